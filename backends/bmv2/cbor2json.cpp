@@ -0,0 +1,53 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <fstream>
+#include <iostream>
+
+#include "lib/json.h"
+
+// Standalone converter from the CBOR artifact written with --cbor back to
+// the usual bmv2 JSON text, for consumers that only speak JSON.
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " file.cbor [file.json]" << std::endl;
+        return 1;
+    }
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    try {
+        auto json = Util::IJson::loadCBOR(in);
+        if (argc == 3) {
+            std::ofstream out(argv[2]);
+            if (!out) {
+                std::cerr << "cannot open " << argv[2] << std::endl;
+                return 1;
+            }
+            json->serialize(out);
+            out << std::endl;
+        } else {
+            json->serialize(std::cout);
+            std::cout << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
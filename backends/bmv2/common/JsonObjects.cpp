@@ -20,6 +20,26 @@ limitations under the License.
 
 namespace BMV2 {
 
+namespace {
+// JSON keys emplaced once per generated object; interned once here
+// instead of being re-hashed by the cstring constructor on every call.
+const cstring nameKey = "name";
+const cstring idKey = "id";
+const cstring typeKey = "type";
+const cstring valueKey = "value";
+const cstring fieldsKey = "fields";
+const cstring headerTypeKey = "header_type";
+const cstring metadataKey = "metadata";
+const cstring piOmitKey = "pi_omit";
+const cstring sizeKey = "size";
+const cstring headerIdsKey = "header_ids";
+const cstring entriesKey = "entries";
+const cstring parseStatesKey = "parse_states";
+const cstring parserOpsKey = "parser_ops";
+const cstring transitionsKey = "transitions";
+const cstring transitionKey = "transition_key";
+}  // namespace
+
 const int JSON_MAJOR_VERSION = 2;
 const int JSON_MINOR_VERSION = 23;
 
@@ -55,7 +75,7 @@ Util::JsonArray*
 JsonObjects::get_field_list_contents(unsigned id) const {
     for (auto e : *field_lists) {
         auto obj = e->to<Util::JsonObject>();
-        auto val = obj->get("id")->to<Util::JsonValue>();
+        auto val = obj->get(idKey)->to<Util::JsonValue>();
         if (val != nullptr && val->isNumber() && val->getInt() == static_cast<int>(id)) {
             return obj->get("elements")->to<Util::JsonArray>();
         }
@@ -67,7 +87,7 @@ Util::JsonObject*
 JsonObjects::find_object_by_name(Util::JsonArray* array, const cstring& name) {
     for (auto e : *array) {
         auto obj = e->to<Util::JsonObject>();
-        auto val = obj->get("name")->to<Util::JsonValue>();
+        auto val = obj->get(nameKey)->to<Util::JsonValue>();
         if (val != nullptr && val->isString() && val->getString() == name) {
             return obj;
         }
@@ -131,13 +151,14 @@ JsonObjects::add_header_type(const cstring& name, Util::JsonArray*& fields, unsi
     auto header_type = new Util::JsonObject();
     unsigned id = BMV2::nextId("header_types");
     header_type_id[sname] = id;
-    header_type->emplace("name", name);
-    header_type->emplace("id", id);
+    map_header_type[sname] = header_type;
+    header_type->emplace(nameKey, name);
+    header_type->emplace(idKey, id);
     if (fields != nullptr) {
-        header_type->emplace("fields", fields);
+        header_type->emplace(fieldsKey, fields);
     } else {
         auto temp = new Util::JsonArray();
-        header_type->emplace("fields", temp);
+        header_type->emplace(fieldsKey, temp);
     }
     if (max_length > 0)
         header_type->emplace("max_length", max_length);
@@ -154,8 +175,8 @@ JsonObjects::add_union_type(const cstring& name, Util::JsonArray*& fields) {
     auto union_type = new Util::JsonObject();
     unsigned id = BMV2::nextId("header_union_types");
     union_type_id[sname] = id;
-    union_type->emplace("name", name);
-    union_type->emplace("id", id);
+    union_type->emplace(nameKey, name);
+    union_type->emplace(idKey, id);
     if (fields != nullptr) {
         union_type->emplace("headers", fields);
     } else {
@@ -178,10 +199,11 @@ JsonObjects::add_header_type(const cstring& name) {
     auto header_type = new Util::JsonObject();
     unsigned id = BMV2::nextId("header_types");
     header_type_id[sname] = id;
-    header_type->emplace("name", name);
-    header_type->emplace("id", id);
+    map_header_type[sname] = header_type;
+    header_type->emplace(nameKey, name);
+    header_type->emplace(idKey, id);
     auto temp = new Util::JsonArray();
-    header_type->emplace("fields", temp);
+    header_type->emplace(fieldsKey, temp);
     header_types->append(header_type);
     return id;
 }
@@ -191,8 +213,11 @@ JsonObjects::add_header_type(const cstring& name) {
 void
 JsonObjects::add_header_field(const cstring& name, Util::JsonArray*& field) {
     CHECK_NULL(field);
-    Util::JsonObject* headerType = find_object_by_name(header_types, name);
-    Util::JsonArray* fields = headerType->get("fields")->to<Util::JsonArray>();
+    // this is called once per field, so use the index instead of scanning
+    // the header_types array every time
+    auto it = map_header_type.find(std::string(name, name.size()));
+    BUG_CHECK(it != map_header_type.end(), "header '%1%' not found", name);
+    Util::JsonArray* fields = it->second->get(fieldsKey)->to<Util::JsonArray>();
     BUG_CHECK(fields != nullptr, "header '%1%' not found", name);
     fields->append(field);
 }
@@ -203,11 +228,11 @@ JsonObjects::add_header(const cstring& type, const cstring& name) {
     auto header = new Util::JsonObject();
     unsigned id = BMV2::nextId("headers");
     LOG1("add header id " << id);
-    header->emplace("name", name);
-    header->emplace("id", id);
-    header->emplace("header_type", type);
-    header->emplace("metadata", false);
-    header->emplace("pi_omit", true);
+    header->emplace(nameKey, name);
+    header->emplace(idKey, id);
+    header->emplace(headerTypeKey, type);
+    header->emplace(metadataKey, false);
+    header->emplace(piOmitKey, true);
     headers->append(header);
     return id;
 }
@@ -218,11 +243,11 @@ JsonObjects::add_union(const cstring& type, Util::JsonArray*& headers, const cst
     auto u = new Util::JsonObject();
     unsigned id = BMV2::nextId("header_unions");
     LOG3("add header_union id " << id);
-    u->emplace("name", name);
-    u->emplace("id", id);
+    u->emplace(nameKey, name);
+    u->emplace(idKey, id);
     u->emplace("union_type", type);
-    u->emplace("header_ids", headers);
-    u->emplace("pi_omit", true);
+    u->emplace(headerIdsKey, headers);
+    u->emplace(piOmitKey, true);
     header_unions->append(u);
     return id;
 }
@@ -232,11 +257,11 @@ JsonObjects::add_metadata(const cstring& type, const cstring& name) {
     auto header = new Util::JsonObject();
     unsigned id = BMV2::nextId("headers");
     LOG1("add metadata header id " << id);
-    header->emplace("name", name);
-    header->emplace("id", id);
-    header->emplace("header_type", type);
-    header->emplace("metadata", true);
-    header->emplace("pi_omit", true);  // Don't expose in PI.
+    header->emplace(nameKey, name);
+    header->emplace(idKey, id);
+    header->emplace(headerTypeKey, type);
+    header->emplace(metadataKey, true);
+    header->emplace(piOmitKey, true);  // Don't expose in PI.
     headers->append(header);
     return id;
 }
@@ -246,12 +271,12 @@ JsonObjects::add_header_stack(const cstring& type, const cstring& name,
                               const unsigned size, const std::vector<unsigned>& ids) {
     auto stack = new Util::JsonObject();
     unsigned id = BMV2::nextId("stack");
-    stack->emplace("name", name);
-    stack->emplace("id", id);
-    stack->emplace("header_type", type);
-    stack->emplace("size", size);
+    stack->emplace(nameKey, name);
+    stack->emplace(idKey, id);
+    stack->emplace(headerTypeKey, type);
+    stack->emplace(sizeKey, size);
     auto members = new Util::JsonArray();
-    stack->emplace("header_ids", members);
+    stack->emplace(headerIdsKey, members);
     for (auto id : ids) {
         members->append(id);
     }
@@ -263,10 +288,10 @@ JsonObjects::add_header_union_stack(const cstring& type, const cstring& name,
                                     const unsigned size, const std::vector<unsigned>& ids) {
     auto stack = new Util::JsonObject();
     unsigned id = BMV2::nextId("union_stack");
-    stack->emplace("name", name);
-    stack->emplace("id", id);
+    stack->emplace(nameKey, name);
+    stack->emplace(idKey, id);
     stack->emplace("union_type", type);
-    stack->emplace("size", size);
+    stack->emplace(sizeKey, size);
     auto members = new Util::JsonArray();
     stack->emplace("header_union_ids", members);
     for (auto id : ids) {
@@ -289,11 +314,14 @@ void
 JsonObjects::add_enum(const cstring& enum_name, const cstring& entry_name,
                       const unsigned entry_value) {
     // look up enum in json by name
-    Util::JsonObject* enum_json = find_object_by_name(enums, enum_name);
+    std::string sname(enum_name, enum_name.size());
+    auto it = map_enum.find(sname);
+    Util::JsonObject* enum_json = it == map_enum.end() ? nullptr : it->second;
     if (enum_json == nullptr) {  // first entry in a new enum
         enum_json = new Util::JsonObject();
-        enum_json->emplace("name", enum_name);
-        auto entries = insert_array_field(enum_json, "entries");
+        map_enum[sname] = enum_json;
+        enum_json->emplace(nameKey, enum_name);
+        auto entries = insert_array_field(enum_json, entriesKey);
         auto entry = new Util::JsonArray();
         entry->append(entry_name);
         entry->append(entry_value);
@@ -301,7 +329,7 @@ JsonObjects::add_enum(const cstring& enum_name, const cstring& entry_name,
         enums->append(enum_json);
         LOG3("new enum object: " << enum_name << " " << entry_name << " " << entry_value);
     } else {  // add entry to existing enum
-        auto entries = enum_json->get("entries")->to<Util::JsonArray>();
+        auto entries = enum_json->get(entriesKey)->to<Util::JsonArray>();
         auto entry = new Util::JsonArray();
         entry->append(entry_name);
         entry->append(entry_value);
@@ -314,14 +342,18 @@ unsigned
 JsonObjects::add_parser(const cstring& name) {
     auto parser = new Util::JsonObject();
     unsigned id = BMV2::nextId("parser");
-    parser->emplace("name", name);
-    parser->emplace("id", id);
+    parser->emplace(nameKey, name);
+    parser->emplace(idKey, id);
     parser->emplace("init_state", IR::ParserState::start);
     auto parse_states = new Util::JsonArray();
-    parser->emplace("parse_states", parse_states);
+    parser->emplace(parseStatesKey, parse_states);
     parsers->append(parser);
 
-    map_parser.emplace(id, parser);
+    // The ids are handed out by a per-kind counter that is not tied to
+    // this object's lifetime, so index rather than append.
+    if (id >= map_parser.size())
+        map_parser.resize(id + 1);
+    map_parser[id] = parser;
     return id;
 }
 
@@ -329,32 +361,34 @@ JsonObjects::add_parser(const cstring& name) {
 /// return the id of the parser state
 unsigned
 JsonObjects::add_parser_state(const unsigned parser_id, const cstring& state_name) {
-    if (map_parser.find(parser_id) == map_parser.end())
+    if (parser_id >= map_parser.size() || map_parser[parser_id] == nullptr)
         BUG("parser %1% not found.", parser_id);
     auto parser = map_parser[parser_id];
-    auto states = parser->get("parse_states")->to<Util::JsonArray>();
+    auto states = parser->get(parseStatesKey)->to<Util::JsonArray>();
     auto state = new Util::JsonObject();
     unsigned state_id = BMV2::nextId("parse_states");
-    state->emplace("name", state_name);
-    state->emplace("id", state_id);
+    state->emplace(nameKey, state_name);
+    state->emplace(idKey, state_id);
     auto operations = new Util::JsonArray();
-    state->emplace("parser_ops", operations);
+    state->emplace(parserOpsKey, operations);
     auto transitions = new Util::JsonArray();
-    state->emplace("transitions", transitions);
+    state->emplace(transitionsKey, transitions);
     states->append(state);
     auto key = new Util::JsonArray();
-    state->emplace("transition_key", key);
+    state->emplace(transitionKey, key);
 
-    map_parser_state.emplace(state_id, state);
+    if (state_id >= map_parser_state.size())
+        map_parser_state.resize(state_id + 1);
+    map_parser_state[state_id] = state;
     return state_id;
 }
 
 void
 JsonObjects::add_parser_transition(const unsigned state_id, Util::IJson* transition) {
-    if (map_parser_state.find(state_id) == map_parser_state.end())
+    if (state_id >= map_parser_state.size() || map_parser_state[state_id] == nullptr)
         BUG("parser state %1% not found.", state_id);
     auto state = map_parser_state[state_id];
-    auto transitions = state->get("transitions")->to<Util::JsonArray>();
+    auto transitions = state->get(transitionsKey)->to<Util::JsonArray>();
     CHECK_NULL(transitions);
     auto trans = transition->to<Util::JsonObject>();
     CHECK_NULL(trans);
@@ -363,19 +397,19 @@ JsonObjects::add_parser_transition(const unsigned state_id, Util::IJson* transit
 
 void
 JsonObjects::add_parser_op(const unsigned state_id, Util::IJson* op) {
-    if (map_parser_state.find(state_id) == map_parser_state.end())
+    if (state_id >= map_parser_state.size() || map_parser_state[state_id] == nullptr)
         BUG("parser state %1% not found.", state_id);
     auto state = map_parser_state[state_id];
-    auto statements = state->get("parser_ops")->to<Util::JsonArray>();
+    auto statements = state->get(parserOpsKey)->to<Util::JsonArray>();
     CHECK_NULL(statements);
     statements->append(op);
 }
 
 void
 JsonObjects::add_parser_transition_key(const unsigned state_id, Util::IJson* newKey) {
-    if (map_parser_state.find(state_id) != map_parser_state.end()) {
+    if (state_id < map_parser_state.size() && map_parser_state[state_id] != nullptr) {
        auto state = map_parser_state[state_id];
-       auto keys = state->get("transition_key")->to<Util::JsonArray>();
+       auto keys = state->get(transitionKey)->to<Util::JsonArray>();
        CHECK_NULL(keys);
        auto new_keys = newKey->to<Util::JsonArray>();
        for (auto k : *new_keys) {
@@ -389,8 +423,8 @@ JsonObjects::add_parse_vset(const cstring& name, const unsigned bitwidth,
                             const big_int& size) {
     auto parse_vset = new Util::JsonObject();
     unsigned id = BMV2::nextId("parse_vsets");
-    parse_vset->emplace("name", name);
-    parse_vset->emplace("id", id);
+    parse_vset->emplace(nameKey, name);
+    parse_vset->emplace(idKey, id);
     parse_vset->emplace("compressed_bitwidth", bitwidth);
     parse_vset->emplace("max_size", size);
     parse_vsets->append(parse_vset);
@@ -401,9 +435,9 @@ JsonObjects::add_action(const cstring& name, Util::JsonArray*& params, Util::Jso
     CHECK_NULL(params);
     CHECK_NULL(body);
     auto action = new Util::JsonObject();
-    action->emplace("name", name);
+    action->emplace(nameKey, name);
     unsigned id = BMV2::nextId("actions");
-    action->emplace("id", id);
+    action->emplace(idKey, id);
     action->emplace("runtime_data", params);
     action->emplace("primitives", body);
     actions->append(action);
@@ -414,9 +448,9 @@ void
 JsonObjects::add_extern_attribute(const cstring& name, const cstring& type,
                                   const cstring& value, Util::JsonArray* attributes) {
     auto attr = new Util::JsonObject();
-    attr->emplace("name", name);
-    attr->emplace("type", type);
-    attr->emplace("value", value);
+    attr->emplace(nameKey, name);
+    attr->emplace(typeKey, type);
+    attr->emplace(valueKey, value);
     attributes->append(attr);
 }
 
@@ -425,9 +459,9 @@ JsonObjects::add_extern(const cstring& name, const cstring& type,
                         Util::JsonArray* attributes) {
     auto extn = new Util::JsonObject();
     unsigned id = BMV2::nextId("extern_instances");
-    extn->emplace("name", name);
-    extn->emplace("id", id);
-    extn->emplace("type", type);
+    extn->emplace(nameKey, name);
+    extn->emplace(idKey, id);
+    extn->emplace(typeKey, type);
     extn->emplace("attribute_values", attributes);
     externs->append(extn);
 }
@@ -18,6 +18,7 @@ limitations under the License.
 #define BACKENDS_BMV2_COMMON_JSONOBJECTS_H_
 
 #include <map>
+#include <vector>
 #include "lib/json.h"
 #include "lib/ordered_map.h"
 
@@ -63,8 +64,13 @@ class JsonObjects {
     // Given a field list id returns the array of values called "elements"
     Util::JsonArray* get_field_list_contents(unsigned id) const;
 
-    std::map<unsigned, Util::JsonObject*> map_parser;
-    std::map<unsigned, Util::JsonObject*> map_parser_state;
+    /// Parser and parser state objects indexed by their id; the ids are
+    /// small consecutive integers handed out by per-kind counters, so a
+    /// vector lookup replaces a map search on the hot conversion path.
+    std::vector<Util::JsonObject*> map_parser;
+    std::vector<Util::JsonObject*> map_parser_state;
+    std::map<std::string, Util::JsonObject*> map_header_type;
+    std::map<std::string, Util::JsonObject*> map_enum;
 
     Util::JsonObject* toplevel;
     Util::JsonObject* meta;
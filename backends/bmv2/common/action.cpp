@@ -201,8 +201,26 @@ void ActionConverter::postorder(const IR::P4Action* action) {
     convertActionParams(action->parameters, params);
     auto body = new Util::JsonArray();
     convertActionBody(&action->body->components, body);
-    auto id = ctxt->json->add_action(name, params, body);
-    LOG3("add action with id " << id << " name " << name << " " << action);
+    unsigned id;
+    if (dedupActions) {
+        // The copies of an action that action localization makes for each
+        // invoking table all convert to the same definition (they share the
+        // original's control-plane name and source info), so emit it once
+        // and map every copy to the same id.
+        cstring key = name + "\n" + params->toString() + "\n" + body->toString();
+        auto it = actionIds.find(key);
+        if (it != actionIds.end()) {
+            id = it->second;
+            LOG3("reuse action with id " << id << " name " << name << " " << action);
+        } else {
+            id = ctxt->json->add_action(name, params, body);
+            actionIds.emplace(key, id);
+            LOG3("add action with id " << id << " name " << name << " " << action);
+        }
+    } else {
+        id = ctxt->json->add_action(name, params, body);
+        LOG3("add action with id " << id << " name " << name << " " << action);
+    }
     ctxt->structure->ids.emplace(action, id);
 }
 
@@ -24,6 +24,9 @@ namespace BMV2 {
 
 class ActionConverter : public Inspector {
     ConversionContext* ctxt;
+    /// Maps the name and serialized definition of each emitted action to
+    /// its id, so identical actions can share one definition (--dedup-actions).
+    std::map<cstring, unsigned> actionIds;
 
     void convertActionBody(const IR::Vector<IR::StatOrDecl>* body,
                            Util::JsonArray* result);
@@ -34,8 +37,10 @@ class ActionConverter : public Inspector {
 
  public:
     const bool emitExterns;
-    explicit ActionConverter(ConversionContext* ctxt, const bool& emitExterns_)
-        : ctxt(ctxt), emitExterns(emitExterns_) {
+    const bool dedupActions;
+    explicit ActionConverter(ConversionContext* ctxt, const bool& emitExterns_,
+                             const bool& dedupActions_ = false)
+        : ctxt(ctxt), emitExterns(emitExterns_), dedupActions(dedupActions_) {
         setName("ConvertActions"); }
 };
 
@@ -30,6 +30,7 @@ limitations under the License.
 #include "lib/log.h"
 #include "lib/nullstream.h"
 #include "JsonObjects.h"
+#include "jsonWriter.h"
 #include "metermap.h"
 #include "midend/convertEnums.h"
 #include "midend/actionSynthesis.h"
@@ -61,10 +62,16 @@ class Backend {
             P4::ConvertEnums::EnumMapping* enumMap) :
         options(options),
         refMap(refMap), typeMap(typeMap), enumMap(enumMap),
-        corelib(P4::P4CoreLibrary::instance), json(new BMV2::JsonObjects()) {
+        corelib(P4::P4CoreLibrary::instance()), json(new BMV2::JsonObjects()) {
         refMap->setIsV1(options.isv1());
         }
-    void serialize(std::ostream& out) const { json->toplevel->serialize(out); }
+    void serialize(std::ostream& out) const {
+        // build the whole document in memory and write it in one call; going
+        // through IJson::serialize flushes the stream on every line
+        JsonWriter writer;
+        writer.append(json->toplevel);
+        writer.writeTo(out);
+    }
     virtual void convert(const IR::ToplevelBlock* block) = 0;
 };
 
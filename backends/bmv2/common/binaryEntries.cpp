@@ -0,0 +1,277 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "binaryEntries.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "lib/error.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+
+namespace BMV2 {
+
+namespace {
+
+const char magic[4] = {'P', '4', 'C', 'E'};
+const uint8_t formatVersion = 1;
+
+/// Byte widths of one key component, as recorded in the JSON "key_layout".
+struct ComponentLayout {
+    cstring matchType;
+    int bytes;
+};
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/// Append the bytes of a "0x..." literal produced by stringRepr to @out;
+/// @returns the byte count, or -1 when @repr is not such a literal
+/// (negative values and conversion-error leftovers keep their table inline).
+int appendHexBytes(std::string& out, cstring repr) {
+    const char* s = repr.c_str();
+    if (s == nullptr) return -1;
+    size_t len = repr.size();
+    if (len < 2 || s[0] != '0' || s[1] != 'x') return -1;
+    size_t i = 2;
+    int count = 0;
+    if ((len - 2) % 2) {  // width-0 reprs may have an odd digit count
+        int lo = hexDigit(s[i++]);
+        if (lo < 0) return -1;
+        out.push_back(char(lo));
+        count++;
+    }
+    for (; i < len; i += 2) {
+        int hi = hexDigit(s[i]), lo = hexDigit(s[i + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        out.push_back(char(hi * 16 + lo));
+        count++;
+    }
+    return count;
+}
+
+void appendU32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(char(v & 0xff));
+        v >>= 8;
+    }
+}
+
+void appendU16(std::string& out, uint16_t v) {
+    out.push_back(char(v & 0xff));
+    out.push_back(char(v >> 8));
+}
+
+const Util::JsonValue* getMember(const Util::JsonObject* obj, cstring field) {
+    auto* json = obj->get(field);
+    return json != nullptr ? json->to<Util::JsonValue>() : nullptr;
+}
+
+/// Append the hex-string member @field of @key to @out; -1 if absent.
+int appendField(std::string& out, const Util::JsonObject* key, cstring field) {
+    auto* v = getMember(key, field);
+    if (v == nullptr || !v->isString()) return -1;
+    return appendHexBytes(out, v->getString());
+}
+
+/// Encode one key component; on the first entry (@derive) the component's
+/// layout is recorded, on later entries it is checked.  @returns false if
+/// the component does not fit the fixed-width format.
+bool encodeComponent(std::string& out, const Util::JsonObject* key,
+                     std::vector<ComponentLayout>& layout, size_t index, bool derive) {
+    auto* mt = getMember(key, "match_type");
+    if (mt == nullptr || !mt->isString()) return false;
+    cstring matchType = mt->getString();
+    int bytes;
+    if (matchType == "exact") {
+        bytes = appendField(out, key, "key");
+    } else if (matchType == "ternary") {
+        bytes = appendField(out, key, "key");
+        if (bytes < 0 || appendField(out, key, "mask") != bytes) return false;
+    } else if (matchType == "lpm") {
+        bytes = appendField(out, key, "key");
+        auto* plen = getMember(key, "prefix_length");
+        if (bytes < 0 || plen == nullptr || !plen->isNumber()) return false;
+        appendU32(out, uint32_t(plen->getInt()));
+    } else if (matchType == "range") {
+        bytes = appendField(out, key, "start");
+        if (bytes < 0 || appendField(out, key, "end") != bytes) return false;
+    } else {
+        return false;  // target-specific match kind; keep the table inline
+    }
+    if (bytes < 0) return false;
+    if (derive) {
+        layout.push_back(ComponentLayout{matchType, bytes});
+        return true;
+    }
+    return index < layout.size() &&
+           layout[index].matchType == matchType && layout[index].bytes == bytes;
+}
+
+/// Encode @entry into @out (without action-data padding, applied by the
+/// caller once the table-wide maximum is known); @adBytes is set to the
+/// action-data byte count.  @returns false if the entry does not fit.
+bool encodeEntry(std::string& out, const Util::JsonObject* entry,
+                 std::vector<ComponentLayout>& layout, bool derive, int& adBytes) {
+    auto* priority = getMember(entry, "priority");
+    if (priority == nullptr || !priority->isNumber()) return false;
+    appendU32(out, uint32_t(priority->getInt()));
+
+    auto* actionJson = entry->get("action_entry");
+    auto* action = actionJson != nullptr ? actionJson->to<Util::JsonObject>() : nullptr;
+    if (action == nullptr) return false;
+    auto* actionId = getMember(action, "action_id");
+    if (actionId == nullptr || !actionId->isNumber()) return false;
+    appendU32(out, uint32_t(actionId->getInt()));
+
+    auto* keysJson = entry->get("match_key");
+    auto* keys = keysJson != nullptr ? keysJson->to<Util::JsonArray>() : nullptr;
+    if (keys == nullptr || (!derive && keys->size() != layout.size())) return false;
+    size_t index = 0;
+    for (auto* k : *keys) {
+        auto* key = k != nullptr ? k->to<Util::JsonObject>() : nullptr;
+        if (key == nullptr || !encodeComponent(out, key, layout, index, derive)) return false;
+        index++;
+    }
+
+    auto* dataJson = action->get("action_data");
+    auto* data = dataJson != nullptr ? dataJson->to<Util::JsonArray>() : nullptr;
+    if (data == nullptr) return false;
+    std::string argBytes;
+    for (auto* a : *data) {
+        auto* v = a != nullptr ? a->to<Util::JsonValue>() : nullptr;
+        if (v == nullptr || !v->isString()) return false;
+        if (appendHexBytes(argBytes, v->getString()) < 0) return false;
+    }
+    if (argBytes.size() > 0xffff) return false;
+    adBytes = int(argBytes.size());
+    appendU16(out, uint16_t(argBytes.size()));
+    out += argBytes;
+    return true;
+}
+
+/// Externalize one table's entries, appending its section to @file.
+/// @returns the metadata object to put in the JSON, or null if some entry
+/// does not fit the format (the table then keeps its inline array).
+Util::JsonObject* externalizeTable(const Util::JsonArray* entries, cstring filename,
+                                   std::string& file) {
+    std::vector<ComponentLayout> layout;
+    std::vector<std::string> records;
+    records.reserve(entries->size());
+    int maxAd = 0;
+    for (auto* e : *entries) {
+        auto* entry = e != nullptr ? e->to<Util::JsonObject>() : nullptr;
+        if (entry == nullptr) return nullptr;
+        std::string record;
+        int adBytes;
+        if (!encodeEntry(record, entry, layout, records.empty(), adBytes)) return nullptr;
+        maxAd = std::max(maxAd, adBytes);
+        records.push_back(std::move(record));
+    }
+
+    // key widths are table-wide, so every record shares the same prefix
+    // length; only the trailing action-data area needs padding
+    size_t prefix = 4 + 4 + 2;  // priority, action_id, action-data length
+    for (auto& c : layout) {
+        prefix += c.bytes;
+        if (c.matchType == "ternary" || c.matchType == "range")
+            prefix += c.bytes;
+        else if (c.matchType == "lpm")
+            prefix += 4;
+    }
+    size_t recordBytes = prefix + size_t(maxAd);
+    size_t offset = file.size();
+    for (auto& record : records) {
+        record.resize(recordBytes, '\0');
+        file += record;
+    }
+    uint64_t digest = Util::Hash::hash(file.data() + offset, file.size() - offset);
+
+    auto meta = new Util::JsonObject();
+    meta->emplace("path", filename);
+    meta->emplace("offset", big_int(offset));
+    meta->emplace("count", unsigned(records.size()));
+    meta->emplace("record_bytes", unsigned(recordBytes));
+    std::stringstream d;
+    d << "0x" << std::hex << digest;
+    meta->emplace("digest", cstring(d.str()));
+    auto keyLayout = new Util::JsonArray();
+    for (auto& c : layout) {
+        auto o = new Util::JsonObject();
+        o->emplace("match_type", c.matchType);
+        o->emplace("bytes", c.bytes);
+        keyLayout->append(o);
+    }
+    meta->emplace("key_layout", keyLayout);
+    meta->emplace("action_data_bytes", maxAd);
+    return meta;
+}
+
+}  // namespace
+
+void externalizeTableEntries(Util::JsonObject* toplevel, cstring filename, size_t minEntries) {
+    if (toplevel == nullptr || filename.isNullOrEmpty()) return;
+    auto* pipelinesJson = toplevel->get("pipelines");
+    auto* pipelines = pipelinesJson != nullptr ? pipelinesJson->to<Util::JsonArray>() : nullptr;
+    if (pipelines == nullptr) return;
+
+    std::string file;
+    file.append(magic, sizeof(magic));
+    file.push_back(char(formatVersion));
+    bool any = false;
+    for (auto* p : *pipelines) {
+        auto* pipeline = p != nullptr ? p->to<Util::JsonObject>() : nullptr;
+        if (pipeline == nullptr) continue;
+        auto* tablesJson = pipeline->get("tables");
+        auto* tables = tablesJson != nullptr ? tablesJson->to<Util::JsonArray>() : nullptr;
+        if (tables == nullptr) continue;
+        for (auto* t : *tables) {
+            auto* table = t != nullptr ? t->to<Util::JsonObject>() : nullptr;
+            if (table == nullptr) continue;
+            auto* entriesJson = table->get("entries");
+            auto* entries = entriesJson != nullptr ?
+                            entriesJson->to<Util::JsonArray>() : nullptr;
+            if (entries == nullptr || entries->size() < minEntries) continue;
+            auto* meta = externalizeTable(entries, filename, file);
+            if (meta == nullptr) continue;
+            table->erase("entries");
+            table->emplace("entries_file", meta);
+            any = true;
+            LOG2("Externalized " << entries->size() << " entries of "
+                 << table->get("name") << " to " << filename);
+        }
+    }
+    if (!any)
+        return;  // nothing qualified; do not create an empty side file
+
+    std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        ::error(ErrorType::ERR_IO, "Can't open %1%", filename);
+        return;
+    }
+    out.write(file.data(), file.size());
+    out.flush();
+    if (!out)
+        ::error(ErrorType::ERR_IO, "Error writing %1%", filename);
+}
+
+}  // namespace BMV2
@@ -0,0 +1,62 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_BMV2_COMMON_BINARYENTRIES_H_
+#define BACKENDS_BMV2_COMMON_BINARYENTRIES_H_
+
+#include "lib/cstring.h"
+#include "lib/json.h"
+
+namespace BMV2 {
+
+/* Binary side file for large const-entry tables (--entries-file).
+ *
+ * Tables with many thousands of const entries (e.g. prefix lists) dominate
+ * the size of the generated JSON, and the target then JSON-parses every
+ * entry literal at startup.  When enabled, such tables keep only metadata
+ * in the JSON -- an "entries_file" object holding the side file's name, the
+ * section offset, record layout and a digest of the section bytes -- and
+ * the entries themselves become fixed-width binary records in the side
+ * file.
+ *
+ * Side file layout: a 5-byte header (magic "P4CE", format version byte),
+ * then one section per externalized table, each a contiguous run of
+ * count * record_bytes record bytes at the offset recorded in the JSON.
+ * A record is, in order, all little-endian:
+ *   priority     u32
+ *   action_id    u32
+ *   per key component, by match type (widths in the JSON "key_layout"):
+ *     exact              key bytes
+ *     ternary            key bytes, mask bytes
+ *     lpm                key bytes, prefix_length u32
+ *     range              start bytes, end bytes
+ *   action_data  u16 byte count, then the argument bytes of all arguments
+ *                concatenated, zero-padded to "action_data_bytes"
+ * The digest is Util::Hash::hash over the section's bytes, so a loader can
+ * reject a side file that does not belong to the JSON referencing it. */
+
+/// Move the entries of every table in @p toplevel with at least
+/// @p minEntries const entries into the binary side file @p filename,
+/// leaving an "entries_file" metadata object in their place.  Tables whose
+/// entries do not fit the fixed-width format (negative literals, earlier
+/// conversion errors) are kept inline.  The file is only created if some
+/// table qualifies.
+void externalizeTableEntries(Util::JsonObject* toplevel, cstring filename,
+                             size_t minEntries = 1024);
+
+}  // namespace BMV2
+
+#endif /* BACKENDS_BMV2_COMMON_BINARYENTRIES_H_ */
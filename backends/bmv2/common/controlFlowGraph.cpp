@@ -109,14 +109,21 @@ bool CFG::dfs(Node* node, std::set<Node*> &visited,
     return true;
 }
 
+namespace {
+/// Canonical identity of an edge destination: TableNodes that refer
+/// to the same table are the same destination even when they are
+/// distinct CFG nodes.
+const void* destinationKey(const CFG::Node* node) {
+    if (auto tn = node->to<CFG::TableNode>())
+        return tn->table;
+    return node;
+}
+}  // end anonymous namespace
+
 bool CFG::EdgeSet::isDestination(const CFG::Node* node) const {
     for (auto e : edges) {
         auto dest = e->endpoint;
-        if (dest == node) return true;
-        auto td = dest->to<TableNode>();
-        auto tn = node->to<TableNode>();
-        if (td != nullptr && tn != nullptr &&
-            td->table == tn->table)
+        if (destinationKey(dest) == destinationKey(node))
             return true;
     }
 
@@ -126,21 +133,20 @@ bool CFG::EdgeSet::isDestination(const CFG::Node* node) const {
 bool CFG::EdgeSet::checkSame(const CFG::EdgeSet& other) const {
     if (size() != other.size())
         return false;
-    // This algorithm is quadratic, but we expect these graphs to be very small
-    for (auto e : edges) {
-        if (!other.isDestination(e->endpoint))
-            return false;
-    }
-    for (auto e : other.edges) {
-        if (!isDestination(e->endpoint))
-            return false;
-    }
-    return true;
+    // Compare the sets of canonical destinations; a table can appear
+    // many times in the CFG, so comparing each endpoint against the
+    // whole other set would be quadratic in the edge count.
+    std::set<const void*> mine, theirs;
+    for (auto e : edges)
+        mine.emplace(destinationKey(e->endpoint));
+    for (auto e : other.edges)
+        theirs.emplace(destinationKey(e->endpoint));
+    return mine == theirs;
 }
 
 // We check whether a table always jumps to the same destination,
 // even if it appears multiple times in the CFG.
-bool CFG::checkMergeable(std::set<TableNode*> nodes) const {
+bool CFG::checkMergeable(const std::set<TableNode*> &nodes) const {
     TableNode* first = nullptr;
     for (auto tn : nodes) {
         if (first == nullptr) {
@@ -170,7 +176,7 @@ bool CFG::checkImplementable() const {
         if (auto tn = n->to<TableNode>())
             tableNodes[tn->table].emplace(tn);
     }
-    for (auto it : tableNodes) {
+    for (const auto &it : tableNodes) {
         if (it.second.size() == 1)
             continue;
         bool success = checkMergeable(it.second);
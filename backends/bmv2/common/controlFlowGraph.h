@@ -189,7 +189,7 @@ class CFG final : public IHasDbPrint {
     /// a single table node from a control-flow point of view.
     /// This requires their successor edgesets to be "compatible" with
     /// each other.  This is a constraint specific to BMv2.
-    bool checkMergeable(std::set<TableNode*> nodes) const;
+    bool checkMergeable(const std::set<TableNode*> &nodes) const;
 };
 
 }  // namespace BMV2
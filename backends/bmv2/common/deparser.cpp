@@ -46,10 +46,21 @@ void DeparserConverter::convertDeparserBody(const IR::Vector<IR::StatOrDecl>* bo
                             auto j = ctxt->conv->convert(arg->expression);
                             auto val = j->to<Util::JsonObject>()->get("value");
                             order->append(val);
+                        } else if (auto stack = type->to<IR::Type_Stack>()) {
+                            // A whole stack is deparsed by emitting each
+                            // element in order.  Expanding here instead of
+                            // in the midend keeps the IR small.
+                            for (size_t i = 0; i < stack->getSize(); i++) {
+                                auto element = new IR::ArrayIndex(
+                                    arg->expression, new IR::Constant((int)i));
+                                auto j = ctxt->conv->convert(element);
+                                auto val = j->to<Util::JsonObject>()->get("value");
+                                order->append(val);
+                            }
                         } else {
-                            // We don't need to handle other types,
-                            // like header unions or stacks; they were
-                            // expanded by the expandEmit pass.
+                            // We don't need to handle other types, like
+                            // header unions; they were expanded by the
+                            // expandEmit pass.
                             ::error(ErrorType::ERR_UNSUPPORTED,
                                     "%1%: emit only supports header arguments, not %2%",
                                     arg, type);
@@ -760,18 +760,30 @@ bool ExpressionConverter::isArrayIndexRuntime(const IR::Expression* e) {
 // see below for wrap
 Util::IJson*
 ExpressionConverter::convert(const IR::Expression* e, bool doFixup, bool wrap, bool convertBool) {
-    const IR::Expression *expr = e;
-    if (doFixup) {
-        ArithmeticFixup af(typeMap);
-        auto r = e->apply(af);
-        CHECK_NULL(r);
-        expr = r->to<IR::Expression>();
-        CHECK_NULL(expr);
+    // Common subexpressions are shared in the IR (e.g. a value that copy
+    // propagation wrote into many use sites), so the same node is often
+    // converted many times; 'map' already keeps the first translation of
+    // every node (mapExpression uses emplace), so reuse it directly instead
+    // of running the fixup and the traversal again just to look it up.
+    auto result = ::get(map, e);
+    if (result == nullptr) {
+        const IR::Expression *expr = e;
+        if (doFixup) {
+            ArithmeticFixup af(typeMap);
+            auto r = e->apply(af);
+            CHECK_NULL(r);
+            expr = r->to<IR::Expression>();
+            CHECK_NULL(expr);
+        }
+        expr->apply(*this);
+        result = ::get(map, expr->to<IR::Expression>());
+        if (result == nullptr)
+            BUG("%1%: Could not convert expression", e);
+        // when the fixup rebuilt the expression, remember the translation
+        // under the original node as well
+        if (expr != e)
+            mapExpression(e, result);
     }
-    expr->apply(*this);
-    auto result = ::get(map, expr->to<IR::Expression>());
-    if (result == nullptr)
-        BUG("%1%: Could not convert expression", e);
 
     auto type = typeMap->getType(e, true);
     if (convertBool && type->is<IR::Type_Boolean>()) {
@@ -808,16 +820,21 @@ ExpressionConverter::convert(const IR::Expression* e, bool doFixup, bool wrap, b
 
 Util::IJson* ExpressionConverter::convertLeftValue(const IR::Expression* e) {
     leftValue = true;
-    const IR::Expression *expr = e;
-    ArithmeticFixup af(typeMap);
-    auto r = e->apply(af);
-    CHECK_NULL(r);
-    expr = r->to<IR::Expression>();
-    CHECK_NULL(expr);
-    expr->apply(*this);
-    auto result = ::get(map, expr->to<IR::Expression>());
-    if (result == nullptr)
-        BUG("%1%: Could not convert expression", e);
+    auto result = ::get(map, e);
+    if (result == nullptr) {
+        const IR::Expression *expr = e;
+        ArithmeticFixup af(typeMap);
+        auto r = e->apply(af);
+        CHECK_NULL(r);
+        expr = r->to<IR::Expression>();
+        CHECK_NULL(expr);
+        expr->apply(*this);
+        result = ::get(map, expr->to<IR::Expression>());
+        if (result == nullptr)
+            BUG("%1%: Could not convert expression", e);
+        if (expr != e)
+            mapExpression(e, result);
+    }
     leftValue = false;
     return result;
 }
@@ -58,6 +58,8 @@ class ExpressionConverter : public Inspector {
     cstring              scalarsName;
 
     /// After translating an Expression to JSON, save the result to 'map'.
+    /// The map doubles as a memo table: converting a node a second time
+    /// returns the saved (shared) fragment without revisiting the node.
     /// WARNING: this assumes that each IR node has the same
     /// translation in any context, but this is not true in general.
     /// For this pass to work correctly, the IR tree must be converted
@@ -73,7 +75,7 @@ class ExpressionConverter : public Inspector {
     ExpressionConverter(P4::ReferenceMap* refMap, P4::TypeMap* typeMap,
                         ProgramStructure* structure, cstring scalarsName) :
             refMap(refMap), typeMap(typeMap), structure(structure),
-            corelib(P4::P4CoreLibrary::instance),
+            corelib(P4::P4CoreLibrary::instance()),
             scalarsName(scalarsName), leftValue(false), simpleExpressionsOnly(false) {}
     /// If this is 'true' we fail to convert complex expressions.
     /// This is used for table key expressions, for example.
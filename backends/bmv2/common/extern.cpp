@@ -255,21 +255,21 @@ ExternConverter::createCalculation(ConversionContext* ctxt,
 cstring
 ExternConverter::convertHashAlgorithm(cstring algorithm) {
     cstring result;
-    if (algorithm == P4V1::V1Model::instance.algorithm.crc32.name)
+    if (algorithm == P4V1::V1Model::instance().algorithm.crc32.name)
         result = "crc32";
-    else if (algorithm == P4V1::V1Model::instance.algorithm.crc32_custom.name)
+    else if (algorithm == P4V1::V1Model::instance().algorithm.crc32_custom.name)
         result = "crc32_custom";
-    else if (algorithm == P4V1::V1Model::instance.algorithm.crc16.name)
+    else if (algorithm == P4V1::V1Model::instance().algorithm.crc16.name)
         result = "crc16";
-    else if (algorithm == P4V1::V1Model::instance.algorithm.crc16_custom.name)
+    else if (algorithm == P4V1::V1Model::instance().algorithm.crc16_custom.name)
         result = "crc16_custom";
-    else if (algorithm == P4V1::V1Model::instance.algorithm.random.name)
+    else if (algorithm == P4V1::V1Model::instance().algorithm.random.name)
         result = "random";
-    else if (algorithm == P4V1::V1Model::instance.algorithm.identity.name)
+    else if (algorithm == P4V1::V1Model::instance().algorithm.identity.name)
         result = "identity";
-    else if (algorithm == P4V1::V1Model::instance.algorithm.csum16.name)
+    else if (algorithm == P4V1::V1Model::instance().algorithm.csum16.name)
         result = "csum16";
-    else if (algorithm == P4V1::V1Model::instance.algorithm.xor16.name)
+    else if (algorithm == P4V1::V1Model::instance().algorithm.xor16.name)
         result = "xor16";
     else
         ::error(ErrorType::ERR_UNSUPPORTED, "Unsupported algorithm %1%", algorithm);
@@ -79,7 +79,7 @@ class ExternConverter {
     class ExternConverter_##extern_name : public ExternConverter {              \
         model_type&  model_name;                                                \
         ExternConverter_##extern_name() :                                       \
-            model_name(model_type::instance) {                                  \
+            model_name(model_type::instance()) {                                \
             registerExternConverter(#extern_name, this); }                      \
         static ExternConverter_##extern_name singleton;                         \
         Util::IJson* convertExternFunction(ConversionContext* ctxt,             \
@@ -99,7 +99,7 @@ class ExternConverter {
     class ExternConverter_##extern_name : public ExternConverter {              \
         model_type&      model_name;                                            \
         ExternConverter_##extern_name() :                                       \
-            model_name(model_type::instance) {                                  \
+            model_name(model_type::instance()) {                                \
             registerExternConverter(#extern_name, this); }                      \
         static ExternConverter_##extern_name singleton;                         \
         void convertExternInstance(ConversionContext* ctxt,                     \
@@ -119,7 +119,7 @@ class ExternConverter {
     class ExternConverter_##extern_name : public ExternConverter {              \
         type&      name;                                                        \
         ExternConverter_##extern_name() :                                       \
-            name(type::instance) {                                              \
+            name(type::instance()) {                                            \
             registerExternConverter(#extern_name, this); }                      \
         static ExternConverter_##extern_name singleton;                         \
         void convertExternInstance(ConversionContext* ctxt,                     \
@@ -197,6 +197,8 @@ void HeaderConverter::addHeaderField(const cstring& header, const cstring& name,
     field->append(size);
     field->append(is_signed);
     ctxt->json->add_header_field(header, field);
+    if (header == scalarsTypeName)
+        scalarFields.emplace_back(name, size);
 }
 
 void HeaderConverter::addHeaderType(const IR::Type_StructLike *st) {
@@ -419,6 +421,16 @@ void HeaderConverter::end_apply(const IR::Node*) {
         cstring name = ctxt->refMap->newName("_padding");
         addHeaderField(scalarsTypeName, name, 8-padding, false);
     }
+    // Report the final layout.  Fields are packed back to back at bit
+    // granularity, so the trailing alignment field is the only padding.
+    LOG1("Scalars metadata: " << scalars_width << " bits in " << scalarFields.size()
+         << " fields, " << (8 - padding) % 8 << " bits of padding");
+    unsigned offset = 0;
+    for (auto& f : scalarFields) {
+        LOG2("  scalars layout: " << f.first << " offset " << offset
+             << " width " << f.second);
+        offset += f.second;
+    }
 }
 
 /**
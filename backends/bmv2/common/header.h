@@ -18,6 +18,8 @@ limitations under the License.
 #define BACKENDS_BMV2_COMMON_HEADER_H_
 
 #include <list>
+#include <utility>
+#include <vector>
 #include "ir/ir.h"
 #include "lib/json.h"
 #include "frontends/p4/typeMap.h"
@@ -40,6 +42,9 @@ class HeaderConverter : public Inspector {
     const unsigned       boolWidth = 1;    // convert booleans to 1-bit integers
     const unsigned       errorWidth = 32;  // convert errors to 32-bit integers
     unsigned             scalars_width = 0;
+    /// Name and bit width of each field packed into the scalars
+    /// metadata header, in layout order; used to report the layout.
+    std::vector<std::pair<cstring, unsigned>> scalarFields;
 
  protected:
     Util::JsonArray* pushNewArray(Util::JsonArray* parent);
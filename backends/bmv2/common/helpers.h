@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef BACKENDS_BMV2_COMMON_HELPERS_H_
 #define BACKENDS_BMV2_COMMON_HELPERS_H_
 
+#include <set>
 #include "ir/ir.h"
 #include "lib/cstring.h"
 #include "lib/json.h"
@@ -73,10 +74,10 @@ template <Arch arch> struct ActionProfileTraits;
 template<> struct ActionProfileTraits<Arch::V1MODEL> {
     static const cstring name() { return "action profile"; }
     static const cstring propertyName() {
-        return P4V1::V1Model::instance.tableAttributes.tableImplementation.name;
+        return P4V1::V1Model::instance().tableAttributes.tableImplementation.name;
     }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.action_profile.name;
+        return P4V1::V1Model::instance().action_profile.name;
     }
     static const cstring sizeParamName() { return "size"; }
 };
@@ -99,7 +100,7 @@ template <Arch arch> struct ActionSelectorTraits;
 template<> struct ActionSelectorTraits<Arch::V1MODEL> : public ActionProfileTraits<Arch::V1MODEL> {
     static const cstring name() { return "action selector"; }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.action_selector.name;
+        return P4V1::V1Model::instance().action_selector.name;
     }
 };
 
@@ -116,14 +117,14 @@ template <Arch arch> struct RegisterTraits;
 template<> struct RegisterTraits<Arch::V1MODEL> {
     static const cstring name() { return "register"; }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.registers.name;
+        return P4V1::V1Model::instance().registers.name;
     }
     static const cstring sizeParamName() { return "size"; }
     // the index of the type parameter for the data stored in the register, in
     // the type parameter list of the extern type declaration
     static size_t dataTypeParamIdx() { return 0; }
     static boost::optional<size_t> indexTypeParamIdx() {
-        if (P4V1::V1Model::instance.haveIndexTypeParam()) return 1;
+        if (P4V1::V1Model::instance().haveIndexTypeParam()) return 1;
         return boost::none; }
 };
 
@@ -166,19 +167,19 @@ template <typename Kind> struct CounterlikeTraits;
 template<> struct CounterlikeTraits<Standard::CounterExtern<Standard::Arch::V1MODEL> > {
     static const cstring name() { return "counter"; }
     static const cstring directPropertyName() {
-        return P4V1::V1Model::instance.tableAttributes.counters.name;
+        return P4V1::V1Model::instance().tableAttributes.counters.name;
     }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.counter.name;
+        return P4V1::V1Model::instance().counter.name;
     }
     static const cstring directTypeName() {
-        return P4V1::V1Model::instance.directCounter.name;
+        return P4V1::V1Model::instance().directCounter.name;
     }
     static const cstring sizeParamName() {
         return "size";
     }
     static boost::optional<size_t> indexTypeParamIdx() {
-        if (P4V1::V1Model::instance.haveIndexTypeParam()) return 0;
+        if (P4V1::V1Model::instance().haveIndexTypeParam()) return 0;
         return boost::none; }
 };
 
@@ -206,19 +207,19 @@ template<> struct CounterlikeTraits<Standard::CounterExtern<Standard::Arch::PSA>
 template<> struct CounterlikeTraits<Standard::MeterExtern<Standard::Arch::V1MODEL> > {
     static const cstring name() { return "meter"; }
     static const cstring directPropertyName() {
-        return P4V1::V1Model::instance.tableAttributes.meters.name;
+        return P4V1::V1Model::instance().tableAttributes.meters.name;
     }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.meter.name;
+        return P4V1::V1Model::instance().meter.name;
     }
     static const cstring directTypeName() {
-        return P4V1::V1Model::instance.directMeter.name;
+        return P4V1::V1Model::instance().directMeter.name;
     }
     static const cstring sizeParamName() {
         return "size";
     }
     static boost::optional<size_t> indexTypeParamIdx() {
-        if (P4V1::V1Model::instance.haveIndexTypeParam()) return 0;
+        if (P4V1::V1Model::instance().haveIndexTypeParam()) return 0;
         return boost::none; }
 };
 
@@ -267,6 +268,10 @@ struct ConversionContext {
 
     // for action profile conversion
     Util::JsonArray*                 action_profiles = nullptr;
+    /// Names of action profiles/selectors already emitted; shared
+    /// instances referenced from several tables or pipelines are
+    /// converted only once, without rescanning the JSON array.
+    std::set<cstring>                action_profile_names;
 
     std::map<const IR::Declaration_Instance *, SelectorInput> selector_input_map;
 
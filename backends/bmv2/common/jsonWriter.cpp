@@ -0,0 +1,187 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "jsonWriter.h"
+
+#include <ostream>
+
+#include "lib/exceptions.h"
+#include "lib/indent.h"
+
+namespace BMV2 {
+
+void JsonWriter::newline() {
+    buf += '\n';
+    buf.append(indentLevel * indent_t::tabsz, ' ');
+}
+
+void JsonWriter::separate() {
+    if (firstInContainer.empty())
+        return;  // top-level value
+    if (!firstInContainer.back())
+        buf += ',';
+    firstInContainer.back() = false;
+    newline();
+}
+
+void JsonWriter::startValue() {
+    if (keyPending)
+        keyPending = false;  // key() already positioned us
+    else
+        separate();
+}
+
+void JsonWriter::appendValue(const Util::JsonValue* value) {
+    if (value->isString()) {
+        buf += '"';
+        // strings in the IJson tree are already escaped
+        if (const char* s = value->getString().c_str())
+            buf += s;
+        buf += '"';
+    } else if (value->isNumber()) {
+        Util::appendJsonNumber(buf, value->getValue());
+    } else if (value->isBool()) {
+        buf += value->getBool() ? "true" : "false";
+    } else {
+        buf += "null";
+    }
+}
+
+void JsonWriter::append(const Util::IJson* json) {
+    if (json == nullptr) {
+        buf += "null";
+        return;
+    }
+    if (auto* value = json->to<Util::JsonValue>()) {
+        appendValue(value);
+        return;
+    }
+    if (auto* array = json->to<Util::JsonArray>()) {
+        bool isSmall = true;
+        for (auto e : *array)
+            if (e == nullptr || !e->is<Util::JsonValue>())
+                isSmall = false;
+        buf += '[';
+        bool first = true;
+        if (isSmall) {
+            for (auto e : *array) {
+                if (!first)
+                    buf += ", ";
+                appendValue(e->to<Util::JsonValue>());
+                first = false;
+            }
+        } else {
+            ++indentLevel;
+            for (auto e : *array) {
+                if (!first)
+                    buf += ',';
+                newline();
+                append(e);
+                first = false;
+            }
+            --indentLevel;
+            newline();
+        }
+        buf += ']';
+        return;
+    }
+    auto* object = json->to<Util::JsonObject>();
+    BUG_CHECK(object != nullptr, "Unexpected IJson node");
+    buf += '{';
+    ++indentLevel;
+    bool first = true;
+    for (auto& it : *object) {
+        if (!first)
+            buf += ',';
+        first = false;
+        newline();
+        buf += '"';
+        buf += it.first.c_str();
+        buf += "\" : ";
+        append(it.second);
+    }
+    --indentLevel;
+    newline();
+    buf += '}';
+}
+
+void JsonWriter::beginObject() {
+    startValue();
+    buf += '{';
+    ++indentLevel;
+    firstInContainer.push_back(true);
+}
+
+void JsonWriter::endObject() {
+    BUG_CHECK(!firstInContainer.empty() && !keyPending, "Mismatched endObject");
+    firstInContainer.pop_back();
+    --indentLevel;
+    newline();
+    buf += '}';
+}
+
+void JsonWriter::beginArray() {
+    startValue();
+    buf += '[';
+    ++indentLevel;
+    firstInContainer.push_back(true);
+}
+
+void JsonWriter::endArray() {
+    BUG_CHECK(!firstInContainer.empty() && !keyPending, "Mismatched endArray");
+    firstInContainer.pop_back();
+    --indentLevel;
+    newline();
+    buf += ']';
+}
+
+void JsonWriter::key(cstring k) {
+    BUG_CHECK(!keyPending, "Two consecutive keys with no value");
+    separate();
+    buf += '"';
+    buf += k.c_str();
+    buf += "\" : ";
+    keyPending = true;
+}
+
+void JsonWriter::value(cstring v) {
+    startValue();
+    buf += '"';
+    if (const char* s = v.c_str())
+        buf += s;
+    buf += '"';
+}
+
+void JsonWriter::value(bool v) {
+    startValue();
+    buf += v ? "true" : "false";
+}
+
+void JsonWriter::value(const big_int& v) {
+    startValue();
+    Util::appendJsonNumber(buf, v);
+}
+
+void JsonWriter::valueNull() {
+    startValue();
+    buf += "null";
+}
+
+void JsonWriter::writeTo(std::ostream& out) const {
+    out.write(buf.data(), buf.size());
+}
+
+}  // namespace BMV2
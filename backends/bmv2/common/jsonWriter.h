@@ -0,0 +1,86 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_BMV2_COMMON_JSONWRITER_H_
+#define BACKENDS_BMV2_COMMON_JSONWRITER_H_
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "lib/cstring.h"
+#include "lib/gmputil.h"
+#include "lib/json.h"
+
+namespace BMV2 {
+
+/**
+ * A buffered, streaming JSON emitter for the bmv2 backend.
+ *
+ * The Util::IJson tree serializer goes through per-node virtual calls and a
+ * per-line std::endl (which flushes the stream); for a 30MB output document
+ * that dominates write time.  JsonWriter accumulates the whole document in
+ * one large append-only buffer with manual indentation control and writes it
+ * out in a single call.  It produces byte-identical output to
+ * Util::IJson::serialize.
+ *
+ * Two usage styles are supported and can be mixed:
+ *  - append(json): fast non-virtual serialization of an existing IJson tree;
+ *  - beginObject()/key()/value()/endObject() etc.: direct streaming emission
+ *    with no intermediate tree, for append-only construction patterns.
+ */
+class JsonWriter {
+    std::string buf;
+    int indentLevel = 0;
+    // one entry per open object/array: have we emitted its first element yet?
+    std::vector<bool> firstInContainer;
+    bool keyPending = false;  // a key() was emitted; the next value follows it
+
+    void newline();
+    void separate();    // comma+newline separation inside the open container
+    void startValue();  // separation due before a value, unless key() did it
+    void appendValue(const Util::JsonValue* value);
+
+ public:
+    explicit JsonWriter(size_t reserveBytes = 1 << 20) { buf.reserve(reserveBytes); }
+
+    /// Serialize an existing tree into the buffer (non-virtual traversal).
+    void append(const Util::IJson* json);
+
+    // Streaming construction.  Arrays built this way always use the
+    // one-element-per-line layout; the compact single-line form the tree
+    // serializer uses for all-scalar arrays requires knowing the elements in
+    // advance, which defeats streaming.
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(cstring k);
+    void value(cstring v);
+    void value(const char* v) { value(cstring(v)); }
+    void value(bool v);
+    void value(const big_int& v);
+    void value(int v) { value(big_int(v)); }
+    void valueNull();
+
+    const std::string& str() const { return buf; }
+    /// Write the accumulated document to @out in one call.
+    void writeTo(std::ostream& out) const;
+};
+
+}  // namespace BMV2
+
+#endif /* BACKENDS_BMV2_COMMON_JSONWRITER_H_ */
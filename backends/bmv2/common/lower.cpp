@@ -94,6 +94,13 @@ const IR::Node* LowerExpressions::postorder(IR::Slice* expression) {
     int l = expression->getL();
     auto e0type = typeMap->getType(expression->e0, true);
     BUG_CHECK(e0type->is<IR::Type_Bits>(), "%1%: expected a bit<> type", e0type);
+    auto bits = e0type->to<IR::Type_Bits>();
+    // A slice of the whole value is the value itself; it only needs a
+    // signedness conversion, handled below.
+    if (l == 0 && h == bits->size - 1 && !bits->isSigned) {
+        LOG3("Elided " << expression);
+        return expression->e0;
+    }
     const IR::Expression* expr;
     if (l != 0) {
         expr = new IR::Shr(expression->e0->srcInfo, expression->e0, new IR::Constant(l));
@@ -102,10 +109,13 @@ const IR::Node* LowerExpressions::postorder(IR::Slice* expression) {
         expr = expression->e0;
     }
 
-    // Narrowing cast.
-    auto type = IR::Type_Bits::get(h - l + 1, e0type->to<IR::Type_Bits>()->isSigned);
-    auto result = new IR::Cast(expression->srcInfo, type, expr);
-    typeMap->setType(result, type);
+    // Narrowing cast, unless the slice spans the whole value.
+    auto type = IR::Type_Bits::get(h - l + 1, bits->isSigned);
+    const IR::Expression* result = expr;
+    if (!typeMap->equivalent(type, e0type)) {
+        result = new IR::Cast(expression->srcInfo, type, expr);
+        typeMap->setType(result, type);
+    }
 
     // Signedness conversion.
     if (type->isSigned) {
@@ -132,16 +142,23 @@ const IR::Node* LowerExpressions::postorder(IR::Concat* expression) {
     auto cast1 = new IR::Cast(expression->right->srcInfo, resulttype, expression->right);
 
     auto sh = new IR::Shl(cast0->srcInfo, cast0, new IR::Constant(sizeofb));
-    big_int m = Util::maskFromSlice(sizeofb, 0);
-    auto mask = new IR::Constant(expression->right->srcInfo,
-                                 IR::Type_Bits::get(sizeofresult), m, 16);
-    auto and0 = new IR::BAnd(expression->right->srcInfo, cast1, mask);
+    const IR::Expression* and0;
+    if (!type->to<IR::Type_Bits>()->isSigned &&
+        !resulttype->to<IR::Type_Bits>()->isSigned) {
+        // Widening an unsigned value zero-extends, so the mask is redundant.
+        and0 = cast1;
+    } else {
+        big_int m = Util::maskFromSlice(sizeofb, 0);
+        auto mask = new IR::Constant(expression->right->srcInfo,
+                                     IR::Type_Bits::get(sizeofresult), m, 16);
+        and0 = new IR::BAnd(expression->right->srcInfo, cast1, mask);
+        typeMap->setType(and0, resulttype);
+    }
     auto result = new IR::BOr(expression->srcInfo, sh, and0);
     typeMap->setType(cast0, resulttype);
     typeMap->setType(cast1, resulttype);
     typeMap->setType(result, resulttype);
     typeMap->setType(sh, resulttype);
-    typeMap->setType(and0, resulttype);
     LOG3("Replaced " << expression << " with " << result);
     return result;
 }
@@ -292,7 +309,7 @@ RemoveComplexExpressions::postorder(IR::MethodCallExpression* expression) {
         return expression;
 
     if (auto ef = mi->to<P4::ExternFunction>()) {
-        if (ef->method->name == P4V1::V1Model::instance.digest_receiver.name) {
+        if (ef->method->name == P4V1::V1Model::instance().digest_receiver.name) {
             // Special handling for digest; the semantics on bmv2 is to
             // execute the digest at the very end of the pipeline, and to
             // pass a reference to the fields, so fields can be modified
@@ -356,8 +373,8 @@ const IR::Node*
 RemoveComplexExpressions::postorder(IR::MethodCallStatement* statement) {
     auto mi = P4::MethodInstance::resolve(statement, refMap, typeMap);
     if (auto em = mi->to<P4::ExternMethod>()) {
-        if (em->originalExternType->name != P4::P4CoreLibrary::instance.packetIn.name ||
-            em->method->name != P4::P4CoreLibrary::instance.packetIn.lookahead.name)
+        if (em->originalExternType->name != P4::P4CoreLibrary::instance().packetIn.name ||
+            em->method->name != P4::P4CoreLibrary::instance().packetIn.lookahead.name)
             return simpleStatement(statement);
         auto type = em->actualMethodType->returnType;
         auto name = refMap->newName("tmp");
@@ -21,6 +21,7 @@ limitations under the License.
 #include "lower.h"
 #include "frontends/common/options.h"
 #include "midend/convertEnums.h"
+#include "midend/expandEmit.h"
 
 namespace BMV2 {
 
@@ -50,6 +51,15 @@ class EnumOn32Bits : public P4::ChooseEnumRepresentation {
     explicit EnumOn32Bits(cstring filename) : filename(filename) { }
 };
 
+/**
+The deparser converter appends one JSON order entry per element when a
+whole stack is emitted, so stack emits need not be expanded into
+per-element statements in the midend.
+*/
+class KeepStackEmits : public P4::ExpandEmitPolicy {
+    bool expandStack(const IR::Type_Stack*) const override { return false; }
+};
+
 class MidEnd : public PassManager {
  public:
     // These will be accurate when the mid-end completes evaluation
@@ -28,14 +28,29 @@ class BMV2Options : public CompilerOptions {
     bool emitExterns = false;
     // file to output to
     cstring outputFile = nullptr;
+    // emit a single definition for actions with identical bodies
+    bool dedupActions = false;
     // read from json
     bool loadIRFromJson = false;
+    // read from binary IR
+    bool loadIRFromBin = false;
+    // file to dump the midend IR to, in binary form
+    cstring dumpBinIRFile = nullptr;
+    // binary side file for large const-entry tables
+    cstring entriesFile = nullptr;
+    // write the output artifact as CBOR instead of JSON text
+    bool cborOutput = false;
 
     BMV2Options() {
         registerOption("--emit-externs", nullptr,
                 [this](const char*) { emitExterns = true; return true; },
                 "[BMv2 back-end] Force externs be emitted by the backend.\n"
                 "The generated code follows the BMv2 JSON specification.");
+        registerOption("--dedup-actions", nullptr,
+                [this](const char*) { dedupActions = true; return true; },
+                "[BMv2 back-end] Emit one action definition when several\n"
+                "actions (e.g. per-table copies of the same action) convert\n"
+                "to identical JSON, and reference it from all their users.");
         registerOption("-o", "outfile",
                 [this](const char* arg) { outputFile = arg; return true; },
                 "Write output to outfile");
@@ -43,6 +58,25 @@ class BMV2Options : public CompilerOptions {
                 [this](const char* arg) { loadIRFromJson = true; file = arg; return true; },
                 "Use IR representation from JsonFile dumped previously,"\
                 "the compilation starts with reduced midEnd.");
+        registerOption("--fromBinIR", "file",
+                [this](const char* arg) { loadIRFromBin = true; file = arg; return true; },
+                "Like --fromJSON, but reads the compact binary IR format\n"
+                "written by --toBinIR.");
+        registerOption("--toBinIR", "file",
+                [this](const char* arg) { dumpBinIRFile = arg; return true; },
+                "Dump the IR to file in the compact binary format\n"
+                "(smaller and much faster to reload than --toJSON).");
+        registerOption("--cbor", nullptr,
+                [this](const char*) { cborOutput = true; return true; },
+                "[BMv2 back-end] Write the output file as CBOR (RFC 7049),\n"
+                "a structural equivalent of the JSON that is smaller and\n"
+                "cheaper to parse; p4c-bm2-cbor2json converts it back to\n"
+                "JSON text for consumers that need it.");
+        registerOption("--entries-file", "file",
+                [this](const char* arg) { entriesFile = arg; return true; },
+                "[BMv2 back-end] Emit large const-entry tables as fixed-width\n"
+                "binary records in this side file, keeping only metadata in\n"
+                "the JSON (see common/binaryEntries.h for the format).");
     }
 };
 
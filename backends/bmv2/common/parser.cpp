@@ -203,7 +203,7 @@ Util::IJson* ParserConverter::convertParserStatement(const IR::StatOrDecl* stat)
                 paramsArray->append(expr);
                 paramValue->emplace("op", extFuncName);
                 paramValue->emplace_non_null("source_info", mce->sourceInfoJsonObj());
-            } else if (extFuncName == P4V1::V1Model::instance.log_msg.name) {
+            } else if (extFuncName == P4V1::V1Model::instance().log_msg.name) {
                 BUG_CHECK(mce->arguments->size() == 2 || mce->arguments->size() == 1,
                             "%1%: Expected 1 or 2 arguments", mce);
                 result->emplace("op", "primitive");
@@ -357,12 +357,18 @@ unsigned ParserConverter::combine(const IR::Expression* keySet,
     } else if (keySet->is<IR::PathExpression>()) {
         auto pe = keySet->to<IR::PathExpression>();
         auto decl = ctxt->refMap->getDeclaration(pe->path, true);
-        vset_name = decl->controlPlaneName();
         is_vset = true;
-        auto vset = decl->to<IR::P4ValueSet>();
-        CHECK_NULL(vset);
-        auto type = ctxt->typeMap->getTypeType(vset->elementType, true);
-        return ROUNDUP(type->width_bits(), 8);
+        auto cached = vsetCache.find(decl);
+        if (cached == vsetCache.end()) {
+            auto vset = decl->to<IR::P4ValueSet>();
+            CHECK_NULL(vset);
+            auto type = ctxt->typeMap->getTypeType(vset->elementType, true);
+            unsigned bytes = ROUNDUP(type->width_bits(), 8);
+            cached = vsetCache.emplace(
+                decl, std::make_pair(decl->controlPlaneName(), bytes)).first;
+        }
+        vset_name = cached->second.first;
+        return cached->second.second;
     } else {
         BUG_CHECK(select->components.size() == 1, "%1%: mismatched select/label", select);
         convertSimpleKey(keySet, value, mask);
@@ -424,7 +430,14 @@ Util::IJson*
 ParserConverter::convertSelectKey(const IR::SelectExpression* expr) {
     auto se = expr->to<IR::SelectExpression>();
     CHECK_NULL(se);
+    // States of an unrolled parser typically select on the same
+    // expressions; sharing the converted key avoids re-serializing it
+    // for every state.
+    for (auto& cached : selectKeyCache)
+        if (cached.first->equiv(*se->select))
+            return cached.second;
     auto key = ctxt->conv->convert(se->select, false);
+    selectKeyCache.emplace_back(se->select, key);
     return key;
 }
 
@@ -457,7 +470,7 @@ void ParserConverter::addValueSets(const IR::P4Parser* parser) {
         auto matchTypeDecl = ctxt->refMap->getDeclaration(matchPathExpr->path, true)
             ->to<IR::Declaration_ID>();
         BUG_CHECK(matchTypeDecl != nullptr, "No declaration for match type '%1%'", matchPathExpr);
-        return (matchTypeDecl->name.name == P4::P4CoreLibrary::instance.exactMatch.name);
+        return (matchTypeDecl->name.name == P4::P4CoreLibrary::instance().exactMatch.name);
     };
 
     for (auto s : parser->parserLocals) {
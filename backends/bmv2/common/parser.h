@@ -32,6 +32,12 @@ class ParserConverter : public Inspector {
     ConversionContext*   ctxt;
     cstring              name;
     P4::P4CoreLibrary&   corelib;
+    /// Transition keys already converted, reused for states whose select
+    /// expression is structurally identical; unrolled parsers repeat the
+    /// same select in many states.
+    std::vector<std::pair<const IR::ListExpression*, Util::IJson*>> selectKeyCache;
+    /// Caches the control-plane name and byte width of each value set.
+    mutable std::map<const IR::IDeclaration*, std::pair<cstring, unsigned>> vsetCache;
 
  protected:
     void convertSimpleKey(const IR::Expression* keySet, big_int& value, big_int& mask) const;
@@ -49,7 +55,7 @@ class ParserConverter : public Inspector {
  public:
     bool preorder(const IR::P4Parser* p) override;
     explicit ParserConverter(ConversionContext* ctxt, cstring name = "parser")
-        : ctxt(ctxt), name(name), corelib(P4::P4CoreLibrary::instance) {
+        : ctxt(ctxt), name(name), corelib(P4::P4CoreLibrary::instance()) {
         setName("ParserConverter");
     }
 };
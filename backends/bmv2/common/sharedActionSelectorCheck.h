@@ -17,7 +17,8 @@ limitations under the License.
 #ifndef BACKENDS_BMV2_COMMON_SHAREDACTIONSELECTORCHECK_H_
 #define BACKENDS_BMV2_COMMON_SHAREDACTIONSELECTORCHECK_H_
 
-#include <algorithm>
+#include <map>
+#include <sstream>
 #include "ir/ir.h"
 #include "lib/json.h"
 #include "lib/error.h"
@@ -40,25 +41,40 @@ class SharedActionSelectorCheck : public Inspector {
     BMV2::ConversionContext* ctxt;
     P4::ReferenceMap* refMap;
     P4::TypeMap*      typeMap;
+    /// Canonical form of the selector input of the first table seen
+    /// using each selector instance; later tables compare against it
+    /// with a single interned-string comparison.
+    std::map<const IR::Declaration_Instance*, cstring> selectorFingerprints;
+
+  static void fingerprintKeyExpr(const IR::Expression* expr, std::ostream& out) {
+      if (auto pe = expr->to<IR::PathExpression>()) {
+          if (pe->path->absolute)
+              out << ".";
+          out << pe->path->name;
+      } else if (auto mem = expr->to<IR::Member>()) {
+          fingerprintKeyExpr(mem->expr, out);
+          out << "." << mem->member;
+      } else if (auto l = expr->to<IR::Literal>()) {
+          out << l->node_type_name() << "<" << l->type << ">(" << *l << ")";
+      } else if (auto ai = expr->to<IR::ArrayIndex>()) {
+          fingerprintKeyExpr(ai->left, out);
+          out << "[";
+          fingerprintKeyExpr(ai->right, out);
+          out << "]";
+      } else {
+          // Other expressions never compare equal; make their
+          // fingerprint unique.
+          out << "?" << static_cast<const void*>(expr);
+      }
+  }
 
-  static bool checkSameKeyExpr(const IR::Expression* expr0, const IR::Expression* expr1) {
-      if (expr0->node_type_name() != expr1->node_type_name())
-          return false;
-      if (auto pe0 = expr0->to<IR::PathExpression>()) {
-          auto pe1 = expr1->to<IR::PathExpression>();
-          return pe0->path->name == pe1->path->name &&
-              pe0->path->absolute == pe1->path->absolute;
-      } else if (auto mem0 = expr0->to<IR::Member>()) {
-          auto mem1 = expr1->to<IR::Member>();
-          return checkSameKeyExpr(mem0->expr, mem1->expr) && mem0->member == mem1->member;
-      } else if (auto l0 = expr0->to<IR::Literal>()) {
-          auto l1 = expr1->to<IR::Literal>();
-          return *l0 == *l1;
-      } else if (auto ai0 = expr0->to<IR::ArrayIndex>()) {
-          auto ai1 = expr1->to<IR::ArrayIndex>();
-          return checkSameKeyExpr(ai0->left, ai1->left) && checkSameKeyExpr(ai0->right, ai1->right);
+  static cstring fingerprint(const SelectorInput& input) {
+      std::ostringstream out;
+      for (auto e : input) {
+          fingerprintKeyExpr(e, out);
+          out << ";";
       }
-      return false;
+      return cstring(out.str());
   }
 
  public:
@@ -101,18 +117,15 @@ class SharedActionSelectorCheck : public Inspector {
             input.push_back(ke->expression);
         }
         auto decl_instance = decl->to<IR::Declaration_Instance>();
-        auto it = ctxt->selector_input_map.find(decl_instance);
-        if (it == ctxt->selector_input_map.end()) {
+        auto fp = fingerprint(input);
+        auto it = selectorFingerprints.find(decl_instance);
+        if (it == selectorFingerprints.end()) {
+            selectorFingerprints.emplace(decl_instance, fp);
             ctxt->selector_input_map[decl_instance] = input;
             return false;
         }
-        // returns true if inputs are the same, false otherwise
-        auto cmp_inputs = [](const SelectorInput &i1, const SelectorInput &i2) {
-            if (i1.size() != i2.size()) return false;
-            return std::equal(i1.begin(), i1.end(), i2.begin(), checkSameKeyExpr);
-        };
 
-        if (!cmp_inputs(it->second, input)) {
+        if (it->second != fp) {
             ::error(ErrorType::ERR_INVALID,
                     "Action selector %1% is used by multiple tables with different selector inputs",
                     decl);
@@ -15,13 +15,17 @@ limitations under the License.
 */
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <iostream>
 
 #include "ir/ir.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileBatch.h"
+#include "frontends/common/compileServer.h"
 #include "frontends/common/parseInput.h"
+#include "frontends/common/watch.h"
 #include "frontends/p4/frontend.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
@@ -29,23 +33,23 @@ limitations under the License.
 #include "lib/log.h"
 #include "lib/nullstream.h"
 #include "backends/bmv2/common/JsonObjects.h"
+#include "backends/bmv2/common/binaryEntries.h"
 #include "backends/bmv2/psa_switch/midend.h"
 #include "backends/bmv2/psa_switch/psaSwitch.h"
 #include "backends/bmv2/psa_switch/version.h"
 #include "backends/bmv2/psa_switch/options.h"
+#include "ir/binary_io.h"
 #include "ir/json_loader.h"
 #include "fstream"
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-
+static int compile(int argc, char *const argv[]) {
     AutoCompileContext autoPsaSwitchContext(new BMV2::PsaSwitchContext);
     auto& options = BMV2::PsaSwitchContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
     options.compilerVersion = BMV2_PSA_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-            if (options.loadIRFromJson == false)
+            if (options.loadIRFromJson == false && options.loadIRFromBin == false)
                     options.setInputFile();
     }
     if (::errorCount() > 0)
@@ -60,7 +64,19 @@ int main(int argc, char *const argv[]) {
     const IR::ToplevelBlock* toplevel = nullptr;
 
 
-    if (options.loadIRFromJson == false) {
+    if (options.loadIRFromBin) {
+        std::ifstream bin(options.file, std::ios::binary);
+        if (!bin) {
+            ::error(ErrorType::ERR_IO, "%s: No such file or directory.", options.file);
+            return 1;
+        }
+        auto node = loadBinaryIR(bin);
+        if (node == nullptr || (program = node->to<IR::P4Program>()) == nullptr) {
+            ::error(ErrorType::ERR_INVALID, "%s is not a P4Program in binary IR format",
+                    options.file);
+            return 1;
+        }
+    } else if (options.loadIRFromJson == false) {
         program = P4::parseP4File(options);
 
         if (program == nullptr || ::errorCount() > 0)
@@ -79,19 +95,15 @@ int main(int argc, char *const argv[]) {
         if (program == nullptr || ::errorCount() > 0)
             return 1;
     } else {
-        std::filebuf fb;
-        if (fb.open(options.file, std::ios::in) == nullptr) {
-            ::error(ErrorType::ERR_IO, "%s: No such file or directory.", options.file);
+        std::istream* inJson = openInputFile(options.file);
+        if (inJson == nullptr)
             return 1;
-        }
-        std::istream inJson(&fb);
-        JSONLoader jsonFileLoader(inJson);
+        JSONLoader jsonFileLoader(*inJson);
         if (jsonFileLoader.json == nullptr) {
             ::error(ErrorType::ERR_IO, "%s: Not valid input file", options.file);
             return 1;
         }
         program = new IR::P4Program(jsonFileLoader);
-        fb.close();
     }
 
     P4::serializeP4RuntimeIfRequired(program, options);
@@ -105,8 +117,16 @@ int main(int argc, char *const argv[]) {
         if (::errorCount() > 1 || toplevel == nullptr ||
             toplevel->getMain() == nullptr)
             return 1;
-        if (options.dumpJsonFile)
-            JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+        if (options.dumpJsonFile) {
+            auto dump = openFile(options.dumpJsonFile, true);
+            JSONGenerator(*dump, true) << program << std::endl;
+            closeFile(dump);
+        }
+        if (options.dumpBinIRFile && !options.loadIRFromBin) {
+            auto dump = openFile(options.dumpBinIRFile, true);
+            saveBinaryIR(program, *dump);
+            closeFile(dump);
+        }
     } catch (const std::exception &bug) {
         std::cerr << bug.what() << std::endl;
         return 1;
@@ -128,13 +148,39 @@ int main(int argc, char *const argv[]) {
     if (::errorCount() > 0)
         return 1;
 
+    if (options.entriesFile != nullptr)
+        BMV2::externalizeTableEntries(backend->json->toplevel, options.entriesFile);
+
     if (!options.outputFile.isNullOrEmpty()) {
         std::ostream* out = openFile(options.outputFile, false);
         if (out != nullptr) {
-            backend->serialize(*out);
-            out->flush();
+            if (options.cborOutput)
+                backend->json->toplevel->serializeCBOR(*out);
+            else
+                backend->serialize(*out);
+            closeFile(out);
         }
     }
 
+    // prints warnings recorded under --Wdefer; a no-op otherwise
+    P4CContext::get().errorReporter().flushDeferredWarnings();
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+
+    // Daemon, batch and watch modes are handled before option processing:
+    // the driver process itself never compiles anything, each job parses
+    // its own options.
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--watch"))
+            return P4::Watch::run(argc, argv, compile);
+        if (i + 1 < argc && !strcmp(argv[i], "--compile-server"))
+            return P4::CompileServer::run(argv[i + 1], compile, P4::warmStandardLibrary);
+        if (i + 1 < argc && !strcmp(argv[i], "--batch"))
+            return P4::CompileBatch::run(argv[i + 1], argc, argv, compile);
+    }
+
+    return compile(argc, argv);
+}
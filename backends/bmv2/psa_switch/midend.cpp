@@ -33,7 +33,6 @@ limitations under the License.
 #include "midend/copyStructures.h"
 #include "midend/eliminateTuples.h"
 #include "midend/eliminateNewtype.h"
-#include "midend/eliminateSerEnums.h"
 #include "midend/eliminateSwitch.h"
 #include "midend/flattenHeaders.h"
 #include "midend/flattenInterfaceStructs.h"
@@ -93,7 +92,9 @@ class PsaEnumOn32Bits : public P4::ChooseEnumRepresentation {
 
 PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions& options, std::ostream* outStream)
                                 : MidEnd(options) {
-    auto convertEnums = new P4::ConvertEnums(&refMap, &typeMap, new PsaEnumOn32Bits("psa.p4"));
+    // also eliminates serializable enums, in the same traversal
+    auto convertEnums = new P4::ConvertEnums(&refMap, &typeMap,
+                                             new PsaEnumOn32Bits("psa.p4"), true);
     auto evaluator = new P4::EvaluatorPass(&refMap, &typeMap);
     std::function<bool(const Context *, const IR::Expression *)> policy =
             [=](const Context *, const IR::Expression *e) -> bool {
@@ -117,10 +118,11 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions& options, std::ostream* outStre
             options.ndebug ? new P4::RemoveAssertAssume(&refMap, &typeMap) : nullptr,
             new P4::RemoveMiss(&refMap, &typeMap),
             new P4::EliminateNewtype(&refMap, &typeMap),
-            new P4::EliminateSerEnums(&refMap, &typeMap),
             new P4::RemoveActionParameters(&refMap, &typeMap),
-            convertEnums,
-            [this, convertEnums]() { enumMap = convertEnums->getEnumMapping(); },
+            new PassIfFeature(FeatureCensus::Enums | FeatureCensus::SerEnums, {
+                convertEnums,
+                [this, convertEnums]() { enumMap = convertEnums->getEnumMapping(); },
+            }),
             new P4::OrderArguments(&refMap, &typeMap),
             new P4::TypeChecking(&refMap, &typeMap),
             new P4::SimplifyKey(&refMap, &typeMap,
@@ -131,17 +133,17 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions& options, std::ostream* outStre
             new P4::StrengthReduction(&refMap, &typeMap),
             new P4::SimplifySelectCases(&refMap, &typeMap, true),  // require constant keysets
             new P4::ExpandLookahead(&refMap, &typeMap),
-            new P4::ExpandEmit(&refMap, &typeMap),
+            new P4::ExpandEmit(&refMap, &typeMap, new KeepStackEmits()),
             new P4::SimplifyParsers(&refMap),
             new P4::StrengthReduction(&refMap, &typeMap),
-            new P4::EliminateTuples(&refMap, &typeMap),
+            new PassIfFeature(FeatureCensus::Tuples,
+                              {new P4::EliminateTuples(&refMap, &typeMap)}),
             new P4::SimplifyComparisons(&refMap, &typeMap),
             new P4::CopyStructures(&refMap, &typeMap),
             new P4::NestedStructs(&refMap, &typeMap),
             new P4::SimplifySelectList(&refMap, &typeMap),
             new P4::RemoveSelectBooleans(&refMap, &typeMap),
-            new P4::FlattenHeaders(&refMap, &typeMap),
-            new P4::FlattenInterfaceStructs(&refMap, &typeMap),
+            new P4::FlattenHeadersAndInterfaceStructs(&refMap, &typeMap),
             new P4::ReplaceSelectRange(&refMap, &typeMap),
             new P4::Predication(&refMap),
             new P4::MoveDeclarations(),  // more may have been introduced
@@ -158,7 +160,8 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions& options, std::ostream* outStre
             new P4::SimplifyControlFlow(&refMap, &typeMap),
             new P4::CompileTimeOperations(),
             new P4::TableHit(&refMap, &typeMap),
-            new P4::EliminateSwitch(&refMap, &typeMap),
+            new PassIfFeature(FeatureCensus::Switches,
+                              {new P4::EliminateSwitch(&refMap, &typeMap)}),
             new P4::MoveActionsToTables(&refMap, &typeMap),
             new P4::RemoveLeftSlices(&refMap, &typeMap),
             new P4::TypeChecking(&refMap, &typeMap),
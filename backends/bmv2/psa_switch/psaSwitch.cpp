@@ -566,9 +566,8 @@ void PsaSwitchBackend::convert(const IR::ToplevelBlock* tlb) {
         /* TODO */
         // new RenameUserMetadata(refMap, userMetaType, userMetaName),
         new P4::ClearTypeMap(typeMap),  // because the user metadata type has changed
-        new P4::SynthesizeActions(refMap, typeMap,
-                new SkipControls(&structure.non_pipeline_controls)),
-        new P4::MoveActionsToTables(refMap, typeMap),
+        new P4::SynthesizeActionsAndMoveToTables(
+            refMap, typeMap, new SkipControls(&structure.non_pipeline_controls)),
         new P4::TypeChecking(refMap, typeMap),
         new P4::SimplifyControlFlow(refMap, typeMap),
         new LowerExpressions(typeMap),
@@ -1122,7 +1121,7 @@ void ExternConverter_ActionProfile::convertExternInstance(
     cstring name = inst->controlPlaneName();
     // Might call this multiple times if the selector/profile is used more than
     // once in a pipeline, so only add it to the action_profiles once
-    if (BMV2::JsonObjects::find_object_by_name(ctxt->action_profiles, name))
+    if (!ctxt->action_profile_names.insert(name).second)
         return;
     auto action_profile = new Util::JsonObject();
     action_profile->emplace("name", name);
@@ -1148,7 +1147,7 @@ void ExternConverter_ActionSelector::convertExternInstance(
     cstring name = inst->controlPlaneName();
     // Might call this multiple times if the selector/profile is used more than
     // once in a pipeline, so only add it to the action_profiles once
-    if (BMV2::JsonObjects::find_object_by_name(ctxt->action_profiles, name))
+    if (!ctxt->action_profile_names.insert(name).second)
         return;
     auto action_profile = new Util::JsonObject();
     action_profile->emplace("name", name);
@@ -15,37 +15,43 @@ limitations under the License.
 */
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <iostream>
+#include <sstream>
 
 #include "ir/ir.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileBatch.h"
+#include "frontends/common/compileServer.h"
 #include "frontends/common/parseInput.h"
+#include "frontends/common/watch.h"
 #include "frontends/p4/frontend.h"
+#include "lib/async_writer.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
 #include "backends/bmv2/common/JsonObjects.h"
+#include "backends/bmv2/common/binaryEntries.h"
 #include "backends/bmv2/simple_switch/midend.h"
 #include "backends/bmv2/simple_switch/simpleSwitch.h"
 #include "backends/bmv2/simple_switch/version.h"
 #include "backends/bmv2/simple_switch/options.h"
+#include "ir/binary_io.h"
 #include "ir/json_loader.h"
 #include "fstream"
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-
+static int compile(int argc, char *const argv[]) {
     AutoCompileContext autoBMV2Context(new BMV2::SimpleSwitchContext);
     auto& options = BMV2::SimpleSwitchContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
     options.compilerVersion = BMV2_SIMPLESWITCH_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-            if (options.loadIRFromJson == false)
+            if (options.loadIRFromJson == false && options.loadIRFromBin == false)
                     options.setInputFile();
     }
     if (::errorCount() > 0)
@@ -60,7 +66,19 @@ int main(int argc, char *const argv[]) {
     const IR::ToplevelBlock* toplevel = nullptr;
 
 
-    if (options.loadIRFromJson == false) {
+    if (options.loadIRFromBin) {
+        std::ifstream bin(options.file, std::ios::binary);
+        if (!bin) {
+            ::error(ErrorType::ERR_IO, "%s: No such file or directory.", options.file);
+            return 1;
+        }
+        auto node = loadBinaryIR(bin);
+        if (node == nullptr || (program = node->to<IR::P4Program>()) == nullptr) {
+            ::error(ErrorType::ERR_INVALID, "%s is not a P4Program in binary IR format",
+                    options.file);
+            return 1;
+        }
+    } else if (options.loadIRFromJson == false) {
         program = P4::parseP4File(options);
 
         if (program == nullptr || ::errorCount() > 0)
@@ -79,19 +97,15 @@ int main(int argc, char *const argv[]) {
         if (program == nullptr || ::errorCount() > 0)
             return 1;
     } else {
-        std::filebuf fb;
-        if (fb.open(options.file, std::ios::in) == nullptr) {
-            ::error(ErrorType::ERR_IO, "%s: No such file or directory.", options.file);
+        std::istream* inJson = openInputFile(options.file);
+        if (inJson == nullptr)
             return 1;
-        }
-        std::istream inJson(&fb);
-        JSONLoader jsonFileLoader(inJson);
+        JSONLoader jsonFileLoader(*inJson);
         if (jsonFileLoader.json == nullptr) {
             ::error(ErrorType::ERR_IO, "%s: Not valid json input file", options.file);
             return 1;
         }
         program = new IR::P4Program(jsonFileLoader);
-        fb.close();
     }
 
     P4::serializeP4RuntimeIfRequired(program, options);
@@ -105,8 +119,20 @@ int main(int argc, char *const argv[]) {
         if (::errorCount() > 1 || toplevel == nullptr ||
             toplevel->getMain() == nullptr)
             return 1;
-        if (options.dumpJsonFile && !options.loadIRFromJson)
-            JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+        // The dumps are serialized here but written on the background writer
+        // thread, overlapping with the backend conversion below.
+        if (options.dumpJsonFile && !options.loadIRFromJson) {
+            auto dump = openFile(options.dumpJsonFile, true);
+            std::stringstream buffer;
+            JSONGenerator(buffer, true) << program << std::endl;
+            Util::AsyncWriter::write(options.dumpJsonFile, dump, buffer.str());
+        }
+        if (options.dumpBinIRFile && !options.loadIRFromBin) {
+            auto dump = openFile(options.dumpBinIRFile, true);
+            std::stringstream buffer;
+            saveBinaryIR(program, buffer);
+            Util::AsyncWriter::write(options.dumpBinIRFile, dump, buffer.str());
+        }
     } catch (const std::exception &bug) {
         std::cerr << bug.what() << std::endl;
         return 1;
@@ -128,13 +154,43 @@ int main(int argc, char *const argv[]) {
     if (::errorCount() > 0)
         return 1;
 
+    if (options.entriesFile != nullptr)
+        BMV2::externalizeTableEntries(backend->json->toplevel, options.entriesFile);
+
     if (!options.outputFile.isNullOrEmpty()) {
         std::ostream* out = openFile(options.outputFile, false);
         if (out != nullptr) {
-            backend->serialize(*out);
-            out->flush();
+            std::stringstream buffer;
+            if (options.cborOutput)
+                backend->json->toplevel->serializeCBOR(buffer);
+            else
+                backend->serialize(buffer);
+            Util::AsyncWriter::write(options.outputFile, out, buffer.str());
         }
     }
 
+    // Failed background writes surface as I/O errors here, before the exit
+    // code is computed.
+    Util::AsyncWriter::waitForAll();
+    // prints warnings recorded under --Wdefer; a no-op otherwise
+    P4CContext::get().errorReporter().flushDeferredWarnings();
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+
+    // Daemon, batch and watch modes are handled before option processing:
+    // the driver process itself never compiles anything, each job parses
+    // its own options.
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--watch"))
+            return P4::Watch::run(argc, argv, compile);
+        if (i + 1 < argc && !strcmp(argv[i], "--compile-server"))
+            return P4::CompileServer::run(argv[i + 1], compile, P4::warmStandardLibrary);
+        if (i + 1 < argc && !strcmp(argv[i], "--batch"))
+            return P4::CompileBatch::run(argv[i + 1], argc, argv, compile);
+    }
+
+    return compile(argc, argv);
+}
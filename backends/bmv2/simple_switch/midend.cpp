@@ -32,9 +32,9 @@ limitations under the License.
 #include "midend/complexComparison.h"
 #include "midend/convertEnums.h"
 #include "midend/copyStructures.h"
+#include "midend/cse.h"
 #include "midend/eliminateTuples.h"
 #include "midend/eliminateNewtype.h"
-#include "midend/eliminateSerEnums.h"
 #include "midend/eliminateSwitch.h"
 #include "midend/flattenHeaders.h"
 #include "midend/flattenInterfaceStructs.h"
@@ -68,16 +68,19 @@ SimpleSwitchMidEnd::SimpleSwitchMidEnd(CompilerOptions& options, std::ostream* o
 : MidEnd(options) {
     auto evaluator = new P4::EvaluatorPass(&refMap, &typeMap);
     if (BMV2::SimpleSwitchContext::get().options().loadIRFromJson == false) {
-        auto convertEnums = new P4::ConvertEnums(&refMap, &typeMap, new EnumOn32Bits("v1model.p4"));
+        // also eliminates serializable enums, in the same traversal
+        auto convertEnums = new P4::ConvertEnums(&refMap, &typeMap,
+                                                 new EnumOn32Bits("v1model.p4"), true);
         addPasses({
             options.ndebug ? new P4::RemoveAssertAssume(&refMap, &typeMap) : nullptr,
             new P4::CheckTableSize(),
             new P4::RemoveMiss(&refMap, &typeMap),
             new P4::EliminateNewtype(&refMap, &typeMap),
-            new P4::EliminateSerEnums(&refMap, &typeMap),
             new P4::RemoveActionParameters(&refMap, &typeMap),
-            convertEnums,
-            [this, convertEnums]() { enumMap = convertEnums->getEnumMapping(); },
+            new PassIfFeature(FeatureCensus::Enums | FeatureCensus::SerEnums, {
+                convertEnums,
+                [this, convertEnums]() { enumMap = convertEnums->getEnumMapping(); },
+            }),
             new P4::OrderArguments(&refMap, &typeMap),
             new P4::TypeChecking(&refMap, &typeMap),
             new P4::SimplifyKey(&refMap, &typeMap,
@@ -88,21 +91,22 @@ SimpleSwitchMidEnd::SimpleSwitchMidEnd(CompilerOptions& options, std::ostream* o
             new P4::StrengthReduction(&refMap, &typeMap),
             new P4::SimplifySelectCases(&refMap, &typeMap, true),  // require constant keysets
             new P4::ExpandLookahead(&refMap, &typeMap),
-            new P4::ExpandEmit(&refMap, &typeMap),
+            new P4::ExpandEmit(&refMap, &typeMap, new KeepStackEmits()),
             new P4::SimplifyParsers(&refMap),
             new P4::StrengthReduction(&refMap, &typeMap),
-            new P4::EliminateTuples(&refMap, &typeMap),
+            new PassIfFeature(FeatureCensus::Tuples,
+                              {new P4::EliminateTuples(&refMap, &typeMap)}),
             new P4::SimplifyComparisons(&refMap, &typeMap),
             new P4::CopyStructures(&refMap, &typeMap),
             new P4::NestedStructs(&refMap, &typeMap),
             new P4::SimplifySelectList(&refMap, &typeMap),
             new P4::RemoveSelectBooleans(&refMap, &typeMap),
-            new P4::FlattenHeaders(&refMap, &typeMap),
-            new P4::FlattenInterfaceStructs(&refMap, &typeMap),
+            new P4::FlattenHeadersAndInterfaceStructs(&refMap, &typeMap),
             new P4::ReplaceSelectRange(&refMap, &typeMap),
             new P4::Predication(&refMap),
             new P4::MoveDeclarations(),  // more may have been introduced
             new P4::ConstantFolding(&refMap, &typeMap),
+            new P4::GlobalCSE(&refMap, &typeMap),
             new P4::LocalCopyPropagation(&refMap, &typeMap),
             new P4::ConstantFolding(&refMap, &typeMap),
             new P4::StrengthReduction(&refMap, &typeMap),
@@ -119,7 +123,8 @@ SimpleSwitchMidEnd::SimpleSwitchMidEnd(CompilerOptions& options, std::ostream* o
             new P4::SimplifyControlFlow(&refMap, &typeMap),
             new P4::CompileTimeOperations(),
             new P4::TableHit(&refMap, &typeMap),
-            new P4::EliminateSwitch(&refMap, &typeMap),
+            new PassIfFeature(FeatureCensus::Switches,
+                              {new P4::EliminateSwitch(&refMap, &typeMap)}),
             new P4::RemoveLeftSlices(&refMap, &typeMap),
             // p4c-bm removed unused action parameters. To produce a compatible
             // control plane API, we remove them as well for P4-14 programs.
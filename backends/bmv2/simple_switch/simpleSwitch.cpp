@@ -694,7 +694,7 @@ void ExternConverter_action_profile::convertExternInstance(
     cstring name = inst->controlPlaneName();
     // Might call this multiple times if the selector/profile is used more than
     // once in a pipeline, so only add it to the action_profiles once
-    if (BMV2::JsonObjects::find_object_by_name(ctxt->action_profiles, name))
+    if (!ctxt->action_profile_names.insert(name).second)
         return;
     auto action_profile = new Util::JsonObject();
     action_profile->emplace("name", name);
@@ -753,7 +753,7 @@ void ExternConverter_action_selector::convertExternInstance(
     cstring name = inst->controlPlaneName();
     // Might call this multiple times if the selector/profile is used more than
     // once in a pipeline, so only add it to the action_profiles once
-    if (BMV2::JsonObjects::find_object_by_name(ctxt->action_profiles, name))
+    if (!ctxt->action_profile_names.insert(name).second)
         return;
     auto action_profile = new Util::JsonObject();
     action_profile->emplace("name", name);
@@ -981,7 +981,7 @@ SimpleSwitchBackend::convertChecksum(const IR::BlockStatement *block, Util::Json
 }
 
 void SimpleSwitchBackend::createActions(ConversionContext* ctxt, V1ProgramStructure* structure) {
-    auto cvt = new ActionConverter(ctxt, options.emitExterns);
+    auto cvt = new ActionConverter(ctxt, options.emitExterns, options.dedupActions);
     for (auto it : structure->actions) {
         auto action = it.first;
         action->apply(*cvt);
@@ -1080,9 +1080,8 @@ SimpleSwitchBackend::convert(const IR::ToplevelBlock* tlb) {
         // and ParseAnnotations should be skipped
         new RenameUserMetadata(refMap, userMetaType, userMetaName),
         new P4::ClearTypeMap(typeMap),  // because the user metadata type has changed
-        new P4::SynthesizeActions(refMap, typeMap,
-                                  new SkipControls(&structure->non_pipeline_controls)),
-        new P4::MoveActionsToTables(refMap, typeMap),
+        new P4::SynthesizeActionsAndMoveToTables(
+            refMap, typeMap, new SkipControls(&structure->non_pipeline_controls)),
         new P4::TypeChecking(refMap, typeMap),
         new P4::SimplifyControlFlow(refMap, typeMap),
         new LowerExpressions(typeMap),
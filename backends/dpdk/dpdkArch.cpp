@@ -342,6 +342,9 @@ const IR::Node *InjectJumboStruct::preorder(IR::Type_Struct *s) {
 }
 
 const IR::Node *StatementUnroll::preorder(IR::AssignmentStatement *a) {
+    // Temporaries of the previous statement are dead by now and their
+    // slots can be reused for this one.
+    collector->release_tmps();
     auto code_block = new IR::IndexedVector<IR::StatOrDecl>;
     auto right = a->right;
     auto control = findOrigCtxt<IR::P4Control>();
@@ -425,10 +428,12 @@ const IR::Node *StatementUnroll::preorder(IR::AssignmentStatement *a) {
 }
 
 const IR::Node *StatementUnroll::postorder(IR::P4Control *a) {
+    collector->clear_tmps();  // slot declarations are scoped to the control
     auto control = getOriginal();
     return injector.inject_control(control, a);
 }
 const IR::Node *StatementUnroll::postorder(IR::P4Parser *a) {
+    collector->clear_tmps();
     auto parser = getOriginal();
     return injector.inject_parser(parser, a);
 }
@@ -451,9 +456,12 @@ bool ExpressionUnroll::preorder(const IR::Operation_Unary *u) {
     } else {
         un_expr = u->expr;
     }
-    root = new IR::PathExpression(IR::ID(refMap->newName("tmp")));
+    bool fresh;
+    root = new IR::PathExpression(
+        IR::ID(collector->get_tmp(u->type, refMap, &fresh)));
     stmt.push_back(new IR::AssignmentStatement(root, un_expr));
-    decl.push_back(new IR::Declaration_Variable(root->path->name, u->type));
+    if (fresh)
+        decl.push_back(new IR::Declaration_Variable(root->path->name, u->type));
     return false;
 }
 
@@ -469,9 +477,12 @@ bool ExpressionUnroll::preorder(const IR::Operation_Binary *bin) {
     if (!right_root)
         right_root = bin->right;
 
-    root = new IR::PathExpression(IR::ID(refMap->newName("tmp")));
+    bool fresh;
+    root = new IR::PathExpression(
+        IR::ID(collector->get_tmp(bin->type, refMap, &fresh)));
     const IR::Expression *bin_expr;
-    decl.push_back(new IR::Declaration_Variable(root->path->name, bin->type));
+    if (fresh)
+        decl.push_back(new IR::Declaration_Variable(root->path->name, bin->type));
     if (bin->is<IR::Add>()) {
         bin_expr = new IR::Add(left_root, right_root);
     } else if (bin->is<IR::Sub>()) {
@@ -512,8 +523,11 @@ bool ExpressionUnroll::preorder(const IR::MethodCallExpression *m) {
         else
             args->push_back(new IR::Argument(root));
     }
-    root = new IR::PathExpression(IR::ID(refMap->newName("tmp")));
-    decl.push_back(new IR::Declaration_Variable(root->path->name, m->type));
+    bool fresh;
+    root = new IR::PathExpression(
+        IR::ID(collector->get_tmp(m->type, refMap, &fresh)));
+    if (fresh)
+        decl.push_back(new IR::Declaration_Variable(root->path->name, m->type));
     auto new_m = new IR::MethodCallExpression(m->method, args);
     stmt.push_back(new IR::AssignmentStatement(root, new_m));
     return false;
@@ -539,6 +553,7 @@ bool ExpressionUnroll::preorder(const IR::BoolLiteral *) {
 }
 
 const IR::Node *IfStatementUnroll::postorder(IR::IfStatement *i) {
+    collector->release_tmps();
     auto code_block = new IR::IndexedVector<IR::StatOrDecl>;
     expressionUnrollSanityCheck(i->condition);
     auto unroller = new LogicalExpressionUnroll(refMap, collector);
@@ -558,6 +573,7 @@ const IR::Node *IfStatementUnroll::postorder(IR::IfStatement *i) {
 }
 
 const IR::Node *IfStatementUnroll::postorder(IR::P4Control *a) {
+    collector->clear_tmps();
     auto control = getOriginal();
     return injector.inject_control(control, a);
 }
@@ -589,10 +605,13 @@ bool LogicalExpressionUnroll::preorder(const IR::Operation_Unary *u) {
     } else {
         un_expr = u->expr;
     }
-    auto tmp = new IR::PathExpression(IR::ID(refMap->newName("tmp")));
+    bool fresh;
+    auto tmp = new IR::PathExpression(
+        IR::ID(collector->get_tmp(u->type, refMap, &fresh)));
     root = tmp;
     stmt.push_back(new IR::AssignmentStatement(root, un_expr));
-    decl.push_back(new IR::Declaration_Variable(tmp->path->name, u->type));
+    if (fresh)
+        decl.push_back(new IR::Declaration_Variable(tmp->path->name, u->type));
     return false;
 }
 
@@ -627,10 +646,13 @@ bool LogicalExpressionUnroll::preorder(const IR::Operation_Binary *bin) {
         }
         root = bin_expr;
     } else {
-        auto tmp = new IR::PathExpression(IR::ID(refMap->newName("tmp")));
+        bool fresh;
+        auto tmp = new IR::PathExpression(
+            IR::ID(collector->get_tmp(bin->type, refMap, &fresh)));
         root = tmp;
-        decl.push_back(
-            new IR::Declaration_Variable(tmp->path->name, bin->type));
+        if (fresh)
+            decl.push_back(
+                new IR::Declaration_Variable(tmp->path->name, bin->type));
         if (bin->is<IR::Add>()) {
             bin_expr = new IR::Add(left_root, right_root);
         } else if (bin->is<IR::Sub>()) {
@@ -662,9 +684,12 @@ bool LogicalExpressionUnroll::preorder(const IR::MethodCallExpression *m) {
         root = m->clone();
         return false;
     }
-    auto tmp = new IR::PathExpression(IR::ID(refMap->newName("tmp")));
+    bool fresh;
+    auto tmp = new IR::PathExpression(
+        IR::ID(collector->get_tmp(m->type, refMap, &fresh)));
     root = tmp;
-    decl.push_back(new IR::Declaration_Variable(tmp->path->name, m->type));
+    if (fresh)
+        decl.push_back(new IR::Declaration_Variable(tmp->path->name, m->type));
     auto new_m = new IR::MethodCallExpression(m->method, args);
     stmt.push_back(new IR::AssignmentStatement(root, new_m));
     return false;
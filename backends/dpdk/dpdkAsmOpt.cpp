@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include "dpdkAsmOpt.h"
 
 namespace DPDK {
@@ -172,4 +173,185 @@ const IR::Node *RemoveLabelAfterLabel::postorder(IR::DpdkListStatement *l) {
     return l;
 }
 
+const IR::Node *RemoveRedundantMov::postorder(IR::DpdkListStatement *l) {
+    bool changed = false;
+    const IR::DpdkMovStatement *cache = nullptr;
+    IR::IndexedVector<IR::DpdkAsmStatement> new_l;
+    for (auto stmt : l->statements) {
+        if (auto mov = stmt->to<IR::DpdkMovStatement>()) {
+            if (mov->dst->equiv(*mov->src)) {
+                // mov a a
+                changed = true;
+                continue;
+            }
+            if (cache) {
+                if (cache->dst->equiv(*mov->dst)) {
+                    // mov a b
+                    // mov a c
+                    // The first mov is overwritten before anything can read
+                    // a (this mov cannot read it either, or it would be a
+                    // self-copy and already removed above).
+                    cache = mov;
+                    changed = true;
+                    continue;
+                }
+                if (cache->dst->equiv(*mov->src) &&
+                    cache->src->equiv(*mov->dst)) {
+                    // mov a b
+                    // mov b a
+                    // b already holds the value just copied out of it.
+                    changed = true;
+                    continue;
+                }
+                new_l.push_back(cache);
+            }
+            cache = mov;
+        } else {
+            if (cache) {
+                new_l.push_back(cache);
+                cache = nullptr;
+            }
+            new_l.push_back(stmt);
+        }
+    }
+    if (cache)
+        new_l.push_back(cache);
+    if (changed)
+        l->statements = new_l;
+    return l;
+}
+
+namespace {
+// A field of the flattened user metadata struct, always spelled m.<name>.
+bool isMetadataField(const IR::Expression *e) {
+    auto member = e->to<IR::Member>();
+    if (member == nullptr)
+        return false;
+    auto base = member->expr->to<IR::PathExpression>();
+    return base != nullptr && base->path->name == "m";
+}
+}  // namespace
+
+const IR::Expression *
+CopyPropagateMov::resolve(const IR::Expression *e) const {
+    // Recorded sources are themselves resolved and invalidated when
+    // overwritten, so a single lookup suffices.
+    for (auto &c : copies)
+        if (c.first->equiv(*e))
+            return c.second;
+    return e;
+}
+
+void CopyPropagateMov::invalidate(const IR::Expression *dst) {
+    copies.erase(
+        std::remove_if(copies.begin(), copies.end(),
+                       [dst](const std::pair<const IR::Expression *,
+                                             const IR::Expression *> &c) {
+                           return c.first->equiv(*dst) ||
+                                  c.second->equiv(*dst);
+                       }),
+        copies.end());
+}
+
+bool CopyPropagateMov::propagate(
+    IR::IndexedVector<IR::DpdkAsmStatement> &statements) {
+    bool changed = false;
+    copies.clear();
+    for (auto stmt : statements) {
+        if (stmt->is<IR::DpdkLabelStatement>()) {
+            copies.clear();
+        } else if (auto mov = stmt->to<IR::DpdkMovStatement>()) {
+            auto src = resolve(mov->src);
+            if (src != mov->src) {
+                LOG3("Propagated " << src << " into " << mov);
+                ((IR::DpdkMovStatement *)mov)->src = src;
+                changed = true;
+            }
+            invalidate(mov->dst);
+            if (isMetadataField(mov->dst) && isMetadataField(src))
+                copies.emplace_back(mov->dst, src);
+        } else if (auto u = stmt->to<IR::DpdkUnaryStatement>()) {
+            auto src = resolve(u->src);
+            if (src != u->src) {
+                ((IR::DpdkUnaryStatement *)u)->src = src;
+                changed = true;
+            }
+            invalidate(u->dst);
+        } else if (auto b = stmt->to<IR::DpdkBinaryStatement>()) {
+            // The first source must stay equal to the destination, so
+            // only the second one can be renamed.
+            auto src2 = resolve(b->src2);
+            if (src2 != b->src2) {
+                ((IR::DpdkBinaryStatement *)b)->src2 = src2;
+                changed = true;
+            }
+            invalidate(b->dst);
+        } else if (auto j = stmt->to<IR::DpdkJmpCondStatement>()) {
+            auto src1 = resolve(j->src1);
+            auto src2 = resolve(j->src2);
+            if (src1 != j->src1 || src2 != j->src2) {
+                ((IR::DpdkJmpCondStatement *)j)->src1 = src1;
+                ((IR::DpdkJmpCondStatement *)j)->src2 = src2;
+                changed = true;
+            }
+            // the window continues: jumps read but write nothing
+        } else if (stmt->is<IR::DpdkJmpStatement>()) {
+            // plain, hit/miss and validity jumps write nothing
+        } else {
+            // table applies, externs, extract, emit, checksums,
+            // registers... may write state we do not model
+            copies.clear();
+        }
+    }
+    copies.clear();
+    return changed;
+}
+
+const IR::Node *CopyPropagateMov::postorder(IR::DpdkListStatement *l) {
+    propagate(l->statements);
+    return l;
+}
+
+const IR::Node *CopyPropagateMov::postorder(IR::DpdkAction *a) {
+    propagate(a->statements);
+    return a;
+}
+
+namespace {
+// Counts metadata field occurrences over the whole assembly program.
+class CollectMetadataUses : public Inspector {
+    std::map<cstring, int> &uses;
+    std::map<cstring, int> &defs;
+  public:
+    CollectMetadataUses(std::map<cstring, int> &uses,
+                        std::map<cstring, int> &defs)
+        : uses(uses), defs(defs) { setName("CollectMetadataUses"); }
+    void postorder(const IR::Member *m) override { uses[m->toString()]++; }
+    void postorder(const IR::DpdkMovStatement *mov) override {
+        defs[mov->dst->toString()]++;
+    }
+};
+}  // namespace
+
+Visitor::profile_t RemoveUnusedMetadataMov::init_apply(const IR::Node *node) {
+    uses.clear();
+    defs.clear();
+    CollectMetadataUses collect(uses, defs);
+    node->apply(collect);
+    return Transform::init_apply(node);
+}
+
+const IR::Node *RemoveUnusedMetadataMov::postorder(IR::DpdkMovStatement *mov) {
+    auto dst = getOriginal<IR::DpdkMovStatement>()->dst;
+    if (!isMetadataField(dst))
+        return mov;
+    if (dst->to<IR::Member>()->member.name.startsWith("psa_"))
+        return mov;  // standard metadata may be read implicitly
+    cstring name = dst->toString();
+    if (uses[name] > defs[name])
+        return mov;  // the field is read somewhere
+    LOG3("Removing dead " << mov);
+    return nullptr;
+}
+
 }  // namespace DPDK
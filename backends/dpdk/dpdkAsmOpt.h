@@ -86,6 +86,61 @@ class RemoveLabelAfterLabel : public Transform {
     const IR::Node *postorder(IR::DpdkListStatement *l) override;
 };
 
+// This pass removes mov instructions that cannot change any state. The SWX
+// pipeline executes every instruction per packet, so each removed mov is
+// measurable. Three peepholes are applied, all limited to adjacent
+// instructions so that no control-flow analysis is needed:
+// mov a a        - copying a register to itself
+// mov a b
+// mov a c        - the first mov is dead, a is overwritten immediately
+// mov a b
+// mov b a        - the second mov copies back the value just written
+// Jumps, labels and any other instruction end the window, since they may
+// observe the intermediate value.
+
+class RemoveRedundantMov : public Transform {
+  public:
+    const IR::Node *postorder(IR::DpdkListStatement *l) override;
+};
+
+// This pass propagates metadata-to-metadata copies within straight-line
+// code, so that after
+// mov m.a m.b
+// mov m.c m.a
+// the second mov reads m.b directly. A label ends the propagation
+// window, since another path may reach it with different contents; so
+// does any instruction that can write state through means other than an
+// explicit destination (table applies, externs, extract...). Together
+// with RemoveUnusedMetadataMov this collapses the chains of parameter
+// binding copies introduced by the architecture translation.
+
+class CopyPropagateMov : public Transform {
+    std::vector<std::pair<const IR::Expression *, const IR::Expression *>>
+        copies;
+
+    const IR::Expression *resolve(const IR::Expression *e) const;
+    void invalidate(const IR::Expression *dst);
+    bool propagate(IR::IndexedVector<IR::DpdkAsmStatement> &statements);
+  public:
+    const IR::Node *postorder(IR::DpdkListStatement *l) override;
+    const IR::Node *postorder(IR::DpdkAction *a) override;
+};
+
+// This pass removes movs whose destination is a user metadata field that
+// is never read anywhere in the program: not by an instruction, a table
+// key, an action body or a jump condition. Standard psa_ metadata is
+// always considered live, since the pipeline reads some of it implicitly
+// (tx reads the egress port, for instance). Copy propagation tends to
+// leave such dead intermediate copies behind.
+
+class RemoveUnusedMetadataMov : public Transform {
+    std::map<cstring, int> uses;  // all occurrences of a metadata field
+    std::map<cstring, int> defs;  // occurrences as a mov destination
+  public:
+    profile_t init_apply(const IR::Node *node) override;
+    const IR::Node *postorder(IR::DpdkMovStatement *mov) override;
+};
+
 class DpdkAsmOptimization : public PassRepeated {
   private:
   public:
@@ -97,6 +152,9 @@ class DpdkAsmOptimization : public PassRepeated {
         passes.push_back(new RemoveRedundantLabel);
         passes.push_back(r);
         passes.push_back(new ThreadJumps);
+        passes.push_back(new RemoveRedundantMov);
+        passes.push_back(new CopyPropagateMov);
+        passes.push_back(new RemoveUnusedMetadataMov);
     }
 };
 
@@ -20,6 +20,7 @@ limitations under the License.
 namespace DPDK {
 
 int ConvertStatementToDpdk::next_label_id = 0;
+bool ConvertStatementToDpdk::use_switch_jump_tables = false;
 
 bool ConvertStatementToDpdk::preorder(const IR::AssignmentStatement *a) {
     auto left = a->left;
@@ -386,9 +387,99 @@ bool ConvertStatementToDpdk::preorder(const IR::MethodCallStatement *s) {
     return false;
 }
 
-// TODO(hanw): TBD
-bool ConvertStatementToDpdk::preorder(const IR::SwitchStatement *) {
-    BUG("Not implemented");
+/* Lower a switch statement on table.apply().action_run.  By default each
+ * case becomes one conditional jump, i.e. a sequential jmpa ladder executed
+ * per packet.  When jump tables are enabled (--switchJumpTables) and the
+ * dispatch is dense -- the switch handles most of the table's actions -- a
+ * single indexed jump with one target label per action of the table is
+ * emitted instead, so the dispatch cost stops growing with the case count.
+ */
+bool ConvertStatementToDpdk::preorder(const IR::SwitchStatement *s) {
+    auto member = s->expression->to<IR::Member>();
+    if (member == nullptr || member->member != IR::Type_Table::action_run)
+        BUG("%1%: only switch on action_run is supported", s);
+    auto mce = member->expr->to<IR::MethodCallExpression>();
+    BUG_CHECK(mce != nullptr, "%1%: expected a table apply", member->expr);
+    auto mi = P4::MethodInstance::resolve(mce, refmap, typemap);
+    auto am = mi->to<P4::ApplyMethod>();
+    BUG_CHECK(am != nullptr && am->isTableApply(),
+              "%1%: expected a table apply", mce);
+    auto table = am->object->to<IR::P4Table>();
+
+    add_instr(new IR::DpdkApplyStatement(table->name));
+
+    int id = next_label_id++;
+    auto end_label = Util::printf_format("label_%dswitchend", id);
+
+    // Resolve each case label to its target label.  Cases without a statement
+    // fall through to the next case that has one; trailing empty cases jump
+    // straight to the end of the switch.
+    std::map<const IR::IDeclaration *, cstring> targets;
+    cstring default_label = end_label;
+    std::vector<std::pair<cstring, const IR::Statement *>> blocks;
+    std::vector<const IR::SwitchCase *> pending;
+    int case_id = 0;
+    for (auto c : s->cases) {
+        pending.push_back(c);
+        if (c->statement == nullptr)
+            continue;
+        auto case_label = Util::printf_format("label_%dcase%d", id, case_id++);
+        blocks.emplace_back(case_label, c->statement);
+        for (auto p : pending) {
+            if (p->label->is<IR::DefaultExpression>()) {
+                default_label = case_label;
+            } else {
+                auto path = p->label->to<IR::PathExpression>();
+                BUG_CHECK(path != nullptr, "%1%: expected an action name",
+                          p->label);
+                targets[refmap->getDeclaration(path->path, true)] = case_label;
+            }
+        }
+        pending.clear();
+    }
+    for (auto p : pending) {
+        if (p->label->is<IR::DefaultExpression>())
+            continue;
+        auto path = p->label->to<IR::PathExpression>();
+        BUG_CHECK(path != nullptr, "%1%: expected an action name", p->label);
+        targets[refmap->getDeclaration(path->path, true)] = end_label;
+    }
+
+    auto al = table->getActionList();
+    bool dense = use_switch_jump_tables &&
+                 al != nullptr &&
+                 targets.size() >= dense_switch_min_cases &&
+                 2 * targets.size() >= al->size();
+    if (dense) {
+        // One target per action of the table, in action-list order; actions
+        // the switch does not handle go to the default case.
+        safe_vector<cstring> jump_targets;
+        for (auto ale : al->actionList) {
+            auto decl = refmap->getDeclaration(ale->getPath(), true);
+            auto t = targets.find(decl);
+            jump_targets.push_back(
+                t != targets.end() ? t->second : default_label);
+        }
+        add_instr(new IR::DpdkJmpActionTableStatement(table->name,
+                                                      jump_targets));
+    } else {
+        for (auto c : s->cases) {
+            if (c->label->is<IR::DefaultExpression>())
+                continue;
+            auto path = c->label->to<IR::PathExpression>();
+            auto decl = refmap->getDeclaration(path->path, true);
+            add_instr(new IR::DpdkJmpIfActionRunStatement(
+                targets[decl], decl->getName().name));
+        }
+        add_instr(new IR::DpdkJmpLabelStatement(default_label));
+    }
+
+    for (auto b : blocks) {
+        add_instr(new IR::DpdkLabelStatement(b.first));
+        visit(b.second);
+        add_instr(new IR::DpdkJmpLabelStatement(end_label));
+    }
+    add_instr(new IR::DpdkLabelStatement(end_label));
     return false;
 }
 
@@ -131,6 +131,13 @@ class BranchingInstructionGeneration {
 
 class ConvertStatementToDpdk : public Inspector {
     static int next_label_id;
+    // Whether switch statements on action_run may be lowered to a single
+    // indexed jump; requires a DPDK pipeline with computed jump support, so
+    // this is off unless --switchJumpTables is given.
+    static bool use_switch_jump_tables;
+    // Below this many handled actions a compare ladder is at least as fast
+    // as an indexed jump, so the ladder is kept.
+    static constexpr size_t dense_switch_min_cases = 4;
     IR::IndexedVector<IR::DpdkAsmStatement> instructions;
     P4::TypeMap *typemap;
     P4::ReferenceMap *refmap;
@@ -159,6 +166,9 @@ class ConvertStatementToDpdk : public Inspector {
         return instructions;
     }
     int get_label_num() { return next_label_id; }
+    static void enableSwitchJumpTables(bool enable) {
+        use_switch_jump_tables = enable;
+    }
 };
 
 } // namespace DPDK
@@ -266,13 +266,62 @@ bool ConvertToDpdkControl::preorder(const IR::P4Action *a) {
         stmt_list->push_back(i);
 
     auto action = new IR::DpdkAction(*stmt_list, a->name, *a->parameters);
+    // Action localization clones one copy per invocation site; emit
+    // identical clones once and redirect later references to the copy
+    // that was emitted.
+    for (auto prev : actions) {
+        if (prev->statements.equiv(action->statements) &&
+            prev->para.equiv(action->para)) {
+            LOG3("Aliasing action " << a->name << " to " << prev->name);
+            aliasMap.emplace(a->name.name, prev->name);
+            return false;
+        }
+    }
     actions.push_back(action);
     return false;
 }
 
+const IR::Expression *
+ConvertToDpdkControl::rewriteActionRef(const IR::Expression *expression) {
+    if (expression == nullptr)
+        return expression;
+    if (auto path = expression->to<IR::PathExpression>()) {
+        auto alias = aliasMap.find(path->path->name);
+        if (alias != aliasMap.end())
+            return new IR::PathExpression(IR::ID(alias->second));
+    } else if (auto mce = expression->to<IR::MethodCallExpression>()) {
+        if (auto method = mce->method->to<IR::PathExpression>()) {
+            auto alias = aliasMap.find(method->path->name);
+            if (alias != aliasMap.end())
+                return new IR::MethodCallExpression(
+                    new IR::PathExpression(IR::ID(alias->second)),
+                    mce->arguments);
+        }
+    }
+    return expression;
+}
+
 bool ConvertToDpdkControl::preorder(const IR::P4Table *a) {
-    auto t = new IR::DpdkTable(a->name, a->getKey(), a->getActionList(),
-                               a->getDefaultAction(), a->properties);
+    auto actionList = a->getActionList();
+    if (actionList != nullptr && !aliasMap.empty()) {
+        bool changed = false;
+        auto elements = new IR::IndexedVector<IR::ActionListElement>();
+        for (auto ale : actionList->actionList) {
+            auto ref = rewriteActionRef(ale->expression);
+            if (ref != ale->expression) {
+                changed = true;
+                elements->push_back(new IR::ActionListElement(
+                    ale->srcInfo, ale->annotations, ref));
+            } else {
+                elements->push_back(ale);
+            }
+        }
+        if (changed)
+            actionList = new IR::ActionList(*elements);
+    }
+    auto t = new IR::DpdkTable(a->name, a->getKey(), actionList,
+                               rewriteActionRef(a->getDefaultAction()),
+                               a->properties);
     tables.push_back(t);
     return false;
 }
@@ -110,6 +110,12 @@ class ConvertToDpdkControl : public Inspector {
     IR::IndexedVector<IR::DpdkTable> tables;
     IR::IndexedVector<IR::DpdkAction> actions;
     std::map<const IR::Declaration_Instance *, cstring> *csum_map;
+    /// Maps actions whose converted body duplicates an earlier one to
+    /// the name emitted for that earlier action; action localization
+    /// clones one copy per invocation site.
+    std::map<cstring, cstring> aliasMap;
+
+    const IR::Expression *rewriteActionRef(const IR::Expression *expression);
 
   public:
     ConvertToDpdkControl(
@@ -20,4 +20,31 @@ namespace DPDK {
 void DpdkVariableCollector::push_variable(const IR::DpdkDeclaration *d) {
     variables.push_back(d);
 }
+
+cstring DpdkVariableCollector::get_tmp(const IR::Type *type,
+                                       P4::ReferenceMap *refMap, bool *fresh) {
+    auto &slots = tmpPool[type->toString()];
+    for (auto &slot : slots) {
+        if (!slot.inUse) {
+            slot.inUse = true;
+            *fresh = false;
+            LOG3("Reusing temporary " << slot.name << " of type " << type);
+            return slot.name;
+        }
+    }
+    cstring name = refMap->newName("tmp");
+    slots.push_back(TmpSlot{name, true});
+    *fresh = true;
+    return name;
+}
+
+void DpdkVariableCollector::release_tmps() {
+    for (auto &kv : tmpPool)
+        for (auto &slot : kv.second)
+            slot.inUse = false;
+}
+
+void DpdkVariableCollector::clear_tmps() {
+    tmpPool.clear();
+}
 }  // namespace DPDK
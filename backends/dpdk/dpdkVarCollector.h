@@ -46,11 +46,33 @@ class DpdkVariableCollector {
     int next_tmp_id;
     IR::IndexedVector<IR::DpdkDeclaration> variables;
 
+    /// A temporary created while unrolling expressions.  Every
+    /// temporary becomes a field of the per-packet metadata structure,
+    /// so temporaries with disjoint lifetimes share a slot: a slot is
+    /// in use only while the statement whose expansion created it is
+    /// being expanded.
+    struct TmpSlot {
+        cstring name;
+        bool inUse;
+    };
+    /// Free and busy slots, grouped by the type they hold.
+    std::map<cstring, std::vector<TmpSlot>> tmpPool;
+
   public:
     DpdkVariableCollector() { next_tmp_id = 0; }
     cstring get_next_tmp();
     void push_variable(const IR::DpdkDeclaration *);
     IR::IndexedVector<IR::DpdkDeclaration> &get_globals() { return variables; }
+    /// Returns the name of a free temporary of the given type, creating
+    /// a fresh one through refMap when none is available; *fresh tells
+    /// the caller whether a declaration still has to be emitted.
+    cstring get_tmp(const IR::Type *type, P4::ReferenceMap *refMap, bool *fresh);
+    /// Marks every temporary as free again.  Called between statements:
+    /// no expansion keeps a temporary live past the statement's end.
+    void release_tmps();
+    /// Forgets the pool.  Called when leaving a control or parser,
+    /// since the slot declarations are scoped to it.
+    void clear_tmps();
 };
 
 } // namespace DPDK
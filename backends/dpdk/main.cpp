@@ -17,12 +17,14 @@ limitations under the License.
 #include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "backends/bmv2/common/JsonObjects.h"
 #include "backends/bmv2/common/backend.h"
 #include "backends/bmv2/psa_switch/version.h"
 #include "backends/dpdk/backend.h"
+#include "backends/dpdk/dpdkHelpers.h"
 #include "backends/dpdk/midend.h"
 #include "backends/dpdk/options.h"
 #include "control-plane/p4RuntimeSerializer.h"
@@ -112,6 +114,8 @@ int main(int argc, char *const argv[]) {
     if (::errorCount() > 0)
         return 1;
 
+    DPDK::ConvertStatementToDpdk::enableSwitchJumpTables(
+        options.switchJumpTables);
     auto backend = new DPDK::PsaSwitchBackend(options, &midEnd.refMap,
                                               &midEnd.typeMap, &midEnd.enumMap);
 
@@ -131,7 +135,13 @@ int main(int argc, char *const argv[]) {
     if (!options.outputFile.isNullOrEmpty()) {
         std::ostream *out = openFile(options.outputFile, false);
         if (out != nullptr) {
-            backend->codegen(*out);
+            // Format the whole spec in memory first and write it out in a
+            // single unformatted write; emitting a 40k-instruction pipeline
+            // through a file stream one token at a time is measurably slower.
+            std::stringstream spec;
+            backend->codegen(spec);
+            auto contents = spec.str();
+            out->write(contents.data(), contents.size());
             out->flush();
         }
     }
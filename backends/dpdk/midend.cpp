@@ -33,7 +33,6 @@ limitations under the License.
 #include "midend/convertEnums.h"
 #include "midend/copyStructures.h"
 #include "midend/eliminateNewtype.h"
-#include "midend/eliminateSerEnums.h"
 #include "midend/eliminateTuples.h"
 #include "midend/expandEmit.h"
 #include "midend/expandLookahead.h"
@@ -88,11 +87,21 @@ class PsaEnumOn32Bits : public P4::ChooseEnumRepresentation {
     explicit PsaEnumOn32Bits(cstring filename) : filename(filename) {}
 };
 
+/**
+The SWX pipeline can emit a whole header stack with a single bounded
+loop, so there is no need to expand stack emits into one emit per
+element.
+*/
+class KeepStackEmits : public P4::ExpandEmitPolicy {
+    bool expandStack(const IR::Type_Stack*) const override { return false; }
+};
+
 PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options,
                                  std::ostream *outStream)
     : MidEnd(options) {
+    // also eliminates serializable enums, in the same traversal
     auto convertEnums =
-        new P4::ConvertEnums(&refMap, &typeMap, new PsaEnumOn32Bits("psa.p4"));
+        new P4::ConvertEnums(&refMap, &typeMap, new PsaEnumOn32Bits("psa.p4"), true);
     auto evaluator = new P4::EvaluatorPass(&refMap, &typeMap);
     std::function<bool(const Context *, const IR::Expression *)> policy =
         [=](const Context *ctx, const IR::Expression *e) -> bool {
@@ -126,11 +135,12 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options,
                            : nullptr,
             new P4::RemoveMiss(&refMap, &typeMap),
             new P4::EliminateNewtype(&refMap, &typeMap),
-            new P4::EliminateSerEnums(&refMap, &typeMap),
             new P4::RemoveActionParameters(&refMap, &typeMap),
-            convertEnums,
-            new VisitFunctor([this, convertEnums]() {
-                enumMap = convertEnums->getEnumMapping();
+            new PassIfFeature(FeatureCensus::Enums | FeatureCensus::SerEnums, {
+                convertEnums,
+                new VisitFunctor([this, convertEnums]() {
+                    enumMap = convertEnums->getEnumMapping();
+                }),
             }),
             new P4::OrderArguments(&refMap, &typeMap),
             new P4::TypeChecking(&refMap, &typeMap),
@@ -138,23 +148,26 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options,
                 &refMap, &typeMap,
                 new P4::OrPolicy(new P4::IsValid(&refMap, &typeMap),
                                  new P4::IsMask())),
-            new P4::RemoveExits(&refMap, &typeMap),
+            new PassIfFeature(FeatureCensus::Exits,
+                              {new P4::RemoveExits(&refMap, &typeMap)}),
             new P4::ConstantFolding(&refMap, &typeMap),
-            new P4::StrengthReduction(&refMap, &typeMap),
+            new P4::StrengthReduction(&refMap, &typeMap, nullptr,
+                                      /* enableMachineArith */ true),
             new P4::SimplifySelectCases(&refMap, &typeMap, true),
             new P4::ExpandLookahead(&refMap, &typeMap),
-            new P4::ExpandEmit(&refMap, &typeMap),
+            new P4::ExpandEmit(&refMap, &typeMap, new KeepStackEmits()),
             new P4::HandleNoMatch(&refMap),
             new P4::SimplifyParsers(&refMap),
-            new P4::StrengthReduction(&refMap, &typeMap),
-            new P4::EliminateTuples(&refMap, &typeMap),
+            new P4::StrengthReduction(&refMap, &typeMap, nullptr,
+                                      /* enableMachineArith */ true),
+            new PassIfFeature(FeatureCensus::Tuples,
+                              {new P4::EliminateTuples(&refMap, &typeMap)}),
             new P4::SimplifyComparisons(&refMap, &typeMap),
             new P4::CopyStructures(&refMap, &typeMap),
             new P4::NestedStructs(&refMap, &typeMap),
             new P4::SimplifySelectList(&refMap, &typeMap),
             new P4::RemoveSelectBooleans(&refMap, &typeMap),
-            new P4::FlattenHeaders(&refMap, &typeMap),
-            new P4::FlattenInterfaceStructs(&refMap, &typeMap),
+            new P4::FlattenHeadersAndInterfaceStructs(&refMap, &typeMap),
             new P4::ReplaceSelectRange(&refMap, &typeMap),
             new P4::Predication(&refMap),
             new P4::MoveDeclarations(),  // more may have been introduced
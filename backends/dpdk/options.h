@@ -35,7 +35,19 @@ class PsaSwitchOptions : public BMV2::BMV2Options {
                 return false;
             },
             "[PsaSwitch back-end] Lists exact name of all midend passes.\n");
+        registerOption(
+            "--switchJumpTables", nullptr,
+            [this](const char *) {
+                switchJumpTables = true;
+                return true;
+            },
+            "[PsaSwitch back-end] Lower dense switch statements on action_run\n"
+            "to a single indexed jump instead of a sequential compare ladder.\n"
+            "Requires a DPDK pipeline with computed jump support.\n");
     }
+
+    /// Lower dense action_run switches to indexed jumps.
+    bool switchJumpTables = false;
 };
 
 using PsaSwitchContext = P4CContextWithOptions<PsaSwitchOptions>;
@@ -237,6 +237,18 @@ std::ostream& IR::DpdkJmpHeaderStatement::toSpec(std::ostream& out) const {
     return out;
 }
 
+std::ostream& IR::DpdkJmpIfActionRunStatement::toSpec(std::ostream& out) const {
+    out << instruction << " " << label << " " << action;
+    return out;
+}
+
+std::ostream& IR::DpdkJmpActionTableStatement::toSpec(std::ostream& out) const {
+    out << "jmpt " << table;
+    for (auto l : labels)
+        out << " " << l;
+    return out;
+}
+
 std::ostream& IR::DpdkJmpCondStatement::toSpec(std::ostream& out) const {
     out << instruction << " " << label << " " << DPDK::toStr(src1)
         << " " << DPDK::toStr(src2);
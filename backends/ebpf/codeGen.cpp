@@ -87,12 +87,38 @@ bool CodeGenInspector::comparison(const IR::Operation_Relation* b) {
     } else {
         if (!et->is<IHasWidth>())
             BUG("%1%: Comparisons for type %2% not yet implemented", type);
+        // Wide values are compared with memcmp over whole bytes; a width
+        // that is not a byte multiple would include the padding bits of
+        // the last byte, which the rest of the generated code does not
+        // keep masked.
+        if (et->to<IHasWidth>()->widthInBits() % 8 != 0) {
+            ::error(ErrorType::ERR_UNSUPPORTED,
+                    "%1%: comparisons on %2% bits not supported",
+                    b, et->to<IHasWidth>()->widthInBits());
+            return false;
+        }
         unsigned width = et->to<IHasWidth>()->implementationWidthInBits();
+        bool ordered = !b->is<IR::Equ>() && !b->is<IR::Neq>();
+        if (ordered) {
+            // Wide values are stored as byte arrays in network byte order,
+            // so byte-wise comparison agrees with the unsigned numeric
+            // order.  This does not hold for signed values.
+            auto tb = type->to<IR::Type_Bits>();
+            if (tb != nullptr && tb->isSigned) {
+                ::error(ErrorType::ERR_UNSUPPORTED,
+                        "%1%: signed comparisons on %2% bits not supported",
+                        b, tb->size);
+                return false;
+            }
+            builder->append("(");
+        }
         builder->append("memcmp(&");
         visit(b->left);
         builder->append(", &");
         visit(b->right);
         builder->appendFormat(", %d)", width / 8);
+        if (ordered)
+            builder->appendFormat(" %s 0)", b->getStringOp().c_str());
     }
     return false;
 }
@@ -279,6 +305,77 @@ bool CodeGenInspector::preorder(const IR::Type_Enum* type) {
     return false;
 }
 
+// Emits one operand of a wide operation as a 'const u8*'.  A value this
+// wide has no C integer literal, so constants are spelled as byte-array
+// compound literals in network byte order.
+void CodeGenInspector::emitWideOperand(const IR::Expression* expr, unsigned bytes) {
+    if (auto cst = expr->to<IR::Constant>()) {
+        big_int value = cst->value;
+        if (value < 0)
+            // Two's complement on the full width.
+            value += Util::shift_left(1, 8 * bytes);
+        builder->appendFormat("(const u8[%d]){", bytes);
+        for (unsigned i = 0; i < bytes; i++) {
+            big_int byte = (value >> (8 * (bytes - 1 - i))) & 0xff;
+            builder->appendFormat("%s0x%02x", i == 0 ? "" : ", ",
+                                  byte.convert_to<unsigned>());
+        }
+        builder->append("}");
+    } else {
+        builder->append("(const u8*)&");
+        visit(expr);
+    }
+}
+
+// An arithmetic or bitwise operation assigned to a value wider than 64
+// bits: emitted as a call to one of the limb-wise helpers from the
+// preamble instead of an expression C cannot express at this width.
+// Returns false when the right-hand side has a shape the helpers do not
+// cover; the caller then falls back to the normal (rejecting) path.  Only
+// valid for widths that are byte multiples (the caller checks).
+bool CodeGenInspector::emitWideArithmetic(const IR::AssignmentStatement* a, unsigned bytes) {
+    cstring helper;
+    const IR::Expression* left = nullptr;
+    const IR::Expression* right = nullptr;
+    auto rhs = a->right;
+    if (auto op = rhs->to<IR::BAnd>()) {
+        helper = "ebpf_wide_band"; left = op->left; right = op->right;
+    } else if (auto op = rhs->to<IR::BOr>()) {
+        helper = "ebpf_wide_bor"; left = op->left; right = op->right;
+    } else if (auto op = rhs->to<IR::BXor>()) {
+        helper = "ebpf_wide_bxor"; left = op->left; right = op->right;
+    } else if (auto op = rhs->to<IR::Add>()) {
+        helper = "ebpf_wide_add"; left = op->left; right = op->right;
+    } else if (auto op = rhs->to<IR::Sub>()) {
+        helper = "ebpf_wide_sub"; left = op->left; right = op->right;
+    } else if (auto op = rhs->to<IR::Cmpl>()) {
+        helper = "ebpf_wide_bnot"; left = op->expr;
+    } else {
+        return false;
+    }
+
+    // Non-constant operands must have an address to take.
+    for (auto e : { left, right }) {
+        if (e == nullptr || e->is<IR::Constant>())
+            continue;
+        if (!e->is<IR::Member>() && !e->is<IR::PathExpression>() &&
+            !e->is<IR::ArrayIndex>())
+            return false;
+    }
+
+    builder->appendFormat("%s((u8*)&", helper.c_str());
+    visit(a->left);
+    builder->append(", ");
+    emitWideOperand(left, bytes);
+    if (right != nullptr) {
+        builder->append(", ");
+        emitWideOperand(right, bytes);
+    }
+    builder->appendFormat(", %d)", bytes);
+    builder->endOfStatement();
+    return true;
+}
+
 bool CodeGenInspector::preorder(const IR::AssignmentStatement* a) {
     auto ltype = typeMap->getType(a->left);
     auto ebpfType = EBPFTypeFactory::instance->create(ltype);
@@ -292,11 +389,31 @@ bool CodeGenInspector::preorder(const IR::AssignmentStatement* a) {
     }
 
     if (memcpy) {
+        // The limb-wise helpers compute on whole bytes: for a width that is
+        // not a byte multiple, add/subtract/complement would leave garbage
+        // in the top byte's spare bits and later memcmp-based comparisons
+        // would miscompare.  Such widths keep the normal (rejecting) path.
+        if (scalar->widthInBits() % 8 == 0 &&
+            emitWideArithmetic(a, scalar->bytesRequired()))
+            return false;
         builder->append("memcpy(&");
         visit(a->left);
         builder->append(", &");
         visit(a->right);
         builder->appendFormat(", %d)", scalar->bytesRequired());
+    } else if (ltype->is<IR::Type_StructLike>() &&
+               (a->right->is<IR::PathExpression>() ||
+                a->right->is<IR::Member>() ||
+                a->right->is<IR::ArrayIndex>())) {
+        // A bulk copy is cheaper than the field-by-field assignments
+        // that expanding the copy in the midend would produce.
+        builder->append("__builtin_memcpy(&");
+        visit(a->left);
+        builder->append(", &");
+        visit(a->right);
+        builder->append(", sizeof(");
+        visit(a->left);
+        builder->append("))");
     } else {
         visit(a->left);
         builder->append(" = ");
@@ -93,6 +93,10 @@ class CodeGenInspector : public Inspector {
     bool comparison(const IR::Operation_Relation* comp);
     bool preorder(const IR::Equ* e) override { return comparison(e); }
     bool preorder(const IR::Neq* e) override { return comparison(e); }
+    bool preorder(const IR::Lss* e) override { return comparison(e); }
+    bool preorder(const IR::Leq* e) override { return comparison(e); }
+    bool preorder(const IR::Grt* e) override { return comparison(e); }
+    bool preorder(const IR::Geq* e) override { return comparison(e); }
     bool preorder(const IR::Path* path) override;
 
     bool preorder(const IR::Type_Typedef* type) override;
@@ -105,6 +109,8 @@ class CodeGenInspector : public Inspector {
     bool preorder(const IR::ExitStatement* s) override;
     bool preorder(const IR::IfStatement* s) override;
 
+    bool emitWideArithmetic(const IR::AssignmentStatement* a, unsigned bytes);
+    void emitWideOperand(const IR::Expression* expr, unsigned bytes);
     void widthCheck(const IR::Node* node) const;
 };
 
@@ -45,9 +45,12 @@ void run_ebpf_backend(const EbpfOptions& options, const IR::ToplevelBlock* tople
         target = new BccTarget();
     } else if (options.target == "test") {
         target = new TestTarget();
+    } else if (options.target == "afxdp") {
+        target = new AfXdpTarget();
     } else {
         ::error(ErrorType::ERR_UNKNOWN,
-                "Unknown target %s; legal choices are 'bcc', 'kernel', and test", options.target);
+                "Unknown target %s; legal choices are 'bcc', 'kernel', 'test', and 'afxdp'",
+                options.target);
         return;
     }
 
@@ -79,8 +82,8 @@ void run_ebpf_backend(const EbpfOptions& options, const IR::ToplevelBlock* tople
 
     ebpfprog->emitH(&h, hfile);
     ebpfprog->emitC(&c, hfile);
-    *cstream << c.toString();
-    *hstream << h.toString();
+    c.writeTo(*cstream);
+    h.writeTo(*hstream);
     cstream->flush();
     hstream->flush();
 }
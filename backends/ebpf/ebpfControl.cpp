@@ -27,7 +27,7 @@ namespace EBPF {
 
 ControlBodyTranslator::ControlBodyTranslator(const EBPFControl* control) :
         CodeGenInspector(control->program->refMap, control->program->typeMap), control(control),
-        p4lib(P4::P4CoreLibrary::instance)
+        p4lib(P4::P4CoreLibrary::instance())
 { setName("ControlBodyTranslator"); }
 
 bool ControlBodyTranslator::preorder(const IR::PathExpression* expression) {
@@ -271,7 +271,7 @@ void ControlBodyTranslator::processMethod(const P4::ExternMethod* method) {
     auto decl = method->object;
     auto declType = method->originalExternType;
 
-    if (declType->name.name == EBPFModel::instance.counterArray.name) {
+    if (declType->name.name == EBPFModel::instance().counterArray.name) {
         builder->blockStart();
         cstring name = EBPFObject::externalName(decl);
         auto counterMap = control->getCounter(name);
@@ -325,9 +325,32 @@ void ControlBodyTranslator::processApply(const P4::ApplyMethod* method) {
     if (table->keyGenerator != nullptr) {
         builder->emitIndent();
         builder->appendLine("/* perform lookup */");
-        builder->emitIndent();
-        builder->target->emitTableLookup(builder, table->dataMapName, keyname, valueName);
-        builder->endOfStatement(true);
+        if (table->constEntriesInline) {
+            table->emitConstEntriesLookup(builder, keyname, valueName);
+        } else if (table->cacheEnabled) {
+            builder->emitIndent();
+            builder->target->emitTableLookup(builder, table->cacheMapName, keyname, valueName);
+            builder->endOfStatement(true);
+            builder->emitIndent();
+            builder->appendFormat("if (%s == NULL) ", valueName.c_str());
+            builder->blockStart();
+            builder->emitIndent();
+            builder->target->emitTableLookup(builder, table->dataMapName, keyname, valueName);
+            builder->endOfStatement(true);
+            builder->emitIndent();
+            builder->appendFormat("if (%s != NULL) ", valueName.c_str());
+            builder->blockStart();
+            builder->emitIndent();
+            builder->target->emitTableUpdate(builder, table->cacheMapName,
+                                             keyname, cstring("*") + valueName);
+            builder->newline();
+            builder->blockEnd(true);
+            builder->blockEnd(true);
+        } else {
+            builder->emitIndent();
+            builder->target->emitTableLookup(builder, table->dataMapName, keyname, valueName);
+            builder->endOfStatement(true);
+        }
     }
 
     builder->emitIndent();
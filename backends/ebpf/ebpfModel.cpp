@@ -19,6 +19,10 @@ limitations under the License.
 namespace EBPF {
 
 cstring EBPFModel::reservedPrefix = "ebpf_";
-EBPFModel EBPFModel::instance;
+
+EBPFModel& EBPFModel::instance() {
+    static EBPFModel model;
+    return model;
+}
 
 }  // namespace EBPF
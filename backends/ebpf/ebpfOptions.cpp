@@ -23,4 +23,16 @@ EbpfOptions::EbpfOptions() {
         registerOption("--emit-externs", nullptr,
                 [this](const char*) { emitExterns = true; return true; },
                 "[ebpf back-end] Allow for user-provided implementation of extern functions.");
+        registerOption("--split-stages", nullptr,
+                [this](const char*) { splitStages = true; return true; },
+                "[ebpf back-end] Emit the parser and the control block as two\n"
+                "programs chained with a bpf tail call, carrying the parsed\n"
+                "headers through a per-CPU scratch map. Each stage then gets\n"
+                "its own verifier complexity budget. Kernel target only.");
+        registerOption("--table-caching", nullptr,
+                [this](const char*) { enableTableCache = true; return true; },
+                "[ebpf back-end] Generate an LRU cache map in front of each LPM\n"
+                "table, so packets of already-seen flows hit one exact-match\n"
+                "lookup instead of walking the trie. Note that the caches are\n"
+                "not invalidated when the control plane updates a table.");
 }
@@ -29,6 +29,11 @@ class EbpfOptions : public CompilerOptions {
     bool loadIRFromJson = false;
     // Externs generation
     bool emitExterns = false;
+    // Generate an LRU cache map in front of LPM table lookups
+    bool enableTableCache = false;
+    // Split the generated program at the parser/control boundary into two
+    // programs chained with a bpf tail call
+    bool splitStages = false;
     EbpfOptions();
 };
 
@@ -23,31 +23,94 @@ limitations under the License.
 namespace EBPF {
 
 namespace {
+
+/// Width in bits of a fixed-size extract call on @packet, or 0 if the
+/// statement is not such an extract.
+unsigned fixedExtractWidth(const IR::MethodCallStatement* statement,
+                           P4::ReferenceMap* refMap, P4::TypeMap* typeMap,
+                           const IR::Parameter* packet) {
+    auto mce = statement->methodCall;
+    if (mce->arguments->size() != 1)
+        return 0;
+    auto mi = P4::MethodInstance::resolve(mce, refMap, typeMap);
+    auto extMethod = mi->to<P4::ExternMethod>();
+    if (extMethod == nullptr || extMethod->object != packet)
+        return 0;
+    if (extMethod->method->name.name != P4::P4CoreLibrary::instance().packetIn.extract.name)
+        return 0;
+    auto type = typeMap->getType(mce->arguments->at(0)->expression);
+    auto ht = type == nullptr ? nullptr : type->to<IR::Type_Header>();
+    if (ht == nullptr)
+        return 0;
+    for (auto f : ht->fields) {
+        if (typeMap->getType(f)->is<IR::Type_Varbits>())
+            return 0;
+    }
+    return ht->width_bits();
+}
+
 class StateTranslationVisitor : public CodeGenInspector {
     bool hasDefault;
     P4::P4CoreLibrary& p4lib;
     const EBPFParserState* state;
+    ExtractSpans spans;
+    const IR::MethodCallStatement* currentStatement = nullptr;
 
     void compileExtractField(const IR::Expression* expr, cstring name,
                              unsigned alignment, EBPFType* type);
-    void compileExtract(const IR::Expression* destination);
+    void compileExtract(const IR::Expression* destination, int spanBits = -1);
     void compileLookahead(const IR::Expression* destination);
+    void compileTransition(const IR::ParserState* parserState);
 
  public:
     explicit StateTranslationVisitor(const EBPFParserState* state) :
             CodeGenInspector(state->parser->program->refMap, state->parser->program->typeMap),
-            hasDefault(false), p4lib(P4::P4CoreLibrary::instance), state(state) {}
+            hasDefault(false), p4lib(P4::P4CoreLibrary::instance()), state(state) {}
     bool preorder(const IR::ParserState* state) override;
     bool preorder(const IR::SelectCase* selectCase) override;
     bool preorder(const IR::SelectExpression* expression) override;
     bool preorder(const IR::Member* expression) override;
     bool preorder(const IR::MethodCallExpression* expression) override;
-    bool preorder(const IR::MethodCallStatement* stat) override
-    { visit(stat->methodCall); return false; }
+    bool preorder(const IR::MethodCallStatement* stat) override {
+        currentStatement = stat;
+        visit(stat->methodCall);
+        currentStatement = nullptr;
+        return false;
+    }
     bool preorder(const IR::AssignmentStatement* stat) override;
 };
 }  // namespace
 
+void ExtractSpans::compute(const IR::Vector<IR::StatOrDecl>& components,
+                           P4::ReferenceMap* refMap, P4::TypeMap* typeMap,
+                           const IR::Parameter* packet) {
+    std::vector<std::pair<const IR::MethodCallStatement*, unsigned>> run;
+    auto flush = [this, &run]() {
+        if (run.size() > 1) {
+            unsigned total = 0;
+            for (auto& e : run)
+                total += e.second;
+            checkBits[run.front().first] = total;
+            for (size_t i = 1; i < run.size(); i++)
+                checkBits[run[i].first] = 0;
+        }
+        run.clear();
+    };
+    for (auto c : components) {
+        auto statement = c->to<IR::MethodCallStatement>();
+        unsigned width = statement == nullptr ? 0
+                       : fixedExtractWidth(statement, refMap, typeMap, packet);
+        if (width == 0) {
+            // Anything else -- a non-extract statement, a varbit header --
+            // ends the current span; later extracts start a new one.
+            flush();
+            continue;
+        }
+        run.emplace_back(statement, width);
+    }
+    flush();
+}
+
 void
 StateTranslationVisitor::compileLookahead(const IR::Expression* destination) {
     builder->emitIndent();
@@ -98,7 +161,16 @@ bool StateTranslationVisitor::preorder(const IR::ParserState* parserState) {
     builder->spc();
     builder->blockStart();
 
+    spans.compute(parserState->components, state->parser->program->refMap,
+                  state->parser->program->typeMap, state->parser->packet);
     visit(parserState->components, "components");
+    compileTransition(parserState);
+
+    builder->blockEnd(true);
+    return false;
+}
+
+void StateTranslationVisitor::compileTransition(const IR::ParserState* parserState) {
     if (parserState->selectExpression == nullptr) {
         builder->emitIndent();
         builder->append("goto ");
@@ -110,14 +182,27 @@ bool StateTranslationVisitor::preorder(const IR::ParserState* parserState) {
         // must be a PathExpression which is a state name
         if (!parserState->selectExpression->is<IR::PathExpression>())
             BUG("Expected a PathExpression, got a %1%", parserState->selectExpression);
+        auto pe = parserState->selectExpression->to<IR::PathExpression>();
+        auto& inlined = state->parser->inlinedStates;
+        auto it = inlined.find(pe->path->name.name);
+        if (it != inlined.end()) {
+            // The target state has no other predecessor; emit its body
+            // here instead of jumping, flattening the chain into
+            // straight-line code.
+            builder->emitIndent();
+            builder->appendFormat("/* %s */", pe->path->name.name.c_str());
+            builder->newline();
+            spans.compute(it->second->components, state->parser->program->refMap,
+                          state->parser->program->typeMap, state->parser->packet);
+            visit(it->second->components, "components");
+            compileTransition(it->second);
+            return;
+        }
         builder->emitIndent();
         builder->append("goto ");
         visit(parserState->selectExpression);
         builder->endOfStatement(true);
     }
-
-    builder->blockEnd(true);
-    return false;
 }
 
 bool StateTranslationVisitor::preorder(const IR::SelectExpression* expression) {
@@ -212,6 +297,19 @@ StateTranslationVisitor::compileExtractField(
 
         builder->append(")");
         builder->endOfStatement(true);
+    } else if (alignment == 0 && widthToExtract % 8 == 0) {
+        // Byte-aligned wide value: the destination is a byte array in
+        // network order, so one bulk copy from the packet replaces the
+        // byte-by-byte loads.  The bounds check was done by the caller.
+        unsigned bytes = ROUNDUP(widthToExtract, 8);
+        builder->emitIndent();
+        builder->append("memcpy(&");
+        visit(expr);
+        builder->appendFormat(".%s, %s + BYTES(%s), %d)",
+                              field.c_str(),
+                              program->packetStartVar.c_str(),
+                              program->offsetVar.c_str(), bytes);
+        builder->endOfStatement(true);
     } else {
         // wide values; read all bytes one by one.
         unsigned shift;
@@ -255,7 +353,7 @@ StateTranslationVisitor::compileExtractField(
 }
 
 void
-StateTranslationVisitor::compileExtract(const IR::Expression* destination) {
+StateTranslationVisitor::compileExtract(const IR::Expression* destination, int spanBits) {
     auto type = state->parser->typeMap->getType(destination);
     auto ht = type->to<IR::Type_StructLike>();
     if (ht == nullptr) {
@@ -266,22 +364,28 @@ StateTranslationVisitor::compileExtract(const IR::Expression* destination) {
 
     unsigned width = ht->width_bits();
     auto program = state->parser->program;
-    builder->emitIndent();
-    builder->appendFormat("if (%s < %s + BYTES(%s + %d)) ",
-                          program->packetEndVar.c_str(),
-                          program->packetStartVar.c_str(),
-                          program->offsetVar.c_str(), width);
-    builder->blockStart();
+    if (spanBits != 0) {
+        // A positive spanBits means this extract leads a span of
+        // consecutive extracts and one check covers them all; zero means
+        // the span leader already checked for this header's bytes.
+        unsigned checkWidth = spanBits > 0 ? static_cast<unsigned>(spanBits) : width;
+        builder->emitIndent();
+        builder->appendFormat("if (%s < %s + BYTES(%s + %d)) ",
+                              program->packetEndVar.c_str(),
+                              program->packetStartVar.c_str(),
+                              program->offsetVar.c_str(), checkWidth);
+        builder->blockStart();
 
-    builder->emitIndent();
-    builder->appendFormat("%s = %s;", program->errorVar.c_str(),
-                          p4lib.packetTooShort.str());
-    builder->newline();
+        builder->emitIndent();
+        builder->appendFormat("%s = %s;", program->errorVar.c_str(),
+                              p4lib.packetTooShort.str());
+        builder->newline();
 
-    builder->emitIndent();
-    builder->appendFormat("goto %s;", IR::ParserState::reject.c_str());
-    builder->newline();
-    builder->blockEnd(true);
+        builder->emitIndent();
+        builder->appendFormat("goto %s;", IR::ParserState::reject.c_str());
+        builder->newline();
+        builder->blockEnd(true);
+    }
 
     unsigned alignment = 0;
     for (auto f : ht->fields) {
@@ -333,7 +437,9 @@ bool StateTranslationVisitor::preorder(const IR::MethodCallExpression* expressio
                             "Variable-sized header fields not yet supported %1%", expression);
                     return false;
                 }
-                compileExtract(expression->arguments->at(0)->expression);
+                int spanBits = currentStatement == nullptr ? -1
+                             : spans.checkWidth(currentStatement);
+                compileExtract(expression->arguments->at(0)->expression, spanBits);
                 return false;
             }
             BUG("Unhandled packet method %1%", expression->method);
@@ -393,8 +499,12 @@ void EBPFParser::emitDeclaration(CodeBuilder* builder, const IR::Declaration* de
 void EBPFParser::emit(CodeBuilder* builder) {
     for (auto l : parserBlock->container->parserLocals)
         emitDeclaration(builder, l);
-    for (auto s : states)
+    for (auto s : states) {
+        // Inlined states are emitted inside their predecessor.
+        if (inlinedStates.count(s->state->name.name) > 0)
+            continue;
         s->emit(builder);
+    }
     builder->newline();
 
     // Create a synthetic reject state
@@ -426,6 +536,29 @@ bool EBPFParser::build() {
     if (ht == nullptr)
         return false;
     headerType = EBPFTypeFactory::instance->create(ht);
+
+    // Find states whose only predecessor edge is an unconditional
+    // transition; compileTransition inlines them into that predecessor.
+    std::map<cstring, unsigned> predecessors;
+    std::map<cstring, unsigned> directPredecessors;
+    for (auto state : parserBlock->container->states) {
+        if (state->selectExpression == nullptr)
+            continue;
+        if (auto se = state->selectExpression->to<IR::SelectExpression>()) {
+            for (auto c : se->selectCases)
+                predecessors[c->state->path->name.name]++;
+        } else if (auto pe = state->selectExpression->to<IR::PathExpression>()) {
+            predecessors[pe->path->name.name]++;
+            directPredecessors[pe->path->name.name]++;
+        }
+    }
+    for (auto state : parserBlock->container->states) {
+        if (state->isBuiltin() || state->name == IR::ParserState::start)
+            continue;
+        cstring name = state->name.name;
+        if (predecessors[name] == 1 && directPredecessors[name] == 1)
+            inlinedStates.emplace(name, state);
+    }
     return true;
 }
 
@@ -25,6 +25,34 @@ namespace EBPF {
 
 class EBPFParser;
 
+/**
+ * Groups runs of consecutive fixed-size extract calls in a state body
+ * into extraction spans, so that code generation emits a single packet
+ * bounds check covering the whole span instead of one per header (the
+ * common ethernet->vlan->ipv4 fast path pays one branch, not three).
+ * Hoisting the checks is safe in this backend because a failed check
+ * transitions to reject, which abandons the packet without observing
+ * any partially-parsed state.
+ */
+class ExtractSpans {
+    /// Populated only for extracts that belong to a span of two or more.
+    std::map<const IR::MethodCallStatement*, unsigned> checkBits;
+
+ public:
+    void compute(const IR::Vector<IR::StatOrDecl>& components,
+                 P4::ReferenceMap* refMap, P4::TypeMap* typeMap,
+                 const IR::Parameter* packet);
+    /// Number of bits the bounds check for this extract must cover: the
+    /// combined width for the first extract of a span, 0 for the later
+    /// extracts of a span (the leader's check already covered them), and
+    /// -1 for an extract in no span, which checks its own header width.
+    int checkWidth(const IR::MethodCallStatement* statement) const {
+        auto it = checkBits.find(statement);
+        if (it == checkBits.end()) return -1;
+        return static_cast<int>(it->second);
+    }
+};
+
 class EBPFParserState : public EBPFObject {
  public:
     const IR::ParserState* state;
@@ -44,6 +72,11 @@ class EBPFParser : public EBPFObject {
     const IR::Parameter*          packet;
     const IR::Parameter*          headers;
     EBPFType*                     headerType;
+    /// States whose only predecessor reaches them through an unconditional
+    /// transition; their bodies are inlined into that predecessor, so no
+    /// separate labeled block is emitted and linear state chains become
+    /// straight-line code.
+    std::map<cstring, const IR::ParserState*> inlinedStates;
 
     explicit EBPFParser(const EBPFProgram* program, const IR::ParserBlock* block,
                         const P4::TypeMap* typeMap);
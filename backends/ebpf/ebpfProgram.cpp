@@ -59,6 +59,12 @@ bool EBPFProgram::build() {
 }
 
 void EBPFProgram::emitC(CodeBuilder* builder, cstring header) {
+    if (options.splitStages && builder->target->name != "Linux kernel") {
+        ::error(ErrorType::ERR_UNSUPPORTED,
+                "--split-stages is only supported for the kernel target");
+        return;
+    }
+
     emitGeneratedComment(builder);
 
     // Find the last occurrence of a folder slash (Linux only)
@@ -73,8 +79,12 @@ void EBPFProgram::emitC(CodeBuilder* builder, cstring header) {
 
     builder->target->emitIncludes(builder);
     emitPreamble(builder);
+    if (options.splitStages)
+        emitContextType(builder);
     builder->append("REGISTER_START()\n");
     control->emitTableInstances(builder);
+    if (options.splitStages)
+        emitStageMaps(builder);
     builder->append("REGISTER_END()\n");
     builder->newline();
     builder->emitIndent();
@@ -95,7 +105,10 @@ void EBPFProgram::emitC(CodeBuilder* builder, cstring header) {
     builder->newline();
 
     parser->emit(builder);
-    emitPipeline(builder);
+    if (options.splitStages)
+        emitStageHandoff(builder);
+    else
+        emitPipeline(builder);
 
     builder->emitIndent();
     builder->appendFormat("%s:\n", endLabel.c_str());
@@ -113,9 +126,145 @@ void EBPFProgram::emitC(CodeBuilder* builder, cstring header) {
     builder->decreaseIndent();
     builder->blockEnd(true);  // end of function
 
+    if (options.splitStages)
+        emitControlStage(builder);
+
     builder->target->emitLicense(builder, license);
 }
 
+void EBPFProgram::emitContextType(CodeBuilder* builder) {
+    // State handed from the parser stage to the control stage; today just
+    // the parsed headers, since the packet pointers must be recomputed
+    // after a tail call anyway.
+    builder->append("struct ");
+    builder->append(contextTypeName);
+    builder->spc();
+    builder->blockStart();
+    builder->emitIndent();
+    parser->headerType->declare(builder, parser->headers->name.name, false);
+    builder->endOfStatement(true);
+    builder->blockEnd(false);
+    builder->endOfStatement(true);
+    builder->newline();
+}
+
+void EBPFProgram::emitStageMaps(CodeBuilder* builder) {
+    // Per-CPU scratch slot for the context: a stage only writes it for the
+    // packet it is currently processing, so one slot per CPU suffices.
+    builder->appendFormat("REGISTER_TABLE(%s, BPF_MAP_TYPE_PERCPU_ARRAY, "
+                          "sizeof(u32), sizeof(struct %s), 1)\n",
+                          contextMapName.c_str(), contextTypeName.c_str());
+    // Program array for the tail call. The iproute2 loader fills slot 0
+    // with the program in section "1/0" by matching this map's id.
+    builder->appendFormat("struct bpf_elf_map SEC(\"maps\") %s = {\n",
+                          progArrayName.c_str());
+    builder->appendLine("    .type       = BPF_MAP_TYPE_PROG_ARRAY,");
+    builder->appendLine("    .size_key   = sizeof(__u32),");
+    builder->appendLine("    .size_value = sizeof(__u32),");
+    builder->appendLine("    .max_elem   = 1,");
+    builder->appendLine("    .pinning    = 2,");
+    builder->appendLine("    .id         = 1,");
+    builder->appendLine("};");
+}
+
+void EBPFProgram::emitStageHandoff(CodeBuilder* builder) {
+    cstring contextVar = functionName + "_ctx";
+    builder->emitIndent();
+    builder->append(IR::ParserState::accept);
+    builder->append(":");
+    builder->newline();
+    builder->emitIndent();
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendLine("/* hand the parsed headers to the control stage */");
+    builder->emitIndent();
+    builder->appendFormat("struct %s *%s = BPF_MAP_LOOKUP_ELEM(%s, &%s);",
+                          contextTypeName.c_str(), contextVar.c_str(),
+                          contextMapName.c_str(), zeroKey.c_str());
+    builder->newline();
+    builder->emitIndent();
+    builder->appendFormat("if (%s != NULL) ", contextVar.c_str());
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("%s->%s = %s;", contextVar.c_str(),
+                          parser->headers->name.name.c_str(),
+                          parser->headers->name.name.c_str());
+    builder->newline();
+    builder->emitIndent();
+    builder->appendFormat("bpf_tail_call(%s, &%s, 0);",
+                          model.CPacketName.str(), progArrayName.c_str());
+    builder->newline();
+    builder->blockEnd(true);
+    builder->emitIndent();
+    builder->appendLine("/* tail call failed: control stage not loaded */");
+    builder->emitIndent();
+    builder->appendFormat("return %s;", builder->target->dropReturnCode().c_str());
+    builder->newline();
+    builder->blockEnd(true);
+}
+
+void EBPFProgram::emitControlStage(CodeBuilder* builder) {
+    cstring contextVar = functionName + "_ctx";
+    builder->newline();
+    builder->appendLine("SEC(\"1/0\")");
+    builder->emitIndent();
+    builder->appendFormat("int %s(SK_BUFF *%s) ",
+                          controlStageName.c_str(), model.CPacketName.str());
+    builder->blockStart();
+
+    emitHeaderInstances(builder);
+    builder->append(" = ");
+    parser->headerType->emitInitializer(builder);
+    builder->endOfStatement(true);
+
+    emitLocalVariables(builder);
+    builder->newline();
+
+    builder->emitIndent();
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendLine("/* restore the headers parsed by the previous stage */");
+    builder->emitIndent();
+    builder->appendFormat("struct %s *%s = BPF_MAP_LOOKUP_ELEM(%s, &%s);",
+                          contextTypeName.c_str(), contextVar.c_str(),
+                          contextMapName.c_str(), zeroKey.c_str());
+    builder->newline();
+    builder->emitIndent();
+    builder->appendFormat("if (%s == NULL)", contextVar.c_str());
+    builder->newline();
+    builder->increaseIndent();
+    builder->emitIndent();
+    builder->appendFormat("return %s;", builder->target->dropReturnCode().c_str());
+    builder->newline();
+    builder->decreaseIndent();
+    builder->emitIndent();
+    builder->appendFormat("%s = %s->%s;", parser->headers->name.name.c_str(),
+                          contextVar.c_str(), parser->headers->name.name.c_str());
+    builder->newline();
+    builder->blockEnd(true);
+
+    builder->emitIndent();
+    builder->blockStart();
+    control->emit(builder);
+    builder->blockEnd(true);
+
+    builder->emitIndent();
+    builder->appendFormat("%s:\n", endLabel.c_str());
+    builder->emitIndent();
+    builder->appendFormat("if (%s)\n", control->accept->name.name.c_str());
+    builder->increaseIndent();
+    builder->emitIndent();
+    builder->appendFormat("return %s;\n", builder->target->forwardReturnCode().c_str());
+    builder->decreaseIndent();
+    builder->emitIndent();
+    builder->appendLine("else");
+    builder->increaseIndent();
+    builder->emitIndent();
+    builder->appendFormat("return %s;\n", builder->target->dropReturnCode().c_str());
+    builder->decreaseIndent();
+    builder->blockEnd(true);  // end of function
+}
+
 void EBPFProgram::emitGeneratedComment(CodeBuilder* builder) {
     std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now();
     std::time_t time = std::chrono::system_clock::to_time_t(now);
@@ -204,6 +353,93 @@ void EBPFProgram::emitPreamble(CodeBuilder* builder) {
     builder->newline();
     builder->appendLine("void* memcpy(void* dest, const void* src, size_t num);");
     builder->newline();
+    builder->appendLine(
+        "/* Operations on values wider than 64 bits, stored as byte arrays in\n"
+        " * network byte order.  The byte count is a compile-time constant at\n"
+        " * every call site, so after inlining the loops unroll into\n"
+        " * straight-line 64-bit limb operations. */");
+    builder->appendLine(
+        "#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__\n"
+        "#define EBPF_BE64(x) __builtin_bswap64(x)\n"
+        "#else\n"
+        "#define EBPF_BE64(x) (x)\n"
+        "#endif");
+    builder->appendLine(
+        "#define EBPF_WIDE_BITWISE(name, op) \\\n"
+        "static void __attribute__((always_inline, unused)) \\\n"
+        "name(u8* res, const u8* l, const u8* r, int bytes) { \\\n"
+        "    int i; \\\n"
+        "    for (i = 0; i + 8 <= bytes; i += 8) { \\\n"
+        "        u64 a, b; \\\n"
+        "        memcpy(&a, l + i, 8); \\\n"
+        "        memcpy(&b, r + i, 8); \\\n"
+        "        a = a op b; \\\n"
+        "        memcpy(res + i, &a, 8); \\\n"
+        "    } \\\n"
+        "    for (; i < bytes; i++) \\\n"
+        "        res[i] = l[i] op r[i]; \\\n"
+        "}\n"
+        "EBPF_WIDE_BITWISE(ebpf_wide_band, &)\n"
+        "EBPF_WIDE_BITWISE(ebpf_wide_bor, |)\n"
+        "EBPF_WIDE_BITWISE(ebpf_wide_bxor, ^)");
+    builder->appendLine(
+        "static void __attribute__((always_inline, unused))\n"
+        "ebpf_wide_bnot(u8* res, const u8* l, int bytes) {\n"
+        "    int i;\n"
+        "    for (i = 0; i + 8 <= bytes; i += 8) {\n"
+        "        u64 a;\n"
+        "        memcpy(&a, l + i, 8);\n"
+        "        a = ~a;\n"
+        "        memcpy(res + i, &a, 8);\n"
+        "    }\n"
+        "    for (; i < bytes; i++)\n"
+        "        res[i] = ~l[i];\n"
+        "}");
+    builder->appendLine(
+        "static void __attribute__((always_inline, unused))\n"
+        "ebpf_wide_add(u8* res, const u8* l, const u8* r, int bytes) {\n"
+        "    u64 carry = 0;\n"
+        "    int i = bytes;\n"
+        "    while (i > 0) {\n"
+        "        int n = i < 8 ? i : 8;\n"
+        "        u64 a = 0, b = 0, s, c;\n"
+        "        memcpy(&a, l + (i - n), n);\n"
+        "        memcpy(&b, r + (i - n), n);\n"
+        "        a = EBPF_BE64(a) >> (8 * (8 - n));\n"
+        "        b = EBPF_BE64(b) >> (8 * (8 - n));\n"
+        "        s = a + b;\n"
+        "        c = s < a;\n"
+        "        s += carry;\n"
+        "        c |= s < carry;\n"
+        "        carry = c;\n"
+        "        s = EBPF_BE64(s << (8 * (8 - n)));\n"
+        "        memcpy(res + (i - n), &s, n);\n"
+        "        i -= n;\n"
+        "    }\n"
+        "}");
+    builder->appendLine(
+        "static void __attribute__((always_inline, unused))\n"
+        "ebpf_wide_sub(u8* res, const u8* l, const u8* r, int bytes) {\n"
+        "    u64 borrow = 0;\n"
+        "    int i = bytes;\n"
+        "    while (i > 0) {\n"
+        "        int n = i < 8 ? i : 8;\n"
+        "        u64 a = 0, b = 0, d, c;\n"
+        "        memcpy(&a, l + (i - n), n);\n"
+        "        memcpy(&b, r + (i - n), n);\n"
+        "        a = EBPF_BE64(a) >> (8 * (8 - n));\n"
+        "        b = EBPF_BE64(b) >> (8 * (8 - n));\n"
+        "        d = a - b;\n"
+        "        c = a < b;\n"
+        "        c |= d < borrow;\n"
+        "        d -= borrow;\n"
+        "        borrow = c;\n"
+        "        d = EBPF_BE64(d << (8 * (8 - n)));\n"
+        "        memcpy(res + (i - n), &d, n);\n"
+        "        i -= n;\n"
+        "    }\n"
+        "}");
+    builder->newline();
 }
 
 void EBPFProgram::emitLocalVariables(CodeBuilder* builder) {
@@ -214,7 +450,7 @@ void EBPFProgram::emitLocalVariables(CodeBuilder* builder) {
 
     builder->emitIndent();
     builder->appendFormat("enum %s %s = %s;", errorEnum.c_str(), errorVar.c_str(),
-                          P4::P4CoreLibrary::instance.noError.str());
+                          P4::P4CoreLibrary::instance().noError.str());
     builder->newline();
 
     builder->emitIndent();
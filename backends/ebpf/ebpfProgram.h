@@ -52,6 +52,10 @@ class EBPFProgram : public EBPFObject {
     cstring errorEnum;
     cstring license = "GPL";  // TODO: this should be a compiler option probably
     cstring arrayIndexType = "u32";
+    // Names used when --split-stages chains the parser and control stages
+    // with a tail call: the scratch type and map carrying the parsed headers
+    // across the call, the program array, and the control-stage program.
+    cstring contextTypeName, contextMapName, progArrayName, controlStageName;
 
     virtual bool build();  // return 'true' on success
 
@@ -59,7 +63,7 @@ class EBPFProgram : public EBPFObject {
                 P4::ReferenceMap* refMap, P4::TypeMap* typeMap, const IR::ToplevelBlock* toplevel) :
             options(options), program(program), toplevel(toplevel),
             refMap(refMap), typeMap(typeMap),
-            parser(nullptr), control(nullptr), model(EBPFModel::instance) {
+            parser(nullptr), control(nullptr), model(EBPFModel::instance()) {
         offsetVar = EBPFModel::reserved("packetOffsetInBits");
         zeroKey = EBPFModel::reserved("zero");
         functionName = EBPFModel::reserved("filter");
@@ -69,6 +73,10 @@ class EBPFProgram : public EBPFObject {
         byteVar = EBPFModel::reserved("byte");
         endLabel = EBPFModel::reserved("end");
         errorEnum = EBPFModel::reserved("errorCodes");
+        contextTypeName = functionName + "_context";
+        contextMapName = functionName + "_context_map";
+        progArrayName = functionName + "_programs";
+        controlStageName = functionName + "_control";
     }
 
  protected:
@@ -78,6 +86,11 @@ class EBPFProgram : public EBPFObject {
     virtual void emitHeaderInstances(CodeBuilder* builder);
     virtual void emitLocalVariables(CodeBuilder* builder);
     virtual void emitPipeline(CodeBuilder* builder);
+    // Helpers for --split-stages.
+    virtual void emitContextType(CodeBuilder* builder);
+    virtual void emitStageMaps(CodeBuilder* builder);
+    virtual void emitStageHandoff(CodeBuilder* builder);
+    virtual void emitControlStage(CodeBuilder* builder);
 
  public:
     virtual void emitH(CodeBuilder* builder, cstring headerFile);  // emits C headers
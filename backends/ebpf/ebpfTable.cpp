@@ -54,6 +54,14 @@ class ActionTranslationVisitor : public CodeGenInspector {
         return false;
     }
 
+    bool preorder(const IR::ExitStatement*) {
+        // Actions are expanded inline in the generated filter function,
+        // so a plain return would skip the epilogue; exit the pipeline
+        // through the program's end label instead.
+        builder->appendFormat("goto %s;", program->endLabel.c_str());
+        return false;
+    }
+
     bool preorder(const IR::P4Action* act) {
         action = act;
         visit(action->body);
@@ -73,8 +81,34 @@ EBPFTable::EBPFTable(const EBPFProgram* program, const IR::TableBlock* table,
     base = table->container->name.name + "_actions";
     actionEnumName = program->refMap->newName(base);
 
+    base = instanceName + "_cache";
+    cacheMapName = program->refMap->newName(base);
+
     keyGenerator = table->container->getKey();
     actionList = table->container->getActionList();
+
+    // A table whose entries are all given as const entries over scalar
+    // exact-match keys never changes at runtime, so it can be matched with a
+    // branch chain in the generated code; see emitConstEntriesLookup.
+    if (keyGenerator != nullptr && table->container->getEntries() != nullptr) {
+        constEntriesInline = true;
+        for (auto c : keyGenerator->keyElements) {
+            auto mtdecl = program->refMap->getDeclaration(c->matchType->path, true);
+            auto matchType = mtdecl->getNode()->to<IR::Declaration_ID>();
+            if (matchType->name.name != P4::P4CoreLibrary::instance().exactMatch.name) {
+                constEntriesInline = false;
+                break;
+            }
+            auto type = program->typeMap->getType(c->expression);
+            auto ebpfType = EBPFTypeFactory::instance->create(type);
+            auto scalar = ebpfType == nullptr ? nullptr : ebpfType->to<EBPFScalarType>();
+            if (scalar == nullptr ||
+                !EBPFScalarType::generatesScalar(scalar->implementationWidthInBits())) {
+                constEntriesInline = false;
+                break;
+            }
+        }
+    }
 }
 
 void EBPFTable::emitKeyType(CodeBuilder* builder) {
@@ -120,8 +154,8 @@ void EBPFTable::emitKeyType(CodeBuilder* builder) {
 
             auto mtdecl = program->refMap->getDeclaration(c->matchType->path, true);
             auto matchType = mtdecl->getNode()->to<IR::Declaration_ID>();
-            if (matchType->name.name != P4::P4CoreLibrary::instance.exactMatch.name &&
-                matchType->name.name != P4::P4CoreLibrary::instance.lpmMatch.name)
+            if (matchType->name.name != P4::P4CoreLibrary::instance().exactMatch.name &&
+                matchType->name.name != P4::P4CoreLibrary::instance().lpmMatch.name)
                 ::error(ErrorType::ERR_UNSUPPORTED,
                         "Match of type %1% not supported", c->matchType);
         }
@@ -251,7 +285,7 @@ void EBPFTable::emitInstance(CodeBuilder* builder) {
         for (auto it : keyGenerator->keyElements) {
             auto mtdecl = program->refMap->getDeclaration(it->matchType->path, true);
             auto matchType = mtdecl->getNode()->to<IR::Declaration_ID>();
-            if (matchType->name.name == P4::P4CoreLibrary::instance.lpmMatch.name) {
+            if (matchType->name.name == P4::P4CoreLibrary::instance().lpmMatch.name) {
                 if (tableKind == TableLPMTrie) {
                     ::error(ErrorType::ERR_UNSUPPORTED,
                             "%1%: only one LPM field allowed", it->matchType);
@@ -279,9 +313,25 @@ void EBPFTable::emitInstance(CodeBuilder* builder) {
         }
 
         cstring name = EBPFObject::externalName(table->container);
-        builder->target->emitTableDecl(builder, name, tableKind,
-                                       cstring("struct ") + keyTypeName,
-                                       cstring("struct ") + valueTypeName, size);
+        // When the const entries are compiled into the lookup code by
+        // emitConstEntriesLookup no data map is needed; only the default
+        // action map below remains.
+        if (!constEntriesInline)
+            builder->target->emitTableDecl(builder, name, tableKind,
+                                           cstring("struct ") + keyTypeName,
+                                           cstring("struct ") + valueTypeName, size);
+
+        if (!constEntriesInline &&
+            tableKind == TableLPMTrie && program->options.enableTableCache) {
+            // An exact-match LRU cache in front of the trie: packets of a
+            // flow already seen hit one hash lookup on the full key instead
+            // of an LPM walk. Entries are evicted by the LRU policy only,
+            // never by control-plane table updates.
+            cacheEnabled = true;
+            builder->target->emitTableDecl(builder, cacheMapName, TableLruHash,
+                                           cstring("struct ") + keyTypeName,
+                                           cstring("struct ") + valueTypeName, size);
+        }
     }
     builder->target->emitTableDecl(builder, defaultActionMapName, TableArray,
                                    program->arrayIndexType,
@@ -317,6 +367,83 @@ void EBPFTable::emitKey(CodeBuilder* builder, cstring keyName) {
     }
 }
 
+// Emits a branch chain matching the table's const entries against the key
+// that emitKey just built, in entry order.  The matching entry's action and
+// arguments are written to a stack-allocated value, so the code after the
+// lookup (miss handling, emitAction) is the same as for a map-backed table.
+void EBPFTable::emitConstEntriesLookup(CodeBuilder* builder, cstring keyName,
+                                       cstring valueName) {
+    auto entries = table->container->getEntries();
+    CHECK_NULL(entries);
+    cstring entryVariable = valueName + "_entry";
+
+    builder->emitIndent();
+    builder->appendFormat("struct %s %s = {}", valueTypeName.c_str(), entryVariable.c_str());
+    builder->endOfStatement(true);
+
+    CodeGenInspector cg(program->refMap, program->typeMap);
+    cg.setBuilder(builder);
+
+    bool firstEntry = true;
+    for (auto e : entries->entries) {
+        auto keyList = e->getKeys();
+        BUG_CHECK(keyList->components.size() == keyGenerator->keyElements.size(),
+                  "%1%: entry key size does not match the table key", e);
+
+        if (firstEntry)
+            builder->emitIndent();
+        else
+            builder->append(" else ");
+        firstEntry = false;
+        builder->append("if (");
+        bool firstCondition = true;
+        size_t index = 0;
+        for (auto c : keyGenerator->keyElements) {
+            auto keyValue = keyList->components.at(index++);
+            if (keyValue->is<IR::DefaultExpression>())
+                // A '_' key matches any value.
+                continue;
+            if (!firstCondition)
+                builder->append(" && ");
+            firstCondition = false;
+            cstring fieldName = ::get(keyFieldNames, c);
+            builder->appendFormat("%s.%s == ", keyName.c_str(), fieldName.c_str());
+            keyValue->apply(cg);
+        }
+        if (firstCondition)
+            // All key components were '_'.
+            builder->append("1");
+        builder->append(") ");
+        builder->blockStart();
+
+        auto entryAction = e->getAction();
+        BUG_CHECK(entryAction->is<IR::MethodCallExpression>(),
+                  "%1%: expected an action call", entryAction);
+        auto mce = entryAction->to<IR::MethodCallExpression>();
+        auto mi = P4::MethodInstance::resolve(mce, program->refMap, program->typeMap);
+        auto ac = mi->to<P4::ActionCall>();
+        BUG_CHECK(ac != nullptr, "%1%: expected an action call", mce);
+        cstring name = EBPFObject::externalName(ac->action);
+
+        builder->emitIndent();
+        builder->appendFormat("%s.action = %s", entryVariable.c_str(), name.c_str());
+        builder->endOfStatement(true);
+        for (auto p : *mi->substitution.getParametersInArgumentOrder()) {
+            auto arg = mi->substitution.lookup(p);
+            builder->emitIndent();
+            builder->appendFormat("%s.u.%s.%s = ", entryVariable.c_str(),
+                                  name.c_str(), p->name.name.c_str());
+            arg->apply(cg);
+            builder->endOfStatement(true);
+        }
+        builder->emitIndent();
+        builder->appendFormat("%s = &%s", valueName.c_str(), entryVariable.c_str());
+        builder->endOfStatement(true);
+        builder->blockEnd(false);
+    }
+    builder->newline();
+}
+
 void EBPFTable::emitAction(CodeBuilder* builder, cstring valueName) {
     builder->emitIndent();
     builder->appendFormat("switch (%s->action) ", valueName.c_str());
@@ -411,9 +538,10 @@ void EBPFTable::emitInitializer(CodeBuilder* builder) {
     builder->newline();
     builder->blockEnd(true);
 
-    // Emit code for table initializer
+    // Emit code for table initializer; entries matched inline need no
+    // load-time population since there is no map.
     auto entries = t->getEntries();
-    if (entries == nullptr)
+    if (entries == nullptr || constEntriesInline)
         return;
 
     builder->emitIndent();
@@ -657,11 +785,11 @@ EBPFCounterTable::emitMethodInvocation(CodeBuilder* builder, const P4::ExternMet
 void EBPFCounterTable::emitTypes(CodeBuilder* builder) {
     builder->emitIndent();
     builder->appendFormat("typedef %s %s",
-                          EBPFModel::instance.counterIndexType.c_str(), keyTypeName.c_str());
+                          EBPFModel::instance().counterIndexType.c_str(), keyTypeName.c_str());
     builder->endOfStatement(true);
     builder->emitIndent();
     builder->appendFormat("typedef %s %s",
-                          EBPFModel::instance.counterValueType.c_str(), valueTypeName.c_str());
+                          EBPFModel::instance().counterValueType.c_str(), valueTypeName.c_str());
     builder->endOfStatement(true);
 }
 
@@ -51,6 +51,14 @@ class EBPFTable final : public EBPFTableBase {
     const IR::TableBlock*    table;
     cstring               defaultActionMapName;
     cstring               actionEnumName;
+    // Set when --table-caching emits an LRU cache map in front of this
+    // table; the apply code then checks the cache before the real lookup.
+    cstring               cacheMapName;
+    bool                  cacheEnabled = false;
+    // True when the table has const entries over scalar exact-match keys
+    // only.  The entries are immutable, so they are compiled into a branch
+    // chain in the apply code and no data map is emitted or populated.
+    bool                  constEntriesInline = false;
     std::map<const IR::KeyElement*, cstring> keyFieldNames;
     std::map<const IR::KeyElement*, EBPFType*> keyTypes;
 
@@ -61,6 +69,7 @@ class EBPFTable final : public EBPFTableBase {
     void emitKeyType(CodeBuilder* builder);
     void emitValueType(CodeBuilder* builder);
     void emitKey(CodeBuilder* builder, cstring keyName);
+    void emitConstEntriesLookup(CodeBuilder* builder, cstring keyName, cstring valueName);
     void emitAction(CodeBuilder* builder, cstring valueName);
     void emitInitializer(CodeBuilder* builder);
 };
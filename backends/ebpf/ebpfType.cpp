@@ -23,6 +23,9 @@ EBPFTypeFactory* EBPFTypeFactory::instance;
 EBPFType* EBPFTypeFactory::create(const IR::Type* type) {
     CHECK_NULL(type);
     CHECK_NULL(typeMap);
+    auto it = created.find(type);
+    if (it != created.end())
+        return it->second;
     EBPFType* result = nullptr;
     if (type->is<IR::Type_Boolean>()) {
         result = new EBPFBoolType();
@@ -51,6 +54,8 @@ EBPFType* EBPFTypeFactory::create(const IR::Type* type) {
                 "Type %1% not supported", type);
     }
 
+    if (result != nullptr)
+        created.emplace(type, result);
     return result;
 }
 
@@ -52,6 +52,11 @@ class IHasWidth {
 class EBPFTypeFactory {
  protected:
     const P4::TypeMap* typeMap;
+    /// Wrappers already created, keyed by the IR type node.  Type nodes
+    /// are shared in the IR, so repeated references to the same type
+    /// reuse one wrapper instead of rebuilding it -- and, for structs,
+    /// rebuilding every field wrapper along with it.
+    std::map<const IR::Type*, EBPFType*> created;
     explicit EBPFTypeFactory(const P4::TypeMap* typeMap) :
             typeMap(typeMap) { CHECK_NULL(typeMap); }
  public:
@@ -35,7 +35,6 @@ limitations under the License.
 #include "midend/local_copyprop.h"
 #include "midend/midEndLast.h"
 #include "midend/noMatch.h"
-#include "midend/removeExits.h"
 #include "midend/removeLeftSlices.h"
 #include "midend/removeMiss.h"
 #include "midend/removeParameters.h"
@@ -50,7 +49,7 @@ limitations under the License.
 
 namespace EBPF {
 
-class EnumOn32Bits : public P4::ChooseEnumRepresentation {
+class ByteAlignedEnums : public P4::ChooseEnumRepresentation {
     bool convert(const IR::Type_Enum* type) const override {
         if (type->srcInfo.isValid()) {
             auto sourceFile = type->srcInfo.getSourceFile();
@@ -60,8 +59,14 @@ class EnumOn32Bits : public P4::ChooseEnumRepresentation {
         }
         return true;
     }
-    unsigned enumSize(unsigned) const override
-    { return 32; }
+    unsigned enumSize(unsigned enumCount) const override {
+        // Use the narrowest byte-aligned representation that can hold
+        // all members: narrower enums make narrower table keys.
+        unsigned width = 8;
+        while (enumCount > (1ULL << width))
+            width += 8;
+        return width;
+    }
 };
 
 const IR::ToplevelBlock* MidEnd::run(EbpfOptions& options,
@@ -76,7 +81,7 @@ const IR::ToplevelBlock* MidEnd::run(EbpfOptions& options,
     PassManager midEnd = {};
     if (options.loadIRFromJson == false) {
         midEnd.addPasses({
-            new P4::ConvertEnums(&refMap, &typeMap, new EnumOn32Bits()),
+            new P4::ConvertEnums(&refMap, &typeMap, new ByteAlignedEnums()),
             new P4::RemoveMiss(&refMap, &typeMap),
             new P4::ClearTypeMap(&typeMap),
             new P4::EliminateNewtype(&refMap, &typeMap),
@@ -86,13 +91,17 @@ const IR::ToplevelBlock* MidEnd::run(EbpfOptions& options,
                                 new P4::OrPolicy(
                                     new P4::IsValid(&refMap, &typeMap),
                                     new P4::IsLikeLeftValue())),
-            new P4::RemoveExits(&refMap, &typeMap),
+            // Exits are not lowered to hasExited guards here: the code
+            // generator translates them directly into a goto to the
+            // program's end label, which avoids testing a flag around
+            // every statement that follows a table apply.
             new P4::ConstantFolding(&refMap, &typeMap),
             new P4::SimplifySelectCases(&refMap, &typeMap, false),  // accept non-constant keysets
             new P4::HandleNoMatch(&refMap),
             new P4::SimplifyParsers(&refMap),
-            new P4::StrengthReduction(&refMap, &typeMap),
-            new P4::SimplifyComparisons(&refMap, &typeMap),
+            new P4::StrengthReduction(&refMap, &typeMap, nullptr,
+                                      /* enableMachineArith */ true),
+            new P4::SimplifyComparisons(&refMap, &typeMap, true),
             new P4::EliminateTuples(&refMap, &typeMap),
             new P4::LocalCopyPropagation(&refMap, &typeMap),
             new P4::SimplifySelectList(&refMap, &typeMap),
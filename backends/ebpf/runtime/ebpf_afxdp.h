@@ -0,0 +1,31 @@
+/*
+Copyright 2018 VMware, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+ * Definitions for code generated by the afxdp target.  The match-action
+ * pipeline is compiled as ordinary user-space C, exactly as for the test
+ * target -- same packet descriptor, same user-space table registry -- so
+ * everything is borrowed from there.  The difference is purely in how the
+ * filter is driven: the AF_XDP harness (ebpf_runtime_afxdp.c) feeds it
+ * live packets from a zero-copy umem ring instead of pcap files.
+ */
+
+#ifndef BACKENDS_EBPF_RUNTIME_EBPF_AFXDP_H_
+#define BACKENDS_EBPF_RUNTIME_EBPF_AFXDP_H_
+
+#include "ebpf_test.h"
+
+#endif  // BACKENDS_EBPF_RUNTIME_EBPF_AFXDP_H_
@@ -0,0 +1,273 @@
+/*
+Copyright 2018 VMware, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <unistd.h>         // getopt(), sendto()
+#include <signal.h>         // signal()
+#include <stdio.h>
+#include <stdlib.h>         // atoi(), exit()
+#include <string.h>         // memset(), strerror()
+#include <errno.h>
+#include <poll.h>           // poll()
+#include <net/if.h>         // if_nametoindex()
+#include <sys/mman.h>       // mmap()
+#include <linux/if_xdp.h>   // XDP_ZEROCOPY, XDP_COPY
+#include <bpf/xsk.h>        // xsk_umem__*, xsk_socket__*, xsk_ring_*
+
+#include "ebpf_test.h"
+#include "ebpf_runtime_afxdp.h"
+
+#define NUM_FRAMES 4096
+#define FRAME_SIZE XSK_UMEM__DEFAULT_FRAME_SIZE
+
+/* The umem area shared with the kernel and the rings carved out of it. */
+struct xsk_state {
+    void *buffer;
+    struct xsk_umem *umem;
+    struct xsk_socket *xsk;
+    struct xsk_ring_prod fq;    /* fill queue: frames handed to the kernel */
+    struct xsk_ring_cons cq;    /* completion queue: transmitted frames */
+    struct xsk_ring_cons rx;
+    struct xsk_ring_prod tx;
+    /* Stack of umem frame addresses not currently owned by the kernel. */
+    uint64_t free_frames[NUM_FRAMES];
+    uint32_t num_free;
+    uint32_t ifindex;
+    uint32_t outstanding_tx;
+};
+
+static volatile sig_atomic_t running = 1;
+
+static void on_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static uint64_t alloc_frame(struct xsk_state *s) {
+    if (s->num_free == 0)
+        return UINT64_MAX;
+    return s->free_frames[--s->num_free];
+}
+
+static void free_frame(struct xsk_state *s, uint64_t addr) {
+    s->free_frames[s->num_free++] = addr;
+}
+
+/* Hand as many free frames as possible back to the kernel for reception. */
+static void refill_fill_queue(struct xsk_state *s) {
+    uint32_t idx;
+    uint32_t avail = xsk_prod_nb_free(&s->fq, s->num_free);
+    if (avail > s->num_free)
+        avail = s->num_free;
+    if (avail == 0)
+        return;
+    uint32_t reserved = xsk_ring_prod__reserve(&s->fq, avail, &idx);
+    for (uint32_t i = 0; i < reserved; i++)
+        *xsk_ring_prod__fill_addr(&s->fq, idx++) = alloc_frame(s);
+    xsk_ring_prod__submit(&s->fq, reserved);
+}
+
+/* Reclaim frames the kernel has finished transmitting. */
+static void drain_completion_queue(struct xsk_state *s) {
+    uint32_t idx;
+    if (s->outstanding_tx == 0)
+        return;
+    uint32_t done = xsk_ring_cons__peek(&s->cq, s->outstanding_tx, &idx);
+    for (uint32_t i = 0; i < done; i++)
+        free_frame(s, *xsk_ring_cons__comp_addr(&s->cq, idx++));
+    xsk_ring_cons__release(&s->cq, done);
+    s->outstanding_tx -= done;
+}
+
+static int setup_socket(struct xsk_state *s, const char *ifname, int queue) {
+    int err;
+    memset(s, 0, sizeof(*s));
+    s->ifindex = if_nametoindex(ifname);
+    if (s->ifindex == 0) {
+        fprintf(stderr, "Unknown interface %s\n", ifname);
+        return -1;
+    }
+    s->buffer = mmap(NULL, (size_t)NUM_FRAMES * FRAME_SIZE,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (s->buffer == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    err = xsk_umem__create(&s->umem, s->buffer,
+                           (uint64_t)NUM_FRAMES * FRAME_SIZE,
+                           &s->fq, &s->cq, NULL);
+    if (err) {
+        fprintf(stderr, "Failed to create umem: %s\n", strerror(-err));
+        return -1;
+    }
+    struct xsk_socket_config cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.rx_size = XSK_RING_CONS__DEFAULT_NUM_DESCS;
+    cfg.tx_size = XSK_RING_PROD__DEFAULT_NUM_DESCS;
+    /* Prefer zero-copy, fall back to copy mode for drivers without support. */
+    cfg.bind_flags = XDP_ZEROCOPY;
+    err = xsk_socket__create(&s->xsk, ifname, queue, s->umem,
+                             &s->rx, &s->tx, &cfg);
+    if (err) {
+        cfg.bind_flags = XDP_COPY;
+        err = xsk_socket__create(&s->xsk, ifname, queue, s->umem,
+                                 &s->rx, &s->tx, &cfg);
+    }
+    if (err) {
+        fprintf(stderr, "Failed to bind AF_XDP socket: %s\n", strerror(-err));
+        return -1;
+    }
+    /* Initially all frames are ours; half go straight to the fill queue. */
+    for (uint32_t i = 0; i < NUM_FRAMES; i++)
+        free_frame(s, (uint64_t)i * FRAME_SIZE);
+    refill_fill_queue(s);
+    return 0;
+}
+
+static void teardown_socket(struct xsk_state *s) {
+    if (s->xsk)
+        xsk_socket__delete(s->xsk);
+    if (s->umem)
+        xsk_umem__delete(s->umem);
+    if (s->buffer && s->buffer != MAP_FAILED)
+        munmap(s->buffer, (size_t)NUM_FRAMES * FRAME_SIZE);
+}
+
+/**
+ * @brief Run the generated filter over live packets from an AF_XDP socket.
+ * @details Pulls batches of up to AFXDP_BATCH_SIZE receive descriptors,
+ * wraps each umem frame in an sk_buff and calls the imported ebpf_filter
+ * function on it in place. Accepted packets are reflected back out of the
+ * same queue by moving their descriptor to the transmit ring, so the frame
+ * is never copied; dropped packets return their frame to the fill ring.
+ */
+int afxdp_loop(const char *ifname, int queue, int debug) {
+    struct xsk_state s;
+    if (setup_socket(&s, ifname, queue) < 0) {
+        teardown_socket(&s);
+        return EXIT_FAILURE;
+    }
+    struct pollfd pfd;
+    pfd.fd = xsk_socket__fd(s.xsk);
+    pfd.events = POLLIN;
+    while (running) {
+        drain_completion_queue(&s);
+        refill_fill_queue(&s);
+        uint32_t rx_idx;
+        uint32_t rcvd = xsk_ring_cons__peek(&s.rx, AFXDP_BATCH_SIZE, &rx_idx);
+        if (rcvd == 0) {
+            poll(&pfd, 1, 1000);
+            continue;
+        }
+        struct xdp_desc accepted_descs[AFXDP_BATCH_SIZE];
+        uint32_t accepted = 0;
+        for (uint32_t i = 0; i < rcvd; i++) {
+            const struct xdp_desc *desc = xsk_ring_cons__rx_desc(&s.rx, rx_idx++);
+            struct sk_buff skb;
+            skb.data = xsk_umem__get_data(s.buffer, desc->addr);
+            skb.len = desc->len;
+            skb.ifindex = s.ifindex;
+            int result = ebpf_filter(&skb);
+            if (debug)
+                printf("Result of the eBPF parsing is: %d\n", result);
+            if (result != 0) {
+                /* Reflect the frame: the descriptor moves to the transmit
+                 * ring, the packet data is never copied. */
+                accepted_descs[accepted].addr = desc->addr;
+                accepted_descs[accepted].len = desc->len;
+                accepted++;
+            } else {
+                free_frame(&s, desc->addr);
+            }
+        }
+        xsk_ring_cons__release(&s.rx, rcvd);
+        uint32_t tx_idx;
+        /* A batch never exceeds the ring size, so slots must eventually
+         * free up; reclaim completions until they do. */
+        while (xsk_ring_prod__reserve(&s.tx, accepted, &tx_idx) < accepted)
+            drain_completion_queue(&s);
+        for (uint32_t i = 0; i < accepted; i++)
+            *xsk_ring_prod__tx_desc(&s.tx, tx_idx + i) = accepted_descs[i];
+        xsk_ring_prod__submit(&s.tx, accepted);
+        s.outstanding_tx += accepted;
+        if (accepted > 0 && xsk_ring_prod__needs_wakeup(&s.tx))
+            sendto(xsk_socket__fd(s.xsk), NULL, 0, MSG_DONTWAIT, NULL, 0);
+    }
+    teardown_socket(&s);
+    return EXIT_SUCCESS;
+}
+
+void init_ebpf_tables(int debug) {
+    /* Initialize the registry of shared tables */
+    struct bpf_table* current = tables;
+    while (current->name != NULL) {
+        if (debug)
+            printf("Adding table %s\n", current->name);
+        BPF_OBJ_PIN(current, current->name);
+        current++;
+    }
+}
+
+void delete_ebpf_tables(int debug) {
+    /* Delete all the remaining tables in the user program */
+    struct bpf_table* current = tables;
+    while (current->name != NULL) {
+        if (debug)
+            printf("Deleting table %s\n", current->name);
+        registry_delete_tbl(current->name);
+        current++;
+    }
+}
+
+void usage(char *name) {
+    printf("This program processes live packets from an AF_XDP socket with a\n"
+            "packet filter generated by the p4c-ebpf compiler.\n\n"
+            "Usage: %s -i interface [-q queue] [-d]\n"
+            "\t-i: The network interface to attach to.\n"
+            "\t-q: The receive queue to bind to (default 0).\n"
+            "\t-d: Turn on debug messages.\n", name);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+    const char *ifname = NULL;
+    int queue = 0;
+    int debug = 0;
+    int c;
+    while ((c = getopt(argc, argv, "i:q:d")) != -1) {
+        switch (c) {
+        case 'i':
+            ifname = optarg;
+            break;
+        case 'q':
+            queue = atoi(optarg);
+            break;
+        case 'd':
+            debug = 1;
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    if (ifname == NULL)
+        usage(argv[0]);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    init_ebpf_tables(debug);
+    int ret = afxdp_loop(ifname, queue, debug);
+    delete_ebpf_tables(debug);
+    return ret;
+}
@@ -0,0 +1,40 @@
+/*
+Copyright 2018 VMware, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+ * Runtime specific to the afxdp target.  Binds an AF_XDP socket to one
+ * queue of a network interface, maps a umem packet buffer shared with the
+ * kernel (zero-copy when the driver supports it, copy mode otherwise) and
+ * runs the generated ebpf_filter over batches of received frames.
+ * Accepted frames are retransmitted out of the same queue from the same
+ * umem frame; dropped ones are returned to the fill ring.
+ */
+
+#ifndef BACKENDS_EBPF_RUNTIME_EBPF_RUNTIME_AFXDP_H_
+#define BACKENDS_EBPF_RUNTIME_EBPF_RUNTIME_AFXDP_H_
+
+#include "ebpf_test.h"
+
+/* Frames processed per ring poll; descriptors are consumed, filtered and
+ * resubmitted in batches of this size to amortize the ring barriers. */
+#define AFXDP_BATCH_SIZE 32
+
+int afxdp_loop(const char *ifname, int queue, int debug);
+
+void init_ebpf_tables(int debug);
+void delete_ebpf_tables(int debug);
+
+#endif  // BACKENDS_EBPF_RUNTIME_EBPF_RUNTIME_AFXDP_H_
@@ -54,6 +54,8 @@ void KernelSamplesTarget::emitTableDecl(Util::SourceCodeBuilder* builder,
         kind = "BPF_MAP_TYPE_ARRAY";
     else if (tableKind == TableLPMTrie)
         kind = "BPF_MAP_TYPE_LPM_TRIE";
+    else if (tableKind == TableLruHash)
+        kind = "BPF_MAP_TYPE_LRU_HASH";
     else
         BUG("%1%: unsupported table kind", tableKind);
     builder->appendFormat("REGISTER_TABLE(%s, %s, ", tblName.c_str(), kind.c_str());
@@ -99,6 +101,13 @@ void TestTarget::emitTableDecl(Util::SourceCodeBuilder* builder,
 
 //////////////////////////////////////////////////////////////
 
+void AfXdpTarget::emitIncludes(Util::SourceCodeBuilder* builder) const {
+    builder->append("#include \"ebpf_afxdp.h\"\n");
+    builder->newline();
+}
+
+//////////////////////////////////////////////////////////////
+
 void BccTarget::emitTableLookup(Util::SourceCodeBuilder* builder, cstring tblName,
                                 cstring key, cstring value) const {
     builder->appendFormat("%s = %s.lookup(&%s)",
@@ -136,6 +145,8 @@ void BccTarget::emitTableDecl(Util::SourceCodeBuilder* builder,
         kind = "array";
     else if (tableKind == TableLPMTrie)
         kind = "lpm_trie";
+    else if (tableKind == TableLruHash)
+        kind = "lru_hash";
     else
         BUG("%1%: unsupported table kind", tableKind);
 
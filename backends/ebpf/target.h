@@ -29,7 +29,8 @@ namespace EBPF {
 enum TableKind {
     TableHash,
     TableArray,
-    TableLPMTrie  // longest prefix match trie
+    TableLPMTrie,  // longest prefix match trie
+    TableLruHash   // hash with least-recently-used eviction, used for caches
 };
 
 class Target {
@@ -127,7 +128,7 @@ class BccTarget : public Target {
 // Compiles with gcc
 class TestTarget : public EBPF::KernelSamplesTarget {
  public:
-    TestTarget() : KernelSamplesTarget("Userspace Test") {}
+    explicit TestTarget(cstring name = "Userspace Test") : KernelSamplesTarget(name) {}
     void emitIncludes(Util::SourceCodeBuilder* builder) const override;
     void emitTableDecl(Util::SourceCodeBuilder* builder,
                        cstring tblName, TableKind tableKind,
@@ -142,6 +143,17 @@ class TestTarget : public EBPF::KernelSamplesTarget {
     cstring sysMapPath() const override { return "/sys/fs/bpf"; }
 };
 
+// A user-space target processing packets over an AF_XDP socket.  The
+// match-action code is compiled as ordinary C, like the test target, and
+// linked with a harness (runtime/ebpf_runtime_afxdp.c) that pulls batches
+// of packets from a zero-copy umem ring, runs ebpf_filter on each, and
+// retransmits or drops them.
+class AfXdpTarget : public TestTarget {
+ public:
+    AfXdpTarget() : TestTarget("AF_XDP") {}
+    void emitIncludes(Util::SourceCodeBuilder* builder) const override;
+};
+
 }  // namespace EBPF
 
 #endif /* _BACKENDS_EBPF_TARGET_H_ */
@@ -31,8 +31,13 @@ namespace graphs {
 
 using Graph = ControlGraphs::Graph;
 
-Graph *ControlGraphs::ControlStack::pushBack(Graph &currentSubgraph, const cstring &name) {
-    auto &newSubgraph = currentSubgraph.create_subgraph();
+Graph *ControlGraphs::ControlStack::pushBack(Graph *currentSubgraph, const cstring &name) {
+    if (currentSubgraph == nullptr) {
+        names.push_back(name);
+        subgraphs.push_back(nullptr);
+        return nullptr;
+    }
+    auto &newSubgraph = currentSubgraph->create_subgraph();
     boost::get_property(newSubgraph, boost::graph_name) = "cluster" + getName(name);
     boost::get_property(newSubgraph, boost::graph_graph_attribute)["label"] = getName(name);
     // Justify the subgraph label to the right as it usually makes the generated
@@ -70,11 +75,91 @@ bool ControlGraphs::ControlStack::isEmpty() const {
 using vertex_t = ControlGraphs::vertex_t;
 
 ControlGraphs::ControlGraphs(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
-                             const cstring &graphsDir)
-    : refMap(refMap), typeMap(typeMap), graphsDir(graphsDir) {
+                             const cstring &graphsDir,
+                             bool streaming, bool collapseStatements)
+    : refMap(refMap), typeMap(typeMap), graphsDir(graphsDir),
+      streaming(streaming), collapseStatements(collapseStatements) {
     visitDagOnce = false;
 }
 
+// DOT string literals use '\\' as an escape character, and the vertex labels
+// produced by dbprint can contain quotes and newlines.
+static std::string dotEscape(const cstring &str) {
+    std::string escaped;
+    for (const char *p = str.c_str(); *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            escaped.push_back('\\');
+            escaped.push_back(*p);
+        } else if (*p == '\n') {
+            escaped.append("\\n");
+        } else {
+            escaped.push_back(*p);
+        }
+    }
+    return escaped;
+}
+
+vertex_t ControlGraphs::add_vertex(const cstring &name, VertexType type) {
+    if (!streaming) return Graphs::add_vertex(name, type);
+    auto v = streamVertexId++;
+    *streamOut << streamIndent << "node_" << v
+               << " [label=\"" << dotEscape(name) << "\""
+               << ",style=" << GraphAttributeSetter::vertexTypeGetStyle(type)
+               << ",shape=" << GraphAttributeSetter::vertexTypeGetShape(type)
+               << "]" << std::endl;
+    return v;
+}
+
+void ControlGraphs::add_edge(const vertex_t &from, const vertex_t &to, const cstring &name) {
+    if (!streaming) {
+        Graphs::add_edge(from, to, name);
+        return;
+    }
+    streamEdges << "    node_" << from << " -> node_" << to
+                << " [label=\"" << dotEscape(name) << "\"]" << std::endl;
+}
+
+void ControlGraphs::streamClusterBegin(const cstring &name) {
+    *streamOut << streamIndent << "subgraph \"cluster" << name << "\" {" << std::endl;
+    streamIndent += "    ";
+    *streamOut << streamIndent << "label=\"" << dotEscape(name) << "\"" << std::endl;
+    *streamOut << streamIndent << "labeljust=r" << std::endl;
+    *streamOut << streamIndent << "style=bold" << std::endl;
+}
+
+void ControlGraphs::streamClusterEnd() {
+    streamIndent.resize(streamIndent.size() - 4);
+    *streamOut << streamIndent << "}" << std::endl;
+}
+
+void ControlGraphs::writeStreamedGraph(const IR::ControlBlock *block, const cstring &name) {
+    auto path = Util::PathName(graphsDir).join(name + ".dot");
+    auto out = openFile(path.toString(), false);
+    if (out == nullptr) {
+        ::error(ErrorType::ERR_IO, "Failed to open file %1%", path.toString());
+        return;
+    }
+    streamOut = out;
+    streamVertexId = 0;
+    streamEdges.str("");
+    streamIndent = "    ";
+    *streamOut << "digraph " << name << " {" << std::endl;
+    BUG_CHECK(controlStack.isEmpty(), "Invalid control stack state");
+    controlStack.pushBack(nullptr, "");
+    instanceName = boost::none;
+    start_v = add_vertex("__START__", VertexType::OTHER);
+    exit_v = add_vertex("__EXIT__", VertexType::OTHER);
+    parents = {{start_v, new EdgeUnconditional()}};
+    visit(block->getNode());
+    for (auto parent : parents)
+        add_edge(parent.first, exit_v, parent.second->label());
+    controlStack.popBack();
+    *streamOut << streamEdges.str();
+    *streamOut << "}" << std::endl;
+    streamOut->flush();
+    streamOut = nullptr;
+}
+
 void ControlGraphs::writeGraphToFile(const Graph &g, const cstring &name) {
     auto path = Util::PathName(graphsDir).join(name + ".dot");
     auto out = openFile(path.toString(), false);
@@ -93,10 +178,14 @@ bool ControlGraphs::preorder(const IR::PackageBlock *block) {
         if (it.second->is<IR::ControlBlock>()) {
             auto name = it.second->to<IR::ControlBlock>()->container->name;
             LOG1("Generating graph for top-level control " << name);
+            if (streaming) {
+                writeStreamedGraph(it.second->to<IR::ControlBlock>(), name);
+                continue;
+            }
             Graph g_;
             g = &g_;
             BUG_CHECK(controlStack.isEmpty(), "Invalid control stack state");
-            g = controlStack.pushBack(g_, "");
+            g = controlStack.pushBack(&g_, "");
             instanceName = boost::none;
             boost::get_property(g_, boost::graph_name) = name;
             start_v = add_vertex("__START__", VertexType::OTHER);
@@ -125,7 +214,8 @@ bool ControlGraphs::preorder(const IR::P4Control *cont) {
     bool doPop = false;
     // instanceName == boost::none <=> top level
     if (instanceName != boost::none) {
-        g = controlStack.pushBack(*g, instanceName.get());
+        if (streaming) streamClusterBegin(controlStack.getName(instanceName.get()));
+        g = controlStack.pushBack(streaming ? nullptr : g, instanceName.get());
         doPop = true;
     }
     return_parents.clear();
@@ -133,7 +223,10 @@ bool ControlGraphs::preorder(const IR::P4Control *cont) {
     merge_other_statements_into_vertex();
     parents.insert(parents.end(), return_parents.begin(), return_parents.end());
     return_parents.clear();
-    if (doPop) g = controlStack.popBack();
+    if (doPop) {
+        g = controlStack.popBack();
+        if (streaming) streamClusterEnd();
+    }
     return false;
 }
 
@@ -231,14 +324,14 @@ bool ControlGraphs::preorder(const IR::MethodCallStatement *statement) {
         } else {
             BUG("Unsupported apply method: %1%", instance);
         }
-    } else {
+    } else if (!collapseStatements) {
         statementsStack.push_back(statement);
     }
     return false;
 }
 
 bool ControlGraphs::preorder(const IR::AssignmentStatement *statement) {
-    statementsStack.push_back(statement);
+    if (!collapseStatements) statementsStack.push_back(statement);
     return false;
 }
 
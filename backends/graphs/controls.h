@@ -17,6 +17,10 @@ limitations under the License.
 #ifndef _BACKENDS_GRAPHS_CONTROLS_H_
 #define _BACKENDS_GRAPHS_CONTROLS_H_
 
+#include <iosfwd>
+#include <sstream>
+#include <string>
+
 #include "graphs.h"
 
 namespace graphs {
@@ -25,7 +29,9 @@ class ControlGraphs : public Graphs {
  public:
     class ControlStack {
      public:
-        Graph *pushBack(Graph &currentSubgraph, const cstring &name);
+        // @currentSubgraph may be null, in which case the stack only tracks
+        // names (used by the streaming emitter, which does not build a graph).
+        Graph *pushBack(Graph *currentSubgraph, const cstring &name);
         Graph *popBack();
         Graph *getSubgraph() const;
         cstring getName(const cstring &name) const;
@@ -35,7 +41,8 @@ class ControlGraphs : public Graphs {
         std::vector<Graph *> subgraphs{};
     };
 
-    ControlGraphs(P4::ReferenceMap *refMap, P4::TypeMap *typeMap, const cstring &graphsDir);
+    ControlGraphs(P4::ReferenceMap *refMap, P4::TypeMap *typeMap, const cstring &graphsDir,
+                  bool streaming = false, bool collapseStatements = false);
 
     bool preorder(const IR::PackageBlock *block) override;
     bool preorder(const IR::ControlBlock *block) override;
@@ -52,8 +59,29 @@ class ControlGraphs : public Graphs {
     void writeGraphToFile(const Graph &g, const cstring &name);
 
  private:
+    vertex_t add_vertex(const cstring &name, VertexType type) override;
+    void add_edge(const vertex_t &from, const vertex_t &to, const cstring &name) override;
+
+    // Writes the graph for one top-level control directly to its DOT file
+    // while the control is being visited, without building a boost graph
+    // first. This is much cheaper than going through boost::subgraph, whose
+    // bookkeeping does not scale to programs with hundreds of tables.
+    void writeStreamedGraph(const IR::ControlBlock *block, const cstring &name);
+    void streamClusterBegin(const cstring &name);
+    void streamClusterEnd();
+
     P4::ReferenceMap *refMap; P4::TypeMap *typeMap;
     const cstring graphsDir;
+    // write DOT incrementally instead of building a boost graph
+    const bool streaming;
+    // do not emit action-level statement vertices, only tables and conditions
+    const bool collapseStatements;
+    std::ostream *streamOut{nullptr};
+    // edges are buffered and emitted after all clusters, so that a vertex is
+    // declared inside its cluster rather than where an edge first mentions it
+    std::stringstream streamEdges{};
+    unsigned streamVertexId{0};
+    std::string streamIndent{};
     Parents return_parents{};
     // we keep a stack of subgraphs; every time we visit a control, we create a
     // new subgraph and push it to the stack; this new graph becomes the
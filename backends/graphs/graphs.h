@@ -138,9 +138,9 @@ class Graphs : public Inspector {
     // assignments) into a single vertex to reduce graph complexity
     boost::optional<vertex_t> merge_other_statements_into_vertex();
 
-    vertex_t add_vertex(const cstring &name, VertexType type);
+    virtual vertex_t add_vertex(const cstring &name, VertexType type);
     vertex_t add_and_connect_vertex(const cstring &name, VertexType type);
-    void add_edge(const vertex_t &from, const vertex_t &to, const cstring &name);
+    virtual void add_edge(const vertex_t &from, const vertex_t &to, const cstring &name);
 
     class GraphAttributeSetter {
      public:
@@ -161,7 +161,6 @@ class Graphs : public Inspector {
             }
         }
 
-     private:
         static cstring vertexTypeGetShape(VertexType type) {
             switch (type) {
             case VertexType::TABLE:
@@ -65,11 +65,25 @@ class Options : public CompilerOptions {
     cstring graphsDir{"."};
     // read from json
     bool loadIRFromJson = false;
+    // write control graphs in a single streaming pass
+    bool streaming = false;
+    // omit action-level statement nodes from control graphs
+    bool collapseStatements = false;
     Options() {
         registerOption("--graphs-dir", "dir",
                        [this](const char* arg) { graphsDir = arg; return true; },
                        "Use this directory to dump graphs in dot format "
                        "(default is current working directory)\n");
+        registerOption("--stream", nullptr,
+                       [this](const char*) { streaming = true; return true; },
+                       "Write control graphs to their dot files while the "
+                       "program is visited, instead of building a graph in "
+                       "memory first; scales to very large programs.");
+        registerOption("--no-statements", nullptr,
+                       [this](const char*) { collapseStatements = true; return true; },
+                       "Omit action-level detail (action calls, assignments) "
+                       "from control graphs; only tables and conditions are "
+                       "shown.");
         registerOption("--fromJSON", "file",
                 [this](const char* arg) { loadIRFromJson = true; file = arg; return true; },
                 "Use IR representation from JsonFile dumped previously,"\
@@ -152,7 +166,8 @@ int main(int argc, char *const argv[]) {
 
     LOG2("Generating graphs under " << options.graphsDir);
     LOG2("Generating control graphs");
-    graphs::ControlGraphs cgen(&midEnd.refMap, &midEnd.typeMap, options.graphsDir);
+    graphs::ControlGraphs cgen(&midEnd.refMap, &midEnd.typeMap, options.graphsDir,
+                               options.streaming, options.collapseStatements);
     top->getMain()->apply(cgen);
     LOG2("Generating parser graphs");
     graphs::ParserGraphs pgg(&midEnd.refMap, &midEnd.typeMap, options.graphsDir);
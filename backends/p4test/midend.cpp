@@ -81,13 +81,15 @@ MidEnd::MidEnd(CompilerOptions& options, std::ostream* outStream) {
         options.ndebug ? new P4::RemoveAssertAssume(&refMap, &typeMap) : nullptr,
         new P4::RemoveMiss(&refMap, &typeMap),
         new P4::EliminateNewtype(&refMap, &typeMap),
-        new P4::EliminateSerEnums(&refMap, &typeMap),
+        new PassIfFeature(FeatureCensus::SerEnums,
+                          {new P4::EliminateSerEnums(&refMap, &typeMap)}),
         new P4::RemoveActionParameters(&refMap, &typeMap),
         new P4::SimplifyKey(&refMap, &typeMap,
                             new P4::OrPolicy(
                                 new P4::IsValid(&refMap, &typeMap),
                                 new P4::IsLikeLeftValue())),
-        new P4::RemoveExits(&refMap, &typeMap),
+        new PassIfFeature(FeatureCensus::Exits,
+                          {new P4::RemoveExits(&refMap, &typeMap)}),
         new P4::ConstantFolding(&refMap, &typeMap),
         new P4::SimplifySelectCases(&refMap, &typeMap, false),  // non-constant keysets
         new P4::ExpandLookahead(&refMap, &typeMap),
@@ -95,14 +97,14 @@ MidEnd::MidEnd(CompilerOptions& options, std::ostream* outStream) {
         new P4::HandleNoMatch(&refMap),
         new P4::SimplifyParsers(&refMap),
         new P4::StrengthReduction(&refMap, &typeMap),
-        new P4::EliminateTuples(&refMap, &typeMap),
+        new PassIfFeature(FeatureCensus::Tuples,
+                          {new P4::EliminateTuples(&refMap, &typeMap)}),
         new P4::SimplifyComparisons(&refMap, &typeMap),
         new P4::CopyStructures(&refMap, &typeMap),
         new P4::NestedStructs(&refMap, &typeMap),
         new P4::SimplifySelectList(&refMap, &typeMap),
         new P4::RemoveSelectBooleans(&refMap, &typeMap),
-        new P4::FlattenHeaders(&refMap, &typeMap),
-        new P4::FlattenInterfaceStructs(&refMap, &typeMap),
+        new P4::FlattenHeadersAndInterfaceStructs(&refMap, &typeMap),
         new P4::ReplaceSelectRange(&refMap, &typeMap),
         new P4::Predication(&refMap),
         new P4::MoveDeclarations(),  // more may have been introduced
@@ -114,7 +116,8 @@ MidEnd::MidEnd(CompilerOptions& options, std::ostream* outStream) {
         new P4::SimplifyControlFlow(&refMap, &typeMap),
         new P4::CompileTimeOperations(),
         new P4::TableHit(&refMap, &typeMap),
-        new P4::EliminateSwitch(&refMap, &typeMap),
+        new PassIfFeature(FeatureCensus::Switches,
+                          {new P4::EliminateSwitch(&refMap, &typeMap)}),
         evaluator,
         [v1controls, evaluator](const IR::Node *root) -> const IR::Node * {
             auto toplevel = evaluator->getToplevelBlock();
@@ -123,13 +126,13 @@ MidEnd::MidEnd(CompilerOptions& options, std::ostream* outStream) {
                 // nothing further to do
                 return nullptr;
             // Special handling when compiling for v1model.p4
-            if (main->type->name == P4V1::V1Model::instance.sw.name) {
+            if (main->type->name == P4V1::V1Model::instance().sw.name) {
                 if (main->getConstructorParameters()->size() != 6)
                     return root;
-                auto verify = main->getParameterValue(P4V1::V1Model::instance.sw.verify.name);
+                auto verify = main->getParameterValue(P4V1::V1Model::instance().sw.verify.name);
                 auto update = main->getParameterValue(
-                    P4V1::V1Model::instance.sw.compute.name);
-                auto deparser = main->getParameterValue(P4V1::V1Model::instance.sw.deparser.name);
+                    P4V1::V1Model::instance().sw.compute.name);
+                auto deparser = main->getParameterValue(P4V1::V1Model::instance().sw.deparser.name);
                 if (verify == nullptr || update == nullptr || deparser == nullptr ||
                     !verify->is<IR::ControlBlock>() || !update->is<IR::ControlBlock>() ||
                     !deparser->is<IR::ControlBlock>()) {
@@ -140,8 +143,7 @@ MidEnd::MidEnd(CompilerOptions& options, std::ostream* outStream) {
                 v1controls->emplace(deparser->to<IR::ControlBlock>()->container->name);
             }
             return root; },
-        new P4::SynthesizeActions(&refMap, &typeMap, new SkipControls(v1controls)),
-        new P4::MoveActionsToTables(&refMap, &typeMap),
+        new P4::SynthesizeActionsAndMoveToTables(&refMap, &typeMap, new SkipControls(v1controls)),
         evaluator,
         [this, evaluator]() { toplevel = evaluator->getToplevelBlock(); },
         new P4::MidEndLast()
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "backends/p4test/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
+#include "ir/binary_io.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
 #include "lib/log.h"
@@ -28,7 +29,11 @@ limitations under the License.
 #include "lib/crash.h"
 #include "lib/nullstream.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileBatch.h"
+#include "frontends/common/compileServer.h"
 #include "frontends/common/parseInput.h"
+#include "frontends/common/watch.h"
+#include "frontends/p4/analysisSnapshot.h"
 #include "frontends/p4/evaluator/evaluator.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/p4/toP4/toP4.h"
@@ -39,6 +44,8 @@ class P4TestOptions : public CompilerOptions {
     bool parseOnly = false;
     bool validateOnly = false;
     bool loadIRFromJson = false;
+    bool loadIRFromBin = false;
+    cstring dumpBinIRFile = nullptr;
     P4TestOptions() {
         registerOption("--listMidendPasses", nullptr,
                 [this](const char*) {
@@ -66,6 +73,19 @@ class P4TestOptions : public CompilerOptions {
                            return true;
                        },
                        "read previously dumped json instead of P4 source code");
+        registerOption("--fromBinIR", "file",
+                       [this](const char* arg) {
+                           loadIRFromBin = true;
+                           file = arg;
+                           return true;
+                       },
+                       "like --fromJSON, but reads the compact binary IR format");
+        registerOption("--toBinIR", "file",
+                       [this](const char* arg) {
+                           dumpBinIRFile = arg;
+                           return true;
+                       },
+                       "dump the IR to file in the compact binary format");
      }
 };
 
@@ -83,33 +103,42 @@ static void log_dump(const IR::Node *node, const char *head) {
             std::cout << *node << std::endl; }
 }
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-    setup_signals();
-
+static int compile(int argc, char *const argv[]) {
     AutoCompileContext autoP4TestContext(new P4TestContext);
     auto& options = P4TestContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
     options.compilerVersion = P4TEST_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-            if (options.loadIRFromJson == false)
+            if (options.loadIRFromJson == false && options.loadIRFromBin == false)
                     options.setInputFile();
     }
     if (::errorCount() > 0)
         return 1;
     const IR::P4Program *program = nullptr;
     auto hook = options.getDebugHook();
-    if (options.loadIRFromJson) {
-        std::ifstream json(options.file);
-        if (json) {
-            JSONLoader loader(json);
+    // Filled from the analysis snapshot when --fromBinIR reads a dump that
+    // carries one; checkMap tells us whether that actually happened.
+    P4::TypeMap loadedTypeMap;
+    P4::ReferenceMap loadedRefMap;
+    if (options.loadIRFromBin) {
+        std::ifstream bin(options.file, std::ios::binary);
+        if (bin) {
+            auto node = P4::loadBinaryIRWithAnalyses(bin, &loadedTypeMap, &loadedRefMap);
+            if (node == nullptr || (program = node->to<IR::P4Program>()) == nullptr)
+                error(ErrorType::ERR_INVALID, "%s is not a P4Program in binary IR format",
+                      options.file);
+        } else {
+            error(ErrorType::ERR_IO, "Can't open %s", options.file); }
+    } else if (options.loadIRFromJson) {
+        std::istream* json = openInputFile(options.file);
+        if (json != nullptr) {
+            JSONLoader loader(*json);
             const IR::Node* node = nullptr;
             loader >> node;
             if (!(program = node->to<IR::P4Program>()))
                 error(ErrorType::ERR_INVALID, "%s is not a P4Program in json format", options.file);
-        } else {
-            error(ErrorType::ERR_IO, "Can't open %s", options.file); }
+        }
     } else {
         program = P4::parseP4File(options);
 
@@ -134,9 +163,15 @@ int main(int argc, char *const argv[]) {
     if (program != nullptr && ::errorCount() == 0) {
         P4::serializeP4RuntimeIfRequired(program, options);
 
+        P4Test::MidEnd midEnd(options);
+        midEnd.addDebugHook(hook);
+        if (loadedTypeMap.checkMap(program)) {
+            // Seed the midend with the loaded analyses; passes that check
+            // map freshness will then skip recomputing them.
+            midEnd.typeMap = loadedTypeMap;
+            midEnd.refMap = loadedRefMap;
+        }
         if (!options.parseOnly && !options.validateOnly) {
-            P4Test::MidEnd midEnd(options);
-            midEnd.addDebugHook(hook);
 #if 0
             /* doing this breaks the output until we get dump/undump of srcInfo */
             if (options.debugJson) {
@@ -157,8 +192,19 @@ int main(int argc, char *const argv[]) {
             log_dump(program, "After midend");
             log_dump(top, "Top level block");
         }
-        if (options.dumpJsonFile)
-            JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+        if (options.dumpJsonFile) {
+            auto dump = openFile(options.dumpJsonFile, true);
+            JSONGenerator(*dump, true) << program << std::endl;
+            closeFile(dump);
+        }
+        if (options.dumpBinIRFile) {
+            auto dump = openFile(options.dumpBinIRFile, true);
+            if (midEnd.typeMap.checkMap(program) && midEnd.refMap.checkMap(program))
+                P4::saveBinaryIRWithAnalyses(program, *dump, &midEnd.typeMap, &midEnd.refMap);
+            else
+                saveBinaryIR(program, *dump);
+            closeFile(dump);
+        }
         if (options.debugJson) {
             std::stringstream ss1, ss2;
             JSONGenerator gen1(ss1), gen2(ss2);
@@ -183,5 +229,26 @@ int main(int argc, char *const argv[]) {
 
     if (Log::verbose())
         std::cerr << "Done." << std::endl;
+    // prints warnings recorded under --Wdefer; a no-op otherwise
+    P4CContext::get().errorReporter().flushDeferredWarnings();
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+    setup_signals();
+
+    // Daemon, batch and watch modes are handled before option processing:
+    // the driver process itself never compiles anything, each job parses
+    // its own options.
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--watch"))
+            return P4::Watch::run(argc, argv, compile);
+        if (i + 1 < argc && !strcmp(argv[i], "--compile-server"))
+            return P4::CompileServer::run(argv[i + 1], compile, P4::warmStandardLibrary);
+        if (i + 1 < argc && !strcmp(argv[i], "--batch"))
+            return P4::CompileBatch::run(argv[i + 1], argc, argv, compile);
+    }
+
+    return compile(argc, argv);
+}
@@ -49,7 +49,7 @@ limitations under the License.
 
 namespace UBPF {
 
-class EnumOn32Bits : public P4::ChooseEnumRepresentation {
+class ByteAlignedEnums : public P4::ChooseEnumRepresentation {
     bool convert(const IR::Type_Enum* type) const override {
         if (type->srcInfo.isValid()) {
             auto sourceFile = type->srcInfo.getSourceFile();
@@ -59,8 +59,14 @@ class EnumOn32Bits : public P4::ChooseEnumRepresentation {
         }
         return true;
     }
-    unsigned enumSize(unsigned) const override
-    { return 32; }
+    unsigned enumSize(unsigned enumCount) const override {
+        // Use the narrowest byte-aligned representation that can hold
+        // all members: narrower enums make narrower table keys.
+        unsigned width = 8;
+        while (enumCount > (1ULL << width))
+            width += 8;
+        return width;
+    }
 };
 
 const IR::ToplevelBlock*
@@ -75,7 +81,7 @@ MidEnd::run(EbpfOptions& options, const IR::P4Program* program, std::ostream* ou
     PassManager midEnd;
     if (options.loadIRFromJson == false) {
         midEnd.addPasses({
-                new P4::ConvertEnums(&refMap, &typeMap, new EnumOn32Bits()),
+                new P4::ConvertEnums(&refMap, &typeMap, new ByteAlignedEnums()),
                 new P4::RemoveMiss(&refMap, &typeMap),
                 new P4::ClearTypeMap(&typeMap),
                 new P4::EliminateNewtype(&refMap, &typeMap),
@@ -90,8 +96,9 @@ MidEnd::run(EbpfOptions& options, const IR::P4Program* program, std::ostream* ou
                 new P4::SimplifySelectCases(&refMap, &typeMap, false),
                 new P4::HandleNoMatch(&refMap),
                 new P4::SimplifyParsers(&refMap),
-                new P4::StrengthReduction(&refMap, &typeMap),
-                new P4::SimplifyComparisons(&refMap, &typeMap),
+                new P4::StrengthReduction(&refMap, &typeMap, nullptr,
+                                          /* enableMachineArith */ true),
+                new P4::SimplifyComparisons(&refMap, &typeMap, true),
                 new P4::LocalCopyPropagation(&refMap, &typeMap),
                 new P4::SimplifySelectList(&refMap, &typeMap),
                 new P4::MoveDeclarations(),  // more may have been introduced
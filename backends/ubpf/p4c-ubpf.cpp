@@ -49,7 +49,7 @@ void compile(EbpfOptions& options) {
         return;
 
     P4::FrontEnd frontend;
-    program = UBPF::UBPFModel::instance.run(program);
+    program = UBPF::UBPFModel::instance().run(program);
     frontend.addDebugHook(hook);
     program = frontend.run(options, program);
     if (::errorCount() > 0)
@@ -78,8 +78,8 @@ namespace UBPF {
         prog->emitH(&h, hfile);
         prog->emitC(&c, UBPF::extract_file_name(hfile.c_str()));
 
-        *cstream << c.toString();
-        *hstream << h.toString();
+        c.writeTo(*cstream);
+        h.writeTo(*hstream);
         cstream->flush();
         hstream->flush();
     }
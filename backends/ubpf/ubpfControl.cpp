@@ -28,7 +28,7 @@ namespace UBPF {
     UBPFControlBodyTranslator::UBPFControlBodyTranslator(
             const UBPFControl *control) :
             EBPF::ControlBodyTranslator(control), control(control),
-            p4lib(P4::P4CoreLibrary::instance) {
+            p4lib(P4::P4CoreLibrary::instance()) {
         setName("UBPFControlBodyTranslator");
     }
 
@@ -161,12 +161,12 @@ namespace UBPF {
                 return;
             }
         } else if (declType->name.name ==
-                   UBPFModel::instance.registerModel.name) {
+                   UBPFModel::instance().registerModel.name) {
             cstring name = decl->getName().name;
             auto pRegister = control->getRegister(name);
 
             if (method->method->name.name ==
-                UBPFModel::instance.registerModel.write.name) {
+                UBPFModel::instance().registerModel.write.name) {
                 pRegister->emitKeyInstance(builder, method->expr);
             }
 
@@ -216,11 +216,38 @@ namespace UBPF {
         if (table->keyGenerator != nullptr) {
             builder->emitIndent();
             builder->appendLine("/* perform lookup */");
-            builder->emitIndent();
-            builder->appendFormat("%s = ", valueName.c_str());
-            builder->target->emitTableLookup(builder, table->dataMapName,
-                                             keyname, valueName);
-            builder->endOfStatement(true);
+            if (table->constEntriesInline) {
+                table->emitConstEntriesLookup(builder, keyname, valueName);
+            } else if (table->cacheEnabled) {
+                builder->emitIndent();
+                builder->appendFormat("%s = ", valueName.c_str());
+                builder->target->emitTableLookup(builder, table->cacheMapName,
+                                                 keyname, valueName);
+                builder->endOfStatement(true);
+                builder->emitIndent();
+                builder->appendFormat("if (%s == NULL) ", valueName.c_str());
+                builder->blockStart();
+                builder->emitIndent();
+                builder->appendFormat("%s = ", valueName.c_str());
+                builder->target->emitTableLookup(builder, table->dataMapName,
+                                                 keyname, valueName);
+                builder->endOfStatement(true);
+                builder->emitIndent();
+                builder->appendFormat("if (%s != NULL) ", valueName.c_str());
+                builder->blockStart();
+                builder->emitIndent();
+                builder->target->emitTableUpdate(builder, table->cacheMapName,
+                                                 keyname, valueName);
+                builder->endOfStatement(true);
+                builder->blockEnd(true);
+                builder->blockEnd(true);
+            } else {
+                builder->emitIndent();
+                builder->appendFormat("%s = ", valueName.c_str());
+                builder->target->emitTableLookup(builder, table->dataMapName,
+                                                 keyname, valueName);
+                builder->endOfStatement(true);
+            }
         }
 
         builder->newline();
@@ -351,7 +378,7 @@ namespace UBPF {
             auto method = a->right->to<IR::MethodCallExpression>();
             if (method->method->is<IR::Member>()) {
                 auto methodName = method->method->to<IR::Member>()->member.name;
-                if (methodName == UBPFModel::instance.registerModel.read.name) {
+                if (methodName == UBPFModel::instance().registerModel.read.name) {
                     return emitRegisterRead(a, method);
                 }
             }
@@ -587,7 +614,7 @@ namespace UBPF {
                     auto di = node->to<IR::Declaration_Instance>();
                     auto type = di->type->to<IR::Type_Specialized>();
                     auto externTypeName = type->baseType->path->name.name;
-                    if (externTypeName == UBPFModel::instance.registerModel.name) {
+                    if (externTypeName == UBPFModel::instance().registerModel.name) {
                         cstring name = di->name.name;
                         auto ctr = new UBPFRegister(program, ctrblk, name, codeGen);
                         registers.emplace(name, ctr);
@@ -658,7 +685,7 @@ namespace UBPF {
         hitVariable = program->refMap->newName("hit");
         passVariable = program->refMap->newName("pass");
         auto pl = controlBlock->container->type->applyParams;
-        size_t numberOfArgs = UBPFModel::instance.numberOfControlBlockArguments();
+        size_t numberOfArgs = UBPFModel::instance().numberOfControlBlockArguments();
         if (pl->size() != numberOfArgs) {
             ::error(ErrorType::ERR_EXPECTED,
                     "Expected control block to have exactly %d parameter", numberOfArgs);
@@ -19,6 +19,10 @@ limitations under the License.
 namespace UBPF {
 
     cstring UBPFModel::reservedPrefix = "ubpf_";
-    UBPFModel UBPFModel::instance;
+
+    UBPFModel& UBPFModel::instance() {
+        static UBPFModel model;
+        return model;
+    }
 
 }
@@ -63,7 +63,7 @@ namespace UBPF {
     protected:
         UBPFModel() : Model("0.1"),
                       CPacketName("pkt"),
-                      packet("packet", P4::P4CoreLibrary::instance.packetIn, 0),
+                      packet("packet", P4::P4CoreLibrary::instance().packetIn, 0),
                       pipeline(),
                       registerModel(),
                       drop("mark_to_drop"),
@@ -76,7 +76,7 @@ namespace UBPF {
                       hash() {}
 
     public:
-        static UBPFModel instance;
+        static UBPFModel& instance();
         static cstring reservedPrefix;
 
         ::Model::Elem CPacketName;
@@ -102,7 +102,7 @@ namespace UBPF {
             bool preorder(const IR::Declaration_Constant *dc) override {
                 if (dc->name == "__ubpf_model_version") {
                     auto val = dc->initializer->to<IR::Constant>();
-                    UBPFModel::instance.version = static_cast<unsigned>(val->value); }
+                    UBPFModel::instance().version = static_cast<unsigned>(val->value); }
                 return false; }
             bool preorder(const IR::Declaration *) override { return false; }
         };
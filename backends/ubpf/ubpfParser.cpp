@@ -18,6 +18,7 @@ limitations under the License.
 #include "ubpfType.h"
 #include "ubpfHelpers.h"
 #include "ubpfModel.h"
+#include "backends/ebpf/ebpfParser.h"
 #include "frontends/p4/coreLibrary.h"
 #include "frontends/p4/methodInstance.h"
 
@@ -29,6 +30,8 @@ class UBPFStateTranslationVisitor : public EBPF::CodeGenInspector {
     bool hasDefault;
     P4::P4CoreLibrary& p4lib;
     const UBPFParserState* state;
+    EBPF::ExtractSpans spans;
+    const IR::MethodCallStatement* currentStatement = nullptr;
 
     void emitCheckPacketLength(const IR::Expression* expr, const char * varname, unsigned width);
     void emitCheckPacketLength(const IR::Expression* expr)
@@ -40,7 +43,7 @@ class UBPFStateTranslationVisitor : public EBPF::CodeGenInspector {
 
     void compileExtractField(const IR::Expression* expr, cstring field,
                              unsigned alignment, EBPF::EBPFType* type, bool advanceCursor = true);
-    void compileExtract(const IR::Expression* destination);
+    void compileExtract(const IR::Expression* destination, int spanBits = -1);
 
     void compileLookahead(const IR::Expression* destination);
 
@@ -49,14 +52,18 @@ class UBPFStateTranslationVisitor : public EBPF::CodeGenInspector {
  public:
     explicit UBPFStateTranslationVisitor(const UBPFParserState* state) :
             CodeGenInspector(state->parser->program->refMap, state->parser->program->typeMap),
-            hasDefault(false), p4lib(P4::P4CoreLibrary::instance), state(state) {}
+            hasDefault(false), p4lib(P4::P4CoreLibrary::instance()), state(state) {}
     bool preorder(const IR::ParserState* state) override;
     bool preorder(const IR::SelectCase* selectCase) override;
     bool preorder(const IR::SelectExpression* expression) override;
     bool preorder(const IR::Member* expression) override;
     bool preorder(const IR::MethodCallExpression* expression) override;
-    bool preorder(const IR::MethodCallStatement* stat) override
-    { visit(stat->methodCall); return false; }
+    bool preorder(const IR::MethodCallStatement* stat) override {
+        currentStatement = stat;
+        visit(stat->methodCall);
+        currentStatement = nullptr;
+        return false;
+    }
     bool preorder(const IR::AssignmentStatement* stat) override;
 };
 }  // namespace
@@ -102,6 +109,8 @@ bool UBPFStateTranslationVisitor::preorder(const IR::ParserState* parserState) {
     builder->spc();
     builder->blockStart();
 
+    spans.compute(parserState->components, state->parser->program->refMap,
+                  state->parser->program->typeMap, state->parser->packet);
     visit(parserState->components, "components");
     if (parserState->selectExpression == nullptr) {
         builder->emitIndent();
@@ -282,7 +291,7 @@ UBPFStateTranslationVisitor::compileExtractField(
 }
 
 void
-UBPFStateTranslationVisitor::compileExtract(const IR::Expression* destination) {
+UBPFStateTranslationVisitor::compileExtract(const IR::Expression* destination, int spanBits) {
     auto type = state->parser->typeMap->getType(destination);
     auto ht = type->to<IR::Type_StructLike>();
 
@@ -293,7 +302,12 @@ UBPFStateTranslationVisitor::compileExtract(const IR::Expression* destination) {
     }
 
     unsigned width = ht->width_bits();
-    emitCheckPacketLength(width);
+    if (spanBits != 0) {
+        // A positive spanBits means this extract leads a span of
+        // consecutive extracts and one check covers them all; zero means
+        // the span leader already checked for this header's bytes.
+        emitCheckPacketLength(spanBits > 0 ? static_cast<unsigned>(spanBits) : width);
+    }
 
     unsigned alignment = 0;
     for (auto f : ht->fields) {
@@ -397,7 +411,9 @@ bool UBPFStateTranslationVisitor::preorder(const IR::MethodCallExpression* expre
                             "Variable-sized header fields not yet supported %1%", expression);
                     return false;
                 }
-                compileExtract(expression->arguments->at(0)->expression);
+                int spanBits = currentStatement == nullptr ? -1
+                             : spans.checkWidth(currentStatement);
+                compileExtract(expression->arguments->at(0)->expression, spanBits);
                 return false;
             }
 
@@ -472,7 +488,7 @@ void UBPFParser::emit(EBPF::CodeBuilder *builder) {
 
 bool UBPFParser::build() {
     auto pl = parserBlock->container->type->applyParams;
-    size_t numberOfArgs = UBPFModel::instance.numberOfParserArguments();
+    size_t numberOfArgs = UBPFModel::instance().numberOfParserArguments();
     if (pl->size() != numberOfArgs) {
         ::error(ErrorType::ERR_EXPECTED,
                 "Expected parser to have exactly %d parameters", numberOfArgs);
@@ -178,6 +178,9 @@ UBPFTable::UBPFTable(const UBPFProgram *program,
     base = instanceName + "_NoAction";
     noActionName = program->refMap->newName(base);
 
+    base = instanceName + "_cache";
+    cacheMapName = program->refMap->newName(base);
+
     keyGenerator = table->container->getKey();
     actionList = table->container->getActionList();
 
@@ -186,10 +189,53 @@ UBPFTable::UBPFTable(const UBPFProgram *program,
 
     setTableSize(table);
     setTableKind();
+
+    // A table whose entries are all given as const entries over scalar
+    // exact-match keys never changes at runtime, so it can be matched with
+    // a branch chain in the generated code; see emitConstEntriesLookup.
+    if (keyGenerator != nullptr && table->container->getEntries() != nullptr) {
+        constEntriesInline = true;
+        for (auto c : keyGenerator->keyElements) {
+            auto mtdecl = program->refMap->getDeclaration(c->matchType->path, true);
+            auto matchType = mtdecl->getNode()->to<IR::Declaration_ID>();
+            if (matchType->name.name != P4::P4CoreLibrary::instance().exactMatch.name) {
+                constEntriesInline = false;
+                break;
+            }
+            auto type = program->typeMap->getType(c->expression);
+            auto ebpfType = UBPFTypeFactory::instance->create(type);
+            auto scalar = ebpfType == nullptr ?
+                          nullptr : ebpfType->to<EBPF::EBPFScalarType>();
+            if (scalar == nullptr ||
+                !EBPF::EBPFScalarType::generatesScalar(
+                    scalar->implementationWidthInBits())) {
+                constEntriesInline = false;
+                break;
+            }
+        }
+    }
 }
 
 void UBPFTable::emitInstance(EBPF::CodeBuilder *builder) {
-    UBPFTableBase::emitInstance(builder, tableKind);
+    // When the const entries are compiled into the lookup code by
+    // emitConstEntriesLookup no data map is needed; only the default
+    // action map below remains.
+    if (!constEntriesInline) {
+        UBPFTableBase::emitInstance(builder, tableKind);
+
+        if (tableKind == EBPF::TableLPMTrie && program->options.enableTableCache) {
+            // An exact-match cache in front of the trie: packets of a flow
+            // already seen hit one hash lookup on the full key instead of
+            // an LPM walk.  The uBPF VM has no LRU map type, so the cache
+            // is a plain bounded hash map: once full it stops absorbing
+            // new flows.  Entries are never invalidated by control-plane
+            // table updates.
+            cacheEnabled = true;
+            builder->target->emitTableDecl(builder, cacheMapName, EBPF::TableHash,
+                                           cstring("struct ") + keyTypeName,
+                                           cstring("struct ") + valueTypeName, size);
+        }
+    }
     builder->target->emitTableDecl(builder, defaultActionMapName, EBPF::TableArray,
                                    program->arrayIndexType,
                                    cstring("struct ") + valueTypeName, 1);
@@ -206,7 +252,7 @@ void UBPFTable::setTableKind() {
     for (auto it : keyGenerator->keyElements) {
         auto mtdecl = program->refMap->getDeclaration(it->matchType->path, true);
         auto matchType = mtdecl->getNode()->to<IR::Declaration_ID>();
-        if (matchType->name.name == P4::P4CoreLibrary::instance.lpmMatch.name) {
+        if (matchType->name.name == P4::P4CoreLibrary::instance().lpmMatch.name) {
             if (tableKind == EBPF::TableLPMTrie) {
                 ::error(ErrorType::ERR_UNSUPPORTED,
                         "only one LPM field allowed", it->matchType);
@@ -289,8 +335,8 @@ void UBPFTable::emitKeyType(EBPF::CodeBuilder *builder) {
             auto mtdecl = program->refMap->getDeclaration(
                     c->matchType->path, true);
             auto matchType = mtdecl->getNode()->to<IR::Declaration_ID>();
-            if (matchType->name.name != P4::P4CoreLibrary::instance.exactMatch.name &&
-                matchType->name.name != P4::P4CoreLibrary::instance.lpmMatch.name)
+            if (matchType->name.name != P4::P4CoreLibrary::instance().exactMatch.name &&
+                matchType->name.name != P4::P4CoreLibrary::instance().lpmMatch.name)
                 ::error(ErrorType::ERR_UNSUPPORTED_ON_TARGET,
                         "Match of type %1% not supported", c->matchType);
             key_idx++;
@@ -322,7 +368,7 @@ void UBPFTable::emitActionArguments(EBPF::CodeBuilder *builder,
 }
 
 cstring UBPFTable::generateActionName(const IR::P4Action *action) {
-    if (action->getName().originalName == P4::P4CoreLibrary::instance.noAction.name) {
+    if (action->getName().originalName == P4::P4CoreLibrary::instance().noAction.name) {
         return this->noActionName;
     } else {
         return EBPF::EBPFObject::externalName(action);
@@ -415,6 +461,84 @@ void UBPFTable::emitKey(EBPF::CodeBuilder *builder, cstring keyName) {
     }
 }
 
+// Emits a branch chain matching the table's const entries against the key
+// that emitKey just built, in entry order.  The matching entry's action and
+// arguments are written to a stack-allocated value, so the code after the
+// lookup (miss handling, emitAction) is the same as for a map-backed table.
+void UBPFTable::emitConstEntriesLookup(EBPF::CodeBuilder *builder, cstring keyName,
+                                       cstring valueName) {
+    auto entries = table->container->getEntries();
+    CHECK_NULL(entries);
+    cstring entryVariable = valueName + "_entry";
+
+    builder->emitIndent();
+    builder->appendFormat("struct %s %s = {}", valueTypeName.c_str(),
+                          entryVariable.c_str());
+    builder->endOfStatement(true);
+
+    EBPF::CodeGenInspector cg(program->refMap, program->typeMap);
+    cg.setBuilder(builder);
+
+    bool firstEntry = true;
+    for (auto e : entries->entries) {
+        auto keyList = e->getKeys();
+        BUG_CHECK(keyList->components.size() == keyGenerator->keyElements.size(),
+                  "%1%: entry key size does not match the table key", e);
+
+        if (firstEntry)
+            builder->emitIndent();
+        else
+            builder->append(" else ");
+        firstEntry = false;
+        builder->append("if (");
+        bool firstCondition = true;
+        size_t index = 0;
+        for (auto c : keyGenerator->keyElements) {
+            auto keyValue = keyList->components.at(index++);
+            if (keyValue->is<IR::DefaultExpression>())
+                // A '_' key matches any value.
+                continue;
+            if (!firstCondition)
+                builder->append(" && ");
+            firstCondition = false;
+            cstring fieldName = ::get(keyFieldNames, c);
+            builder->appendFormat("%s.%s == ", keyName.c_str(), fieldName.c_str());
+            keyValue->apply(cg);
+        }
+        if (firstCondition)
+            // All key components were '_'.
+            builder->append("1");
+        builder->append(") ");
+        builder->blockStart();
+
+        auto entryAction = e->getAction();
+        BUG_CHECK(entryAction->is<IR::MethodCallExpression>(),
+                  "%1%: expected an action call", entryAction);
+        auto mce = entryAction->to<IR::MethodCallExpression>();
+        auto mi = P4::MethodInstance::resolve(mce, program->refMap, program->typeMap);
+        auto ac = mi->to<P4::ActionCall>();
+        BUG_CHECK(ac != nullptr, "%1%: expected an action call", mce);
+        cstring name = generateActionName(ac->action);
+
+        builder->emitIndent();
+        builder->appendFormat("%s.action = %s", entryVariable.c_str(), name.c_str());
+        builder->endOfStatement(true);
+        for (auto p : *mi->substitution.getParametersInArgumentOrder()) {
+            auto arg = mi->substitution.lookup(p);
+            builder->emitIndent();
+            builder->appendFormat("%s.u.%s.%s = ", entryVariable.c_str(),
+                                  name.c_str(), p->name.name.c_str());
+            arg->apply(cg);
+            builder->endOfStatement(true);
+        }
+        builder->emitIndent();
+        builder->appendFormat("%s = &%s", valueName.c_str(), entryVariable.c_str());
+        builder->endOfStatement(true);
+        builder->blockEnd(false);
+    }
+    builder->newline();
+}
+
 void UBPFTable::emitAction(EBPF::CodeBuilder *builder, cstring valueName) {
     builder->emitIndent();
     builder->appendFormat("switch (%s->action) ", valueName.c_str());
@@ -507,9 +631,11 @@ void UBPFTable::emitInitializer(EBPF::CodeBuilder *builder) {
     builder->blockEnd(true);
 
 
-    // Check if there are const entries.
+    // Check if there are const entries.  Entries over scalar exact-match
+    // keys are compiled into the lookup code by emitConstEntriesLookup and
+    // need no load-time configuration.
     auto entries = t->getEntries();
-    if (entries != nullptr) {
+    if (entries != nullptr && !constEntriesInline) {
         ::error(ErrorType::ERR_UNSUPPORTED_ON_TARGET,
                 "%1%: Immutable table entries cannot be configured by the uBPF target "
                 "and should not be used.",
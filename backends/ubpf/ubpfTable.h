@@ -64,6 +64,15 @@ namespace UBPF {
         cstring defaultActionMapName;
         cstring actionEnumName;
         cstring noActionName;
+        // Set when --table-caching emits an exact-match cache map in front
+        // of this table; the apply code then checks the cache before the
+        // real lookup.
+        cstring cacheMapName;
+        bool cacheEnabled = false;
+        // True when the table has const entries over scalar exact-match keys
+        // only.  The entries are immutable, so they are compiled into a
+        // branch chain in the apply code and no data map is emitted.
+        bool constEntriesInline = false;
         std::map<const IR::KeyElement *, cstring> keyFieldNames;
         std::map<const IR::KeyElement *, EBPF::EBPFType *> keyTypes;
 
@@ -78,6 +87,8 @@ namespace UBPF {
         void emitKeyType(EBPF::CodeBuilder *builder);
         void emitValueType(EBPF::CodeBuilder *builder);
         void emitKey(EBPF::CodeBuilder *builder, cstring keyName);
+        void emitConstEntriesLookup(EBPF::CodeBuilder *builder, cstring keyName,
+                                    cstring valueName);
         void emitAction(EBPF::CodeBuilder *builder, cstring valueName);
         void emitInitializer(EBPF::CodeBuilder *builder);
     };
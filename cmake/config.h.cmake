@@ -7,6 +7,9 @@
 /* Define to 1 if you have the execinfo.h header */
 #cmakedefine HAVE_EXECINFO_H 1
 
+/* Define to 1 if you have the sys/sdt.h header (USDT tracepoints) */
+#cmakedefine HAVE_SYS_SDT_H 1
+
 /* Define to 1 if you have the LIBGC library. */
 #cmakedefine HAVE_LIBGC 1
 
@@ -22,6 +25,12 @@
 /* Define to 1 if you have the GC_print_stats function. */
 #cmakedefine HAVE_GC_PRINT_STATS 1
 
+/* Define to 1 if you have the GC_set_on_collection_event function. */
+#cmakedefine HAVE_GC_COLLECTION_EVENT 1
+
+/* Define to 1 if you have the GC_set_markers_count function. */
+#cmakedefine HAVE_GC_SET_MARKERS_COUNT 1
+
 /* Define if you have simple switch installed */
 #cmakedefine HAVE_SIMPLE_SWITCH 1
 
@@ -32,7 +32,7 @@ boost::optional<std::string> stringReprConstant(big_int value, int width) {
         return boost::none;
     }
     BUG_CHECK(width > 0, "Unexpected width 0");
-    size_t bitsRequired = floor_log2(value) + 1;
+    size_t bitsRequired = value == 0 ? 0 : boost::multiprecision::msb(value) + 1;
     BUG_CHECK(static_cast<size_t>(width) >= bitsRequired,
               "Cannot represent %1% on %2% bits", value, width);
     // TODO(antonin): P4Runtime defines the canonical representation for bit<W>
@@ -42,13 +42,23 @@ boost::optional<std::string> stringReprConstant(big_int value, int width) {
     // representation, so instead we use a padded binary string, which according
     // to the P4Runtime specification is also valid (but not the canonical
     // representation, which means no RW symmetry).
-    // auto bytes = ROUNDUP(mpz_sizeinbase(value.get_mpz_t(), 2), 8);
-    auto bytes = ROUNDUP(width, 8);
-    std::vector<char> data(bytes);
-    for (auto &d : data) {
-        big_int v = (value >> (--bytes * 8)) & 0xff;
-        d = static_cast<uint8_t>(v); }
-    return std::string(data.begin(), data.end());
+    size_t bytes = ROUNDUP(width, 8);
+    // Export the value's limbs directly into the tail of the zero-padded
+    // buffer instead of extracting it one byte at a time with bignum shifts;
+    // this runs for every component of every static table entry.
+    std::string data(bytes, '\0');
+    if (value != 0) {
+        size_t valueBytes = ROUNDUP(bitsRequired, 8);
+#if HAVE_LIBGMP
+        mpz_export(&data[bytes - valueBytes], nullptr, 1 /* msb first */,
+                   1 /* one-byte words */, 0 /* native endian */, 0 /* no nails */,
+                   value.backend().data());
+#else
+        boost::multiprecision::export_bits(
+            value, data.begin() + (bytes - valueBytes), 8);
+#endif
+    }
+    return data;
 }
 
 /// Convert a Constant to the P4Runtime bytes representation by calling
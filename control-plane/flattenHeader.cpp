@@ -70,11 +70,23 @@ const IR::Annotations* FlattenHeader::mergeAnnotations() const {
 /* static */
 const IR::Type_Header* FlattenHeader::flatten(
     const P4::TypeMap* typeMap, const IR::Type_Header* headerType) {
+    // Every table, digest or register referencing a header flattens it
+    // again; the result only depends on the type, so flatten each
+    // distinct header once and reuse the clone (or the original, when no
+    // flattening was needed) on later references.
+    using CacheKey = std::pair<const P4::TypeMap*, const IR::Type_Header*>;
+    static std::map<CacheKey, const IR::Type_Header*> cache;
+    auto inserted = cache.emplace(CacheKey(typeMap, headerType), nullptr);
+    if (!inserted.second)
+        return inserted.first->second;
     auto flattenedHeader = headerType->clone();
     flattenedHeader->fields.clear();
     FlattenHeader flattener(typeMap, flattenedHeader);
     flattener.doFlatten(headerType);
-    return flattener.needsFlattening ? flattenedHeader : headerType;
+    auto result = flattener.needsFlattening ?
+                  static_cast<const IR::Type_Header*>(flattenedHeader) : headerType;
+    inserted.first->second = result;
+    return result;
 }
 
 }  // namespace ControlPlaneAPI
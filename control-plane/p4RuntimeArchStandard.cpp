@@ -58,10 +58,10 @@ template <Arch arch> struct ActionProfileTraits;
 template<> struct ActionProfileTraits<Arch::V1MODEL> {
     static const cstring name() { return "action profile"; }
     static const cstring propertyName() {
-        return P4V1::V1Model::instance.tableAttributes.tableImplementation.name;
+        return P4V1::V1Model::instance().tableAttributes.tableImplementation.name;
     }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.action_profile.name;
+        return P4V1::V1Model::instance().action_profile.name;
     }
     static const cstring sizeParamName() { return "size"; }
 };
@@ -84,7 +84,7 @@ template <Arch arch> struct ActionSelectorTraits;
 template<> struct ActionSelectorTraits<Arch::V1MODEL> : public ActionProfileTraits<Arch::V1MODEL> {
     static const cstring name() { return "action selector"; }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.action_selector.name;
+        return P4V1::V1Model::instance().action_selector.name;
     }
 };
 
@@ -101,14 +101,14 @@ template <Arch arch> struct RegisterTraits;
 template<> struct RegisterTraits<Arch::V1MODEL> {
     static const cstring name() { return "register"; }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.registers.name;
+        return P4V1::V1Model::instance().registers.name;
     }
     static const cstring sizeParamName() { return "size"; }
     // the index of the type parameter for the data stored in the register, in
     // the type parameter list of the extern type declaration
     static size_t dataTypeParamIdx() { return 0; }
     static boost::optional<size_t> indexTypeParamIdx() {
-        if (P4V1::V1Model::instance.haveIndexTypeParam()) return 1;
+        if (P4V1::V1Model::instance().haveIndexTypeParam()) return 1;
         return boost::none; }
 };
 
@@ -149,13 +149,13 @@ namespace Helpers {
 template<> struct CounterlikeTraits<Standard::CounterExtern<Standard::Arch::V1MODEL> > {
     static const cstring name() { return "counter"; }
     static const cstring directPropertyName() {
-        return P4V1::V1Model::instance.tableAttributes.counters.name;
+        return P4V1::V1Model::instance().tableAttributes.counters.name;
     }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.counter.name;
+        return P4V1::V1Model::instance().counter.name;
     }
     static const cstring directTypeName() {
-        return P4V1::V1Model::instance.directCounter.name;
+        return P4V1::V1Model::instance().directCounter.name;
     }
     static const cstring sizeParamName() {
         return "size";
@@ -168,7 +168,7 @@ template<> struct CounterlikeTraits<Standard::CounterExtern<Standard::Arch::V1MO
         return CounterSpec::UNSPECIFIED;
     }
     static boost::optional<size_t> indexTypeParamIdx() {
-        if (P4V1::V1Model::instance.haveIndexTypeParam()) return 0;
+        if (P4V1::V1Model::instance().haveIndexTypeParam()) return 0;
         return boost::none; }
 };
 
@@ -203,13 +203,13 @@ template<> struct CounterlikeTraits<Standard::CounterExtern<Standard::Arch::PSA>
 template<> struct CounterlikeTraits<Standard::MeterExtern<Standard::Arch::V1MODEL> > {
     static const cstring name() { return "meter"; }
     static const cstring directPropertyName() {
-        return P4V1::V1Model::instance.tableAttributes.meters.name;
+        return P4V1::V1Model::instance().tableAttributes.meters.name;
     }
     static const cstring typeName() {
-        return P4V1::V1Model::instance.meter.name;
+        return P4V1::V1Model::instance().meter.name;
     }
     static const cstring directTypeName() {
-        return P4V1::V1Model::instance.directMeter.name;
+        return P4V1::V1Model::instance().directMeter.name;
     }
     static const cstring sizeParamName() {
         return "size";
@@ -221,7 +221,7 @@ template<> struct CounterlikeTraits<Standard::MeterExtern<Standard::Arch::V1MODE
         return MeterSpec::UNSPECIFIED;
     }
     static boost::optional<size_t> indexTypeParamIdx() {
-        if (P4V1::V1Model::instance.haveIndexTypeParam()) return 0;
+        if (P4V1::V1Model::instance().haveIndexTypeParam()) return 0;
         return boost::none; }
 };
 
@@ -888,7 +888,7 @@ class P4RuntimeArchHandlerV1Model final : public P4RuntimeArchHandlerCommon<Arch
                   ReferenceMap* refMap,
                   const P4::TypeMap* typeMap,
                   p4configv1::P4TypeInfo* p4RtTypeInfo) {
-        if (function->method->name != P4V1::V1Model::instance.digest_receiver.name)
+        if (function->method->name != P4V1::V1Model::instance().digest_receiver.name)
             return boost::none;
 
         auto call = function->expr;
@@ -935,7 +935,7 @@ class P4RuntimeArchHandlerV1Model final : public P4RuntimeArchHandlerCommon<Arch
     /// @return true if @table's 'support_timeout' property exists and is true. This
     /// indicates that @table supports entry ageing.
     static bool getSupportsTimeout(const IR::P4Table* table) {
-        auto timeout = table->properties->getProperty(P4V1::V1Model::instance
+        auto timeout = table->properties->getProperty(P4V1::V1Model::instance()
                                                       .tableAttributes
                                                       .supportTimeout.name);
         if (timeout == nullptr) return false;
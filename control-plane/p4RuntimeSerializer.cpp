@@ -17,6 +17,8 @@ limitations under the License.
 #include <boost/algorithm/string.hpp>
 #include <boost/optional.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/text_format.h>
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -26,6 +28,7 @@ limitations under the License.
 #include <iostream>
 #include <iterator>
 #include <set>
+#include <sstream>
 #include <typeinfo>
 #include <unordered_map>
 #include <utility>
@@ -51,6 +54,7 @@ limitations under the License.
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
+#include "lib/async_writer.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
 #include "lib/ordered_set.h"
@@ -169,16 +173,17 @@ static bool writeJsonTo(const Message& message, std::ostream* destination) {
 static bool writeTextTo(const Message& message, std::ostream* destination) {
     CHECK_NULL(destination);
 
-    // According to the protobuf documentation, it would be better to use Print
-    // with a FileOutputStream object for performance reasons. However all we
-    // have here is a std::ostream and performance is not a concern.
-    std::string output;
-    if (!google::protobuf::TextFormat::PrintToString(message, &output)) {
-        ::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
-        return false;
+    // Stream the text format directly to the destination instead of building
+    // it all in a string first: the P4Info for large programs runs to many
+    // megabytes of text.
+    {
+        google::protobuf::io::OstreamOutputStream out(destination);
+        if (!google::protobuf::TextFormat::Print(message, &out)) {
+            ::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
+            return false;
+        }
     }
 
-    *destination << output;
     if (!destination->good()) {
         ::error(ErrorType::ERR_IO, "Failed to write text protobuf message to the output");
         return false;
@@ -700,17 +705,17 @@ getMatchTypeName(const IR::PathExpression* matchPathExpr, const ReferenceMap* re
 /// UNSPECIFIED is returned.
 static boost::optional<MatchField::MatchType>
 getMatchType(cstring matchTypeName) {
-    if (matchTypeName == P4CoreLibrary::instance.exactMatch.name) {
+    if (matchTypeName == P4CoreLibrary::instance().exactMatch.name) {
         return MatchField::MatchTypes::EXACT;
-    } else if (matchTypeName == P4CoreLibrary::instance.lpmMatch.name) {
+    } else if (matchTypeName == P4CoreLibrary::instance().lpmMatch.name) {
         return MatchField::MatchTypes::LPM;
-    } else if (matchTypeName == P4CoreLibrary::instance.ternaryMatch.name) {
+    } else if (matchTypeName == P4CoreLibrary::instance().ternaryMatch.name) {
         return MatchField::MatchTypes::TERNARY;
-    } else if (matchTypeName == P4V1::V1Model::instance.rangeMatchType.name) {
+    } else if (matchTypeName == P4V1::V1Model::instance().rangeMatchType.name) {
         return MatchField::MatchTypes::RANGE;
-    } else if (matchTypeName == P4V1::V1Model::instance.optionalMatchType.name) {
+    } else if (matchTypeName == P4V1::V1Model::instance().optionalMatchType.name) {
         return MatchField::MatchTypes::OPTIONAL;
-    } else if (matchTypeName == P4V1::V1Model::instance.selectorMatchType.name) {
+    } else if (matchTypeName == P4V1::V1Model::instance().selectorMatchType.name) {
         // Nothing to do here, we cannot even perform some sanity-checking.
         return boost::none;
     } else {
@@ -822,7 +827,8 @@ class P4RuntimeAnalyzer {
     P4RuntimeAnalyzer(const P4RuntimeSymbolTable& symbols,
                       TypeMap* typeMap, ReferenceMap* refMap,
                       P4RuntimeArchHandlerIface* archHandler)
-        : p4Info(new P4Info)
+        : arena(new google::protobuf::Arena)
+        , p4Info(google::protobuf::Arena::CreateMessage<P4Info>(arena))
         , symbols(symbols)
         , typeMap(typeMap)
         , refMap(refMap)
@@ -1347,6 +1353,11 @@ class P4RuntimeAnalyzer {
     }
 
  private:
+    /// Arena on which @p4Info and all its submessages are allocated; building
+    /// the message tree with individual heap allocations is measurably slower
+    /// for large programs. It is deliberately never destroyed, since the
+    /// generated message outlives the analyzer.
+    google::protobuf::Arena* arena;
     /// P4Runtime's representation of a program's control plane API.
     P4Info* p4Info;
     /// The symbols used in the API and their ids.
@@ -1447,7 +1458,9 @@ class P4RuntimeEntriesConverter {
     friend class P4RuntimeAnalyzer;
 
     explicit P4RuntimeEntriesConverter(const P4RuntimeSymbolTable& symbols)
-        : entries(new p4v1::WriteRequest), symbols(symbols) { }
+        : arena(new google::protobuf::Arena)
+        , entries(google::protobuf::Arena::CreateMessage<p4v1::WriteRequest>(arena))
+        , symbols(symbols) { }
 
     /// @return the P4Runtime WriteRequest message generated by this analyzer.
     const p4v1::WriteRequest* getEntries() const {
@@ -1501,9 +1514,9 @@ class P4RuntimeEntriesConverter {
       for (auto e : table->getKey()->keyElements) {
           auto matchType = getKeyMatchType(e, refMap);
           // TODO(antonin): remove dependency on v1model.
-          if (matchType == P4CoreLibrary::instance.ternaryMatch.name ||
-              matchType == P4V1::V1Model::instance.rangeMatchType.name ||
-              matchType == P4V1::V1Model::instance.optionalMatchType.name) {
+          if (matchType == P4CoreLibrary::instance().ternaryMatch.name ||
+              matchType == P4V1::V1Model::instance().rangeMatchType.name ||
+              matchType == P4V1::V1Model::instance().optionalMatchType.name) {
               return true;
           }
       }
@@ -1561,15 +1574,15 @@ class P4RuntimeEntriesConverter {
             auto keyWidth = getTypeWidth(tableKey->expression->type, typeMap);
             auto matchType = getKeyMatchType(tableKey, refMap);
 
-            if (matchType == P4CoreLibrary::instance.exactMatch.name) {
+            if (matchType == P4CoreLibrary::instance().exactMatch.name) {
               addExact(protoEntry, fieldId++, k, keyWidth, typeMap);
-            } else if (matchType == P4CoreLibrary::instance.lpmMatch.name) {
+            } else if (matchType == P4CoreLibrary::instance().lpmMatch.name) {
               addLpm(protoEntry, fieldId++, k, keyWidth, typeMap);
-            } else if (matchType == P4CoreLibrary::instance.ternaryMatch.name) {
+            } else if (matchType == P4CoreLibrary::instance().ternaryMatch.name) {
               addTernary(protoEntry, fieldId++, k, keyWidth, typeMap);
-            } else if (matchType == P4V1::V1Model::instance.rangeMatchType.name) {
+            } else if (matchType == P4V1::V1Model::instance().rangeMatchType.name) {
               addRange(protoEntry, fieldId++, k, keyWidth, typeMap);
-            } else if (matchType == P4V1::V1Model::instance.optionalMatchType.name) {
+            } else if (matchType == P4V1::V1Model::instance().optionalMatchType.name) {
               addOptional(protoEntry, fieldId++, k, keyWidth, typeMap);
             } else {
                 if (!k->is<IR::DefaultExpression>())
@@ -1780,6 +1793,9 @@ class P4RuntimeEntriesConverter {
         return mt->name.name;
     }
 
+    /// Arena on which @entries and all its submessages are allocated; never
+    /// destroyed, since the generated message outlives the converter.
+    google::protobuf::Arena* arena;
     /// We represent all static table entries as one P4Runtime WriteRequest object
     p4v1::WriteRequest *entries;
     /// The symbols used in the API and their ids.
@@ -1798,8 +1814,10 @@ P4RuntimeAnalyzer::analyze(const IR::P4Program* program,
     CHECK_NULL(archHandler);
 
     // Perform a first pass to collect all of the control plane visible symbols in
-    // the program.
-    auto symbols = P4RuntimeSymbolTable::create([=](P4RuntimeSymbolTable& symbols) {
+    // the program.  Controller headers found along the way are remembered so
+    // the construction phase does not have to walk the whole program again.
+    std::vector<const IR::Type_Header*> controllerHeaders;
+    auto symbols = P4RuntimeSymbolTable::create([&](P4RuntimeSymbolTable& symbols) {
         Helpers::forAllEvaluatedBlocks(evaluatedProgram, [&](const IR::Block* block) {
             if (block->is<IR::ControlBlock>()) {
                 collectControlSymbols(symbols, archHandler,
@@ -1816,6 +1834,7 @@ P4RuntimeAnalyzer::analyze(const IR::P4Program* program,
         forAllMatching<IR::Type_Header>(program, [&](const IR::Type_Header* type) {
             if (isControllerHeader(type)) {
                 symbols.add(P4RuntimeSymbolType::CONTROLLER_HEADER(), type);
+                controllerHeaders.push_back(type);
             }
         });
         archHandler->collectExtra(&symbols);
@@ -1823,8 +1842,11 @@ P4RuntimeAnalyzer::analyze(const IR::P4Program* program,
 
     archHandler->postCollect(symbols);
 
-    // Construct a P4Runtime control plane API from the program.
+    // Construct a P4Runtime control plane API from the program.  Static table
+    // entries only need the symbol ids collected above, so they are converted
+    // during the same traversal instead of a separate one.
     P4RuntimeAnalyzer analyzer(symbols, typeMap, refMap, archHandler);
+    P4RuntimeEntriesConverter entriesConverter(symbols);
     Helpers::forAllEvaluatedBlocks(evaluatedProgram, [&](const IR::Block* block) {
         if (block->is<IR::ControlBlock>()) {
             analyzer.analyzeControl(block->to<IR::ControlBlock>());
@@ -1832,15 +1854,14 @@ P4RuntimeAnalyzer::analyze(const IR::P4Program* program,
             analyzer.addExtern(block->to<IR::ExternBlock>());
         } else if (block->is<IR::TableBlock>()) {
             analyzer.addTable(block->to<IR::TableBlock>());
+            entriesConverter.addTableEntries(block->to<IR::TableBlock>(), refMap,
+                                             typeMap, archHandler);
         } else if (block->is<IR::ParserBlock>()) {
             analyzeParser(analyzer, block->to<IR::ParserBlock>());
         }
     });
-    forAllMatching<IR::Type_Header>(program, [&](const IR::Type_Header* type) {
-        if (isControllerHeader(type)) {
-            analyzer.addControllerHeader(type);
-        }
-    });
+    for (auto type : controllerHeaders)
+        analyzer.addControllerHeader(type);
 
     analyzer.postAdd();
 
@@ -1856,13 +1877,6 @@ P4RuntimeAnalyzer::analyze(const IR::P4Program* program,
 
     analyzer.addPkgInfo(evaluatedProgram, arch);
 
-    P4RuntimeEntriesConverter entriesConverter(symbols);
-    Helpers::forAllEvaluatedBlocks(evaluatedProgram, [&](const IR::Block* block) {
-        if (block->is<IR::TableBlock>())
-            entriesConverter.addTableEntries(block->to<IR::TableBlock>(), refMap,
-                                             typeMap, archHandler);
-    });
-
     auto* p4Info = analyzer.getP4Info();
     auto* p4Entries = entriesConverter.getEntries();
     return P4RuntimeAPI{p4Info, p4Entries};
@@ -1967,7 +1981,14 @@ static bool parseFileNames(cstring fileNameVector,
         }
         files.push_back(name);
 
-        if (cstring suffix = name.findlast('.')) {
+        // A trailing ".gz" selects transparent compression in openFile;
+        // the format is inferred from the suffix before it.
+        cstring base = name;
+        if (const char* gz = base.findlast('.')) {
+            if (cstring(gz) == ".gz")
+                base = base.before(gz);
+        }
+        if (cstring suffix = base.findlast('.')) {
             if (suffix == ".json") {
                 formats.push_back(P4::P4RuntimeFormat::JSON);
             } else if (suffix == ".bin") {
@@ -2023,6 +2044,9 @@ P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI& p4Runtime,
         return;
 
     if (!files.empty()) {
+        // Serialize the message once per distinct format; several files may
+        // request the same format.
+        std::map<P4::P4RuntimeFormat, std::string> serialized;
         for (unsigned i = 0; i < files.size(); i++) {
             cstring file = files.at(i);
             P4::P4RuntimeFormat format = formats.at(i);
@@ -2031,7 +2055,14 @@ P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI& p4Runtime,
                 ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime API file: %1%", file);
                 continue;
             }
-            p4Runtime.serializeP4InfoTo(out, format);
+            auto inserted = serialized.emplace(format, std::string());
+            if (inserted.second) {
+                std::ostringstream data;
+                p4Runtime.serializeP4InfoTo(&data, format);
+                inserted.first->second = data.str();
+            }
+            // written in the background, overlapping the rest of the compile
+            Util::AsyncWriter::write(file, out, inserted.first->second);
         }
     }
 
@@ -2046,6 +2077,7 @@ P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI& p4Runtime,
     if (!parseFileNames(options.p4RuntimeEntriesFiles, files, formats))
         return;
     if (!files.empty()) {
+        std::map<P4::P4RuntimeFormat, std::string> serialized;
         for (unsigned i = 0; i < files.size(); i++) {
             cstring file = files.at(i);
             P4::P4RuntimeFormat format = formats.at(i);
@@ -2055,7 +2087,13 @@ P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI& p4Runtime,
                         options.p4RuntimeEntriesFile);
                 continue;
             }
-            p4Runtime.serializeEntriesTo(out, format);
+            auto inserted = serialized.emplace(format, std::string());
+            if (inserted.second) {
+                std::ostringstream data;
+                p4Runtime.serializeEntriesTo(&data, format);
+                inserted.first->second = data.str();
+            }
+            Util::AsyncWriter::write(file, out, inserted.first->second);
         }
     }
 }
@@ -18,6 +18,8 @@ limitations under the License.
 #include <map>
 #include <string>
 
+#include <google/protobuf/arena.h>
+
 #include "p4/config/v1/p4types.pb.h"
 
 #include "bytestrings.h"
@@ -41,6 +43,22 @@ namespace P4 {
 
 namespace ControlPlaneAPI {
 
+namespace {
+
+/// Arena on which all type spec messages are allocated. The messages that
+/// convert() returns are kept by callers and copied into P4Info, so they
+/// must outlive any single converter instance; the arena is deliberately
+/// never destroyed, just as the individually heap-allocated messages were
+/// never freed before.
+google::protobuf::Arena* typeSpecArena = new google::protobuf::Arena();
+
+template <typename Message>
+Message* makeMessage() {
+    return google::protobuf::Arena::CreateMessage<Message>(typeSpecArena);
+}
+
+}  // namespace
+
 bool hasTranslationAnnotation(const IR::Type* type,
                               TranslationAnnotation* payload) {
     auto ann = type->getAnnotation("p4runtime_translation");
@@ -101,12 +119,12 @@ TypeSpecConverter::TypeSpecConverter(
 
 bool TypeSpecConverter::preorder(const IR::Type* type) {
     ::error(ErrorType::ERR_UNEXPECTED, "Unexpected type %1%", type);
-    map.emplace(type, new P4DataTypeSpec());
+    map.emplace(type, makeMessage<P4DataTypeSpec>());
     return false;
 }
 
 bool TypeSpecConverter::preorder(const IR::Type_Bits* type) {
-    auto typeSpec = new P4DataTypeSpec();
+    auto typeSpec = makeMessage<P4DataTypeSpec>();
     auto bitTypeSpec = typeSpec->mutable_bitstring();
     auto bw = type->width_bits();
     if (type->isSigned) bitTypeSpec->mutable_int_()->set_bitwidth(bw);
@@ -117,7 +135,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Bits* type) {
 }
 
 bool TypeSpecConverter::preorder(const IR::Type_Varbits* type) {
-    auto typeSpec = new P4DataTypeSpec();
+    auto typeSpec = makeMessage<P4DataTypeSpec>();
     auto bitTypeSpec = typeSpec->mutable_bitstring();
     bitTypeSpec->mutable_varbit()->set_max_bitwidth(type->size);
     map.emplace(type, typeSpec);
@@ -125,7 +143,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Varbits* type) {
 }
 
 bool TypeSpecConverter::preorder(const IR::Type_Boolean* type) {
-    auto typeSpec = new P4DataTypeSpec();
+    auto typeSpec = makeMessage<P4DataTypeSpec>();
     // enable "bool" field in P4DataTypeSpec's type_spec oneof
     (void)typeSpec->mutable_bool_();
     map.emplace(type, typeSpec);
@@ -133,7 +151,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Boolean* type) {
 }
 
 bool TypeSpecConverter::preorder(const IR::Type_Name* type) {
-    auto typeSpec = new P4DataTypeSpec();
+    auto typeSpec = makeMessage<P4DataTypeSpec>();
     auto decl = refMap->getDeclaration(type->path, true);
     auto name = decl->controlPlaneName();
     if (decl->is<IR::Type_Struct>()) {
@@ -174,7 +192,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Newtype* type) {
         auto name = std::string(type->controlPlaneName());
         auto types = p4RtTypeInfo->mutable_new_types();
         if (types->find(name) == types->end()) {
-            auto newTypeSpec = new p4configv1::P4NewTypeSpec();
+            auto newTypeSpec = makeMessage<p4configv1::P4NewTypeSpec>();
 
             // walk the chain of new types
             const IR::Type* underlyingType = type;
@@ -218,7 +236,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Newtype* type) {
 }
 
 bool TypeSpecConverter::preorder(const IR::Type_BaseList* type) {
-    auto typeSpec = new P4DataTypeSpec();
+    auto typeSpec = makeMessage<P4DataTypeSpec>();
     auto tupleTypeSpec = typeSpec->mutable_tuple();
     for (auto cType : type->components) {
         visit(cType);
@@ -232,7 +250,7 @@ bool TypeSpecConverter::preorder(const IR::Type_BaseList* type) {
 }
 
 bool TypeSpecConverter::preorder(const IR::Type_Stack* type) {
-    auto typeSpec = new P4DataTypeSpec();
+    auto typeSpec = makeMessage<P4DataTypeSpec>();
     if (!type->elementType->is<IR::Type_Name>()) {
         BUG("Unexpected stack element type %1%", type->elementType);
     }
@@ -264,7 +282,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Struct* type) {
         auto name = std::string(type->controlPlaneName());
         auto structs = p4RtTypeInfo->mutable_structs();
         if (structs->find(name) == structs->end()) {
-            auto structTypeSpec = new p4configv1::P4StructTypeSpec();
+            auto structTypeSpec = makeMessage<p4configv1::P4StructTypeSpec>();
             for (auto f : type->fields) {
                 auto fType = f->type;
                 visit(fType);
@@ -287,7 +305,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Header* type) {
         auto name = std::string(type->controlPlaneName());
         auto headers = p4RtTypeInfo->mutable_headers();
         if (headers->find(name) == headers->end()) {
-            auto headerTypeSpec = new p4configv1::P4HeaderTypeSpec();
+            auto headerTypeSpec = makeMessage<p4configv1::P4HeaderTypeSpec>();
             for (auto f : flattenedHeaderType->fields) {
                 auto fType = f->type;
                 visit(fType);
@@ -312,7 +330,7 @@ bool TypeSpecConverter::preorder(const IR::Type_HeaderUnion* type) {
         auto name = std::string(type->controlPlaneName());
         auto headerUnions = p4RtTypeInfo->mutable_header_unions();
         if (headerUnions->find(name) == headerUnions->end()) {
-            auto headerUnionTypeSpec = new p4configv1::P4HeaderUnionTypeSpec();
+            auto headerUnionTypeSpec = makeMessage<p4configv1::P4HeaderUnionTypeSpec>();
             for (auto f : type->fields) {
                 auto fType = f->type;
                 visit(fType);
@@ -336,7 +354,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Enum* type) {
         auto name = std::string(type->controlPlaneName());
         auto enums = p4RtTypeInfo->mutable_enums();
         if (enums->find(name) == enums->end()) {
-            auto enumTypeSpec = new p4configv1::P4EnumTypeSpec();
+            auto enumTypeSpec = makeMessage<p4configv1::P4EnumTypeSpec>();
             for (auto m : type->members) {
                 auto member = enumTypeSpec->add_members();
                 member->set_name(m->controlPlaneName());
@@ -353,7 +371,7 @@ bool TypeSpecConverter::preorder(const IR::Type_SerEnum* type) {
         auto name = std::string(type->controlPlaneName());
         auto enums = p4RtTypeInfo->mutable_serializable_enums();
         if (enums->find(name) == enums->end()) {
-            auto enumTypeSpec = new p4configv1::P4SerializableEnumTypeSpec();
+            auto enumTypeSpec = makeMessage<p4configv1::P4SerializableEnumTypeSpec>();
             auto bitTypeSpec = enumTypeSpec->mutable_underlying_type();
             auto width = type->type->width_bits();
             bitTypeSpec->set_bitwidth(width);
@@ -390,9 +408,21 @@ const P4DataTypeSpec* TypeSpecConverter::convert(
     const P4::ReferenceMap* refMap,
     const P4::TypeMap* typeMap,
     const IR::Type* type, P4TypeInfo* typeInfo) {
+    // The same type occurs in many table keys, action parameters and digest
+    // fields; convert each distinct type once and reuse the result. The
+    // typeInfo pointer is part of the key because conversion also records
+    // named types in it, which must still happen for a type first converted
+    // without a typeInfo.
+    using CacheKey = std::pair<const IR::Type*, const P4TypeInfo*>;
+    static std::map<CacheKey, const P4DataTypeSpec*> cache;
+    auto inserted = cache.emplace(CacheKey(type, typeInfo), nullptr);
+    if (!inserted.second)
+        return inserted.first->second;
     TypeSpecConverter typeSpecConverter(refMap, typeMap, typeInfo);
     type->apply(typeSpecConverter);
-    return typeSpecConverter.map.at(type);
+    auto typeSpec = typeSpecConverter.map.at(type);
+    inserted.first->second = typeSpec;
+    return typeSpec;
 }
 
 }  // namespace ControlPlaneAPI
@@ -30,6 +30,18 @@ ApplyOptionsPragmas::ApplyOptionsPragmas(IOptionPragmaParser& parser)
     options.push_back("(from pragmas)");
 }
 
+bool ApplyOptionsPragmas::preorder(const IR::P4Program* program) {
+    // If this program is fresh from the parser, its annotations were already
+    // collected in program order; consume them directly instead of traversing
+    // the whole tree to rediscover them.  Programs from other sources (e.g.
+    // reloaded from a cache or synthesized in memory) still get scanned.
+    auto pragmas = AbstractParserDriver::optionPragmasFor(program);
+    if (pragmas == nullptr) return true;
+    for (auto annotation : *pragmas)
+        preorder(annotation);
+    return false;
+}
+
 bool ApplyOptionsPragmas::preorder(const IR::Annotation* annotation) {
     auto newOptions = parser.tryToParse(annotation);
     if (!newOptions) return false;
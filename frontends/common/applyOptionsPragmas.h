@@ -50,11 +50,17 @@ class IOptionPragmaParser {
  * where truly standalone pragmas are often used. Annotations which really are
  * specific to a certain program construct should be handled using a different
  * approach.
+ *
+ * For programs that come straight from the parser this pass consumes the
+ * annotation list the parser driver collected as it read them, avoiding a
+ * whole-tree traversal of the fresh program; other programs are scanned
+ * node by node as before.
  */
 class ApplyOptionsPragmas : public Inspector {
  public:
     explicit ApplyOptionsPragmas(IOptionPragmaParser& parser);
 
+    bool preorder(const IR::P4Program* program) override;
     bool preorder(const IR::Annotation* annotation) override;
     void end_apply() override;
 
@@ -0,0 +1,76 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "compileBatch.h"
+
+#include <string.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace P4 {
+namespace CompileBatch {
+
+int run(const char* listFile, int argc, char* const* argv,
+        std::function<int(int argc, char* const* argv)> compile) {
+    std::ifstream list(listFile);
+    if (!list) {
+        std::cerr << "Can't open " << listFile << std::endl;
+        return 1;
+    }
+
+    // the driver arguments shared by every job, with --batch itself removed
+    std::vector<std::string> common;
+    for (int i = 0; i < argc; i++) {
+        if (i > 0 && !strcmp(argv[i], "--batch")) {
+            i++;  // skip the list file argument too
+            continue;
+        }
+        common.push_back(argv[i]);
+    }
+
+    int jobs = 0, failed = 0;
+    std::string line;
+    while (std::getline(list, line)) {
+        std::vector<std::string> fields(common);
+        std::istringstream split(line);
+        std::string word;
+        while (split >> word)
+            fields.push_back(word);
+        if (fields.size() == common.size())
+            continue;  // blank line
+        if (fields.at(common.size())[0] == '#')
+            continue;  // comment
+        std::vector<char*> jobArgv;
+        for (auto& f : fields)
+            jobArgv.push_back(const_cast<char*>(f.c_str()));
+        jobArgv.push_back(nullptr);
+        jobs++;
+        if (compile(jobArgv.size() - 1, jobArgv.data()) != 0) {
+            failed++;
+            std::cerr << "Failed: " << line << std::endl;
+        }
+    }
+    if (failed)
+        std::cerr << failed << " of " << jobs << " jobs failed" << std::endl;
+    return failed > 255 ? 255 : failed;
+}
+
+}  // namespace CompileBatch
+}  // namespace P4
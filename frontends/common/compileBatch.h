@@ -0,0 +1,52 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _FRONTENDS_COMMON_COMPILEBATCH_H_
+#define _FRONTENDS_COMMON_COMPILEBATCH_H_
+
+#include <functional>
+
+namespace P4 {
+
+/**
+ * Batch mode, enabled with --batch <file-list>.
+ *
+ * Compiles every program listed in the file within a single process, one
+ * after the other.  Jobs after the first reuse warmed process state -- the
+ * initialized collector, the interned string table and any in-memory
+ * caches -- so the per-invocation startup cost is paid once instead of
+ * once per program.  Each job parses its own options and runs under a
+ * fresh compile context, so diagnostics and error counts stay isolated.
+ *
+ * Each non-empty line of the list file that does not start with '#' is one
+ * job: it is split on whitespace and substituted for the "--batch <file>"
+ * pair in the driver's argument list, so a line can be a bare .p4 file or
+ * a file plus per-job options (e.g. "-o prog.json prog.p4").  Options
+ * given on the driver's command line apply to every job.
+ */
+namespace CompileBatch {
+
+/// Run every job listed in @listFile through @compile, passing the driver
+/// arguments @argc/@argv with the "--batch <file>" pair replaced by the
+/// job's own fields.  Returns the number of failed jobs, capped at the
+/// largest representable exit status.
+int run(const char* listFile, int argc, char* const* argv,
+        std::function<int(int argc, char* const* argv)> compile);
+
+}  // namespace CompileBatch
+}  // namespace P4
+
+#endif /* _FRONTENDS_COMMON_COMPILEBATCH_H_ */
@@ -0,0 +1,160 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "compileCache.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "ir/binary_io.h"
+#include "lib/error.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+
+namespace P4 {
+namespace CompileCache {
+
+bool enabled(const CompilerOptions& options) {
+    return options.compilationCacheDir != nullptr;
+}
+
+cstring computeDigest(const CompilerOptions& options, const std::string& source) {
+    // Everything that changes the IR a given source text produces must be
+    // part of the key: language version, target/arch (they select different
+    // builtin models), preprocessor flags, ndebug, and the compiler itself.
+    std::stringstream key;
+    key << (options.langVersion == CompilerOptions::FrontendVersion::P4_14 ? "p4-14" : "p4-16")
+        << '\0' << options.preprocessor_options
+        << '\0' << (options.target ? options.target.c_str() : "")
+        << '\0' << (options.arch ? options.arch.c_str() : "")
+        << '\0' << options.ndebug
+        << '\0' << (options.compilerVersion ? options.compilerVersion.c_str() : "");
+    std::string keyStr = key.str();
+    // two independently seeded 64-bit hashes over options+source give a 128-bit key
+    uint64_t h1 = Util::Hash::hash(keyStr.data(), keyStr.size()) ^
+                  Util::Hash::hash(source.data(), source.size());
+    uint64_t h2 = Util::Hash::hash(keyStr.data(), keyStr.size(), UINT64_C(0x5851f42d4c957f2d)) ^
+                  Util::Hash::hash(source.data(), source.size(), UINT64_C(0x5851f42d4c957f2d));
+    char buf[36];
+    snprintf(buf, sizeof(buf), "%016llx%016llx",
+             static_cast<unsigned long long>(h1), static_cast<unsigned long long>(h2));
+    return cstring(buf);
+}
+
+static cstring entryPath(const CompilerOptions& options, cstring digest, const char* phase) {
+    std::string path = options.compilationCacheDir + "/" + digest + "-" + phase + ".p4irbin";
+    return cstring(path);
+}
+
+const IR::P4Program* lookup(const CompilerOptions& options, cstring digest, const char* phase) {
+    cstring path = entryPath(options, digest, phase);
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        LOG2("compilation cache miss for " << path);
+        return nullptr;
+    }
+    unsigned errorsBefore = ::errorCount();
+    auto node = loadBinaryIR(in);
+    if (node == nullptr || ::errorCount() > errorsBefore) {
+        // treat a corrupt entry as a miss and let it be overwritten
+        ::warning(ErrorType::WARN_FAILED, "ignoring corrupt compilation cache entry %1%", path);
+        return nullptr;
+    }
+    auto program = node->to<IR::P4Program>();
+    if (program != nullptr)
+        LOG1("compilation cache hit for " << path);
+    return program;
+}
+
+void store(const CompilerOptions& options, cstring digest, const char* phase,
+           const IR::P4Program* program) {
+    cstring path = entryPath(options, digest, phase);
+    // write to a temporary and rename, so concurrent compiles never observe
+    // a partially written entry
+    cstring tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            ::warning(ErrorType::WARN_FAILED, "can't write compilation cache entry %1%", path);
+            return;
+        }
+        saveBinaryIR(program, out);
+        if (!out) {
+            ::warning(ErrorType::WARN_FAILED, "can't write compilation cache entry %1%", path);
+            unlink(tmp.c_str());
+            return;
+        }
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        ::warning(ErrorType::WARN_FAILED, "can't write compilation cache entry %1%", path);
+        unlink(tmp.c_str());
+    }
+}
+
+size_t stdlibPrefixLength(const std::string& source) {
+    const std::string includePrefix = p4includePath;
+    bool seenStdlib = false;        // entered a p4include file at some point
+    bool currentIsStdlib = false;   // current line marker points into p4include
+    size_t cutCandidate = 0;        // offset of the marker returning to user code
+    size_t pos = 0;
+    while (pos < source.size()) {
+        size_t eol = source.find('\n', pos);
+        if (eol == std::string::npos) eol = source.size();
+        if (source[pos] == '#') {
+            // a preprocessor line marker: # <line> "<file>" [flags]
+            size_t q1 = source.find('"', pos);
+            size_t q2 = q1 == std::string::npos ? q1 : source.find('"', q1 + 1);
+            if (q2 != std::string::npos && q2 < eol) {
+                std::string file = source.substr(q1 + 1, q2 - q1 - 1);
+                bool isStdlib = file.compare(0, includePrefix.size(), includePrefix) == 0;
+                if (isStdlib) {
+                    seenStdlib = true;
+                    cutCandidate = 0;  // blank user region between includes joins the prefix
+                } else if (currentIsStdlib) {
+                    cutCandidate = pos;  // the marker itself belongs to the remainder
+                }
+                currentIsStdlib = isStdlib;
+            }
+        } else if (!currentIsStdlib &&
+                   source.find_first_not_of(" \t\r", pos) < eol) {
+            // actual user code; the prefix (if any) ended at the last marker
+            // switching back out of the include path
+            return seenStdlib ? cutCandidate : 0;
+        }
+        pos = eol + 1;
+    }
+    // program with no user code after the includes
+    return seenStdlib ? cutCandidate : 0;
+}
+
+std::vector<std::pair<cstring, bool>> declaredTypes(const IR::P4Program* program) {
+    std::vector<std::pair<cstring, bool>> rv;
+    for (auto obj : program->objects) {
+        auto td = obj->to<IR::Type_Declaration>();
+        if (td == nullptr) continue;
+        bool generic = false;
+        if (auto gen = obj->to<IR::IMayBeGenericType>())
+            generic = !gen->getTypeParameters()->empty();
+        rv.emplace_back(td->name.name, generic);
+    }
+    return rv;
+}
+
+}  // namespace CompileCache
+}  // namespace P4
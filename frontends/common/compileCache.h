@@ -0,0 +1,80 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _FRONTENDS_COMMON_COMPILECACHE_H_
+#define _FRONTENDS_COMMON_COMPILECACHE_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "frontends/common/options.h"
+#include "lib/cstring.h"
+
+namespace IR {
+class P4Program;
+}  // namespace IR
+
+namespace P4 {
+
+/**
+ * On-disk compilation cache, enabled with --compilation-cache <dir>.
+ *
+ * Entries are keyed on a digest of the preprocessed source text together
+ * with the options that influence the produced IR, so an unchanged program
+ * compiled with unchanged options hits the cache regardless of include
+ * timestamps. Each phase ("parse", "frontend") stores its output IR as a
+ * separate binary IR artifact (see ir/binary_io.h); a hit on the "frontend"
+ * entry skips both parsing and the whole frontend pipeline, including
+ * TypeInference.
+ *
+ * Cached programs are reloaded without their InputSources, so diagnostics
+ * emitted by later phases lose source fragments; the cache is therefore
+ * opt-in.
+ */
+namespace CompileCache {
+
+/// True if @options enable the compilation cache.
+bool enabled(const CompilerOptions& options);
+
+/// Compute the cache key for @source compiled with @options.
+cstring computeDigest(const CompilerOptions& options, const std::string& source);
+
+/// Look up the cached output of @phase for @digest; returns nullptr on a miss
+/// or if the cached artifact is unreadable (a miss, not an error).
+const IR::P4Program* lookup(const CompilerOptions& options, cstring digest, const char* phase);
+
+/// Store @program as the output of @phase for @digest.  Failures to write are
+/// reported as warnings; compilation proceeds regardless.
+void store(const CompilerOptions& options, cstring digest, const char* phase,
+           const IR::P4Program* program);
+
+/// Length of the leading region of preprocessed @source that came entirely
+/// from files under the p4include path, as determined from the preprocessor's
+/// line markers.  This is the standard library portion of the program, which
+/// can be parsed once and snapshotted.  Returns 0 if the program has no such
+/// cleanly separable prefix (e.g. user code before the includes).
+size_t stdlibPrefixLength(const std::string& source);
+
+/// The type names (and whether each is generic) declared by the top-level
+/// objects of @program; used to seed the parser symbol table when parsing the
+/// remainder of a program whose stdlib prefix was spliced in precompiled.
+std::vector<std::pair<cstring, bool>> declaredTypes(const IR::P4Program* program);
+
+}  // namespace CompileCache
+}  // namespace P4
+
+#endif /* _FRONTENDS_COMMON_COMPILECACHE_H_ */
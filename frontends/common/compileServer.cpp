@@ -0,0 +1,175 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "compileServer.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace P4 {
+namespace CompileServer {
+
+/// Read a full request (fields up to and including an empty one) from @fd.
+/// Returns false on a malformed or truncated request.
+static bool readRequest(int fd, std::vector<std::string>* fields) {
+    std::string data;
+    char buf[4096];
+    for (;;) {
+        // a complete request ends with two consecutive NULs
+        if (data.size() >= 2 && data[data.size() - 1] == '\0' && data[data.size() - 2] == '\0')
+            break;
+        if (data.size() == 1 && data[0] == '\0')  // shutdown request
+            break;
+        ssize_t got = read(fd, buf, sizeof(buf));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (got == 0)
+            return !data.empty() && data[data.size() - 1] == '\0';
+        data.append(buf, got);
+    }
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t end = data.find('\0', pos);
+        if (end == pos)
+            break;  // empty field terminates the request
+        fields->push_back(data.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return true;
+}
+
+static void writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t put = write(fd, data, size);
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += put;
+        size -= put;
+    }
+}
+
+static int runJob(int conn, const std::vector<std::string>& fields,
+                  const std::function<int(int, char* const*)>& compile) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("p4c compile server: fork");
+        return -1;
+    }
+    if (pid == 0) {
+        // the job's output goes back over the connection
+        dup2(conn, STDOUT_FILENO);
+        dup2(conn, STDERR_FILENO);
+        if (chdir(fields.at(0).c_str()) != 0) {
+            std::cerr << "Can't chdir to " << fields.at(0) << std::endl;
+            exit(1);
+        }
+        std::vector<char*> argv;
+        for (size_t i = 1; i < fields.size(); i++)
+            argv.push_back(const_cast<char*>(fields.at(i).c_str()));
+        argv.push_back(nullptr);
+        int status = compile(argv.size() - 1, argv.data());
+        std::cout.flush();
+        std::cerr.flush();
+        exit(status);
+    }
+    int wstatus = 0;
+    while (waitpid(pid, &wstatus, 0) < 0 && errno == EINTR) {}
+    return WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : 128 + WTERMSIG(wstatus);
+}
+
+int run(const char* socketPath, std::function<int(int argc, char* const* argv)> compile,
+        std::function<void()> warmup) {
+    struct sockaddr_un addr;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << socketPath << std::endl;
+        return 1;
+    }
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        perror("p4c compile server: socket");
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+    unlink(socketPath);  // remove a stale socket from a previous server
+    if (bind(server, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(server, 16) < 0) {
+        perror("p4c compile server: bind/listen");
+        close(server);
+        return 1;
+    }
+
+    // Warm up after the socket is ready, so clients can connect immediately
+    // and at worst wait for the warmup instead of being refused.  Whatever
+    // the warmup builds is inherited copy-on-write by every job.
+    if (warmup != nullptr)
+        warmup();
+
+    int rv = 0;
+    for (;;) {
+        int conn = accept(server, nullptr, nullptr);
+        if (conn < 0) {
+            if (errno == EINTR) continue;
+            perror("p4c compile server: accept");
+            rv = 1;
+            break;
+        }
+        std::vector<std::string> fields;
+        if (!readRequest(conn, &fields)) {
+            close(conn);
+            continue;
+        }
+        if (fields.empty()) {  // shutdown request
+            close(conn);
+            break;
+        }
+        if (fields.size() < 2) {
+            // need at least a working directory and an argv[0]
+            close(conn);
+            continue;
+        }
+        int code = runJob(conn, fields, compile);
+        if (code < 0) {
+            close(conn);
+            continue;
+        }
+        char trailer[16];
+        int n = snprintf(trailer + 1, sizeof(trailer) - 1, "%d\n", code);
+        trailer[0] = '\0';
+        writeAll(conn, trailer, n + 1);
+        close(conn);
+    }
+    close(server);
+    unlink(socketPath);
+    return rv;
+}
+
+}  // namespace CompileServer
+}  // namespace P4
@@ -0,0 +1,56 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _FRONTENDS_COMMON_COMPILESERVER_H_
+#define _FRONTENDS_COMMON_COMPILESERVER_H_
+
+#include <functional>
+
+namespace P4 {
+
+/**
+ * Compile-server (daemon) mode, enabled with --compile-server <socket>.
+ *
+ * The server listens on a unix stream socket and runs each compile job in a
+ * forked child, so jobs inherit warmed process state -- the initialized
+ * collector, interned strings and any in-memory caches -- copy-on-write,
+ * while their options, compile context and error counts stay isolated.
+ * Before accepting jobs the server runs an optional warmup callback, which
+ * drivers use to pre-parse the standard library headers (see
+ * P4::warmStandardLibrary) so that state is resident in the parent and
+ * shared by every job.  This eliminates the per-invocation startup cost
+ * when a test suite runs the compiler thousands of times.
+ *
+ * Wire protocol (one job per connection):
+ *  - request: NUL-separated fields: the job's working directory, then its
+ *    argv (including argv[0]), terminated by an empty field;
+ *  - response: the job's stdout and stderr, then a NUL byte followed by the
+ *    decimal exit code and a newline.
+ * A request with no fields at all shuts the server down.
+ */
+namespace CompileServer {
+
+/// Serve compile jobs on @socketPath, running each through @compile.  If
+/// @warmup is non-null it runs once in the parent, after the socket is
+/// ready but before the first job is accepted.
+/// Returns only when a shutdown request is received or the socket fails.
+int run(const char* socketPath, std::function<int(int argc, char* const* argv)> compile,
+        std::function<void()> warmup = nullptr);
+
+}  // namespace CompileServer
+}  // namespace P4
+
+#endif /* _FRONTENDS_COMMON_COMPILESERVER_H_ */
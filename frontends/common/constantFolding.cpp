@@ -46,6 +46,43 @@ class CloneConstants : public Transform {
     }
 };
 
+const IR::Node* DoConstantFolding::preorder(IR::Node* node) {
+    if (cache != nullptr && cache->isSettled(getOriginal()->id))
+        // a previous folding pass proved that nothing under this node folds
+        prune();
+    return node;
+}
+
+bool MarkSettledSubtrees::dependsOnNames(const IR::Node* node) const {
+    if (node->is<IR::Declaration_Constant>())
+        // must be revisited so the declared value is registered for
+        // substitution of the paths that refer to it
+        return true;
+    if (auto pe = node->to<IR::PathExpression>()) {
+        // a path is inert for folding unless it can resolve to a constant
+        // declaration; without a resolution we must assume it can
+        if (refMap == nullptr)
+            return true;
+        auto decl = refMap->getDeclaration(pe->path);
+        return decl == nullptr || decl->is<IR::Declaration_Constant>();
+    }
+    return false;
+}
+
+bool MarkSettledSubtrees::preorder(const IR::Node*) {
+    clean.push_back(true);
+    return true;
+}
+
+void MarkSettledSubtrees::postorder(const IR::Node* node) {
+    bool settled = clean.back() && !dependsOnNames(node);
+    clean.pop_back();
+    if (settled)
+        cache->markSettled(node->id);
+    else if (!clean.empty())
+        clean.back() = false;
+}
+
 const IR::Expression* DoConstantFolding::getConstant(const IR::Expression* expr) const {
     CHECK_NULL(expr);
     if (expr->is<IR::Constant>())
@@ -150,7 +187,7 @@ const IR::Node* DoConstantFolding::postorder(IR::Declaration_Constant* d) {
                     ::error(ErrorType::ERR_TYPE_ERROR, "%1%: initializer has wrong type %2%",
                             d, cst->type);
                 else if (cst->type->is<IR::Type_InfInt>())
-                    init = new IR::Constant(init->srcInfo, d->type, cst->value, cst->base);
+                    init = IR::Constant::get(init->srcInfo, d->type, cst->value, cst->base);
             } else if (!d->type->is<IR::Type_InfInt>()) {
                 // Don't fold this yet, we can't evaluate the cast.
                 return d;
@@ -222,7 +259,7 @@ const IR::Node* DoConstantFolding::postorder(IR::Cmpl* e) {
     }
 
     big_int value = ~cst->value;
-    return new IR::Constant(cst->srcInfo, t, value, cst->base, true);
+    return IR::Constant::get(cst->srcInfo, t, value, cst->base, true);
 }
 
 const IR::Node* DoConstantFolding::postorder(IR::Neg* e) {
@@ -237,7 +274,7 @@ const IR::Node* DoConstantFolding::postorder(IR::Neg* e) {
     }
     const IR::Type* t = op->type;
     if (t->is<IR::Type_InfInt>())
-        return new IR::Constant(cst->srcInfo, t, -cst->value, cst->base);
+        return IR::Constant::get(cst->srcInfo, t, -cst->value, cst->base);
 
     auto tb = t->to<IR::Type_Bits>();
     if (tb == nullptr) {
@@ -246,12 +283,12 @@ const IR::Node* DoConstantFolding::postorder(IR::Neg* e) {
     }
 
     big_int value = -cst->value;
-    return new IR::Constant(cst->srcInfo, t, value, cst->base, true);
+    return IR::Constant::get(cst->srcInfo, t, value, cst->base, true);
 }
 
 const IR::Constant*
 DoConstantFolding::cast(const IR::Constant* node, unsigned base, const IR::Type_Bits* type) const {
-    return new IR::Constant(node->srcInfo, type, node->value, base);
+    return IR::Constant::get(node->srcInfo, type, node->value, base);
 }
 
 const IR::Node* DoConstantFolding::postorder(IR::Add* e) {
@@ -363,7 +400,7 @@ DoConstantFolding::compare(const IR::Operation_Binary* e) {
             return e;
         }
         bool bresult = (left->value == right->value) == eqTest;
-        return new IR::BoolLiteral(e->srcInfo, bresult);
+        return IR::BoolLiteral::get(e->srcInfo, bresult);
     } else if (typesKnown) {
         auto le = EnumInstance::resolve(eleft, typeMap);
         auto re = EnumInstance::resolve(eright, typeMap);
@@ -371,7 +408,7 @@ DoConstantFolding::compare(const IR::Operation_Binary* e) {
             BUG_CHECK(le->type == re->type,
                       "%1%: different enum types in comparison", e);
             bool bresult = (le->name == re->name) == eqTest;
-            return new IR::BoolLiteral(e->srcInfo, bresult);
+            return IR::BoolLiteral::get(e->srcInfo, bresult);
         }
 
         auto llist = eleft->to<IR::ListExpression>();
@@ -397,7 +434,7 @@ DoConstantFolding::compare(const IR::Operation_Binary* e) {
                 if (boolLit->value != eqTest)
                     return boolLit;
             }
-            return new IR::BoolLiteral(e->srcInfo, eqTest);
+            return IR::BoolLiteral::get(e->srcInfo, eqTest);
         }
     }
 
@@ -493,9 +530,9 @@ DoConstantFolding::binary(const IR::Operation_Binary* e,
     }
 
     if (e->is<IR::Operation_Relation>())
-        return new IR::BoolLiteral(e->srcInfo, value != 0);
+        return IR::BoolLiteral::get(e->srcInfo, value != 0);
     else
-        return new IR::Constant(e->srcInfo, resultType, value, left->base, true);
+        return IR::Constant::get(e->srcInfo, resultType, value, left->base, true);
 }
 
 const IR::Node* DoConstantFolding::postorder(IR::LAnd* e) {
@@ -511,7 +548,7 @@ const IR::Node* DoConstantFolding::postorder(IR::LAnd* e) {
     if (lcst->value) {
         return e->right;
     }
-    return new IR::BoolLiteral(left->srcInfo, false);
+    return IR::BoolLiteral::get(left->srcInfo, false);
 }
 
 const IR::Node* DoConstantFolding::postorder(IR::LOr* e) {
@@ -527,7 +564,7 @@ const IR::Node* DoConstantFolding::postorder(IR::LOr* e) {
     if (!lcst->value) {
         return e->right;
     }
-    return new IR::BoolLiteral(left->srcInfo, true);
+    return IR::BoolLiteral::get(left->srcInfo, true);
 }
 
 static bool overflowWidth(const IR::Node* node, int width) {
@@ -581,7 +618,7 @@ const IR::Node* DoConstantFolding::postorder(IR::Slice* e) {
     mask = (mask << (m - l + 1)) - 1;
     value = value & mask;
     auto resultType = IR::Type_Bits::get(m - l + 1);
-    return new IR::Constant(e->srcInfo, resultType, value, cbase->base, true);
+    return IR::Constant::get(e->srcInfo, resultType, value, cbase->base, true);
 }
 
 const IR::Node* DoConstantFolding::postorder(IR::Member* e) {
@@ -595,7 +632,7 @@ const IR::Node* DoConstantFolding::postorder(IR::Member* e) {
     if (type->is<IR::Type_Stack>() && e->member == IR::Type_Stack::arraySize) {
         auto st = type->to<IR::Type_Stack>();
         auto size = st->getSize();
-        result = new IR::Constant(st->size->srcInfo, origtype, size);
+        result = IR::Constant::get(st->size->srcInfo, origtype, size);
     } else {
         auto expr = getConstant(e->expr);
         if (expr == nullptr)
@@ -669,7 +706,7 @@ const IR::Node* DoConstantFolding::postorder(IR::Concat* e) {
     if (overflowWidth(e, resultType->size))
         return e;
     big_int value = Util::shift_left(left->value, static_cast<unsigned>(rt->size)) + right->value;
-    return new IR::Constant(e->srcInfo, resultType, value, left->base);
+    return IR::Constant::get(e->srcInfo, resultType, value, left->base);
 }
 
 const IR::Node* DoConstantFolding::postorder(IR::LNot* e) {
@@ -682,7 +719,7 @@ const IR::Node* DoConstantFolding::postorder(IR::LNot* e) {
         ::error(ErrorType::ERR_EXPECTED, "%1%: Expected a boolean value", op);
         return e;
     }
-    return new IR::BoolLiteral(cst->srcInfo, !cst->value);
+    return IR::BoolLiteral::get(cst->srcInfo, !cst->value);
 }
 
 const IR::Node* DoConstantFolding::postorder(IR::Mux* e) {
@@ -751,7 +788,7 @@ const IR::Node* DoConstantFolding::shift(const IR::Operation_Binary* e) {
         value = Util::shift_left(value, shift);
     else
         value = Util::shift_right(value, shift);
-    return new IR::Constant(e->srcInfo, left->type, value, cl->base);
+    return IR::Constant::get(e->srcInfo, left->type, value, cl->base);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Cast *e) {
@@ -773,7 +810,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Cast *e) {
         } else if (expr -> is<IR::BoolLiteral>()) {
             auto arg = expr->to<IR::BoolLiteral>();
             int v = arg->value ? 1 : 0;
-            return new IR::Constant(e->srcInfo, type, v, 10);
+            return IR::Constant::get(e->srcInfo, type, v, 10);
         } else {
             return e;
         }
@@ -804,7 +841,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Cast *e) {
                 ::error(ErrorType::ERR_INVALID, "%1%: Only 0 and 1 can be cast to booleans", e);
                 return e;
             }
-            return new IR::BoolLiteral(e->srcInfo, v == 1);
+            return IR::BoolLiteral::get(e->srcInfo, v == 1);
         }
     } else if (etype->is<IR::Type_StructLike>()) {
         return CloneConstants::clone(expr);
@@ -17,12 +17,38 @@ limitations under the License.
 #ifndef _COMMON_CONSTANTFOLDING_H_
 #define _COMMON_CONSTANTFOLDING_H_
 
+#include <unordered_set>
+
 #include "lib/gmputil.h"
 #include "ir/ir.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
 
 namespace P4 {
 
+/** @brief Memoizes folding results across the ConstantFolding instances of
+ * one compilation.
+ *
+ * The cache records the ids of subtrees that a completed (typed) folding
+ * pass left untouched and whose folding result cannot change later: all
+ * folding in such a subtree is driven by the (immutable) subtree itself,
+ * not by declarations elsewhere in the program.  A later folding pass
+ * prunes these subtrees without revisiting them.
+ *
+ * Keying on IR::Node::id gives invalidation for free: when a pass replaces
+ * a node, the replacement (and every ancestor) gets a fresh id, so only
+ * genuinely unchanged subtrees ever hit the cache.  Ids are not reliably
+ * unique across IR loaded from JSON dumps, so a cache must not outlive the
+ * compilation whose ids it recorded.
+ */
+class ConstantFoldingCache {
+    std::unordered_set<int> settled;
+
+ public:
+    /// True if the subtree rooted at the node with id @p id can never fold.
+    bool isSettled(int id) const { return settled.count(id) != 0; }
+    void markSettled(int id) { settled.insert(id); }
+};
+
 /** @brief statically evaluates many constant expressions.
  *
  * This pass can be invoked either with or without the `refMap` and
@@ -59,6 +85,9 @@ class DoConstantFolding : public Transform {
     /// If `true` then emit warnings
     bool warnings;
 
+    /// If not `nullptr`, subtrees the cache knows cannot fold are pruned.
+    ConstantFoldingCache* cache;
+
     /// Maps declaration constants to constant expressions
     std::map<const IR::Declaration_Constant*, const IR::Expression*> constants;
     // True if we are processing a left side of an assignment; we should not
@@ -103,12 +132,16 @@ class DoConstantFolding : public Transform {
     Result setContains(const IR::Expression* keySet, const IR::Expression* constant) const;
 
  public:
-    DoConstantFolding(const ReferenceMap* refMap, TypeMap* typeMap, bool warnings = true) :
-            refMap(refMap), typeMap(typeMap), typesKnown(typeMap != nullptr), warnings(warnings) {
+    DoConstantFolding(const ReferenceMap* refMap, TypeMap* typeMap, bool warnings = true,
+                      ConstantFoldingCache* cache = nullptr) :
+            refMap(refMap), typeMap(typeMap), typesKnown(typeMap != nullptr), warnings(warnings),
+            cache(cache) {
         visitDagOnce = true; setName("DoConstantFolding");
         assignmentTarget = false;
     }
 
+    const IR::Node* preorder(IR::Node* node) override;
+
     const IR::Node* postorder(IR::Declaration_Constant* d) override;
     const IR::Node* postorder(IR::PathExpression* e) override;
     const IR::Node* postorder(IR::Cmpl* e) override;
@@ -147,18 +180,54 @@ class DoConstantFolding : public Transform {
     const IR::Node* preorder(IR::ArrayIndex* e) override;
 };
 
+/** @brief Populates a ConstantFoldingCache after a typed folding pass.
+ *
+ * A subtree is "settled" -- and recorded in the cache -- if nothing under
+ * it can ever fold: all its folding is operand-driven, and this pass left
+ * it unchanged, so re-running folding on it is a no-op.  A subtree is
+ * poisoned by any node whose folding depends on state outside the subtree:
+ * a PathExpression that resolves (or might resolve) to a constant
+ * declaration, or a Declaration_Constant itself, which must be revisited so
+ * the declared value is registered for substitution.
+ */
+class MarkSettledSubtrees : public Inspector {
+    const ReferenceMap* refMap;
+    ConstantFoldingCache* cache;
+    /// One entry per node on the visitor path: true while nothing
+    /// name-dependent has been seen underneath it.
+    std::vector<bool> clean;
+
+    bool dependsOnNames(const IR::Node* node) const;
+    bool preorder(const IR::Node* node) override;
+    void postorder(const IR::Node* node) override;
+
+ public:
+    MarkSettledSubtrees(const ReferenceMap* refMap, ConstantFoldingCache* cache)
+            : refMap(refMap), cache(cache) {
+        CHECK_NULL(cache);
+        // shared nodes must be revisited in every position so each parent
+        // learns whether its subtree is clean
+        visitDagOnce = false;
+        setName("MarkSettledSubtrees");
+    }
+};
+
 /** Optionally runs @ref TypeChecking if @p typeMap is not
  *  `nullptr`, and then runs @ref DoConstantFolding.
  */
 class ConstantFolding : public PassManager {
  public:
     ConstantFolding(ReferenceMap* refMap, TypeMap* typeMap, bool warnings = true,
-            TypeChecking* typeChecking = nullptr) {
+            TypeChecking* typeChecking = nullptr, ConstantFoldingCache* cache = nullptr) {
         if (typeMap != nullptr) {
             if (!typeChecking)
                 typeChecking = new TypeChecking(refMap, typeMap);
             passes.push_back(typeChecking); }
-        passes.push_back(new DoConstantFolding(refMap, typeMap, warnings));
+        passes.push_back(new DoConstantFolding(refMap, typeMap, warnings, cache));
+        if (cache != nullptr && typeMap != nullptr)
+            // only a typed folding pass settles subtrees; an untyped one
+            // skips folds that a later typed pass would perform
+            passes.push_back(new MarkSettledSubtrees(refMap, cache));
         if (typeMap != nullptr)
             passes.push_back(new ClearTypeMap(typeMap));
         setName("ConstantFolding");
@@ -17,7 +17,8 @@ limitations under the License.
 #ifndef _FRONTENDS_COMMON_CONSTANTPARSING_H_
 #define _FRONTENDS_COMMON_CONSTANTPARSING_H_
 
-#include "lib/cstring.h"
+#include <iosfwd>
+#include <string>
 
 namespace IR {
 class Constant;
@@ -61,7 +62,12 @@ class SourceInfo;
  * false and providing a @skip length of 0.
  */
 struct UnparsedConstant {
-    cstring text;   /// Raw P4 text which was recognized as a numeric constant.
+    /// Raw P4 text which was recognized as a numeric constant.  Deliberately
+    /// not a cstring: literals are parsed once and their text is not needed
+    /// afterwards, so interning half a million of them into the permanent
+    /// string table buys nothing; short literals stay in the std::string's
+    /// inline buffer and never touch the heap at all.
+    std::string text;
     unsigned skip;  /// An ignored prefix of the numeric constant (e.g. '0x').
     unsigned base;  /// The base in which the constant is expressed.
     bool hasWidth;  /// If true, a bitwidth and separator are present.
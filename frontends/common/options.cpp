@@ -20,15 +20,22 @@ limitations under the License.
 #include <unistd.h>
 #include <unordered_set>
 #include <regex>
+#include <sstream>
 
 #include "options.h"
+#include "frontends/common/preprocessor.h"
+#include "lib/arena.h"
+#include "lib/async_writer.h"
+#include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
 #include "lib/nullstream.h"
 #include "lib/path.h"
+#include "lib/threadpool.h"
 #include "frontends/p4/toP4/toP4.h"
 #include "ir/json_generator.h"
+#include "ir/pass_manager.h"
 #include "frontends/p4/frontend.h"
 
 const char* p4includePath = CONFIG_PKGDATADIR "/p4include";
@@ -183,6 +190,13 @@ CompilerOptions::CompilerOptions() : Util::Options(defaultMessage) {
         }, "Report an error for a compiler diagnostic, or treat all warnings as "
            "errors if no diagnostic is specified.",
         OptionFlags::OptionalArgument);
+    registerOption("--Wdefer", nullptr,
+        [](const char *) {
+            P4CContext::get().errorReporter().setDeferWarnings(true);
+            return true;
+        }, "Defer warnings: record them during compilation and print them in "
+           "one batch at the end, after all pragmas that may suppress them "
+           "have been processed.");
     registerOption("--maxErrorCount", "errorCount",
                    [](const char *arg) {
                        auto maxError = strtoul(arg, nullptr, 10);
@@ -218,6 +232,67 @@ CompilerOptions::CompilerOptions() : Util::Options(defaultMessage) {
     registerOption("--ndebug", nullptr,
                    [this](const char*) { ndebug = true; return true; },
                   "Compile program in non-debug mode.\n");
+    registerOption("--compilation-cache", "dir",
+                   [this](const char* arg) { compilationCacheDir = arg; return true; },
+                   "Cache parse and frontend results in dir, keyed on the\n"
+                   "preprocessed source and the compilation options; unchanged\n"
+                   "inputs skip parsing and the frontend entirely. Note that\n"
+                   "cached programs lose source-level diagnostics detail.\n");
+    registerOption("--arena-alloc", nullptr,
+                   [](const char*) { Util::Arena::enable(); return true; },
+                   "Allocate IR nodes from arena regions instead of the\n"
+                   "garbage-collected heap; trades peak memory for the\n"
+                   "elimination of GC scan and pause time.\n");
+    registerOption("--gc-incremental", nullptr,
+                   [](const char*) { gc_enable_incremental(); return true; },
+                   "Collect incrementally: shorter pauses at some throughput\n"
+                   "cost.  Mainly useful with --compile-server, where one\n"
+                   "long stop-the-world pause can stall many queued jobs.\n");
+    registerOption("--gc-free-space-divisor", "n",
+                   [](const char* arg) {
+                       gc_set_free_space_divisor(strtoul(arg, nullptr, 10));
+                       return true; },
+                   "Collector heap growth policy: higher values keep the\n"
+                   "heap smaller at the cost of more frequent collections\n"
+                   "(the libgc default is 3).\n");
+    registerOption("--compile-server", "socket",
+                   [this](const char* arg) { compileServerSocket = arg; return true; },
+                   "Run as a long-lived compile server accepting jobs over\n"
+                   "the given unix socket instead of compiling once; see\n"
+                   "frontends/common/compileServer.h for the protocol.\n");
+    registerOption("--watch", nullptr,
+                   [](const char*) { return true; },
+                   "Stay resident after compiling and recompile whenever one\n"
+                   "of the program's source files changes; handled by the\n"
+                   "driver before option processing (see\n"
+                   "frontends/common/watch.h).\n");
+    registerOption("--pass-profile", "file",
+                   [](const char* arg) { PassProfiler::enable(arg); return true; },
+                   "[Compiler debugging] Record wall time, allocation, IR node\n"
+                   "creation and visit counts for every pass and write them to\n"
+                   "`file' as JSON when the compiler exits.\n");
+    registerOption("--memory-profile", "file",
+                   [](const char* arg) { MemoryProfiler::enable(arg); return true; },
+                   "[Compiler debugging] Record heap size and watermark after\n"
+                   "every pass, and periodically attribute the live IR to node\n"
+                   "types; written to `file' as JSON when the compiler exits.\n");
+    registerOption("--ir-stats", "file",
+                   [](const char* arg) { IRStatistics::enable(arg); return true; },
+                   "[Compiler debugging] Record the shape of the IR after every\n"
+                   "pass -- node counts by type, depth histogram, DAG sharing\n"
+                   "factor and estimated bytes -- written to `file' as JSON\n"
+                   "when the compiler exits.\n");
+    registerOption("--parallel-typecheck", nullptr,
+                   [this](const char*) { parallelTypecheck = true; return true; },
+                   "Type-check control and parser bodies on worker threads\n"
+                   "whenever type checking is re-run in read-only mode.\n");
+    registerOption("--maxThreads", "n",
+                   [this](const char* arg) {
+                       maxThreads = unsigned(strtoul(arg, nullptr, 10));
+                       Util::ThreadPool::configure(maxThreads);
+                       return true; },
+                   "Number of worker threads for parallel compilation phases;\n"
+                   "0 (the default) sizes the pool to the hardware.\n");
     registerOption("--excludeFrontendPasses", "pass1[,pass2]",
                    [this](const char* arg) {
                       excludeFrontendPasses = true;
@@ -321,6 +396,24 @@ FILE* CompilerOptions::preprocess() {
         file = "<stdin>";
         in = stdin;
     } else {
+        // Try the in-process preprocessor first: it avoids the fork/exec of
+        // the cpp subprocess and caches include files.  It refuses anything
+        // it does not fully understand, in which case we fall through to the
+        // subprocess below, which either handles the input or produces the
+        // proper diagnostic.
+        P4::Preprocessor builtin;
+        if (builtin.initFromOptions(preprocessor_options, isv1()) &&
+            builtin.preprocess(file, preprocessedSource)) {
+            if (Log::verbose())
+                std::cerr << "Preprocessed " << file << " in process" << std::endl;
+            in = fmemopen(preprocessedSource.empty() ? const_cast<char*>("")
+                                                     : &preprocessedSource[0],
+                          preprocessedSource.size(), "r");
+            if (in != nullptr)
+                mem_input = true;
+        }
+    }
+    if (in == nullptr && file != "<stdin>") {
 #ifdef __clang__
         std::string cmd("cc -E -x c -Wno-comment");
 #else
@@ -360,6 +453,10 @@ FILE* CompilerOptions::preprocess() {
 }
 
 void CompilerOptions::closeInput(FILE* inputStream) const {
+    if (mem_input) {
+        fclose(inputStream);
+        return;
+    }
     if (close_input) {
         int exitCode = pclose(inputStream);
         if (WIFEXITED(exitCode) && WEXITSTATUS(exitCode) == 4)
@@ -418,9 +515,12 @@ void CompilerOptions::dumpPass(const char* manager, unsigned seq, const char* pa
             if (stream != nullptr) {
                 if (Log::verbose())
                     std::cerr << "Writing program to " << fileName << std::endl;
-                P4::ToP4 toP4(stream, Log::verbose(), file);
+                // Pretty-print into a buffer and let the background writer
+                // do the I/O; the pass pipeline continues meanwhile.
+                std::stringstream buffer;
+                P4::ToP4 toP4(&buffer, Log::verbose(), file);
                 node->apply(toP4);
-                delete stream;  // close the file
+                Util::AsyncWriter::write(fileName, stream, buffer.str());
             }
             break;
         }
@@ -38,6 +38,10 @@ extern const char* p4_14includePath;
 // Each back-end should subclass this file.
 class CompilerOptions : public Util::Options {
     bool close_input = false;
+    // input came from the in-process preprocessor; the buffer below backs
+    // the FILE* that preprocess() returned
+    bool mem_input = false;
+    std::string preprocessedSource;
     static const char* defaultMessage;
 
     // annotation names that are to be ignored by the compiler
@@ -81,6 +85,14 @@ class CompilerOptions : public Util::Options {
     bool excludeFrontendPasses = false;
     bool listFrontendPasses = false;
 
+    // if true, read-only type checking runs control and parser bodies on
+    // worker threads (see ParallelTypeInference)
+    bool parallelTypecheck = false;
+
+    // worker count for the shared thread pool (Util::ThreadPool); 0 sizes
+    // the pool to the hardware
+    unsigned maxThreads = 0;
+
     // if true, skip midend passes whose names are contained in passesToExcludeMidend vector
     bool excludeMidendPasses = false;
     bool listMidendPasses = false;
@@ -120,6 +132,17 @@ class CompilerOptions : public Util::Options {
     // if this flag is true, compile program in non-debug mode
     bool ndebug = false;
 
+    // Directory holding the on-disk compilation cache; null disables caching.
+    cstring compilationCacheDir = nullptr;
+
+    // Digest of the preprocessed source + options, filled in by parseP4File
+    // when the compilation cache is enabled; used to key later cache phases.
+    cstring sourceDigest = nullptr;
+
+    // Unix socket to serve compile jobs on; handled by the driver's main()
+    // before normal option processing (see frontends/common/compileServer.h).
+    cstring compileServerSocket = nullptr;
+
     // strings matched against pass names that should be excluded from Frontend passes
     std::vector<cstring> passesToExcludeFrontend;
 
@@ -16,10 +16,14 @@ limitations under the License.
 
 #include "parseInput.h"
 
+#include <dirent.h>
+
 #include <boost/optional.hpp>
 #include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "frontends/parsers/parserDriver.h"
 #include "frontends/p4/fromv1.0/converters.h"
@@ -51,4 +55,32 @@ const IR::P4Program* parseP4String(const std::string& input,
     return parseP4String("(string)", 1, input, version);
 }
 
+void warmStandardLibrary() {
+    if (p4includePath == nullptr)
+        return;
+    DIR* dir = opendir(p4includePath);
+    if (dir == nullptr)
+        return;
+    // The parser consults the current compilation context for options and
+    // reports diagnostics against it; use a throwaway context so neither
+    // leaks into the jobs forked afterwards.
+    auto* context = new P4CContextWithOptions<CompilerOptions>;
+    AutoCompileContext autoContext(context);
+    auto& options = context->options();
+    options.langVersion = CompilerOptions::FrontendVersion::P4_16;
+    while (auto entry = readdir(dir)) {
+        cstring name = entry->d_name;
+        if (!name.endsWith(".p4"))
+            continue;
+        // Preprocess so headers that include other headers parse cleanly.
+        options.file = cstring(std::string(p4includePath) + "/" + entry->d_name);
+        FILE* in = options.preprocess();
+        if (in == nullptr)
+            continue;
+        P4ParserDriver::parse(in, options.file);
+        options.closeInput(in);
+    }
+    closedir(dir);
+}
+
 }  // namespace P4
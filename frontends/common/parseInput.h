@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef _FRONTENDS_COMMON_PARSEINPUT_H_
 #define _FRONTENDS_COMMON_PARSEINPUT_H_
 
+#include <sstream>
+
+#include "frontends/common/compileCache.h"
 #include "frontends/common/options.h"
 #include "frontends/parsers/parserDriver.h"
 #include "frontends/p4/fromv1.0/converters.h"
@@ -46,6 +49,10 @@ parseV1Program(Input& stream, const char* sourceFile, unsigned sourceLine,
     if (::errorCount() > 0 || v1 == nullptr)
         return nullptr;
 
+    // The pragmas were collected against the P4-14 tree; carry them over to
+    // the converted program so option pragmas are found without a tree scan.
+    auto optionPragmas = AbstractParserDriver::optionPragmasFor(v1);
+
     // Convert to P4-16.
     if (Log::verbose())
         std::cerr << "Converting to P4-16" << std::endl;
@@ -53,7 +60,10 @@ parseV1Program(Input& stream, const char* sourceFile, unsigned sourceLine,
     if (::errorCount() > 0 || v1 == nullptr)
         return nullptr;
     BUG_CHECK(v1->is<IR::P4Program>(), "Conversion returned %1%", v1);
-    return v1->to<IR::P4Program>();
+    auto program = v1->to<IR::P4Program>();
+    if (optionPragmas != nullptr)
+        AbstractParserDriver::bindOptionPragmas(program, optionPragmas);
+    return program;
 }
 
 /**
@@ -69,6 +79,9 @@ const IR::P4Program* parseP4File(CompilerOptions& options) {
     BUG_CHECK(&options == &P4CContext::get().options(),
               "Parsing using options that don't match the current "
               "compiler context");
+    // Comments are only read back when pretty-printing the program, so only
+    // that flow pays for capturing them during lexing.
+    Util::InputSources::captureComments(!options.prettyPrintFile.isNullOrEmpty());
     FILE* in = nullptr;
     if (options.doNotPreprocess) {
         in = fopen(options.file, "r");
@@ -83,6 +96,72 @@ const IR::P4Program* parseP4File(CompilerOptions& options) {
             return nullptr;
     }
 
+    if (CompileCache::enabled(options)) {
+        // Slurp the preprocessed source so it can be hashed; on a hit we
+        // skip parsing (and conversion, for P4-14 programs) entirely.
+        std::string source;
+        char buffer[16 * 1024];
+        size_t got;
+        while ((got = fread(buffer, 1, sizeof(buffer), in)) > 0)
+            source.append(buffer, got);
+        options.closeInput(in);
+        options.sourceDigest = CompileCache::computeDigest(options, source);
+        if (auto cached = CompileCache::lookup(options, options.sourceDigest, "parse"))
+            return cached;
+        const IR::P4Program* result = nullptr;
+        size_t stdlibLen = options.isv1() ? 0 : CompileCache::stdlibPrefixLength(source);
+        if (stdlibLen > 0) {
+            // Parse (or reload a snapshot of) the standard library headers
+            // separately, then splice their objects ahead of the user program.
+            std::string stdlibText = source.substr(0, stdlibLen);
+            cstring stdlibDigest = CompileCache::computeDigest(options, stdlibText);
+            auto stdlib = CompileCache::lookup(options, stdlibDigest, "stdlib");
+            if (stdlib == nullptr) {
+                std::istringstream stdlibStream(stdlibText);
+                stdlib = P4ParserDriver::parse(stdlibStream, options.file);
+                if (stdlib != nullptr && ::errorCount() == 0)
+                    CompileCache::store(options, stdlibDigest, "stdlib", stdlib);
+            }
+            if (stdlib != nullptr && ::errorCount() == 0) {
+                // Capture the stdlib's pragma list (if it was parsed rather
+                // than reloaded) before the next parse replaces the binding.
+                auto stdlibPragmas = AbstractParserDriver::optionPragmasFor(stdlib);
+                std::istringstream restStream(source.substr(stdlibLen));
+                auto rest = P4ParserDriver::parse(restStream, options.file, 1,
+                                                  CompileCache::declaredTypes(stdlib));
+                if (rest != nullptr && ::errorCount() == 0) {
+                    auto objects = stdlib->objects;
+                    objects.append(rest->objects);
+                    result = new IR::P4Program(rest->srcInfo, objects);
+                    // Bind the combined pragma lists to the spliced program;
+                    // if either half is missing, leave the program unbound and
+                    // option pragmas will be found by scanning it instead.
+                    auto restPragmas = AbstractParserDriver::optionPragmasFor(rest);
+                    if (stdlibPragmas != nullptr && restPragmas != nullptr) {
+                        auto combined = new IR::Vector<IR::Annotation>(*stdlibPragmas);
+                        combined->append(*restPragmas);
+                        AbstractParserDriver::bindOptionPragmas(result, combined);
+                    }
+                }
+            }
+        }
+        if (result == nullptr && ::errorCount() == 0) {
+            std::istringstream stream(source);
+            result = options.isv1()
+                        ? parseV1Program<std::istringstream, C>(stream, options.file, 1,
+                                                                options.getDebugHook())
+                        : P4ParserDriver::parse(stream, options.file);
+        }
+        if (::errorCount() > 0) {
+            ::error(ErrorType::ERR_OVERLIMIT,
+                    "%1% errors encountered, aborting compilation", ::errorCount());
+            return nullptr;
+        }
+        BUG_CHECK(result != nullptr, "Parsing failed, but we didn't report an error");
+        CompileCache::store(options, options.sourceDigest, "parse", result);
+        return result;
+    }
+
     auto result = options.isv1()
                 ? parseV1Program<FILE*, C>(in, options.file, 1, options.getDebugHook())
                 : P4ParserDriver::parse(in, options.file);
@@ -113,6 +192,18 @@ const IR::P4Program* parseP4String(const char* sourceFile, unsigned sourceLine,
 const IR::P4Program* parseP4String(const std::string& input,
                                    CompilerOptions::FrontendVersion version);
 
+/**
+ * Parse every P4 header under the standard include path (p4includePath),
+ * discarding the resulting IR.  This is a warmup step for the compile
+ * server: the parent process runs it once before forking jobs, so the
+ * populated shared string intern table and the grown collector heap are
+ * inherited copy-on-write by every job instead of being rebuilt from
+ * scratch each time.  Runs under a throwaway compilation
+ * context; parse errors are deliberately ignored, since a broken header
+ * will be diagnosed by the first job that actually includes it.
+ */
+void warmStandardLibrary();
+
 }  // namespace P4
 
 #endif /* _FRONTENDS_COMMON_PARSEINPUT_H_ */
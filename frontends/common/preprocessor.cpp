@@ -0,0 +1,504 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "preprocessor.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "lib/path.h"
+
+// defined in options.cpp
+extern const char* p4includePath;
+extern const char* p4_14includePath;
+
+namespace P4 {
+
+namespace {
+
+bool isIdentStart(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+bool isIdentChar(char c) {
+    return isIdentStart(c) || (c >= '0' && c <= '9'); }
+
+std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t");
+    return s.substr(b, e - b + 1); }
+
+/// Remove // and /* */ comments from a single (directive) line; fails if a
+/// block comment does not close on the line, which we leave to the external
+/// preprocessor rather than track across directives.
+bool stripLineComments(const std::string& line, std::string& out) {
+    for (size_t i = 0; i < line.size();) {
+        if (line[i] == '/' && i + 1 < line.size() && line[i + 1] == '/') break;
+        if (line[i] == '/' && i + 1 < line.size() && line[i + 1] == '*') {
+            size_t close = line.find("*/", i + 2);
+            if (close == std::string::npos) return false;
+            out += ' ';
+            i = close + 2;
+            continue; }
+        out += line[i++]; }
+    return true; }
+
+/// A tiny recursive-descent evaluator for the integer expressions that occur
+/// in #if/#elif once macros and defined() have been substituted away.
+struct ExprParser {
+    const std::string& s;
+    size_t pos = 0;
+    bool ok = true;
+    explicit ExprParser(const std::string& s) : s(s) {}
+
+    void ws() { while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t')) pos++; }
+    bool lit(const char* t) {
+        ws();
+        size_t n = strlen(t);
+        if (s.compare(pos, n, t) != 0) return false;
+        // don't let '<' match the start of '<=', or '&' of '&&'
+        if ((t[n - 1] == '<' || t[n - 1] == '>') && pos + n < s.size() && s[pos + n] == '=')
+            return false;
+        pos += n;
+        return true; }
+
+    long primary() {
+        ws();
+        if (pos >= s.size()) { ok = false; return 0; }
+        char c = s[pos];
+        if (c == '(') {
+            pos++;
+            long v = orExpr();
+            ws();
+            if (pos < s.size() && s[pos] == ')') pos++; else ok = false;
+            return v; }
+        if (c == '!') { pos++; return !primary(); }
+        if (c == '-') { pos++; return -primary(); }
+        if (c == '+') { pos++; return primary(); }
+        if (c >= '0' && c <= '9') {
+            char* end = nullptr;
+            long v = strtol(s.c_str() + pos, &end, 0);
+            pos = end - s.c_str();
+            // swallow integer suffixes cpp would accept
+            while (pos < s.size() && (s[pos] == 'u' || s[pos] == 'U' ||
+                                      s[pos] == 'l' || s[pos] == 'L')) pos++;
+            if (pos < s.size() && isIdentChar(s[pos])) ok = false;
+            return v; }
+        if (isIdentStart(c)) {
+            // an identifier that survived macro expansion is not a macro;
+            // cpp evaluates those as 0
+            while (pos < s.size() && isIdentChar(s[pos])) pos++;
+            return 0; }
+        ok = false;
+        return 0; }
+
+    long mulExpr() {
+        long v = primary();
+        for (;;) {
+            if (lit("*")) { v = v * primary(); continue; }
+            ws();
+            // '/' must not consume the start of a comment remnant
+            if (pos < s.size() && s[pos] == '/' &&
+                (pos + 1 >= s.size() || (s[pos + 1] != '/' && s[pos + 1] != '*'))) {
+                pos++;
+                long d = primary();
+                if (d == 0) { ok = false; return 0; }
+                v = v / d;
+                continue; }
+            if (lit("%")) {
+                long d = primary();
+                if (d == 0) { ok = false; return 0; }
+                v = v % d;
+                continue; }
+            return v; } }
+    long addExpr() {
+        long v = mulExpr();
+        for (;;) {
+            if (lit("+")) { v = v + mulExpr(); continue; }
+            if (lit("-")) { v = v - mulExpr(); continue; }
+            return v; } }
+    long cmpExpr() {
+        long v = addExpr();
+        for (;;) {
+            if (lit("==")) { v = v == addExpr(); continue; }
+            if (lit("!=")) { v = v != addExpr(); continue; }
+            if (lit("<=")) { v = v <= addExpr(); continue; }
+            if (lit(">=")) { v = v >= addExpr(); continue; }
+            if (lit("<")) { v = v < addExpr(); continue; }
+            if (lit(">")) { v = v > addExpr(); continue; }
+            return v; } }
+    long andExpr() {
+        long v = cmpExpr();
+        while (lit("&&")) v = cmpExpr() && v;
+        return v; }
+    long orExpr() {
+        long v = andExpr();
+        while (lit("||")) v = andExpr() || v;
+        return v; }
+
+    bool parse(long& result) {
+        result = orExpr();
+        ws();
+        return ok && pos == s.size(); }
+};
+
+}  // namespace
+
+bool Preprocessor::initFromOptions(cstring preprocessorOptions, bool isv1) {
+    // mirror the command line that CompilerOptions::preprocess builds for
+    // the external cpp: -I/-D/-U flags, the driver's environment include
+    // path, and finally the installed p4include directory
+    std::istringstream flags(preprocessorOptions.c_str());
+    std::string flag;
+    while (flags >> flag) {
+        if (flag.compare(0, 2, "-I") == 0 && flag.size() > 2) {
+            addSearchPath(flag.substr(2));
+        } else if (flag.compare(0, 2, "-D") == 0 && flag.size() > 2) {
+            std::string body = flag.substr(2);
+            size_t eq = body.find('=');
+            std::string name = eq == std::string::npos ? body : body.substr(0, eq);
+            if (name.find('(') != std::string::npos)
+                return false;  // function-like macro definition
+            define(name, eq == std::string::npos ? "1" : body.substr(eq + 1));
+        } else if (flag.compare(0, 2, "-U") == 0 && flag.size() > 2) {
+            undefine(flag.substr(2));
+        } else {
+            return false;  // a flag we cannot honor in process
+        } }
+    char* driverP4IncludePath =
+        isv1 ? getenv("P4C_14_INCLUDE_PATH") : getenv("P4C_16_INCLUDE_PATH");
+    if (driverP4IncludePath)
+        addSearchPath(driverP4IncludePath);
+    addSearchPath(isv1 ? p4_14includePath : p4includePath);
+    return true;
+}
+
+const std::string* Preprocessor::readFile(cstring path) {
+    auto it = fileCache.find(path);
+    if (it != fileCache.end())
+        return &it->second;
+    if (fileCacheMisses.count(path))
+        return nullptr;
+    std::ifstream input(path.c_str(), std::ios::binary);
+    if (!input) {
+        fileCacheMisses.insert(path);
+        return nullptr;
+    }
+    std::stringstream text;
+    text << input.rdbuf();
+    return &fileCache.emplace(path, text.str()).first->second;
+}
+
+cstring Preprocessor::resolveInclude(cstring name, bool quoted, cstring currentFile) {
+    if (quoted) {
+        // quoted includes are resolved against the including file first
+        auto folder = Util::PathName(currentFile).getFolder();
+        auto candidate = folder.join(name.c_str()).toString();
+        if (readFile(candidate) != nullptr)
+            return candidate;
+    }
+    for (auto dir : searchPath) {
+        auto candidate = Util::PathName(dir).join(name.c_str()).toString();
+        if (readFile(candidate) != nullptr)
+            return candidate;
+    }
+    return nullptr;
+}
+
+bool Preprocessor::preprocess(cstring file, std::string& out) {
+    auto* text = readFile(file);
+    if (text == nullptr)
+        return false;  // let the external preprocessor report the error
+    return preprocessSource(file, *text, out);
+}
+
+bool Preprocessor::preprocessSource(cstring sourceName, const std::string& text,
+                                    std::string& out) {
+    conditionals.clear();
+    inBlockComment = false;
+    includeDepth = 0;
+    out.clear();
+    out += "# 1 \"" + std::string(sourceName.c_str()) + "\"\n";
+    if (!processText(sourceName, text, out))
+        return false;
+    // an unbalanced #if or an unterminated comment is cpp's error to report
+    return conditionals.empty() && !inBlockComment;
+}
+
+bool Preprocessor::processText(cstring sourceName, const std::string& text, std::string& out) {
+    size_t condBase = conditionals.size();
+    size_t pos = 0;
+    unsigned lineno = 0;
+    while (pos <= text.size()) {
+        if (pos == text.size() && lineno > 0) break;
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) eol = text.size();
+        std::string line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+        lineno++;
+        // splice continuation lines, keeping the physical line count
+        unsigned extra = 0;
+        while (!line.empty() && line.back() == '\\' && pos <= text.size()) {
+            line.pop_back();
+            eol = text.find('\n', pos);
+            if (eol == std::string::npos) eol = text.size();
+            line += text.substr(pos, eol - pos);
+            pos = eol + 1;
+            lineno += 1;
+            extra += 1; }
+
+        bool active = conditionals.empty() || conditionals.back().active;
+        size_t firstNonSpace = line.find_first_not_of(" \t");
+        if (!inBlockComment && firstNonSpace != std::string::npos &&
+            line[firstNonSpace] == '#') {
+            if (!handleDirective(sourceName, lineno + 1, line.substr(firstNonSpace + 1), out))
+                return false;
+        } else if (active) {
+            if (!expandText(line, out, 0))
+                return false;
+            out += '\n';
+        } else {
+            // skipped lines still participate in comment nesting: a block
+            // comment opened in a dead branch hides the #endif from cpp too
+            std::string ignored;
+            (void)expandText(line, ignored, 0);  // only for the comment state
+            out += '\n';
+        }
+        for (unsigned i = 0; i < extra; i++) out += '\n';
+        if (pos > text.size()) break;
+    }
+    return conditionals.size() == condBase;
+}
+
+bool Preprocessor::handleDirective(cstring sourceName, unsigned resumeLine,
+                                   const std::string& rawLine, std::string& out) {
+    std::string stripped;
+    if (!stripLineComments(rawLine, stripped))
+        return false;
+    std::string line = trim(stripped);
+    size_t sp = 0;
+    while (sp < line.size() && isIdentChar(line[sp])) sp++;
+    std::string word = line.substr(0, sp);
+    std::string rest = trim(line.substr(sp));
+    bool active = conditionals.empty() || conditionals.back().active;
+
+    if (word == "ifdef" || word == "ifndef") {
+        size_t e = 0;
+        while (e < rest.size() && isIdentChar(rest[e])) e++;
+        if (e == 0) return false;
+        bool defined = macros.count(rest.substr(0, e)) > 0;
+        bool value = word == "ifdef" ? defined : !defined;
+        conditionals.push_back({active && value, !active || value, false});
+        out += '\n';
+        return true; }
+    if (word == "if") {
+        bool value = false;
+        if (active && !evalCondition(rest, value))
+            return false;
+        conditionals.push_back({active && value, !active || value, false});
+        out += '\n';
+        return true; }
+    if (word == "elif") {
+        if (conditionals.size() == 0 || conditionals.back().seenElse) return false;
+        auto& top = conditionals.back();
+        bool parent = conditionals.size() == 1 || conditionals[conditionals.size() - 2].active;
+        bool value = false;
+        if (parent && !top.anyTaken && !evalCondition(rest, value))
+            return false;
+        top.active = parent && !top.anyTaken && value;
+        top.anyTaken = top.anyTaken || top.active;
+        out += '\n';
+        return true; }
+    if (word == "else") {
+        if (conditionals.size() == 0 || conditionals.back().seenElse) return false;
+        auto& top = conditionals.back();
+        bool parent = conditionals.size() == 1 || conditionals[conditionals.size() - 2].active;
+        top.active = parent && !top.anyTaken;
+        top.anyTaken = true;
+        top.seenElse = true;
+        out += '\n';
+        return true; }
+    if (word == "endif") {
+        if (conditionals.size() == 0) return false;
+        conditionals.pop_back();
+        out += '\n';
+        return true; }
+
+    if (!active) {  // non-conditional directives in a dead branch are skipped
+        out += '\n';
+        return true; }
+
+    if (word == "define") {
+        size_t e = 0;
+        while (e < rest.size() && isIdentChar(rest[e])) e++;
+        if (e == 0) return false;
+        if (e < rest.size() && rest[e] == '(')
+            return false;  // function-like macros need the external cpp
+        macros[rest.substr(0, e)] = trim(rest.substr(e));
+        out += '\n';
+        return true; }
+    if (word == "undef") {
+        size_t e = 0;
+        while (e < rest.size() && isIdentChar(rest[e])) e++;
+        if (e == 0) return false;
+        macros.erase(rest.substr(0, e));
+        out += '\n';
+        return true; }
+    if (word == "include") {
+        bool quoted;
+        std::string name;
+        if (rest.size() > 2 && rest[0] == '"' && rest.back() == '"') {
+            quoted = true;
+            name = rest.substr(1, rest.size() - 2);
+        } else if (rest.size() > 2 && rest[0] == '<' && rest.back() == '>') {
+            quoted = false;
+            name = rest.substr(1, rest.size() - 2);
+        } else {
+            return false;  // computed includes need the external cpp
+        }
+        cstring resolved = resolveInclude(name, quoted, sourceName);
+        if (resolved == nullptr)
+            return false;  // let cpp produce the missing-file diagnostic
+        if (++includeDepth > 200)
+            return false;
+        auto* text = readFile(resolved);
+        out += "# 1 \"" + std::string(resolved.c_str()) + "\" 1\n";
+        bool ok = processText(resolved, *text, out);
+        includeDepth--;
+        if (!ok)
+            return false;
+        out += "# " + std::to_string(resumeLine) + " \"" +
+               std::string(sourceName.c_str()) + "\" 2\n";
+        return true; }
+    if (word == "line" || word == "pragma") {
+        // understood downstream; pass through unchanged
+        out += "#" + rawLine + "\n";
+        return true; }
+    if (word.empty()) {  // the null directive
+        out += '\n';
+        return true; }
+    // #error, #warning and anything unknown: the external cpp owns those
+    return false;
+}
+
+bool Preprocessor::expandText(const std::string& text, std::string& out, unsigned depth) {
+    if (depth > 64)
+        return false;
+    for (size_t i = 0; i < text.size();) {
+        char c = text[i];
+        if (inBlockComment) {
+            size_t close = text.find("*/", i);
+            if (close == std::string::npos) {
+                out.append(text, i, text.size() - i);
+                return true; }
+            out.append(text, i, close + 2 - i);
+            i = close + 2;
+            inBlockComment = false;
+            continue; }
+        if (c == '/' && i + 1 < text.size() && text[i + 1] == '/') {
+            out.append(text, i, text.size() - i);
+            return true; }
+        if (c == '/' && i + 1 < text.size() && text[i + 1] == '*') {
+            inBlockComment = true;
+            out += "/*";
+            i += 2;
+            continue; }
+        if (c == '"') {  // no expansion inside string literals
+            out += c;
+            i++;
+            while (i < text.size()) {
+                out += text[i];
+                if (text[i] == '\\' && i + 1 < text.size()) {
+                    out += text[i + 1];
+                    i += 2;
+                    continue; }
+                if (text[i] == '"') { i++; break; }
+                i++; }
+            continue; }
+        if (c >= '0' && c <= '9') {  // a number, including width prefixes like 8w15
+            while (i < text.size() && isIdentChar(text[i])) out += text[i++];
+            continue; }
+        if (isIdentStart(c)) {
+            size_t b = i;
+            while (i < text.size() && isIdentChar(text[i])) i++;
+            std::string name = text.substr(b, i - b);
+            if (name.compare(0, 2, "__") == 0 && macros.count(name) == 0)
+                return false;  // __LINE__ and friends: not worth emulating
+            auto it = macros.find(name);
+            if (it == macros.end() || expanding.count(name)) {
+                out.append(name);
+                continue; }
+            // rescan the replacement, hiding the macro from itself
+            expanding.insert(name);
+            bool saved = inBlockComment;
+            inBlockComment = false;
+            bool ok = expandText(it->second, out, depth + 1);
+            inBlockComment = saved;
+            expanding.erase(name);
+            if (!ok)
+                return false;
+            continue; }
+        out += c;
+        i++; }
+    return true;
+}
+
+bool Preprocessor::evalCondition(const std::string& text, bool& result) {
+    // substitute defined(NAME) and defined NAME before macro expansion
+    std::string subst;
+    for (size_t i = 0; i < text.size();) {
+        if (isIdentStart(text[i])) {
+            size_t b = i;
+            while (i < text.size() && isIdentChar(text[i])) i++;
+            std::string name = text.substr(b, i - b);
+            if (name != "defined") {
+                subst += name;
+                continue; }
+            size_t j = i;
+            while (j < text.size() && (text[j] == ' ' || text[j] == '\t')) j++;
+            bool paren = j < text.size() && text[j] == '(';
+            if (paren) {
+                j++;
+                while (j < text.size() && (text[j] == ' ' || text[j] == '\t')) j++; }
+            size_t nb = j;
+            while (j < text.size() && isIdentChar(text[j])) j++;
+            if (j == nb) return false;
+            std::string arg = text.substr(nb, j - nb);
+            if (paren) {
+                while (j < text.size() && (text[j] == ' ' || text[j] == '\t')) j++;
+                if (j >= text.size() || text[j] != ')') return false;
+                j++; }
+            subst += macros.count(arg) ? "1" : "0";
+            i = j;
+            continue; }
+        subst += text[i++]; }
+
+    std::string expanded;
+    bool saved = inBlockComment;
+    inBlockComment = false;
+    bool ok = expandText(subst, expanded, 0);
+    inBlockComment = saved;
+    if (!ok)
+        return false;
+    long value = 0;
+    if (!ExprParser(expanded).parse(value))
+        return false;
+    result = value != 0;
+    return true;
+}
+
+}  // namespace P4
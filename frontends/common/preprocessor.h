@@ -0,0 +1,97 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef FRONTENDS_COMMON_PREPROCESSOR_H_
+#define FRONTENDS_COMMON_PREPROCESSOR_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "lib/cstring.h"
+
+namespace P4 {
+
+/**
+ * A small in-process preprocessor covering the subset of cpp that P4
+ * programs actually use: #include (quoted and angled, with the include
+ * files cached for the duration of the compile), object-like #define,
+ * #undef, and the #if/#ifdef family with integer expressions.  Line
+ * markers in the GNU cpp style are emitted so source positions in the
+ * parsed program are unaffected.
+ *
+ * Anything outside that subset -- function-like macros, unknown
+ * directives, expressions we cannot evaluate -- makes preprocess()
+ * return false without reporting anything; the caller then falls back
+ * to the external preprocessor, which either handles the input or
+ * produces the proper diagnostic.  This is what lets parseP4File skip
+ * the fork/exec of the cpp subprocess for the common case.
+ */
+class Preprocessor final {
+ public:
+    /// Configure search paths and predefined macros from the -I/-D/-U flags
+    /// accumulated in CompilerOptions::preprocessor_options, the driver's
+    /// environment include path and the installed p4include directory;
+    /// @return false if the flags contain anything this class does not
+    /// understand.
+    bool initFromOptions(cstring preprocessorOptions, bool isv1);
+
+    /// Append a directory to the include search path.
+    void addSearchPath(cstring dir) { searchPath.push_back(dir); }
+    /// Predefine an object-like macro.
+    void define(cstring name, const std::string& body) { macros[name] = body; }
+    void undefine(cstring name) { macros.erase(name); }
+
+    /// Expand @file into @out.  @return false if the input needs the
+    /// external preprocessor; @out is unspecified in that case.
+    bool preprocess(cstring file, std::string& out);
+
+    /// Expand in-memory @text, as if read from @sourceName; #includes are
+    /// still resolved against the search path.  Used by preprocess() and
+    /// directly by tests.
+    bool preprocessSource(cstring sourceName, const std::string& text, std::string& out);
+
+ private:
+    struct CondState {
+        bool active;    // the current branch is being emitted
+        bool anyTaken;  // some branch of this #if chain was taken
+        bool seenElse;
+    };
+
+    const std::string* readFile(cstring path);
+    cstring resolveInclude(cstring name, bool quoted, cstring currentFile);
+    bool processText(cstring sourceName, const std::string& text, std::string& out);
+    bool handleDirective(cstring sourceName, unsigned lineno,
+                         const std::string& line, std::string& out);
+    bool expandText(const std::string& text, std::string& out, unsigned depth);
+    bool evalCondition(const std::string& text, bool& result);
+
+    std::map<cstring, std::string> macros;
+    std::vector<cstring> searchPath;
+    /// Include files read so far, so headers pulled in repeatedly (or by
+    /// several compiles sharing this object) are read from disk only once.
+    std::map<cstring, std::string> fileCache;
+    std::set<cstring> fileCacheMisses;
+    std::set<cstring> expanding;  // macros being rescanned, hidden from themselves
+    std::vector<CondState> conditionals;
+    bool inBlockComment = false;
+    unsigned includeDepth = 0;
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_PREPROCESSOR_H_ */
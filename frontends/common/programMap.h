@@ -24,6 +24,10 @@ namespace P4 {
 // Base class for various maps.
 // A map is computed on a certain P4Program.
 // If the program has not changed, the map is up-to-date.
+// The root pointer doubles as a version stamp: Transforms and Modifiers
+// return the original node when they did not actually replace anything
+// (see ChangeTracker::finish), so a different root implies some pass
+// really changed the tree since the map was computed.
 class ProgramMap : public IHasDbPrint {
  protected:
     const IR::P4Program* program = nullptr;
@@ -56,6 +60,8 @@ class ProgramMap : public IHasDbPrint {
         program = node->to<IR::P4Program>();
         LOG2(mapKind << " updated to " << dbp(node));
     }
+    /// @returns the program this map was last computed for, or nullptr.
+    const IR::P4Program* getProgram() const { return program; }
 };
 
 }  // namespace P4
@@ -14,9 +14,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <memory>
 #include <sstream>
 #include "referenceMap.h"
 #include "frontends/p4/reservedWords.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
 
 namespace P4 {
 
@@ -31,20 +34,75 @@ void ReferenceMap::clear() {
     usedNames.clear();
     used.clear();
     thisToDeclaration.clear();
+    // Reset the counters with the used-name set they shadow: within one
+    // resolve round the counter yields the same suffix a probe from zero
+    // would, so generated names match the historical ones byte for byte,
+    // while repeated newName calls inside the round stay amortized O(1).
+    nameCounters.clear();
     usedNames.insert(P4::reservedWords.begin(), P4::reservedWords.end());
 }
 
+std::function<void()> ReferenceMap::checkpoint() {
+    // the closure may be invoked once per backtrack retry, so it must not
+    // consume the snapshot when restoring
+    auto saved = std::make_shared<ReferenceMap>(*this);
+    return [this, saved]() { *this = *saved; };
+}
+
+void ReferenceMap::toJSON(JSONGenerator& json) const {
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> paths;
+    pathToDeclaration.forall([&paths](const PathEntry &e) {
+        if (e.path != nullptr && e.decl != nullptr)
+            paths.emplace_back(e.path, e.decl->getNode()); });
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> thisDecls;
+    for (auto& e : thisToDeclaration)
+        thisDecls.emplace_back(e.first, e.second->getNode());
+    json << json.indent << "\"isv1\" : " << isv1 << "," << std::endl;
+    json << json.indent << "\"pathToDeclaration\" : " << paths << "," << std::endl;
+    json << json.indent << "\"thisToDeclaration\" : " << thisDecls << "," << std::endl;
+    json << json.indent << "\"usedNames\" : " << usedNames;
+}
+
+void ReferenceMap::loadFromJSON(JSONLoader& loader) {
+    clear();
+    loader.load("isv1", isv1);
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> paths;
+    loader.load("pathToDeclaration", paths);
+    for (auto& e : paths) {
+        // setDeclaration also repopulates `used` and the path names
+        auto path = e.first != nullptr ? e.first->to<IR::Path>() : nullptr;
+        auto decl = e.second != nullptr ? e.second->to<IR::IDeclaration>() : nullptr;
+        if (path != nullptr && decl != nullptr)
+            setDeclaration(path, decl);
+    }
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> thisDecls;
+    loader.load("thisToDeclaration", thisDecls);
+    for (auto& e : thisDecls) {
+        auto pointer = e.first != nullptr ? e.first->to<IR::This>() : nullptr;
+        auto decl = e.second != nullptr ? e.second->to<IR::IDeclaration>() : nullptr;
+        if (pointer != nullptr && decl != nullptr)
+            setDeclaration(pointer, decl);
+    }
+    loader.load("usedNames", usedNames);
+    LOG2("Loaded ReferenceMap with " << paths.size() << " resolutions");
+}
+
 void ReferenceMap::setDeclaration(const IR::Path* path, const IR::IDeclaration* decl) {
     CHECK_NULL(path);
     CHECK_NULL(decl);
     LOG3("Resolved " << dbp(path) << " to " << dbp(decl));
-    auto previous = get(pathToDeclaration, path);
-    if (previous != nullptr && previous != decl)
-        BUG("%1% already resolved to %2% instead of %3%",
-            dbp(path), dbp(previous), dbp(decl->getNode()));
-    pathToDeclaration.emplace(path, decl);
+    auto &entry = pathToDeclaration[path->id];
+    if (entry.decl != nullptr && entry.decl != decl) {
+        if (!overwrite)
+            BUG("%1% already resolved to %2% instead of %3%",
+                dbp(path), dbp(entry.decl), dbp(decl->getNode()));
+        // stale entry from the program this map was last computed for
+        LOG3("Replacing " << dbp(entry.decl) << " with " << dbp(decl) << " for " << dbp(path));
+    }
+    entry.path = path;
+    entry.decl = decl;
     usedName(path->name.name);
-    used.insert(decl);
+    used[decl->getNode()->id] = true;
 }
 
 void ReferenceMap::setDeclaration(const IR::This* pointer, const IR::IDeclaration* decl) {
@@ -52,10 +110,33 @@ void ReferenceMap::setDeclaration(const IR::This* pointer, const IR::IDeclaratio
     CHECK_NULL(decl);
     LOG3("Resolved " << dbp(pointer) << " to " << dbp(decl));
     auto previous = get(thisToDeclaration, pointer);
-    if (previous != nullptr && previous != decl)
-        BUG("%1% already resolved to %2% instead of %3%",
-            dbp(pointer), dbp(previous), dbp(decl));
-    thisToDeclaration.emplace(pointer, decl);
+    if (previous != nullptr && previous != decl) {
+        if (!overwrite)
+            BUG("%1% already resolved to %2% instead of %3%",
+                dbp(pointer), dbp(previous), dbp(decl));
+        LOG3("Replacing " << dbp(previous) << " with " << dbp(decl) << " for " << dbp(pointer));
+        thisToDeclaration.find(pointer)->second = decl;
+    } else {
+        thisToDeclaration.emplace(pointer, decl);
+    }
+}
+
+void ReferenceMap::patchDeclaration(const IR::IDeclaration* old, const IR::IDeclaration* repl) {
+    CHECK_NULL(old);
+    CHECK_NULL(repl);
+    LOG3("Patching " << dbp(old->getNode()) << " to " << dbp(repl->getNode()));
+    pathToDeclaration.forall([old, repl](PathEntry &e) {
+        if (e.decl == old)
+            e.decl = repl; });
+    for (auto &e : thisToDeclaration)
+        if (e.second == old)
+            e.second = repl;
+    if (auto u = used.find(old->getNode()->id)) {
+        if (*u) {
+            *u = false;
+            used[repl->getNode()->id] = true;
+        }
+    }
 }
 
 const IR::IDeclaration* ReferenceMap::getDeclaration(const IR::This* pointer, bool notNull) const {
@@ -74,7 +155,8 @@ const IR::IDeclaration* ReferenceMap::getDeclaration(const IR::This* pointer, bo
 
 const IR::IDeclaration* ReferenceMap::getDeclaration(const IR::Path* path, bool notNull) const {
     CHECK_NULL(path);
-    auto result = get(pathToDeclaration, path);
+    auto entry = pathToDeclaration.find(path->id);
+    auto result = entry != nullptr ? entry->decl : nullptr;
 
     if (result)
         LOG3("Looking up " << dbp(path) << " found " << dbp(result));
@@ -87,10 +169,14 @@ const IR::IDeclaration* ReferenceMap::getDeclaration(const IR::Path* path, bool
 }
 
 void ReferenceMap::dbprint(std::ostream &out) const {
-    if (pathToDeclaration.empty())
+    bool empty = true;
+    pathToDeclaration.forall([&out, &empty](const PathEntry &e) {
+        if (e.decl == nullptr)
+            return;
+        empty = false;
+        out << dbp(e.path) << "->" << dbp(e.decl) << std::endl; });
+    if (empty)
         out << "Empty" << std::endl;
-    for (auto e : pathToDeclaration)
-        out << dbp(e.first) << "->" << dbp(e.second) << std::endl;
 }
 
 cstring ReferenceMap::newName(cstring base) {
@@ -107,7 +193,7 @@ cstring ReferenceMap::newName(cstring base) {
     if (len > 0 && base[len - 1] == '_')
         base = base.substr(0, len - 1);
 
-    cstring name = cstring::make_unique(usedNames, base, '_');
+    cstring name = cstring::make_unique(usedNames, nameCounters, base, '_');
     usedNames.insert(name);
     return name;
 }
@@ -126,7 +212,7 @@ cstring MinimalNameGenerator::newName(cstring base) {
     if (len > 0 && base[len - 1] == '_')
         base = base.substr(0, len - 1);
 
-    cstring name = cstring::make_unique(usedNames, base, '_');
+    cstring name = cstring::make_unique(usedNames, nameCounters, base, '_');
     usedNames.insert(name);
     return name;
 }
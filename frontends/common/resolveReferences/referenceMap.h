@@ -18,10 +18,16 @@ limitations under the License.
 #define _COMMON_RESOLVEREFERENCES_REFERENCEMAP_H_
 
 #include "ir/ir.h"
+#include "ir/pass_manager.h"
+#include "ir/visitor.h"
 #include "lib/cstring.h"
 #include "lib/map.h"
+#include "lib/ordered_flat_map.h"
 #include "frontends/common/programMap.h"
 
+class JSONGenerator;
+class JSONLoader;
+
 namespace P4 {
 
 class NameGenerator {
@@ -32,6 +38,8 @@ class NameGenerator {
 // replacement for ReferenceMap NameGenerator to make it easier to remove uses of refMap
 class MinimalNameGenerator : public NameGenerator, public Inspector {
     std::set<cstring> usedNames;
+    /// Next suffix to try for each base name; see cstring::make_unique.
+    std::map<cstring, int> nameCounters;
     void usedName(cstring name) { usedNames.insert(name); }
     void postorder(const IR::Path *p) override { usedName(p->name.name); }
     void postorder(const IR::Type_Declaration *t) override { usedName(t->name.name); }
@@ -58,23 +66,47 @@ class DeclarationLookup {
 };
 
 /// Class used to encode maps from paths to declarations.
-class ReferenceMap final : public ProgramMap, public NameGenerator, public DeclarationLookup {
+class ReferenceMap final : public ProgramMap, public NameGenerator, public DeclarationLookup,
+                           public ICheckpointable {
     /// If `isv1` is true, then the map is for a P4_14 program
     /// (possibly translated into P4_16).
     bool isv1;
 
-    /// Maps paths in the program to declarations.
-    std::map<const IR::Path*, const IR::IDeclaration*> pathToDeclaration;
-
-    /// Set containing all declarations in the program.
-    std::set<const IR::IDeclaration*> used;
+    /// Maps paths in the program to declarations, indexed directly by the
+    /// Path's node id.  Node ids are dense and monotonic, so the lookup in
+    /// getDeclaration -- the hottest query on this map -- is two loads with
+    /// no hashing or comparisons; only the id ranges that actually contain
+    /// Paths get a chunk allocated.  The entry keeps the Path itself so the
+    /// map can still be enumerated (dbprint, patchDeclaration); a null decl
+    /// means the slot was never set.
+    struct PathEntry {
+        const IR::Path* path = nullptr;
+        const IR::IDeclaration* decl = nullptr;
+    };
+    NodeIdInfoMap<PathEntry> pathToDeclaration;
+
+    /// Declarations used in the program, indexed by declaration node id.
+    NodeIdInfoMap<bool> used;
 
     /// Map from `This` to declarations (an experimental feature).
-    std::map<const IR::This*, const IR::IDeclaration*> thisToDeclaration;
+    ordered_flat_map<const IR::This*, const IR::IDeclaration*> thisToDeclaration;
 
     /// Set containing all names used in the program.
     std::set<cstring> usedNames;
 
+    /// Next suffix to try for each base name passed to newName; see
+    /// cstring::make_unique.  Reset together with usedNames by clear(), so
+    /// a fresh resolve round produces exactly the names a probe from zero
+    /// would; within a round the counter makes repeated newName calls on
+    /// the same base amortized O(1) instead of quadratic.
+    std::map<cstring, int> nameCounters;
+
+    /// If true, setDeclaration may revise an existing resolution instead of
+    /// treating the change as a bug.  Set while an incremental
+    /// ResolveReferences is patching the map computed for a previous version
+    /// of the program, where entries for reused nodes may be stale.
+    bool overwrite = false;
+
  public:
     ReferenceMap();
     /// Looks up declaration for @p path. If @p notNull is false, then
@@ -93,6 +125,15 @@ class ReferenceMap final : public ProgramMap, public NameGenerator, public Decla
     /// Sets declaration for @p pointer to @p decl.
     void setDeclaration(const IR::This* pointer, const IR::IDeclaration* decl);
 
+    /// Replaces every resolution to @p old by @p repl; used by incremental
+    /// reference resolution when a declaration is rewritten but the (shared)
+    /// subtrees referring to it are not revisited.
+    void patchDeclaration(const IR::IDeclaration* old, const IR::IDeclaration* repl);
+
+    /// Allow (or stop allowing) setDeclaration to overwrite existing entries;
+    /// see `overwrite`.
+    void allowOverwrites(bool allow) { overwrite = allow; }
+
     void dbprint(std::ostream& cout) const override;
 
     /// Set boolean indicating whether map is for a P4_14 program to @p isV1.
@@ -105,11 +146,26 @@ class ReferenceMap final : public ProgramMap, public NameGenerator, public Decla
     /// Clear the reference map
     void clear();
 
+    /// Snapshot for PassManager::checkpoint: the returned closure restores
+    /// the map's current contents.
+    std::function<void()> checkpoint() override;
+
+    /// Serialize the map contents through @p json, as id references into the
+    /// program @p json has already written.  Part of the analysis snapshot
+    /// carried by binary IR dumps.
+    void toJSON(JSONGenerator& json) const;
+    /// Repopulate from @p loader, which must share node references with the
+    /// loader that produced the program this map describes.
+    void loadFromJSON(JSONLoader& loader);
+
     /// @returns @true if this map is for a P4_14 program
     bool isV1() const { return isv1; }
 
     /// @returns @true if @p decl is used in the program.
-    bool isUsed(const IR::IDeclaration* decl) const { return used.count(decl) > 0; }
+    bool isUsed(const IR::IDeclaration* decl) const {
+        auto u = used.find(decl->getNode()->id);
+        return u != nullptr && *u;
+    }
 
     /// Indicate that @p name is used in the program.
     void usedName(cstring name) { usedNames.insert(name); }
@@ -18,6 +18,8 @@ limitations under the License.
 #include <boost/range/adaptor/reversed.hpp>
 #include <sstream>
 #include "frontends/common/options.h"
+#include "ir/pass_manager.h"
+#include "lib/view.h"
 
 namespace P4 {
 
@@ -44,28 +46,29 @@ ResolutionContext::lookup(const IR::INamespace *current, IR::ID name,
     LOG2("Trying to resolve in " << current->toString());
 
     if (auto gen = current->to<IR::IGeneralNamespace>()) {
-        Util::Enumerator<const IR::IDeclaration*> *decls = gen->getDeclsByName(name);
-        switch (type) {
-            case P4::ResolutionType::Any:
-                break;
-            case P4::ResolutionType::Type: {
-                std::function<bool(const IR::IDeclaration*)> kindFilter =
-                        [](const IR::IDeclaration *d) {
-                    return d->is<IR::Type>(); };
-                decls = decls->where(kindFilter);
-                break; }
-            case P4::ResolutionType::TypeVariable: {
-                std::function<bool(const IR::IDeclaration*)> kindFilter =
-                        [](const IR::IDeclaration *d) {
-                return d->is<IR::Type_Var>(); };
-                decls = decls->where(kindFilter);
-                break; }
-        default:
-            BUG("Unexpected enumeration value %1%", static_cast<int>(type)); }
-
-        if (!anyOrder && name.srcInfo.isValid()) {
-            std::function<bool(const IR::IDeclaration*)> locationFilter =
-                    [this, name, type](const IR::IDeclaration *d) {
+        // A single inlined pass over the declarations; the predicate fuses
+        // the name, kind and location checks that used to be a chain of
+        // virtual filter enumerators.  This is the hottest loop in
+        // reference resolution.
+        bool checkLocation = !anyOrder && name.srcInfo.isValid();
+        auto matching = Util::Views::filter(*gen->getDeclarations(),
+                [this, name, type, checkLocation](const IR::IDeclaration *d) -> bool {
+            CHECK_NULL(d);
+            if (name.name != d->getName().name)
+                return false;
+            switch (type) {
+                case P4::ResolutionType::Any:
+                    break;
+                case P4::ResolutionType::Type:
+                    if (!d->is<IR::Type>()) return false;
+                    break;
+                case P4::ResolutionType::TypeVariable:
+                    if (!d->is<IR::Type_Var>()) return false;
+                    break;
+                default:
+                    BUG("Unexpected enumeration value %1%", static_cast<int>(type)); }
+
+            if (checkLocation) {
                 if (d->is<IR::Type_Var>() || d->is<IR::ParserState>())
                     // type vars and parser states may be used before their definitions
                     return true;
@@ -84,11 +87,12 @@ ResolutionContext::lookup(const IR::INamespace *current, IR::ID name,
                     if (auto *decl_ctxt = findContext<IR::Declaration>())
                         if (decl_ctxt->getNode() == d->getNode())
                             before = false; }
+                return before; }
+            return true; });
 
-                return before; };
-            decls = decls->where(locationFilter); }
-
-        auto vector = decls->toVector();
+        auto vector = new std::vector<const IR::IDeclaration*>();
+        for (auto *d : matching)
+            vector->push_back(d);
         if (!vector->empty()) {
             LOG3("Resolved in " << dbp(current->getNode()));
             return vector; }
@@ -186,13 +190,16 @@ ResolutionContext::resolveUnique(IR::ID name,
     // Check overloaded symbols.
     const IR::Vector<IR::Argument> *arguments;
     if (decls->size() > 1 && (arguments = methodArguments(name))) {
-        decls = Util::Enumerator<const IR::IDeclaration*>::createEnumerator(*decls)->
-                where([arguments](const IR::IDeclaration* d) {
+        auto matching = Util::Views::filter(*decls,
+                [arguments](const IR::IDeclaration* d) {
                         auto func = d->to<IR::IFunctional>();
                         if (func == nullptr)
                             return true;
-                        return func->callMatches(arguments); })->
-                toVector();
+                        return func->callMatches(arguments); });
+        auto filtered = new std::vector<const IR::IDeclaration*>();
+        for (auto *d : matching)
+            filtered->push_back(d);
+        decls = filtered;
     }
 
     if (decls->empty()) {
@@ -254,8 +261,8 @@ ResolutionContext::resolveType(const IR::Type *type) const {
     return type;
 }
 
-ResolveReferences::ResolveReferences(ReferenceMap *refMap, bool checkShadow)
-: refMap(refMap), checkShadow(checkShadow) {
+ResolveReferences::ResolveReferences(ReferenceMap *refMap, bool checkShadow, bool incremental)
+: refMap(refMap), checkShadow(checkShadow), incremental(incremental) {
     CHECK_NULL(refMap);
     setName("ResolveReferences");
     visitDagOnce = false;
@@ -332,14 +339,92 @@ void ResolveReferences::checkShadowing(const IR::INamespace *ns) const {
     }
 }
 
+/// Try to patch the existing map instead of rebuilding it from scratch.
+/// Since IR nodes are immutable, a top-level object that is pointer-identical
+/// to one in the program the map was computed for is an entirely unchanged
+/// subtree: every resolution inside it is already in the map and still
+/// correct, provided the global declarations it may refer to did not change
+/// either.  For each top-level declaration that was replaced we therefore
+/// look for its rewritten version (same node type, name and position) and
+/// patch the map entries pointing to it; match kinds are patched member by
+/// member, since lookupMatchKind searches all match_kind declarations by
+/// name.  Declarations that were added (rather than replacing an old one) are
+/// assumed to carry fresh names, as produced by newName.
+/// @returns false -- leaving the caller to fall back to a full resolution --
+/// for any change this analysis cannot prove safe: a used declaration that
+/// disappeared, an ambiguous replacement for an overloaded name, or a
+/// declaration that moved in the source (which may change what is visible at
+/// its uses).  On failure the map may have been partially patched, so it must
+/// be cleared.
+bool ResolveReferences::computeChanges(const IR::P4Program *program) {
+    const IR::P4Program *previous = refMap->getProgram();
+    if (previous == nullptr)
+        return false;
+    // When the pass history describes the change, give up early if most of
+    // the top-level declarations were replaced: patching them one by one
+    // costs more than a full resolution would.
+    std::set<cstring> dirty;
+    if (DirtyRegions::changedSince(previous, program, &dirty) &&
+        dirty.size() * 2 > program->objects.size())
+        return false;
+    std::set<const IR::Node *> oldObjects(previous->objects.begin(), previous->objects.end());
+    for (auto *obj : program->objects)
+        if (oldObjects.count(obj))
+            unchanged.insert(obj);
+    for (auto *oldObj : previous->objects) {
+        if (unchanged.count(oldObj)) continue;  // still in the program
+        if (auto *oldMk = oldObj->to<IR::Declaration_MatchKind>()) {
+            for (auto *oldm : oldMk->members) {
+                const IR::IDeclaration *replm = nullptr;
+                for (auto *obj : program->objects)
+                    if (auto *mk = obj->to<IR::Declaration_MatchKind>())
+                        if ((replm = mk->members.getDeclaration(oldm->name)))
+                            break;
+                if (replm == nullptr) {
+                    if (refMap->isUsed(oldm)) return false;  // dangling references
+                } else if (replm != oldm) {
+                    refMap->patchDeclaration(oldm, replm); } }
+            continue; }
+        auto *decl = oldObj->to<IR::IDeclaration>();
+        if (decl == nullptr)
+            return false;  // no idea how references to it behave
+        const IR::IDeclaration *repl = nullptr;
+        for (auto *obj : program->objects) {
+            if (unchanged.count(obj)) continue;
+            if (obj->node_type_name() != oldObj->node_type_name()) continue;
+            auto *d = obj->to<IR::IDeclaration>();
+            if (d == nullptr || d->getName() != decl->getName()) continue;
+            if (repl != nullptr) return false;  // ambiguous -- overloaded name
+            repl = d; }
+        if (repl == nullptr) {
+            if (refMap->isUsed(decl)) return false;  // dangling references
+            continue; }
+        if (!anyOrder && !(repl->getNode()->srcInfo == oldObj->srcInfo))
+            return false;  // moved; the position-based visibility tests may differ
+        refMap->patchDeclaration(decl, repl);
+    }
+    return true;
+}
+
 Visitor::profile_t ResolveReferences::init_apply(const IR::Node *node) {
     anyOrder = refMap->isV1();
-    if (!refMap->checkMap(node))
-        refMap->clear();
+    unchanged.clear();
+    if (!refMap->checkMap(node)) {
+        const IR::P4Program *program = incremental ? node->to<IR::P4Program>() : nullptr;
+        if (program != nullptr && computeChanges(program)) {
+            LOG2("Patching " << unchanged.size() << " unchanged top-level objects");
+            refMap->allowOverwrites(true);
+        } else {
+            unchanged.clear();  // computeChanges may have partially filled it
+            refMap->clear();
+        }
+    }
     return Inspector::init_apply(node);
 }
 
 void ResolveReferences::end_apply(const IR::Node *node) {
+    refMap->allowOverwrites(false);
+    unchanged.clear();
     refMap->updateMap(node);
 }
 
@@ -348,6 +433,13 @@ void ResolveReferences::end_apply(const IR::Node *node) {
 bool ResolveReferences::preorder(const IR::P4Program *program) {
     if (refMap->checkMap(program))
         return false;
+    if (!unchanged.empty()) {
+        // incremental update: only the replaced or added objects need a visit
+        for (auto *obj : program->objects)
+            if (!unchanged.count(obj))
+                visit(obj);
+        return false;
+    }
     return true;
 }
 
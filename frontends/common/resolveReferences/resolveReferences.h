@@ -81,6 +81,11 @@ class ResolutionContext : virtual public Visitor, public DeclarationLookup {
  *
  * @post: produces an up-to-date `refMap`
  *
+ * If constructed with `incremental` set, a re-application to a program that
+ * differs from the one the map was computed for tries to patch the map in
+ * place, revisiting only the top-level objects that were actually replaced;
+ * see computeChanges.  Note that shadowing warnings are not re-issued for the
+ * skipped objects, so `checkShadow` should not be combined with this.
  */
 class ResolveReferences : public Inspector, private ResolutionContext {
     /// Reference map -- essentially from paths to declarations.
@@ -89,13 +94,25 @@ class ResolveReferences : public Inspector, private ResolutionContext {
     /// If @true, then warn if one declaration shadows another.
     bool checkShadow;
 
+    /// If @true, patch an up-to-date map in place when the program changes
+    /// instead of rebuilding it from scratch.
+    bool incremental;
+
+    /// Top-level objects of the program being visited that are shared with
+    /// the program the map was computed for; their resolutions are already in
+    /// the map, so the traversal skips them.  Empty during a full resolution.
+    std::set<const IR::Node *> unchanged;
+
  private:
     /// Resolve @p path; if @p isType is `true` then resolution will
     /// only return type nodes.
     void resolvePath(const IR::Path *path, bool isType) const;
 
+    bool computeChanges(const IR::P4Program *program);
+
  public:
-    explicit ResolveReferences(/* out */ P4::ReferenceMap *refMap, bool checkShadow = false);
+    explicit ResolveReferences(/* out */ P4::ReferenceMap *refMap, bool checkShadow = false,
+                               bool incremental = false);
 
     Visitor::profile_t init_apply(const IR::Node *node) override;
     void end_apply(const IR::Node *node) override;
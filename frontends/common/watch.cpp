@@ -0,0 +1,133 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "watch.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "lib/source_file.h"
+
+namespace P4 {
+namespace Watch {
+
+#ifdef __linux__
+
+/// Block until one of @files changes.  Returns false if no watch could
+/// be established.
+static bool waitForChange(const std::set<std::string>& files) {
+    int fd = inotify_init();
+    if (fd < 0) {
+        perror("p4c watch: inotify_init");
+        return false;
+    }
+    int watched = 0;
+    for (auto& file : files)
+        if (inotify_add_watch(fd, file.c_str(),
+                              IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                              IN_MOVE_SELF | IN_DELETE_SELF) >= 0)
+            watched++;
+    if (watched == 0) {
+        close(fd);
+        return false;
+    }
+    char buf[4096];
+    ssize_t got;
+    do {
+        got = read(fd, buf, sizeof(buf));
+    } while (got < 0 && errno == EINTR);
+    close(fd);
+    // Editors often save in several steps (write to a temporary file,
+    // rename, chmod); let the dust settle so the final contents are
+    // compiled once.  The watches are re-established for every rebuild,
+    // which also repairs them after a save-by-rename.
+    usleep(100 * 1000);
+    return got > 0;
+}
+
+#else  /* !__linux__ */
+
+/// Portable fallback: poll the files' modification times.
+static bool waitForChange(const std::set<std::string>& files) {
+    auto snapshot = [&files]() {
+        std::vector<time_t> times;
+        for (auto& file : files) {
+            struct stat st;
+            times.push_back(stat(file.c_str(), &st) == 0 ? st.st_mtime : 0);
+        }
+        return times;
+    };
+    auto before = snapshot();
+    for (;;) {
+        usleep(500 * 1000);
+        if (snapshot() != before)
+            return true;
+    }
+}
+
+#endif
+
+int run(int argc, char* const* argv, std::function<int(int argc, char* const* argv)> compile) {
+    // Strip --watch so that option processing doesn't see it.
+    std::vector<char*> args;
+    for (int i = 0; i < argc; i++)
+        if (strcmp(argv[i], "--watch") != 0)
+            args.push_back(argv[i]);
+    args.push_back(nullptr);
+
+    std::set<std::string> files;
+    for (;;) {
+        int status = compile(args.size() - 1, args.data());
+
+        // The files of the program just compiled; after a compile that
+        // failed before parsing, keep watching the previous set.
+        if (auto sources = Util::InputSources::mostRecent()) {
+            std::set<cstring> names;
+            sources->getAllFileNames(&names);
+            std::set<std::string> current;
+            for (auto name : names)
+                current.insert(name.c_str());
+            if (!current.empty())
+                files = std::move(current);
+        }
+        if (files.empty()) {
+            std::cerr << "p4c watch: no source files to watch" << std::endl;
+            return status;
+        }
+
+        std::cerr << "p4c watch: compilation " << (status == 0 ? "succeeded" : "failed")
+                  << "; watching " << files.size()
+                  << (files.size() == 1 ? " file" : " files") << std::endl;
+        if (!waitForChange(files)) {
+            std::cerr << "p4c watch: can't watch the source files; exiting" << std::endl;
+            return status;
+        }
+        std::cerr << "p4c watch: change detected, recompiling" << std::endl;
+    }
+}
+
+}  // namespace Watch
+}  // namespace P4
@@ -0,0 +1,46 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _FRONTENDS_COMMON_WATCH_H_
+#define _FRONTENDS_COMMON_WATCH_H_
+
+#include <functional>
+
+namespace P4 {
+
+/**
+ * Watch mode, enabled with --watch.
+ *
+ * The compiler stays resident: after each compile it collects the set of
+ * files the program was assembled from -- the main file and every include
+ * recorded by Util::InputSources -- waits until one of them changes
+ * (inotify on Linux, mtime polling elsewhere), and recompiles.  Reruns
+ * happen in the same warmed process, so they skip collector startup and
+ * reuse the interned-string table, the precompiled stdlib snapshot and
+ * the on-disk compilation cache, which is what makes the edit-compile
+ * loop fast.
+ */
+namespace Watch {
+
+/// Compile via @compile (with --watch removed from the arguments), then
+/// recompile whenever one of the program's files changes.  Returns only
+/// when no watch can be established, with the last compile's exit code.
+int run(int argc, char* const* argv, std::function<int(int argc, char* const* argv)> compile);
+
+}  // namespace Watch
+}  // namespace P4
+
+#endif /* _FRONTENDS_COMMON_WATCH_H_ */
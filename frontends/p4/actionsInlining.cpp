@@ -45,12 +45,35 @@ void DiscoverActionsInlining::postorder(const IR::MethodCallStatement* mcs) {
 }
 
 Visitor::profile_t ActionsInliner::init_apply(const IR::Node* node) {
-    P4::ResolveReferences solver(refMap, true);
-    node->apply(solver);
-    LOG2("ActionsInliner " << toInline);
+    if (!nested) {
+        // Helper inliners reuse the references already resolved here; the
+        // declarations they create are added to the refMap as they are built.
+        P4::ResolveReferences solver(refMap, true);
+        node->apply(solver);
+        inlinedCallees->clear();
+        LOG2("ActionsInliner " << toInline);
+    }
     return Transform::init_apply(node);
 }
 
+const IR::P4Action* ActionsInliner::getInlinedVersion(const IR::P4Action* callee) {
+    auto sites = toInline->sites.find(callee);
+    if (sites == toInline->sites.end() || sites->second.empty())
+        return callee;
+    // The callee has calls of its own in the work list, so its callers must
+    // inline the version with those calls already substituted.  Since P4
+    // requires declarations before use, the callee has normally been visited
+    // already and its inlined version saved; if not, compute it now.  The
+    // call graph is acyclic, so this recursion terminates.
+    auto& version = (*inlinedCallees)[callee];
+    if (version == nullptr) {
+        ActionsInliner helper(this);
+        version = callee->apply(helper)->to<IR::P4Action>();
+        CHECK_NULL(version);
+    }
+    return version;
+}
+
 const IR::Node* ActionsInliner::preorder(IR::P4Action* action) {
     if (toInline->sites.count(getOriginal<IR::P4Action>()) == 0)
         prune();
@@ -60,8 +83,12 @@ const IR::Node* ActionsInliner::preorder(IR::P4Action* action) {
 }
 
 const IR::Node* ActionsInliner::postorder(IR::P4Action* action) {
-    if (toInline->sites.count(getOriginal<IR::P4Action>()) > 0)
+    if (toInline->sites.count(getOriginal<IR::P4Action>()) > 0) {
         list->replace(getOriginal<IR::P4Action>(), action);
+        // Save the result: if this action is also a callee in the work
+        // list, its callers must inline this version.
+        (*inlinedCallees)[getOriginal<IR::P4Action>()] = action;
+    }
     replMap = nullptr;
     return action;
 }
@@ -75,13 +102,15 @@ const IR::Node* ActionsInliner::preorder(IR::MethodCallStatement* statement) {
     auto callee = get(*replMap, orig);
     if (callee == nullptr)
         return statement;
+    callee = getInlinedVersion(callee);
 
     LOG2("Inlining: " << callee);
     IR::IndexedVector<IR::StatOrDecl> body;
     ParameterSubstitution subst;
     TypeVariableSubstitution tvs;  // empty
 
-    std::map<const IR::Parameter*, cstring> paramRename;
+    // Local copies standing in for the parameters, by parameter.
+    std::map<const IR::Parameter*, const IR::Declaration_Variable*> paramCopies;
     ParameterSubstitution substitution;
     substitution.populate(callee->parameters, statement->methodCall->arguments);
 
@@ -89,13 +118,17 @@ const IR::Node* ActionsInliner::preorder(IR::MethodCallStatement* statement) {
     for (auto param : callee->parameters->parameters) {
         auto argument = substitution.lookup(param);
         cstring newName = refMap->newName(param->name);
-        paramRename.emplace(param, newName);
         if (param->direction == IR::Direction::In || param->direction == IR::Direction::InOut) {
             auto vardecl = new IR::Declaration_Variable(newName, param->annotations,
                                                         param->type, argument->expression);
             body.push_back(vardecl);
-            subst.add(param, new IR::Argument(
-                argument->srcInfo, argument->name, new IR::PathExpression(newName)));
+            paramCopies.emplace(param, vardecl);
+            auto paramRef = new IR::PathExpression(newName);
+            // Resolve the new reference right away: the body we build here
+            // may be inlined again further up the call chain, without a
+            // reference re-resolution in between.
+            refMap->setDeclaration(paramRef->path, vardecl);
+            subst.add(param, new IR::Argument(argument->srcInfo, argument->name, paramRef));
         } else if (param->direction == IR::Direction::None) {
             // This works because there can be no side-effects in the evaluation of this
             // argument.
@@ -109,8 +142,10 @@ const IR::Node* ActionsInliner::preorder(IR::MethodCallStatement* statement) {
             // uninitialized variable
             auto vardecl = new IR::Declaration_Variable(newName,
                                                         param->annotations, param->type);
-            subst.add(param, new IR::Argument(
-                argument->srcInfo, argument->name, new IR::PathExpression(newName)));
+            paramCopies.emplace(param, vardecl);
+            auto paramRef = new IR::PathExpression(newName);
+            refMap->setDeclaration(paramRef->path, vardecl);
+            subst.add(param, new IR::Argument(argument->srcInfo, argument->name, paramRef));
             body.push_back(vardecl);
         }
     }
@@ -128,8 +163,9 @@ const IR::Node* ActionsInliner::preorder(IR::MethodCallStatement* statement) {
     for (auto param : callee->parameters->parameters) {
         auto left = substitution.lookup(param);
         if (param->direction == IR::Direction::InOut || param->direction == IR::Direction::Out) {
-            cstring newName = ::get(paramRename, param);
-            auto right = new IR::PathExpression(newName);
+            auto vardecl = ::get(paramCopies, param);
+            auto right = new IR::PathExpression(vardecl->name);
+            refMap->setDeclaration(right->path, vardecl);
             auto copyout = new IR::AssignmentStatement(left->expression, right);
             body.push_back(copyout);
         }
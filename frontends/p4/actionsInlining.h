@@ -47,8 +47,28 @@ class DiscoverActionsInlining : public Inspector {
 class ActionsInliner : public AbstractInliner<ActionsInlineList, AInlineWorkList> {
     P4::ReferenceMap* refMap;
     std::map<const IR::MethodCallStatement*, const IR::P4Action*>* replMap;
+    /// Inlined versions of the callees which are themselves callers in the
+    /// current work list; such nested calls only appear when the work list
+    /// holds the whole inlining plan (see SimpleInlineList).
+    std::map<const IR::P4Action*, const IR::P4Action*>* inlinedCallees;
+    /// True in the helper inliners created by getInlinedVersion.
+    bool nested;
+
+    /// Creates a helper inliner sharing the state of @p parent; it is
+    /// applied to a single callee to inline the callee's own calls.
+    explicit ActionsInliner(ActionsInliner* parent) :
+            refMap(parent->refMap), replMap(nullptr),
+            inlinedCallees(parent->inlinedCallees), nested(true)
+    { prepare(parent->list, parent->toInline); }
+    /// The version of @p callee which should be inlined into its callers:
+    /// @p callee itself if it has no calls to inline, otherwise a copy of
+    /// @p callee with all its own calls already inlined.
+    const IR::P4Action* getInlinedVersion(const IR::P4Action* callee);
+
  public:
-    explicit ActionsInliner(bool isv1) : refMap(new P4::ReferenceMap()), replMap(nullptr)
+    explicit ActionsInliner(bool isv1) : refMap(new P4::ReferenceMap()), replMap(nullptr),
+            inlinedCallees(new std::map<const IR::P4Action*, const IR::P4Action*>()),
+            nested(false)
     { refMap->setIsV1(isv1); }
     Visitor::profile_t init_apply(const IR::Node* node) override;
     const IR::Node* preorder(IR::P4Parser* cont) override
@@ -63,7 +83,12 @@ typedef InlineDriver<ActionsInlineList, AInlineWorkList> InlineActionsDriver;
 class InlineActions : public PassManager {
     ActionsInlineList actionsToInline;
  public:
-    InlineActions(ReferenceMap* refMap, TypeMap* typeMap) {
+    /// With @p bulk, all actions are inlined in a single traversal of the
+    /// program instead of one traversal per level of the call chain; fresh
+    /// names for parameter copies are then allocated in a different order,
+    /// so enabling it requires regenerating the reference outputs.
+    InlineActions(ReferenceMap* refMap, TypeMap* typeMap, bool bulk = false) :
+            actionsToInline(bulk) {
         passes.push_back(new TypeChecking(refMap, typeMap));
         passes.push_back(new DiscoverActionsInlining(&actionsToInline, refMap, typeMap));
         passes.push_back(new InlineActionsDriver(&actionsToInline,
@@ -0,0 +1,123 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "analysisSnapshot.h"
+
+#include <sstream>
+#include <vector>
+
+#include "ir/binary_io.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+#include "lib/error.h"
+#include "lib/hash.h"
+
+namespace P4 {
+
+void saveBinaryIRWithAnalyses(const IR::P4Program* program, std::ostream& out,
+                              const TypeMap* typeMap, const ReferenceMap* refMap) {
+    CHECK_NULL(program); CHECK_NULL(typeMap); CHECK_NULL(refMap);
+    // One generator serializes both the program and the maps, so map entries
+    // pointing at program nodes come out as Node_ID references instead of
+    // duplicated subtrees.  As in saveBinaryIR, generation still goes through
+    // text JSON internally; the artifact itself is binary.
+    std::stringstream text;
+    JSONGenerator gen(text);
+    gen << program;
+    JsonData* progData = nullptr;
+    text >> progData;
+
+    writeBinaryIRHeader(out);
+    // Encode the program record separately so its exact bytes can be hashed;
+    // the hash stored in the snapshot lets the loader reject a snapshot that
+    // was not computed for the program it sits behind.
+    std::stringstream encoded;
+    encodeBinaryJson(progData, encoded);
+    const std::string& programBytes = encoded.str();
+    uint64_t programHash = Util::Hash::hash(programBytes.data(), programBytes.size());
+    out.write(programBytes.data(), programBytes.size());
+
+    // The parser may have touched EOF consuming the program value; clear the
+    // stream state so the same generator (and its node_refs) can keep writing.
+    text.clear();
+    gen << "{" << std::endl
+        << ++gen.indent << "\"hash\" : " << programHash << "," << std::endl
+        << gen.indent << "\"typeMap\" : " << *typeMap << "," << std::endl
+        << gen.indent << "\"refMap\" : " << *refMap << std::endl
+        << --gen.indent << "}" << std::endl;
+    JsonData* snapData = nullptr;
+    text >> snapData;
+    encodeBinaryJson(snapData, out);
+}
+
+const IR::Node* loadBinaryIRWithAnalyses(std::istream& in,
+                                         TypeMap* typeMap, ReferenceMap* refMap) {
+    if (!readBinaryIRHeader(in))
+        return nullptr;
+    auto start = in.tellg();
+    JsonData* progData = decodeBinaryJson(in);
+    if (progData == nullptr) {
+        ::error(ErrorType::ERR_INVALID, "corrupt binary IR file");
+        return nullptr; }
+    auto end = in.tellg();
+
+    JSONLoader loader(progData);
+    const IR::Node* node = nullptr;
+    loader >> node;
+    if (node == nullptr)
+        return nullptr;
+    if (typeMap == nullptr || refMap == nullptr)
+        return node;
+    if (in.peek() == EOF)  // plain dump without a snapshot
+        return node;
+
+    // Hash the program record's bytes; on a non-seekable stream we cannot
+    // re-read them, so accept the snapshot without validation.
+    bool validated = false;
+    uint64_t programHash = 0;
+    if (start != std::streampos(-1) && end != std::streampos(-1)) {
+        size_t len = size_t(end - start);
+        std::vector<char> bytes(len);
+        in.seekg(start);
+        in.read(bytes.data(), len);
+        programHash = Util::Hash::hash(bytes.data(), len);
+        validated = true;
+    }
+
+    JsonData* snapData = decodeBinaryJson(in);
+    if (snapData == nullptr) {
+        ::warning(ErrorType::WARN_INVALID, "ignoring corrupt analysis snapshot");
+        return node; }
+    JSONLoader snapshot(snapData, loader.node_refs);
+    big_int storedHash = 0;
+    snapshot.load("hash", storedHash);
+    if (validated && storedHash != big_int(programHash)) {
+        ::warning(ErrorType::WARN_MISMATCH,
+                  "analysis snapshot does not match the program; ignoring it");
+        return node; }
+
+    JSONLoader typeData(snapshot, "typeMap");
+    if (typeData.json != nullptr)
+        typeMap->loadFromJSON(typeData);
+    JSONLoader refData(snapshot, "refMap");
+    if (refData.json != nullptr)
+        refMap->loadFromJSON(refData);
+    typeMap->updateMap(node);
+    refMap->updateMap(node);
+    return node;
+}
+
+}  // namespace P4
@@ -0,0 +1,52 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _FRONTENDS_P4_ANALYSISSNAPSHOT_H_
+#define _FRONTENDS_P4_ANALYSISSNAPSHOT_H_
+
+#include <iosfwd>
+
+#include "ir/ir.h"
+#include "frontends/p4/typeMap.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+
+namespace P4 {
+
+/* Binary IR dumps carrying the analysis results computed for the program.
+ *
+ * The snapshot is an extra record appended after the program record of the
+ * ordinary binary IR container, holding the TypeMap and ReferenceMap as id
+ * references into the program, plus a hash of the program record's bytes.
+ * A consumer that loads the snapshot alongside the program can skip
+ * reference resolution and type inference entirely; plain loadBinaryIR
+ * keeps working on these files because it ignores trailing records. */
+
+/// Write @p program in the binary IR format followed by a snapshot of
+/// @p typeMap and @p refMap, which must have been computed for @p program.
+void saveBinaryIRWithAnalyses(const IR::P4Program* program, std::ostream& out,
+                              const TypeMap* typeMap, const ReferenceMap* refMap);
+
+/// Load a binary IR file, repopulating @p typeMap and @p refMap from its
+/// analysis snapshot if one is present and matches the program bytes.
+/// On success the maps pass checkMap() for the returned program; a file
+/// without a snapshot (or with a stale one) still loads the program, just
+/// with the maps left cleared.  Returns nullptr on a corrupt file.
+const IR::Node* loadBinaryIRWithAnalyses(std::istream& in,
+                                         TypeMap* typeMap, ReferenceMap* refMap);
+
+}  // namespace P4
+
+#endif /* _FRONTENDS_P4_ANALYSISSNAPSHOT_H_ */
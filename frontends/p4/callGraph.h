@@ -23,6 +23,7 @@ limitations under the License.
 #include "lib/log.h"
 #include "lib/exceptions.h"
 #include "lib/map.h"
+#include "lib/ordered_flat_map.h"
 #include "lib/ordered_map.h"
 #include "lib/ordered_set.h"
 #include "lib/null.h"
@@ -264,114 +265,223 @@ class CallGraph {
             set.erase(e);
     }
 
-    // Helper for computing strongly-connected components
-    // using Tarjan's algorithm.
-    struct sccInfo {
-        unsigned       crtIndex;
-        std::vector<T> stack;
-        std::set<T>    onStack;
-        std::map<T, unsigned> index;
-        std::map<T, unsigned> lowlink;
-
-        sccInfo() : crtIndex(0) {}
-        void push(T node) {
-            stack.push_back(node);
-            onStack.emplace(node);
-        }
-        bool isOnStack(T node)
-        { return onStack.count(node) != 0; }
-        bool unknown(T node)
-        { return index.count(node) == 0; }
-        void setLowLink(T node, unsigned value) {
-            lowlink[node] = value;
-            LOG1(node << ".lowlink = " << value << " = " << get(lowlink, node));
-        }
-        void setLowLink(T node, T successor) {
-            unsigned nlink = get(lowlink, node);
-            unsigned slink = get(lowlink, successor);
-            if (slink < nlink)
-                setLowLink(node, slink);
-        }
-        T pop() {
-            T result = stack.back();
-            stack.pop_back();
-            onStack.erase(result);
-            return result;
+ public:
+    /** A dense, read-only form of the graph, built once and queried many
+     * times.  Vertices are renumbered 0..N-1 in node insertion order and
+     * the adjacency is stored as compressed sparse rows, so traversals
+     * walk contiguous arrays instead of chasing map nodes.  Construction
+     * runs one whole-graph Tarjan pass and caches its results: component
+     * numbers, recursion flags, and a topological order of all nodes.
+     * The compiled form is a snapshot: it does not reflect later changes
+     * to the graph it was built from.
+     */
+    class Compiled {
+        enum : unsigned { NOT_VISITED = ~0u };
+
+        cstring name;
+        std::vector<T> vertex;              // dense id -> node
+        ordered_flat_map<T, unsigned> ids;  // node -> dense id
+        std::vector<unsigned> offsets;      // CSR row starts; size() == vertex.size() + 1
+        std::vector<unsigned> targets;      // concatenated callee ids
+        std::vector<unsigned> component;    // vertex -> strongly-connected component number
+        std::vector<char> inCycle;          // vertex is part of a cycle
+        std::vector<T> order;               // all nodes, callees before callers
+        unsigned componentCount = 0;
+        bool cyclic = false;
+
+        struct TarjanState {
+            unsigned crtIndex = 0;
+            std::vector<unsigned> index;    // doubles as the "visited" flag
+            std::vector<unsigned> lowlink;
+            std::vector<char> onStack;
+            std::vector<unsigned> stack;
+            explicit TarjanState(size_t size) :
+                    index(size, NOT_VISITED), lowlink(size, 0), onStack(size, 0) {}
+        };
+        struct Frame {
+            unsigned vertex;
+            unsigned edge;  // next out-edge to examine
+        };
+
+        unsigned getId(T node) const {
+            auto it = ids.find(node);
+            BUG_CHECK(it != ids.end(), "%1%: node not in call graph %2%",
+                      cgMakeString(node), name);
+            return it->second;
         }
-    };
 
-    // helper for scSort
-    bool strongConnect(T node, sccInfo& helper, std::vector<T>& out) {
-        bool loop = false;
-
-        LOG1("scc " << cgMakeString(node));
-        helper.index.emplace(node, helper.crtIndex);
-        helper.setLowLink(node, helper.crtIndex);
-        helper.crtIndex++;
-        helper.push(node);
-        auto oe = out_edges[node];
-        if (oe != nullptr) {
-            for (auto next : *oe) {
-                LOG1(cgMakeString(node) << " => " << cgMakeString(next));
-                if (helper.unknown(next)) {
-                    bool l = strongConnect(next, helper, out);
-                    loop = loop | l;
-                    helper.setLowLink(node, next);
-                } else if (helper.isOnStack(next)) {
-                    helper.setLowLink(node, next);
-                    if (next == node)
-                        // the check below does not find self-loops
+        /** Iterative Tarjan; emits the members of each strongly-connected
+         * component consecutively, callees before callers, in exactly the
+         * order the recursive formulation would.  Returns true if a cycle
+         * (including a self-loop) was found.  If @record is true also
+         * fills in the component numbers and cycle flags.
+         */
+        bool strongConnect(unsigned root, TarjanState &st, std::vector<T> &out, bool record) {
+            bool loop = false;
+            std::vector<Frame> frames;
+            std::vector<unsigned> members;  // of the component being popped
+            st.index[root] = st.lowlink[root] = st.crtIndex++;
+            st.stack.push_back(root);
+            st.onStack[root] = 1;
+            frames.push_back(Frame{root, 0});
+            while (!frames.empty()) {
+                Frame &frame = frames.back();
+                unsigned v = frame.vertex;
+                if (offsets[v] + frame.edge < offsets[v + 1]) {
+                    unsigned next = targets[offsets[v] + frame.edge++];
+                    if (st.index[next] == NOT_VISITED) {
+                        st.index[next] = st.lowlink[next] = st.crtIndex++;
+                        st.stack.push_back(next);
+                        st.onStack[next] = 1;
+                        frames.push_back(Frame{next, 0});
+                    } else if (st.onStack[next]) {
+                        if (st.lowlink[next] < st.lowlink[v])
+                            st.lowlink[v] = st.lowlink[next];
+                        if (next == v) {
+                            // the component size check below does not find self-loops
+                            loop = true;
+                            if (record)
+                                inCycle[v] = 1;
+                        }
+                    }
+                    continue;
+                }
+                // all successors of v examined
+                if (st.lowlink[v] == st.index[v]) {
+                    members.clear();
+                    while (true) {
+                        unsigned member = st.stack.back();
+                        st.stack.pop_back();
+                        st.onStack[member] = 0;
+                        LOG2("Scc order " << cgMakeString(vertex[member])
+                             << "[" << cgMakeString(vertex[v]) << "]");
+                        out.push_back(vertex[member]);
+                        members.push_back(member);
+                        if (member == v)
+                            break;
+                    }
+                    if (members.size() > 1)
                         loop = true;
+                    if (record) {
+                        for (auto member : members) {
+                            component[member] = componentCount;
+                            if (members.size() > 1)
+                                inCycle[member] = 1;
+                        }
+                        componentCount++;
+                    }
+                }
+                frames.pop_back();
+                if (!frames.empty()) {
+                    unsigned parent = frames.back().vertex;
+                    if (st.lowlink[v] < st.lowlink[parent])
+                        st.lowlink[parent] = st.lowlink[v];
                 }
             }
+            return loop;
         }
 
-        if (get(helper.lowlink, node) == get(helper.index, node)) {
-            LOG1(cgMakeString(node) << " index=" << get(helper.index, node)
-                      << " lowlink=" << get(helper.lowlink, node));
-            while (true) {
-                T sccMember = helper.pop();
-                LOG1("Scc order " << cgMakeString(sccMember) << "[" << cgMakeString(node) << "]");
-                out.push_back(sccMember);
-                if (sccMember == node)
-                    break;
-                loop = true;
+     public:
+        explicit Compiled(const CallGraph &graph) : name(graph.name) {
+            vertex.reserve(graph.nodes.size());
+            for (auto n : graph.nodes) {
+                ids.emplace(n, static_cast<unsigned>(vertex.size()));
+                vertex.push_back(n);
+            }
+            offsets.assign(vertex.size() + 1, 0);
+            for (auto &oe : graph.out_edges)
+                offsets[getId(oe.first) + 1] = static_cast<unsigned>(oe.second->size());
+            for (size_t i = 1; i < offsets.size(); i++)
+                offsets[i] += offsets[i - 1];
+            targets.resize(offsets.back());
+            std::vector<unsigned> fill(offsets.begin(), offsets.end() - 1);
+            for (auto &oe : graph.out_edges) {
+                unsigned caller = getId(oe.first);
+                for (auto callee : *oe.second)
+                    targets[fill[caller]++] = getId(callee);
             }
+
+            component.assign(vertex.size(), 0);
+            inCycle.assign(vertex.size(), 0);
+            order.reserve(vertex.size());
+            TarjanState st(vertex.size());
+            for (unsigned v = 0; v < vertex.size(); v++)
+                if (st.index[v] == NOT_VISITED)
+                    cyclic |= strongConnect(v, st, order, true);
         }
 
-        return loop;
-    }
+        size_t size() const { return vertex.size(); }
+        bool contains(T node) const { return ids.count(node) != 0; }
+        /// True if the graph contains a cycle, including self-loops.
+        bool isCyclic() const { return cyclic; }
+        /// True if @node is part of a cycle.
+        bool isRecursive(T node) const { return inCycle[getId(node)] != 0; }
+        /// True if @a and @b belong to the same strongly-connected component.
+        bool inSameComponent(T a, T b) const
+        { return component[getId(a)] == component[getId(b)]; }
+        /// Cached topological order of all nodes; the members of each
+        /// strongly-connected component are consecutive and callees come
+        /// before callers.
+        const std::vector<T>& sccOrder() const { return order; }
+
+        /// Like CallGraph::sccSort: only considers nodes reachable from @start.
+        bool sccSort(T start, std::vector<T> &out) {
+            TarjanState st(vertex.size());
+            return strongConnect(getId(start), st, out, false);
+        }
+        /// Like CallGraph::sort with explicit start nodes.
+        bool sort(const std::vector<T> &start, std::vector<T> &out) {
+            TarjanState st(vertex.size());
+            std::unordered_set<T> emitted(out.begin(), out.end());
+            bool cycles = false;
+            for (auto n : start) {
+                if (emitted.count(n) != 0)
+                    continue;
+                if (!contains(n)) {
+                    // a start node that never made it into the graph sorts alone
+                    out.push_back(n);
+                    emitted.emplace(n);
+                    continue;
+                }
+                unsigned v = getId(n);
+                if (st.index[v] != NOT_VISITED)
+                    continue;
+                bool c = strongConnect(v, st, out, false);
+                cycles = cycles || c;
+            }
+            return cycles;
+        }
+    };
+
+    /// Compile the current graph; the result is a snapshot which does not
+    /// reflect later changes to this graph.
+    Compiled* compile() const { return new Compiled(*this); }
 
- public:
     // Sort that computes strongly-connected components - all nodes in
     // a strongly-connected components will be consecutive in the
     // sort.  Returns true if the graph contains at least one
     // cycle.  Ignores nodes not reachable from 'start'.
     bool sccSort(T start, std::vector<T> &out) {
-        sccInfo helper;
-        return strongConnect(start, helper, out);
+        if (nodes.find(start) == nodes.end()) {
+            // preserve the tolerance of the old recursive implementation
+            out.push_back(start);
+            return false;
+        }
+        Compiled compiled(*this);
+        return compiled.sccSort(start, out);
     }
     bool sort(std::vector<T> &start, std::vector<T> &out) {
-        sccInfo helper;
-        bool cycles = false;
-        for (auto n : start) {
-            if (std::find(out.begin(), out.end(), n) == out.end()) {
-                bool c = strongConnect(n, helper, out);
-                cycles = cycles || c;
-            }
-        }
-        return cycles;
+        Compiled compiled(*this);
+        return compiled.sort(start, out);
     }
     bool sort(std::vector<T> &out) {
-        sccInfo helper;
-        bool cycles = false;
-        for (auto n : nodes) {
-            if (std::find(out.begin(), out.end(), n) == out.end()) {
-                bool c = strongConnect(n, helper, out);
-                cycles = cycles || c;
-            }
+        Compiled compiled(*this);
+        if (out.empty()) {
+            out = compiled.sccOrder();
+            return compiled.isCyclic();
         }
-        return cycles;
+        std::vector<T> start(nodes.begin(), nodes.end());
+        return compiled.sort(start, out);
     }
 };
 
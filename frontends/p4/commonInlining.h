@@ -70,8 +70,21 @@ template<class Callable, class CallInfo, class InlineWorkList>
 class SimpleInlineList {
     std::vector<CallInfo*> toInline;     // initial data
     std::vector<CallInfo*> inlineOrder;  // sorted in inlining order
+    /// If true next() returns the whole inlining plan as one work list.
+    bool bulk;
 
  public:
+    /// In bulk mode the entire inlining plan computed from the call graph is
+    /// handed to the inliner as a single work list, so all substitutions are
+    /// performed in one traversal of the program, with a single reference
+    /// re-resolution in the inliner's init_apply.  The work list may then
+    /// contain a callee which is itself a caller; the inliner must inline
+    /// within such a callee before inlining the callee itself (ActionsInliner
+    /// and FunctionsInliner do).  Without bulk mode the plan is split into
+    /// work lists free of nested calls, and the program is traversed (and
+    /// references re-resolved) once per work list.
+    explicit SimpleInlineList(bool bulk = false) : bulk(bulk) {}
+
     // generate the inlining order
     void analyze() {
         // We only keep the call graph between objects of the same kind.
@@ -107,11 +120,12 @@ class SimpleInlineList {
 
         // Find callables that can be inlined simultaneously.
         // This traversal is in topological order starting from leaf callees.
-        // We stop at the first callable which calls one of the callables
-        // we have already selected.
+        // Unless we are building the whole plan in bulk, we stop at the
+        // first callable which calls one of the callables we have already
+        // selected.
         while (!inlineOrder.empty()) {
             auto last = inlineOrder.back();
-            if (callers.find(last->callee) != callers.end())
+            if (!bulk && callers.find(last->callee) != callers.end())
                 break;
             inlineOrder.pop_back();
             result->add(last);
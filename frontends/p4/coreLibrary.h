@@ -108,7 +108,8 @@ class P4CoreLibrary : public ::Model::Model {
             headerTooShort(StandardExceptions::HeaderTooShort) {}
 
  public:
-    static P4CoreLibrary instance;
+    /// The core library model, constructed on first use.
+    static P4CoreLibrary& instance();
     ::Model::Elem noAction;
 
     ::Model::Elem exactMatch;
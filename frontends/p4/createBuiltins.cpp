@@ -65,7 +65,7 @@ void CreateBuiltins::postorder(IR::ParserState* state) {
 void CreateBuiltins::postorder(IR::ActionList* actions) {
     if (!addNoAction)
         return;
-    auto decl = actions->getDeclaration(P4::P4CoreLibrary::instance.noAction.str());
+    auto decl = actions->getDeclaration(P4::P4CoreLibrary::instance().noAction.str());
     if (decl != nullptr)
         return;
     actions->push_back(
@@ -73,7 +73,7 @@ void CreateBuiltins::postorder(IR::ActionList* actions) {
             new IR::Annotations(
                 {new IR::Annotation(IR::Annotation::defaultOnlyAnnotation, {})}),
             new IR::MethodCallExpression(
-                new IR::PathExpression(P4::P4CoreLibrary::instance.noAction.Id(actions->srcInfo)),
+                new IR::PathExpression(P4::P4CoreLibrary::instance().noAction.Id(actions->srcInfo)),
                 new IR::Vector<IR::Type>(), new IR::Vector<IR::Argument>())));
 }
 
@@ -87,7 +87,7 @@ bool CreateBuiltins::preorder(IR::P4Table* table) {
 void CreateBuiltins::postorder(IR::TableProperties* properties) {
     if (!addNoAction)
         return;
-    auto act = new IR::PathExpression(P4::P4CoreLibrary::instance.noAction.Id(properties->srcInfo));
+    auto act = new IR::PathExpression(P4::P4CoreLibrary::instance().noAction.Id(properties->srcInfo));
     auto args = new IR::Vector<IR::Argument>();
     auto methodCall = new IR::MethodCallExpression(act, args);
     auto prop = new IR::Property(
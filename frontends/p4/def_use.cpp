@@ -242,10 +242,34 @@ bool LocationSet::overlaps(const LocationSet* other) const {
     return false;
 }
 
+std::unordered_map<ProgramPoint, unsigned> ProgramPoints::pointId;
+std::vector<ProgramPoint> ProgramPoints::pointById;
+
+unsigned ProgramPoints::id(const ProgramPoint& point) {
+    auto it = pointId.find(point);
+    if (it != pointId.end())
+        return it->second;
+    unsigned id = pointById.size();
+    pointById.push_back(point);
+    pointId.emplace(point, id);
+    return id;
+}
+
+void ProgramPoints::clearIds() {
+    pointId.clear();
+    pointById.clear();
+}
+
 const ProgramPoints* ProgramPoints::merge(const ProgramPoints* with) const {
+    // Share the larger set when one side contains the other; repeated joins
+    // converge to identical pointers, which makes the pointer fast paths in
+    // joinDefinitions effective.
+    if (points.contains(with->points))
+        return this;
+    if (with->points.contains(points))
+        return with;
     auto result = new ProgramPoints(points);
-    for (auto p : with->points)
-        result->points.emplace(p);
+    result->points |= with->points;
     return result;
 }
 
@@ -271,12 +295,7 @@ std::size_t ProgramPoint::hash() const {
 }
 
 bool ProgramPoints::operator==(const ProgramPoints& other) const {
-    if (points.size() != other.points.size())
-        return false;
-    for (auto p : points)
-        if (other.points.find(p) == other.points.end())
-            return false;
-    return true;
+    return points == other.points;
 }
 
 Definitions* Definitions::joinDefinitions(const Definitions* other) const {
@@ -285,7 +304,10 @@ Definitions* Definitions::joinDefinitions(const Definitions* other) const {
         auto loc = d.first;
         auto defs = d.second;
         auto current = ::get(definitions, loc);
-        if (current != nullptr) {
+        if (current == defs) {
+            // both sides share the same set - nothing to merge
+            result->definitions.emplace(loc, defs);
+        } else if (current != nullptr) {
             auto merged = current->merge(defs);
             result->definitions.emplace(loc, merged);
         } else {
@@ -354,6 +376,8 @@ bool Definitions::operator==(const Definitions& other) const {
         auto od = ::get(other.definitions, d.first);
         if (od == nullptr)
             return false;
+        if (d.second == od)
+            continue;  // shared set
         if (!d.second->operator==(*od))
             return false;
     }
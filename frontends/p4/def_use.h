@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef _FRONTENDS_P4_DEF_USE_H_
 #define _FRONTENDS_P4_DEF_USE_H_
 
+#include "lib/bitvec.h"
 #include "lib/ordered_map.h"
 #include "lib/ordered_set.h"
 #include "ir/ir.h"
@@ -298,28 +299,46 @@ template<> struct hash<P4::ProgramPoint> {
 
 namespace P4 {
 class ProgramPoints : public IHasDbPrint {
-    typedef std::unordered_set<ProgramPoint> Points;
-    Points points;
-    explicit ProgramPoints(const Points &points) : points(points) {}
+    /// Program points are interned: each distinct point gets a dense integer
+    /// id, and a set of points is a bitvec over those ids.  This makes merges
+    /// word-parallel, and lets merge() share a whole set when one side
+    /// already contains the other.
+    bitvec points;
+    static std::unordered_map<ProgramPoint, unsigned> pointId;
+    static std::vector<ProgramPoint> pointById;
+    static unsigned id(const ProgramPoint& point);
+    explicit ProgramPoints(const bitvec& points) : points(points) {}
  public:
     ProgramPoints() = default;
-    explicit ProgramPoints(ProgramPoint point) { points.emplace(point); }
-    void add(ProgramPoint point) { points.emplace(point); }
+    explicit ProgramPoints(ProgramPoint point) { points.setbit(id(point)); }
+    void add(ProgramPoint point) { points.setbit(id(point)); }
     const ProgramPoints* merge(const ProgramPoints* with) const;
     bool operator==(const ProgramPoints& other) const;
     void dbprint(std::ostream& out) const {
         out << "{";
-        for (auto p : points)
+        for (auto p : *this)
             out << p << " ";
         out << "}";
     }
-    size_t size() const { return points.size(); }
+    size_t size() const { return points.popcount(); }
     bool containsBeforeStart() const
-    { return points.find(ProgramPoint::beforeStart) != points.end(); }
-    Points::const_iterator begin() const
-    { return points.cbegin(); }
-    Points::const_iterator end() const
-    { return points.cend(); }
+    { return points.getbit(id(ProgramPoint::beforeStart)); }
+    /// Iterates the set bits of the bitvec, mapping each id back to its point.
+    class const_iterator {
+        bitvec::const_bitref ref;
+        friend class ProgramPoints;
+        explicit const_iterator(bitvec::const_bitref ref) : ref(ref) {}
+     public:
+        ProgramPoint operator*() const { return pointById.at(*ref); }
+        const_iterator& operator++() { ++ref; return *this; }
+        bool operator==(const const_iterator& other) const { return ref == other.ref; }
+        bool operator!=(const const_iterator& other) const { return ref != other.ref; }
+    };
+    const_iterator begin() const { return const_iterator(points.begin()); }
+    const_iterator end() const { return const_iterator(points.end()); }
+    /// Forget all interned points; called when a fresh analysis starts so ids
+    /// (and the IR nodes points refer to) don't accumulate across programs.
+    static void clearIds();
 };
 
 /// List of definers for each base storage (at a specific program point).
@@ -380,7 +399,8 @@ class AllDefinitions : public IHasDbPrint {
  public:
     StorageMap* storageMap;
     AllDefinitions(ReferenceMap* refMap, TypeMap* typeMap) :
-            storageMap(new StorageMap(refMap, typeMap)) {}
+            storageMap(new StorageMap(refMap, typeMap))
+    { ProgramPoints::clearIds(); }
     Definitions* getDefinitions(ProgramPoint point, bool emptyIfNotFound = false) {
         auto it = atPoint.find(point);
         if (it == atPoint.end()) {
@@ -20,6 +20,51 @@ limitations under the License.
 
 namespace P4 {
 
+std::map<int, Evaluator::MemoizedBlock> Evaluator::memoized;
+
+/// Compares two constructor-argument values.  Blocks compare by identity
+/// (nested blocks are themselves memoized, so an unchanged nested
+/// instantiation yields the same pointer); other compile-time values are
+/// compared structurally, since constant folding may rebuild an equal
+/// constant on every run.
+static bool sameValue(const IR::CompileTimeValue* a, const IR::CompileTimeValue* b) {
+    if (a == b)
+        return true;
+    if (a == nullptr || b == nullptr)
+        return false;
+    if (a->getNode()->is<IR::Block>() || b->getNode()->is<IR::Block>())
+        return false;
+    return a->getNode()->equiv(*b->getNode());
+}
+
+const IR::Block* Evaluator::findMemoized(
+        const IR::Node* node, const IR::IDeclaration* decl, const IR::Type* instanceType,
+        const std::vector<const IR::CompileTimeValue*>* values) const {
+    auto it = memoized.find(node->id);
+    if (it == memoized.end())
+        return nullptr;
+    auto &m = it->second;
+    if (m.decl != decl)
+        return nullptr;
+    // Canonical types are rebuilt by each type inference, so accept a
+    // structurally equal instance type as well.
+    if (m.instanceType != instanceType && !m.instanceType->equiv(*instanceType))
+        return nullptr;
+    if (m.values.size() != values->size())
+        return nullptr;
+    for (size_t i = 0; i < m.values.size(); i++)
+        if (!sameValue(m.values.at(i), values->at(i)))
+            return nullptr;
+    LOG2("Reusing " << dbp(m.block) << " for " << dbp(node));
+    return m.block;
+}
+
+void Evaluator::memoize(
+        const IR::Node* node, const IR::IDeclaration* decl, const IR::Type* instanceType,
+        const std::vector<const IR::CompileTimeValue*>* values, const IR::Block* block) {
+    memoized[node->id] = MemoizedBlock{decl, instanceType, *values, block};
+}
+
 Visitor::profile_t Evaluator::init_apply(const IR::Node* node) {
     BUG_CHECK(node->is<IR::P4Program>(),
               "Evaluation should be invoked on a program, not a %1%", node);
@@ -174,30 +219,46 @@ Evaluator::processConstructor(
         BUG_CHECK(constructor != nullptr,
                   "Type %1% has no constructor with %2% arguments",
                   exttype, arguments->size());
+        // Argument evaluation only touches the enclosing block, so it can
+        // run before the new block exists; this also produces the values
+        // that key the memoization table.
+        auto values = evaluateArguments(constructor->type->parameters, arguments, current);
+        if (values != nullptr)
+            if (auto cached = findMemoized(node, decl, instanceType, values))
+                return cached;
         auto block = new IR::ExternBlock(node->srcInfo, node, instanceType, exttype, constructor);
         pushBlock(block);
-        auto values = evaluateArguments(constructor->type->parameters, arguments, current);
         if (values != nullptr)
             block->instantiate(values);
         popBlock(block);
+        if (values != nullptr)
+            memoize(node, decl, instanceType, values, block);
         return block;
     } else if (decl->is<IR::P4Control>()) {
         auto cont = decl->to<IR::P4Control>();
+        auto values = evaluateArguments(cont->getConstructorParameters(), arguments, current);
+        if (values != nullptr)
+            if (auto cached = findMemoized(node, decl, instanceType, values))
+                return cached;
         auto block = new IR::ControlBlock(node->srcInfo, node, instanceType, cont);
         pushBlock(block);
-        auto values = evaluateArguments(cont->getConstructorParameters(), arguments, current);
         if (values != nullptr) {
             block->instantiate(values);
             for (auto a : cont->controlLocals)
                 visit(a);
         }
         popBlock(block);
+        if (values != nullptr)
+            memoize(node, decl, instanceType, values, block);
         return block;
     } else if (decl->is<IR::P4Parser>()) {
         auto cont = decl->to<IR::P4Parser>();
+        auto values = evaluateArguments(cont->getConstructorParameters(), arguments, current);
+        if (values != nullptr)
+            if (auto cached = findMemoized(node, decl, instanceType, values))
+                return cached;
         auto block = new IR::ParserBlock(node->srcInfo, node, instanceType, cont);
         pushBlock(block);
-        auto values = evaluateArguments(cont->getConstructorParameters(), arguments, current);
         if (values != nullptr) {
             block->instantiate(values);
             for (auto a : cont->parserLocals)
@@ -206,15 +267,22 @@ Evaluator::processConstructor(
                 visit(a);
         }
         popBlock(block);
+        if (values != nullptr)
+            memoize(node, decl, instanceType, values, block);
         return block;
     } else if (decl->is<IR::Type_Package>()) {
         auto package = decl->to<IR::Type_Package>();
+        auto values = evaluateArguments(package->constructorParams, arguments, current);
+        if (values != nullptr)
+            if (auto cached = findMemoized(node, decl, instanceType, values))
+                return cached;
         auto block = new IR::PackageBlock(node->srcInfo, node, instanceType, package);
         pushBlock(block);
-        auto values = evaluateArguments(package->constructorParams, arguments, current);
         if (values != nullptr)
             block->instantiate(values);
         popBlock(block);
+        if (values != nullptr)
+            memoize(node, decl, instanceType, values, block);
         return block;
     }
 
@@ -34,6 +34,30 @@ class Evaluator final : public Inspector, public IHasBlock {
     std::vector<IR::Block*>  blockStack;
     IR::ToplevelBlock*       toplevelBlock;
 
+    /// Memoized results of processConstructor, keyed by the id of the
+    /// instantiating node (Declaration_Instance or
+    /// ConstructorCallExpression).  The evaluator runs in the frontend and
+    /// again in every backend midend, mostly over instantiations that did
+    /// not change; node ids are never reused, so an entry can only match
+    /// the same node, and an unchanged declaration with equal constructor
+    /// argument values would evaluate to an identical block.  Static
+    /// because a fresh Evaluator is created for every run; entries for
+    /// superseded nodes are simply never looked up again.
+    struct MemoizedBlock {
+        const IR::IDeclaration*                  decl;
+        const IR::Type*                          instanceType;
+        std::vector<const IR::CompileTimeValue*> values;
+        const IR::Block*                         block;
+    };
+    static std::map<int, MemoizedBlock> memoized;
+    const IR::Block* findMemoized(const IR::Node* node, const IR::IDeclaration* decl,
+                                  const IR::Type* instanceType,
+                                  const std::vector<const IR::CompileTimeValue*>* values) const;
+    void memoize(const IR::Node* node, const IR::IDeclaration* decl,
+                 const IR::Type* instanceType,
+                 const std::vector<const IR::CompileTimeValue*>* values,
+                 const IR::Block* block);
+
  protected:
     void pushBlock(IR::Block* block);
     void popBlock(IR::Block* block);
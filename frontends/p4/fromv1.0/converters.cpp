@@ -108,7 +108,7 @@ const IR::Node* ExpressionConverter::postorder(IR::Primitive* primitive) {
 
         const IR::Expression* method = new IR::Member(
             structure->paramReference(structure->parserPacketIn),
-            P4::P4CoreLibrary::instance.packetIn.lookahead.Id());
+            P4::P4CoreLibrary::instance().packetIn.lookahead.Id());
         auto typeargs = new IR::Vector<IR::Type>();
         typeargs->push_back(IR::Type_Bits::get(aval + bval));
         auto lookahead = new IR::MethodCallExpression(method, typeargs);
@@ -189,7 +189,7 @@ const IR::Node* ExpressionConverter::postorder(IR::ConcreteHeaderRef* nhr) {
     if (structure->isHeader(nhr)) {
         ref = structure->conversionContext->header->clone();
     } else {
-        if (nhr->ref->name == P4V1::V1Model::instance.standardMetadata.name)
+        if (nhr->ref->name == P4V1::V1Model::instance().standardMetadata.name)
             return structure->conversionContext->standardMetadata->clone();
         else
             ref = structure->conversionContext->userMetadata->clone();
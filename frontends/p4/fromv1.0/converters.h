@@ -39,7 +39,7 @@ class ExpressionConverter : public Transform {
  public:
     bool replaceNextWithLast;  // if true p[next] becomes p.last
     explicit ExpressionConverter(ProgramStructure* structure)
-            : structure(structure), p4lib(P4::P4CoreLibrary::instance),
+            : structure(structure), p4lib(P4::P4CoreLibrary::instance()),
               replaceNextWithLast(false) { setName("ExpressionConverter"); }
     const IR::Type* getFieldType(const IR::Type_StructLike* ht, cstring fieldName);
     const IR::Node* postorder(IR::Constant* expression) override;
@@ -371,8 +371,8 @@ class ComputeTableCallGraph : public Inspector {
 
         // skip control block that is unused.
         if (!structure->calledControls.isCallee(parent->name) &&
-            parent->name != P4V1::V1Model::instance.ingress.name &&
-            parent->name != P4V1::V1Model::instance.egress.name )
+            parent->name != P4V1::V1Model::instance().ingress.name &&
+            parent->name != P4V1::V1Model::instance().egress.name )
             return;
 
         if (ctrl != nullptr && ctrl != parent) {
@@ -586,7 +586,7 @@ class FixExtracts final : public Transform {
         auto typeArgs = new IR::Vector<IR::Type>();
         typeArgs->push_back(fixed->fixedHeaderType->getP4Type());
         auto lookaheadMethod = new IR::Member(member->expr,
-                                              P4::P4CoreLibrary::instance.packetIn.lookahead.name);
+                                              P4::P4CoreLibrary::instance().packetIn.lookahead.name);
         auto lookahead = new IR::MethodCallExpression(
             mce->srcInfo, lookaheadMethod, typeArgs, new IR::Vector<IR::Argument>());
         auto assign = new IR::AssignmentStatement(
@@ -600,7 +600,7 @@ class FixExtracts final : public Transform {
         auto args = new IR::Vector<IR::Argument>();
         args->push_back(arg->clone());
         auto type = IR::Type_Bits::get(
-            P4::P4CoreLibrary::instance.packetIn.extractSecondArgSize);
+            P4::P4CoreLibrary::instance().packetIn.extractSecondArgSize);
         auto cast = new IR::Cast(Util::SourceInfo(), type, length);
         args->push_back(new IR::Argument(cast));
         auto expression = new IR::MethodCallExpression(
@@ -36,13 +36,18 @@ limitations under the License.
 namespace P4V1 {
 
 ProgramStructure::ProgramStructure() :
-        v1model(P4V1::V1Model::instance), p4lib(P4::P4CoreLibrary::instance),
-        types(&allNames), metadata(&allNames), headers(&allNames), stacks(&allNames),
-        controls(&allNames), parserStates(&allNames), tables(&allNames),
-        actions(&allNames), counters(&allNames), registers(&allNames), meters(&allNames),
-        action_profiles(nullptr), field_lists(nullptr), field_list_calculations(&allNames),
-        action_selectors(nullptr), extern_types(&allNames), externs(&allNames),
-        value_sets(&allNames),
+        v1model(P4V1::V1Model::instance()), p4lib(P4::P4CoreLibrary::instance()),
+        types(&allNames, &nameCounters), metadata(&allNames, &nameCounters),
+        headers(&allNames, &nameCounters), stacks(&allNames, &nameCounters),
+        controls(&allNames, &nameCounters), parserStates(&allNames, &nameCounters),
+        tables(&allNames, &nameCounters), actions(&allNames, &nameCounters),
+        counters(&allNames, &nameCounters), registers(&allNames, &nameCounters),
+        meters(&allNames, &nameCounters),
+        action_profiles(nullptr, nullptr), field_lists(nullptr, nullptr),
+        field_list_calculations(&allNames, &nameCounters),
+        action_selectors(nullptr, nullptr), extern_types(&allNames, &nameCounters),
+        externs(&allNames, &nameCounters),
+        value_sets(&allNames, &nameCounters),
         calledActions("actions"), calledControls("controls"), calledCounters("counters"),
         calledMeters("meters"), calledRegisters("registers"), calledExterns("externs"),
         parsers("parsers"), parserPacketIn(nullptr), parserHeadersOut(nullptr),
@@ -69,7 +74,7 @@ ProgramStructure::addGlobalNameAnnotation(cstring name,
 }
 
 cstring ProgramStructure::makeUniqueName(cstring base) {
-    cstring name = cstring::make_unique(allNames, base, '_');
+    cstring name = cstring::make_unique(allNames, nameCounters, base, '_');
     LOG3(" make unique name " << name);
     allNames.emplace(name);
     return name;
@@ -609,8 +614,8 @@ void ProgramStructure::include(cstring filename, cstring ppoptions) {
 void ProgramStructure::loadModel() {
     // This includes in turn core.p4
     std::stringstream versionArg;
-    versionArg << "-DV1MODEL_VERSION=" << V1Model::instance.version;
-    include(V1Model::instance.file.name, versionArg.str());
+    versionArg << "-DV1MODEL_VERSION=" << V1Model::instance().version;
+    include(V1Model::instance().file.name, versionArg.str());
 
     metadataInstances.insert(v1model.standardMetadataType.name);
     metadataTypes.insert(v1model.standardMetadataType.name);
@@ -2414,7 +2419,7 @@ void ProgramStructure::createChecksumVerifications() {
             if (uov.cond != nullptr)
                 condition = conv.convert(uov.cond);
             else
-                condition = new IR::BoolLiteral(true);
+                condition = IR::BoolLiteral::get(true);
             auto algo = convertHashAlgorithms(flc->algorithm);
             args->push_back(new IR::Argument(condition));
             args->push_back(new IR::Argument(le));
@@ -2479,7 +2484,7 @@ void ProgramStructure::createChecksumUpdates() {
             if (uov.cond != nullptr)
                 condition = conv.convert(uov.cond);
             else
-                condition = new IR::BoolLiteral(true);
+                condition = IR::BoolLiteral::get(true);
             auto algo = convertHashAlgorithms(flc->algorithm);
 
             args->push_back(new IR::Argument(condition));
@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "lib/map.h"
 #include "lib/cstring.h"
+#include "lib/ordered_flat_map.h"
 #include "frontends/p4/coreLibrary.h"
 #include "ir/ir.h"
 #include "frontends/p4/callGraph.h"
@@ -50,28 +51,34 @@ class ProgramStructure {
     class NamedObjectInfo {
         // If allNames is nullptr we don't check for duplicate names
         std::unordered_set<cstring> *allNames;
-        std::map<cstring, T> nameToObject;
-        std::map<T, cstring> objectToNewName;
+        /// Next suffix per base name for renaming clashes; shared with the
+        /// enclosing ProgramStructure so generation is amortized constant
+        /// time (see cstring::make_unique).
+        std::map<cstring, int> *nameCounters;
+        /// The new name is stored alongside the object so iteration does not
+        /// have to look it up separately; the map is keyed by the original
+        /// name to keep the emission order of converted declarations
+        /// deterministic (sorted by name).
+        std::map<cstring, std::pair<T, cstring>> nameToObject;
+        /// Hashed object-to-new-name index for the hot get(T) lookups.
+        ordered_flat_map<T, cstring> objectToNewName;
 
         // Iterate in order of name, but return pair<T, newname>
         class iterator {
             friend class NamedObjectInfo;
          private:
-            typename std::map<cstring, T>::iterator it;
-            typename std::map<T, cstring> &objToName;
-            iterator(typename std::map<cstring, T>::iterator it,
-                     typename std::map<T, cstring> &objToName) :
-                    it(it), objToName(objToName) {}
+            typename std::map<cstring, std::pair<T, cstring>>::iterator it;
+            explicit iterator(typename std::map<cstring, std::pair<T, cstring>>::iterator it) :
+                    it(it) {}
          public:
             const iterator& operator++() { ++it; return *this; }
             bool operator!=(const iterator& other) const { return it != other.it; }
-            std::pair<T, cstring> operator*() const {
-                return std::pair<T, cstring>(it->second, objToName[it->second]);
-            }
+            std::pair<T, cstring> operator*() const { return it->second; }
         };
 
      public:
-        explicit NamedObjectInfo(std::unordered_set<cstring>* allNames) : allNames(allNames) {}
+        NamedObjectInfo(std::unordered_set<cstring>* allNames, std::map<cstring, int>* counters) :
+                allNames(allNames), nameCounters(counters) {}
         void emplace(T obj) {
             if (objectToNewName.find(obj) != objectToNewName.end()) {
                 // Already done
@@ -79,29 +86,30 @@ class ProgramStructure {
                 return;
             }
 
-            nameToObject.emplace(obj->name, obj);
             cstring newName;
-
             if (allNames == nullptr ||
                 (allNames->find(obj->name) == allNames->end())) {
                 newName = obj->name;
             } else {
-                newName = cstring::make_unique(*allNames, obj->name, '_');
+                newName = cstring::make_unique(*allNames, *nameCounters, obj->name, '_');
             }
             if (allNames != nullptr)
                 allNames->emplace(newName);
             LOG3("Discovered " << obj << " named " << newName);
+            nameToObject.emplace(obj->name, std::make_pair(obj, newName));
             objectToNewName.emplace(obj, newName);
         }
         /// Lookup using the original name
-        T get(cstring name) const { return ::get(nameToObject, name); }
+        T get(cstring name) const {
+            auto it = nameToObject.find(name);
+            return it == nameToObject.end() ? T() : it->second.first; }
         /// Get the new name
         cstring get(T object) const { return ::get(objectToNewName, object, object->name.name); }
         /// Get the new name from the old name
         cstring newname(cstring name) const { return get(get(name)); }
         bool contains(cstring name) const { return nameToObject.find(name) != nameToObject.end(); }
-        iterator begin() { return iterator(nameToObject.begin(), objectToNewName); }
-        iterator end() { return iterator(nameToObject.end(), objectToNewName); }
+        iterator begin() { return iterator(nameToObject.begin()); }
+        iterator end() { return iterator(nameToObject.end()); }
         void erase(cstring name) {
             allNames->erase(name);
             auto obj = get(name);
@@ -119,6 +127,9 @@ class ProgramStructure {
     P4::P4CoreLibrary &p4lib;
 
     std::unordered_set<cstring>                 allNames;
+    /// Next suffix to try per base name in makeUniqueName; see
+    /// cstring::make_unique.
+    std::map<cstring, int>                      nameCounters;
     NamedObjectInfo<const IR::Type_StructLike*> types;
     NamedObjectInfo<const IR::HeaderOrMetadata*> metadata;
     NamedObjectInfo<const IR::Header*>          headers;
@@ -135,12 +146,16 @@ class ProgramStructure {
     NamedObjectInfo<const IR::FieldListCalculation*> field_list_calculations;
     NamedObjectInfo<const IR::ActionSelector*>  action_selectors;
     NamedObjectInfo<const IR::Type_Extern *>    extern_types;
-    std::map<const IR::Type_Extern *, const IR::Type_Extern *>  extern_remap;
+    // Pointer-keyed bookkeeping uses ordered_flat_map: lookups hash the
+    // pointer instead of walking a tree, and iteration is insertion-ordered
+    // rather than address-ordered (std::map over pointers iterates in
+    // allocation order, which is not deterministic).
+    ordered_flat_map<const IR::Type_Extern *, const IR::Type_Extern *>  extern_remap;
     NamedObjectInfo<const IR::Declaration_Instance *>  externs;
     NamedObjectInfo<const IR::ParserValueSet*>  value_sets;
     std::set<cstring>                           value_sets_implemented;
     std::vector<const IR::CalculatedField*>     calculated_fields;
-    std::map<const IR::Node *, const IR::Declaration_Instance *>        globalInstances;
+    ordered_flat_map<const IR::Node *, const IR::Declaration_Instance *>        globalInstances;
     P4::CallGraph<cstring> calledActions;
     P4::CallGraph<cstring> calledControls;
     P4::CallGraph<cstring> calledCounters;
@@ -152,11 +167,11 @@ class ProgramStructure {
     std::map<cstring, cstring> directCounters;  /// Maps table to direct counter.
     /// Maps table name to direct meter.
     std::map<cstring, const IR::Meter*> directMeters;
-    std::map<const IR::Meter*, const IR::Declaration_Instance*> meterMap;
+    ordered_flat_map<const IR::Meter*, const IR::Declaration_Instance*> meterMap;
     std::map<cstring, const IR::Declaration_Instance*> counterMap;
 
-    std::map<const IR::V1Table*, const IR::V1Control*> tableMapping;
-    std::map<const IR::V1Table*, const IR::Apply*> tableInvocation;
+    ordered_flat_map<const IR::V1Table*, const IR::V1Control*> tableMapping;
+    ordered_flat_map<const IR::V1Table*, const IR::Apply*> tableInvocation;
     /// Some types are transformed during conversion; this maps the
     /// original P4-14 header type name to the final P4-16
     /// Type_Header.  We can't use the P4-14 type object itself as a
@@ -169,7 +184,7 @@ class ProgramStructure {
     /// Maps each inserted extract statement to the type of the header
     /// type that is being extracted.  The extracts will need another
     /// pass to cope with varbit fields.
-    std::map<const IR::MethodCallExpression*, const IR::Type_Header*> extractsSynthesized;
+    ordered_flat_map<const IR::MethodCallExpression*, const IR::Type_Header*> extractsSynthesized;
 
     std::map<cstring, const IR::ParserState*> parserEntryPoints;
 
@@ -34,7 +34,7 @@ struct Parser_Model : public ::Model::Elem {
     Parser_Model(Model::Type_Model headersType, Model::Type_Model userMetaType,
                  Model::Type_Model standardMetadataType) :
             Model::Elem("ParserImpl"),
-            packetParam("packet", P4::P4CoreLibrary::instance.packetIn, 0),
+            packetParam("packet", P4::P4CoreLibrary::instance().packetIn, 0),
             headersParam("hdr", headersType, 1),
             metadataParam("meta", userMetaType, 2),
             standardMetadataParam("standard_metadata", standardMetadataType, 3)
@@ -48,7 +48,7 @@ struct Parser_Model : public ::Model::Elem {
 struct Deparser_Model : public ::Model::Elem {
     explicit Deparser_Model(Model::Type_Model headersType) :
             Model::Elem("DeparserImpl"),
-            packetParam("packet", P4::P4CoreLibrary::instance.packetOut, 0),
+            packetParam("packet", P4::P4CoreLibrary::instance().packetOut, 0),
             headersParam("hdr", headersType, 1)
     {}
     ::Model::Param_Model packetParam;
@@ -309,14 +309,14 @@ class V1Model : public ::Model::Model {
 
     bool haveIndexTypeParam() const { return version >= 20200408; }  // depends on version
 
-    static V1Model instance;
+    static V1Model& instance();
 };
 
 class getV1ModelVersion : public Inspector {
     bool preorder(const IR::Declaration_Constant *dc) override {
         if (dc->name == "__v1model_version") {
             auto val = dc->initializer->to<IR::Constant>();
-            V1Model::instance.version = static_cast<unsigned>(val->value); }
+            V1Model::instance().version = static_cast<unsigned>(val->value); }
         return false; }
     bool preorder(const IR::Declaration *) override { return false; }
 };
@@ -18,6 +18,7 @@ limitations under the License.
 #include <fstream>
 
 #include "ir/ir.h"
+#include "../common/compileCache.h"
 #include "../common/options.h"
 #include "lib/nullstream.h"
 #include "lib/path.h"
@@ -123,31 +124,49 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
     if (program == nullptr && options.listFrontendPasses == 0)
         return nullptr;
 
+    bool cacheable = CompileCache::enabled(options) && options.sourceDigest != nullptr &&
+                     !options.listFrontendPasses && !options.excludeFrontendPasses;
+    if (cacheable)
+        if (auto cached = CompileCache::lookup(options, options.sourceDigest, "frontend"))
+            return cached;
+
     bool isv1 = options.isv1();
     ReferenceMap  refMap;
     TypeMap       typeMap;
     refMap.setIsV1(isv1);
 
+    // shared by the folding passes below, so repeated folding (e.g. the
+    // PassRepeated fixpoint) skips subtrees that are known not to fold
+    auto foldCache = new ConstantFoldingCache();
+
     auto evaluator = new P4::EvaluatorPass(&refMap, &typeMap);
     PassManager passes({
         new P4V1::getV1ModelVersion,
         // Parse annotations
         new ParseAnnotationBodies(&parseAnnotations, &typeMap),
-        new PrettyPrint(options),
-        // Simple checks on parsed program
-        new ValidateParsedProgram(),
+        // Analysis-only passes that do not touch the tree; run them
+        // concurrently (diagnostics still come out in pass order).
+        new ParallelPassGroup({
+            new PrettyPrint(options),
+            // Simple checks on parsed program
+            new ValidateParsedProgram(),
+        }),
         // Synthesize some built-in constructs
         new CreateBuiltins(),
         new ResolveReferences(&refMap, true),  // check shadowing
         // First pass of constant folding, before types are known --
         // may be needed to compute types.
-        new ConstantFolding(&refMap, nullptr),
+        new ConstantFolding(&refMap, nullptr, true, nullptr, foldCache),
         // Desugars direct parser and control applications
         // into instantiations followed by application
         new InstantiateDirectCalls(&refMap),
         new ResolveReferences(&refMap),  // check shadowing
-        new Deprecated(&refMap),
-        new CheckNamedArgs(),
+        // refMap is fresh from the ResolveReferences above; these checks
+        // only read it and the tree, so they can run concurrently.
+        new ParallelPassGroup({
+            new CheckDeprecated(&refMap),
+            new CheckNamedArgs(),
+        }),
         // Type checking and type inference.  Also inserts
         // explicit casts where implicit casts exist.
         new TypeInference(&refMap, &typeMap, false),  // insert casts
@@ -162,13 +181,13 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
         new SpecializeGenericFunctions(&refMap, &typeMap),
         new TableKeyNames(&refMap, &typeMap),
         PassRepeated({
-            new ConstantFolding(&refMap, &typeMap),
+            new ConstantFolding(&refMap, &typeMap, true, nullptr, foldCache),
             new StrengthReduction(&refMap, &typeMap),
             new Reassociation(),
             new UselessCasts(&refMap, &typeMap)
         }),
         new SimplifyControlFlow(&refMap, &typeMap),
-        new SwitchAddDefault,
+        new PassIfFeature(FeatureCensus::Switches, {new SwitchAddDefault}),
         new FrontEndDump(),  // used for testing the program at this point
         new RemoveAllUnusedDeclarations(&refMap, true),
         new SimplifyParsers(&refMap),
@@ -184,7 +203,7 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
         new SimplifyControlFlow(&refMap, &typeMap),
         new SpecializeAll(&refMap, &typeMap),
         new RemoveParserControlFlow(&refMap, &typeMap),
-        new RemoveReturns(&refMap),
+        new PassIfFeature(FeatureCensus::Returns, {new RemoveReturns(&refMap)}),
         new RemoveDontcareArgs(&refMap, &typeMap),
         new MoveConstructors(&refMap),
         new RemoveAllUnusedDeclarations(&refMap),
@@ -200,8 +219,9 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
         new RemoveParserControlFlow(&refMap, &typeMap),
         new UniqueNames(&refMap),
         new LocalizeAllActions(&refMap),
-        new UniqueNames(&refMap),  // needed again after inlining
-        new UniqueParameters(&refMap, &typeMap),
+        // needed again after inlining; accumulates the symbol and
+        // parameter renames and applies them in one traversal
+        new RenameAll(&refMap, &typeMap),
         new SimplifyControlFlow(&refMap, &typeMap),
         new HierarchicalNames(),
         new FrontEndLast(),
@@ -220,6 +240,8 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
     passes.setStopOnError(true);
     passes.addDebugHooks(hooks, true);
     const IR::P4Program* result = program->apply(passes);
+    if (cacheable && result != nullptr && ::errorCount() == 0)
+        CompileCache::store(options, options.sourceDigest, "frontend", result);
     return result;
 }
 
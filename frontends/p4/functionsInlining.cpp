@@ -51,12 +51,35 @@ void FunctionsInliner::end_apply(const IR::Node*) {
 }
 
 Visitor::profile_t FunctionsInliner::init_apply(const IR::Node* node) {
-    P4::ResolveReferences solver(refMap, true);
-    node->apply(solver);
-    LOG2("FunctionsInliner " << toInline);
+    if (!nested) {
+        // Helper inliners reuse the references already resolved here; the
+        // declarations they create are added to the refMap as they are built.
+        P4::ResolveReferences solver(refMap, true);
+        node->apply(solver);
+        inlinedCallees->clear();
+        LOG2("FunctionsInliner " << toInline);
+    }
     return Transform::init_apply(node);
 }
 
+const IR::Node* FunctionsInliner::getInlinedVersion(const IR::Node* callee) {
+    auto sites = toInline->sites.find(callee);
+    if (sites == toInline->sites.end() || sites->second.empty())
+        return callee;
+    // The callee has calls of its own in the work list, so its callers must
+    // inline the version with those calls already substituted.  Since P4
+    // requires declarations before use, the callee has normally been visited
+    // already and its inlined version saved; if not, compute it now.  The
+    // call graph is acyclic, so this recursion terminates.
+    auto& version = (*inlinedCallees)[callee];
+    if (version == nullptr) {
+        FunctionsInliner helper(this);
+        version = callee->apply(helper);
+        CHECK_NULL(version);
+    }
+    return version;
+}
+
 bool FunctionsInliner::preCaller() {
     LOG2("Visiting: " << dbp(getOriginal()));
     if (toInline->sites.count(getOriginal()) == 0) {
@@ -70,8 +93,12 @@ bool FunctionsInliner::preCaller() {
 
 const IR::Node* FunctionsInliner::postCaller(const IR::Node* node) {
     LOG2("Ending: " << dbp(getOriginal()));
-    if (toInline->sites.count(getOriginal()) > 0)
+    if (toInline->sites.count(getOriginal()) > 0) {
         list->replace(getOriginal(), node);
+        // Save the result: if this caller is also a callee in the work
+        // list, its own callers must inline this version.
+        (*inlinedCallees)[getOriginal()] = node;
+    }
     BUG_CHECK(!replacementStack.empty(), "Empty replacement stack");
     replacementStack.pop_back();
     return node;
@@ -175,6 +202,7 @@ const IR::Node* FunctionsInliner::inlineBefore(
     const IR::Node* calleeNode, const IR::MethodCallExpression* mce,
     const IR::Statement* statement) {
     LOG2("Inlining: " << dbp(calleeNode) << " before " << dbp(statement));
+    calleeNode = getInlinedVersion(calleeNode);
 
     auto callee = calleeNode->to<IR::Function>();
     BUG_CHECK(callee, "%1%: expected a function", calleeNode);
@@ -183,7 +211,8 @@ const IR::Node* FunctionsInliner::inlineBefore(
     ParameterSubstitution subst;
     TypeVariableSubstitution tvs;  // empty
 
-    std::map<const IR::Parameter*, cstring> paramRename;
+    // Local copies standing in for the parameters, by parameter.
+    std::map<const IR::Parameter*, const IR::Declaration_Variable*> paramCopies;
     ParameterSubstitution substitution;
     substitution.populate(callee->type->parameters, mce->arguments);
 
@@ -191,13 +220,17 @@ const IR::Node* FunctionsInliner::inlineBefore(
     for (auto param : callee->type->parameters->parameters) {
         auto argument = substitution.lookup(param);
         cstring newName = refMap->newName(param->name);
-        paramRename.emplace(param, newName);
         if (param->direction == IR::Direction::In || param->direction == IR::Direction::InOut) {
             auto vardecl = new IR::Declaration_Variable(newName, param->annotations,
                                                         param->type, argument->expression);
             body.push_back(vardecl);
-            subst.add(param, new IR::Argument(
-                argument->srcInfo, argument->name, new IR::PathExpression(newName)));
+            paramCopies.emplace(param, vardecl);
+            auto paramRef = new IR::PathExpression(newName);
+            // Resolve the new reference right away: the body we build here
+            // may be inlined again further up the call chain, without a
+            // reference re-resolution in between.
+            refMap->setDeclaration(paramRef->path, vardecl);
+            subst.add(param, new IR::Argument(argument->srcInfo, argument->name, paramRef));
         } else if (param->direction == IR::Direction::None) {
             // This works because there can be no side-effects in the evaluation of this
             // argument.
@@ -206,8 +239,10 @@ const IR::Node* FunctionsInliner::inlineBefore(
             // uninitialized variable
             auto vardecl = new IR::Declaration_Variable(newName,
                                                         param->annotations, param->type);
-            subst.add(param, new IR::Argument(
-                argument->srcInfo, argument->name, new IR::PathExpression(newName)));
+            paramCopies.emplace(param, vardecl);
+            auto paramRef = new IR::PathExpression(newName);
+            refMap->setDeclaration(paramRef->path, vardecl);
+            subst.add(param, new IR::Argument(argument->srcInfo, argument->name, paramRef));
             body.push_back(vardecl);
         }
     }
@@ -225,8 +260,9 @@ const IR::Node* FunctionsInliner::inlineBefore(
     for (auto param : callee->type->parameters->parameters) {
         auto left = substitution.lookup(param);
         if (param->direction == IR::Direction::InOut || param->direction == IR::Direction::Out) {
-            cstring newName = ::get(paramRename, param);
-            auto right = new IR::PathExpression(newName);
+            auto vardecl = ::get(paramCopies, param);
+            auto right = new IR::PathExpression(vardecl->name);
+            refMap->setDeclaration(right->path, vardecl);
             auto copyout = new IR::AssignmentStatement(left->expression, right);
             body.push_back(copyout);
         }
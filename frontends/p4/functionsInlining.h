@@ -55,6 +55,22 @@ class FunctionsInliner : public AbstractInliner<FunctionsInlineList, FunctionsIn
     typedef std::map<const IR::Statement*, const IR::Node*> ReplacementMap;
     /// A stack of replacement maps
     std::vector<ReplacementMap*> replacementStack;
+    /// Inlined versions of the callees which are themselves callers in the
+    /// current work list; such nested calls only appear when the work list
+    /// holds the whole inlining plan (see SimpleInlineList).
+    std::map<const IR::Node*, const IR::Node*>* inlinedCallees;
+    /// True in the helper inliners created by getInlinedVersion.
+    bool nested;
+
+    /// Creates a helper inliner sharing the state of @p parent; it is
+    /// applied to a single callee to inline the callee's own calls.
+    explicit FunctionsInliner(FunctionsInliner* parent) :
+            refMap(parent->refMap), inlinedCallees(parent->inlinedCallees), nested(true)
+    { prepare(parent->list, parent->toInline); }
+    /// The version of @p callee which should be inlined into its callers:
+    /// @p callee itself if it has no calls to inline, otherwise a copy of
+    /// @p callee with all its own calls already inlined.
+    const IR::Node* getInlinedVersion(const IR::Node* callee);
 
     /// Clones the body of a function without the return statement;
     /// returns the expression of a return statement.  This assumes
@@ -72,7 +88,8 @@ class FunctionsInliner : public AbstractInliner<FunctionsInlineList, FunctionsIn
     void dumpReplacementMap() const;
 
  public:
-    explicit FunctionsInliner(bool isv1) : refMap(new P4::ReferenceMap())
+    explicit FunctionsInliner(bool isv1) : refMap(new P4::ReferenceMap()),
+            inlinedCallees(new std::map<const IR::Node*, const IR::Node*>()), nested(false)
     { refMap->setIsV1(isv1); }
     Visitor::profile_t init_apply(const IR::Node* node) override;
     void end_apply(const IR::Node* node) override;
@@ -90,7 +107,12 @@ class InlineFunctions : public PassRepeated {
     FunctionsInlineList functionsToInline;
 
  public:
-    InlineFunctions(ReferenceMap* refMap, TypeMap* typeMap) {
+    /// With @p bulk, all functions are inlined in a single traversal of
+    /// the program instead of one traversal per level of the call chain;
+    /// fresh names are then allocated in a different order, so enabling it
+    /// requires regenerating the reference outputs.
+    InlineFunctions(ReferenceMap* refMap, TypeMap* typeMap, bool bulk = false) :
+            functionsToInline(bulk) {
         passes.push_back(new TypeChecking(refMap, typeMap));
         passes.push_back(new DiscoverFunctionsInlining(&functionsToInline, refMap, typeMap));
         passes.push_back(new InlineFunctionsDriver(&functionsToInline,
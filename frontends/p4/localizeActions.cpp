@@ -156,6 +156,17 @@ bool FindRepeatedActionUses::preorder(const IR::PathExpression* expression) {
     }
 
     LOG1(dbp(expression) << " used by " << dbp(actionUser));
+    // The first user keeps the shared original definition; only
+    // additional users pay for a clone.  The body of an action does not
+    // depend on its caller, so the copies are only needed to give each
+    // table its own named action.
+    auto first = ::get(repl->firstUser, action);
+    if (first == nullptr) {
+        repl->firstUser.emplace(action, actionUser);
+        return false;
+    }
+    if (first == actionUser)
+        return false;
     auto replacement = repl->getActionUser(action, actionUser);
     if (replacement == nullptr) {
         auto newName = refMap->newName(action->name);
@@ -85,6 +85,10 @@ class ActionReplacement {
     std::map<const IR::PathExpression*, const IR::P4Action*> repl;
     // For each action all replacements to insert
 
+    // The first user of each action; it keeps using the original
+    // definition, so actions with a single user are never cloned.
+    std::map<const IR::P4Action*, const IR::Node*> firstUser;
+
     const IR::P4Action* getActionUser(const IR::P4Action* action, const IR::Node* user) {
         if (toInsert.find(action) == toInsert.end())
             return nullptr;
@@ -111,9 +115,10 @@ class ActionReplacement {
     }
 };
 
-// Find actions that are invoked in multiple places; create a new
-// copy for each invocation and store it in the repl map.  Ignores
-// actions that are not in a control.
+// Find actions that are invoked in multiple places; the first user
+// keeps the shared original definition and each additional user gets a
+// new copy, stored in the repl map.  Actions with a single user are
+// thus left alone.  Ignores actions that are not in a control.
 class FindRepeatedActionUses : public Inspector {
     ReferenceMap* refMap;
     ActionReplacement* repl;
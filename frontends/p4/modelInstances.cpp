@@ -17,17 +17,27 @@ limitations under the License.
 #include "coreLibrary.h"
 #include "fromv1.0/v1model.h"
 
+/* The model objects are constructed on first use rather than at program
+ * startup: a run that never touches an architecture (or exits early, as
+ * --version does) never pays for building its model.  Function-local statics
+ * also make the initialization order explicit -- constructing V1Model pulls
+ * in P4CoreLibrary::instance() as needed. */
+
 namespace P4 {
 
-P4CoreLibrary P4CoreLibrary::instance;
+P4CoreLibrary& P4CoreLibrary::instance() {
+    static P4CoreLibrary model;
+    return model;
+}
 
 }  // namespace P4
 
-/* These must be in the same compiliation unit to ensure that P4CoreLibrary::instance
- * is initialized before V1Model::instance */
 namespace P4V1 {
 
-V1Model V1Model::instance;
+V1Model& V1Model::instance() {
+    static V1Model model;
+    return model;
+}
 
 }  // namespace P4V1
 
@@ -23,6 +23,7 @@ const IR::Node* MoveDeclarations::postorder(IR::P4Action* action)  {
         // Else let the parent control get these
         auto body = new IR::IndexedVector<IR::StatOrDecl>();
         auto m = getMoves();
+        body->reserve(m->size() + action->body->components.size());
         body->insert(body->end(), m->begin(), m->end());
         body->append(action->body->components);
         action->body = new IR::BlockStatement(
@@ -34,22 +35,21 @@ const IR::Node* MoveDeclarations::postorder(IR::P4Action* action)  {
 
 const IR::Node* MoveDeclarations::postorder(IR::P4Control* control)  {
     LOG1("Visiting " << control << " toMove " << toMove.size());
-    auto decls = new IR::IndexedVector<IR::Declaration>();
-    for (auto decl : *getMoves()) {
-        LOG1("Moved " << decl);
-        decls->push_back(decl);
-    }
-    decls->append(control->controlLocals);
-    control->controlLocals = *decls;
+    auto m = getMoves();
+    if (LOGGING(1))
+        for (auto decl : *m)
+            LOG1("Moved " << decl);
+    // Splice the whole batch in front of the existing locals at once:
+    // one shift of the tail rather than one per moved declaration, and no
+    // temporary vector to copy back.  Post-inlining controls can have
+    // thousands of moved locals, which made the rebuild quadratic.
+    control->controlLocals.prepend(*m);
     pop();
     return control;
 }
 
 const IR::Node* MoveDeclarations::postorder(IR::P4Parser* parser)  {
-    auto newStateful = new IR::IndexedVector<IR::Declaration>();
-    newStateful->append(*getMoves());
-    newStateful->append(parser->parserLocals);
-    parser->parserLocals = *newStateful;
+    parser->parserLocals.prepend(*getMoves());
     pop();
     return parser;
 }
@@ -57,6 +57,7 @@ const IR::Node* MoveDeclarations::postorder(IR::P4Parser* parser)  {
 const IR::Node* MoveDeclarations::postorder(IR::Function* function)  {
     auto body = new IR::IndexedVector<IR::StatOrDecl>();
     auto m = getMoves();
+    body->reserve(m->size() + function->body->components.size());
     body->insert(body->end(), m->begin(), m->end());
     body->append(function->body->components);
     function->body = new IR::BlockStatement(
@@ -156,6 +157,7 @@ const IR::Node* MoveInitializers::postorder(IR::ParserState* state) {
 const IR::Node* MoveInitializers::postorder(IR::P4Control* control) {
     if (toMove->empty())
         return control;
+    toMove->reserve(toMove->size() + control->body->components.size());
     toMove->append(control->body->components);
     auto newBody = new IR::BlockStatement(control->body->annotations, *toMove);
     control->body = newBody;
@@ -62,10 +62,10 @@ const IR::Node* DoRemoveParserControlFlow::postorder(IR::ParserState* state) {
             // left-over
             auto vec = new IR::Vector<IR::Expression>();
             vec->push_back(ifstat->condition);
-            auto trueCase = new IR::SelectCase(new IR::BoolLiteral(true),
+            auto trueCase = new IR::SelectCase(IR::BoolLiteral::get(true),
                 new IR::PathExpression(IR::ID(trueName, nullptr)));
             auto falseCase = new IR::SelectCase(
-                new IR::BoolLiteral(false),
+                IR::BoolLiteral::get(false),
                 new IR::PathExpression(IR::ID(falseName, nullptr)));
             auto cases = new IR::Vector<IR::SelectCase>();
             cases->push_back(trueCase);
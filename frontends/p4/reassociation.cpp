@@ -16,9 +16,50 @@ limitations under the License.
 
 #include "reassociation.h"
 
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "frontends/p4/sideEffects.h"
+
 namespace P4 {
 
+namespace {
+/// A deterministic textual key for canonical operand ordering: equal
+/// subexpressions print equally, so sorting makes them line up across
+/// different chains.
+std::string fingerprint(const IR::Expression* expr) {
+    std::ostringstream str;
+    str << expr;
+    return str.str();
+}
+}  // namespace
+
+void Reassociation::flatten(const IR::Operation_Binary* root, cstring op,
+                            safe_vector<const IR::Expression*>* leaves) const {
+    for (auto e : { root->left, root->right }) {
+        auto bin = e->to<IR::Operation_Binary>();
+        if (bin != nullptr && bin->getStringOp() == op)
+            flatten(bin, op, leaves);
+        else
+            leaves->push_back(e);
+    }
+}
+
+IR::Operation_Binary* Reassociation::makeBinary(
+        const IR::Operation_Binary* model, const IR::Expression* left,
+        const IR::Expression* right) const {
+    auto result = dynamic_cast<IR::Operation_Binary*>(model->clone());
+    result->left = left;
+    result->right = right;
+    return result;
+}
+
 const IR::Node* Reassociation::reassociate(IR::Operation_Binary* root) {
+    if (canonicalize)
+        return canonicalizeChain(root);
+    // Default mode: only combine adjacent constants, leaving the rest of
+    // the chain untouched.
     auto right = root->right->to<IR::Constant>();
     if (!right)
         return root;
@@ -29,12 +70,63 @@ const IR::Node* Reassociation::reassociate(IR::Operation_Binary* root) {
         return root;
     if (!leftBin->right->is<IR::Constant>())
         return root;
-    auto c = dynamic_cast<IR::Operation_Binary*>(root->clone());
-    c->left = leftBin->right;
-    c->right = root->right;
+    auto c = makeBinary(root, leftBin->right, root->right);
     root->left = leftBin->left;
     root->right = c;
     return root;
 }
 
+const IR::Node* Reassociation::canonicalizeChain(IR::Operation_Binary* root) {
+    cstring op = root->getStringOp();
+    // Only rebuild at the topmost operator of a chain: the visit of a
+    // same-operator parent sees the whole chain at once.
+    if (getContext() != nullptr)
+        if (auto parent = getContext()->node->to<IR::Operation_Binary>())
+            if (parent->getStringOp() == op)
+                return root;
+
+    safe_vector<const IR::Expression*> leaves;
+    flatten(root, op, &leaves);
+
+    safe_vector<const IR::Expression*> operands, constants;
+    bool pure = true;
+    for (auto leaf : leaves) {
+        if (leaf->is<IR::Constant>()) {
+            constants.push_back(leaf);
+        } else {
+            operands.push_back(leaf);
+            pure = pure && !SideEffects::check(leaf, nullptr, nullptr);
+        }
+    }
+
+    auto byFingerprint = [](const IR::Expression* a, const IR::Expression* b)
+    { return fingerprint(a) < fingerprint(b); };
+    // Reordering evaluation is only safe when no operand has side
+    // effects; constants can always be clustered and sorted.
+    if (pure)
+        std::stable_sort(operands.begin(), operands.end(), byFingerprint);
+    std::stable_sort(constants.begin(), constants.end(), byFingerprint);
+
+    // Rebuild the chain left-deep, with all the constants in a subtree
+    // of their own on the far right so constant folding collapses them.
+    auto build = [this, root](const safe_vector<const IR::Expression*>& ops) {
+        const IR::Expression* tree = ops.front();
+        for (size_t i = 1; i < ops.size(); ++i)
+            tree = makeBinary(root, tree, ops.at(i));
+        return tree;
+    };
+    const IR::Expression* result;
+    if (operands.empty())
+        result = build(constants);
+    else if (constants.empty())
+        result = build(operands);
+    else
+        result = makeBinary(root, build(operands), build(constants));
+    // Avoid churning the IR (and defeating fixpoint detection in
+    // repeated passes) when the chain is already in canonical form.
+    if (result->equiv(*root))
+        return root;
+    return result;
+}
+
 }  // namespace P4
@@ -22,11 +22,40 @@ limitations under the License.
 namespace P4 {
 
 /** Implements a pass that reorders associative operations when beneficial.
-  * For example, (a + c0) + c1 is rewritten as a + (c0 + c1) when cs are constants.
+  *
+  * By default it rewrites (a op c1) op c2 as a op (c1 op c2) for a
+  * commutative operator (`+`, `*`, `|`, `&`, `^`) and constants c1, c2,
+  * so that constant folding can collapse them.
+  *
+  * When constructed with canonicalize = true, a whole chain of one such
+  * operator is flattened, all its constant operands are clustered into a
+  * single subtree, and -- when no operand has side effects -- the
+  * remaining operands are put into a canonical order, so that equal
+  * subexpressions of different chains end up in the same positions where
+  * common subexpression elimination can find them.  For example,
+  * (c0 + a) + (b + c1) is rewritten as (a + b) + (c0 + c1).  This mode
+  * changes the shape of emitted expressions, so it is not yet enabled in
+  * the default frontend pipeline; the reference outputs have to be
+  * regenerated first.
   */
 class Reassociation final : public Transform {
+    /// If true, rewrite whole chains into canonical form; otherwise only
+    /// combine adjacent constants.
+    bool canonicalize;
+
+    /// Appends the leaves of the maximal chain of @p op operators rooted
+    /// at @p root to @p leaves, from left to right.
+    void flatten(const IR::Operation_Binary* root, cstring op,
+                 safe_vector<const IR::Expression*>* leaves) const;
+    /// @returns a copy of @p model with the given operands.
+    IR::Operation_Binary* makeBinary(const IR::Operation_Binary* model,
+                                     const IR::Expression* left,
+                                     const IR::Expression* right) const;
+    const IR::Node* canonicalizeChain(IR::Operation_Binary* root);
+
  public:
-    Reassociation() { visitDagOnce = true; setName("Reassociation"); }
+    explicit Reassociation(bool canonicalize = false) : canonicalize(canonicalize)
+    { visitDagOnce = true; setName("Reassociation"); }
     using Transform::postorder;
 
     const IR::Node* reassociate(IR::Operation_Binary* root);
@@ -30,7 +30,7 @@ const IR::Node* DoRemoveReturns::preorder(IR::P4Action* action) {
     LOG3("Processing " << dbp(action));
     cstring var = refMap->newName(variableName);
     returnVar = IR::ID(var, nullptr);
-    auto f = new IR::BoolLiteral(false);
+    auto f = IR::BoolLiteral::get(false);
     auto decl = new IR::Declaration_Variable(returnVar, IR::Type_Boolean::get(), f);
     BUG_CHECK(stack.empty(), "Non-empty stack");
     push();
@@ -72,7 +72,7 @@ const IR::Node* DoRemoveReturns::preorder(IR::Function* function) {
         returnedValue = IR::ID(var, nullptr);
         retvalDecl = new IR::Declaration_Variable(returnedValue, function->type->returnType);
     }
-    auto f = new IR::BoolLiteral(false);
+    auto f = IR::BoolLiteral::get(false);
     auto decl = new IR::Declaration_Variable(returnVar, IR::Type_Boolean::get(), f);
     BUG_CHECK(stack.empty(), "Non-empty stack");
     push();
@@ -104,7 +104,7 @@ const IR::Node* DoRemoveReturns::preorder(IR::P4Control* control) {
 
     cstring var = refMap->newName(variableName);
     returnVar = IR::ID(var, nullptr);
-    auto f = new IR::BoolLiteral(false);
+    auto f = IR::BoolLiteral::get(false);
     auto decl = new IR::Declaration_Variable(returnVar, IR::Type_Boolean::get(), f);
     BUG_CHECK(stack.empty(), "Non-empty stack");
     push();
@@ -126,7 +126,7 @@ const IR::Node* DoRemoveReturns::preorder(IR::ReturnStatement* statement) {
 
     auto left = new IR::PathExpression(returnVar);
     vec->push_back(new IR::AssignmentStatement(statement->srcInfo, left,
-                                               new IR::BoolLiteral(true)));
+                                               IR::BoolLiteral::get(true)));
     if (statement->expression != nullptr) {
         left = new IR::PathExpression(returnedValue);
         vec->push_back(new IR::AssignmentStatement(statement->srcInfo, left,
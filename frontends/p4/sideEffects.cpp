@@ -140,27 +140,35 @@ const IR::Node* DoSimplifyExpressions::preorder(IR::Operation_Unary* expression)
 
 const IR::Node* DoSimplifyExpressions::preorder(IR::StructExpression* expression) {
     LOG3("Visiting " << dbp(expression));
-    bool foundEffect = false;
-    for (auto v : expression->components) {
-        if (SideEffects::check(v->expression, refMap, typeMap)) {
-            foundEffect = true;
-            break;
-        }
-    }
-    if (!foundEffect)
+    const IR::NamedExpression* lastEffects = nullptr;
+    for (auto v : expression->components)
+        if (SideEffects::check(v->expression, refMap, typeMap))
+            lastEffects = v;
+    if (lastEffects == nullptr)
         return expression;
-    // allocate temporaries for all members in order.
-    // this will handle cases like a = (S) { b, f(b) }, where f can mutate b.
+    // allocate temporaries for the members preceding the last one with side
+    // effects: this handles cases like a = (S) { b, f(b) }, where f can
+    // mutate b.  From that member on nothing effectful runs before the
+    // whole expression is consumed, so those can stay in place once their
+    // calls have been lifted into statements.
     IR::IndexedVector<IR::NamedExpression> vec;
     LOG3("Dismantling " << dbp(expression));
+    bool needTemp = true;
     for (auto &v : expression->components) {
+        if (v == lastEffects)
+            needTemp = false;
         auto t = typeMap->getType(v->expression, true);
-        auto tmp = createTemporary(t);
         visit(v);
-        auto path = addAssignment(expression->srcInfo, tmp, v->expression);
-        typeMap->setType(path, t);
-        // We cannot directly mutate v, because of https://github.com/p4lang/p4c/issues/43
-        vec.push_back(new IR::NamedExpression(v->name, path));
+        if (needTemp) {
+            auto tmp = createTemporary(t);
+            auto path = addAssignment(expression->srcInfo, tmp, v->expression);
+            typeMap->setType(path, t);
+            // We cannot directly mutate v, because of
+            // https://github.com/p4lang/p4c/issues/43
+            vec.push_back(new IR::NamedExpression(v->name, path));
+        } else {
+            vec.push_back(v);
+        }
     }
     expression->components = vec;
     prune();
@@ -169,25 +177,30 @@ const IR::Node* DoSimplifyExpressions::preorder(IR::StructExpression* expression
 
 const IR::Node* DoSimplifyExpressions::preorder(IR::ListExpression* expression) {
     LOG3("Visiting " << dbp(expression));
-    bool foundEffect = false;
-    for (auto v : expression->components) {
-        if (SideEffects::check(v, refMap, typeMap)) {
-            foundEffect = true;
-            break;
-        }
-    }
-    if (!foundEffect)
+    const IR::Expression* lastEffects = nullptr;
+    for (auto v : expression->components)
+        if (SideEffects::check(v, refMap, typeMap))
+            lastEffects = v;
+    if (lastEffects == nullptr)
         return expression;
-    // allocate temporaries for all members in order.
-    // this will handle cases like a = { b, f(b) }, where f can mutate b.
+    // allocate temporaries for the members preceding the last one with side
+    // effects: this handles cases like a = { b, f(b) }, where f can mutate
+    // b.  From that member on nothing effectful runs before the whole
+    // expression is consumed, so those can stay in place once their calls
+    // have been lifted into statements.
     LOG3("Dismantling " << dbp(expression));
+    bool needTemp = true;
     for (auto &v : expression->components) {
+        if (v == lastEffects)
+            needTemp = false;
         auto t = typeMap->getType(v, true);
-        auto tmp = createTemporary(t);
         visit(v);
-        auto path = addAssignment(expression->srcInfo, tmp, v);
-        v = path;
-        typeMap->setType(path, t);
+        if (needTemp) {
+            auto tmp = createTemporary(t);
+            auto path = addAssignment(expression->srcInfo, tmp, v);
+            v = path;
+            typeMap->setType(path, t);
+        }
     }
     prune();
     return expression;
@@ -198,11 +211,14 @@ const IR::Node* DoSimplifyExpressions::preorder(IR::Operation_Binary* expression
     auto original = getOriginal<IR::Operation_Binary>();
     auto type = typeMap->getType(original, true);
     if (SideEffects::check(original, refMap, typeMap)) {
-        if (SideEffects::check(original->right, refMap, typeMap)) {
-            // We are a bit conservative here. We handle this case:
+        if (SideEffects::check(original->right, refMap, typeMap) &&
+            interferes(original->left, original->right)) {
+            // We handle this case:
             // T f(inout T val) { ... }
             // val + f(val);
-            // We must save val before the evaluation of f
+            // We must save val before the evaluation of f.  The copy is
+            // only made when the effects on the right can actually touch
+            // something the left side reads.
             auto ltype = typeMap->getType(original->left, true);
             auto leftTmp = createTemporary(ltype);
             visit(expression->left);
@@ -214,12 +230,10 @@ const IR::Node* DoSimplifyExpressions::preorder(IR::Operation_Binary* expression
         }
         CHECK_NULL(expression->left);
         visit(expression->right);
-        typeMap->setType(expression, type);
-        auto tmp = createTemporary(type);
-        auto path = addAssignment(expression->srcInfo, tmp, expression);
-        typeMap->setType(path, type);
-        prune();
-        return path;
+        // Visiting the children lifted their side effects into statements,
+        // so what remains of this expression is pure and can stay in place;
+        // contexts that must pin its value relative to later effects
+        // introduce their own copy.
     }
     typeMap->setType(expression, type);
     prune();
@@ -308,6 +322,49 @@ bool DoSimplifyExpressions::mayAlias(const IR::Expression* left,
     return rw.mayAlias(left, right);
 }
 
+namespace {
+
+/// Detects calls whose effects may not be confined to the call expression.
+/// Extern and built-in methods can only touch their own object and their
+/// arguments, all of which appear in the expression, so ReadsWrites sees
+/// their complete footprint; actions, functions and table applications can
+/// also read and write enclosing-scope state the call never mentions.
+class UncontainedEffects : public Inspector {
+    ReferenceMap* refMap;
+    TypeMap* typeMap;
+
+ public:
+    bool found = false;
+    UncontainedEffects(ReferenceMap* refMap, TypeMap* typeMap)
+        : refMap(refMap), typeMap(typeMap) { setName("UncontainedEffects"); }
+    void postorder(const IR::MethodCallExpression* mce) override {
+        auto mi = MethodInstance::resolve(mce, refMap, typeMap, true);
+        if (!mi->is<ExternMethod>() && !mi->is<ExternFunction>() && !mi->is<BuiltInMethod>())
+            found = true;
+    }
+    void postorder(const IR::ConstructorCallExpression*) override { found = true; }
+};
+
+}  // namespace
+
+/** @return true if evaluating @p write can change the value @p read
+  * evaluates to.  Used to decide whether a temporary is needed to pin down
+  * an evaluation order: when the effects in one subexpression cannot touch
+  * anything another one looks at, the subexpressions may stay in place.
+  */
+bool DoSimplifyExpressions::interferes(const IR::Expression* read,
+                                       const IR::Expression* write) const {
+    UncontainedEffects ue(refMap, typeMap);
+    read->apply(ue);
+    write->apply(ue);
+    if (ue.found)
+        return true;
+    // All effects are visible in the expressions themselves, so the
+    // syntactic overlap check is sufficient.
+    ReadsWrites rw(refMap, false);
+    return rw.mayAlias(read, write);
+}
+
 /// Returns true if type is a header or a struct containing a header.
 /// (We don't care about stacks or unions.)
 bool DoSimplifyExpressions::containsHeaderType(const IR::Type* type) {
@@ -347,19 +404,40 @@ const IR::Node* DoSimplifyExpressions::preorder(IR::MethodCallExpression* mce) {
     std::set<const IR::Expression*> hasSideEffects;
 
     bool anyOut = false;
+    const IR::Parameter* lastEffects = nullptr;
     for (auto p : *mi->substitution.getParametersInArgumentOrder()) {
         if (p->direction == IR::Direction::None)
             continue;
         if (p->hasOut())
             anyOut = true;
         auto arg = mi->substitution.lookup(p);
-        // If an argument evaluation has side-effects then
-        // always use a temporary to hold the argument value.
+        if (SideEffects::check(arg->expression, refMap, typeMap))
+            lastEffects = p;
+    }
+
+    for (auto p : *mi->substitution.getParametersInArgumentOrder()) {
+        if (p->direction == IR::Direction::None)
+            continue;
+        auto arg = mi->substitution.lookup(p);
+        // If an argument evaluation has side-effects then use a temporary
+        // to hold the argument value -- unless nothing evaluated after it
+        // can disturb that value: once its calls are lifted into statements
+        // the remaining expression is pure, so if no later argument has
+        // effects and there are no out arguments to alias with, it can be
+        // passed directly.  This is the nested-pure-call case g(f(x)),
+        // where f's result is already in a temporary of its own.
         if (SideEffects::check(arg->expression, refMap, typeMap)) {
+            hasSideEffects.emplace(arg->expression);
+            if (p->direction == IR::Direction::In && !anyOut && p == lastEffects &&
+                !arg->expression->is<IR::ListExpression>() &&
+                !arg->expression->is<IR::StructExpression>()) {
+                LOG3("No temporary for " << dbp(mce) <<
+                     " param " << dbp(p) << " nothing later can disturb it");
+                continue;
+            }
             LOG3("Using temporary for " << dbp(mce) <<
                  " param " << dbp(p) << " arg side effect");
             useTemporary.emplace(p);
-            hasSideEffects.emplace(arg->expression);
             continue;
         }
 
@@ -76,11 +76,24 @@ class SideEffects : public Inspector {
             refMap(refMap), typeMap(typeMap) { setName("SideEffects"); }
 
     /// @return true if the expression may have side-effects.
+    /// Answers computed with a refMap/typeMap are cached by node id -- nodes
+    /// are immutable and ids are never reused, so a summary stays valid as
+    /// long as the node does.  Conservative answers (null maps) are not
+    /// cached, since they depend on which maps the caller happened to have.
     static bool check(const IR::Expression* expression,
                       ReferenceMap* refMap,
                       TypeMap* typeMap) {
+        static NodeIdInfoMap<char> cache;  // 0 unknown, 1 no side effects, 2 some
+        char* cached = nullptr;
+        if (refMap != nullptr && typeMap != nullptr) {
+            cached = &cache[expression->id];
+            if (*cached != 0)
+                return *cached == 2;
+        }
         SideEffects se(refMap, typeMap);
         expression->apply(se);
+        if (cached != nullptr)
+            *cached = se.nodeWithSideEffect != nullptr ? 2 : 1;
         return se.nodeWithSideEffect != nullptr;
     }
 };
@@ -128,6 +141,7 @@ class DoSimplifyExpressions : public Transform, P4WriteContext {
     const IR::Expression* addAssignment(Util::SourceInfo srcInfo, cstring varName,
                                         const IR::Expression* expression);
     bool mayAlias(const IR::Expression* left, const IR::Expression* right) const;
+    bool interferes(const IR::Expression* read, const IR::Expression* write) const;
     bool containsHeaderType(const IR::Type* type);
 
  public:
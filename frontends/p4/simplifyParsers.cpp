@@ -184,14 +184,117 @@ class CollapseChains : public Transform {
     }
 };
 
+/** @brief Merges states that are identical.
+ *
+ * Two states can be merged if they have the same statements and the same
+ * select expression; every transition into one of them is then redirected
+ * to the other.  Machine-generated parsers -- e.g., one copy of a header
+ * chain per tunnel nesting level -- contain many such duplicates, and
+ * each one costs a dispatch in the backends' generated state machines.
+ * Merging runs to a fixed point, since redirecting transitions can make
+ * the predecessors of merged states identical in turn.
+ *
+ * The "start", "accept", and "reject" states and states carrying
+ * annotations are not considered.  The pass works on state names alone,
+ * so it can run after CollapseChains has rewritten states.
+ *
+ * Must only be invoked on parsers.
+ */
+class MergeDuplicateStates : public Transform {
+    /// Maps each state merged in the current round to the name of the
+    /// state that replaces it.
+    std::map<cstring, cstring> merged;
+
+    bool canMerge(const IR::ParserState* state) const {
+        return state->name != IR::ParserState::start &&
+               !state->isBuiltin() &&
+               state->annotations->annotations.empty();
+    }
+
+    /// Redirects transitions to merged states to their replacement.
+    const IR::Expression* redirect(const IR::Expression* select) {
+        if (select == nullptr)
+            return select;
+        if (auto pe = select->to<IR::PathExpression>()) {
+            auto repl = merged.find(pe->path->name.name);
+            if (repl == merged.end())
+                return select;
+            return new IR::PathExpression(select->srcInfo, new IR::Path(IR::ID(repl->second)));
+        }
+        auto se = select->to<IR::SelectExpression>();
+        BUG_CHECK(se != nullptr, "%1%: unexpected select expression", select);
+        bool changed = false;
+        IR::Vector<IR::SelectCase> cases;
+        for (auto sc : se->selectCases) {
+            auto state = redirect(sc->state);
+            if (state != sc->state) {
+                changed = true;
+                sc = new IR::SelectCase(sc->srcInfo, sc->keyset,
+                                        state->to<IR::PathExpression>());
+            }
+            cases.push_back(sc);
+        }
+        if (!changed)
+            return select;
+        return new IR::SelectExpression(se->srcInfo, se->select, cases);
+    }
+
+ public:
+    MergeDuplicateStates() { setName("MergeDuplicateStates"); }
+
+    const IR::Node* preorder(IR::P4Parser* parser) override {
+        auto states = parser->states;
+        while (true) {
+            merged.clear();
+            IR::IndexedVector<IR::ParserState> unique;
+            for (auto state : states) {
+                const IR::ParserState* replacement = nullptr;
+                if (canMerge(state)) {
+                    for (auto other : unique) {
+                        if (!canMerge(other))
+                            continue;
+                        if (state->components.equiv(other->components) &&
+                            IR::equiv(state->selectExpression, other->selectExpression)) {
+                            replacement = other;
+                            break;
+                        }
+                    }
+                }
+                if (replacement == nullptr) {
+                    unique.push_back(state);
+                } else {
+                    LOG1("Merging duplicate state " << dbp(state)
+                         << " into " << dbp(replacement));
+                    merged.emplace(state->name.name, replacement->name.name);
+                }
+            }
+            if (merged.empty())
+                break;
+            states.clear();
+            for (auto state : unique) {
+                auto select = redirect(state->selectExpression);
+                if (select != state->selectExpression)
+                    state = new IR::ParserState(state->srcInfo, state->name, state->annotations,
+                                                state->components, select);
+                states.push_back(state);
+            }
+        }
+        parser->states = states;
+        prune();
+        return parser;
+    }
+};
+
 // This is invoked on each parser separately
 class SimplifyParser : public PassManager {
     ParserCallGraph transitions;
  public:
-    explicit SimplifyParser(ReferenceMap* refMap) : transitions("transitions") {
+    SimplifyParser(ReferenceMap* refMap, bool mergeDuplicates) : transitions("transitions") {
         passes.push_back(new ComputeParserCG(refMap, &transitions));
         passes.push_back(new RemoveUnreachableStates(&transitions));
         passes.push_back(new CollapseChains(&transitions));
+        if (mergeDuplicates)
+            passes.push_back(new MergeDuplicateStates());
         setName("SimplifyParser");
     }
 };
@@ -199,7 +302,7 @@ class SimplifyParser : public PassManager {
 }  // namespace
 
 const IR::Node* DoSimplifyParsers::preorder(IR::P4Parser* parser) {
-    SimplifyParser simpl(refMap);
+    SimplifyParser simpl(refMap, mergeDuplicates);
     return parser->apply(simpl);
 }
 
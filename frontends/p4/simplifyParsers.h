@@ -31,11 +31,18 @@ namespace P4 {
  *  - there are no other outgoing edges from ```s1```,
  *  - there are no other incoming edges to ```s2```,
  *  - and ```s2``` does not have annotations.
+ *
+ * With @p mergeDuplicates, states with identical statements and select
+ * expressions are also merged into one.  This removes states from the
+ * emitted program, so it is not yet enabled in the default frontend
+ * pipeline; the reference outputs have to be regenerated first.
  */
 class DoSimplifyParsers : public Transform {
     ReferenceMap *refMap;
+    bool mergeDuplicates;
  public:
-    explicit DoSimplifyParsers(ReferenceMap *refMap) : refMap(refMap) {
+    explicit DoSimplifyParsers(ReferenceMap *refMap, bool mergeDuplicates = false)
+            : refMap(refMap), mergeDuplicates(mergeDuplicates) {
         CHECK_NULL(refMap);
         setName("DoSimplifyParsers");
     }
@@ -47,9 +54,9 @@ class DoSimplifyParsers : public Transform {
 
 class SimplifyParsers : public PassManager {
  public:
-    explicit SimplifyParsers(ReferenceMap* refMap) {
+    explicit SimplifyParsers(ReferenceMap* refMap, bool mergeDuplicates = false) {
         passes.push_back(new ResolveReferences(refMap));
-        passes.push_back(new DoSimplifyParsers(refMap));
+        passes.push_back(new DoSimplifyParsers(refMap, mergeDuplicates));
         setName("SimplifyParsers");
     }
 };
@@ -30,26 +30,25 @@ bool FindFunctionSpecializations::preorder(const IR::MethodCallExpression* mce)
 }
 
 const IR::Node* SpecializeFunctions::postorder(IR::Function* function) {
+    auto specs = specMap->getSpecializations(getOriginal<IR::Function>());
+    if (specs == nullptr)
+        return function;
     auto result = new IR::Vector<IR::Node>();
-    for (auto it : specMap->map) {
-        if (it.second->specialized == getOriginal()) {
-            auto methodCall = it.first;
-            TypeVariableSubstitution ts;
-            ts.setBindings(function, function->type->typeParameters, methodCall->typeArguments);
-            TypeSubstitutionVisitor tsv(specMap->typeMap, &ts);
-            LOG3("Substitution " << ts);
-            auto specialized = function->apply(tsv)->to<IR::Function>();
-            auto renamed = new IR::Function(
-                specialized->srcInfo,
-                it.second->name,
-                specialized->type,
-                specialized->body);
-            result->push_back(renamed);
-            LOG3("Specializing " << function << " as " << renamed);
-        }
+    for (auto fs : *specs) {
+        auto methodCall = fs->invocation;
+        TypeVariableSubstitution ts;
+        ts.setBindings(function, function->type->typeParameters, methodCall->typeArguments);
+        TypeSubstitutionVisitor tsv(specMap->typeMap, &ts);
+        LOG3("Substitution " << ts);
+        auto specialized = function->apply(tsv)->to<IR::Function>();
+        auto renamed = new IR::Function(
+            specialized->srcInfo,
+            fs->name,
+            specialized->type,
+            specialized->body);
+        result->push_back(renamed);
+        LOG3("Specializing " << function << " as " << renamed);
     }
-    if (!result->size())
-        return function;
     result->push_back(function);
     return result;
 }
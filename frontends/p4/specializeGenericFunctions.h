@@ -42,16 +42,50 @@ struct FunctionSpecialization {
 struct FunctionSpecializationMap {
     ReferenceMap* refMap;
     TypeMap* typeMap;
+    // The map can have multiple keys pointing to the same value: invocations
+    // with equivalent type arguments share one specialization.
     ordered_map<const IR::MethodCallExpression*, FunctionSpecialization*> map;
-
+    /// The distinct specializations of each function, in creation order.
+    ordered_map<const IR::Function*, std::vector<FunctionSpecialization*>> distinct;
+
+    /// True if the two invocations instantiate their function with
+    /// equivalent type arguments.
+    bool sameTypeArguments(const IR::MethodCallExpression* left,
+                           const IR::MethodCallExpression* right) const {
+        if (left->typeArguments->size() != right->typeArguments->size())
+            return false;
+        for (size_t i = 0; i < left->typeArguments->size(); i++) {
+            auto lt = typeMap->getTypeType(left->typeArguments->at(i), true);
+            auto rt = typeMap->getTypeType(right->typeArguments->at(i), true);
+            if (!typeMap->equivalent(lt, rt))
+                return false;
+        }
+        return true;
+    }
     void add(const IR::MethodCallExpression* mce, const IR::Function* func) {
+        // Reuse a previous specialization of this function with the same
+        // type arguments if there is one
+        auto &specs = distinct[func];
+        for (auto fs : specs) {
+            if (sameTypeArguments(fs->invocation, mce)) {
+                map.emplace(mce, fs);
+                return;
+            }
+        }
         cstring name = refMap->newName(func->name);
         FunctionSpecialization* fs = new FunctionSpecialization(name, mce, func);
+        specs.push_back(fs);
         map.emplace(mce, fs);
     }
     FunctionSpecialization* get(const IR::MethodCallExpression* mce) const {
         return ::get(map, mce);
     }
+    /// The distinct specializations of @p func, or nullptr if it has none.
+    const std::vector<FunctionSpecialization*>*
+    getSpecializations(const IR::Function* func) const {
+        auto it = distinct.find(func);
+        return it == distinct.end() ? nullptr : &it->second;
+    }
 };
 
 /**
@@ -86,7 +120,7 @@ bit<32> f_0(in bit<32> data) { return data; }
 ...
 bit<32> b = f_0(32w0);
 ```
- * A different specialization is made for each function invocation.
+ * Invocations with equivalent type arguments share a single specialization.
  */
 class SpecializeFunctions : public Transform {
     FunctionSpecializationMap* specMap;
@@ -41,12 +41,13 @@ void TypeSpecializationMap::add(
     if (it != map.end())
         return;
 
-    // First check if we have another specialization with the same
-    // type arguments, in that case reuse it
-    for (auto it : map) {
-        if (same(it.second, t)) {
-            map.emplace(t, it.second);
-            LOG3("Found to specialize: " << t << " as previous " << it.second->name);
+    // First check if we have another specialization of this declaration with
+    // the same type arguments, in that case reuse it
+    auto &candidates = distinct[decl->getName().name];
+    for (auto spec : candidates) {
+        if (same(spec, t)) {
+            map.emplace(t, spec);
+            LOG3("Found to specialize: " << t << " as previous " << spec->name);
             return;
         }
     }
@@ -58,13 +59,20 @@ void TypeSpecializationMap::add(
     for (auto a : *t->arguments)
         argTypes->push_back(typeMap->getType(a, true));
     TypeSpecialization* s = new TypeSpecialization(name, t, decl, insertion, argTypes);
+    candidates.push_back(s);
     map.emplace(t, s);
 }
 
 TypeSpecialization* TypeSpecializationMap::get(const IR::Type_Specialized* type) const {
-    for (auto it : map) {
-        if (same(it.second, type))
-            return it.second;
+    auto it = map.find(type);
+    if (it != map.end())
+        return it->second;
+    // not a recorded instantiation site; compare against the distinct
+    // specializations
+    for (auto &d : distinct) {
+        for (auto spec : d.second)
+            if (same(spec, type))
+                return spec;
     }
     return nullptr;
 }
@@ -121,19 +129,20 @@ void FindTypeSpecializations::postorder(const IR::Type_Specialized* type) {
 ///////////////////////////////////////////////////////////////////////////////////////
 
 const IR::Node* CreateSpecializedTypes::postorder(IR::Type_Declaration* type) {
-    for (auto it : specMap->map) {
-        if (it.second->declaration->name == type->name) {
-            auto specialized = it.first;
+    // clone once per distinct specialization, not once per instantiation site
+    if (auto specs = specMap->specializationsOf(type->name)) {
+        for (auto spec : *specs) {
+            auto specialized = spec->specialized;
             auto genDecl = type->to<IR::IMayBeGenericType>();
             TypeVariableSubstitution ts;
             ts.setBindings(type, genDecl->getTypeParameters(), specialized->arguments);
             TypeSubstitutionVisitor tsv(specMap->typeMap, &ts);
             auto renamed = type->apply(tsv)->to<IR::Type_StructLike>()->clone();
-            cstring name = it.second->name;
+            cstring name = spec->name;
             auto empty = new IR::TypeParameters();
             renamed->name = name;
             renamed->typeParameters = empty;
-            it.second->replacement = postorder(renamed)->to<IR::Type_StructLike>();
+            spec->replacement = postorder(renamed)->to<IR::Type_StructLike>();
             LOG3("Specializing " << dbp(type) << " with " << ts << " as " << dbp(renamed));
         }
     }
@@ -53,8 +53,13 @@ struct TypeSpecialization : public IHasDbPrint {
 struct TypeSpecializationMap : public IHasDbPrint {
     ReferenceMap* refMap;
     TypeMap* typeMap;
-    // The map can have multiple keys pointing to the same value
+    // The map can have multiple keys pointing to the same value:
+    // instantiations with equivalent type arguments share one specialization.
     ordered_map<const IR::Type_Specialized*, TypeSpecialization*> map;
+    // The distinct specializations of each declaration, indexed by the
+    // declaration name, so that add/get only compare against the few
+    // specializations of that declaration instead of every instantiation site.
+    ordered_map<cstring, std::vector<TypeSpecialization*>> distinct;
     // Keep track of the values in the above map which are already
     // inserted in the program.
     std::set<TypeSpecialization*> inserted;
@@ -62,6 +67,12 @@ struct TypeSpecializationMap : public IHasDbPrint {
     void add(const IR::Type_Specialized* t, const IR::Type_StructLike* decl,
              const IR::Node* insertion);
     TypeSpecialization* get(const IR::Type_Specialized* t) const;
+    /// The distinct specializations of the declaration named @p name, or
+    /// nullptr if it has none.
+    const std::vector<TypeSpecialization*>* specializationsOf(cstring name) const {
+        auto it = distinct.find(name);
+        return it == distinct.end() ? nullptr : &it->second;
+    }
     bool same(const TypeSpecialization* left, const IR::Type_Specialized* right) const;
     void dbprint(std::ostream& out) const override {
         for (auto it : map) { out << dbp(it.first) << " => " << it.second << std::endl; } }
@@ -16,24 +16,12 @@ limitations under the License.
 
 #include "strengthReduction.h"
 
+#include "ir/pattern.h"
+
 namespace P4 {
 
 /// @section Helper methods
 
-bool DoStrengthReduction::isOne(const IR::Expression* expr) const {
-    auto cst = expr->to<IR::Constant>();
-    if (cst == nullptr)
-        return false;
-    return cst->value == 1;
-}
-
-bool DoStrengthReduction::isZero(const IR::Expression* expr) const {
-    auto cst = expr->to<IR::Constant>();
-    if (cst == nullptr)
-        return false;
-    return cst->value == 0;
-}
-
 bool DoStrengthReduction::isTrue(const IR::Expression* expr) const {
     auto cst = expr->to<IR::BoolLiteral>();
     if (cst == nullptr)
@@ -60,6 +48,42 @@ int DoStrengthReduction::isPowerOf2(const IR::Expression* expr) const {
     return log;
 }
 
+int DoStrengthReduction::isLowOnes(const IR::Expression* expr) const {
+    auto cst = expr->to<IR::Constant>();
+    if (cst == nullptr)
+        return -1;
+    if (cst->value <= 0)
+        return -1;
+    big_int plus1 = cst->value + 1;
+    auto log = boost::multiprecision::msb(plus1);
+    if (log != boost::multiprecision::lsb(plus1))
+        return -1;
+    return log;
+}
+
+const IR::Expression* DoStrengthReduction::makeReciprocalDivide(
+        Util::SourceInfo srcInfo, const IR::Expression* a, const IR::Constant* k) const {
+    auto type = a->type ? a->type->to<IR::Type_Bits>() : nullptr;
+    if (type == nullptr || type->isSigned)
+        return nullptr;
+    if (k->value <= 1)
+        return nullptr;
+    int width = type->width_bits();
+    // The widened multiply must still fit in a 64-bit machine word.
+    if (width < 1 || width > 31)
+        return nullptr;
+    // Round-up reciprocal: with shift = width + ceil(log2 k) and
+    // magic = ceil(2^shift / k), floor(a * magic / 2^shift) equals
+    // floor(a / k) for every unsigned a of this width.
+    int shift = width + boost::multiprecision::msb(k->value) + 1;
+    big_int magic = 1;
+    magic = ((magic << shift) + k->value - 1) / k->value;
+    auto wide = IR::Type_Bits::get(2 * width + 1);
+    auto mul = new IR::Mul(srcInfo, new IR::Cast(wide, a), new IR::Constant(wide, magic));
+    auto shr = new IR::Shr(srcInfo, mul, new IR::Constant(shift));
+    return new IR::Cast(type, shr);
+}
+
 bool DoStrengthReduction::isAllOnes(const IR::Expression* expr) const {
     auto cst = expr->to<IR::Constant>();
     if (cst == nullptr)
@@ -74,41 +98,55 @@ bool DoStrengthReduction::isAllOnes(const IR::Expression* expr) const {
 /// @section Visitor Methods
 
 const IR::Node* DoStrengthReduction::postorder(IR::Cmpl* expr) {
-    if (auto a = expr->expr->to<IR::Cmpl>())
-        return a->expr;
+    Pattern::Match<IR::Expression> a;
+    if ((~~Pattern(a)).match(expr))
+        return a;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::BAnd* expr) {
-    if (isAllOnes(expr->left))
-        return expr->right;
-    if (isAllOnes(expr->right))
-        return expr->left;
-    auto l = expr->left->to<IR::Cmpl>();
-    auto r = expr->right->to<IR::Cmpl>();
-    if (l && r)
-        return new IR::Cmpl(new IR::BOr(expr->srcInfo, l->expr, r->expr));
+    Pattern::Match<IR::Expression> a, l, r;
+    const IR::Constant* k = nullptr;
+    if ((a & Pattern([this](const IR::Constant* c) { return isAllOnes(c); })).match(expr))
+        return a;
+    if ((~Pattern(l) & ~Pattern(r)).match(expr))
+        return new IR::Cmpl(new IR::BOr(expr->srcInfo, l, r));
+
+    // Fuse a shift followed by a low-bits mask into a slice, which the
+    // Slice rules can then combine with surrounding shifts, concats and
+    // casts, and which machine targets compile to a single extract.
+    Pattern::Match<IR::Constant> sh;
+    const IR::Constant* mask = nullptr;
+    if (enableMachineArith &&
+        ((Pattern(a) >> sh) & Pattern(mask, [this](const IR::Constant* c) {
+            return isLowOnes(c) > 0; })).match(expr)) {
+        auto atype = a->type ? a->type->to<IR::Type_Bits>() : nullptr;
+        int w = isLowOnes(mask);
+        if (atype != nullptr && !atype->isSigned && expr->type->is<IR::Type_Bits>() &&
+            sh->fitsInt() && sh->asInt() >= 0 && sh->asInt() + w <= atype->width_bits()) {
+            int lo = sh->asInt();
+            auto result = new IR::Cast(expr->type,
+                                       new IR::Slice(expr->srcInfo, a, lo + w - 1, lo));
+            LOG3("Replace " << expr << " with " << result);
+            return result;
+        }
+    }
 
     if (hasSideEffects(expr))
         return expr;
-    if (isZero(expr->left))
-        return expr->left;
-    if (isZero(expr->right))
-        return expr->right;
+    if ((a & Pattern(k, [](const IR::Constant* c) { return c->value == 0; })).match(expr))
+        return k;
     if (expr->left->equiv(*expr->right))
         return expr->left;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::BOr* expr) {
-    if (isZero(expr->left))
-        return expr->right;
-    if (isZero(expr->right))
-        return expr->left;
-    auto l = expr->left->to<IR::Cmpl>();
-    auto r = expr->right->to<IR::Cmpl>();
-    if (l && r)
-        return new IR::Cmpl(new IR::BAnd(expr->srcInfo, l->expr, r->expr));
+    Pattern::Match<IR::Expression> a, l, r;
+    if ((a | 0).match(expr))
+        return a;
+    if ((~Pattern(l) | ~Pattern(r)).match(expr))
+        return new IR::Cmpl(new IR::BAnd(expr->srcInfo, l, r));
     if (hasSideEffects(expr))
         return expr;
     if (expr->left->equiv(*expr->right))
@@ -117,10 +155,9 @@ const IR::Node* DoStrengthReduction::postorder(IR::BOr* expr) {
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::BXor* expr) {
-    if (isZero(expr->left))
-        return expr->right;
-    if (isZero(expr->right))
-        return expr->left;
+    Pattern::Match<IR::Expression> a;
+    if ((a ^ 0).match(expr))
+        return a;
     bool cmpl = false;
     if (auto l = expr->left->to<IR::Cmpl>()) {
         expr->left = l->expr;
@@ -140,84 +177,87 @@ const IR::Node* DoStrengthReduction::postorder(IR::BXor* expr) {
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::LAnd* expr) {
-    if (isFalse(expr->left))
-        return expr->left;
-    if (isTrue(expr->left))
-        return expr->right;
-    if (isTrue(expr->right))
+    Pattern::Match<IR::Expression> a;
+    if ((Pattern(false) && a).match(expr))
         return expr->left;
+    if ((Pattern(true) && a).match(expr))
+        return a;
+    if ((a && Pattern(true)).match(expr))
+        return a;
     // Note that remaining case is not simplified, due to possible side effects in expr->left
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::LOr* expr) {
-    if (isFalse(expr->left))
-        return expr->right;
-    if (isTrue(expr->left))
-        return expr->left;
-    if (isFalse(expr->right))
+    Pattern::Match<IR::Expression> a;
+    if ((Pattern(false) || a).match(expr))
+        return a;
+    if ((Pattern(true) || a).match(expr))
         return expr->left;
+    if ((a || Pattern(false)).match(expr))
+        return a;
     // Note that remaining case is not simplified, due to semantics of short-circuit evaluation
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Equ* expr) {
+    Pattern::Match<IR::Expression> a;
     // a == true is the same as a
-    if (isTrue(expr->left))
-        return expr->right;
-    if (isTrue(expr->right))
-        return expr->left;
+    if ((a == true).match(expr))
+        return a;
     // a == false is the same as !a
-    if (isFalse(expr->left))
-        return new IR::LNot(expr->right);
-    if (isFalse(expr->right))
-        return new IR::LNot(expr->left);
+    if ((a == false).match(expr))
+        return new IR::LNot(a);
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Neq* expr) {
+    Pattern::Match<IR::Expression> a;
     // a != true is the same as !a
-    if (isTrue(expr->left))
-        return new IR::LNot(expr->right);
-    if (isTrue(expr->right))
-        return new IR::LNot(expr->left);
+    if ((a != true).match(expr))
+        return new IR::LNot(a);
     // a != false is the same as a
-    if (isFalse(expr->left))
-        return expr->right;
-    if (isFalse(expr->right))
-        return expr->left;
+    if ((a != false).match(expr))
+        return a;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::LNot* expr) {
-    if (auto e = expr->expr->to<IR::LNot>())
-        return e->expr;
-    if (auto e = expr->expr->to<IR::Equ>())
-        return new IR::Neq(e->left, e->right);
-    if (auto e = expr->expr->to<IR::Neq>())
-        return new IR::Equ(e->left, e->right);
-    if (auto e = expr->expr->to<IR::Leq>())
-        return new IR::Grt(e->left, e->right);
-    if (auto e = expr->expr->to<IR::Geq>())
-        return new IR::Lss(e->left, e->right);
-    if (auto e = expr->expr->to<IR::Lss>())
-        return new IR::Geq(e->left, e->right);
-    if (auto e = expr->expr->to<IR::Grt>())
-        return new IR::Leq(e->left, e->right);
+    Pattern::Match<IR::Expression> a;
+    if ((!!Pattern(a)).match(expr))
+        return a;
+    // The complement of a comparison is the inverse comparison.  The table
+    // dispatches on the comparison's node class, replacing the former
+    // dynamic_cast ladder with a single typeid lookup.
+    static PatternTable inverses({
+        {Pattern::any() == Pattern::any(), [](const IR::Node *n) -> const IR::Node * {
+            auto e = n->to<IR::Equ>(); return new IR::Neq(e->left, e->right); }},
+        {Pattern::any() != Pattern::any(), [](const IR::Node *n) -> const IR::Node * {
+            auto e = n->to<IR::Neq>(); return new IR::Equ(e->left, e->right); }},
+        {Pattern::any() <= Pattern::any(), [](const IR::Node *n) -> const IR::Node * {
+            auto e = n->to<IR::Leq>(); return new IR::Grt(e->left, e->right); }},
+        {Pattern::any() >= Pattern::any(), [](const IR::Node *n) -> const IR::Node * {
+            auto e = n->to<IR::Geq>(); return new IR::Lss(e->left, e->right); }},
+        {Pattern::any() < Pattern::any(), [](const IR::Node *n) -> const IR::Node * {
+            auto e = n->to<IR::Lss>(); return new IR::Geq(e->left, e->right); }},
+        {Pattern::any() > Pattern::any(), [](const IR::Node *n) -> const IR::Node * {
+            auto e = n->to<IR::Grt>(); return new IR::Leq(e->left, e->right); }}});
+    if (auto rv = inverses.apply(expr->expr))
+        return rv;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Sub* expr) {
-    if (isZero(expr->right))
-        return expr->left;
-    if (isZero(expr->left))
-        return new IR::Neg(expr->srcInfo, expr->right);
+    Pattern::Match<IR::Expression> a;
+    Pattern::Match<IR::Constant> k;
+    if ((a - 0).match(expr))
+        return a;
+    if ((0 - Pattern(a)).match(expr))
+        return new IR::Neg(expr->srcInfo, a);
     // Replace `a - constant` with `a + (-constant)`
-    if (expr->right->is<IR::Constant>()) {
-        auto cst = expr->right->to<IR::Constant>();
-        auto neg = new IR::Constant(cst->srcInfo, cst->type, -cst->value, cst->base, true);
-        auto result = new IR::Add(expr->srcInfo, expr->left, neg);
-        return result;
+    if ((a - k).match(expr)) {
+        auto neg = new IR::Constant(k->srcInfo, k->type, -k->value, k->base, true);
+        return new IR::Add(expr->srcInfo, a, neg);
     }
     if (hasSideEffects(expr))
         return expr;
@@ -228,119 +268,126 @@ const IR::Node* DoStrengthReduction::postorder(IR::Sub* expr) {
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Add* expr) {
-    if (isZero(expr->right))
-        return expr->left;
-    if (isZero(expr->left))
-        return expr->right;
+    Pattern::Match<IR::Expression> a;
+    // Add is commutative, so this covers zero on either side
+    if ((a + 0).match(expr))
+        return a;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Shl* expr) {
-    if (isZero(expr->right))
-        return expr->left;
-    if (auto sh2 = expr->left->to<IR::Shl>()) {
-        if (sh2->right->type->is<IR::Type_InfInt>() &&
-            expr->right->type->is<IR::Type_InfInt>()) {
-            // (a << b) << c is a << (b + c)
-            auto result = new IR::Shl(expr->srcInfo, sh2->left,
-                                      new IR::Add(expr->srcInfo, sh2->right, expr->right));
-            LOG3("Replace " << expr << " with " << result);
-            return result;
-        }
+    Pattern::Match<IR::Expression> a, b, c;
+    if ((a << 0).match(expr))
+        return a;
+    // (a << b) << c is a << (b + c)
+    if ((Pattern(a) << b << c).match(expr) &&
+        b->type->is<IR::Type_InfInt>() && c->type->is<IR::Type_InfInt>()) {
+        auto result = new IR::Shl(expr->srcInfo, a,
+                                  new IR::Add(expr->srcInfo, b, c));
+        LOG3("Replace " << expr << " with " << result);
+        return result;
     }
 
-    if (!hasSideEffects(expr->right) && isZero(expr->left))
+    if ((0 << Pattern(a)).match(expr) && !hasSideEffects(a))
         return expr->left;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Shr* expr) {
-    if (isZero(expr->right))
-        return expr->left;
-    if (auto sh2 = expr->left->to<IR::Shr>()) {
-        if (sh2->right->type->is<IR::Type_InfInt>() &&
-            expr->right->type->is<IR::Type_InfInt>()) {
-            // (a >> b) >> c is a >> (b + c)
-            auto result = new IR::Shr(expr->srcInfo, sh2->left,
-                                      new IR::Add(expr->srcInfo, sh2->right, expr->right));
-            LOG3("Replace " << expr << " with " << result);
-            return result;
-        }
+    Pattern::Match<IR::Expression> a, b, c;
+    if ((a >> 0).match(expr))
+        return a;
+    // (a >> b) >> c is a >> (b + c)
+    if ((Pattern(a) >> b >> c).match(expr) &&
+        b->type->is<IR::Type_InfInt>() && c->type->is<IR::Type_InfInt>()) {
+        auto result = new IR::Shr(expr->srcInfo, a,
+                                  new IR::Add(expr->srcInfo, b, c));
+        LOG3("Replace " << expr << " with " << result);
+        return result;
     }
-    if (!hasSideEffects(expr->right) && isZero(expr->left))
+    if ((0 >> Pattern(a)).match(expr) && !hasSideEffects(a))
         return expr->left;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Mul* expr) {
-    if (isOne(expr->left))
-        return expr->right;
-    if (isOne(expr->right))
-        return expr->left;
-    auto exp = isPowerOf2(expr->left);
-    if (exp >= 0) {
-        auto amt = new IR::Constant(exp);
-        auto sh = new IR::Shl(expr->srcInfo, expr->right, amt);
-        return sh;
-    }
-    exp = isPowerOf2(expr->right);
-    if (exp >= 0) {
-        auto amt = new IR::Constant(exp);
-        auto sh = new IR::Shl(expr->srcInfo, expr->left, amt);
-        return sh;
-    }
+    Pattern::Match<IR::Expression> a;
+    const IR::Constant* k = nullptr;
+    // Mul is commutative, so these cover constants on either side
+    if ((a * 1).match(expr))
+        return a;
+    if ((a * Pattern(k, [this](const IR::Constant* c) { return isPowerOf2(c) >= 0; }))
+            .match(expr))
+        return new IR::Shl(expr->srcInfo, a, new IR::Constant(isPowerOf2(k)));
     if (hasSideEffects(expr))
         return expr;
-    if (isZero(expr->left))
-        return expr->left;
-    if (isZero(expr->right))
-        return expr->right;
+    if ((a * Pattern(k, [](const IR::Constant* c) { return c->value == 0; })).match(expr))
+        return k;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Div* expr) {
-    if (isZero(expr->right)) {
-        ::error(ErrorType::ERR_EXPRESSION, "%1%: Division by zero", expr);
-        return expr;
-    }
-    if (isOne(expr->right))
-        return expr->left;
-    auto exp = isPowerOf2(expr->right);
-    if (exp >= 0) {
-        auto amt = new IR::Constant(exp);
-        auto sh = new IR::Shr(expr->srcInfo, expr->left, amt);
-        return sh;
+    Pattern::Match<IR::Expression> a;
+    Pattern::Match<IR::Constant> k;
+    if ((a / k).match(expr)) {
+        if (k->value == 0) {
+            ::error(ErrorType::ERR_EXPRESSION, "%1%: Division by zero", expr);
+            return expr;
+        }
+        if (k->value == 1)
+            return a;
+        auto exp = isPowerOf2(k);
+        if (exp >= 0)
+            return new IR::Shr(expr->srcInfo, a, new IR::Constant(exp));
+        if (enableMachineArith) {
+            if (auto rv = makeReciprocalDivide(expr->srcInfo, a, k)) {
+                LOG3("Replace " << expr << " with " << rv);
+                return rv;
+            }
+        }
     }
-    if (isZero(expr->left) && !hasSideEffects(expr->right))
+    if ((0 / Pattern(a)).match(expr) && !hasSideEffects(a))
         return expr->left;
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Mod* expr) {
-    if (isZero(expr->right)) {
+    Pattern::Match<IR::Expression> a;
+    Pattern::Match<IR::Constant> k;
+    if ((a % k).match(expr) && k->value == 0) {
         ::error(ErrorType::ERR_EXPRESSION, "%1%: Modulo by zero", expr);
         return expr;
     }
-    if (isZero(expr->left) && !hasSideEffects(expr->right))
+    if ((0 % Pattern(a)).match(expr) && !hasSideEffects(a))
         return expr->left;
-    auto exp = isPowerOf2(expr->right);
-    if (exp >= 0) {
-        big_int mask = 1;
-        mask = (mask << exp) - 1;
-        auto amt = new IR::Constant(expr->right->to<IR::Constant>()->type, mask);
-        auto sh = new IR::BAnd(expr->srcInfo, expr->left, amt);
-        return sh;
+    if ((a % k).match(expr)) {
+        auto exp = isPowerOf2(k);
+        if (exp >= 0) {
+            big_int mask = 1;
+            mask = (mask << exp) - 1;
+            return new IR::BAnd(expr->srcInfo, a, new IR::Constant(k->type, mask));
+        }
+        // a % k is a - (a / k) * k, with the division lowered to a
+        // multiply-and-shift.  This reuses `a`, so side effects bar it.
+        if (enableMachineArith && !hasSideEffects(a)) {
+            if (auto q = makeReciprocalDivide(expr->srcInfo, a, k)) {
+                auto rv = new IR::Sub(expr->srcInfo, a, new IR::Mul(expr->srcInfo, q, k));
+                LOG3("Replace " << expr << " with " << rv);
+                return rv;
+            }
+        }
     }
     return expr;
 }
 
 const IR::Node* DoStrengthReduction::postorder(IR::Mux* expr) {
+    Pattern::Match<IR::Expression> a;
     if (isTrue(expr->e1) && isFalse(expr->e2))
         return expr->e0;
     else if (isFalse(expr->e1) && isTrue(expr->e2))
         return new IR::LNot(expr->e0);
-    else if (auto lnot = expr->e0->to<IR::LNot>())
-        return new IR::Mux(lnot->expr, expr->e2, expr->e1);
+    else if ((!Pattern(a)).match(expr->e0))
+        return new IR::Mux(a, expr->e2, expr->e1);
     else if (!hasSideEffects(expr) && expr->e1->equiv(*expr->e2))
         return expr->e1;
     return expr;
@@ -31,9 +31,11 @@ namespace P4 {
   * Specifically, it provides:
   *
   * 1. A collection of helper methods that determine whether a given
-  * expression is `0`, `1`, `true`, or `false`, or a power of `2`
+  * expression is `true` or `false`, all ones, a low-bits mask, or a
+  * power of `2`
   *
-  * 2. A visitor that transforms arithmetic and boolean expressions
+  * 2. A visitor that transforms arithmetic and boolean expressions,
+  * with the rewrites expressed as ir/pattern.h patterns
   *
   * @pre: None
   *
@@ -43,10 +45,13 @@ namespace P4 {
   *
   */
 class DoStrengthReduction final : public Transform {
-    /// @returns `true` if @p expr is the constant `1`.
-    bool isOne(const IR::Expression* expr) const;
-    /// @returns `true` if @p expr is the constant `0`.
-    bool isZero(const IR::Expression* expr) const;
+    /// Enables rewrites that pay off only on targets executing
+    /// straight-line machine arithmetic (DPDK, eBPF): division and
+    /// modulo by an arbitrary constant are lowered to a widened
+    /// multiply-and-shift, and shift-then-mask is fused into a slice.
+    /// Interpreting or reconfigurable targets leave this off.
+    bool enableMachineArith = false;
+
     /// @returns `true` if @p expr is the constant `true`.
     bool isTrue(const IR::Expression* expr) const;
     /// @returns `true` if @p expr is the constant `false`.
@@ -56,6 +61,16 @@ class DoStrengthReduction final : public Transform {
     /// @returns the logarithm (base 2) of @p expr if it is positive
     /// and a power of `2` and `-1` otherwise.
     int isPowerOf2(const IR::Expression* expr) const;
+    /// @returns `n` if @p expr is a constant with exactly its `n`
+    /// lowest bits set (i.e., `2^n - 1`) and `-1` otherwise.
+    int isLowOnes(const IR::Expression* expr) const;
+
+    /// Lowers an unsigned division of @p a by the constant @p k --
+    /// which must be neither `0`, `1`, nor a power of `2` -- to a
+    /// widened multiplication by a precomputed reciprocal followed by
+    /// a shift.  @returns nullptr if the types do not permit this.
+    const IR::Expression* makeReciprocalDivide(
+        Util::SourceInfo srcInfo, const IR::Expression* a, const IR::Constant* k) const;
 
     const IR::Node* simplifyShift(IR::Slice* expr);
     const IR::Node* simplifyConcat(IR::Slice* expr);
@@ -67,7 +82,9 @@ class DoStrengthReduction final : public Transform {
     }
 
  public:
-    DoStrengthReduction() { visitDagOnce = true; setName("StrengthReduction"); }
+    explicit DoStrengthReduction(bool enableMachineArith = false) :
+            enableMachineArith(enableMachineArith) {
+        visitDagOnce = true; setName("StrengthReduction"); }
 
     using Transform::postorder;
 
@@ -94,11 +111,11 @@ class DoStrengthReduction final : public Transform {
 class StrengthReduction : public PassManager {
  public:
     StrengthReduction(ReferenceMap* refMap, TypeMap* typeMap,
-            TypeChecking* typeChecking = nullptr) {
+            TypeChecking* typeChecking = nullptr, bool enableMachineArith = false) {
         if (!typeChecking)
             typeChecking = new TypeChecking(refMap, typeMap, true);
         passes.push_back(typeChecking);
-        passes.push_back(new DoStrengthReduction());
+        passes.push_back(new DoStrengthReduction(enableMachineArith));
     }
 };
 
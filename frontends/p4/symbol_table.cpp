@@ -66,9 +66,10 @@ class Namespace : public NamedSymbol {
     Namespace(cstring name, Util::SourceInfo si, bool allowDuplicates) :
             NamedSymbol(name, si),
             allowDuplicates(allowDuplicates) {}
-    void declare(NamedSymbol* symbol) {
+    /// @returns true if @p symbol was actually added to this namespace.
+    bool declare(NamedSymbol* symbol) {
         cstring symname = symbol->getName();
-        if (symname.isNullOrEmpty()) return;
+        if (symname.isNullOrEmpty()) return false;
 
         auto it = contents.find(symname);
         if (it != contents.end()) {
@@ -77,17 +78,17 @@ class Namespace : public NamedSymbol {
                 ::error(ErrorType::ERR_DUPLICATE,
                         "Re-declaration of %1%%2% with different type: %3%",
                         symbol->getName(), symbol->getSourceInfo(), it->second->getSourceInfo());
-                return;
+                return false;
             }
 
             if (!allowDuplicates) {
                 ::error(ErrorType::ERR_DUPLICATE,
                         "Duplicate declaration of %1%%2%; previous at %3%",
                         symbol->getName(), symbol->getSourceInfo(), it->second->getSourceInfo());
-                return;
+                return false;
             }
         }
-        contents.emplace(symbol->getName(), symbol);
+        return contents.emplace(symbol->getName(), symbol).second;
     }
     NamedSymbol* lookup(cstring name) const {
         auto it = contents.find(name);
@@ -146,20 +147,29 @@ ProgramStructure::ProgramStructure()
           currentNamespace(nullptr) {
     rootNamespace = new Namespace("", Util::SourceInfo(), true);
     currentNamespace = rootNamespace;
+    scopeNames.emplace_back();
     // We use stderr because we want debugging output
     // to be the same as the bison debugging output.
     debugStream = stderr;
 }
 
+void ProgramStructure::declare(NamedSymbol* symbol) {
+    if (!currentNamespace->declare(symbol))
+        return;
+    visibleSymbols[symbol->getName()].push_back(symbol);
+    scopeNames.back().push_back(symbol->getName());
+}
+
 void ProgramStructure::push(Namespace* ns) {
     CHECK_NULL(ns);
     if (debug)
         fprintf(debugStream, "ProgramStructure: pushing %s\n", ns->toString().c_str());
     LOG4("ProgramStructure: pushing " << ns->toString());
     BUG_CHECK(currentNamespace != nullptr, "Null currentNamespace");
-    currentNamespace->declare(ns);
+    declare(ns);
     ns->setParent(currentNamespace);
     currentNamespace = ns;
+    scopeNames.emplace_back();
 }
 
 void ProgramStructure::pushNamespace(SourceInfo si, bool allowDuplicates) {
@@ -180,6 +190,14 @@ void ProgramStructure::pop() {
         fprintf(debugStream, "ProgramStructure: popping %s\n",
                 currentNamespace->toString().c_str());
     LOG4("ProgramStructure: popping " << currentNamespace->toString());
+    // undo the flattened entries of the scope being left
+    for (auto name : scopeNames.back()) {
+        auto it = visibleSymbols.find(name);
+        it->second.pop_back();
+        if (it->second.empty())
+            visibleSymbols.erase(it);
+    }
+    scopeNames.pop_back();
     currentNamespace = parent;
 }
 
@@ -189,7 +207,7 @@ void ProgramStructure::declareType(IR::ID id) {
 
     LOG3("ProgramStructure: adding type " << id);
     auto st = new SimpleType(id.name, id.srcInfo);
-    currentNamespace->declare(st);
+    declare(st);
 }
 
 void ProgramStructure::declareObject(IR::ID id, cstring type) {
@@ -201,7 +219,7 @@ void ProgramStructure::declareObject(IR::ID id, cstring type) {
     auto o = new Object(id.name, id.srcInfo);
     if (auto tns = dynamic_cast<const Namespace *>(type_sym))
         o->setNamespace(tns);
-    currentNamespace->declare(o);
+    declare(o);
 }
 
 void ProgramStructure::markAsTemplate(IR::ID id) {
@@ -230,15 +248,11 @@ NamedSymbol* ProgramStructure::lookup(cstring identifier) {
     const Namespace* parent = identifierContext.lookupContext;
     NamedSymbol *rv = nullptr;
     if (parent == nullptr) {
-        // We don't have a parent, try lookup up the stack
-        parent = currentNamespace;
-        while (parent != nullptr) {
-            NamedSymbol* symbol = parent->lookup(identifier);
-            if (symbol != nullptr) {
-                rv = symbol;
-                break; }
-            parent = parent->getParent();
-        }
+        // No explicit namespace: look up the scope chain, flattened into
+        // visibleSymbols so that this costs a single probe
+        auto it = visibleSymbols.find(identifier);
+        if (it != visibleSymbols.end())
+            rv = it->second.back();  // the innermost declaration
     } else {
         rv = parent->lookup(identifier);
     }
@@ -292,6 +306,9 @@ cstring ProgramStructure::toString() const {
 void ProgramStructure::clear() {
     rootNamespace->clear();
     currentNamespace = rootNamespace;
+    visibleSymbols.clear();
+    scopeNames.clear();
+    scopeNames.emplace_back();
     debugStream = stderr;
 }
 }  // namespace Util
@@ -49,6 +49,17 @@ class ProgramStructure final {
         PathContext() : previousSymbol(nullptr), lookupContext(nullptr) {}
     } identifierContext;
 
+    // Flattened view of the namespace stack: for each name, the symbols
+    // declared under it in the scopes of the current chain, outermost first.
+    // Lets the lexer's identifier/type disambiguation, which runs for every
+    // token, answer a lookup with a single hash probe instead of walking the
+    // scope chain.  Lookups within an explicit namespace (qualified paths)
+    // still go through the per-namespace tables.
+    std::unordered_map<cstring, std::vector<NamedSymbol*>> visibleSymbols;
+    // Names declared at each namespace depth, so pop() can undo the
+    // visibleSymbols entries of the scope being left.
+    std::vector<std::vector<cstring>> scopeNames;
+
     void push(Namespace* ns);
     NamedSymbol* lookup(const cstring identifier);
     void declare(NamedSymbol* symbol);
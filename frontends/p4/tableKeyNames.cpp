@@ -29,7 +29,7 @@ void KeyNameGenerator::postorder(const IR::Expression* expression) {
 }
 
 void KeyNameGenerator::postorder(const IR::PathExpression* expression)
-{ name.emplace(expression, expression->path->toString()); }
+{ nameFor(expression, expression->path->toString()); }
 
 namespace {
 
@@ -72,14 +72,14 @@ void KeyNameGenerator::postorder(const IR::Member* expression) {
     // discard the left-hand side of the Member expression. (We'll also strip
     // off the `.` so it doesn't appear in the key name.)
     if (fname.startsWith(".")) {
-        name.emplace(expression, fname.substr(1));
+        nameFor(expression, fname.substr(1));
         return;
     }
 
     // We can generate a name for the overall Member expression only if we were
     // able to generate a name for its left-hand side.
     if (cstring n = getName(expression->expr))
-        name.emplace(expression, n + "." + fname);
+        nameFor(expression, n + "." + fname);
 }
 
 void KeyNameGenerator::postorder(const IR::ArrayIndex* expression) {
@@ -87,11 +87,11 @@ void KeyNameGenerator::postorder(const IR::ArrayIndex* expression) {
     cstring r = getName(expression->right);
     if (!l || !r)
         return;
-    name.emplace(expression, l + "[" + r + "]");
+    nameFor(expression, l + "[" + r + "]");
 }
 
 void KeyNameGenerator::postorder(const IR::Constant* expression)
-{ name.emplace(expression, Util::toString(expression->value, 0, false, expression->base)); }
+{ nameFor(expression, Util::toString(expression->value, 0, false, expression->base)); }
 
 void KeyNameGenerator::postorder(const IR::Slice* expression) {
     cstring e0 = getName(expression->e0);
@@ -99,7 +99,7 @@ void KeyNameGenerator::postorder(const IR::Slice* expression) {
     cstring e2 = getName(expression->e2);
     if (!e0 || !e1 || !e2)
         return;
-    name.emplace(expression, e0 + "[" + e1 + ":" + e2 + "]");
+    nameFor(expression, e0 + "[" + e1 + ":" + e2 + "]");
 }
 
 void KeyNameGenerator::postorder(const IR::BAnd* expression) {
@@ -107,7 +107,7 @@ void KeyNameGenerator::postorder(const IR::BAnd* expression) {
     if (!left) return;
     cstring right = getName(expression->right);
     if (!right) return;
-    name.emplace(expression, left + " & " + right);
+    nameFor(expression, left + " & " + right);
 }
 
 void KeyNameGenerator::postorder(const IR::MethodCallExpression* expression) {
@@ -117,7 +117,7 @@ void KeyNameGenerator::postorder(const IR::MethodCallExpression* expression) {
 
     // This is a heuristic.
     if (m.endsWith("$valid$") && expression->arguments->size() == 0) {
-        name.emplace(expression, m);
+        nameFor(expression, m);
         return;
     }
 
@@ -129,9 +129,8 @@ const IR::Node* DoTableKeyNames::postorder(IR::KeyElement* keyElement) {
     if (keyElement->getAnnotation(IR::Annotation::nameAnnotation) != nullptr)
         // already present: no changes
         return keyElement;
-    KeyNameGenerator kng(typeMap);;
-    (void)keyElement->expression->apply(kng);
-    cstring name = kng.getName(keyElement->expression);
+    (void)keyElement->expression->apply(generator);
+    cstring name = generator.getName(keyElement->expression);
 
     LOG3("Generated name " << name);
     if (!name)
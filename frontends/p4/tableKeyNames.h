@@ -20,6 +20,7 @@ limitations under the License.
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
+#include "ir/visitor.h"
 
 namespace P4 {
 
@@ -28,15 +29,26 @@ namespace P4 {
  *
  * Emit a compilation error if the IR contains complex expressions without
  * `@name` annotations.
+ *
+ * The generated names are memoized by node id, so a generator instance
+ * can be applied to many key expressions and subtrees shared between
+ * them are only rendered once.
  */
 class KeyNameGenerator : public Inspector {
-    std::map<const IR::Expression*, cstring> name;
+    NodeIdInfoMap<cstring> name;
     const TypeMap* typeMap;  // can be nullptr
 
+    void nameFor(const IR::Expression* expression, cstring n)
+    { name[expression->id] = n; }
+
  public:
     explicit KeyNameGenerator(const TypeMap* typeMap) : typeMap(typeMap)
     { setName("KeyNameGenerator"); }
     void error(const IR::Expression* expression);
+    bool preorder(const IR::Expression* expression) override {
+        // do not re-render a subtree whose name is already known
+        return !getName(expression);
+    }
     void postorder(const IR::Expression* expression) override;
     void postorder(const IR::PathExpression* expression) override;
     void postorder(const IR::Member* expression) override;
@@ -46,7 +58,8 @@ class KeyNameGenerator : public Inspector {
     void postorder(const IR::BAnd* expression) override;
     void postorder(const IR::MethodCallExpression* expression) override;
     cstring getName(const IR::Expression* expression) {
-        return ::get(name, expression);
+        auto n = name.find(expression->id);
+        return n != nullptr ? *n : cstring();
     }
 };
 
@@ -78,9 +91,11 @@ class KeyNameGenerator : public Inspector {
  * without `@name` annotations.
  */
 class DoTableKeyNames final : public Transform {
-    const TypeMap* typeMap;
+    /// Shared across all key elements so identical (shared) expressions
+    /// are only rendered once.
+    KeyNameGenerator generator;
  public:
-    explicit DoTableKeyNames(const TypeMap* typeMap) :typeMap(typeMap)
+    explicit DoTableKeyNames(const TypeMap* typeMap) : generator(typeMap)
     { CHECK_NULL(typeMap); setName("DoTableKeyNames"); }
     const IR::Node* postorder(IR::KeyElement* keyElement) override;
 };
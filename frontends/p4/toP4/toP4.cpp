@@ -33,8 +33,11 @@ Visitor::profile_t ToP4::init_apply(const IR::Node* node) {
 
 void ToP4::end_apply(const IR::Node*) {
     if (outStream != nullptr) {
-        cstring result = builder.toString();
-        *outStream << result.c_str();
+        // top-level declarations were already streamed out as they were
+        // printed; this writes whatever is left (everything, when the
+        // root was not a P4Program)
+        builder.writeTo(*outStream);
+        builder.clear();
         outStream->flush();
     }
     BUG_CHECK(listTerminators.size() == listTerminators_init_apply_size,
@@ -169,9 +172,9 @@ bool ToP4::preorder(const IR::P4Program* program) {
                 if (sourceFile.startsWith(p4includePath)) {
                     const char *p = sourceFile.c_str() + strlen(p4includePath);
                     if (*p == '/') p++;
-                    if (P4V1::V1Model::instance.file.name == p) {
+                    if (P4V1::V1Model::instance().file.name == p) {
                         std::stringstream buf;
-                        buf << "#define V1MODEL_VERSION " << P4V1::V1Model::instance.version;
+                        buf << "#define V1MODEL_VERSION " << P4V1::V1Model::instance().version;
                         builder.appendLine(buf.str()); }
                     builder.append("#include <");
                     builder.append(p);
@@ -190,6 +193,7 @@ bool ToP4::preorder(const IR::P4Program* program) {
             builder.newline();
         first = false;
         visit(a);
+        flushStream();
     }
     if (!program->objects.empty())
         builder.newline();
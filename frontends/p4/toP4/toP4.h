@@ -78,6 +78,15 @@ class ToP4 : public Inspector {
     // dump node IR tree up to depth - in the form of a comment
     void dump(unsigned depth, const IR::Node* node = nullptr, unsigned adjDepth = 0);
     unsigned curDepth() const;
+    /// When printing to a stream, write everything accumulated so far to
+    /// it and drop it from the builder.  Called after each top-level
+    /// declaration, so at most one declaration is buffered at a time.
+    void flushStream() {
+        if (outStream == nullptr)
+            return;
+        builder.writeTo(*outStream);
+        builder.clear();
+    }
 
  public:
     // Output is constructed here
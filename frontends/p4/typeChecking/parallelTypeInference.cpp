@@ -0,0 +1,148 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "parallelTypeInference.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "lib/compile_context.h"
+#include "lib/gc.h"
+
+namespace P4 {
+
+namespace {
+/** Type inference that stops at control and parser boundaries: it types
+ * the signature of each top-level P4Control/P4Parser (its functor type and
+ * constructor parameters) but not its locals or body, which are left for
+ * the parallel phase. */
+class SkeletonTypeInference : public TypeInference {
+    const IR::Node* root = nullptr;
+
+ public:
+    SkeletonTypeInference(ReferenceMap* refMap, TypeMap* typeMap)
+            : TypeInference(refMap, typeMap, true) {}
+
+    Visitor::profile_t init_apply(const IR::Node* node) override {
+        root = node;
+        return TypeInference::init_apply(node);
+    }
+
+    // TypeInference::end_apply would mark the map up-to-date for the
+    // program, but it is only complete once the bodies have been typed;
+    // ParallelTypeInference updates it after the merge.
+    void end_apply(const IR::Node* node) override {
+        BUG_CHECK(*node == *root, "At this point in the compilation typechecking "
+                  "should not infer new types anymore, but it did.");
+    }
+
+    // The work of the P4Control/P4Parser postorders must happen in
+    // preorder here, because prune() skips the postorder as well.
+    const IR::Node* preorder(IR::P4Control* cont) override {
+        visit(cont->type, "type");
+        visit(cont->constructorParams, "constructorParams");
+        (void)setTypeType(cont, false);
+        prune();
+        return cont;
+    }
+
+    const IR::Node* preorder(IR::P4Parser* parser) override {
+        visit(parser->type, "type");
+        visit(parser->constructorParams, "constructorParams");
+        (void)setTypeType(parser, false);
+        prune();
+        return parser;
+    }
+};
+}  // namespace
+
+ParallelTypeInference::ParallelTypeInference(ReferenceMap* refMap, TypeMap* typeMap) :
+        refMap(refMap), typeMap(typeMap) {
+    CHECK_NULL(refMap); CHECK_NULL(typeMap);
+    setName("ParallelTypeInference");
+}
+
+bool ParallelTypeInference::preorder(const IR::P4Program* program) {
+    if (typeMap->checkMap(program)) {
+        LOG2("No need to typecheck");
+        return false;
+    }
+
+    unsigned initialErrorCount = ::errorCount();
+    SkeletonTypeInference skeleton(refMap, typeMap);
+    (void)program->apply(skeleton);
+    if (::errorCount() > initialErrorCount)
+        // the bodies would only produce noise on top of the signature errors
+        return false;
+
+    std::vector<const IR::Node*> work;
+    for (auto decl : program->objects)
+        if (decl->is<IR::P4Control>() || decl->is<IR::P4Parser>())
+            work.push_back(decl);
+
+    size_t nthreads = std::thread::hardware_concurrency();
+    if (nthreads > work.size()) nthreads = work.size();
+    if (nthreads < 2) {
+        // no parallelism available -- type the bodies sequentially
+        for (auto decl : work) {
+            TypeInference ti(refMap, typeMap, true);
+            (void)decl->apply(ti);
+        }
+    } else {
+        std::atomic<size_t> next(0);
+        std::vector<std::exception_ptr> failures(nthreads);
+        // each worker grows a private copy of the map; the shared one is
+        // only read until the workers have joined
+        std::vector<TypeMap> localMaps(nthreads, *typeMap);
+        std::vector<std::thread> workers;
+        auto* parentContext = CompileContextStack::currentOrNull();
+        // one lane per work item: diagnostics merge in declaration order,
+        // matching the sequential loop, whatever the scheduling
+        auto& reporter = BaseCompileContext::get().errorReporter();
+        reporter.beginSequencedEmission(work.size());
+        for (size_t t = 0; t < nthreads; ++t) {
+            workers.emplace_back([this, t, parentContext, &work, &next, &failures, &localMaps]() {
+                gc_register_thread();
+                // the context stack is thread-local; adopt the spawning thread's
+                InheritedCompileContext inherited(parentContext);
+                try {
+                    size_t i;
+                    while ((i = next.fetch_add(1)) < work.size()) {
+                        ErrorReporter::SequenceLaneScope lane(int(i));
+                        TypeInference ti(refMap, &localMaps[t], true);
+                        (void)work[i]->apply(ti);
+                    }
+                } catch (...) {
+                    failures[t] = std::current_exception();
+                }
+                gc_unregister_thread();
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        reporter.endSequencedEmission();
+        for (auto& failure : failures)
+            if (failure) std::rethrow_exception(failure);
+        for (auto& local : localMaps)
+            typeMap->merge(&local);
+    }
+
+    if (::errorCount() == initialErrorCount)
+        typeMap->updateMap(program);
+    return false;
+}
+
+}  // namespace P4
@@ -0,0 +1,57 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _TYPECHECKING_PARALLELTYPEINFERENCE_H_
+#define _TYPECHECKING_PARALLELTYPEINFERENCE_H_
+
+#include "ir/ir.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+
+namespace P4 {
+
+/** @brief Read-only type inference that checks top-level controls and
+ * parsers on worker threads.
+ *
+ * Drop-in replacement for a read-only @ref TypeInference; selected by
+ * @ref TypeChecking when the --parallel-typecheck option is given.
+ * It proceeds in three phases:
+ *
+ * 1. (serial) Run type inference over the whole program, descending into
+ *    each top-level P4Control/P4Parser only far enough to type its
+ *    signature.  After this phase every name a body can refer to has a
+ *    type in the shared TypeMap.
+ * 2. (parallel) Distribute the control and parser bodies over the
+ *    available hardware threads; each worker types the bodies it grabs
+ *    against its own copy of the shared TypeMap.
+ * 3. (serial) Merge the thread-local maps back into the shared one
+ *    (see TypeMap::merge).
+ *
+ * Because it never mutates the program, this pass must only run after a
+ * mutating TypeInference has already inserted all implicit casts --
+ * exactly the situation TypeChecking is used in.
+ */
+class ParallelTypeInference : public Inspector {
+    ReferenceMap* refMap;
+    TypeMap* typeMap;
+
+ public:
+    ParallelTypeInference(ReferenceMap* refMap, TypeMap* typeMap);
+    bool preorder(const IR::P4Program* program) override;
+};
+
+}  // namespace P4
+
+#endif /* _TYPECHECKING_PARALLELTYPEINFERENCE_H_ */
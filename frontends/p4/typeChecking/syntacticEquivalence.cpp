@@ -18,6 +18,65 @@ limitations under the License.
 
 namespace P4 {
 
+namespace {
+// 64-bit variant of hash_combine
+uint64_t mix(uint64_t hash, uint64_t value) {
+    return hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 12) + (hash >> 4));
+}
+uint64_t mix(uint64_t hash, const void* pointer) {
+    return mix(hash, reinterpret_cast<uint64_t>(pointer));
+}
+}  // namespace
+
+uint64_t SameExpression::fingerprint(const IR::Expression* expression) const {
+    uint64_t& cached = fingerprints[expression->id];
+    if (cached != 0)
+        return cached;
+    // node type names are interned, so the pointer identifies the opcode
+    uint64_t hash = reinterpret_cast<uint64_t>(expression->node_type_name().c_str());
+    if (auto unary = expression->to<IR::Operation_Unary>()) {
+        if (auto member = expression->to<IR::Member>())
+            hash = mix(hash, member->member.name.c_str());
+        // Cast types are deliberately not hashed; see the header.
+        hash = mix(hash, fingerprint(unary->expr));
+    } else if (auto binary = expression->to<IR::Operation_Binary>()) {
+        hash = mix(mix(hash, fingerprint(binary->left)), fingerprint(binary->right));
+    } else if (auto ternary = expression->to<IR::Operation_Ternary>()) {
+        hash = mix(mix(mix(hash, fingerprint(ternary->e0)), fingerprint(ternary->e1)),
+                   fingerprint(ternary->e2));
+    } else if (auto constant = expression->to<IR::Constant>()) {
+        bool negative = constant->value < 0;
+        big_int magnitude = negative ? -constant->value : constant->value;
+        hash = mix(hash, static_cast<uint64_t>(magnitude & big_int(0xffffffffffffffffULL)));
+        if (negative)
+            hash = mix(hash, 1);
+    } else if (auto boolean = expression->to<IR::BoolLiteral>()) {
+        hash = mix(hash, boolean->value ? 2 : 1);
+    } else if (auto string = expression->to<IR::StringLiteral>()) {
+        hash = mix(hash, string->value.c_str());
+    } else if (auto pe = expression->to<IR::PathExpression>()) {
+        hash = mix(hash, refMap->getDeclaration(pe->path, true));
+    } else if (auto tne = expression->to<IR::TypeNameExpression>()) {
+        hash = mix(hash, refMap->getDeclaration(tne->typeName->path, true));
+    } else if (auto list = expression->to<IR::ListExpression>()) {
+        for (auto component : list->components)
+            hash = mix(hash, fingerprint(component));
+    } else if (auto mce = expression->to<IR::MethodCallExpression>()) {
+        hash = mix(hash, fingerprint(mce->method));
+        hash = mix(hash, static_cast<uint64_t>(mce->typeArguments->size()));
+        for (auto argument : *mce->arguments)
+            hash = mix(hash, fingerprint(argument->expression));
+    } else if (auto cce = expression->to<IR::ConstructorCallExpression>()) {
+        for (auto argument : *cce->arguments)
+            hash = mix(hash, fingerprint(argument->expression));
+    }
+    // all other expression kinds hash on the opcode alone
+    if (hash == 0)
+        hash = 1;  // 0 is reserved for "not yet computed"
+    cached = hash;
+    return hash;
+}
+
 bool SameExpression::sameType(const IR::Type* left, const IR::Type* right) const {
     auto lt = typeMap->getType(left, true);
     auto rt = typeMap->getType(right, true);
@@ -46,6 +105,10 @@ bool SameExpression::sameExpressions(const IR::Vector<IR::Argument>* left,
 
 bool SameExpression::sameExpression(const IR::Expression* left, const IR::Expression* right) const {
     CHECK_NULL(left); CHECK_NULL(right);
+    // equivalent expressions have equal fingerprints, so a fingerprint
+    // mismatch rejects the pair without recursing
+    if (fingerprint(left) != fingerprint(right))
+        return false;
     if (left->node_type_name() != right->node_type_name())
         return false;
     if (left->is<IR::Operation_Unary>()) {
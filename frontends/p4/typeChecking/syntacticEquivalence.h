@@ -18,6 +18,7 @@ limitations under the License.
 #define _TYPECHECKING_SYNTACTICEQUIVALENCE_H_
 
 #include "ir/ir.h"
+#include "ir/visitor.h"
 #include "frontends/p4/typeMap.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 
@@ -27,6 +28,19 @@ namespace P4 {
 class SameExpression {
     const ReferenceMap* refMap;
     const TypeMap* typeMap;
+
+    /// Syntactic fingerprint of each expression visited, keyed by node
+    /// id: a hash of the opcode, the salient leaf data, and the child
+    /// fingerprints.  Equivalent expressions have equal fingerprints, so
+    /// comparing the fingerprints first rejects most mismatched pairs in
+    /// constant time instead of recursing.  Types are not hashed
+    /// (equivalent types need not be structurally identical), so type
+    /// mismatches are still found by the full comparison.  Per instance
+    /// because fingerprints embed declaration pointers from the refMap.
+    /// The value 0 is reserved for "not yet computed".
+    mutable NodeIdInfoMap<uint64_t> fingerprints;
+    uint64_t fingerprint(const IR::Expression* expression) const;
+
  public:
     explicit SameExpression(const ReferenceMap* refMap, const TypeMap* typeMap) :
             refMap(refMap), typeMap(typeMap) { CHECK_NULL(refMap); CHECK_NULL(typeMap); }
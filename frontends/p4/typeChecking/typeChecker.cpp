@@ -22,6 +22,8 @@ limitations under the License.
 #include "frontends/p4/coreLibrary.h"
 #include "frontends/p4/toP4/toP4.h"
 #include "syntacticEquivalence.h"
+#include "parallelTypeInference.h"
+#include "frontends/common/options.h"
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/methodInstance.h"
 
@@ -89,11 +91,18 @@ class ConstantTypeSubstitution : public Transform {
 
 TypeChecking::TypeChecking(ReferenceMap* refMap, TypeMap* typeMap,
                            bool updateExpressions) {
+    bool parallel = P4CContext::get().options().parallelTypecheck;
+    // TypeChecking instances are inserted defensively all over the
+    // pipeline, so most applications see a program that is unchanged (the
+    // maps are up-to-date and the passes no-op) or where only a few
+    // top-level objects were replaced; resolve references incrementally to
+    // avoid rebuilding the map from scratch in the latter case.
     addPasses({
-       new P4::ResolveReferences(refMap),
-       new P4::TypeInference(refMap, typeMap, true),
+       new P4::ResolveReferences(refMap, false, /* incremental */ true),
+       parallel ? static_cast<Visitor*>(new P4::ParallelTypeInference(refMap, typeMap))
+                : static_cast<Visitor*>(new P4::ReadOnlyTypeInference(refMap, typeMap)),
        updateExpressions ? new ApplyTypesToExpressions(typeMap) : nullptr,
-       updateExpressions ? new P4::ResolveReferences(refMap) : nullptr });
+       updateExpressions ? new P4::ResolveReferences(refMap, false, true) : nullptr });
     setStopOnError(true);
 }
 
@@ -931,7 +940,7 @@ TypeInference::checkExternConstructor(const IR::Node* errorPosition,
 bool TypeInference::checkAbstractMethods(const IR::Declaration_Instance* inst,
                                          const IR::Type_Extern* type) {
     // Make a list of the abstract methods
-    IR::NameMap<IR::Method, ordered_map> virt;
+    IR::NameMap<IR::Method, IR::flatmap> virt;
     for (auto m : type->methods)
         if (m->isAbstract)
             virt.addUnique(m->name, m);
@@ -3150,7 +3159,7 @@ void TypeInference::checkEmitType(const IR::Expression* emit, const IR::Type* ty
 }
 
 void TypeInference::checkCorelibMethods(const ExternMethod* em) const {
-    P4CoreLibrary &corelib = P4CoreLibrary::instance;
+    P4CoreLibrary &corelib = P4CoreLibrary::instance();
     auto et = em->actualExternType;
     auto mce = em->expr;
     unsigned argCount = mce->arguments->size();
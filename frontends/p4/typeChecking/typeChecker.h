@@ -302,6 +302,22 @@ class TypeInference : public Transform {
     TypeInference* clone() const override;
 };
 
+// TypeInference that traverses without cloning: the visit functions are
+// handed the nodes of the input tree itself, so the pass runs with
+// Inspector-like cost and only repopulates the typeMap.  This is the right
+// instance for TypeChecking, which applies type inference in read-only mode
+// to an already canonicalized program; the casts such a program could still
+// need have all been inserted by the non-readOnly runs in the frontend.
+// Note that without a pristine original to compare against, an in-place
+// modification the pass would make (a bug at this point of compilation) can
+// no longer be detected.  The clone()s used internally to learn types of
+// newly created subtrees still run in the ordinary cloning mode.
+class ReadOnlyTypeInference : public TypeInference {
+ public:
+    ReadOnlyTypeInference(ReferenceMap* refMap, TypeMap* typeMap)
+            : TypeInference(refMap, typeMap, true) { inplaceReadOnly = true; }
+};
+
 // Copy types from the typeMap to expressions.  Updates the typeMap with newly created nodes
 class ApplyTypesToExpressions : public Transform {
     TypeMap *typeMap;
@@ -37,6 +37,9 @@ TypeVariableSubstitution* TypeConstraints::solve() {
         if (!success)
             return nullptr;
     }
+    // Bindings accumulate without rewriting one another while solving;
+    // fold them into fully resolved form in one pass now.
+    currentSubstitution->resolve();
     LOG3("Constraint solution:\n" << currentSubstitution);
     return currentSubstitution;
 }
@@ -81,7 +81,7 @@ class TypeConstraint : public IHasDbPrint {
     cstring localError(Explain* explainer) const {
         if (errFormat.isNullOrEmpty()) return "";
         std::string message, explanation;
-        boost::format fmt = boost::format(errFormat);
+        Util::Format fmt(errFormat.c_str());
         switch (errArguments.size()) {
             case 0:
                 message = ::error_helper(fmt, "", "", "", "");
@@ -132,7 +132,7 @@ class TypeConstraint : public IHasDbPrint {
         /// The top of the stack has no 'derivedFrom' field,
         /// and it contains the actual source position where
         /// the analysis started.
-        boost::format fmt(format);
+        Util::Format fmt(format);
         cstring message = cstring("  ---- Actual error:\n") +
                 ::error_helper(fmt, "", "", "", "", args...);
         auto o = origin;
@@ -54,29 +54,53 @@ cstring TypeVariableSubstitution::compose(const IR::ITypeVar* var, const IR::Typ
             var->toString(), substitution->toString(), bound->toString());
     }
 
-    // Replace var with substitution everywhere
-    TypeVariableSubstitution *tvs = new TypeVariableSubstitution();
-    bool success = tvs->setBinding(var, substitution);
+    // The binding is stored exactly as given.  It may mention variables
+    // bound by other constraints; those are substituted away all at once
+    // by resolve() when solving completes, instead of re-cloning every
+    // existing binding here on each new constraint.
+    bool success = setBinding(var, substitution);
     if (!success)
-        BUG("Cannot set binding");
-
-    TypeVariableSubstitutionVisitor visitor(tvs);
-    for (auto &bound : binding) {
-        const IR::Type* type = bound.second;
-        const IR::Node* newType = type->apply(visitor);
-        if (newType == nullptr)
-            return "Could not replace '%1%' with '%2%'";
-        if (newType == type)
-            continue;
+        BUG("Failed to insert binding");
+    return "";
+}
 
-        LOG3("Refining subsitution for " << bound.first->getNode() << " to " << newType);
-        bound.second = newType->to<IR::Type>();
+namespace {
+/// Collects the type variables occurring in a type.
+class TypeVariableCollector : public Inspector {
+ public:
+    std::vector<const IR::ITypeVar*> vars;
+    bool preorder(const IR::Type_Var* tv) override { vars.push_back(tv); return true; }
+    bool preorder(const IR::Type_InfInt* ti) override { vars.push_back(ti); return true; }
+};
+}  // namespace
+
+void TypeVariableSubstitution::resolveVariable(const IR::ITypeVar* var,
+                                               std::set<const IR::ITypeVar*>& visited) {
+    // Marking the variable before recursing makes a circular chain of
+    // variables terminate; the variables on the cycle are simply left in
+    // place, just as the eager rewrite used to leave them.
+    if (!visited.insert(var).second)
+        return;
+    auto it = binding.find(var);
+    if (it == binding.end())
+        return;
+    TypeVariableCollector collector;
+    it->second->apply(collector);
+    for (auto dep : collector.vars)
+        if (dep != var)
+            resolveVariable(dep, visited);
+    TypeVariableSubstitutionVisitor replace(this);
+    const IR::Node* newType = it->second->apply(replace);
+    if (newType != nullptr && newType != it->second) {
+        LOG3("Resolved substitution for " << it->first->getNode() << " to " << newType);
+        it->second = newType->to<IR::Type>();
     }
+}
 
-    success = setBinding(var, substitution);
-    if (!success)
-        BUG("Failed to insert binding");
-    return "";
+void TypeVariableSubstitution::resolve() {
+    std::set<const IR::ITypeVar*> visited;
+    for (auto &bound : binding)
+        resolveVariable(bound.first, visited);
 }
 
 void TypeVariableSubstitution::simpleCompose(const TypeVariableSubstitution* other) {
@@ -92,6 +116,22 @@ void TypeVariableSubstitution::simpleCompose(const TypeVariableSubstitution* oth
     }
 }
 
+void TypeVariableSubstitution::mergeCompose(const TypeVariableSubstitution* other) {
+    CHECK_NULL(other);
+    for (auto v : other->binding) {
+        const IR::Type* subst = v.second;
+        auto it = binding.find(v.first);
+        if (it != binding.end()) {
+            if (it->second != subst)
+                BUG("Changing binding for %1% from %2% to %3%",
+                    v.first, it->second, subst);
+            continue;
+        }
+        LOG3("Setting substitution for " << v.first->getNode() << " to " << subst);
+        binding[v.first] = subst;
+    }
+}
+
 bool TypeVariableSubstitution::setBindings(const IR::Node* errorLocation,
                                            const IR::TypeParameters* params,
                                            const IR::Vector<IR::Type>* args) {
@@ -18,6 +18,7 @@ limitations under the License.
 #define _TYPECHECKING_TYPESUBSTITUTION_H_
 
 #include <map>
+#include <set>
 #include <sstream>
 
 #include "ir/ir.h"
@@ -44,6 +45,8 @@ class TypeSubstitution : public IHasDbPrint {
 
     bool containsKey(T key) const { return binding.find(key) != binding.end(); }
 
+    const std::map<T, const IR::Type*>& getBindings() const { return binding; }
+
     /* This can fail if id is already bound.
      * @return true on success. */
     bool setBinding(T id, const IR::Type* type) {
@@ -83,10 +86,28 @@ class TypeVariableSubstitution final : public TypeSubstitution<const IR::ITypeVa
     /// Returns an empyty string on error, or an error message format otherwise.
     /// The error message should be used with 'var' and 'substitution' as arguments when
     /// reporting an error (i.e., it may contain %1% and %2% inside).
+    /// The binding is stored exactly as given; bindings may mention other
+    /// bound variables until resolve() is called.
     cstring compose(const IR::ITypeVar* var, const IR::Type* substitution);
+    /// Rewrite every binding into fully resolved form, so that no bound
+    /// variable remains inside a non-variable binding (variable-to-variable
+    /// chains are compressed to their last variable).  Called once when
+    /// constraint solving completes; resolving each binding after the
+    /// bindings it depends on makes the total work linear in the size of
+    /// the resolved types.
+    void resolve();
     // In this variant of compose all variables in 'other' that are
     // assigned to are disjoint from all variables already in 'this'.
     void simpleCompose(const TypeVariableSubstitution* other);
+    // Like simpleCompose, but bindings already present are tolerated
+    // (and must agree); used when merging a substitution that grew from
+    // a copy of 'this'.
+    void mergeCompose(const TypeVariableSubstitution* other);
+
+ private:
+    /// Resolve the binding for @var, depth-first after everything it
+    /// depends on; @visited guards against circular variable chains.
+    void resolveVariable(const IR::ITypeVar* var, std::set<const IR::ITypeVar*>& visited);
 };
 
 }  // namespace P4
@@ -14,7 +14,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <memory>
+
 #include "typeMap.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+#include "lib/hash.h"
 #include "lib/map.h"
 
 namespace P4 {
@@ -64,6 +69,7 @@ void TypeMap::cloneExpressionProperties(const IR::Expression* to,
 void TypeMap::clear() {
     LOG3("Clearing typeMap");
     typeMap.clear(); leftValues.clear(); constants.clear(); allTypeVariables.clear();
+    canonicalTypes.clear(); typeHashCache.clear();
     program = nullptr;
 }
 
@@ -106,6 +112,87 @@ const IR::Type* TypeMap::getTypeType(const IR::Node* element, bool notNull) cons
     return result->to<IR::Type_Type>()->type;
 }
 
+void TypeMap::merge(const TypeMap* other) {
+    CHECK_NULL(other);
+    // Entries both maps have were either copied at the fork or computed
+    // independently for a node shared between subtrees; in the latter case
+    // the types are equivalent (if not pointer-equal), so keeping ours is
+    // always correct.
+    for (auto& it : other->typeMap)
+        typeMap.emplace(it.first, it.second);
+    leftValues.insert(other->leftValues.begin(), other->leftValues.end());
+    constants.insert(other->constants.begin(), other->constants.end());
+    allTypeVariables.mergeCompose(other->getSubstitutions());
+    for (auto& it : other->typeHashCache)
+        typeHashCache.emplace(it.first, it.second);
+    // The canonical-type intern table may end up with equivalent duplicates
+    // created by different threads; that only costs a few extra equivalent()
+    // calls in getCanonical, so we just avoid inserting identical pointers.
+    for (auto& it : other->canonicalTypes) {
+        bool present = false;
+        auto range = canonicalTypes.equal_range(it.first);
+        for (auto c = range.first; c != range.second; ++c) {
+            if (c->second == it.second) {
+                present = true;
+                break;
+            }
+        }
+        if (!present)
+            canonicalTypes.emplace(it.first, it.second);
+    }
+}
+
+std::function<void()> TypeMap::checkpoint() {
+    // the closure may be invoked once per backtrack retry, so it must not
+    // consume the snapshot when restoring
+    auto saved = std::make_shared<TypeMap>(*this);
+    return [this, saved]() { *this = *saved; };
+}
+
+void TypeMap::toJSON(JSONGenerator& json) const {
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> types;
+    types.reserve(typeMap.size());
+    for (auto& e : typeMap)
+        types.emplace_back(e.first, e.second);
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> vars;
+    for (auto& b : allTypeVariables.getBindings())
+        vars.emplace_back(b.first->getNode(), b.second);
+    // The canonical-type and hash caches are rebuilt on demand.
+    json << json.indent << "\"typeMap\" : " << types << "," << std::endl;
+    json << json.indent << "\"leftValues\" : " << leftValues << "," << std::endl;
+    json << json.indent << "\"constants\" : " << constants << "," << std::endl;
+    json << json.indent << "\"typeVars\" : " << vars;
+}
+
+void TypeMap::loadFromJSON(JSONLoader& loader) {
+    clear();
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> types;
+    loader.load("typeMap", types);
+    for (auto& e : types)
+        if (e.first != nullptr && e.second != nullptr)
+            if (auto type = e.second->to<IR::Type>())
+                typeMap.emplace(e.first, type);
+    std::vector<const IR::Expression*> exprs;
+    loader.load("leftValues", exprs);
+    for (auto e : exprs)
+        if (e != nullptr)
+            leftValues.insert(e);
+    exprs.clear();
+    loader.load("constants", exprs);
+    for (auto e : exprs)
+        if (e != nullptr)
+            constants.insert(e);
+    std::vector<std::pair<const IR::Node*, const IR::Node*>> vars;
+    loader.load("typeVars", vars);
+    for (auto& b : vars) {
+        auto var = b.first != nullptr ? b.first->to<IR::ITypeVar>() : nullptr;
+        auto type = b.second != nullptr ? b.second->to<IR::Type>() : nullptr;
+        if (var != nullptr && type != nullptr)
+            allTypeVariables.setBinding(var, type);
+    }
+    LOG2("Loaded TypeMap with " << size() << " entries");
+}
+
 void TypeMap::addSubstitutions(const TypeVariableSubstitution* tvs) {
     if (tvs == nullptr || tvs->isIdentity())
         return;
@@ -117,9 +204,11 @@ void TypeMap::addSubstitutions(const TypeVariableSubstitution* tvs) {
 // Does not do unification of type variables - a type variable is only
 // equivalent to itself.  nullptr is only equivalent to nullptr.
 bool TypeMap::equivalent(const IR::Type* left, const IR::Type* right) {
-    if (left == nullptr)
-        return right == nullptr;
-    if (right == nullptr)
+    if (left == right)
+        // Canonical types are interned (see getCanonical), so in the common
+        // case equivalence is just pointer equality.
+        return true;
+    if (left == nullptr || right == nullptr)
         return false;
     if (left->node_type_name() != right->node_type_name())
         return false;
@@ -315,24 +404,79 @@ bool TypeMap::implicitlyConvertibleTo(const IR::Type* from, const IR::Type* to)
     return false;
 }
 
+static uint64_t hashCombine(uint64_t h, uint64_t v) {
+    // FNV-style mixing; only used to key the intern table, so quality
+    // matters less than never disagreeing with equivalent()
+    return (h ^ v) * 0x100000001b3ULL;
+}
+
+static uint64_t hashString(cstring s) {
+    return s.isNull() ? 0 : Util::Hash::hash(s.c_str(), s.size());
+}
+
+// Mirrors the structure of equivalent(): fields that equivalent() ignores
+// (e.g. struct names when one side may be a Type_UnknownStruct) are left out
+// of the hash, so equivalent types always land in the same bucket.
+uint64_t TypeMap::typeHash(const IR::Type* type) {
+    if (type == nullptr)
+        return 0;
+    auto it = typeHashCache.find(type);
+    if (it != typeHashCache.end())
+        return it->second;
+
+    uint64_t h = hashString(type->node_type_name());
+    if (type->is<IR::Type_Base>() || type->is<IR::Type_Newtype>()) {
+        h = hashCombine(h, hashString(type->toString()));
+    } else if (auto tt = type->to<IR::Type_Type>()) {
+        h = hashCombine(h, typeHash(tt->type));
+    } else if (auto tv = type->to<IR::ITypeVar>()) {
+        h = hashCombine(hashCombine(h, hashString(tv->getVarName())), tv->getDeclId());
+    } else if (auto ts = type->to<IR::Type_Stack>()) {
+        h = hashCombine(h, typeHash(ts->elementType));
+        if (ts->sizeKnown())
+            h = hashCombine(h, ts->getSize());
+    } else if (auto te = type->to<IR::Type_Enum>()) {
+        h = hashCombine(h, hashString(te->name.name));
+    } else if (auto tse = type->to<IR::Type_SerEnum>()) {
+        h = hashCombine(h, hashString(tse->name.name));
+    } else if (auto tsl = type->to<IR::Type_StructLike>()) {
+        // the name deliberately does not participate: a Type_UnknownStruct
+        // is equivalent to any struct with the same fields
+        for (auto f : tsl->fields)
+            h = hashCombine(hashCombine(h, hashString(f->name.name)), typeHash(f->type));
+    } else if (auto tbl = type->to<IR::Type_BaseList>()) {
+        // covers both Type_Tuple and Type_List, distinguished by node_type_name
+        for (auto c : tbl->components)
+            h = hashCombine(h, typeHash(c));
+    } else if (auto tset = type->to<IR::Type_Set>()) {
+        h = hashCombine(h, typeHash(tset->elementType));
+    } else if (auto tsc = type->to<IR::Type_SpecializedCanonical>()) {
+        h = hashCombine(h, typeHash(tsc->substituted));
+    } else if (auto ta = type->to<IR::Type_ActionEnum>()) {
+        h = hashCombine(h, reinterpret_cast<uintptr_t>(ta->actionList));
+    } else if (auto tex = type->to<IR::Type_Extern>()) {
+        h = hashCombine(h, hashString(tex->name.name));
+    }
+    // For the remaining kinds (packages, methods, IApply) the class name
+    // alone is a valid - if coarse - hash; equivalent() disambiguates.
+
+    typeHashCache.emplace(type, h);
+    return h;
+}
+
 // Used for tuples, stacks and lists only
 const IR::Type* TypeMap::getCanonical(const IR::Type* type) {
-    // Currently a linear search; hopefully this won't be too expensive in practice
-    std::vector<const IR::Type*>* searchIn;
-    if (type->is<IR::Type_Stack>())
-        searchIn = &canonicalStacks;
-    else if (type->is<IR::Type_Tuple>())
-        searchIn = &canonicalTuples;
-    else if (type->is<IR::Type_List>())
-        searchIn = &canonicalLists;
-    else
+    if (!type->is<IR::Type_Stack>() && !type->is<IR::Type_Tuple>() &&
+        !type->is<IR::Type_List>())
         BUG("%1%: unexpected type", type);
 
-    for (auto t : *searchIn) {
-        if (TypeMap::equivalent(type, t))
-            return t;
+    uint64_t h = typeHash(type);
+    auto range = canonicalTypes.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (TypeMap::equivalent(type, it->second))
+            return it->second;
     }
-    searchIn->push_back(type);
+    canonicalTypes.emplace(h, type);
     return type;
 }
 
@@ -17,10 +17,18 @@ limitations under the License.
 #ifndef _FRONTENDS_P4_TYPEMAP_H_
 #define _FRONTENDS_P4_TYPEMAP_H_
 
+#include <cstdint>
+#include <unordered_map>
+
 #include "ir/ir.h"
+#include "ir/pass_manager.h"
+#include "lib/ordered_flat_map.h"
 #include "frontends/common/programMap.h"
 #include "frontends/p4/typeChecking/typeSubstitution.h"
 
+class JSONGenerator;
+class JSONLoader;
+
 namespace P4 {
 /**
 Maps nodes to their canonical types.
@@ -37,16 +45,18 @@ Objects that have a type in the map:
 - error (pointing to the error type)
 - type declarations - map name to the actual type
 */
-class TypeMap final : public ProgramMap {
+class TypeMap final : public ProgramMap, public ICheckpointable {
  protected:
     // We want to have the same canonical type for two
     // different tuples, lists, or stacks with the same signature.
-    std::vector<const IR::Type*> canonicalTuples;
-    std::vector<const IR::Type*> canonicalStacks;
-    std::vector<const IR::Type*> canonicalLists;
+    // Interned canonical types, keyed by structural hash; candidates within
+    // a bucket are compared with equivalent().
+    std::unordered_multimap<uint64_t, const IR::Type*> canonicalTypes;
+    // Memoized structural hashes; safe because IR nodes are immutable.
+    std::unordered_map<const IR::Type*, uint64_t> typeHashCache;
 
     // Map each node to its canonical type
-    std::map<const IR::Node*, const IR::Type*> typeMap;
+    ordered_flat_map<const IR::Node*, const IR::Type*> typeMap;
     // All left-values in the program.
     std::set<const IR::Expression*> leftValues;
     // All compile-time constants.  A compile-time constant
@@ -76,6 +86,25 @@ class TypeMap final : public ProgramMap {
     size_t size() const
     { return typeMap.size(); }
 
+    /// Copies into this map all entries of @p other that it does not
+    /// already have.  Used by parallel type inference to fold the
+    /// thread-local maps back into the shared one; @p other must have
+    /// started as a copy of this map.
+    void merge(const TypeMap* other);
+
+    /// Snapshot for PassManager::checkpoint: the returned closure restores
+    /// the map's current contents.
+    std::function<void()> checkpoint() override;
+
+    /// Serialize the map contents through @p json.  Entries for nodes that
+    /// @p json has already written (normally the whole program) come out as
+    /// id references; synthesized types are written in full.  Part of the
+    /// analysis snapshot carried by binary IR dumps.
+    void toJSON(JSONGenerator& json) const;
+    /// Repopulate from @p loader, which must share node references with the
+    /// loader that produced the program this map describes.
+    void loadFromJSON(JSONLoader& loader);
+
     void setLeftValue(const IR::Expression* expression);
     void cloneExpressionProperties(const IR::Expression* to,
                                    const IR::Expression* from);
@@ -94,6 +123,9 @@ class TypeMap final : public ProgramMap {
 
     // Used for tuples and stacks only
     const IR::Type* getCanonical(const IR::Type* type);
+    /// Structural hash of @type, consistent with equivalent(): equivalent
+    /// types always have equal hashes.  Hashes are memoized per type node.
+    uint64_t typeHash(const IR::Type* type);
     /// The minimum width in bits of this type.  If the width is not
     /// well-defined this will report an error and return -1.
     int minWidthBits(const IR::Type* type, const IR::Node* errorPosition);
@@ -99,6 +99,22 @@ UniqueParameters::UniqueParameters(ReferenceMap* refMap, TypeMap* typeMap) :
     passes.emplace_back(new ClearTypeMap(typeMap));
 }
 
+RenameAll::RenameAll(ReferenceMap* refMap, TypeMap* typeMap) :
+        renameMap(new RenameMap) {
+    setName("RenameAll");
+    CHECK_NULL(refMap); CHECK_NULL(typeMap);
+    passes.emplace_back(new TypeChecking(refMap, typeMap));
+    // FindActionCalls must run before FindParameters, which consults the
+    // action-in-table information it collects.  FindSymbols runs before
+    // FindParameters so the allocated names match the former
+    // UniqueNames-then-UniqueParameters sequence.
+    passes.emplace_back(new FindActionCalls(refMap, typeMap, renameMap));
+    passes.emplace_back(new FindSymbols(refMap, renameMap));
+    passes.emplace_back(new FindParameters(refMap, renameMap));
+    passes.emplace_back(new RenameSymbols(refMap, renameMap));
+    passes.emplace_back(new ClearTypeMap(typeMap));
+}
+
 /**************************************************************************/
 
 IR::ID* RenameSymbols::getName() const {
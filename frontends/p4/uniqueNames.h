@@ -148,6 +148,21 @@ class UniqueParameters : public PassManager {
     UniqueParameters(ReferenceMap* refMap, TypeMap* typeMap);
 };
 
+/// Single-traversal renaming engine: accumulates the rename requests of
+/// UniqueNames (FindSymbols) and UniqueParameters (FindActionCalls,
+/// FindParameters) in one shared RenameMap and applies all of them in a
+/// single RenameSymbols traversal.  The finding policies run on the same
+/// program version and share the used-name index of @refMap, so the
+/// names they allocate cannot collide.  Equivalent to running
+/// UniqueNames followed by UniqueParameters, minus one whole-program
+/// rename and one reference resolution.
+class RenameAll : public PassManager {
+ private:
+    RenameMap    *renameMap;
+ public:
+    RenameAll(ReferenceMap* refMap, TypeMap* typeMap);
+};
+
 }  // namespace P4
 
 #endif /* _FRONTENDS_P4_UNIQUENAMES_H_ */
@@ -19,6 +19,96 @@ limitations under the License.
 
 namespace P4 {
 
+Visitor::profile_t ComputeUsedDeclarations::init_apply(const IR::Node* node) {
+    refCount.clear();
+    references.clear();
+    return Inspector::init_apply(node);
+}
+
+bool ComputeUsedDeclarations::removable(const IR::Node* node, const IR::Node* parent) const {
+    // Must mirror what RemoveUnusedDeclarations can actually delete:
+    // references inside any other node survive the cleanup, so they must
+    // never be subtracted from the counts.
+    if (!node->is<IR::IDeclaration>())
+        return false;
+    if (auto state = node->to<IR::ParserState>())
+        return state->name != IR::ParserState::accept &&
+               state->name != IR::ParserState::reject &&
+               state->name != IR::ParserState::start;
+    if (auto decl = node->to<IR::Declaration_Instance>()) {
+        if (decl->getName().name == IR::P4Program::main &&
+            parent != nullptr && parent->is<IR::P4Program>())
+            return false;
+        // Extern instances are never removed.
+        auto type = decl->type;
+        if (type->is<IR::Type_Specialized>())
+            type = type->to<IR::Type_Specialized>()->baseType;
+        if (type->is<IR::Type_Name>())
+            type = refMap->getDeclaration(type->to<IR::Type_Name>()->path, true)->to<IR::Type>();
+        return !type->is<IR::Type_Extern>();
+    }
+    if (auto decl = node->to<IR::Declaration_Variable>())
+        return decl->initializer == nullptr ||
+               !SideEffects::check(decl->initializer, nullptr, nullptr);
+    // Declarations kept even when unreferenced, and the declarations
+    // nested inside them, which the transform prunes past.
+    if (node->is<IR::Parameter>() || node->is<IR::NamedExpression>() ||
+        node->is<IR::StructField>() || node->is<IR::Method>() ||
+        node->is<IR::Type_Var>() || node->is<IR::Declaration_ID>() ||
+        node->is<IR::Type_Error>() || node->is<IR::Declaration_MatchKind>() ||
+        node->is<IR::Type_StructLike>() || node->is<IR::Type_Extern>() ||
+        node->is<IR::Type_Method>())
+        return false;
+    if (node->to<IR::IDeclaration>()->getName().name == IR::ParserState::verify &&
+        parent != nullptr && parent->is<IR::P4Program>())
+        return false;
+    return node->is<IR::Declaration>() || node->is<IR::Type_Declaration>();
+}
+
+const IR::IDeclaration* ComputeUsedDeclarations::enclosingRemovable() const {
+    for (auto c = getContext(); c != nullptr; c = c->parent) {
+        if (removable(c->node, c->parent != nullptr ? c->parent->node : nullptr))
+            return c->node->to<IR::IDeclaration>();
+    }
+    return nullptr;
+}
+
+void ComputeUsedDeclarations::addReference(const IR::IDeclaration* target) {
+    if (target == nullptr)
+        return;
+    refCount[target]++;
+    if (auto scope = enclosingRemovable())
+        references[scope].push_back(target);
+}
+
+void ComputeUsedDeclarations::postorder(const IR::Path* path) {
+    addReference(refMap->getDeclaration(path));
+}
+
+void ComputeUsedDeclarations::postorder(const IR::This* pointer) {
+    addReference(refMap->getDeclaration(pointer));
+}
+
+void ComputeUsedDeclarations::end_apply(const IR::Node*) {
+    // Cascade: subtracting the references held by a dead declaration may
+    // zero out further counts.  Each reference was recorded under exactly
+    // one scope, so counts can never go negative and each declaration
+    // enters the worklist at most once.
+    std::vector<const IR::IDeclaration*> worklist;
+    for (auto& scope : references)
+        if (::get(refCount, scope.first, 0) == 0)
+            worklist.push_back(scope.first);
+    while (!worklist.empty()) {
+        auto dead = worklist.back();
+        worklist.pop_back();
+        LOG3("Subtracting references held by dead " << dbp(dead->getNode()));
+        for (auto target : references[dead]) {
+            if (--refCount[target] == 0 && references.count(target) != 0)
+                worklist.push_back(target);
+        }
+    }
+}
+
 Visitor::profile_t RemoveUnusedDeclarations::init_apply(const IR::Node* node) {
     LOG4("Reference map " << refMap);
     return Transform::init_apply(node);
@@ -38,7 +128,7 @@ bool RemoveUnusedDeclarations::giveWarning(const IR::Node* node) {
 
 const IR::Node* RemoveUnusedDeclarations::preorder(IR::Type_Enum* type) {
     prune();  // never remove individual enum members
-    if (!refMap->isUsed(getOriginal<IR::Type_Enum>())) {
+    if (!isUsed(getOriginal<IR::Type_Enum>())) {
         LOG3("Removing " << type);
         return nullptr;
     }
@@ -47,7 +137,7 @@ const IR::Node* RemoveUnusedDeclarations::preorder(IR::Type_Enum* type) {
 
 const IR::Node* RemoveUnusedDeclarations::preorder(IR::Type_SerEnum* type) {
     prune();  // never remove individual enum members
-    if (!refMap->isUsed(getOriginal<IR::Type_SerEnum>())) {
+    if (!isUsed(getOriginal<IR::Type_SerEnum>())) {
         LOG3("Removing " << type);
         return nullptr;
     }
@@ -55,7 +145,7 @@ const IR::Node* RemoveUnusedDeclarations::preorder(IR::Type_SerEnum* type) {
 }
 
 const IR::Node* RemoveUnusedDeclarations::preorder(IR::P4Control* cont) {
-    if (!refMap->isUsed(getOriginal<IR::IDeclaration>())) {
+    if (!isUsed(getOriginal<IR::IDeclaration>())) {
         LOG3("Removing " << cont);
         prune();
         return nullptr;
@@ -68,7 +158,7 @@ const IR::Node* RemoveUnusedDeclarations::preorder(IR::P4Control* cont) {
 }
 
 const IR::Node* RemoveUnusedDeclarations::preorder(IR::P4Parser* cont) {
-    if (!refMap->isUsed(getOriginal<IR::IDeclaration>())) {
+    if (!isUsed(getOriginal<IR::IDeclaration>())) {
         LOG3("Removing " << cont);
         prune();
         return nullptr;
@@ -81,7 +171,7 @@ const IR::Node* RemoveUnusedDeclarations::preorder(IR::P4Parser* cont) {
 }
 
 const IR::Node* RemoveUnusedDeclarations::preorder(IR::P4Table* table) {
-    if (!refMap->isUsed(getOriginal<IR::IDeclaration>())) {
+    if (!isUsed(getOriginal<IR::IDeclaration>())) {
         if (giveWarning(getOriginal()))
             ::warning(ErrorType::WARN_UNUSED, "Table %1% is not used; removing", table);
         LOG3("Removing " << table);
@@ -104,7 +194,7 @@ const IR::Node* RemoveUnusedDeclarations::process(const IR::IDeclaration* decl)
     LOG3("Visiting " << decl);
     if (decl->getName().name == IR::ParserState::verify && getParent<IR::P4Program>())
         return decl->getNode();
-    if (refMap->isUsed(getOriginal<IR::IDeclaration>()))
+    if (isUsed(getOriginal<IR::IDeclaration>()))
         return decl->getNode();
     LOG3("Removing " << getOriginal());
     prune();  // no need to go deeper
@@ -115,7 +205,7 @@ const IR::Node* RemoveUnusedDeclarations::preorder(IR::Declaration_Instance* dec
     // Don't delete instances; they may have consequences on the control-plane API
     if (decl->getName().name == IR::P4Program::main && getParent<IR::P4Program>())
         return decl;
-    if (!refMap->isUsed(getOriginal<IR::Declaration_Instance>())) {
+    if (!isUsed(getOriginal<IR::Declaration_Instance>())) {
         if (giveWarning(getOriginal()))
             ::warning(ErrorType::WARN_UNUSED, "%1%: unused instance", decl);
         // We won't delete extern instances; these may be useful even if not references.
@@ -140,7 +230,7 @@ const IR::Node* RemoveUnusedDeclarations::preorder(IR::ParserState* state) {
         state->name == IR::ParserState::start)
         return state;
 
-    if (refMap->isUsed(getOriginal<IR::ParserState>()))
+    if (isUsed(getOriginal<IR::ParserState>()))
         return state;
     LOG3("Removing " << state);
     prune();
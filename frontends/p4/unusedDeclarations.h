@@ -18,10 +18,64 @@ limitations under the License.
 #define _P4_UNUSEDDECLARATIONS_H_
 
 #include "ir/ir.h"
+#include "lib/ordered_flat_map.h"
 #include "../common/resolveReferences/resolveReferences.h"
 
 namespace P4 {
 
+/** @brief Computes in a single traversal which declarations survive the
+ * removal of all unused declarations, including cascades.
+ *
+ * A declaration with no references is dead, but deleting it also deletes
+ * the references it contains, which may leave further declarations
+ * unreferenced.  Instead of re-resolving and re-scanning the whole program
+ * until a fixed point is reached, this pass counts the references to every
+ * declaration, remembers inside which *removable* declaration each
+ * reference occurs, and then drains a worklist: when a declaration's count
+ * drops to zero the references it contains are subtracted, which may zero
+ * out more counts.  References that occur inside nodes that are never
+ * removed (struct fields, extern methods, parameters, "main", ...) are
+ * never subtracted.
+ *
+ * The result is the fixed point that iterating
+ * { ResolveReferences, RemoveUnusedDeclarations } would reach; in
+ * particular declarations that only reference each other in a cycle keep
+ * nonzero counts and stay, exactly as the iteration would leave them.
+ *
+ * @pre Requires an up-to-date ReferenceMap.
+ */
+class ComputeUsedDeclarations : public Inspector {
+    const ReferenceMap* refMap;
+    /// Number of references to each declaration; end_apply subtracts the
+    /// references located inside dead declarations.
+    ordered_flat_map<const IR::IDeclaration*, int> refCount;
+    /// For each removable declaration, the declarations referenced from
+    /// within it; one entry per reference so counts can be subtracted.
+    ordered_flat_map<const IR::IDeclaration*, std::vector<const IR::IDeclaration*>> references;
+
+    bool removable(const IR::Node* node, const IR::Node* parent) const;
+    const IR::IDeclaration* enclosingRemovable() const;
+    void addReference(const IR::IDeclaration* target);
+
+ public:
+    explicit ComputeUsedDeclarations(const ReferenceMap* refMap) : refMap(refMap) {
+        CHECK_NULL(refMap); setName("ComputeUsedDeclarations");
+        // Subtrees can be shared; each occurrence of a reference must be
+        // counted in the scope it occurs in for subtraction to be exact.
+        visitDagOnce = false;
+    }
+
+    /// True if @decl is still referenced after all dead declarations have
+    /// been removed.
+    bool isUsed(const IR::IDeclaration* decl) const
+    { return ::get(refCount, decl, 0) > 0; }
+
+    profile_t init_apply(const IR::Node* node) override;
+    void end_apply(const IR::Node* node) override;
+    void postorder(const IR::Path* path) override;
+    void postorder(const IR::This* pointer) override;
+};
+
 /** @brief Removes unused declarations.
  *
  * The following kinds of nodes are not removed even if they are unreferenced:
@@ -46,6 +100,11 @@ namespace P4 {
 class RemoveUnusedDeclarations : public Transform {
     const ReferenceMap* refMap;
 
+    /// If not null, usage computed up front including cascades; a single
+    /// application then reaches the fixed point.  If null, the reference
+    /// map is consulted directly and the pass must be iterated.
+    const ComputeUsedDeclarations* usage;
+
     /** If not null, logs the following unused elements in @warn:
      *  - unused IR::P4Table nodes
      *  - unused IR::Declaration_Instance nodes
@@ -61,11 +120,14 @@ class RemoveUnusedDeclarations : public Transform {
      */
     bool giveWarning(const IR::Node* node);
     const IR::Node* process(const IR::IDeclaration* decl);
+    bool isUsed(const IR::IDeclaration* decl) const
+    { return usage != nullptr ? usage->isUsed(decl) : refMap->isUsed(decl); }
 
  public:
     explicit RemoveUnusedDeclarations(const ReferenceMap* refMap,
-                                      std::set<const IR::Node*>* warned = nullptr) :
-            refMap(refMap), warned(warned)
+                                      std::set<const IR::Node*>* warned = nullptr,
+                                      const ComputeUsedDeclarations* usage = nullptr) :
+            refMap(refMap), usage(usage), warned(warned)
     { CHECK_NULL(refMap); setName("RemoveUnusedDeclarations"); }
 
     using Transform::postorder;
@@ -103,7 +165,7 @@ class RemoveUnusedDeclarations : public Transform {
     const IR::Node* preorder(IR::Type_Declaration* decl) override { return process(decl); }
 };
 
-/** @brief Iterates RemoveUnusedDeclarations until convergence.
+/** @brief Removes all unused declarations, including cascades.
  *
  * If @warn is true, emit compiler warnings if an unused instance of an
  * IR::P4Table or IR::Declaration_Instance is removed.
@@ -114,17 +176,23 @@ class RemoveAllUnusedDeclarations : public PassManager {
         CHECK_NULL(refMap);
 
         // Unused extern instances are not removed but may still trigger
-        // warnings.  The @warned set keeps track of warnings emitted in
-        // previous iterations to avoid emitting duplicate warnings.
+        // warnings.  The @warned set keeps track of warnings already
+        // emitted to avoid emitting duplicates.
         std::set<const IR::Node*> *warned = nullptr;
         if (warn)
             warned = new std::set<const IR::Node*>();
 
-        passes.emplace_back(
-            new PassRepeated {
-                new ResolveReferences(refMap),
-                new RemoveUnusedDeclarations(refMap, warned)
-             });
+        // ComputeUsedDeclarations already accounts for declarations that
+        // only become unused once their last users are removed, so a
+        // single application of RemoveUnusedDeclarations reaches the
+        // fixed point that iterating it used to converge to.
+        auto usage = new ComputeUsedDeclarations(refMap);
+        passes.emplace_back(new ResolveReferences(refMap));
+        passes.emplace_back(usage);
+        passes.emplace_back(new RemoveUnusedDeclarations(refMap, warned, usage));
+        // Leave the map describing the program we emit, as the final
+        // iteration used to.
+        passes.emplace_back(new ResolveReferences(refMap));
         setName("RemoveAllUnusedDeclarations");
         setStopOnError(true);
     }
@@ -15,7 +15,7 @@ using Parser = P4::P4Parser;
 
 #define makeToken(symbol) \
     Parser::make_ ## symbol( \
-        P4::Token(Parser::token::TOK_ ## symbol, yytext), \
+        P4::Token(Parser::token::TOK_ ## symbol, driver.internToken(yytext, yyleng)), \
         driver.yylloc)
 
 // Silence the warnings triggered by the code flex generates.
@@ -192,7 +192,7 @@ using Parser = P4::P4Parser;
 [A-Za-z_][A-Za-z0-9_]* {
                   BEGIN(driver.saveState);
                   driver.template_args = false;
-                  cstring name = yytext;
+                  cstring name = driver.internToken(yytext, yyleng);
                   Util::ProgramStructure::SymbolKind kind =
                       driver.structure->lookupIdentifier(name);
                   switch (kind)
@@ -1,8 +1,5 @@
 #include "parserDriver.h"
 
-#include <boost/algorithm/string/predicate.hpp>
-#include <boost/format.hpp>
-
 #include <cerrno>
 #include <cstdio>
 #include <iostream>
@@ -16,6 +13,7 @@
 #include "frontends/parsers/v1/v1lexer.hpp"
 #include "frontends/parsers/v1/v1parser.hpp"
 #include "lib/error.h"
+#include "lib/hash.h"
 
 
 #ifdef HAVE_LIBBOOST_IOSTREAMS
@@ -80,6 +78,19 @@ void AbstractParserDriver::onReadToken(const char* text) {
     yylloc = Util::SourceInfo(sources, posBeforeToken, posAfterToken);
 }
 
+cstring AbstractParserDriver::internToken(const char* text, size_t length) {
+    size_t h = Util::Hash::hash(text, length);
+    auto it = tokenCache.find(h);
+    if (it != tokenCache.end()) {
+        cstring cached = it->second;
+        if (cached.size() == length && memcmp(cached.c_str(), text, length) == 0)
+            return cached;
+    }
+    cstring result(text, length);
+    tokenCache[h] = result;
+    return result;
+}
+
 void AbstractParserDriver::onReadLineNumber(const char* text) {
     char* last;
     errno = 0;
@@ -93,8 +104,11 @@ void AbstractParserDriver::onReadLineNumber(const char* text) {
     }
 }
 
-void AbstractParserDriver::onReadComment(const char* text, bool lineComment) {
-    sources->addComment(yylloc, lineComment, text);
+void AbstractParserDriver::onReadComment(const char* /*text*/, bool lineComment) {
+    // The comment text is not copied: the Comment is a span of the program
+    // text the sources store anyway, and capture is off entirely unless a
+    // pretty-printing flow asked for it.
+    sources->addComment(yylloc, lineComment);
 }
 
 void AbstractParserDriver::onReadFileName(const char* text) {
@@ -106,15 +120,33 @@ void AbstractParserDriver::onReadIdentifier(cstring id) {
     lastIdentifier = id;
 }
 
+void AbstractParserDriver::onReadAnnotation(const IR::Annotation* annotation) {
+    optionPragmas.push_back(annotation);
+}
+
+const IR::Node* AbstractParserDriver::boundPragmaProgram = nullptr;
+const IR::Vector<IR::Annotation>* AbstractParserDriver::boundPragmaList = nullptr;
+
+void AbstractParserDriver::bindOptionPragmas(const IR::Node* program,
+                                             const IR::Vector<IR::Annotation>* pragmas) {
+    boundPragmaProgram = program;
+    boundPragmaList = pragmas;
+}
+
+const IR::Vector<IR::Annotation>*
+AbstractParserDriver::optionPragmasFor(const IR::Node* program) {
+    if (program == nullptr || program != boundPragmaProgram) return nullptr;
+    return boundPragmaList;
+}
+
 void AbstractParserDriver::onParseError(const Util::SourceInfo& location,
                                         const std::string& message) {
     static const std::string unexpectedIdentifierError =
         "syntax error, unexpected IDENTIFIER";
     auto& context = BaseCompileContext::get();
-    if (boost::equal(message, unexpectedIdentifierError)) {
-        context.errorReporter().parser_error(location, boost::format("%s \"%s\"") %
-                                                       unexpectedIdentifierError %
-                                                       lastIdentifier);
+    if (message == unexpectedIdentifierError) {
+        context.errorReporter().parser_error(location, unexpectedIdentifierError +
+                                                       " \"" + lastIdentifier + "\"");
     } else {
         context.errorReporter().parser_error(location, message);
     }
@@ -154,7 +186,9 @@ P4ParserDriver::parse(std::istream& in, const char* sourceFile,
     P4ParserDriver driver;
     P4Lexer lexer(in);
     if (!driver.parse(lexer, sourceFile, sourceLine)) return nullptr;
-    return new IR::P4Program(driver.nodes->srcInfo, *driver.nodes);
+    auto* program = new IR::P4Program(driver.nodes->srcInfo, *driver.nodes);
+    bindOptionPragmas(program, new IR::Vector<IR::Annotation>(driver.optionPragmas));
+    return program;
 }
 
 /* static */ const IR::P4Program*
@@ -164,6 +198,24 @@ P4ParserDriver::parse(FILE* in, const char* sourceFile,
     return parse(inputStream.get(), sourceFile, sourceLine);
 }
 
+/* static */ const IR::P4Program*
+P4ParserDriver::parse(std::istream& in, const char* sourceFile, unsigned sourceLine,
+                      const std::vector<std::pair<cstring, bool>>& predeclaredTypes) {
+    LOG1("Parsing P4-16 program fragment " << sourceFile);
+
+    P4ParserDriver driver;
+    for (auto& type : predeclaredTypes) {
+        driver.structure->declareType(IR::ID(type.first));
+        if (type.second)
+            driver.structure->markAsTemplate(IR::ID(type.first));
+    }
+    P4Lexer lexer(in);
+    if (!driver.parse(lexer, sourceFile, sourceLine)) return nullptr;
+    auto* program = new IR::P4Program(driver.nodes->srcInfo, *driver.nodes);
+    bindOptionPragmas(program, new IR::Vector<IR::Annotation>(driver.optionPragmas));
+    return program;
+}
+
 template<typename T> const T*
 P4ParserDriver::parse(P4AnnotationLexer::Type type,
                       const Util::SourceInfo& srcInfo,
@@ -344,6 +396,8 @@ V1ParserDriver::parse(std::istream& in, const char* sourceFile,
 
     // Parse.
     if (parser.parse() != 0) return nullptr;
+    bindOptionPragmas(driver.global,
+                      new IR::Vector<IR::Annotation>(driver.optionPragmas));
     return driver.global;
 }
 
@@ -373,8 +427,10 @@ void V1ParserDriver::clearPragmas() {
 }
 
 void V1ParserDriver::addPragma(IR::Annotation* pragma) {
-    if (!P4CContext::get().options().isAnnotationDisabled(pragma))
+    if (!P4CContext::get().options().isAnnotationDisabled(pragma)) {
         currentPragmas.push_back(pragma);
+        onReadAnnotation(pragma);
+    }
 }
 
 IR::Vector<IR::Annotation> V1ParserDriver::takePragmasAsVector() {
@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 
 #include "frontends/p4/symbol_table.h"
 #include "frontends/parsers/p4/abstractP4Lexer.hpp"
@@ -39,6 +40,18 @@ class AbstractParserDriver {
  public:
     virtual ~AbstractParserDriver() = 0;
 
+    /// Record that @pragmas is the list of annotations collected while
+    /// parsing @program, in program order.  Only the most recent parse is
+    /// remembered; earlier bindings are forgotten.
+    static void bindOptionPragmas(const IR::Node* program,
+                                  const IR::Vector<IR::Annotation>* pragmas);
+
+    /// @return the annotations collected while parsing @program, or null if
+    /// @program is not the result of the most recent parse (e.g. it was
+    /// reloaded from a cache or synthesized in memory).  Callers getting null
+    /// must fall back to scanning the program for annotations themselves.
+    static const IR::Vector<IR::Annotation>* optionPragmasFor(const IR::Node* program);
+
  protected:
     AbstractParserDriver();
 
@@ -56,6 +69,12 @@ class AbstractParserDriver {
     /// Notify that the lexer read a token. @text is the matched source text.
     void onReadToken(const char* text);
 
+    /// Intern the token text [@text, @text+@length).  Token spellings repeat
+    /// constantly (`hdr`, `meta`, `apply`, ...), so this goes through a small
+    /// per-driver cache: a hit returns the interned cstring directly and
+    /// skips the shared intern table's hashing and shard lock.
+    cstring internToken(const char* text, size_t length);
+
     /// Notify that the lexer read a line number from a #line directive.
     void onReadLineNumber(const char* text);
 
@@ -65,6 +84,12 @@ class AbstractParserDriver {
     /// Notify that the lexer read an identifier, @id.
     void onReadIdentifier(cstring id);
 
+    /// Notify that the parser constructed the annotation @annotation.  The
+    /// annotations are remembered in program order so that option pragmas
+    /// (e.g. `@diagnostic`) can be consumed right after parsing without
+    /// rediscovering them with a whole-tree traversal.
+    void onReadAnnotation(const IR::Annotation* annotation);
+
     /// Notify that an error was encountered during parsing at @location.
     /// @message is a Bison-provided human-readable explanation of the error.
     void onParseError(const Util::SourceInfo& location,
@@ -84,7 +109,22 @@ class AbstractParserDriver {
     /// Scratch storage for the lexer to remember its previous state.
     int saveState = -1;
 
+    /// The annotations constructed so far by this driver, in program order.
+    /// Published via bindOptionPragmas() by the top-level parse entry points.
+    IR::Vector<IR::Annotation> optionPragmas;
+
  private:
+    /// The program most recently bound with bindOptionPragmas() and its
+    /// annotation list.
+    static const IR::Node* boundPragmaProgram;
+    static const IR::Vector<IR::Annotation>* boundPragmaList;
+
+    /// Token texts already interned by this driver, keyed by content hash.
+    /// On the rare hash collision the colliding spelling simply takes over
+    /// the slot; correctness only depends on the byte comparison in
+    /// internToken.
+    std::unordered_map<size_t, cstring> tokenCache;
+
     /// The line number from the most recent #line directive.
     int lineDirectiveLine = 0;
 
@@ -116,6 +156,19 @@ class P4ParserDriver final : public AbstractParserDriver {
     static const IR::P4Program* parse(FILE* in, const char* sourceFile,
                                       unsigned sourceLine = 1);
 
+    /**
+     * Like parse(), but pre-declares the given type names in the parser's
+     * symbol table before lexing starts, so a program fragment that
+     * references types declared in a precompiled subtree (e.g. the standard
+     * library headers) lexes and parses correctly without their text.  The
+     * bool in each pair is true for generic types, which take template
+     * arguments.
+     */
+    static const IR::P4Program* parse(std::istream& in, const char* sourceFile,
+                                      unsigned sourceLine,
+                                      const std::vector<std::pair<cstring, bool>>&
+                                          predeclaredTypes);
+
     /**
      * Parses a P4-16 annotation body.
      *
@@ -72,187 +72,187 @@ using Parser = V1::V1Parser;
                   return Parser::make_PRAGMA("pragma", driver.yylloc); }
 
 "action"        { BEGIN(driver.saveState);
-                  return Parser::make_ACTION(cstring(yytext), driver.yylloc); }
+                  return Parser::make_ACTION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "actions"       { BEGIN(driver.saveState);
-                  return Parser::make_ACTIONS(cstring(yytext), driver.yylloc); }
+                  return Parser::make_ACTIONS(driver.internToken(yytext, yyleng), driver.yylloc); }
 "action_profile" {BEGIN(driver.saveState);
-                  return Parser::make_ACTION_PROFILE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_ACTION_PROFILE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "action_selector" { BEGIN(driver.saveState);
-                    return Parser::make_ACTION_SELECTOR(cstring(yytext), driver.yylloc); }
+                    return Parser::make_ACTION_SELECTOR(driver.internToken(yytext, yyleng), driver.yylloc); }
 "algorithm"     { BEGIN(driver.saveState);
-                  return Parser::make_ALGORITHM(cstring(yytext), driver.yylloc); }
+                  return Parser::make_ALGORITHM(driver.internToken(yytext, yyleng), driver.yylloc); }
 "and"           { BEGIN(driver.saveState);
                   return Parser::make_AND(driver.yylloc); }
 "apply"         { BEGIN(driver.saveState);
-                  return Parser::make_APPLY(cstring(yytext), driver.yylloc); }
+                  return Parser::make_APPLY(driver.internToken(yytext, yyleng), driver.yylloc); }
 "attribute"     { BEGIN(driver.saveState);
-                  return Parser::make_ATTRIBUTE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_ATTRIBUTE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "attributes"    { BEGIN(driver.saveState);
-                  return Parser::make_ATTRIBUTES(cstring(yytext), driver.yylloc); }
+                  return Parser::make_ATTRIBUTES(driver.internToken(yytext, yyleng), driver.yylloc); }
 "bit"           { BEGIN(driver.saveState);
-                  return Parser::make_BIT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_BIT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "bool"          { BEGIN(driver.saveState);
-                  return Parser::make_BOOL(cstring(yytext), driver.yylloc); }
+                  return Parser::make_BOOL(driver.internToken(yytext, yyleng), driver.yylloc); }
 "blackbox"      { BEGIN(driver.saveState);
-                  return Parser::make_BLACKBOX(cstring(yytext), driver.yylloc); }
+                  return Parser::make_BLACKBOX(driver.internToken(yytext, yyleng), driver.yylloc); }
 "blackbox_type" { BEGIN(driver.saveState);
-                  return Parser::make_BLACKBOX_TYPE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_BLACKBOX_TYPE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "block"         { BEGIN(driver.saveState);
-                  return Parser::make_BLOCK(cstring(yytext), driver.yylloc); }
+                  return Parser::make_BLOCK(driver.internToken(yytext, yyleng), driver.yylloc); }
 "calculated_field" { BEGIN(driver.saveState);
-                     return Parser::make_CALCULATED_FIELD(cstring(yytext), driver.yylloc); }
+                     return Parser::make_CALCULATED_FIELD(driver.internToken(yytext, yyleng), driver.yylloc); }
 "control"       { BEGIN(driver.saveState);
-                  return Parser::make_CONTROL(cstring(yytext), driver.yylloc); }
+                  return Parser::make_CONTROL(driver.internToken(yytext, yyleng), driver.yylloc); }
 "counter"       { BEGIN(driver.saveState);
-                  return Parser::make_COUNTER(cstring(yytext), driver.yylloc); }
+                  return Parser::make_COUNTER(driver.internToken(yytext, yyleng), driver.yylloc); }
 "current"       { BEGIN(driver.saveState);
-                  return Parser::make_CURRENT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_CURRENT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "default"       { BEGIN(driver.saveState);
-                  return Parser::make_DEFAULT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_DEFAULT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "default_action" {BEGIN(driver.saveState);
-                  return Parser::make_DEFAULT_ACTION(cstring(yytext), driver.yylloc); }
+                  return Parser::make_DEFAULT_ACTION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "const"         {BEGIN(driver.saveState);
-                  return Parser::make_CONST(cstring(yytext), driver.yylloc); }
+                  return Parser::make_CONST(driver.internToken(yytext, yyleng), driver.yylloc); }
 "direct"        { BEGIN(driver.saveState);
-                  return Parser::make_DIRECT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_DIRECT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "drop"          { BEGIN(driver.saveState);
-                  return Parser::make_DROP(cstring(yytext), driver.yylloc); }
+                  return Parser::make_DROP(driver.internToken(yytext, yyleng), driver.yylloc); }
 "dynamic_action_selection" {
                   BEGIN(driver.saveState);
-                  return Parser::make_DYNAMIC_ACTION_SELECTION(cstring(yytext), driver.yylloc); }
+                  return Parser::make_DYNAMIC_ACTION_SELECTION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "else"          { BEGIN(driver.saveState);
-                  return Parser::make_ELSE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_ELSE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "extern"        { BEGIN(driver.saveState);
-                  return Parser::make_BLACKBOX(cstring(yytext), driver.yylloc); }
+                  return Parser::make_BLACKBOX(driver.internToken(yytext, yyleng), driver.yylloc); }
 "extern_type"   { BEGIN(driver.saveState);
-                  return Parser::make_BLACKBOX_TYPE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_BLACKBOX_TYPE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "expression"    { BEGIN(driver.saveState);
-                  return Parser::make_EXPRESSION(cstring(yytext), driver.yylloc); }
+                  return Parser::make_EXPRESSION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "expression_local_variables" {
                   BEGIN(driver.saveState);
-                  return Parser::make_EXPRESSION_LOCAL_VARIABLES(cstring(yytext), driver.yylloc); }
+                  return Parser::make_EXPRESSION_LOCAL_VARIABLES(driver.internToken(yytext, yyleng), driver.yylloc); }
 "extract"       { BEGIN(driver.saveState);
-                  return Parser::make_EXTRACT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_EXTRACT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "false"         { BEGIN(driver.saveState);
-                  return Parser::make_FALSE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_FALSE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "field_list"    { BEGIN(driver.saveState);
-                  return Parser::make_FIELD_LIST(cstring(yytext), driver.yylloc); }
+                  return Parser::make_FIELD_LIST(driver.internToken(yytext, yyleng), driver.yylloc); }
 "field_list_calculation" {
                   BEGIN(driver.saveState);
-                  return Parser::make_FIELD_LIST_CALCULATION(cstring(yytext), driver.yylloc); }
+                  return Parser::make_FIELD_LIST_CALCULATION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "fields"        { BEGIN(driver.saveState);
-                  return Parser::make_FIELDS(cstring(yytext), driver.yylloc); }
+                  return Parser::make_FIELDS(driver.internToken(yytext, yyleng), driver.yylloc); }
 "header"        { BEGIN(driver.saveState);
-                  return Parser::make_HEADER(cstring(yytext), driver.yylloc); }
+                  return Parser::make_HEADER(driver.internToken(yytext, yyleng), driver.yylloc); }
 "header_type"   { BEGIN(driver.saveState);
-                  return Parser::make_HEADER_TYPE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_HEADER_TYPE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "if"            { BEGIN(driver.saveState);
-                  return Parser::make_IF(cstring(yytext), driver.yylloc); }
+                  return Parser::make_IF(driver.internToken(yytext, yyleng), driver.yylloc); }
 "implementation" {BEGIN(driver.saveState);
-                  return Parser::make_IMPLEMENTATION(cstring(yytext), driver.yylloc); }
+                  return Parser::make_IMPLEMENTATION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "input"         { BEGIN(driver.saveState);
-                  return Parser::make_INPUT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_INPUT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "instance_count" {BEGIN(driver.saveState);
-                  return Parser::make_INSTANCE_COUNT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_INSTANCE_COUNT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "in"            { BEGIN(driver.saveState);
-                  return Parser::make_IN(cstring(yytext), driver.yylloc); }
+                  return Parser::make_IN(driver.internToken(yytext, yyleng), driver.yylloc); }
 "int"           { BEGIN(driver.saveState);
-                  return Parser::make_INT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_INT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "latest"        { BEGIN(driver.saveState);
-                  return Parser::make_LATEST(cstring(yytext), driver.yylloc); }
+                  return Parser::make_LATEST(driver.internToken(yytext, yyleng), driver.yylloc); }
 "layout"        { BEGIN(driver.saveState);
-                  return Parser::make_LAYOUT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_LAYOUT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "length"        { BEGIN(driver.saveState);
-                  return Parser::make_LENGTH(cstring(yytext), driver.yylloc); }
+                  return Parser::make_LENGTH(driver.internToken(yytext, yyleng), driver.yylloc); }
 "mask"          { BEGIN(driver.saveState);
-                  return Parser::make_MASK(cstring(yytext), driver.yylloc); }
+                  return Parser::make_MASK(driver.internToken(yytext, yyleng), driver.yylloc); }
 "max_length"    { BEGIN(driver.saveState);
-                  return Parser::make_MAX_LENGTH(cstring(yytext), driver.yylloc); }
+                  return Parser::make_MAX_LENGTH(driver.internToken(yytext, yyleng), driver.yylloc); }
 "max_size"      { BEGIN(driver.saveState);
-                  return Parser::make_MAX_SIZE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_MAX_SIZE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "max_width"     { BEGIN(driver.saveState);
-                  return Parser::make_MAX_WIDTH(cstring(yytext), driver.yylloc); }
+                  return Parser::make_MAX_WIDTH(driver.internToken(yytext, yyleng), driver.yylloc); }
 "metadata"      { BEGIN(driver.saveState);
-                  return Parser::make_METADATA(cstring(yytext), driver.yylloc); }
+                  return Parser::make_METADATA(driver.internToken(yytext, yyleng), driver.yylloc); }
 "meter"         { BEGIN(driver.saveState);
-                  return Parser::make_METER(cstring(yytext), driver.yylloc); }
+                  return Parser::make_METER(driver.internToken(yytext, yyleng), driver.yylloc); }
 "method"        { BEGIN(driver.saveState);
-                  return Parser::make_METHOD(cstring(yytext), driver.yylloc); }
+                  return Parser::make_METHOD(driver.internToken(yytext, yyleng), driver.yylloc); }
 "min_size"      { BEGIN(driver.saveState);
-                  return Parser::make_MIN_SIZE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_MIN_SIZE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "min_width"     { BEGIN(driver.saveState);
-                  return Parser::make_MIN_WIDTH(cstring(yytext), driver.yylloc); }
+                  return Parser::make_MIN_WIDTH(driver.internToken(yytext, yyleng), driver.yylloc); }
 "not"           { BEGIN(driver.saveState);
                   return Parser::make_NOT(driver.yylloc); }
 "or"            { BEGIN(driver.saveState);
                   return Parser::make_OR(driver.yylloc); }
 "optional"      { BEGIN(driver.saveState);
-                  return Parser::make_OPTIONAL(cstring(yytext), driver.yylloc); }
+                  return Parser::make_OPTIONAL(driver.internToken(yytext, yyleng), driver.yylloc); }
 "out"           { BEGIN(driver.saveState);
-                  return Parser::make_OUT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_OUT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "output_width"  { BEGIN(driver.saveState);
-                  return Parser::make_OUTPUT_WIDTH(cstring(yytext), driver.yylloc); }
+                  return Parser::make_OUTPUT_WIDTH(driver.internToken(yytext, yyleng), driver.yylloc); }
 "parse_error"   { BEGIN(driver.saveState);
-                  return Parser::make_PARSE_ERROR(cstring(yytext), driver.yylloc); }
+                  return Parser::make_PARSE_ERROR(driver.internToken(yytext, yyleng), driver.yylloc); }
 "parser"        { BEGIN(driver.saveState);
-                  return Parser::make_PARSER(cstring(yytext), driver.yylloc); }
+                  return Parser::make_PARSER(driver.internToken(yytext, yyleng), driver.yylloc); }
 "parser_value_set" { BEGIN(driver.saveState);
-                     return Parser::make_PARSER_VALUE_SET(cstring(yytext), driver.yylloc); }
+                     return Parser::make_PARSER_VALUE_SET(driver.internToken(yytext, yyleng), driver.yylloc); }
 "parser_exception" { BEGIN(driver.saveState);
-                     return Parser::make_PARSER_EXCEPTION(cstring(yytext), driver.yylloc); }
+                     return Parser::make_PARSER_EXCEPTION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "payload"       { BEGIN(driver.saveState);
-                  return Parser::make_PAYLOAD(cstring(yytext), driver.yylloc); }
+                  return Parser::make_PAYLOAD(driver.internToken(yytext, yyleng), driver.yylloc); }
 "pre_color"     { BEGIN(driver.saveState);
-                  return Parser::make_PRE_COLOR(cstring(yytext), driver.yylloc); }
+                  return Parser::make_PRE_COLOR(driver.internToken(yytext, yyleng), driver.yylloc); }
 "primitive_action" { BEGIN(driver.saveState);
-                     return Parser::make_PRIMITIVE_ACTION(cstring(yytext), driver.yylloc); }
+                     return Parser::make_PRIMITIVE_ACTION(driver.internToken(yytext, yyleng), driver.yylloc); }
 "reads"         { BEGIN(driver.saveState);
-                  return Parser::make_READS(cstring(yytext), driver.yylloc); }
+                  return Parser::make_READS(driver.internToken(yytext, yyleng), driver.yylloc); }
 "register"      { BEGIN(driver.saveState);
-                  return Parser::make_REGISTER(cstring(yytext), driver.yylloc); }
+                  return Parser::make_REGISTER(driver.internToken(yytext, yyleng), driver.yylloc); }
 "result"        { BEGIN(driver.saveState);
-                  return Parser::make_RESULT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_RESULT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "return"        { BEGIN(driver.saveState);
-                  return Parser::make_RETURN(cstring(yytext), driver.yylloc); }
+                  return Parser::make_RETURN(driver.internToken(yytext, yyleng), driver.yylloc); }
 "saturating"    { BEGIN(driver.saveState);
-                  return Parser::make_SATURATING(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SATURATING(driver.internToken(yytext, yyleng), driver.yylloc); }
 "select"        { BEGIN(driver.saveState);
-                  return Parser::make_SELECT(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SELECT(driver.internToken(yytext, yyleng), driver.yylloc); }
 "selection_key" { BEGIN(driver.saveState);
-                  return Parser::make_SELECTION_KEY(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SELECTION_KEY(driver.internToken(yytext, yyleng), driver.yylloc); }
 "selection_mode" {BEGIN(driver.saveState);
-                  return Parser::make_SELECTION_MODE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SELECTION_MODE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "selection_type" {BEGIN(driver.saveState);
-                  return Parser::make_SELECTION_TYPE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SELECTION_TYPE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "set_metadata"  { BEGIN(driver.saveState);
-                  return Parser::make_SET_METADATA(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SET_METADATA(driver.internToken(yytext, yyleng), driver.yylloc); }
 "signed"        { BEGIN(driver.saveState);
-                  return Parser::make_SIGNED(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SIGNED(driver.internToken(yytext, yyleng), driver.yylloc); }
 "size"          { BEGIN(driver.saveState);
-                  return Parser::make_SIZE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_SIZE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "static"        { BEGIN(driver.saveState);
-                  return Parser::make_STATIC(cstring(yytext), driver.yylloc); }
+                  return Parser::make_STATIC(driver.internToken(yytext, yyleng), driver.yylloc); }
 "string"        { BEGIN(driver.saveState);
-                  return Parser::make_STRING(cstring(yytext), driver.yylloc); }
+                  return Parser::make_STRING(driver.internToken(yytext, yyleng), driver.yylloc); }
 "true"          { BEGIN(driver.saveState);
-                  return Parser::make_TRUE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_TRUE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "table"         { BEGIN(driver.saveState);
-                  return Parser::make_TABLE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_TABLE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "type"          { BEGIN(driver.saveState);
-                  return Parser::make_TYPE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_TYPE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "update"        { BEGIN(driver.saveState);
-                  return Parser::make_UPDATE(cstring(yytext), driver.yylloc); }
+                  return Parser::make_UPDATE(driver.internToken(yytext, yyleng), driver.yylloc); }
 "valid"         { BEGIN(driver.saveState);
-                  return Parser::make_VALID(cstring(yytext), driver.yylloc); }
+                  return Parser::make_VALID(driver.internToken(yytext, yyleng), driver.yylloc); }
 "verify"        { BEGIN(driver.saveState);
-                  return Parser::make_VERIFY(cstring(yytext), driver.yylloc); }
+                  return Parser::make_VERIFY(driver.internToken(yytext, yyleng), driver.yylloc); }
 "width"         { BEGIN(driver.saveState);
-                  return Parser::make_WIDTH(cstring(yytext), driver.yylloc); }
+                  return Parser::make_WIDTH(driver.internToken(yytext, yyleng), driver.yylloc); }
 "writes"        { BEGIN(driver.saveState);
-                  return Parser::make_WRITES(cstring(yytext), driver.yylloc); }
+                  return Parser::make_WRITES(driver.internToken(yytext, yyleng), driver.yylloc); }
 [A-Za-z_][A-Za-z0-9_]* {
                   BEGIN(driver.saveState);
-                  cstring name = yytext;
+                  cstring name = driver.internToken(yytext, yyleng);
                   driver.onReadIdentifier(name);
                   return Parser::make_IDENTIFIER(name, driver.yylloc);
 }
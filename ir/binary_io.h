@@ -0,0 +1,55 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _IR_BINARY_IO_H_
+#define _IR_BINARY_IO_H_
+
+#include <iosfwd>
+
+#include "ir.h"
+#include "json_parser.h"
+
+/* Compact binary IR serialization (--toBinIR / --fromBinIR).
+ *
+ * The format is a binary encoding of the same document the text JSON
+ * dump/load path produces: length-prefixed records with LEB128 varints, an
+ * interned string table (each distinct string -- node type names, field
+ * names, identifiers -- is written once and referenced by index afterwards),
+ * and the existing Node_ID based back references for shared subtrees.
+ * Loading skips text parsing entirely and feeds the decoded document to
+ * JSONLoader, so all generated fromJSON constructors are reused unchanged. */
+
+/// Serialize @node to @out in the binary IR format.
+void saveBinaryIR(const IR::Node *node, std::ostream &out);
+
+/// Load a node previously written by saveBinaryIR.  Reports an error and
+/// returns nullptr if @in does not hold a valid binary IR artifact.
+const IR::Node *loadBinaryIR(std::istream &in);
+
+/// The document-level codec, exposed for testing: encode/decode a JsonData
+/// tree in the binary format.  decodeBinaryJson returns nullptr on a
+/// malformed input.
+void encodeBinaryJson(const JsonData *data, std::ostream &out);
+JsonData *decodeBinaryJson(std::istream &in);
+
+/// The container header, exposed so that writers appending extra records
+/// after the program (e.g. the analysis snapshot in frontends) produce files
+/// plain loadBinaryIR still reads; loadBinaryIR ignores trailing records.
+/// readBinaryIRHeader reports an error and returns false on a mismatch.
+void writeBinaryIRHeader(std::ostream &out);
+bool readBinaryIRHeader(std::istream &in);
+
+#endif /* _IR_BINARY_IO_H_ */
@@ -57,6 +57,87 @@ class IRDumper : public Inspector {
     IRDumper(std::ostream &o, unsigned m, cstring ign, bool src)
     : out(o), maxdepth(m), ignore(ign), source(src) { visitDagOnce = false; }
 };
+
+/* Like IRDumper, but only dumps subtrees matching the filter and stops as
+ * soon as a byte budget runs out.  Until a match is found the visitor just
+ * descends without producing output; within a match the depth cap is
+ * relative to the matched subtree root. */
+class FilteredIRDumper : public Inspector {
+    std::ostream                &out;
+    std::set<const IR::Node *>  dumped;
+    DumpFilter                  filter;
+    size_t                      written = 0;
+    int                         matchDepth = -1;
+    bool                        exhausted = false;
+
+    bool matches(const IR::Node *n) const {
+        if (filter.nodeType && filter.nodeType != n->node_type_name())
+            return false;
+        if (filter.match) {
+            auto decl = n->to<IR::IDeclaration>();
+            if (!decl || !decl->getName().name.find(filter.match))
+                return false; }
+        return true; }
+    bool preorder(const IR::Node *n) override {
+        if (exhausted)
+            return false;
+        auto ctxt = getContext();
+        unsigned depth = ctxt ? ctxt->depth : 0;
+        if (matchDepth < 0) {
+            if (!matches(n))
+                return true;    // keep searching below
+            matchDepth = depth; }
+        unsigned reldepth = depth - unsigned(matchDepth);
+        if (reldepth > filter.maxdepth)
+            return false;
+        std::stringstream line;
+        line << indent_t(reldepth);
+        if (ctxt && ctxt->child_name)
+            line << ctxt->child_name << ": ";
+        line << "[" << n->id << "] " << n->node_type_name();
+        if (filter.maxNodeBytes) {
+            std::stringstream fields;
+            n->dump_fields(fields);
+            auto text = fields.str();
+            if (text.size() > filter.maxNodeBytes) {
+                text.resize(filter.maxNodeBytes);
+                text += "..."; }
+            line << text;
+        } else {
+            n->dump_fields(line); }
+        bool descend = true;
+        if (dumped.count(n)) {
+            line << "...";
+            descend = false;
+        } else {
+            dumped.insert(n); }
+        line << '\n';
+        auto text = line.str();
+        if (filter.maxTotalBytes && written + text.size() > filter.maxTotalBytes) {
+            out << indent_t(reldepth) << "... (dump byte budget exhausted)" << std::endl;
+            exhausted = true;
+            return false; }
+        written += text.size();
+        out << text;
+        return descend; }
+    bool preorder(const IR::Expression *e) override {
+        if (!preorder(static_cast<const IR::Node *>(e))) return false;
+        if (matchDepth >= 0)
+            visit(e->type, "type");
+        return true; }
+    bool preorder(const IR::Constant *c) override {
+        return preorder(static_cast<const IR::Node *>(c)); }
+    void postorder(const IR::Node *n) override {
+        if (getChildrenVisited() == 0)
+            dumped.erase(n);
+        unsigned depth = getContext() ? getContext()->depth : 0;
+        if (matchDepth >= 0 && unsigned(matchDepth) == depth)
+            matchDepth = -1; }      // resume searching for the next match
+
+ public:
+    FilteredIRDumper(std::ostream &o, const DumpFilter &f)
+    : out(o), filter(f) { visitDagOnce = false; }
+};
 }  // namespace
 
 void dump(std::ostream &out, const IR::Node *n, unsigned maxdepth) {
@@ -110,3 +191,18 @@ void dump(const Visitor::Context *ctxt) { dump(std::cout, ctxt); }
 std::string dumpToString(const IR::Node* n) {
     std::stringstream str;
     dump(str, n); return str.str(); }
+
+void dump(std::ostream &out, const IR::Node *n, const DumpFilter &filter) {
+    n->apply(FilteredIRDumper(out, filter)); }
+void dump(const IR::Node *n, const DumpFilter &filter) { dump(std::cout, n, filter); }
+void dump_match(const IR::Node *n, const char *match) {
+    DumpFilter filter;
+    filter.match = match;
+    dump(std::cout, n, filter); }
+void dump_type(const IR::Node *n, const char *nodeType) {
+    DumpFilter filter;
+    filter.nodeType = nodeType;
+    dump(std::cout, n, filter); }
+std::string dumpToString(const IR::Node *n, const DumpFilter &filter) {
+    std::stringstream str;
+    dump(str, n, filter); return str.str(); }
@@ -40,6 +40,25 @@ void dump(const Visitor::Context *);
 
 std::string dumpToString(const IR::Node* n);
 
+/* Limits for filtered dumps; the defaults dump everything, like plain dump().
+ * Output is streamed to the destination as it is produced and stops as soon
+ * as a budget is exhausted, so dumping a huge midend IR stays cheap. */
+struct DumpFilter {
+    unsigned maxdepth = ~0U;      // levels to dump below each matched subtree root
+    cstring  nodeType = nullptr;  // only dump subtrees rooted at this node type
+    cstring  match = nullptr;     // only dump subtrees rooted at declarations
+                                  // whose name contains this substring
+    size_t   maxNodeBytes = 0;    // truncate a node's fields beyond this (0 = no limit)
+    size_t   maxTotalBytes = 0;   // stop the whole dump beyond this (0 = no limit)
+};
+
+void dump(std::ostream &out, const IR::Node *n, const DumpFilter &filter);
+void dump(const IR::Node *n, const DumpFilter &filter);
+/* debugger conveniences */
+void dump_match(const IR::Node *n, const char *match);
+void dump_type(const IR::Node *n, const char *nodeType);
+std::string dumpToString(const IR::Node *n, const DumpFilter &filter);
+
 class Dump {
     const IR::Node *n = nullptr;
     const Visitor::Context *ctxt = nullptr;
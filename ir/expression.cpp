@@ -14,6 +14,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
 #include "ir.h"
 #include "dbprint.h"
 #include "lib/gmputil.h"
@@ -73,6 +77,51 @@ IR::Constant::handleOverflow(bool noWarning) {
     }
 
     int width = tb->size;
+
+    // Fast path for the overwhelmingly common case: a width of at most
+    // 64 bits and a value already in machine range.  The check and the
+    // masking run on machine words, with no big_int temporaries for the
+    // mask and bounds, and the value is only touched if it must change.
+    if (width > 0 && width <= 64 &&
+        value >= std::numeric_limits<int64_t>::min() &&
+        value <= std::numeric_limits<uint64_t>::max()) {
+        if (tb->isSigned) {
+            if (value <= std::numeric_limits<int64_t>::max()) {
+                if (width < 64) {
+                    int64_t v = value.convert_to<int64_t>();
+                    int64_t max = (int64_t(1) << (width - 1)) - 1;
+                    int64_t min = -(int64_t(1) << (width - 1));
+                    if (v < min || v > max) {
+                        if (!noWarning)
+                            ::warning(ErrorType::WARN_OVERFLOW,
+                                      "%1%: signed value does not fit in %2% bits", this, width);
+                        uint64_t m = (uint64_t(1) << width) - 1;
+                        // wrapping subtraction yields the two's complement value
+                        uint64_t masked = uint64_t(v) & m;
+                        if (masked > uint64_t(max))
+                            masked -= uint64_t(1) << width;
+                        value = int64_t(masked);
+                    }
+                }
+                // any int64 value fits in 64 signed bits
+                return;
+            }
+            // value in (INT64_MAX, UINT64_MAX] must wrap: use the slow path
+        } else if (value >= 0) {
+            uint64_t v = value.convert_to<uint64_t>();
+            uint64_t m = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+            if ((v & m) != v) {
+                if (!noWarning)
+                    ::warning(ErrorType::WARN_MISMATCH,
+                              "%1%: value does not fit in %2% bits", this, width);
+                value = v & m;
+            }
+            return;
+        }
+        // negative value with unsigned type: keep the slow path's
+        // two's-complement masking (and its warning)
+    }
+
     big_int one = 1;
     big_int mask = Util::mask(width);
 
@@ -146,3 +195,57 @@ IR::Constant
 IR::Constant::GetMask(unsigned width) {
   return (IR::Constant(1) << width) - IR::Constant(1);
 }
+
+const IR::Constant*
+IR::Constant::get(const Type* t, big_int v, unsigned base) {
+    // Interned nodes are shared across the whole IR, so only values that need
+    // no overflow handling are eligible.  Type_InfInt is never interned: each
+    // instance is a distinct type variable for unification (see the comment in
+    // CloneConstants in constantFolding.cpp).
+    static const big_int cacheLimit = 16;
+    if (v >= 0 && v <= cacheLimit && base == 10) {
+        if (auto tb = t->to<IR::Type_Bits>()) {
+            int bits = tb->isSigned ? tb->size - 1 : tb->size;
+            if (bits > 0 && v < (big_int(1) << bits)) {
+                // map (type, value) to the shared constant
+                using const_key = std::pair<const Type*, int>;
+                static auto *cache = new std::map<const_key, const IR::Constant*>();
+                static std::mutex cache_mutex;
+                // TypeInference workers (--parallel-typecheck) call this
+                // concurrently; the cache must not be mutated unsynchronized.
+                std::lock_guard<std::mutex> lock(cache_mutex);
+                auto &result = (*cache)[std::make_pair(t, static_cast<int>(v))];
+                if (!result)
+                    result = new IR::Constant(t, v, base);
+                return result;
+            }
+        }
+    }
+    return new IR::Constant(t, v, base);
+}
+
+const IR::Constant*
+IR::Constant::get(Util::SourceInfo si, const Type* t, big_int v,
+                  unsigned base, bool noWarning) {
+    if (!si.isValid() && !noWarning)
+        return get(t, v, base);
+    return new IR::Constant(si, t, v, base, noWarning);
+}
+
+const IR::BoolLiteral*
+IR::BoolLiteral::get(bool value) {
+    // Thread-safe initialization of function-local statics makes these
+    // singletons safe to create from worker threads.
+    static const IR::BoolLiteral *true_ =
+        new IR::BoolLiteral(IR::Type::Boolean::get(), true);
+    static const IR::BoolLiteral *false_ =
+        new IR::BoolLiteral(IR::Type::Boolean::get(), false);
+    return value ? true_ : false_;
+}
+
+const IR::BoolLiteral*
+IR::BoolLiteral::get(Util::SourceInfo si, bool value) {
+    if (!si.isValid())
+        return get(value);
+    return new IR::BoolLiteral(si, value);
+}
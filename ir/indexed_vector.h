@@ -18,6 +18,9 @@ limitations under the License.
 #define IR_INDEXED_VECTOR_H_
 
 
+#include <atomic>
+#include <mutex>
+
 #include "dbprint.h"
 #include "lib/enumerator.h"
 #include "lib/error.h"
@@ -37,11 +40,15 @@ namespace IR {
  */
 template<class T>
 class IndexedVector : public Vector<T> {
-    ordered_map<cstring, const IDeclaration*> declarations;
-    bool invalid = false;  // set when an error occurs; then we don't
-                           // expect the validity check to succeed.
-
-    void insertInMap(const T* a) {
+    // Built lazily on the first name lookup: the Transform clone paths
+    // copy these vectors far more often than anyone looks a name up, so
+    // copies just drop the index instead of rebuilding it eagerly.
+    mutable ordered_map<cstring, const IDeclaration*> declarations;
+    mutable std::atomic<bool> indexed{false};
+    mutable bool invalid = false;  // set when an error occurs; then we don't
+                                   // expect the validity check to succeed.
+
+    void insertInMap(const T* a, bool report = true) const {
         if (a == nullptr || !a->template is<IDeclaration>())
             return;
         auto decl = a->template to<IDeclaration>();
@@ -49,12 +56,13 @@ class IndexedVector : public Vector<T> {
         auto previous = declarations.find(name);
         if (previous != declarations.end()) {
             invalid = true;
-            ::error(ErrorType::ERR_DUPLICATE,
-                    "%1%: Duplicates declaration %2%", a, previous->second);
+            if (report)
+                ::error(ErrorType::ERR_DUPLICATE,
+                        "%1%: Duplicates declaration %2%", a, previous->second);
         } else {
             declarations[name] = decl; }}
     void removeFromMap(const T* a) {
-        if (a == nullptr)
+        if (!indexed || a == nullptr)
             return;
         auto decl = a->template to<IDeclaration>();
         if (decl == nullptr)
@@ -64,18 +72,44 @@ class IndexedVector : public Vector<T> {
         if (it == declarations.end())
             BUG("%1% does not exist", a);
         declarations.erase(it); }
+    void buildIndex() const {
+        // a copy of a vector whose duplicates were already reported must
+        // not report them again
+        bool report = !invalid;
+        declarations.clear();
+        for (auto el : *this) insertInMap(el, report);
+        indexed.store(true, std::memory_order_release); }
+    void ensureIndexed() const {
+        if (indexed.load(std::memory_order_acquire)) return;
+        // read-only passes may share nodes between worker threads, so the
+        // first lookups can race to build the index; builds happen once per
+        // vector, so one mutex per instantiation is plenty
+        static std::mutex lock;
+        std::lock_guard<std::mutex> guard(lock);
+        if (!indexed.load(std::memory_order_relaxed)) buildIndex(); }
 
  public:
     using Vector<T>::begin;
     using Vector<T>::end;
 
     IndexedVector() = default;
-    IndexedVector(const IndexedVector &) = default;
-    IndexedVector(IndexedVector &&) = default;
-    IndexedVector(const std::initializer_list<const T *> &a) : Vector<T>(a) {
-        for (auto el : *this) insertInMap(el); }
-    IndexedVector &operator=(const IndexedVector &) = default;
-    IndexedVector &operator=(IndexedVector &&) = default;
+    IndexedVector(const IndexedVector &a) : Vector<T>(a), invalid(a.invalid) {}
+    IndexedVector(IndexedVector &&a)
+        : Vector<T>(std::move(a)), declarations(std::move(a.declarations)),
+          indexed(a.indexed.load()), invalid(a.invalid) {}
+    IndexedVector(const std::initializer_list<const T *> &a) : Vector<T>(a) {}
+    IndexedVector &operator=(const IndexedVector &a) {
+        Vector<T>::operator=(a);
+        declarations.clear();
+        indexed = false;
+        invalid = a.invalid;
+        return *this; }
+    IndexedVector &operator=(IndexedVector &&a) {
+        Vector<T>::operator=(std::move(a));
+        declarations = std::move(a.declarations);
+        indexed = a.indexed.load();
+        invalid = a.invalid;
+        return *this; }
     explicit IndexedVector(const T *a) {
         push_back(std::move(a)); }
     explicit IndexedVector(const safe_vector<const T *> &a) {
@@ -84,24 +118,27 @@ class IndexedVector : public Vector<T> {
         insert(typename Vector<T>::end(), a.begin(), a.end()); }
     explicit IndexedVector(JSONLoader &json);
 
-    void clear() { IR::Vector<T>::clear(); declarations.clear(); }
+    void clear() { IR::Vector<T>::clear(); declarations.clear(); indexed = false; }
     // TODO: Although this is not a const_iterator, it should NOT
     // be used to modify the vector directly.  I don't know
     // how to enforce this property, though.
     typedef typename Vector<T>::iterator iterator;
 
     const IDeclaration* getDeclaration(cstring name) const {
+        ensureIndexed();
         auto it = declarations.find(name);
         if (it == declarations.end())
             return nullptr;
         return it->second; }
     template <class U>
     const U* getDeclaration(cstring name) const {
+        ensureIndexed();
         auto it = declarations.find(name);
         if (it == declarations.end())
             return nullptr;
         return it->second->template to<U>(); }
     Util::Enumerator<const IDeclaration*>* getDeclarations() const {
+        ensureIndexed();
         return Util::Enumerator<const IDeclaration*>::createEnumerator(
             Values(declarations).begin(), Values(declarations).end()); }
     iterator erase(iterator i) {
@@ -109,13 +146,14 @@ class IndexedVector : public Vector<T> {
         return Vector<T>::erase(i); }
     template<typename ForwardIter>
     iterator insert(iterator i, ForwardIter b, ForwardIter e) {
-        for (auto it = b; it != e; ++it)
-            insertInMap(*it);
+        if (indexed)
+            for (auto it = b; it != e; ++it)
+                insertInMap(*it);
         return Vector<T>::insert(i, b, e); }
     iterator replace(iterator i, const T* v) {
         removeFromMap(*i);
         *i = v;
-        insertInMap(v);
+        if (indexed) insertInMap(v);
         return ++i; }
     template<typename Container>
     iterator append(const Container &toAppend) {
@@ -124,7 +162,7 @@ class IndexedVector : public Vector<T> {
     iterator prepend(const Container &toAppend) {
         return insert(Vector<T>::begin(), toAppend.begin(), toAppend.end()); }
     iterator insert(iterator i, const T* v) {
-        insertInMap(v);
+        if (indexed) insertInMap(v);
         return Vector<T>::insert(i, v); }
     template <class... Args> void emplace_back(Args&&... args) {
         auto el = new T(std::forward<Args>(args)...);
@@ -139,15 +177,16 @@ class IndexedVector : public Vector<T> {
         }
         return false;
     }
-    void push_back(T *a) { CHECK_NULL(a); Vector<T>::push_back(a); insertInMap(a); }
-    void push_back(const T *a) { CHECK_NULL(a); Vector<T>::push_back(a); insertInMap(a); }
+    void push_back(T *a) { CHECK_NULL(a); Vector<T>::push_back(a); if (indexed) insertInMap(a); }
+    void push_back(const T *a) {
+        CHECK_NULL(a); Vector<T>::push_back(a); if (indexed) insertInMap(a); }
     void pop_back() {
         if (typename Vector<T>::empty())
             BUG("pop_back from empty IndexedVector");
         auto last = typename Vector<T>::back();
         removeFromMap(last);
         typename Vector<T>::pop_back(); }
-    template<class U> void push_back(U &a) { Vector<T>::push_back(a); insertInMap(a); }
+    template<class U> void push_back(U &a) { Vector<T>::push_back(a); if (indexed) insertInMap(a); }
 
     IRNODE_SUBCLASS(IndexedVector)
     IRNODE_DECLARE_APPLY_OVERLOAD(IndexedVector)
@@ -180,6 +219,7 @@ class IndexedVector : public Vector<T> {
     void toJSON(JSONGenerator &json) const override;
     static IndexedVector<T>* fromJSON(JSONLoader &json);
     void validate() const override {
+        ensureIndexed();
         if (invalid) return;  // don't crash the compiler because an error happened
         for (auto el : *this) {
             auto decl = el->template to<IR::IDeclaration>();
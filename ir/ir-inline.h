@@ -159,6 +159,7 @@ template<class T> void IR::IndexedVector<T>::visit_children(Visitor &v) const {
 template<class T>
 void IR::IndexedVector<T>::toJSON(JSONGenerator &json) const {
     const char *sep = "";
+    ensureIndexed();  // the dump must carry a complete index
     Vector<T>::toJSON(json);
     json << "," << std::endl << json.indent++ << "\"declarations\" : {";
     for (auto &k : declarations) {
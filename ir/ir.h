@@ -27,6 +27,7 @@ limitations under the License.
 #include "lib/algorithm.h"
 #include "lib/cstring.h"
 #include "lib/map.h"
+#include "lib/ordered_flat_map.h"
 #include "lib/ordered_map.h"
 #include "lib/exceptions.h"
 #include "lib/source_file.h"
@@ -42,6 +43,7 @@ limitations under the License.
 #include "namemap.h"
 #include "nodemap.h"
 #include "id.h"
+#include "structural_hash.h"
 
 
 // generated ir file
@@ -26,9 +26,11 @@ limitations under the License.
 #include "lib/cstring.h"
 #include "lib/indent.h"
 #include "lib/match.h"
+#include "lib/ordered_flat_map.h"
 #include "lib/ordered_map.h"
 #include "lib/ordered_set.h"
 #include "lib/safe_vector.h"
+#include "lib/small_vector.h"
 #include "ir.h"
 #include "json_parser.h"
 
@@ -69,13 +71,14 @@ class JSONLoader {
             if (node_refs.find(id) == node_refs.end()) {
                 if (auto fn = get(IR::unpacker_table, json->to<JsonObject>()->get_type())) {
                         node_refs[id] = fn(*this);
-                        // Creating JsonObject from source_info read from jsonFile
-                        // and setting SourceInfo for each node
-                        // when "--fromJSON" flag is used
-                        JsonObject* obj = new JsonObject(json->to<JsonObject>()->get_sourceJson());
-                        if (obj->hasSrcInfo() == true) {
-                                node_refs[id]->srcInfo = Util::SourceInfo(obj->get_filename(), \
-                                    obj->get_line(), obj->get_column(), obj->get_sourceFragment());
+                        // Setting SourceInfo for each node from the source_info
+                        // read from the jsonFile when "--fromJSON" flag is used.
+                        // Read in place: copying the Source_Info object for
+                        // every node was a measurable part of load time.
+                        if (auto si = dynamic_cast<JsonObject *>(
+                                ::get(json->to<JsonObject>(), "Source_Info"))) {
+                                node_refs[id]->srcInfo = Util::SourceInfo(si->get_filename(), \
+                                    si->get_line(), si->get_column(), si->get_sourceFragment());
                         }
                     } else {
                         return nullptr;
@@ -95,6 +98,15 @@ class JSONLoader {
         }
     }
 
+    template<typename T, size_t N>
+    void unpack_json(small_vector<T, N> &v) {
+        T temp;
+        for (auto e : *json->to<JsonVector>()) {
+            load(e, temp);
+            v.push_back(temp);
+        }
+    }
+
     template<typename T>
     void unpack_json(std::set<T> &v) {
         T temp;
@@ -150,6 +162,16 @@ class JSONLoader {
             v.insert(temp);
         }
     }
+    template<typename K, typename V, typename HASH, typename PRED>
+    void unpack_json(ordered_flat_map<K, V, HASH, PRED> &v) {
+        std::pair<K, V> temp;
+        for (auto e : *json->to<JsonObject>()) {
+            JsonString* k = new JsonString(e.first);
+            load(k, temp.first);
+            load(e.second, temp.second);
+            v.insert(temp);
+        }
+    }
     template<typename K, typename V>
     void unpack_json(std::multimap<K, V> &v) {
         std::pair<K, V> temp;
@@ -198,6 +220,7 @@ class JSONLoader {
     unpack_json(T &v) { v = *json->to<JsonNumber>(); }
     void unpack_json(big_int &v) { v = json->to<JsonNumber>()->val; }
     void unpack_json(cstring &v) { if (!json->is<JsonNull>()) v = *json->to<std::string>(); }
+    void unpack_json(std::string &v) { if (!json->is<JsonNull>()) v = *json->to<std::string>(); }
     void unpack_json(IR::ID &v) { if (!json->is<JsonNull>()) v.name = *json->to<std::string>(); }
 
     void unpack_json(LTBitMatrix &m) {
@@ -218,7 +241,7 @@ class JSONLoader {
             s->c_str() >> v; }
 
     void unpack_json(UnparsedConstant*& v) {
-        cstring text("");
+        std::string text;
         unsigned skip = 0;
         unsigned base = 0;
         bool hasWidth = false;
@@ -302,6 +325,7 @@ IR::Vector<T>* IR::Vector<T>::fromJSON(JSONLoader &json) {
 template<class T>
 IR::IndexedVector<T>::IndexedVector(JSONLoader &json) : Vector<T>(json) {
     json.load("declarations", declarations);
+    indexed = true;
 }
 template<class T>
 IR::IndexedVector<T>* IR::IndexedVector<T>::fromJSON(JSONLoader &json) {
@@ -17,6 +17,7 @@ limitations under the License.
 #include "ir/json_parser.h"
 
 #include <iostream>
+#include <iterator>
 
 int JsonObject::get_id() const {
     if (find("Node_ID") == end())
@@ -121,90 +122,116 @@ std::ostream& operator<<(std::ostream &out, JsonData* json) {
 }
 
 
-std::istream& operator>>(std::istream &in, JsonData*& json) {
-    while (in) {
-        char ch;
-        in >> ch;
-        switch (ch) {
-        case '{': {
-            ordered_map<std::string, JsonData*> obj;
-            do {
-                in >> std::ws >> ch;
-                if (ch == '}')
-                    break;
-                in.unget();
+namespace {
+
+// Recursive-descent parser over an in-memory buffer.  The previous
+// implementation extracted the input a character at a time through the
+// istream interface (with unget backtracking), which dominated the time
+// to load large IR dumps; here the document is scanned in place and the
+// DOM nodes are filled in directly, with no intermediate containers to
+// copy from.
+class JsonParser {
+    const char *p;
+    const char *end;
 
-                JsonData *key, *val;
-                in >> key >> std::ws >> ch >> std::ws >> val;
-                obj[*(dynamic_cast<std::string*>(key))] = val;
+    void skipSpace() { while (p != end && isspace(*p)) ++p; }
+    void skip(size_t n) { p = size_t(end - p) > n ? p + n : end; }
 
-                in >> std::ws >> ch;
-            } while (in && ch != '}');
+ public:
+    JsonParser(const char *start, const char *finish) : p(start), end(finish) {}
 
-            json = new JsonObject(obj);
-            return in;
+    JsonData *parse() {
+        skipSpace();
+        if (p == end)
+            return nullptr;
+        switch (*p) {
+        case '{': {
+            ++p;
+            auto *obj = new JsonObject();
+            while (true) {
+                skipSpace();
+                if (p == end)
+                    break;
+                if (*p == '}') {
+                    ++p;
+                    break; }
+                JsonData *key = parse();
+                skipSpace();
+                if (p != end && *p == ':')
+                    ++p;
+                JsonData *val = parse();
+                if (auto *k = dynamic_cast<std::string *>(key))
+                    obj->emplace(std::move(*k), val);
+                skipSpace();
+                if (p != end && *p == ',')
+                    ++p;
+            }
+            return obj;
         }
         case '[': {
-            std::vector<JsonData*> vec;
-            do {
-                in >> std::ws >> ch;
-                if (ch == ']')
+            ++p;
+            auto *vec = new JsonVector();
+            while (true) {
+                skipSpace();
+                if (p == end)
                     break;
-                in.unget();
-
-                JsonData *elem;
-                in >> elem;
-                vec.push_back(elem);
-
-                in >> std::ws >> ch;
-            } while (in && ch != ']');
-
-            json = new JsonVector(vec);
-            return in;
+                if (*p == ']') {
+                    ++p;
+                    break; }
+                vec->push_back(parse());
+                skipSpace();
+                if (p != end && *p == ',')
+                    ++p;
+            }
+            return vec;
         }
         case '"': {
-            std::string s;
-            getline(in, s, '"');
-            while (!s.empty() && s.back() == '\\') {
-                int bscount = 0;  // odd number of '\' chars mean the quote is escaped
-                for (auto t = s.rbegin(); t != s.rend() && *t == '\\'; ++t) bscount++;
-                if ((bscount & 1) == 0) break;
-                s += '"';
-                std::string more;
-                getline(in, more, '"');
-                s += more; }
-            json = new JsonString(s);
-            return in;
+            const char *start = ++p;
+            while (p != end) {
+                if (*p == '"') {
+                    int bscount = 0;  // odd number of '\' chars mean the quote is escaped
+                    for (const char *t = p; t != start && t[-1] == '\\'; --t) bscount++;
+                    if ((bscount & 1) == 0)
+                        break;
+                    // the quote stays part of the string, as does the backslash
+                }
+                ++p;
+            }
+            auto *rv = new JsonString(std::string(start, p - start));
+            if (p != end) ++p;  // closing quote
+            return rv;
         }
         case '-': case '0': case '1': case '2': case '3':
         case '4': case '5': case '6': case '7': case '8': case '9': {
-            // operator>>(istream, big_int) is broken and throws exceptions if the
-            // number is not followed by whitespace, so we need to manually extract all
-            // the digits into a buffer and convert that to big_int
-            std::string num;
-            do {
-                num += ch;
-                in >> ch;
-            } while (isdigit(ch));
-            in.unget();
-            json = new JsonNumber(big_int(num));
-            return in;
+            const char *start = p;
+            ++p;
+            while (p != end && isdigit(*p)) ++p;
+            return new JsonNumber(big_int(std::string(start, p - start)));
         }
         case 't': case 'T':
-            in.ignore(3);
-            json = new JsonBoolean(true);
-            return in;
+            skip(4);
+            return new JsonBoolean(true);
         case 'f': case 'F':
-            in.ignore(4);
-            json = new JsonBoolean(false);
-            return in;
+            skip(5);
+            return new JsonBoolean(false);
         case 'n': case 'N':
-            in.ignore(3);
-            json = new JsonNull();
-            return in;
+            skip(4);
+            return new JsonNull();
         default:
-            return in;
+            ++p;
+            return nullptr;
         }
     }
+};
+
+}  // namespace
+
+std::istream& operator>>(std::istream &in, JsonData*& json) {
+    // Read the rest of the stream in one gulp; the buffer is released as
+    // soon as parsing finishes, so it never overlaps with the IR built
+    // from the DOM.
+    std::string buf{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    JsonParser parser(buf.data(), buf.data() + buf.size());
+    json = parser.parse();
     return in;
 }
@@ -21,6 +21,16 @@ class JSONLoader;
 
 namespace IR {
 
+/* Adapter giving ordered_flat_map the <K, V, COMP, ALLOC> shape that the MAP
+ * argument of NameMap/NodeMap expects.  The comparator and allocator slots are
+ * ignored: the flat map hashes its keys and keeps its entries in a contiguous
+ * vector, which makes cloning a NameMap a pair of vector copies instead of a
+ * node-by-node rebuild of a std::map.  Use it instead of ordered_map wherever
+ * nothing relies on comparator-based lookup; iteration order is insertion
+ * order, the same as ordered_map. */
+template<class K, class V, class COMP, class ALLOC>
+using flatmap = ordered_flat_map<K, V>;
+
 template<class T, template<class K, class V, class COMP, class ALLOC> class MAP = std::map,
          class COMP = std::less<cstring>,
          class ALLOC = std::allocator<std::pair<const cstring, const T*>>>
@@ -0,0 +1,47 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _IR_NODE_SIZE_BUDGET_H_
+#define _IR_NODE_SIZE_BUDGET_H_
+
+#include <cstddef>
+
+/* Size budgets for generated IR node classes.
+ *
+ * ir-generated.cpp emits IRNODE_CHECK_SIZE for every concrete node class, so
+ * any class pinned here fails the build as soon as a .def change (or a field
+ * layout change in the generator) grows it past its budget.  With tens of
+ * millions of live nodes in large compiles, a few bytes on a hot class are
+ * easily gigabytes of heap.
+ *
+ * Budgets are opt-in because sizeof is platform dependent: none are pinned
+ * by default.  To pin a class, measure it (IR::dump_node_sizes prints all of
+ * them) on the platform CI builds with and add a specialization here:
+ *
+ *     template<> struct NodeSizeBudget<IR::Member>
+ *     { static const size_t value = 136; };
+ */
+namespace IR {
+template<class T> struct NodeSizeBudget {
+    static const size_t value = size_t(-1);  // unlimited unless specialized
+};
+}  // namespace IR
+
+#define IRNODE_CHECK_SIZE(CLASS)                                      \
+    static_assert(sizeof(CLASS) <= ::IR::NodeSizeBudget<CLASS>::value, \
+                  #CLASS " grew past its budget in ir/node-size-budget.h");
+
+#endif /* _IR_NODE_SIZE_BUDGET_H_ */
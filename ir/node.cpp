@@ -16,13 +16,43 @@ limitations under the License.
 
 #include "ir.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
+
+void *IR::Node::operator new(std::size_t size) {
+    if (Util::Arena::enabled())
+        return Util::Arena::allocate(size);
+    return ::operator new(size);
+}
+
+void IR::Node::operator delete(void *p) {
+    // arena-allocated nodes are reclaimed wholesale when their region closes
+    if (Util::Arena::enabled())
+        return;
+    ::operator delete(p);
+}
 
 void IR::Node::traceVisit(const char* visitor) const
 { LOG3("Visiting " << visitor << " " << id << ":" << node_type_name()); }
 
 void IR::Node::traceCreation() const { LOG5("Created node " << id); }
 
-int IR::Node::currentId = 0;
+uint64_t IR::Node::computeHash() const {
+    // seed of every node's hash chain; node_type_name is virtual, so the
+    // most derived type is mixed in exactly once
+    return IR::hash_combine(0, node_type_name());
+}
+
+uint64_t IR::Node::structuralHash() const {
+    uint64_t h = cached_hash.load(std::memory_order_relaxed);
+    if (h != 0) return h;
+    h = computeHash();
+    if (h == 0) h = 1;  // 0 is reserved for "not computed yet"
+    if (cacheHash())
+        cached_hash.store(h, std::memory_order_relaxed);
+    return h;
+}
+
+std::atomic<int> IR::Node::currentId(0);
 
 void IR::Node::toJSON(JSONGenerator &json) const {
     json << json.indent << "\"Node_ID\" : " << id << "," << std::endl
@@ -93,18 +123,19 @@ Util::JsonObject* IR::Node::sourceInfoJsonObj() const {
     unsigned lineNumber, columnNumber;
     cstring fName = prepareSourceInfoForJSON(si, &lineNumber, &columnNumber);
     if (fName == nullptr) {
-        if (si.line == -1) {
-            // -1 is default value for objects when SourceInfo
-            // was not read from jsonFile using "--fromJSON" flag
+        if (!srcInfo.isDetached()) {
+            // no position at all: SourceInfo was neither parsed nor
+            // read from a jsonFile using the "--fromJSON" flag
             return nullptr;
         } else {
-            // Added source_info for jsonObject when "--fromJSON" flag is used
-            // which parameters are saved in srcInfo fileds(filename, line, column and srcBrief)
+            // Added source_info for jsonObject when "--fromJSON" flag is
+            // used, whose parameters are kept in the detached side record
+            // (filename, line, column and source fragment)
             auto json1 = new Util::JsonObject();
-            json1->emplace("filename", srcInfo.filename);
-            json1->emplace("line", srcInfo.line);
-            json1->emplace("column", srcInfo.column);
-            json1->emplace("source_fragment", srcInfo.srcBrief);
+            json1->emplace("filename", srcInfo.detachedFilename());
+            json1->emplace("line", srcInfo.detachedLine());
+            json1->emplace("column", srcInfo.detachedColumn());
+            json1->emplace("source_fragment", srcInfo.detachedFragment());
             return json1;
         }
     } else {
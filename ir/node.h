@@ -17,6 +17,8 @@ limitations under the License.
 #ifndef _IR_NODE_H_
 #define _IR_NODE_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include "lib/cstring.h"
 #include "lib/stringify.h"
@@ -79,11 +81,15 @@ class Node : public virtual INode {
     virtual const Node *apply_visitor_preorder(Transform &v);
     virtual const Node *apply_visitor_postorder(Transform &v);
     virtual void apply_visitor_revisit(Transform &v, const Node *n) const;
-    Node &operator=(const Node &) = default;
-    Node &operator=(Node &&) = default;
+    Node &operator=(const Node &a) {
+        srcInfo = a.srcInfo;
+        id = a.id;
+        clone_id = a.clone_id;
+        cached_hash.store(0, std::memory_order_relaxed);
+        return *this; }
+    Node &operator=(Node &&a) { return operator=(a); }
 
  protected:
-    static int currentId;
     void traceVisit(const char* visitor) const;
     virtual void visit_children(Visitor &) { }
     virtual void visit_children(Visitor &) const { }
@@ -96,9 +102,20 @@ class Node : public virtual INode {
                                      unsigned *columnNumber) const;
 
  public:
+    /* IR nodes normally live on the collected heap; with --arena-alloc
+     * (see lib/arena.h) they are bump-allocated from the active arena region
+     * and never individually freed */
+    static void *operator new(std::size_t size);
+    static void operator delete(void *p);
     Util::SourceInfo    srcInfo;
+    // Source of node ids; atomic because parallel passes may create nodes
+    // (e.g. read-only type inference canonicalizing types on worker threads).
+    static std::atomic<int> currentId;
     int id;  // unique id for each node
     int clone_id;  // unique id this node was cloned from (recursively)
+    // lazily computed recursive hash of the node's contents; 0 until
+    // computed (see structuralHash below)
+    mutable std::atomic<uint64_t> cached_hash{0};
     void traceCreation() const;
     Node() : id(currentId++), clone_id(id) { traceCreation(); }
     explicit Node(Util::SourceInfo si) : srcInfo(si), id(currentId++), clone_id(id) {
@@ -132,6 +149,18 @@ class Node : public virtual INode {
     /* 'equiv' does a deep-equals comparison, comparing all non-pointer fields and recursing
      * though all Node subclass pointers to compare them with 'equiv' as well. */
     virtual bool equiv(const Node &a) const { return typeid(*this) == typeid(a); }
+    /* 'structuralHash' returns a hash consistent with 'equiv': two nodes that compare
+     * equiv always hash equal, so equiv consults it first to reject unequal trees without
+     * walking them.  The hash is computed lazily and cached in the node, which is sound
+     * because nodes are immutable once they are part of a tree -- a node must not be
+     * mutated after it has been hashed.  Clones start with an empty cache. */
+    uint64_t structuralHash() const;
+    /* the per-class hash contributions are generated alongside 'equiv'; classes with
+     * a custom equiv body supply a matching custom computeHash body */
+    virtual uint64_t computeHash() const;
+    /* containers that may legitimately be grown in place override this to skip the
+     * cache; their hash is recomputed from the (cached) hashes of their elements */
+    virtual bool cacheHash() const { return true; }
 #define DEFINE_OPEQ_FUNC(CLASS, BASE) \
     virtual bool operator==(const CLASS &) const { return false; }
     IRNODE_ALL_SUBCLASSES(DEFINE_OPEQ_FUNC)
@@ -14,9 +14,303 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
 #include "ir.h"
+#include "lib/arena.h"
+#include "lib/compile_context.h"
 #include "lib/gc.h"
+#include "lib/json.h"
 #include "lib/n4.h"
+#include "lib/tracepoints.h"
+
+cstring PassProfiler::outputFile = nullptr;
+std::vector<PassProfiler::Record> PassProfiler::records;
+int PassProfiler::currentDepth = 0;
+
+static uint64_t now_nsec() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+void PassProfiler::enable(cstring file) {
+    bool first = !enabled();
+    outputFile = file;
+    if (first)
+        std::atexit(write);
+}
+
+void PassProfiler::write() {
+    if (!enabled())
+        return;
+    std::ofstream out(outputFile.c_str());
+    if (!out) {
+        std::cerr << "Can't write pass profile to " << outputFile << std::endl;
+        return; }
+    auto array = new Util::JsonArray();
+    for (auto &r : records) {
+        auto o = new Util::JsonObject();
+        o->emplace("manager", r.manager);
+        o->emplace("pass", r.pass);
+        o->emplace("depth", r.depth);
+        o->emplace("time_nsec", r.nsec);
+        o->emplace("gc_bytes", r.gcBytes);
+        o->emplace("arena_bytes", r.arenaBytes);
+        o->emplace("nodes_created", r.nodesCreated);
+        o->emplace("visits", r.visits);
+        o->emplace("gc_collections", r.gcCollections);
+        o->emplace("gc_pause_nsec", r.gcPauseNsec);
+        o->emplace("gc_freed_bytes", r.gcFreedBytes);
+        array->append(o);
+    }
+    array->serialize(out);
+    out << std::endl;
+}
+
+PassProfiler::Sample::Sample(cstring manager, cstring pass)
+        : manager(manager), pass(pass), active(enabled()) {
+    if (!active) return;
+    ++currentDepth;
+    startNsec = now_nsec();
+    startGc = gc_bytes_allocated();
+    startArena = Util::Arena::bytesAllocated();
+    startNodes = IR::Node::currentId;
+    startVisits = Visitor::total_visits;
+    startCollections = gc_collections();
+    startPause = gc_pause_nsec();
+    startFreed = gc_freed_bytes();
+}
+
+PassProfiler::Sample::~Sample() {
+    if (!active) return;
+    records.push_back(Record{manager, pass, currentDepth, now_nsec() - startNsec,
+                             gc_bytes_allocated() - startGc,
+                             Util::Arena::bytesAllocated() - startArena,
+                             IR::Node::currentId - startNodes,
+                             Visitor::total_visits - startVisits,
+                             gc_collections() - startCollections,
+                             gc_pause_nsec() - startPause,
+                             gc_freed_bytes() - startFreed});
+    --currentDepth;
+}
+
+cstring MemoryProfiler::outputFile = nullptr;
+std::vector<MemoryProfiler::Snapshot> MemoryProfiler::snapshots;
+std::vector<MemoryProfiler::Attribution> MemoryProfiler::attributions;
+uint64_t MemoryProfiler::lastAttributedHeap = 0;
+
+void MemoryProfiler::enable(cstring file) {
+    bool first = !enabled();
+    outputFile = file;
+    if (first)
+        std::atexit(write);
+}
+
+namespace {
+
+/// Counts the live nodes reachable from a root by node type, sized through
+/// the collector (sizes are 0 when not built with libgc).
+class NodeTypeCounter : public Inspector {
+ public:
+    std::map<cstring, MemoryProfiler::TypeUsage> usage;
+    uint64_t nodes = 0, bytes = 0;
+    NodeTypeCounter() { setName("NodeTypeCounter"); }
+    bool preorder(const IR::Node *n) override {
+        auto &u = usage[n->node_type_name()];
+        size_t size = gc_object_size(n);
+        u.count++;
+        u.bytes += size;
+        nodes++;
+        bytes += size;
+        return true;
+    }
+};
+
+}  // namespace
+
+void MemoryProfiler::sample(cstring manager, cstring pass, const IR::Node *root) {
+    if (!enabled()) return;
+    uint64_t heap = gc_heap_size();
+    snapshots.push_back(Snapshot{manager, pass, heap, gc_heap_watermark(),
+                                 gc_bytes_allocated()});
+    if (root == nullptr)
+        return;
+    // walking the program is expensive, so attribute only when the heap has
+    // grown by a quarter since the last attribution
+    if (!attributions.empty() && heap < lastAttributedHeap + lastAttributedHeap / 4)
+        return;
+    lastAttributedHeap = heap;
+    NodeTypeCounter counter;
+    root->apply(counter);
+    Attribution attr;
+    attr.pass = pass;
+    attr.heapBytes = heap;
+    attr.liveNodes = counter.nodes;
+    attr.liveBytes = counter.bytes;
+    attr.types.assign(counter.usage.begin(), counter.usage.end());
+    std::sort(attr.types.begin(), attr.types.end(),
+              [](const std::pair<cstring, TypeUsage> &a, const std::pair<cstring, TypeUsage> &b) {
+                  return a.second.bytes > b.second.bytes ||
+                         (a.second.bytes == b.second.bytes && a.second.count > b.second.count); });
+    attributions.push_back(std::move(attr));
+}
+
+void MemoryProfiler::write() {
+    if (!enabled())
+        return;
+    std::ofstream out(outputFile.c_str());
+    if (!out) {
+        std::cerr << "Can't write memory profile to " << outputFile << std::endl;
+        return; }
+    auto snapArray = new Util::JsonArray();
+    for (auto &s : snapshots) {
+        auto o = new Util::JsonObject();
+        o->emplace("manager", s.manager);
+        o->emplace("pass", s.pass);
+        o->emplace("heap_bytes", s.heapBytes);
+        o->emplace("heap_watermark", s.heapWatermark);
+        o->emplace("alloc_bytes_total", s.allocatedBytes);
+        snapArray->append(o);
+    }
+    auto attrArray = new Util::JsonArray();
+    for (auto &a : attributions) {
+        auto o = new Util::JsonObject();
+        o->emplace("after_pass", a.pass);
+        o->emplace("heap_bytes", a.heapBytes);
+        o->emplace("live_nodes", a.liveNodes);
+        o->emplace("live_bytes", a.liveBytes);
+        auto types = new Util::JsonArray();
+        for (auto &t : a.types) {
+            auto to = new Util::JsonObject();
+            to->emplace("type", t.first);
+            to->emplace("count", t.second.count);
+            to->emplace("bytes", t.second.bytes);
+            types->append(to);
+        }
+        o->emplace("types", types);
+        attrArray->append(o);
+    }
+    auto report = new Util::JsonObject();
+    report->emplace("snapshots", snapArray);
+    report->emplace("attributions", attrArray);
+    report->serialize(out);
+    out << std::endl;
+}
+
+cstring IRStatistics::outputFile = nullptr;
+std::vector<IRStatistics::Record> IRStatistics::records;
+int IRStatistics::lastRoot = -1;
+IRStatistics::Stats IRStatistics::lastStats;
+
+void IRStatistics::enable(cstring file) {
+    bool first = !enabled();
+    outputFile = file;
+    if (first)
+        std::atexit(write);
+}
+
+namespace {
+
+/// Measures the shape of an IR DAG in one linear walk: distinct node counts
+/// by type and depth, plus the tree-equivalent size.  Shared subtrees are
+/// re-entered only to add their memoized tree size, never re-walked.
+class IRShapeCounter : public Inspector {
+    std::unordered_map<const IR::Node *, uint64_t> subtreeSize;  // tree nodes under each node
+    std::vector<uint64_t> entryCount;       // treeNodes at entry, one per open node
+    std::map<cstring, uint64_t> typeCount;
+
+ public:
+    IRStatistics::Stats stats;
+    IRShapeCounter() { setName("IRShapeCounter"); visitDagOnce = false; }
+    bool preorder(const IR::Node *n) override {
+        auto it = subtreeSize.find(n);
+        if (it != subtreeSize.end()) {
+            // a shared subtree seen again: count it, do not walk it
+            stats.treeNodes += it->second;
+            return false; }
+        size_t depth = entryCount.size();
+        if (depth >= stats.depthHistogram.size())
+            stats.depthHistogram.resize(depth + 1);
+        stats.depthHistogram[depth]++;
+        stats.maxDepth = std::max(stats.maxDepth, depth);
+        typeCount[n->node_type_name()]++;
+        stats.bytes += gc_object_size(n);
+        stats.distinctNodes++;
+        entryCount.push_back(++stats.treeNodes);
+        return true;
+    }
+    void postorder(const IR::Node *n) override {
+        // everything tree-counted since this node's preorder is its subtree
+        subtreeSize[n] = stats.treeNodes - entryCount.back() + 1;
+        entryCount.pop_back();
+    }
+    void end_apply(const IR::Node *) override {
+        stats.types.assign(typeCount.begin(), typeCount.end());
+        std::sort(stats.types.begin(), stats.types.end(),
+                  [](const std::pair<cstring, uint64_t> &a,
+                     const std::pair<cstring, uint64_t> &b) {
+                      return a.second > b.second ||
+                             (a.second == b.second && a.first < b.first); });
+    }
+};
+
+}  // namespace
+
+void IRStatistics::sample(cstring manager, cstring pass, const IR::Node *root) {
+    if (!enabled() || root == nullptr)
+        return;
+    if (root->id != lastRoot) {
+        IRShapeCounter counter;
+        root->apply(counter);
+        lastRoot = root->id;
+        lastStats = std::move(counter.stats);
+    }
+    // a pass that returned its input unchanged reuses the previous walk
+    records.push_back(Record{manager, pass, lastStats});
+}
+
+void IRStatistics::write() {
+    if (!enabled())
+        return;
+    std::ofstream out(outputFile.c_str());
+    if (!out) {
+        std::cerr << "Can't write IR statistics to " << outputFile << std::endl;
+        return; }
+    auto array = new Util::JsonArray();
+    for (auto &r : records) {
+        auto o = new Util::JsonObject();
+        o->emplace("manager", r.manager);
+        o->emplace("pass", r.pass);
+        o->emplace("distinct_nodes", r.stats.distinctNodes);
+        o->emplace("tree_nodes", r.stats.treeNodes);
+        o->emplace("est_bytes", r.stats.bytes);
+        o->emplace("max_depth", uint64_t(r.stats.maxDepth));
+        auto depths = new Util::JsonArray();
+        for (auto d : r.stats.depthHistogram)
+            depths->append(d);
+        o->emplace("depth_histogram", depths);
+        auto types = new Util::JsonArray();
+        for (auto &t : r.stats.types) {
+            auto to = new Util::JsonObject();
+            to->emplace("type", t.first);
+            to->emplace("count", t.second);
+            types->append(to);
+        }
+        o->emplace("types", types);
+        array->append(o);
+    }
+    array->serialize(out);
+    out << std::endl;
+}
 
 void PassManager::removePasses(const std::vector<cstring> &exclude) {
     for (auto it : exclude) {
@@ -42,6 +336,152 @@ void PassManager::listPasses(std::ostream &out, cstring sep) const {
         first = false; }
 }
 
+std::map<int, DirtyRegions::Change> DirtyRegions::history;
+
+/// Collect the names of the top-level declarations that differ between
+/// @from and @to; @returns false if some differing object has no name (the
+/// change cannot be described as a set of dirty declarations).
+static bool diffTopLevel(const IR::P4Program *from, const IR::P4Program *to,
+                         std::set<cstring> *out) {
+    auto addName = [out](const IR::Node *obj) -> bool {
+        auto *decl = obj->to<IR::IDeclaration>();
+        if (decl == nullptr)
+            return false;
+        out->insert(decl->getName().name);
+        return true;
+    };
+    std::set<const IR::Node *> oldObjects(from->objects.begin(), from->objects.end());
+    for (auto *obj : to->objects)
+        if (!oldObjects.count(obj) && !addName(obj))
+            return false;
+    std::set<const IR::Node *> newObjects(to->objects.begin(), to->objects.end());
+    for (auto *obj : from->objects)
+        if (!newObjects.count(obj) && !addName(obj))
+            return false;
+    return true;
+}
+
+void DirtyRegions::record(const IR::Node *from, const IR::Node *to,
+                          const std::set<cstring> *names) {
+    if (from == nullptr || to == nullptr || from == to)
+        return;
+    auto *fromProgram = from->to<IR::P4Program>();
+    auto *toProgram = to->to<IR::P4Program>();
+    if (fromProgram == nullptr || toProgram == nullptr)
+        return;
+    // a nested PassManager records its steps before the enclosing one sees
+    // the combined change; keep the finer-grained record
+    if (history.count(to->id))
+        return;
+    Change change;
+    change.prev = from->id;
+    if (names != nullptr) {
+        change.names = *names;
+    } else if (!diffTopLevel(fromProgram, toProgram, &change.names)) {
+        return;  // leave a gap in the history; consumers will recompute
+    }
+    LOG3("DirtyRegions: " << dbp(from) << " -> " << dbp(to) << ", "
+         << change.names.size() << " declarations dirty");
+    history.emplace(to->id, std::move(change));
+}
+
+bool DirtyRegions::changedSince(int baselineId, const IR::Node *current,
+                                std::set<cstring> *names) {
+    if (current == nullptr)
+        return false;
+    for (int at = current->id; at != baselineId; ) {
+        auto it = history.find(at);
+        if (it == history.end())
+            return false;
+        names->insert(it->second.names.begin(), it->second.names.end());
+        at = it->second.prev;
+    }
+    return true;
+}
+
+bool DirtyRegions::changedSince(const IR::Node *baseline, const IR::Node *current,
+                                std::set<cstring> *names) {
+    if (baseline == nullptr)
+        return false;
+    return changedSince(baseline->id, current, names);
+}
+
+int FeatureCensus::lastRoot = -1;
+std::map<cstring, unsigned> FeatureCensus::perDecl;
+unsigned FeatureCensus::unnamed = 0;
+
+namespace {
+/// Records which FeatureCensus features a subtree contains.
+class FeatureScan : public Inspector {
+    unsigned &mask;
+    void add(unsigned feature) { mask |= feature; }
+ public:
+    explicit FeatureScan(unsigned &mask) : mask(mask) { setName("FeatureScan"); }
+    bool preorder(const IR::P4Parser *) override
+    { add(FeatureCensus::Parsers); return true; }
+    bool preorder(const IR::SwitchStatement *) override
+    { add(FeatureCensus::Switches); return true; }
+    bool preorder(const IR::ExitStatement *) override
+    { add(FeatureCensus::Exits); return false; }
+    bool preorder(const IR::ReturnStatement *) override
+    { add(FeatureCensus::Returns); return true; }
+    bool preorder(const IR::Type_Enum *) override
+    { add(FeatureCensus::Enums); return false; }
+    bool preorder(const IR::Type_SerEnum *) override
+    { add(FeatureCensus::SerEnums); return false; }
+    bool preorder(const IR::Type_BaseList *) override
+    { add(FeatureCensus::Tuples); return true; }
+    bool preorder(const IR::Type_Varbits *) override
+    { add(FeatureCensus::Varbits); return false; }
+};
+}  // namespace
+
+unsigned FeatureCensus::collect(const IR::Node *root) {
+    auto *program = root->to<IR::P4Program>();
+    if (program == nullptr)
+        return ~0U;
+    if (root->id != lastRoot) {
+        std::set<cstring> dirty;
+        bool incremental =
+            lastRoot >= 0 && DirtyRegions::changedSince(lastRoot, root, &dirty);
+        std::map<cstring, unsigned> fresh;
+        unsigned freshUnnamed = 0;
+        for (auto *obj : program->objects) {
+            unsigned mask = 0;
+            auto *decl = obj->to<IR::IDeclaration>();
+            if (decl != nullptr) {
+                cstring name = decl->getName().name;
+                auto it = incremental && !dirty.count(name)
+                        ? perDecl.find(name) : perDecl.end();
+                if (it != perDecl.end()) {
+                    mask = it->second;
+                } else {
+                    FeatureScan scan(mask);
+                    obj->apply(scan);
+                }
+                fresh[name] |= mask;
+            } else {
+                FeatureScan scan(mask);
+                obj->apply(scan);
+                freshUnnamed |= mask;
+            }
+        }
+        perDecl = std::move(fresh);
+        unnamed = freshUnnamed;
+        lastRoot = root->id;
+    }
+    unsigned result = unnamed;
+    for (auto &d : perDecl)
+        result |= d.second;
+    return result;
+}
+
+bool FeatureCensus::hasAny(const IR::Node *root, unsigned features) {
+    if (root == nullptr)
+        return true;
+    return (collect(root) & features) != 0;
+}
+
 const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *) {
     safe_vector<std::pair<safe_vector<Visitor *>::iterator, const IR::Node *>> backup;
     static indent_t log_indent(-1);
@@ -62,7 +502,16 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
         try {
             try {
                 LOG1(log_indent << name() << " invoking " << v->name());
-                auto after = program->apply(**it);
+                const IR::Node *after;
+                {
+                    PassProfiler::Sample sample(name(), v->name());
+                    P4C_PROBE2(pass_start, name(), v->name());
+                    after = program->apply(**it);
+                    P4C_PROBE3(pass_end, name(), v->name(), Visitor::total_visits);
+                }
+                MemoryProfiler::sample(name(), v->name(), after);
+                IRStatistics::sample(name(), v->name(), after);
+                DirtyRegions::record(program, after);
                 if (LOGGING(3)) {
                     size_t maxmem, mem = gc_mem_inuse(&maxmem);  // triggers gc
                     LOG3(log_indent << "heap after " << v->name() << ": in use " <<
@@ -105,6 +554,30 @@ bool PassManager::backtrack(trigger &trig) {
     return false;
 }
 
+Checkpoint PassManager::checkpoint(const IR::Node *current) const {
+    Checkpoint cp;
+    cp.node = current;
+    cp.restorers.reserve(checkpointables.size());
+    for (auto *state : checkpointables)
+        cp.restorers.push_back(state->checkpoint());
+    if (Util::Arena::enabled()) {
+        cp.arenaRegion = Util::Arena::openRegion();
+        cp.ownsArenaRegion = true; }
+    return cp;
+}
+
+const IR::Node *PassManager::restore(Checkpoint &cp) {
+    BUG_CHECK(cp.node != nullptr, "Restoring an empty Checkpoint");
+    for (auto &restorer : cp.restorers)
+        restorer();
+    if (cp.ownsArenaRegion) {
+        // drop every node built since the checkpoint and open a fresh
+        // region for the next attempt
+        Util::Arena::closeRegion(cp.arenaRegion);
+        cp.arenaRegion = Util::Arena::openRegion(); }
+    return cp.node;
+}
+
 bool PassManager::never_backtracks() {
     if (never_backtracks_cache >= 0) return never_backtracks_cache;
     for (auto v : passes) {
@@ -121,6 +594,53 @@ void PassManager::runDebugHooks(const char* visitorName, const IR::Node* program
         h(name(), seqNo, visitorName, program);
 }
 
+const IR::Node *ParallelPassGroup::apply_visitor(const IR::Node *program, const char *) {
+    BUG_CHECK(running, "not calling apply properly");
+    for (auto *v : passes)
+        BUG_CHECK(dynamic_cast<Inspector *>(v) != nullptr,
+                  "%1%: only Inspectors may run in a ParallelPassGroup", v->name());
+    size_t nthreads = std::thread::hardware_concurrency();
+    if (nthreads > passes.size()) nthreads = passes.size();
+    if (nthreads < 2) {
+        // no parallelism available -- just run sequentially
+        for (auto *v : passes) {
+            program->apply(*v);
+            runDebugHooks(v->name(), program);
+            seqNo++; }
+        running = false;
+        return program; }
+    std::atomic<size_t> next(0);
+    std::vector<std::exception_ptr> failures(passes.size());
+    std::vector<std::thread> workers;
+    auto* parentContext = CompileContextStack::currentOrNull();
+    // one lane per pass: the merged diagnostics come out in pass order, as
+    // a sequential run would have printed them, whatever the scheduling
+    auto &reporter = BaseCompileContext::get().errorReporter();
+    reporter.beginSequencedEmission(passes.size());
+    for (size_t t = 0; t < nthreads; ++t) {
+        workers.emplace_back([this, program, parentContext, &next, &failures]() {
+            gc_register_thread();
+            // the context stack is thread-local; adopt the spawning thread's
+            InheritedCompileContext inherited(parentContext);
+            size_t i;
+            while ((i = next.fetch_add(1)) < passes.size()) {
+                ErrorReporter::SequenceLaneScope lane(int(i));
+                try {
+                    program->apply(*passes[i]);
+                } catch (...) {
+                    failures[i] = std::current_exception(); } }
+            gc_unregister_thread(); }); }
+    for (auto &worker : workers) worker.join();
+    reporter.endSequencedEmission();
+    for (auto &failure : failures)
+        if (failure) std::rethrow_exception(failure);
+    for (auto *v : passes) {
+        runDebugHooks(v->name(), program);
+        seqNo++; }
+    running = false;
+    return program;
+}
+
 const IR::Node *PassRepeated::apply_visitor(const IR::Node *program, const char *name) {
     bool done = false;
     unsigned iterations = 0;
@@ -156,3 +676,72 @@ const IR::Node *PassIf::apply_visitor(const IR::Node *program, const char *name)
     }
     return program;
 }
+
+const IR::Node *PassIfFeature::apply_visitor(const IR::Node *program, const char *name) {
+    if (!FeatureCensus::hasAny(program, features)) {
+        LOG1("Skipping " << (name ? name : "pass group")
+             << ": program has none of the node kinds it works on");
+        return program;
+    }
+    running = true;
+    return PassManager::apply_visitor(program, name);
+}
+
+FusedTransformGroup::FusedTransformGroup(const std::initializer_list<Transform *> &init) {
+    for (auto *t : init) {
+        CHECK_NULL(t);
+        passes.push_back(t);
+        // a member that must revisit shared subtrees forces the group to
+        if (!t->visitDagOnce) visitDagOnce = false;
+        if (t->dontForwardChildrenBeforePreorder) dontForwardChildrenBeforePreorder = true; }
+}
+
+Visitor::profile_t FusedTransformGroup::init_apply(const IR::Node *root) {
+    auto rv = Transform::init_apply(root);
+    profiles = new std::vector<profile_t>();
+    for (auto *t : passes)
+        profiles->emplace_back(t->init_apply(root));
+    return rv;
+}
+
+void FusedTransformGroup::end_apply(const IR::Node *root) {
+    for (auto *t : passes)
+        t->end_apply(root);
+    delete profiles;  // fires each member's 0-argument end_apply
+    profiles = nullptr;
+}
+
+const IR::Node *FusedTransformGroup::preorder(IR::Node *n) {
+    const IR::Node *rv = n;
+    const Transform *changedBy = nullptr;
+    for (auto *t : passes) {
+        t->ctxt = ctxt;  // members resolve getOriginal/findContext via the group
+        auto *result = n->apply_visitor_preorder(*t);
+        if (t->prune_flag) {
+            t->prune_flag = false;
+            prune(); }
+        if (result != n) {
+            BUG_CHECK(changedBy == nullptr,
+                      "FusedTransformGroup: %1% and %2% both rewrote %3%; "
+                      "these passes cannot be fused",
+                      changedBy->name(), t->name(), n);
+            changedBy = t;
+            rv = result; } }
+    return rv;
+}
+
+const IR::Node *FusedTransformGroup::postorder(IR::Node *n) {
+    const IR::Node *rv = n;
+    const Transform *changedBy = nullptr;
+    for (auto *t : passes) {
+        t->ctxt = ctxt;
+        auto *result = n->apply_visitor_postorder(*t);
+        if (result != n) {
+            BUG_CHECK(changedBy == nullptr,
+                      "FusedTransformGroup: %1% and %2% both rewrote %3%; "
+                      "these passes cannot be fused",
+                      changedBy->name(), t->name(), n);
+            changedBy = t;
+            rv = result; } }
+    return rv;
+}
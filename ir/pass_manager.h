@@ -17,11 +17,259 @@ limitations under the License.
 #ifndef _IR_PASS_MANAGER_H_
 #define _IR_PASS_MANAGER_H_
 
+#include <map>
+#include <set>
+
 #include "visitor.h"
 
 typedef std::function<void(const char* manager, unsigned seqNo,
                            const char* pass, const IR::Node* node)> DebugHook;
 
+/** Collects per-pass instrumentation when enabled with --pass-profile=FILE:
+ * wall time, bytes allocated on the GC heap and in arenas, IR nodes created
+ * and visitor callbacks performed.  Every PassManager records a sample for
+ * each pass it runs (nested managers report their children too, with the
+ * nesting depth), and the accumulated records are written to FILE as JSON
+ * when the process exits. */
+class PassProfiler {
+    struct Record {
+        cstring     manager;
+        cstring     pass;
+        int         depth;
+        uint64_t    nsec;
+        uint64_t    gcBytes;
+        uint64_t    arenaBytes;
+        int         nodesCreated;
+        uint64_t    visits;
+        uint64_t    gcCollections;
+        uint64_t    gcPauseNsec;    // 0 when libgc can't report events
+        uint64_t    gcFreedBytes;   // ditto
+    };
+    static cstring                  outputFile;
+    static std::vector<Record>      records;
+    static int                      currentDepth;
+
+ public:
+    static void enable(cstring file);
+    static bool enabled() { return !outputFile.isNull(); }
+    /// Write the accumulated records to the file passed to enable().
+    static void write();
+
+    /// RAII sample around a single pass invocation.
+    class Sample {
+        cstring     manager;
+        cstring     pass;
+        uint64_t    startNsec, startGc, startArena, startVisits;
+        uint64_t    startCollections, startPause, startFreed;
+        int         startNodes;
+        bool        active;
+
+     public:
+        Sample(cstring manager, cstring pass);
+        ~Sample();
+    };
+};
+
+/** Collects heap usage when enabled with --memory-profile=FILE: a snapshot
+ * of heap size, heap watermark and cumulative allocation after every pass,
+ * plus periodic attributions of the live IR to node types (count and bytes
+ * per type, sized through the collector).  Attributions walk the whole
+ * program, so they are only taken when the heap has grown substantially
+ * since the last one; the snapshots pinpoint the pass, the attributions
+ * the node types that own the memory.  Everything is written to FILE as
+ * JSON when the process exits. */
+class MemoryProfiler {
+ public:
+    struct TypeUsage {
+        uint64_t    count = 0;
+        uint64_t    bytes = 0;
+    };
+
+ private:
+    struct Snapshot {
+        cstring     manager;
+        cstring     pass;
+        uint64_t    heapBytes;
+        uint64_t    heapWatermark;
+        uint64_t    allocatedBytes;     // cumulative, for per-pass deltas
+    };
+    struct Attribution {
+        cstring     pass;               // taken after this pass
+        uint64_t    heapBytes;
+        uint64_t    liveNodes;
+        uint64_t    liveBytes;
+        std::vector<std::pair<cstring, TypeUsage>> types;  // largest first
+    };
+    static cstring                  outputFile;
+    static std::vector<Snapshot>    snapshots;
+    static std::vector<Attribution> attributions;
+    static uint64_t                 lastAttributedHeap;
+
+ public:
+    static void enable(cstring file);
+    static bool enabled() { return !outputFile.isNull(); }
+    /// Write the accumulated data to the file passed to enable().
+    static void write();
+
+    /// Record a snapshot after @manager ran @pass producing @root; walks
+    /// @root attributing live nodes to their types when the heap has grown
+    /// enough since the last walk.
+    static void sample(cstring manager, cstring pass, const IR::Node *root);
+};
+
+/** Collects IR shape statistics when enabled with --ir-stats=FILE: after
+ * every pass, one walk over the resulting program records node counts by
+ * type, a histogram of node depths, the DAG sharing factor (tree size over
+ * distinct nodes -- shared subtrees count once per reference in the former)
+ * and the estimated live bytes.  Shared subtrees are pruned on revisit and
+ * accounted from memoized sizes, so the walk is linear in the distinct
+ * nodes, and passes that return their input unchanged (most of them) reuse
+ * the previous walk outright.  Written to FILE as JSON when the process
+ * exits; when a pass regression lands, this answers "which pass exploded
+ * the tree" in one run. */
+class IRStatistics {
+ public:
+    struct Stats {
+        uint64_t    distinctNodes = 0;
+        uint64_t    treeNodes = 0;      // shared subtrees counted per reference
+        uint64_t    bytes = 0;          // 0 when not built with libgc
+        size_t      maxDepth = 0;
+        std::vector<uint64_t> depthHistogram;  // distinct nodes by first-visit depth
+        std::vector<std::pair<cstring, uint64_t>> types;  // count per type, largest first
+    };
+
+ private:
+    struct Record {
+        cstring     manager;
+        cstring     pass;
+        Stats       stats;
+    };
+    static cstring                  outputFile;
+    static std::vector<Record>      records;
+    static int                      lastRoot;  // id of the last measured root
+    static Stats                    lastStats;
+
+ public:
+    static void enable(cstring file);
+    static bool enabled() { return !outputFile.isNull(); }
+    /// Write the accumulated records to the file passed to enable().
+    static void write();
+    /// Record the shape of @root after @manager ran @pass.
+    static void sample(cstring manager, cstring pass, const IR::Node *root);
+};
+
+/** Shared record of which top-level declarations were replaced as the
+ * program evolves, so that incremental analyses do not each have to
+ * reinvent change detection.  PassManager maintains it automatically:
+ * whenever a pass returns a new P4Program root, the top-level objects of
+ * the old and the new program are diffed by pointer (Transforms hand back
+ * the nodes they did not replace) and the names of the replaced, added or
+ * removed declarations are recorded.  A pass with more precise knowledge
+ * of what it changed may call record() itself; the manager's automatic
+ * record is then a no-op.
+ *
+ * A consumer that computed a result for an earlier root calls
+ * changedSince() with that root and the current one; on success it
+ * receives the accumulated set of dirty declaration names and can limit
+ * reprocessing to those.  Failure means the history between the two roots
+ * is unknown -- some replaced object had no name, or the root was produced
+ * outside a PassManager -- and the consumer must recompute from scratch.
+ *
+ * The history is keyed by node id, not node pointer, so it does not keep
+ * superseded programs alive.  It is only written between passes, on the
+ * main thread. */
+class DirtyRegions {
+    struct Change {
+        int                 prev;    // id of the root this one was derived from
+        std::set<cstring>   names;   // top-level declarations replaced
+    };
+    static std::map<int, Change> history;
+
+ public:
+    /// Record that root @from was rewritten into @to, replacing the
+    /// top-level declarations named in @names (computed by diffing the two
+    /// programs when @names is null).  No-ops unless both roots are
+    /// P4Programs; never overwrites an existing record for @to.
+    static void record(const IR::Node *from, const IR::Node *to,
+                       const std::set<cstring> *names = nullptr);
+    /// If the history covers the evolution of @baseline into @current, add
+    /// the names of all declarations dirtied on the way to @names and
+    /// return true.
+    static bool changedSince(const IR::Node *baseline, const IR::Node *current,
+                             std::set<cstring> *names);
+    /// As above, for consumers that only kept the baseline's node id (so
+    /// they do not keep the superseded program alive).
+    static bool changedSince(int baselineId, const IR::Node *current,
+                             std::set<cstring> *names);
+};
+
+/** A census of the node kinds present in a program, so that pass managers
+ * can skip passes that are statically inapplicable: a program without a
+ * single switch statement cannot need EliminateSwitch.  The first query for
+ * a root walks the program once; later queries stay cheap through
+ * DirtyRegions -- when the history proves that only some top-level
+ * declarations changed since the last censused root, only those are
+ * re-scanned.  The census is exact, never stale: when the evolution of a
+ * root is unknown it is simply recomputed.  See PassIfFeature for the
+ * consumer side. */
+class FeatureCensus {
+ public:
+    enum Feature : unsigned {
+        Parsers  = 1 << 0,  ///< parser declarations
+        Switches = 1 << 1,  ///< switch statements
+        Exits    = 1 << 2,  ///< exit statements
+        Returns  = 1 << 3,  ///< return statements
+        Enums    = 1 << 4,  ///< enum declarations
+        SerEnums = 1 << 5,  ///< serializable enum declarations
+        Tuples   = 1 << 6,  ///< tuple and list types
+        Varbits  = 1 << 7,  ///< varbit types
+    };
+    /// True if the program at @root contains any of @features.  A root that
+    /// is not a P4Program is conservatively reported as having them all.
+    static bool hasAny(const IR::Node *root, unsigned features);
+
+ private:
+    static int                          lastRoot;  // id of the last censused root
+    static std::map<cstring, unsigned>  perDecl;   // features per top-level declaration
+    static unsigned                     unnamed;   // features of unnamed objects
+    static unsigned collect(const IR::Node *root);
+};
+
+/** Implemented by holders of side state derived from the program (TypeMap,
+ * ReferenceMap, backend tables) so that PassManager::checkpoint can snapshot
+ * them along with the program.  The program itself never needs this -- IR
+ * immutability makes retaining the root pointer a complete snapshot -- but
+ * mutable side tables must be rolled back explicitly when a Backtrack-driven
+ * retry rewinds to an earlier program. */
+class ICheckpointable {
+ public:
+    /// @return a closure that, when invoked, restores the state this object
+    /// held at the time of the checkpoint() call.  The closure may be invoked
+    /// any number of times: a backtracking loop checkpoints once and restores
+    /// the same checkpoint on every retry.
+    virtual std::function<void()> checkpoint() = 0;
+    virtual ~ICheckpointable() {}
+};
+
+/** A point-in-time snapshot of a compilation taken by PassManager::checkpoint
+ * and rewound by PassManager::restore.  Holds the program root (which, the IR
+ * being immutable, keeps the whole checkpointed tree valid whatever later
+ * passes build), one restore closure per registered ICheckpointable, and the
+ * arena region opened at the checkpoint when arena allocation is in use. */
+class Checkpoint {
+    const IR::Node                      *node = nullptr;
+    std::size_t                         arenaRegion = 0;
+    bool                                ownsArenaRegion = false;
+    std::vector<std::function<void()>>  restorers;
+    friend class PassManager;
+
+ public:
+    Checkpoint() = default;
+    /// The program this checkpoint was taken at, or null if default-constructed.
+    const IR::Node *program() const { return node; }
+    explicit operator bool() const { return node != nullptr; }
+};
+
 class PassManager : virtual public Visitor, virtual public Backtrack {
     bool early_exit_flag;
     mutable int never_backtracks_cache = -1;
@@ -29,6 +277,7 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
  protected:
     safe_vector<DebugHook>   debugHooks;  // called after each pass
     safe_vector<Visitor *>   passes;
+    safe_vector<ICheckpointable *> checkpointables;  // caller-owned side state
     // if true stops compilation after first pass that signals an error
     bool                stop_on_error = true;
     bool                running = false;
@@ -76,6 +325,21 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
     bool backtrack(trigger &trig) override;
     bool never_backtracks() override;
     void setStopOnError(bool stop) { stop_on_error = stop; }
+    /// Register caller-owned side state to be snapshotted by checkpoint() and
+    /// rolled back by restore().  The manager does not take ownership; @state
+    /// must outlive every checkpoint taken after this call.
+    void addCheckpointable(ICheckpointable *state) { checkpointables.push_back(state); }
+    /// Record a checkpoint at @current.  The program snapshot is free (the
+    /// root pointer is retained); each registered ICheckpointable contributes
+    /// a restore closure; and when --arena-alloc is in effect a fresh arena
+    /// region is opened, so nodes built after the checkpoint can be released
+    /// wholesale when it is restored.
+    Checkpoint checkpoint(const IR::Node *current) const;
+    /// Rewind to @cp: reinstate the registered side state, release every IR
+    /// node arena-allocated since the checkpoint, and @return the
+    /// checkpointed program.  May be called repeatedly on the same
+    /// checkpoint; the typical backtrack loop restores once per retry.
+    const IR::Node *restore(Checkpoint &cp);
     void addDebugHook(DebugHook h, bool recursive = false) {
         debugHooks.push_back(h);
         if (recursive)
@@ -119,6 +383,48 @@ class PassRepeated : virtual public PassManager {
     PassRepeated *clone() const override { return new PassRepeated(*this); }
 };
 
+/** Runs a group of analysis-only passes concurrently against the same tree.
+ * All passes in the group must be Inspectors (checked at apply time) and must
+ * be side-effect-free apart from updating their own state and reporting
+ * diagnostics; the tree is shared read-only between the workers.  Diagnostics
+ * are buffered per pass in a sequenced ErrorReporter section and merged in
+ * pass order when the group joins, so the output is byte-identical to a
+ * sequential run regardless of scheduling.  Worker threads are registered
+ * with the collector for the duration of the group. */
+class ParallelPassGroup : virtual public PassManager {
+ public:
+    ParallelPassGroup(const std::initializer_list<VisitorRef> &init)   // NOLINT(runtime/explicit)
+    : PassManager(init) {}
+    const IR::Node *apply_visitor(const IR::Node *, const char * = 0) override;
+    ParallelPassGroup *clone() const override { return new ParallelPassGroup(*this); }
+};
+
+/** Applies several Transforms in a single traversal of the tree.  Each
+ * node passes through every member's preorder (and, after the children,
+ * every member's postorder) in the order given, so the group pays for one
+ * tree walk with one round of clone/compare bookkeeping instead of one
+ * per pass.
+ *
+ * The members must be fusible: the sets of node types they rewrite must
+ * be disjoint, and no member may depend on seeing rewrites another member
+ * makes elsewhere in the tree (each node is seen by all members at the
+ * same moment, not in pass order).  The caller asserts this by grouping
+ * the passes; a BUG is raised at runtime if two members rewrite the same
+ * node.  Members share the group's visitor context, so getOriginal,
+ * findContext and friends behave as usual; a member calling prune()
+ * prunes the shared traversal for the whole group. */
+class FusedTransformGroup : public Transform {
+    safe_vector<Transform *>    passes;
+    std::vector<profile_t>      *profiles = nullptr;  // keeps member passes open
+ public:
+    FusedTransformGroup(const std::initializer_list<Transform *> &init);  // NOLINT(runtime/explicit)
+    profile_t init_apply(const IR::Node *root) override;
+    void end_apply(const IR::Node *root) override;
+    const IR::Node *preorder(IR::Node *n) override;
+    const IR::Node *postorder(IR::Node *n) override;
+    FusedTransformGroup *clone() const override { return new FusedTransformGroup(*this); }
+};
+
 class PassRepeatUntil : virtual public PassManager {
     std::function<bool()>       done;
  public:
@@ -140,6 +446,18 @@ class PassIf : virtual public PassManager {
     PassIf *clone() const override { return new PassIf(*this); }
 };
 
+/** Runs its passes only when the program contains at least one of the given
+ * features (see FeatureCensus).  Wrapping a pass group this way asserts that
+ * the group is a no-op on programs without those features. */
+class PassIfFeature : virtual public PassManager {
+    unsigned    features;
+ public:
+    PassIfFeature(unsigned features, const std::initializer_list<VisitorRef> &init)
+    : PassManager(init), features(features) {}
+    const IR::Node *apply_visitor(const IR::Node *, const char * = 0) override;
+    PassIfFeature *clone() const override { return new PassIfFeature(*this); }
+};
+
 // Converts a function Node* -> Node* into a visitor
 class VisitFunctor : virtual public Visitor {
     std::function<const IR::Node *(const IR::Node *)>       fn;
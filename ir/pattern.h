@@ -17,6 +17,14 @@ limitations under the License.
 #ifndef IR_PATTERN_H_
 #define IR_PATTERN_H_
 
+#include <functional>
+#include <initializer_list>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "ir/ir.h"
 
 /**
@@ -29,6 +37,10 @@ class Pattern {
     class Base {
      public:
         virtual bool match(const IR::Node *) = 0;
+        /// The exact IR class a successful match requires the root node to
+        /// be, or null when the pattern can match more than one class (a
+        /// binder or a base-class match); used by PatternTable dispatch.
+        virtual const std::type_info *rootType() const { return nullptr; }
     } *pattern;
     Pattern(Base *p) : pattern(p) {}
 
@@ -46,9 +58,39 @@ class Pattern {
             if (auto k = n->to<IR::Constant>())
                 return k->value == value;
             return false; }
+        const std::type_info *rootType() const override { return &typeid(IR::Constant); }
         Const(big_int v) : value(v) {}
         Const(int v) : value(v) {}
     };
+    class ConstPred : public Base {
+        const IR::Constant **bind;
+        std::function<bool(const IR::Constant *)> pred;
+     public:
+        bool match(const IR::Node *n) override {
+            auto k = n->to<IR::Constant>();
+            if (!k || !pred(k)) return false;
+            if (bind) *bind = k;
+            return true; }
+        const std::type_info *rootType() const override { return &typeid(IR::Constant); }
+        explicit ConstPred(std::function<bool(const IR::Constant *)> p)
+            : bind(nullptr), pred(p) {}
+        ConstPred(const IR::Constant *&m, std::function<bool(const IR::Constant *)> p)
+            : bind(&m), pred(p) {}
+    };
+    class BoolLit : public Base {
+        bool value;
+     public:
+        bool match(const IR::Node *n) override {
+            if (auto b = n->to<IR::BoolLiteral>())
+                return b->value == value;
+            return false; }
+        const std::type_info *rootType() const override { return &typeid(IR::BoolLiteral); }
+        explicit BoolLit(bool v) : value(v) {}
+    };
+    class Any : public Base {
+     public:
+        bool match(const IR::Node *) override { return true; }
+    };
     template<class T> class Unary : public Base {
         Base *expr;
      public:
@@ -56,6 +98,7 @@ class Pattern {
             if (auto b = n->to<T>())
                 return expr->match(b->expr);
             return false; }
+        const std::type_info *rootType() const override { return &typeid(T); }
         Unary(Base *e) : expr(e) {}
     };
     template<class T> class Binary : public Base {
@@ -69,6 +112,7 @@ class Pattern {
                 if (commutative && left->match(b->right) && right->match(b->left))
                     return true; }
             return false; }
+        const std::type_info *rootType() const override { return &typeid(T); }
         Binary(Base *l, Base *r, bool commute = false) : left(l), right(r), commutative(commute) {}
     };
 
@@ -104,12 +148,29 @@ class Pattern {
         Pattern operator-(int a) { return Pattern(*this) - Pattern(a); }
         Pattern operator==(int a) { return Pattern(*this) == Pattern(a); }
         Pattern operator!=(int a) { return Pattern(*this) != Pattern(a); }
+        // without these, a bool literal would silently convert to int and
+        // build an IR::Constant pattern instead of an IR::BoolLiteral one
+        Pattern operator==(bool a) { return Pattern(*this) == Pattern(a); }
+        Pattern operator!=(bool a) { return Pattern(*this) != Pattern(a); }
     };
 
     template <class T> Pattern(const T*&m) : pattern(new MatchExt<T>(m)) {}
     template <class T>Pattern(Match<T> &m) : pattern(&m) {}
     Pattern(big_int v) : pattern(new Const(v)) {}     // NOLINT(runtime/explicit)
     Pattern(int v) : pattern(new Const(v)) {}           // NOLINT(runtime/explicit)
+    Pattern(bool v) : pattern(new BoolLit(v)) {}        // NOLINT(runtime/explicit)
+    /// Matches an IR::Constant satisfying @pred.  Unlike testing a bound
+    /// constant after the fact, the predicate participates in matching, so
+    /// a commutative operator above it retries the swapped operand order
+    /// when the predicate rejects one side.
+    explicit Pattern(std::function<bool(const IR::Constant *)> pred)
+        : pattern(new ConstPred(pred)) {}
+    /// As above, additionally binding the matched constant to @m.
+    Pattern(const IR::Constant *&m, std::function<bool(const IR::Constant *)> pred)
+        : pattern(new ConstPred(m, pred)) {}
+    /// Matches any node; gives structural patterns "don't care" positions
+    /// without needing a binder.
+    static Pattern any() { return Pattern(new Any); }
     Pattern operator-() const { return Pattern(new Unary<IR::Neg>(pattern)); }
     Pattern operator~() const { return Pattern(new Unary<IR::Cmpl>(pattern)); }
     Pattern operator!() const { return Pattern(new Unary<IR::LNot>(pattern)); }
@@ -151,6 +212,8 @@ class Pattern {
         return Pattern(new Binary<IR::LOr>(pattern, r.pattern)); }
 
     bool match(const IR::Node *n) { return pattern->match(n); }
+    /// See Base::rootType(); null unless the root is a single concrete class.
+    const std::type_info *rootType() const { return pattern->rootType(); }
 };
 
 inline Pattern operator*(int v, const Pattern &a) { return Pattern(v) * a; }
@@ -172,5 +235,58 @@ inline Pattern operator^(int v, const Pattern &a) { return Pattern(v) ^ a; }
 inline Pattern operator&&(int v, const Pattern &a) { return Pattern(v) && a; }
 inline Pattern operator||(int v, const Pattern &a) { return Pattern(v) || a; }
 
+/**
+ * A set of alternative Patterns matched against the same node, with actions.
+ *
+ * Rewrite code that tries many patterns in sequence re-tests the node's type
+ * once per alternative, recreating the else-if dynamic_cast ladders Patterns
+ * are meant to replace.  A PatternTable instead buckets its alternatives by
+ * the exact IR class their root matches (Pattern::rootType()) and dispatches
+ * with a single typeid lookup, so only the alternatives that can possibly
+ * match are tried.  Alternatives whose root is a binder or a base class go
+ * to a generic list that is always tried, after the bucketed ones.
+ *
+ * A table is meant to be built once (e.g. as a function-local static) and
+ * applied to many nodes, so its patterns must be binder-free: a binder
+ * writes through a reference captured when the pattern was built, which
+ * would dangle on later applications.  Actions receive the matched node and
+ * extract operands from it directly; an action may decline by returning
+ * null, in which case the remaining alternatives are tried.
+ */
+class PatternTable {
+ public:
+    typedef std::function<const IR::Node *(const IR::Node *)> Action;
+
+ private:
+    struct Alternative {
+        Pattern pattern;
+        Action  action;
+    };
+    std::unordered_map<std::type_index, std::vector<Alternative>> byType;
+    std::vector<Alternative> generic;
+
+ public:
+    PatternTable() = default;
+    PatternTable(std::initializer_list<std::pair<Pattern, Action>> init) {
+        for (auto &alt : init) add(alt.first, alt.second); }
+    PatternTable &add(Pattern pattern, Action action) {
+        if (auto *type = pattern.rootType())
+            byType[std::type_index(*type)].push_back(Alternative{pattern, action});
+        else
+            generic.push_back(Alternative{pattern, action});
+        return *this; }
+    /// Try the alternatives that can match @n in insertion order; @return
+    /// the first non-null action result, or null if nothing matched.
+    const IR::Node *apply(const IR::Node *n) {
+        auto it = byType.find(std::type_index(typeid(*n)));
+        if (it != byType.end())
+            for (auto &alt : it->second)
+                if (alt.pattern.match(n))
+                    if (auto *rv = alt.action(n)) return rv;
+        for (auto &alt : generic)
+            if (alt.pattern.match(n))
+                if (auto *rv = alt.action(n)) return rv;
+        return nullptr; }
+};
 
 #endif /* IR_PATTERN_H_ */
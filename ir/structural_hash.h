@@ -0,0 +1,67 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _IR_STRUCTURAL_HASH_H_
+#define _IR_STRUCTURAL_HASH_H_
+
+#include <cstdint>
+#include <type_traits>
+
+#include "lib/cstring.h"
+#include "lib/gmputil.h"
+#include "id.h"
+
+namespace IR {
+
+/* Helpers used by the generated computeHash methods (see
+ * tools/ir-generator/methods.cpp) to fold one field into a node's structural
+ * hash.  The overload set must stay consistent with what the generated
+ * 'equiv' compares: whenever equiv considers two fields equal, hash_combine
+ * must produce the same value for both.  Field types with no overload fall
+ * through to the catch-all at the bottom and are left out of the hash
+ * entirely, which weakens the filter but never its soundness. */
+
+inline uint64_t hash_combine(uint64_t h, uint64_t v) {
+    // 64-bit analogue of boost::hash_combine
+    return h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 12) + (h >> 4)); }
+
+template<class T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value,
+                               uint64_t>::type
+hash_combine(uint64_t h, T v) { return hash_combine(h, static_cast<uint64_t>(v)); }
+
+// cstrings are interned, so the pointer identifies the contents
+inline uint64_t hash_combine(uint64_t h, cstring s) {
+    return hash_combine(h, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(s.c_str()))); }
+
+// must match ID::operator==, which ignores srcInfo and originalName
+inline uint64_t hash_combine(uint64_t h, const ID &id) {
+    return hash_combine(h, id.name); }
+
+// the sign and the low 64 bits are plenty for a filter
+inline uint64_t hash_combine(uint64_t h, const big_int &v) {
+    big_int lo = (v < 0 ? big_int(-v) : v) & 0xffffffffffffffffULL;
+    h = hash_combine(h, lo.convert_to<uint64_t>());
+    return hash_combine(h, static_cast<uint64_t>(v < 0)); }
+
+template<class T>
+inline typename std::enable_if<!std::is_integral<T>::value && !std::is_enum<T>::value,
+                               uint64_t>::type
+hash_combine(uint64_t h, const T &) { return h; }
+
+}  // namespace IR
+
+#endif /* _IR_STRUCTURAL_HASH_H_ */
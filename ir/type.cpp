@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <mutex>
 #include <utility>
 #include "ir.h"
 #include "configuration.h"
@@ -51,44 +52,47 @@ const cstring IR::Annotation::noSideEffectsAnnotation = "noSideEffects";
 const cstring IR::Annotation::noWarnAnnotation = "noWarn";
 const cstring IR::Annotation::matchAnnotation = "match";
 
-int Type_Declaration::nextId = 0;
-int Type_InfInt::nextId = 0;
+std::atomic<int> Type_Declaration::nextId(0);
+std::atomic<int> Type_InfInt::nextId(0);
 
 Annotations* Annotations::empty = new Annotations(Vector<Annotation>());
 
 const Type_Bits* Type_Bits::get(int width, bool isSigned) {
     // map (width, signed) to type
     using bit_type_key = std::pair<int, bool>;
-    static std::map<bit_type_key, const IR::Type_Bits*> *type_map = nullptr;
-    if (type_map == nullptr)
-        type_map = new std::map<bit_type_key, const IR::Type_Bits*>();
-    auto &result = (*type_map)[std::make_pair(width, isSigned)];
-    if (!result)
-        result = new Type_Bits(width, isSigned);
+    static auto *type_map = new std::map<bit_type_key, const IR::Type_Bits*>();
+    static std::mutex type_map_mutex;
+    const IR::Type_Bits* result;
+    {
+        // TypeInference workers (--parallel-typecheck) call this
+        // concurrently; the cache must not be mutated unsynchronized.
+        std::lock_guard<std::mutex> lock(type_map_mutex);
+        auto &slot = (*type_map)[std::make_pair(width, isSigned)];
+        if (!slot)
+            slot = new Type_Bits(width, isSigned);
+        result = slot;
+    }
     if (width > P4CConfiguration::MaximumWidthSupported)
         ::error(ErrorType::ERR_UNSUPPORTED, "%1%: Compiler only supports widths up to %2%",
                 result, P4CConfiguration::MaximumWidthSupported);
     return result;
 }
 
+// The lazy singletons below rely on C++11 thread-safe initialization of
+// function-local statics, so they are safe to call from worker threads.
+
 const Type::Unknown *Type::Unknown::get() {
-    static const Type::Unknown *singleton = nullptr;
-    if (!singleton)
-        singleton = (new Type::Unknown());
+    static const Type::Unknown *singleton = new Type::Unknown();
     return singleton;
 }
 
 const Type::Boolean *Type::Boolean::get() {
-    static const Type::Boolean *singleton = nullptr;
-    if (!singleton)
-        singleton = (new Type::Boolean());
+    static const Type::Boolean *singleton = new Type::Boolean();
     return singleton;
 }
 
 const Type_String *Type_String::get() {
-    static const Type_String *singleton = nullptr;
-    if (!singleton)
-        singleton = (new Type_String());
+    static const Type_String *singleton = new Type_String();
     return singleton;
 }
 
@@ -109,30 +113,22 @@ const Type::Varbits *Type::Varbits::get() {
 }
 
 const Type_Dontcare *Type_Dontcare::get() {
-    static const Type_Dontcare *singleton;
-    if (!singleton)
-        singleton = (new Type_Dontcare());
+    static const Type_Dontcare *singleton = new Type_Dontcare();
     return singleton;
 }
 
 const Type_State *Type_State::get() {
-    static const Type_State *singleton;
-    if (!singleton)
-        singleton = (new Type_State());
+    static const Type_State *singleton = new Type_State();
     return singleton;
 }
 
 const Type_Void *Type_Void::get() {
-    static const Type_Void *singleton;
-    if (!singleton)
-        singleton = (new Type_Void());
+    static const Type_Void *singleton = new Type_Void();
     return singleton;
 }
 
 const Type_MatchKind *Type_MatchKind::get() {
-    static const Type_MatchKind *singleton;
-    if (!singleton)
-        singleton = (new Type_MatchKind());
+    static const Type_MatchKind *singleton = new Type_MatchKind();
     return singleton;
 }
 
@@ -18,9 +18,11 @@ limitations under the License.
 #define _IR_VECTOR_H_
 
 #include "dbprint.h"
+#include "structural_hash.h"
 #include "lib/enumerator.h"
 #include "lib/null.h"
 #include "lib/safe_vector.h"
+#include "lib/small_vector.h"
 
 class JSONLoader;
 
@@ -52,7 +54,10 @@ class VectorBase : public Node {
 // User-level code should use regular std::vector
 template<class T>
 class Vector : public VectorBase {
-    safe_vector<const T *>   vec;
+    // inline storage for the common case: most statement and parameter
+    // lists hold only a few elements, and the Transform clone paths copy
+    // these vectors far too often to pay for a heap buffer each time
+    small_vector<const T *>   vec;
 
  public:
     typedef const T* value_type;
@@ -68,24 +73,27 @@ class Vector : public VectorBase {
         vec.insert(vec.end(), a.begin(), a.end()); }
     Vector(const std::initializer_list<const T *> &a) : vec(a) {}
     static Vector<T>* fromJSON(JSONLoader &json);
-    typedef typename safe_vector<const T *>::iterator        iterator;
-    typedef typename safe_vector<const T *>::const_iterator  const_iterator;
+    typedef typename small_vector<const T *>::iterator        iterator;
+    typedef typename small_vector<const T *>::const_iterator  const_iterator;
     iterator begin() { return vec.begin(); }
     const_iterator begin() const { return vec.begin(); }
     VectorBase::iterator VectorBase_begin() const override {
         /* DANGER -- works as long as IR::Node is the first ultimate base class of T */
-        return reinterpret_cast<VectorBase::iterator>(&vec[0]); }
+        return reinterpret_cast<VectorBase::iterator>(vec.begin()); }
     iterator end() { return vec.end(); }
     const_iterator end() const { return vec.end(); }
     VectorBase::iterator VectorBase_end() const override {
         /* DANGER -- works as long as IR::Node is the first ultimate base class of T */
-        return reinterpret_cast<VectorBase::iterator>(&vec[0] + vec.size()); }
+        return reinterpret_cast<VectorBase::iterator>(vec.end()); }
     std::reverse_iterator<iterator> rbegin() { return vec.rbegin(); }
     std::reverse_iterator<const_iterator> rbegin() const { return vec.rbegin(); }
     std::reverse_iterator<iterator> rend() { return vec.rend(); }
     std::reverse_iterator<const_iterator> rend() const { return vec.rend(); }
     size_t size() const override { return vec.size(); }
     void resize(size_t sz) { vec.resize(sz); }
+    /// Pre-size the backing store before a series of appends, so splicing
+    /// several containers together reallocates at most once.
+    void reserve(size_t n) { vec.reserve(n); }
     bool empty() const override { return vec.empty(); }
     const T* const & front() const { return vec.front(); }
     const T*& front() { return vec.front(); }
@@ -103,6 +111,13 @@ class Vector : public VectorBase {
     template<typename Container>
     iterator append(const Container &toAppend)
     { return insert(end(), toAppend.begin(), toAppend.end()); }
+    /// Steals the elements of an expiring vector instead of copying them;
+    /// used on the freshly created vectors of the Transform clone paths.
+    iterator append(Vector &&toAppend) {
+        if (vec.empty()) {
+            vec = std::move(toAppend.vec);
+            return vec.begin(); }
+        return insert(end(), toAppend.vec.begin(), toAppend.vec.end()); }
     template<typename Container>
     iterator prepend(const Container &toAppend)
     { return insert(begin(), toAppend.begin(), toAppend.end()); }
@@ -176,6 +191,16 @@ class Vector : public VectorBase {
         auto it = a.begin();
         for (auto *el : *this) if (!el->equiv(**it++)) return false;
         return true; }
+    /* vectors are legitimately grown in place while a tree is being built, so
+     * their hash is never cached; it is cheap to recompute from the (cached)
+     * hashes of the elements.  The elementwise structure must stay consistent
+     * with equiv above. */
+    bool cacheHash() const override { return false; }
+    uint64_t computeHash() const override {
+        uint64_t h = Node::computeHash();
+        h = hash_combine(h, size());
+        for (auto *el : vec) h = hash_combine(h, el->structuralHash());
+        return h; }
     cstring node_type_name() const override {
         return "Vector<" + T::static_type_name() + ">"; }
     static cstring static_type_name() {
@@ -186,7 +211,7 @@ class Vector : public VectorBase {
     virtual void parallel_visit_children(Visitor &v) const;
     void toJSON(JSONGenerator &json) const override;
     Util::Enumerator<const T*>* getEnumerator() const {
-        return Util::Enumerator<const T*>::createEnumerator(vec); }
+        return Util::Enumerator<const T*>::createEnumerator(vec.begin(), vec.end()); }
     template <typename S>
     Util::Enumerator<const S*>* only() const {
         std::function<bool(const T*)> filter = [](const T* d) { return d->template is<S>(); };
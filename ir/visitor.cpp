@@ -15,8 +15,11 @@ limitations under the License.
 */
 
 #include <time.h>
+#include <deque>
+#include <vector>
 #include "ir.h"
 #include "lib/log.h"
+#include "lib/tracepoints.h"
 
 /** @class Visitor::ChangeTracker
  *  @brief Assists visitors in traversing the IR.
@@ -28,11 +31,13 @@ limitations under the License.
  */
 class Visitor::ChangeTracker {
     struct visit_info_t {
+        bool            present;
         bool            visit_in_progress;
         bool            visitOnce;
         const IR::Node  *result;
     };
-    typedef std::unordered_map<const IR::Node *, visit_info_t>  visited_t;
+    // indexed by node id -- no hashing, and entries have stable addresses
+    typedef NodeIdInfoMap<visit_info_t>  visited_t;
     visited_t           visited;
 
  public:
@@ -40,17 +45,13 @@ class Visitor::ChangeTracker {
      * visited once the pass completes.
      */
     void start(const IR::Node *n, bool defaultVisitOnce) {
-        // Initialization
-        visited_t::iterator visited_it;
-        bool inserted;
-        bool visit_in_progress = true;
-        std::tie(visited_it, inserted) =
-            visited.emplace(n, visit_info_t{visit_in_progress, defaultVisitOnce, n});
+        visit_info_t &visit_info = visited[n->id];
+        if (!visit_info.present) {
+            visit_info = visit_info_t{true, true, defaultVisitOnce, n};
+            return; }
 
         // Sanity check for IR loops
-        bool already_present = !inserted;
-        visit_info_t *visit_info = &(visited_it->second);
-        if (already_present && visit_info->visit_in_progress)
+        if (visit_info.visit_in_progress)
             BUG("IR loop detected ");
     }
 
@@ -62,26 +63,31 @@ class Visitor::ChangeTracker {
      * If @final is a new node, that node is marked as finished as well, as if
      * `start(@final); finish(@final);` were invoked.
      *
+     * A caller that already knows some child of @orig was replaced passes
+     * @childChanged = true; a changed child pointer makes @final compare
+     * unequal to @orig anyway, so the field-by-field comparison is skipped.
+     *
      * @return true if the node has changed or been removed or coalesced.
      * 
      * @exception Util::CompilerBug This method fails if `start(@orig)` has not
      * previously been invoked.
      */
-    bool finish(const IR::Node *orig, const IR::Node *final) {
-        auto it = visited.find(orig);
-        if (it == visited.end())
+    bool finish(const IR::Node *orig, const IR::Node *final, bool childChanged = false) {
+        auto *orig_visit_info = visited.find(orig->id);
+        if (!orig_visit_info || !orig_visit_info->present)
             BUG("visitor state tracker corrupted");
 
-        visit_info_t *orig_visit_info = &(it->second);
         orig_visit_info->visit_in_progress = false;
         if (!final) {
             orig_visit_info->result = final;
             return true;
-        } else if (final != orig && *final != *orig) {
+        } else if (final != orig && (childChanged || *final != *orig)) {
             orig_visit_info->result = final;
-            visited.emplace(final, visit_info_t{false, orig_visit_info->visitOnce, final});
+            auto &final_info = visited[final->id];
+            if (!final_info.present)
+                final_info = visit_info_t{true, false, orig_visit_info->visitOnce, final};
             return true;
-        } else if (visited.count(final)) {
+        } else if (final != orig && visited.find(final->id) && visited.find(final->id)->present) {
             // coalescing with some previously visited node, so we don't want to undo
             // the coalesce
             orig_visit_info->result = final;
@@ -95,19 +101,18 @@ class Visitor::ChangeTracker {
     /** Return a pointer to the visitOnce flag for node @n so that it can be changed
      */
     bool *refVisitOnce(const IR::Node *n) {
-        if (!visited.count(n))
+        auto *info = visited.find(n->id);
+        if (!info || !info->present)
             BUG("visitor state tracker corrupted");
-        return &visited.at(n).visitOnce;
+        return &info->visitOnce;
     }
 
     /** Forget nodes that have already been visited, allowing them to be visited
      * again. */
     void revisit_visited() {
-        for (auto it = visited.begin(); it != visited.end();) {
-            if (!it->second.visit_in_progress)
-                it = visited.erase(it);
-            else
-                ++it; } }
+        visited.forall([](visit_info_t &info) {
+            if (!info.visit_in_progress)
+                info.present = false; }); }
 
     /** Determine whether @n has been visited and the visitor has finished
      *  and we don't want to visit @n again the next time we see it.
@@ -117,8 +122,8 @@ class Visitor::ChangeTracker {
      * @return true if @n has been visited and the visitor is finished and visitOnce is true
      */
     bool done(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && !it->second.visit_in_progress && it->second.visitOnce;
+        auto *info = visited.find(n->id);
+        return info && info->present && !info->visit_in_progress && info->visitOnce;
     }
 
     /** Produce the result of visiting @n.
@@ -128,12 +133,15 @@ class Visitor::ChangeTracker {
      * if `start(@n)` has not been invoked.
      */
     const IR::Node *result(const IR::Node *n) const {
-        if (!visited.count(n))
+        auto *info = visited.find(n->id);
+        if (!info || !info->present)
             return n;
-        return visited.at(n).result;
+        return info->result;
     }
 };
 
+uint64_t Visitor::total_visits = 0;
+
 Visitor::profile_t Visitor::init_apply(const IR::Node *root) {
     ctxt = nullptr;
     if (joinFlows) init_join_flows(root);
@@ -225,6 +233,7 @@ struct PushContext {
         current.node = current.original = node;
         current.child_index = 0;
         current.child_name = "";
+        current.child_changed = false;
         current.depth = stack ? stack->depth+1 : 1;
         assert(current.depth < 10000);    // stack overflow?
         stack = &current; }
@@ -244,7 +253,9 @@ class ForwardChildren : public Visitor {
 }    // namespace
 
 const IR::Node *Modifier::apply_visitor(const IR::Node *n, const char *name) {
+    ++total_visits;
     if (ctxt) ctxt->child_name = name;
+    const IR::Node *input = n;
     if (n) {
         PushContext local(ctxt, n);
         if (visited->done(n)) {
@@ -258,38 +269,46 @@ const IR::Node *Modifier::apply_visitor(const IR::Node *n, const char *name) {
                 ForwardChildren forward_children(*visited);
                 copy->visit_children(forward_children); }
             visitCurrentOnce = visited->refVisitOnce(n);
+            P4C_PROBE2(visit_node, n->node_type_name().c_str(), n->id);
             if (copy->apply_visitor_preorder(*this)) {
                 copy->visit_children(*this);
                 visitCurrentOnce = visited->refVisitOnce(n);
                 copy->apply_visitor_postorder(*this); }
-            if (visited->finish(n, copy))
+            if (visited->finish(n, copy, local.current.child_changed))
                 (n = copy)->validate(); } }
-    if (ctxt)
+    if (ctxt) {
         ctxt->child_index++;
-    else
-        visited = nullptr;
+        if (n != input)
+            ctxt->child_changed = true;
+    } else {
+        visited = nullptr; }
     return n;
 }
 
 const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
+    if (iterativeTraversal && !ctxt && n && !joinFlows)
+        return apply_iterative(n, name);
+    ++total_visits;
     if (ctxt) ctxt->child_name = name;
     if (n && !join_flows(n)) {
         PushContext local(ctxt, n);
-        auto vp = visited->emplace(n, info_t{false, visitDagOnce});
-        if (!vp.second && !vp.first->second.done)
+        info_t &info = (*visited)[n->id];
+        bool seen = info.present;
+        if (!seen)
+            info = info_t{true, false, visitDagOnce};
+        else if (!info.done)
             BUG("IR loop detected");
-        if (!vp.second && vp.first->second.visitOnce) {
+        if (seen && info.visitOnce) {
             n->apply_visitor_revisit(*this);
         } else {
-            vp.first->second.done = false;
-            visitCurrentOnce = &vp.first->second.visitOnce;
+            info.done = false;
+            visitCurrentOnce = &info.visitOnce;
+            P4C_PROBE2(visit_node, n->node_type_name().c_str(), n->id);
             if (n->apply_visitor_preorder(*this)) {
                 n->visit_children(*this);
-                visitCurrentOnce = &vp.first->second.visitOnce;
+                visitCurrentOnce = &info.visitOnce;
                 n->apply_visitor_postorder(*this); }
-            if (vp.first != visited->find(n))
-                BUG("visitor state tracker corrupted");
-            vp.first->second.done = true; } }
+            info.done = true; } }
     if (ctxt)
         ctxt->child_index++;
     else
@@ -297,8 +316,115 @@ const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
     return n;
 }
 
+/* Explicit-stack traversal engine behind Inspector::iterativeTraversal.
+ * Each Frame holds the visitor Context and the pending children of one node
+ * whose preorder has run, so the loop below replaces the per-node C++ call
+ * frames of the recursive engine and tree depth is bounded by heap memory
+ * instead of the thread stack.  Frames live in a deque because it grows
+ * without relocating live elements, which keeps the Context parent chain
+ * threaded through the frames valid.  Children are listed one level at a
+ * time by running the node's own visit_children with a forwarding visitor
+ * that records instead of descending, so hand-written visit_children bodies
+ * keep their visit order. */
+const IR::Node *Inspector::apply_iterative(const IR::Node *root, const char *name) {
+    struct Child { const IR::Node *node; const char *name; };
+    class Collector : public Visitor {
+        std::vector<Child> &out;
+        Context scratch;
+        const IR::Node *apply_visitor(const IR::Node *n, const char *name = 0) override {
+            if (n) out.push_back(Child{n, name});
+            return n; }
+     public:
+        explicit Collector(std::vector<Child> &out) : out(out) {
+            scratch.parent = nullptr;
+            scratch.node = scratch.original = nullptr;
+            scratch.child_index = 0;
+            scratch.child_name = "";
+            scratch.child_changed = false;
+            scratch.depth = 0;
+            // the visit(n, name, cidx) overloads write through ctxt
+            ctxt = &scratch; }
+    };
+    struct Frame {
+        Context             ctx;
+        info_t              *info;
+        std::vector<Child>  children;
+        size_t              next = 0;
+        bool                postorderPending = false;
+    };
+    std::deque<Frame> stack;
+    std::vector<Child> collected;
+    Collector collect(collected);
+
+    // The per-node logic of the recursive apply_visitor: preorder runs here,
+    // children and postorder go through the work stack.
+    auto open = [&](const IR::Node *n, const char *childName) {
+        ++total_visits;
+        if (ctxt) ctxt->child_name = childName;
+        if (n && !join_flows(n)) {
+            info_t &info = (*visited)[n->id];
+            bool seen = info.present;
+            if (!seen)
+                info = info_t{true, false, visitDagOnce};
+            else if (!info.done)
+                BUG("IR loop detected");
+            if (seen && info.visitOnce) {
+                Context local;
+                local.parent = ctxt;
+                local.node = local.original = n;
+                local.child_index = 0;
+                local.child_name = "";
+                local.child_changed = false;
+                local.depth = ctxt ? ctxt->depth + 1 : 1;
+                ctxt = &local;
+                n->apply_visitor_revisit(*this);
+                ctxt = local.parent;
+            } else {
+                info.done = false;
+                stack.emplace_back();
+                Frame &f = stack.back();
+                f.ctx.parent = ctxt;
+                f.ctx.node = f.ctx.original = n;
+                f.ctx.child_index = 0;
+                f.ctx.child_name = "";
+                f.ctx.child_changed = false;
+                f.ctx.depth = ctxt ? ctxt->depth + 1 : 1;
+                f.info = &info;
+                ctxt = &f.ctx;
+                visitCurrentOnce = &info.visitOnce;
+                P4C_PROBE2(visit_node, n->node_type_name().c_str(), n->id);
+                if (n->apply_visitor_preorder(*this)) {
+                    f.postorderPending = true;
+                    collected.clear();
+                    n->visit_children(collect);
+                    f.children.swap(collected); }
+                // the parent's child_index advances when this frame pops
+                return; } }
+        if (ctxt) ctxt->child_index++;
+    };
+
+    open(root, name);
+    while (!stack.empty()) {
+        Frame &f = stack.back();
+        if (f.next < f.children.size()) {
+            auto &c = f.children[f.next++];
+            open(c.node, c.name);
+        } else {
+            if (f.postorderPending) {
+                visitCurrentOnce = &f.info->visitOnce;
+                f.ctx.node->apply_visitor_postorder(*this); }
+            f.info->done = true;
+            ctxt = f.ctx.parent;
+            stack.pop_back();
+            if (ctxt) ctxt->child_index++; } }
+    visited = nullptr;  // matches the root-visit epilogue of the recursive engine
+    return root;
+}
+
 const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
+    ++total_visits;
     if (ctxt) ctxt->child_name = name;
+    const IR::Node *input = n;
     if (n) {
         PushContext local(ctxt, n);
         if (visited->done(n)) {
@@ -306,7 +432,7 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
             n = visited->result(n);
         } else {
             visited->start(n, visitDagOnce);
-            auto copy = n->clone();
+            auto copy = inplaceReadOnly ? const_cast<IR::Node *>(n) : n->clone();
             local.current.node = copy;
             if (!dontForwardChildrenBeforePreorder) {
                 ForwardChildren forward_children(*visited);
@@ -315,8 +441,10 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
             prune_flag = false;
             visitCurrentOnce = visited->refVisitOnce(n);
             bool extra_clone = false;
+            P4C_PROBE2(visit_node, n->node_type_name().c_str(), n->id);
             const IR::Node *preorder_result = copy->apply_visitor_preorder(*this);
-            assert(preorder_result != n);  // should never happen
+            assert(preorder_result != n || copy == n);  // returning the original is a bug
+                                                        // unless traversing in place
             const IR::Node *final_result = preorder_result;
             if (preorder_result != copy) {
                 // FIXME -- not safe if the visitor resurrects the node (which it shouldn't)
@@ -338,25 +466,27 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
             prune_flag = save_prune_flag;
             if (final_result == copy
                 && final_result != preorder_result
+                && !local.current.child_changed
                 && *final_result == *preorder_result)
                 final_result = preorder_result;
-            if (visited->finish(n, final_result) && (n = final_result))
+            if (visited->finish(n, final_result, local.current.child_changed)
+                && (n = final_result))
                 final_result->validate();
             if (extra_clone)
                 visited->finish(preorder_result, final_result); } }
-    if (ctxt)
+    if (ctxt) {
         ctxt->child_index++;
-    else
-        visited = nullptr;
+        if (n != input)
+            ctxt->child_changed = true;
+    } else {
+        visited = nullptr; }
     return n;
 }
 
 void Inspector::revisit_visited() {
-    for (auto it = visited->begin(); it != visited->end();) {
-        if (it->second.done)
-            it = visited->erase(it);
-        else
-            ++it; }
+    visited->forall([](info_t &info) {
+        if (info.done)
+            info.present = false; });
 }
 void Modifier::revisit_visited() {
     visited->revisit_visited();
@@ -17,12 +17,67 @@ limitations under the License.
 #ifndef _IR_VISITOR_H_
 #define _IR_VISITOR_H_
 
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 #include "lib/cstring.h"
 #include "ir/ir.h"
 #include "lib/exceptions.h"
 
+/** Dense, node-id-indexed side table used by visitors to track visited nodes.
+ * Every IR::Node carries a monotonically increasing id, so visited state can
+ * live in a flat array instead of a hash map keyed by node pointer; lookup is
+ * two loads with no hashing.  Storage is chunked so memory is proportional to
+ * the id ranges actually touched and references into the table stay stable
+ * while it grows (visitCurrentOnce hands out a pointer into it). */
+template<class Info> class NodeIdInfoMap {
+    static constexpr size_t chunk_size = 1024;  // ids per chunk, power of two
+    std::vector<std::unique_ptr<Info[]>> chunks;
+
+ public:
+    NodeIdInfoMap() = default;
+    NodeIdInfoMap(NodeIdInfoMap &&) = default;
+    NodeIdInfoMap &operator=(NodeIdInfoMap &&) = default;
+    /// Deep copy; requires Info to be copyable.  Maps built on this table
+    /// (e.g. ReferenceMap) need it to be snapshotted for checkpointing.
+    NodeIdInfoMap(const NodeIdInfoMap &other) : chunks(other.chunks.size()) {
+        for (size_t c = 0; c < chunks.size(); ++c)
+            if (other.chunks[c]) {
+                chunks[c].reset(new Info[chunk_size]);
+                std::copy_n(other.chunks[c].get(), chunk_size, chunks[c].get()); } }
+    NodeIdInfoMap &operator=(const NodeIdInfoMap &other) {
+        if (this != &other) {
+            NodeIdInfoMap copy(other);
+            chunks.swap(copy.chunks); }
+        return *this; }
+
+    /// Returns the (default-constructed if untouched) entry for @id,
+    /// allocating its chunk on demand.
+    Info &operator[](int id) {
+        size_t c = size_t(id) / chunk_size, off = size_t(id) % chunk_size;
+        if (c >= chunks.size()) chunks.resize(c + 1);
+        if (!chunks[c]) chunks[c].reset(new Info[chunk_size]{});
+        return chunks[c][off]; }
+    /// Returns the entry for @id, or nullptr if its chunk was never touched.
+    Info *find(int id) {
+        size_t c = size_t(id) / chunk_size, off = size_t(id) % chunk_size;
+        if (c >= chunks.size() || !chunks[c]) return nullptr;
+        return &chunks[c][off]; }
+    const Info *find(int id) const {
+        return const_cast<NodeIdInfoMap *>(this)->find(id); }
+    template<class Fn> void forall(Fn fn) {
+        for (auto &chunk : chunks)
+            if (chunk)
+                for (size_t i = 0; i < chunk_size; ++i) fn(chunk[i]); }
+    template<class Fn> void forall(Fn fn) const {
+        for (auto &chunk : chunks)
+            if (chunk)
+                for (size_t i = 0; i < chunk_size; ++i) fn(const_cast<const Info &>(chunk[i])); }
+    void clear() { chunks.clear(); }
+};
+
 // declare this outside of Visitor so it can be forward declared in node.h
 struct Visitor_Context {
     // We maintain a linked list of Context structures on the stack
@@ -33,6 +88,9 @@ struct Visitor_Context {
     const IR::Node              *node, *original;
     mutable int                 child_index;
     mutable const char          *child_name;
+    // set by a child's apply_visitor when it hands back a different node;
+    // lets Modifier/Transform skip the structural comparison of this node
+    mutable bool                child_changed;
     int                         depth;
 };
 
@@ -58,6 +116,10 @@ class Visitor {
 
     mutable cstring internalName;
 
+    /// Number of node visits performed by all visitors in this process;
+    /// sampled by the pass profiler to attribute visit counts to passes.
+    static uint64_t total_visits;
+
     // init_apply is called (once) when apply is called on an IR tree
     // it expects to allocate a profile record which will be destroyed
     // when the traversal completes.  Visitor subclasses may extend this
@@ -133,6 +195,10 @@ class Visitor {
     virtual bool check_clone(const Visitor *a) { return typeid(*this) == typeid(*a); }
 
     // Functions for IR visit_children to call for ControlFlowVisitors.
+    // flow_clone copies the whole visitor at every branch point, so bulky
+    // per-branch state is best kept in copy-on-write containers (see
+    // lib/cow_map.h) that make the copy O(1) and defer the real work until
+    // one of the branches actually writes.
     virtual Visitor &flow_clone() { return *this; }
 
     /** Merge the given visitor into this visitor at a joint point in the
@@ -250,6 +316,7 @@ class Visitor {
     friend class Inspector;
     friend class Modifier;
     friend class Transform;
+    friend class FusedTransformGroup;
     friend class ControlFlowVisitor;
 };
 
@@ -273,10 +340,11 @@ class Modifier : public virtual Visitor {
 };
 
 class Inspector : public virtual Visitor {
-    struct info_t { bool done, visitOnce; };
-    typedef std::unordered_map<const IR::Node *, info_t>       visited_t;
+    struct info_t { bool present, done, visitOnce; };
+    typedef NodeIdInfoMap<info_t>       visited_t;
     visited_t   *visited = nullptr;
     bool check_clone(const Visitor *) override;
+    const IR::Node *apply_iterative(const IR::Node *root, const char *name);
  public:
     profile_t init_apply(const IR::Node *root) override;
     const IR::Node *apply_visitor(const IR::Node *, const char *name = 0) override;
@@ -290,6 +358,15 @@ class Inspector : public virtual Visitor {
     IRNODE_ALL_SUBCLASSES(DECLARE_VISIT_FUNCTIONS)
 #undef DECLARE_VISIT_FUNCTIONS
     void revisit_visited();
+
+ protected:
+    /* If set, the root visit walks the tree with an explicit work stack
+     * instead of one C++ call frame per node, so machine-generated programs
+     * with very deep expression chains cannot overflow the thread stack.
+     * Contexts, pruning, revisit callbacks and visitOnce behave exactly as
+     * in the recursive traversal; visitors that join control flow
+     * (joinFlows) keep the recursive engine. */
+    bool iterativeTraversal = false;
 };
 
 class Transform : public virtual Visitor {
@@ -297,6 +374,7 @@ class Transform : public virtual Visitor {
     bool prune_flag = false;
     void visitor_const_error() override;
     bool check_clone(const Visitor *) override;
+    friend class FusedTransformGroup;  // forwards prune() from fused passes
 
  public:
     profile_t init_apply(const IR::Node *root) override;
@@ -315,6 +393,14 @@ class Transform : public virtual Visitor {
     void prune() { prune_flag = true; }
 
  protected:
+    /* If set, the traversal does not clone: the preorder/postorder functions
+     * are handed the nodes of the input tree itself (cast to non-const), so
+     * the Transform traverses with Inspector-like cost.  Only for passes
+     * that run in a read-only mode over a tree they are known not to change;
+     * without the pristine original to compare against, a change the pass
+     * does make is applied to the shared input nodes in place instead of
+     * being detected. */
+    bool inplaceReadOnly = false;
     const IR::Node *transform_child(const IR::Node *child) {
         auto *rv = apply_visitor(child);
         prune_flag = true;
@@ -0,0 +1,118 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "arena.h"
+
+#include <sys/mman.h>
+#include <cstdint>
+
+#include "exceptions.h"
+#include "gc.h"
+
+namespace Util {
+
+namespace {
+constexpr std::size_t chunkSize = 1 << 20;  // 1 MiB per chunk
+constexpr std::size_t nodeAlign = alignof(std::max_align_t);
+}  // namespace
+
+// Chunks are mapped directly with mmap rather than operator new, so arena
+// memory bypasses the collected heap entirely (lib/gc.cpp redirects both
+// operator new and malloc to libgc when HAVE_LIBGC is set). The collector
+// never scans these chunks, yet arena-allocated nodes routinely hold the
+// only reference to GC-heap objects (string storage, vector element
+// buffers, big_int limbs) -- and the collector is already initialized by
+// the first allocation, long before option parsing.  enable() therefore
+// disables collection outright: with --arena-alloc the GC heap, like the
+// arena, only grows and is reclaimed at process exit.
+struct Arena::Chunk {
+    Chunk *next;
+    char *cur;
+    char *end;
+};
+
+struct Arena::Region {
+    Chunk *chunks = nullptr;
+    std::size_t bytes = 0;
+};
+
+bool Arena::arenaEnabled = false;
+std::vector<Arena::Region *> Arena::regions;
+
+void Arena::enable() {
+    // See the comment on Chunk: GC-heap objects can become reachable only
+    // through arena memory, which the collector does not scan.
+    gc_disable();
+    arenaEnabled = true;
+    if (regions.empty()) openRegion();
+}
+
+Arena::Region *Arena::activeRegion() {
+    BUG_CHECK(!regions.empty(), "arena allocation requested with no open region");
+    return regions.back();
+}
+
+void *Arena::allocate(std::size_t size) {
+    auto *region = activeRegion();
+    size = (size + nodeAlign - 1) & ~(nodeAlign - 1);
+    auto *chunk = region->chunks;
+    if (!chunk || static_cast<std::size_t>(chunk->end - chunk->cur) < size) {
+        std::size_t mapSize = chunkSize;
+        if (size + sizeof(Chunk) + nodeAlign > mapSize)
+            mapSize = size + sizeof(Chunk) + nodeAlign;
+        void *mem = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) throw std::bad_alloc();
+        chunk = static_cast<Chunk *>(mem);
+        chunk->next = region->chunks;
+        chunk->cur = reinterpret_cast<char *>(
+            (reinterpret_cast<std::uintptr_t>(chunk + 1) + nodeAlign - 1) & ~(nodeAlign - 1));
+        chunk->end = static_cast<char *>(mem) + mapSize;
+        region->chunks = chunk;
+        region->bytes += mapSize;
+    }
+    void *rv = chunk->cur;
+    chunk->cur += size;
+    return rv;
+}
+
+std::size_t Arena::openRegion() {
+    regions.push_back(new Region);
+    return regions.size() - 1;
+}
+
+void Arena::closeRegion(std::size_t handle) {
+    BUG_CHECK(handle < regions.size(), "closing arena region %1% that is not open", handle);
+    while (regions.size() > handle) {
+        auto *region = regions.back();
+        regions.pop_back();
+        for (auto *chunk = region->chunks; chunk;) {
+            auto *next = chunk->next;
+            std::size_t mapSize = chunk->end - reinterpret_cast<char *>(chunk);
+            munmap(chunk, mapSize);
+            chunk = next;
+        }
+        delete region;
+    }
+}
+
+std::size_t Arena::bytesAllocated() {
+    std::size_t total = 0;
+    for (auto *region : regions) total += region->bytes;
+    return total;
+}
+
+}  // namespace Util
@@ -0,0 +1,79 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_ARENA_H_
+#define LIB_ARENA_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace Util {
+
+/**
+ * A simple chunked bump allocator for IR nodes, enabled with --arena-alloc.
+ *
+ * When arena allocation is enabled, IR::Node::operator new draws memory from
+ * the active arena region instead of the garbage-collected heap, eliminating
+ * GC scan/pause cost for node allocation. Regions form a stack: a caller that
+ * knows an entire subcomputation's nodes cannot escape (e.g. a trial
+ * compilation that is thrown away) can open a region, run, and drop all of
+ * its allocations wholesale by closing it. The outermost region lives for
+ * the duration of the compile and is released at process exit.
+ *
+ * Individual nodes allocated from an arena are never freed; operator delete
+ * is a no-op for them.
+ *
+ * Enabling the arena also disables garbage collection (see lib/gc.h):
+ * arena memory is invisible to the collector, so objects still allocated
+ * from the GC heap (string storage, vector buffers) and referenced only
+ * from arena nodes must never be collected.  --arena-alloc thus trades
+ * memory for the elimination of all GC scan/pause cost.
+ */
+class Arena {
+ public:
+    /// Enables arena allocation globally. Must be called before any IR nodes
+    /// are created; typically from --arena-alloc option processing.
+    static void enable();
+    /// True if --arena-alloc is in effect.
+    static bool enabled() { return arenaEnabled; }
+
+    /// Allocates @size bytes from the active region, suitably aligned for
+    /// any IR node. Only valid when enabled() is true.
+    static void *allocate(std::size_t size);
+
+    /// Opens a fresh region; subsequent allocations come from it.
+    /// Returns an opaque handle to pass to closeRegion.
+    static std::size_t openRegion();
+    /// Closes the region identified by @handle and every region opened after
+    /// it, releasing their memory wholesale. The caller asserts that no node
+    /// allocated inside those regions is still reachable.
+    static void closeRegion(std::size_t handle);
+
+    /// Total bytes currently held by all open regions; for memory reporting.
+    static std::size_t bytesAllocated();
+
+ private:
+    struct Chunk;
+    struct Region;
+
+    static bool arenaEnabled;
+    static std::vector<Region *> regions;
+    static Region *activeRegion();
+};
+
+}  // namespace Util
+
+#endif /* LIB_ARENA_H_ */
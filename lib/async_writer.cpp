@@ -0,0 +1,148 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "async_writer.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "error.h"
+#include "gc.h"
+#include "nullstream.h"
+#include "tracepoints.h"
+
+namespace Util {
+
+namespace {
+
+struct Job {
+    cstring name;
+    std::ostream* stream;
+    std::string contents;
+};
+
+/* The worker thread is detached and may still be blocked on the condition
+ * variable when the process exits, so the state is allocated once and never
+ * destroyed. */
+struct WriterState {
+    std::mutex mutex;
+    std::condition_variable wake;     // signals the worker
+    std::condition_variable drained;  // signals waitForAll
+    std::deque<Job> queue;
+    unsigned pending = 0;             // queued plus in-flight jobs
+    std::vector<std::pair<cstring, std::string>> failures;
+    bool workerStarted = false;
+
+    static WriterState& get() {
+        static WriterState* state = new WriterState();
+        return *state;
+    }
+};
+
+void workerLoop() {
+    // Register with the collector: the worker allocates through the
+    // GC-backed operator new, and once a job is popped its contents and
+    // stream are referenced only from this stack, which the collector
+    // would otherwise never scan.
+    gc_register_thread();
+    auto& state = WriterState::get();
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (true) {
+        while (state.queue.empty())
+            state.wake.wait(lock);
+        Job job = std::move(state.queue.front());
+        state.queue.pop_front();
+        lock.unlock();
+
+        std::string failure;
+        try {
+            P4C_PROBE1(write_start, job.name.c_str());
+            *job.stream << job.contents;
+            closeFile(job.stream);
+            if (!job.stream->good())
+                failure = strerror(errno);
+            delete job.stream;
+            P4C_PROBE2(write_end, job.name.c_str(), job.contents.size());
+        } catch (const std::exception& e) {
+            // boost's compressing streams report errors by throwing
+            failure = e.what();
+        }
+
+        lock.lock();
+        if (!failure.empty())
+            state.failures.emplace_back(job.name, failure);
+        if (--state.pending == 0)
+            state.drained.notify_all();
+    }
+}
+
+// Drain the queue at process exit for callers that never call waitForAll;
+// the compile context is gone by now, so failures go unreported.
+void drainAtExit() {
+    auto& state = WriterState::get();
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (state.pending != 0)
+        state.drained.wait(lock);
+}
+
+}  // namespace
+
+void AsyncWriter::write(cstring name, std::ostream* stream, std::string contents) {
+    if (stream == nullptr)
+        return;
+    auto& state = WriterState::get();
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (!state.workerStarted) {
+        state.workerStarted = true;
+        std::thread(workerLoop).detach();
+        std::atexit(drainAtExit);
+    }
+    state.queue.push_back(Job{name, stream, std::move(contents)});
+    state.pending++;
+    state.wake.notify_one();
+}
+
+bool AsyncWriter::writeToFile(cstring name, std::string contents) {
+    std::ostream* out = openFile(name, false);
+    if (out == nullptr)
+        return false;
+    write(name, out, std::move(contents));
+    return true;
+}
+
+bool AsyncWriter::waitForAll() {
+    auto& state = WriterState::get();
+    std::vector<std::pair<cstring, std::string>> failed;
+    {
+        std::unique_lock<std::mutex> lock(state.mutex);
+        while (state.pending != 0)
+            state.drained.wait(lock);
+        failed.swap(state.failures);
+    }
+    for (auto& f : failed)
+        ::error(ErrorType::ERR_IO,
+                "Error writing output to file %1%: %2%", f.first, f.second);
+    return failed.empty();
+}
+
+}  // namespace Util
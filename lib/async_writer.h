@@ -0,0 +1,53 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef P4C_LIB_ASYNC_WRITER_H_
+#define P4C_LIB_ASYNC_WRITER_H_
+
+#include <ostream>
+#include <string>
+
+#include "cstring.h"
+
+namespace Util {
+
+/// Background writer for completed compilation artifacts (backend JSON,
+/// P4Info, --top4 dumps).  The stream is opened on the calling thread, so
+/// diagnostics for bad paths are still reported in context; the buffered
+/// contents are then written -- and, for ".gz" outputs, compressed -- on a
+/// worker thread while compilation continues.  Call waitForAll() before
+/// computing the process exit code: failed writes only become errors there.
+/// A handler registered with atexit drains the queue as a safety net for
+/// callers that never wait, but it cannot report failures.
+class AsyncWriter {
+ public:
+    /// Queue @contents for writing to @stream, which must have been returned
+    /// by openFile(@name).  Takes ownership of the stream; a null stream is
+    /// ignored.
+    static void write(cstring name, std::ostream* stream, std::string contents);
+
+    /// Convenience overload that opens @name itself.  @return false (after
+    /// reporting an error) if the file cannot be opened.
+    static bool writeToFile(cstring name, std::string contents);
+
+    /// Block until every queued write has completed, reporting an I/O error
+    /// for each write that failed.  @return true when all writes succeeded.
+    static bool waitForAll();
+};
+
+}  // namespace Util
+
+#endif /* P4C_LIB_ASYNC_WRITER_H_ */
@@ -125,6 +125,10 @@ bitvec bitvec::getslice(size_t idx, size_t sz) const {
                 if (shift != 0 && i != 0)
                     rv.ptr[i-1] |= ptr[idx + i] << (bits_per_unit - shift);
                 rv.ptr[i] = ptr[idx + i] >> shift; }
+            // an unaligned slice can straddle one more source word than
+            // there are words in the result
+            if (shift != 0 && idx + rv.size < size)
+                rv.ptr[rv.size-1] |= ptr[idx + rv.size] << (bits_per_unit - shift);
             if ((sz %= bits_per_unit))
                 rv.ptr[rv.size-1] &= ~(~static_cast<uintptr_t>(1) << (sz-1));
         } else {
@@ -208,3 +212,63 @@ bitvec bitvec::rotate_right_copy(size_t start_bit, size_t rotation_idx, size_t e
     bitvec rv = rot_section | (*this - rot_mask);
     return rv;
 }
+
+/* On x86-64 GCC, compile an AVX2 clone of each kernel in addition to the
+ * baseline and pick one at load time (clang lacks target_clones on some
+ * supported versions; aarch64 gets NEON from the baseline flags already). */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define BITVEC_TARGET_CLONES __attribute__((target_clones("default,avx2")))
+#else
+#define BITVEC_TARGET_CLONES
+#endif
+
+BITVEC_TARGET_CLONES
+uintptr_t bitvec_detail::or_words(uintptr_t *dst, const uintptr_t *src, size_t n) {
+    uintptr_t diff = 0;
+    for (size_t i = 0; i < n; i++) {
+        uintptr_t w = dst[i] | src[i];
+        diff |= w ^ dst[i];
+        dst[i] = w; }
+    return diff;
+}
+
+BITVEC_TARGET_CLONES
+uintptr_t bitvec_detail::and_words(uintptr_t *dst, const uintptr_t *src, size_t n) {
+    uintptr_t diff = 0;
+    for (size_t i = 0; i < n; i++) {
+        uintptr_t w = dst[i] & src[i];
+        diff |= w ^ dst[i];
+        dst[i] = w; }
+    return diff;
+}
+
+BITVEC_TARGET_CLONES
+uintptr_t bitvec_detail::andnot_words(uintptr_t *dst, const uintptr_t *src, size_t n) {
+    uintptr_t diff = 0;
+    for (size_t i = 0; i < n; i++) {
+        uintptr_t w = dst[i] & ~src[i];
+        diff |= w ^ dst[i];
+        dst[i] = w; }
+    return diff;
+}
+
+BITVEC_TARGET_CLONES
+uintptr_t bitvec_detail::xor_reduce(const uintptr_t *a, const uintptr_t *b, size_t n) {
+    uintptr_t acc = 0;
+    for (size_t i = 0; i < n; i++)
+        acc |= a[i] ^ b[i];
+    return acc;
+}
+
+BITVEC_TARGET_CLONES
+int bitvec_detail::popcount_words(const uintptr_t *p, size_t n) {
+    int rv = 0;
+    for (size_t i = 0; i < n; i++)
+#if defined(__GNUC__) || defined(__clang__)
+        rv += builtin_popcount(p[i]);
+#else
+        for (auto v = p[i]; v; v &= v-1)
+            ++rv;
+#endif
+    return rv;
+}
@@ -46,8 +46,16 @@ CompileContextStack::reportContextMismatch(const char* desiredContextType) {
         typeid(*topContext).name(), desiredContextType);
 }
 
+/* static */ ICompileContext* CompileContextStack::currentOrNull() {
+    auto& stack = getStack();
+    return stack.empty() ? nullptr : stack.back();
+}
+
 /* static */ CompileContextStack::StackType& CompileContextStack::getStack() {
-    static StackType stack;
+    // One stack per thread: worker threads start with an empty stack and
+    // inherit their parent's context explicitly (InheritedCompileContext),
+    // so concurrent passes never race on the stack itself.
+    static thread_local StackType stack;
     return stack;
 }
 
@@ -59,6 +67,17 @@ AutoCompileContext::~AutoCompileContext() {
     CompileContextStack::pop();
 }
 
+InheritedCompileContext::InheritedCompileContext(ICompileContext* context)
+    : pushed(context != nullptr) {
+    if (pushed)
+        CompileContextStack::push(context);
+}
+
+InheritedCompileContext::~InheritedCompileContext() {
+    if (pushed)
+        CompileContextStack::pop();
+}
+
 BaseCompileContext::BaseCompileContext() { }
 
 BaseCompileContext::BaseCompileContext(const BaseCompileContext& other)
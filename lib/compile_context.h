@@ -49,8 +49,16 @@ struct CompileContextStack final {
         return *current;
     }
 
+    /// @return the calling thread's current context without any type
+    /// checking, or null if the stack is empty.  The stack is thread-local;
+    /// capture this on the spawning thread and push it in the worker (via
+    /// InheritedCompileContext) so threads created by a parallel pass see
+    /// their parent's compilation context.
+    static ICompileContext* currentOrNull();
+
  private:
     friend struct AutoCompileContext;
+    friend struct InheritedCompileContext;
 
     using StackType = std::vector<ICompileContext*>;
 
@@ -75,6 +83,19 @@ struct AutoCompileContext {
     ~AutoCompileContext();
 };
 
+/// A RAII helper for worker threads: pushes a context captured on the
+/// spawning thread (via CompileContextStack::currentOrNull()) onto this
+/// thread's stack, so the worker reports errors against the same context as
+/// its parent.  Unlike AutoCompileContext, a null context is allowed and
+/// pushes nothing, for code that can also run outside any context.
+struct InheritedCompileContext {
+    explicit InheritedCompileContext(ICompileContext* context);
+    ~InheritedCompileContext();
+
+ private:
+    bool pushed;
+};
+
 /// A base compilation context which provides members needed by code in
 /// `libp4ctoolkit`. Compilation context types should normally inherit from
 /// BaseCompileContext.
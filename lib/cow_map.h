@@ -0,0 +1,99 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_COW_MAP_H_
+#define LIB_COW_MAP_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+
+/* Copy-on-write map, intended for the per-branch state of control-flow
+ * sensitive visitors: ControlFlowVisitor clones the whole visitor at every
+ * branch point (flow_clone) and merges the clones back (flow_merge), so a
+ * std::map member is copied once per if/switch/select arm whether the arm
+ * touches it or not.  A cow_map copy just shares the representation; the
+ * underlying map is only duplicated on the first mutating access while it
+ * is shared.  Branches that do not write the state therefore never pay for
+ * a copy, and a merge can use shares_with() to detect that both sides are
+ * still identical and skip the walk entirely.
+ *
+ * Every non-const method counts as a mutating access, including non-const
+ * lookups, since the caller may write through the returned reference; use
+ * the map through a const reference (or getref on a const map) when only
+ * reading.  As with std::map, mutating the map invalidates nothing, but
+ * the first mutation after a copy relocates all entries, so references and
+ * iterators must not be held across it. */
+template <class K, class V, class Compare = std::less<K>>
+class cow_map {
+    typedef std::map<K, V, Compare> rep_type;
+    std::shared_ptr<rep_type>       rep;
+
+    rep_type *own() {
+        if (rep.use_count() > 1)
+            rep = std::make_shared<rep_type>(*rep);
+        return rep.get(); }
+
+ public:
+    typedef K                                   key_type;
+    typedef V                                   mapped_type;
+    typedef typename rep_type::value_type       value_type;
+    typedef typename rep_type::size_type        size_type;
+    typedef typename rep_type::iterator         iterator;
+    typedef typename rep_type::const_iterator   const_iterator;
+
+    cow_map() : rep(std::make_shared<rep_type>()) {}
+    cow_map(const cow_map &) = default;             // shares the representation
+    cow_map &operator=(const cow_map &) = default;  // shares the representation
+
+    /// @returns true if both maps still share one representation; they are
+    /// then trivially equal.
+    bool shares_with(const cow_map &other) const { return rep == other.rep; }
+
+    bool empty() const { return rep->empty(); }
+    size_type size() const { return rep->size(); }
+    size_type count(const K &key) const { return rep->count(key); }
+    const_iterator begin() const { return rep->begin(); }
+    const_iterator end() const { return rep->end(); }
+    const_iterator find(const K &key) const { return rep->find(key); }
+    const_iterator upper_bound(const K &key) const { return rep->upper_bound(key); }
+
+    iterator begin() { return own()->begin(); }
+    iterator end() { return own()->end(); }
+    iterator find(const K &key) { return own()->find(key); }
+    iterator upper_bound(const K &key) { return own()->upper_bound(key); }
+    V &operator[](const K &key) { return (*own())[key]; }
+    size_type erase(const K &key) { return own()->erase(key); }
+    void clear() {
+        if (rep.use_count() > 1)
+            rep = std::make_shared<rep_type>();
+        else
+            rep->clear(); }
+};
+
+template <class K, class V, class Comp, class T>
+inline V *getref(cow_map<K, V, Comp> &m, T key) {
+    auto it = m.find(key);
+    if (it != m.end()) return &it->second;
+    return 0; }
+
+template <class K, class V, class Comp, class T>
+inline const V *getref(const cow_map<K, V, Comp> &m, T key) {
+    auto it = m.find(key);
+    if (it != m.end()) return &it->second;
+    return 0; }
+
+#endif /* LIB_COW_MAP_H_ */
@@ -17,95 +17,53 @@ limitations under the License.
 #include "cstring.h"
 
 #include <algorithm>
+#include <array>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 
 #include "hash.h"
+#include "json.h"
 
 namespace {
-enum class table_entry_flags {
-    none,
-    no_need_copy = 1 << 0,
-    require_destruction = 1 << 1,
-    inplace = 1 << 2,
-};
-
-inline table_entry_flags operator &(table_entry_flags l, table_entry_flags r) {
-    return static_cast<table_entry_flags>(static_cast<int>(l) & static_cast<int>(r));
-}
-
-inline table_entry_flags operator |(table_entry_flags l, table_entry_flags r) {
-    return static_cast<table_entry_flags>(static_cast<int>(l) | static_cast<int>(r));
-}
-
-// cache entry, ordered by string length
+// Cache entry.  Stored entries own a length-prefixed copy of the string:
+// the std::size_t immediately before the characters holds the length, so
+// cstring::size() can read it back in constant time while cstring itself
+// stays a single pointer into the characters.  Entries constructed with
+// the two-argument constructor are non-owning views of caller memory, for
+// table lookups only; they are never stored.
 class table_entry {
     std::size_t m_length = 0;
-    table_entry_flags m_flags = table_entry_flags::none;
-
-    union {
-        const char *m_string;
-        char m_inplace_string[sizeof(const char *)];
-    };
+    bool m_owned = false;
+    const char *m_string = nullptr;
 
  public:
-    // entry ctor, makes copy of passed string
-    table_entry(const char *string, std::size_t length, table_entry_flags flags)
-        : m_length(length) {
-        if ((flags & table_entry_flags::no_need_copy) == table_entry_flags::no_need_copy) {
-            // No need to copy object, it's view of string, string literal or string allocated
-            // on heap and wrapped with cstring.
-            // Inherit require_destruction flag here, because string can be allready
-            // allocated on heap and wrapped with cstring object, so cstring owns the string now
-
-            m_flags = flags & table_entry_flags::require_destruction;
-            m_string = string;
-            return;
-        }
-
-        if (length < sizeof(const char *)) {
-            // String with length less than size of pointer store directly
-            // in pointer, that hint allows reduce stack fragmentation.
-            // We can make such optimization because std::unordered_set never
-            // moves objects in memory on new element insert
-            std::memcpy(m_inplace_string, string, length);
-            m_inplace_string[length] = '\0';
-            m_flags = table_entry_flags::inplace;
-        } else {
-            // Make copy of string elseware
-            auto copy = new char[length + 1];
-            std::memcpy(copy, string, length);
-            copy[length] = '\0';
-            m_string = copy;
-
-            // destruction required, because we own copy of string
-            m_flags = table_entry_flags::require_destruction;
-        }
+    // a non-owning view of [string, string+length), for lookups only
+    table_entry(const char *string, std::size_t length)
+        : m_length(length), m_string(string) {}
+
+    // an owning, length-prefixed copy of [string, string+length)
+    static table_entry make_copy(const char *string, std::size_t length) {
+        auto buffer = new char[sizeof(std::size_t) + length + 1];
+        std::memcpy(buffer, &length, sizeof(std::size_t));
+        std::memcpy(buffer + sizeof(std::size_t), string, length);
+        buffer[sizeof(std::size_t) + length] = '\0';
+        table_entry result(buffer + sizeof(std::size_t), length);
+        result.m_owned = true;
+        return result;
     }
 
     // table_entry moveable only
     table_entry(const table_entry &) = delete;
 
-    table_entry(table_entry &&other) : m_length(other.m_length), m_flags(other.m_flags) {
-        // this object for internal usage only, length will never be accessed
-        // if object was moved, so do not zero other.m_length here
-
-        if (is_inplace()) {
-            std::memcpy(m_inplace_string, other.m_inplace_string, sizeof(m_inplace_string));
-        } else {
-            m_string = other.string();
-            other.m_string = nullptr;
-        }
+    table_entry(table_entry &&other)
+        : m_length(other.m_length), m_owned(other.m_owned), m_string(other.m_string) {
+        other.m_owned = false;
     }
 
     ~table_entry() {
-        if ((m_flags & table_entry_flags::require_destruction) ==
-                table_entry_flags::require_destruction) {
-            // null pointer checked in operator delete [], so we don't need
-            // to check it explicitly
-
-            delete [] m_string;
-        }
+        if (m_owned)
+            delete [] const_cast<char *>(m_string - sizeof(std::size_t));
     }
 
     std::size_t length() const {
@@ -113,21 +71,12 @@ class table_entry {
     }
 
     const char *string() const {
-        if (is_inplace()) {
-            return m_inplace_string;
-        }
-
         return m_string;
     }
 
     bool operator ==(const table_entry &other) const {
         return length() == other.length() && std::memcmp(string(), other.string(), length()) == 0;
     }
-
- private:
-    bool is_inplace() const {
-        return (m_flags & table_entry_flags::inplace) == table_entry_flags::inplace;
-    }
 };
 }  // namespace
 
@@ -135,28 +84,43 @@ namespace std {
 template<>
 struct hash<table_entry> {
     std::size_t operator()(const table_entry &entry) const {
-        return Util::Hash::murmur(entry.string(), entry.length());
+        return Util::Hash::hash(entry.string(), entry.length());
     }
 };
 }
 
 namespace {
-std::unordered_set<table_entry>& cache() {
-    static std::unordered_set<table_entry> g_cache;
+// The intern table is sharded by string hash so that concurrent interning
+// (lexing, name mangling, future multi-threaded passes) contends on a shard
+// mutex instead of a single global lock. Entries are never erased, and
+// std::unordered_set never moves elements, so returned pointers stay stable.
+constexpr std::size_t cache_shard_count = 64;  // must be a power of two
+static_assert((cache_shard_count & (cache_shard_count - 1)) == 0,
+              "shard count must be a power of two");
+
+struct cache_shard {
+    std::mutex mutex;
+    std::unordered_set<table_entry> entries;
+};
+
+std::array<cache_shard, cache_shard_count>& cache() {
+    static std::array<cache_shard, cache_shard_count> g_cache;
 
     return g_cache;
 }
 
-const char *save_to_cache(const char *string, std::size_t length, table_entry_flags flags) {
-    if ((flags & table_entry_flags::no_need_copy) == table_entry_flags::no_need_copy) {
-        return cache().emplace(string, length, flags).first->string();
-    }
+const char *save_to_cache(const char *string, std::size_t length) {
+    auto &shard = cache()[Util::Hash::hash(string, length) & (cache_shard_count - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
     // temporary table_entry, used for searching only. no need to copy string
-    auto found = cache().find(table_entry(string, length, table_entry_flags::no_need_copy));
+    auto found = shard.entries.find(table_entry(string, length));
 
-    if (found == cache().end()) {
-        return cache().emplace(string, length, flags).first->string();
+    if (found == shard.entries.end()) {
+        // Always store a length-prefixed copy, even of literals: size()
+        // unconditionally reads the length prefix, so every interned pointer
+        // must have one.
+        return shard.entries.insert(table_entry::make_copy(string, length)).first->string();
     }
 
     return found->string();
@@ -165,23 +129,41 @@ const char *save_to_cache(const char *string, std::size_t length, table_entry_fl
 }  // namespace
 
 void cstring::construct_from_shared(const char *string, std::size_t length) {
-    str = save_to_cache(string, length, table_entry_flags::none);
+    str = save_to_cache(string, length);
 }
 
 void cstring::construct_from_unique(const char *string, std::size_t length) {
-    str = save_to_cache(string, length,
-        table_entry_flags::no_need_copy | table_entry_flags::require_destruction);
+    str = save_to_cache(string, length);
+    // the table keeps its own prefixed copy; we own (and are done with) the
+    // original
+    delete [] const_cast<char *>(string);
 }
 
 void cstring::construct_from_literal(const char *string, std::size_t length) {
-    str = save_to_cache(string, length, table_entry_flags::no_need_copy);
+    str = save_to_cache(string, length);
+}
+
+cstring cstring::find_interned(const char *string, std::size_t length) {
+    auto &shard = cache()[Util::Hash::hash(string, length) & (cache_shard_count - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // temporary table_entry, used for searching only. no need to copy string
+    auto found = shard.entries.find(table_entry(string, length));
+    cstring result;
+    if (found != shard.entries.end())
+        result.str = found->string();
+    return result;
 }
 
 size_t cstring::cache_size(size_t &count) {
     size_t rv = 0;
-    count = cache().size();
-    for (auto &s : cache())
-        rv += sizeof(s) + s.length();
+    count = 0;
+    for (auto &shard : cache()) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.entries.size();
+        for (auto &s : shard.entries)
+            rv += sizeof(s) + sizeof(std::size_t) + s.length() + 1;
+    }
     return rv;
 }
 
@@ -233,12 +215,7 @@ cstring cstring::replace(cstring search, cstring replace) const {
 
 cstring cstring::escapeJson() const {
     std::string out;
-    for (size_t i = 0; i < size(); i++) {
-        char c = get(i);
-        if (c == '\\' || c == '"')
-            out += "\\";
-        out += c;
-    }
+    Util::appendJsonEscaped(out, c_str(), size());
     return cstring(out);
 }
 
@@ -51,8 +51,9 @@ limitations under the License.
  *     std::string.
  *   - Interned strings can never be freed, so they'll stick around for the
  *     lifetime of the program.
- *   - The string interning cstring performs is currently not threadsafe, so you
- *     can't safely use cstrings off the main thread.
+ *   - Interning goes through a sharded, mutex-protected table, so creating
+ *     cstrings is safe off the main thread, but each conversion still pays
+ *     for hashing and a shard lock.
  *
  * Given these tradeoffs, the general rule of thumb to follow is that you should
  * try to convert strings to cstrings early and keep them in that form. That
@@ -114,8 +115,9 @@ class cstring {
 
     // TODO (DanilLutsenko): Construct from StringRef?
 
-    // String was created outside and cstring is unique owner of it.
-    // cstring will control lifetime of passed object
+    // String was created outside (with new char[]) and cstring is unique
+    // owner of it: the intern table keeps its own length-prefixed copy and
+    // frees the passed string.
     static cstring own(const char *string, std::size_t length) {
         if (string == nullptr) {
             return{};
@@ -159,19 +161,21 @@ class cstring {
     const char *c_str() const { return str; }
     operator const char *() const { return str; }
 
-    // Size tests. Constant time except for size(), which is linear time.
+    // Size tests. Constant time: interned strings are stored with their
+    // length in the std::size_t just before the characters (see
+    // lib/cstring.cpp), so size() is a single load rather than a strlen scan.
     size_t size() const {
-        // TODO (DanilLutsenko): We store size of string in table on object construction,
-        // compiler cannot optimize strlen if str not points to string literal.
-        // Probably better fetch size from table or store it to cstring on construction.
-        return str ? strlen(str) : 0;
+        if (str == nullptr) return 0;
+        std::size_t length;
+        std::memcpy(&length, str - sizeof(std::size_t), sizeof(std::size_t));
+        return length;
     }
     bool isNull() const { return str == nullptr; }
     bool isNullOrEmpty() const { return str == nullptr ? true : str[0] == 0; }
 
     // iterate over characters
     const char *begin() const { return str; }
-    const char *end() const { return str ? str + strlen(str) : str; }
+    const char *end() const { return str ? str + size() : str; }
 
     // Search for characters. Linear time.
     const char *find(int c) const { return str ? strchr(str, c) : nullptr; }
@@ -184,16 +188,30 @@ class cstring {
     bool operator==(cstring a) const { return str == a.str; }
     bool operator!=(cstring a) const { return str != a.str; }
 
+    /// Three-way lexicographic comparison.  The cached lengths turn this
+    /// into one bounded memcmp instead of a character-by-character strcmp;
+    /// sort-heavy code (name indices, symbol table output) goes through the
+    /// relational operators below and benefits automatically.
+    int compare(cstring a) const {
+        if (str == a.str) return 0;
+        if (str == nullptr) return -1;
+        if (a.str == nullptr) return 1;
+        size_t n = size(), m = a.size();
+        int cmp = memcmp(str, a.str, n < m ? n : m);
+        if (cmp != 0) return cmp;
+        return n < m ? -1 : n > m ? 1 : 0;
+    }
+
     // Other comparisons and tests. Linear time.
     bool operator==(const char *a) const { return str ? a && !strcmp(str, a) : !a; }
     bool operator!=(const char *a) const { return str ? !a || !!strcmp(str, a) : !!a; }
-    bool operator<(cstring a) const { return *this < a.str; }
+    bool operator<(cstring a) const { return compare(a) < 0; }
     bool operator<(const char *a) const { return str ? a && strcmp(str, a) < 0 : !!a; }
-    bool operator<=(cstring a) const { return *this <= a.str; }
+    bool operator<=(cstring a) const { return compare(a) <= 0; }
     bool operator<=(const char *a) const { return str ? a && strcmp(str, a) <= 0 : true; }
-    bool operator>(cstring a) const { return *this > a.str; }
+    bool operator>(cstring a) const { return compare(a) > 0; }
     bool operator>(const char *a) const { return str ? !a || strcmp(str, a) > 0 : false; }
-    bool operator>=(cstring a) const { return *this >= a.str; }
+    bool operator>=(cstring a) const { return compare(a) >= 0; }
     bool operator>=(const char *a) const { return str ? !a || strcmp(str, a) >= 0 : !a; }
 
     bool operator==(const std::string &a) const { return *this == a.c_str(); }
@@ -253,11 +271,31 @@ class cstring {
             ss << *current; }
         return cstring(ss.str()); }
     template<class T> static cstring make_unique(const T &inuse, cstring base, char sep = '.');
+    /// Like make_unique, but probing starts at counters[base], which is
+    /// advanced past the chosen suffix.  Callers generating many names from
+    /// the same base (every retry of make_unique(inuse, ...) re-probes all
+    /// the suffixes handed out before) should keep a counter map alongside
+    /// their in-use set to make generation amortized constant time; the
+    /// result is still validated against @inuse, so a stale or shared
+    /// counter map affects only the suffixes chosen, never uniqueness.
+    template<class T, class U>
+    static cstring make_unique(const T &inuse, U &counters, cstring base, char sep = '.');
 
     /// @return the total size in bytes of all interned strings. @count is set
     /// to the total number of interned strings.
     static size_t cache_size(size_t &count);
 
+    /// Look up an already-interned string without interning it.  @return the
+    /// interned cstring if the argument is in the table, or a null cstring if
+    /// it was never interned -- in which case it cannot be a key in any
+    /// cstring-keyed container, so speculative probes can fail fast without
+    /// growing the table.
+    static cstring find_interned(const char *string, std::size_t length);
+    static cstring find_interned(const char *string) {
+        return string == nullptr ? cstring() : find_interned(string, std::strlen(string)); }
+    static cstring find_interned(const std::string &string) {
+        return find_interned(string.data(), string.length()); }
+
     // convert the cstring to upper case
     cstring toUpper();
 };
@@ -297,6 +335,16 @@ template<class T> cstring cstring::make_unique(const T &inuse, cstring base, cha
         rv = base + suffix; }
     return rv; }
 
+template<class T, class U>
+cstring cstring::make_unique(const T &inuse, U &counters, cstring base, char sep) {
+    char suffix[12];
+    cstring rv = base;
+    auto &counter = counters[base];
+    while (inuse.count(rv)) {
+        snprintf(suffix, sizeof(suffix)/sizeof(suffix[0]), "%c%d", sep, counter++);
+        rv = base + suffix; }
+    return rv; }
+
 inline std::ostream &operator<<(std::ostream &out, cstring s) {
     return out << (s ? s.c_str() : "<null>"); }
 
@@ -0,0 +1,108 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "densebitmatrix.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t bpw = bitvec::bits_per_unit;
+
+unsigned lowbit(uintptr_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return builtin_ctz(w);
+#else
+    unsigned i = 0;
+    while (!(w & 1)) { w >>= 1; ++i; }
+    return i;
+#endif
+}
+
+/* In-place transpose of a bpw x bpw bit block held one word per row, bit 0 of
+ * word 0 being element (0, 0).  Recursive quadrant swap via delta-swaps
+ * (Hacker's Delight 7-3, adjusted for row-0/lsb-first orientation and
+ * generalized to the word size). */
+void transpose_block(uintptr_t *a) {
+    uintptr_t m = ~uintptr_t(0) >> (bpw / 2);
+    for (size_t j = bpw / 2; j; j >>= 1, m ^= m << j) {
+        for (size_t k = 0; k < bpw; k = (k + j + 1) & ~j) {
+            uintptr_t t = ((a[k] >> j) ^ a[k ^ j]) & m;
+            a[k] ^= t << j;
+            a[k ^ j] ^= t; } }
+}
+
+}  // namespace
+
+DenseBitMatrix::DenseBitMatrix(const SymBitMatrix &m) : DenseBitMatrix(m.size()) {
+    for (unsigned r = 0; r < n; ++r)
+        for (size_t c : bitvec(m[r]))
+            set(r, unsigned(c));
+}
+
+DenseBitMatrix::DenseBitMatrix(const LTBitMatrix &m) : DenseBitMatrix(m.size()) {
+    for (unsigned r = 0; r < n; ++r)
+        for (size_t c : bitvec(m[r]))
+            set(r, unsigned(c));
+}
+
+bitvec DenseBitMatrix::row(unsigned r) const {
+    bitvec rv;
+    const uintptr_t *p = row_ptr(r);
+    for (unsigned w = rowWords; w-- > 0;)     // high to low, so bitvec grows once
+        for (uintptr_t word = p[w]; word; word &= word - 1)
+            rv.setbit(w * bpw + lowbit(word));
+    return rv;
+}
+
+/* Warshall's algorithm, consuming intermediate vertices one word-sized block
+ * at a time.  The block's rows are first closed against each other (a
+ * bpw x bpw subproblem), after which any path from an outside row through the
+ * block starts with one of that row's original edges into it, so a single
+ * pass over one word of each remaining row finishes the block.  Each row is
+ * read and written once per block instead of once per vertex, and the block
+ * rows stay cache-resident while they are the hot operand. */
+void DenseBitMatrix::closure() {
+    for (unsigned blk = 0; blk < rowWords; ++blk) {
+        unsigned base = blk * unsigned(bpw);
+        unsigned lim = std::min(n, base + unsigned(bpw));
+        for (unsigned k = base; k < lim; ++k)
+            for (unsigned i = base; i < lim; ++i)
+                if (i != k && (*this)(i, k))
+                    or_row(i, k);
+        for (unsigned i = 0; i < n; ++i) {
+            if (i >= base && i < lim) continue;
+            for (uintptr_t w = row_ptr(i)[blk]; w; w &= w - 1)
+                or_row(i, base + lowbit(w)); } }
+}
+
+/* OR in the transpose one pair of word-square blocks at a time, so both the
+ * reads and the writes stream through memory in row order rather than
+ * scattering single bits down a column. */
+void DenseBitMatrix::make_symmetric() {
+    std::vector<uintptr_t> lo(bpw), hi(bpw);
+    for (unsigned bi = 0; bi < rowWords; ++bi) {
+        for (unsigned bj = bi; bj < rowWords; ++bj) {
+            unsigned ri = bi * unsigned(bpw), rj = bj * unsigned(bpw);
+            for (unsigned k = 0; k < bpw; ++k) {
+                lo[k] = ri + k < n ? row_ptr(ri + k)[bj] : 0;
+                hi[k] = rj + k < n ? row_ptr(rj + k)[bi] : 0; }
+            transpose_block(&lo[0]);
+            transpose_block(&hi[0]);
+            for (unsigned k = 0; k < bpw; ++k) {
+                if (rj + k < n) row_ptr(rj + k)[bi] |= lo[k];
+                if (ri + k < n) row_ptr(ri + k)[bj] |= hi[k]; } } }
+}
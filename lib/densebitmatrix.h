@@ -0,0 +1,79 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef P4C_LIB_DENSEBITMATRIX_H_
+#define P4C_LIB_DENSEBITMATRIX_H_
+
+#include <vector>
+
+#include "bitvec.h"
+#include "ltbitmatrix.h"
+#include "symbitmatrix.h"
+
+/* A dense square bit matrix with each row stored as a contiguous run of
+ * machine words.  SymBitMatrix and LTBitMatrix pack a triangle of bits into a
+ * single bitvec, which is the right tradeoff for sparse matrices that live a
+ * long time, but their bit-at-a-time access makes whole-matrix kernels the
+ * bottleneck once conflict/alias matrices reach thousands of rows.  This type
+ * trades memory for layout: row operations go through the vectorized
+ * bitvec_detail word kernels, and closure() consumes intermediate vertices one
+ * cache-resident word-sized block at a time.  Convert from the triangular
+ * types at the start of a kernel and copy the rows back afterwards. */
+class DenseBitMatrix {
+    static constexpr size_t bpw = bitvec::bits_per_unit;
+    unsigned                n = 0;          // rows == columns
+    unsigned                rowWords = 0;   // words per row
+    std::vector<uintptr_t>  bits;           // n * rowWords words, row-major
+
+    uintptr_t *row_ptr(unsigned r) { return &bits[size_t(r) * rowWords]; }
+    const uintptr_t *row_ptr(unsigned r) const { return &bits[size_t(r) * rowWords]; }
+
+ public:
+    DenseBitMatrix() = default;
+    explicit DenseBitMatrix(unsigned size)
+        : n(size), rowWords(unsigned((size + bpw - 1) / bpw)), bits(size_t(n) * rowWords) {}
+    explicit DenseBitMatrix(const SymBitMatrix &);
+    explicit DenseBitMatrix(const LTBitMatrix &);
+
+    unsigned size() const { return n; }
+    void clear() { bits.assign(bits.size(), 0); }
+    bool empty() const {
+        for (auto w : bits) if (w) return false;
+        return true; }
+    bool operator()(unsigned r, unsigned c) const {
+        return (row_ptr(r)[c / bpw] >> (c % bpw)) & 1; }
+    void set(unsigned r, unsigned c) { row_ptr(r)[c / bpw] |= uintptr_t(1) << (c % bpw); }
+    void clr(unsigned r, unsigned c) { row_ptr(r)[c / bpw] &= ~(uintptr_t(1) << (c % bpw)); }
+    /// Set both (r, c) and (c, r), as a SymBitMatrix write would.
+    void set_sym(unsigned r, unsigned c) { set(r, c); set(c, r); }
+
+    /// row @dst |= row @src, one vectorized pass; true if @dst changed.
+    bool or_row(unsigned dst, unsigned src) {
+        return bitvec_detail::or_words(row_ptr(dst), row_ptr(src), rowWords) != 0; }
+    /// The set bits of row @r, for copying a result back into a
+    /// bitvec-based type (e.g. via SymBitMatrix's rowref |=).
+    bitvec row(unsigned r) const;
+
+    /// Transitive closure in place (Warshall over whole rows).
+    void closure();
+    /// this |= transpose(this), making row-at-a-time updates symmetric.
+    void make_symmetric();
+
+    bool operator==(const DenseBitMatrix &a) const { return n == a.n && bits == a.bits; }
+    bool operator!=(const DenseBitMatrix &a) const { return !(*this == a); }
+};
+
+#endif /* P4C_LIB_DENSEBITMATRIX_H_ */
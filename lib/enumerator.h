@@ -20,6 +20,7 @@ limitations under the License.
 #ifndef P4C_LIB_ENUMERATOR_H_
 #define P4C_LIB_ENUMERATOR_H_
 
+#include <iterator>
 #include <vector>
 #include <list>
 #include <stdexcept>
@@ -96,7 +97,7 @@ class Enumerator {
     static Enumerator<T>* createEnumerator(const std::list<T> &data);
     static Enumerator<T>* emptyEnumerator();  // empty data
     template <typename Iter>
-    static Enumerator<typename Iter::value_type>* createEnumerator(Iter begin, Iter end);
+    static Enumerator<typename std::iterator_traits<Iter>::value_type>* createEnumerator(Iter begin, Iter end);
     // concatenate all these collections into a single one
     static Enumerator<T>* concatAll(Enumerator<Enumerator<T>*>* inputs);
 
@@ -133,16 +134,16 @@ class Enumerator {
    C is the container type */
 
 template <typename Iter>
-class GenericEnumerator : public Enumerator<typename Iter::value_type> {
+class GenericEnumerator : public Enumerator<typename std::iterator_traits<Iter>::value_type> {
  protected:
     Iter begin;
     Iter end;
     Iter current;
     cstring name;
-    friend class Enumerator<typename Iter::value_type>;
+    friend class Enumerator<typename std::iterator_traits<Iter>::value_type>;
 
     GenericEnumerator(Iter begin, Iter end, cstring name)
-            : Enumerator<typename Iter::value_type>(),
+            : Enumerator<typename std::iterator_traits<Iter>::value_type>(),
             begin(begin), end(end), current(begin), name(name) {}
 
  public:
@@ -175,7 +176,7 @@ class GenericEnumerator : public Enumerator<typename Iter::value_type> {
         throw std::runtime_error("Unexpected enumerator state");
     }
 
-    typename Iter::value_type getCurrent() const {
+    typename std::iterator_traits<Iter>::value_type getCurrent() const {
         switch (this->state) {
             case EnumeratorState::NotStarted:
                 throw std::logic_error("You cannot call 'getCurrent' before 'moveNext'");
@@ -497,7 +498,7 @@ Enumerator<T>* Enumerator<T>::createEnumerator(const std::list<T> &data) {
 
 template <typename T>
 template <typename Iter>
-Enumerator<typename Iter::value_type>* Enumerator<T>::createEnumerator(Iter begin, Iter end) {
+Enumerator<typename std::iterator_traits<Iter>::value_type>* Enumerator<T>::createEnumerator(Iter begin, Iter end) {
     return new GenericEnumerator<Iter>(begin, end, "iterator");
 }
 
@@ -38,7 +38,7 @@ inline unsigned diagnosticCount() {
     return BaseCompileContext::get().errorReporter().getDiagnosticCount();
 }
 
-// Errors (and warnings) are specified using boost::format format strings, i.e.,
+// Errors (and warnings) are specified using boost::format-style format strings, i.e.,
 // %1%, %2%, etc (starting at 1, not at 0).
 // Some compatibility for printf-style arguments is also supported.
 
@@ -16,22 +16,137 @@ limitations under the License.
 #ifndef P4C_LIB_ERROR_HELPER_H_
 #define P4C_LIB_ERROR_HELPER_H_
 
-#include <boost/format.hpp>
 #include <stdarg.h>
 #include <map>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include "lib/cstring.h"
 #include "lib/source_file.h"
 #include "lib/stringify.h"
 
-// All these methods return std::string because this is the native format of boost::format
-// Position is printed at the beginning.
-static inline std::string error_helper(boost::format& f, std::string message,
+namespace Util {
+
+/// A "%1%"-style diagnostic format string, parsed once into literal segments
+/// and argument references.  The compiler emits the same handful of format
+/// strings over and over, so parsing them on every emission (as boost::format
+/// did) made warning-heavy compiles formatting-bound; instances are cached by
+/// interned format string and rendering just appends the precompiled segments
+/// and the stringified arguments into a single pre-sized buffer.
+class FormatTemplate {
+    struct Segment {
+        std::string literal;  // emitted before the argument
+        int arg;              // 0-based argument index, or -1 for none
+    };
+    std::vector<Segment> segments;
+    size_t literalSize = 0;
+
+    void parse(const char* fmt) {
+        Segment cur{std::string(), -1};
+        for (const char* p = fmt; *p; ) {
+            if (*p == '%') {
+                if (p[1] == '%') {
+                    cur.literal += '%';
+                    p += 2;
+                    continue;
+                }
+                const char* q = p + 1;
+                unsigned n = 0;
+                while (*q >= '0' && *q <= '9')
+                    n = n * 10 + (*q++ - '0');
+                if (q != p + 1 && *q == '%' && n > 0) {
+                    cur.arg = static_cast<int>(n) - 1;
+                    literalSize += cur.literal.size();
+                    segments.push_back(std::move(cur));
+                    cur = Segment{std::string(), -1};
+                    p = q + 1;
+                    continue;
+                }
+            }
+            cur.literal += *p++;
+        }
+        literalSize += cur.literal.size();
+        segments.push_back(std::move(cur));
+    }
+
+ public:
+    explicit FormatTemplate(const char* fmt) { parse(fmt); }
+
+    /// Parse-once cache.  Diagnostics may be raised from the parallel
+    /// type-checking workers, so insertion is guarded.
+    static const FormatTemplate& get(const char* fmt) {
+        static std::unordered_map<cstring, FormatTemplate> cache;
+        static std::mutex cacheMutex;
+        cstring key = fmt;
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it == cache.end())
+            it = cache.emplace(key, FormatTemplate(fmt)).first;
+        return it->second;
+    }
+
+    std::string render(const std::vector<std::string>& args) const {
+        std::string result;
+        size_t size = literalSize;
+        for (auto& a : args)
+            size += a.size();
+        result.reserve(size);
+        for (auto& s : segments) {
+            result += s.literal;
+            if (s.arg >= 0 && static_cast<size_t>(s.arg) < args.size())
+                result += args[s.arg];
+        }
+        return result;
+    }
+};
+
+/// One emission of a FormatTemplate.  Mirrors the boost::format interface the
+/// error helpers were written against: arguments are fed in positional order
+/// with operator%, and str() renders the message.  Arguments that the format
+/// string does not reference are dropped rather than being an error, since
+/// throwing while reporting a diagnostic would mask the diagnostic itself.
+class Format {
+    const FormatTemplate* tmpl;
+    std::vector<std::string> args;
+
+ public:
+    explicit Format(const char* fmt) : tmpl(&FormatTemplate::get(fmt)) {}
+
+    Format& operator%(const char* t) {
+        args.push_back(t != nullptr ? std::string(t) : std::string());
+        return *this;
+    }
+    Format& operator%(std::string t) {
+        args.push_back(std::move(t));
+        return *this;
+    }
+    Format& operator%(const cstring& t) {
+        args.push_back(t.isNullOrEmpty() ? std::string() : std::string(t.c_str()));
+        return *this;
+    }
+    template<typename T>
+    Format& operator%(const T& t) {
+        std::stringstream str;
+        str << t;
+        args.push_back(str.str());
+        return *this;
+    }
+
+    std::string str() const { return tmpl->render(args); }
+};
+
+}  // namespace Util
+
+// All these methods return std::string because that is what the renderer
+// produces.  Position is printed at the beginning.
+static inline std::string error_helper(Util::Format& f, std::string message,
                                        std::string position, std::string tail, std::string suffix) {
-    std::string text = boost::str(f);
+    std::string text = f.str();
     std::string result = position;
     if (!position.empty())
         result += ": ";
@@ -40,51 +155,51 @@ static inline std::string error_helper(boost::format& f, std::string message,
 }
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const char* t, Args... args);
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const cstring& t, Args... args);
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message,
+std::string error_helper(Util::Format& f, std::string message,
                          std::string position, std::string tail, std::string suffix,
                          const Util::SourceInfo &info, Args... args);
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T &t, Args... args) ->
     typename std::enable_if<Util::HasToString<T>::value &&
                             !std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type;
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T *t, Args... args) ->
     typename std::enable_if<Util::HasToString<T>::value &&
                             !std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type;
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T &t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type;
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T *t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type;
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const big_int *t, Args... args);
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const big_int &t, Args... args);
 
 template<typename T, class... Args>
 auto
-error_helper(boost::format& f, std::string message,
+error_helper(Util::Format& f, std::string message,
              std::string position, std::string tail, std::string suffix,
              const T& t, Args... args) ->
     typename std::enable_if<std::is_arithmetic<T>::value, std::string>::type;
@@ -92,20 +207,20 @@ error_helper(boost::format& f, std::string message,
 // actual implementations
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const char* t, Args... args) {
     return error_helper(f % t, message, position, tail, suffix, std::forward<Args>(args)...);
 }
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const cstring& t, Args... args) {
     return error_helper(f % t.c_str(), message, position, tail,
                         suffix, std::forward<Args>(args)...);
 }
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T &t, Args... args) ->
     typename std::enable_if<Util::HasToString<T>::value &&
                             !std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type {
@@ -114,7 +229,7 @@ auto error_helper(boost::format& f, std::string message, std::string position,
 }
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T *t, Args... args) ->
     typename std::enable_if<Util::HasToString<T>::value &&
                             !std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type {
@@ -123,27 +238,27 @@ auto error_helper(boost::format& f, std::string message, std::string position,
 }
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const big_int *t, Args... args) {
     return error_helper(f % t, message, position, tail, suffix, std::forward<Args>(args)...);
 }
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const big_int &t, Args... args) {
     return error_helper(f % t, message, position, tail, suffix, std::forward<Args>(args)...);
 }
 
 template<typename T, class... Args>
 auto
-error_helper(boost::format& f, std::string message, std::string position,
+error_helper(Util::Format& f, std::string message, std::string position,
              std::string tail, std::string suffix, const T& t, Args... args) ->
     typename std::enable_if<std::is_arithmetic<T>::value, std::string>::type {
     return error_helper(f % t, message, position, tail, suffix, std::forward<Args>(args)...);
 }
 
 template<class... Args>
-std::string error_helper(boost::format& f, std::string message, std::string position,
+std::string error_helper(Util::Format& f, std::string message, std::string position,
                          std::string tail, std::string suffix, const Util::SourceInfo &info,
                          Args... args) {
     cstring posString = info.toPositionString();
@@ -159,7 +274,7 @@ std::string error_helper(boost::format& f, std::string message, std::string posi
 }
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T *t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type {
     cstring posString = t->getSourceInfo().toPositionString();
@@ -176,7 +291,7 @@ auto error_helper(boost::format& f, std::string message, std::string position,
 }
 
 template<typename T, class... Args>
-auto error_helper(boost::format& f, std::string message, std::string position,
+auto error_helper(Util::Format& f, std::string message, std::string position,
                   std::string tail, std::string suffix, const T &t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type {
     cstring posString = t.getSourceInfo().toPositionString();
@@ -194,9 +309,9 @@ auto error_helper(boost::format& f, std::string message, std::string position,
 
 /***********************************************************************************/
 
-static inline std::string bug_helper(boost::format& f, std::string message,
+static inline std::string bug_helper(Util::Format& f, std::string message,
                                      std::string position, std::string tail) {
-    std::string text = boost::str(f);
+    std::string text = f.str();
     std::string result = position;
     if (!position.empty())
         result += ": ";
@@ -205,44 +320,44 @@ static inline std::string bug_helper(boost::format& f, std::string message,
 }
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const char* t, Args... args);
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const cstring& t, Args... args);
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message,
+std::string bug_helper(Util::Format& f, std::string message,
                        std::string position, std::string tail,
                        const Util::SourceInfo &info, Args... args);
 
 template<typename T, class... Args>
-auto bug_helper(boost::format& f, std::string message, std::string position,
+auto bug_helper(Util::Format& f, std::string message, std::string position,
                 std::string tail, const T &t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type;
 
 template<typename T, class... Args>
-auto bug_helper(boost::format& f, std::string message, std::string position,
+auto bug_helper(Util::Format& f, std::string message, std::string position,
                 std::string tail, const T *t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type;
 
 template<typename T, class... Args>
-auto bug_helper(boost::format& f, std::string message, std::string position,
+auto bug_helper(Util::Format& f, std::string message, std::string position,
                 std::string tail, const T *t, Args... args) ->
     typename std::enable_if<!std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type;
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const big_int *t, Args... args);
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const big_int &t, Args... args);
 
 template<typename T, class... Args>
 auto
-bug_helper(boost::format& f, std::string message, std::string position,
+bug_helper(Util::Format& f, std::string message, std::string position,
            std::string tail, const T& t, Args... args) ->
     typename std::enable_if<!std::is_base_of<Util::IHasSourceInfo, T>::value,
                             std::string>::type;
@@ -250,19 +365,19 @@ bug_helper(boost::format& f, std::string message, std::string position,
 // actual implementations
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const char* t, Args... args) {
     return bug_helper(f % t, message, position, tail, std::forward<Args>(args)...);
 }
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const cstring& t, Args... args) {
     return bug_helper(f % t.c_str(), message, position, tail, std::forward<Args>(args)...);
 }
 
 template<typename T, class... Args>
-auto bug_helper(boost::format& f, std::string message, std::string position,
+auto bug_helper(Util::Format& f, std::string message, std::string position,
                 std::string tail, const T *t, Args... args) ->
         typename std::enable_if<!std::is_base_of<Util::IHasSourceInfo, T>::value,
                                 std::string>::type {
@@ -272,20 +387,20 @@ auto bug_helper(boost::format& f, std::string message, std::string position,
 }
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const big_int *t, Args... args) {
     return bug_helper(f % t, message, position, tail, std::forward<Args>(args)...);
 }
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const big_int &t, Args... args) {
     return bug_helper(f % t, message, position, tail, std::forward<Args>(args)...);
 }
 
 template<typename T, class... Args>
 auto
-bug_helper(boost::format& f, std::string message, std::string position,
+bug_helper(Util::Format& f, std::string message, std::string position,
            std::string tail, const T& t, Args... args) ->
     typename std::enable_if<!std::is_base_of<Util::IHasSourceInfo, T>::value,
                             std::string>::type {
@@ -293,7 +408,7 @@ bug_helper(boost::format& f, std::string message, std::string position,
 }
 
 template<class... Args>
-std::string bug_helper(boost::format& f, std::string message, std::string position,
+std::string bug_helper(Util::Format& f, std::string message, std::string position,
                        std::string tail, const Util::SourceInfo &info, Args... args) {
     cstring posString = info.toPositionString();
     if (position.empty()) {
@@ -308,7 +423,7 @@ std::string bug_helper(boost::format& f, std::string message, std::string positi
 }
 
 template<typename T, class... Args>
-auto bug_helper(boost::format& f, std::string message, std::string position,
+auto bug_helper(Util::Format& f, std::string message, std::string position,
                 std::string tail, const T *t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type {
     if (t == nullptr) {
@@ -332,7 +447,7 @@ auto bug_helper(boost::format& f, std::string message, std::string position,
 }
 
 template<typename T, class... Args>
-auto bug_helper(boost::format& f, std::string message, std::string position,
+auto bug_helper(Util::Format& f, std::string message, std::string position,
                 std::string tail, const T &t, Args... args) ->
     typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value, std::string>::type {
     cstring posString = t.getSourceInfo().toPositionString();
@@ -17,6 +17,13 @@ limitations under the License.
 #ifndef P4C_LIB_ERROR_REPORTER_H_
 #define P4C_LIB_ERROR_REPORTER_H_
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "error_helper.h"
 #include "error_catalog.h"
 #include "exceptions.h"
@@ -31,7 +38,7 @@ enum class DiagnosticAction {
 
 // Keeps track of compilation errors.
 // Errors are specified using the error() and warning() methods,
-// that use boost::format format strings, i.e.,
+// that use boost::format-style format strings, i.e.,
 // %1%, %2%, etc (starting at 1, not at 0).
 // Some compatibility for printf-style arguments is also supported.
 class ErrorReporter final {
@@ -41,6 +48,11 @@ class ErrorReporter final {
     /// Track errors or warnings that have already been issued for a particular source location
     std::set<std::pair<int, const Util::SourceInfo>> errorTracker;
 
+    /// Serializes diagnostic emission so that passes running concurrently
+    /// (e.g. in a ParallelPassGroup) neither interleave their messages nor
+    /// race on the counters.
+    std::mutex reportMutex;
+
     /// Output the message and flush the stream
     void emit_message(cstring message) {
         *outputstream << message;
@@ -52,6 +64,7 @@ class ErrorReporter final {
     /// If the error has been reported, return true. Otherwise, insert add the error to the
     /// list of seen errors, and return false.
     bool error_reported(int err, const Util::SourceInfo source) {
+        std::lock_guard<std::mutex> lock(reportMutex);
         auto p = errorTracker.emplace(err, source);
         return !p.second;  // if insertion took place, then we have not seen the error.
     }
@@ -61,25 +74,72 @@ class ErrorReporter final {
         return ErrorCatalog::getCatalog().getName(errorCode);
     }
 
+    /// A warning whose formatting has been postponed: the diagnostic name
+    /// plus a closure holding the format arguments.  The closure only runs
+    /// if the warning survives filtering at flush time.
+    struct DeferredDiagnostic {
+        cstring name;
+        std::function<std::string(const std::string& prefix)> format;
+        /// Lane of the sequenced section it was issued in, or -1; used to
+        /// put deferred warnings from concurrent passes into lane order.
+        int lane;
+    };
+
+    /// A diagnostic buffered during a sequenced section, already formatted;
+    /// the error flag drives the "no warnings after an error" rule, which
+    /// is applied at merge time where lane order makes it deterministic.
+    struct SequencedMessage {
+        bool isError;
+        std::string text;
+    };
+
  public:
     ErrorReporter()
         : errorCount(0),
           warningCount(0),
           maxErrorCount(20),
+          deferWarnings(false),
+          sequencing(false),
+          sectionDeferredStart(0),
+          sectionHadPriorErrors(false),
           defaultWarningDiagnosticAction(DiagnosticAction::Warn)
     { outputstream = &std::cerr; }
 
+    ~ErrorReporter() {
+        // Safety net: don't drop deferred warnings if no one flushed them.
+        // Can't fail on too many errors here -- no throwing in a destructor.
+        if (!deferred.empty())
+            flushDeferredWarnings(false);
+    }
+
+    // Copies all diagnostic state; the mutex is not copyable, so the copy
+    // gets its own.  Needed because CompileContext is copy-constructible.
+    ErrorReporter(const ErrorReporter& other)
+        : outputstream(other.outputstream),
+          errorTracker(other.errorTracker),
+          errorCount(other.errorCount.load()),
+          warningCount(other.warningCount.load()),
+          maxErrorCount(other.maxErrorCount),
+          deferWarnings(other.deferWarnings),
+          deferred(other.deferred),
+          sequencing(other.sequencing),
+          sequenced(other.sequenced),
+          sectionDeferredStart(other.sectionDeferredStart),
+          sectionHadPriorErrors(other.sectionHadPriorErrors),
+          defaultWarningDiagnosticAction(other.defaultWarningDiagnosticAction),
+          diagnosticActions(other.diagnosticActions) { }
+
     // error message for a bug
     template <typename... T>
     std::string bug_message(const char* format, T... args) {
-        boost::format fmt(format);
+        Util::Format fmt(format);
         std::string message = ::bug_helper(fmt, "", "", "", args...);
         return message;
     }
 
     template <typename... T>
     std::string format_message(const char* format, T... args) {
-        boost::format fmt(format);
+        Util::Format fmt(format);
         std::string message = ::error_helper(fmt, "", "", "", "", args...);
         return message;
     }
@@ -127,13 +187,31 @@ class ErrorReporter final {
                   const char* format, const char* suffix, T... args) {
         if (action == DiagnosticAction::Ignore) return;
 
+        std::lock_guard<std::mutex> lock(reportMutex);
+        int lane = sequencing ? sequenceLane() : -1;
+        bool buffered = lane >= 0 && size_t(lane) < sequenced.size();
         std::string prefix;
         if (action == DiagnosticAction::Warn) {
             // Avoid burying errors in a pile of warnings: don't emit any more warnings if we've
-            // emitted errors.
-            if (errorCount > 0) return;
+            // emitted errors.  In a sequenced section this rule is applied at
+            // merge time instead, so the decision does not depend on which
+            // worker's error landed first.
+            if (!buffered && errorCount.load() > 0) return;
 
             warningCount++;
+            if (deferWarnings) {
+                // Record the arguments and postpone formatting; the warning
+                // is filtered again (and only then formatted) at flush time.
+                DeferredDiagnostic d;
+                d.name = diagnosticName;
+                d.format = [=](const std::string& pfx) {
+                    Util::Format fmt(format);
+                    return ::error_helper(fmt, pfx, "", "", suffix, args...);
+                };
+                d.lane = lane;
+                deferred.push_back(d);
+                return;
+            }
             if (diagnosticName != nullptr) {
                 prefix.append("[--Wwarn=");
                 prefix.append(diagnosticName);
@@ -152,13 +230,127 @@ class ErrorReporter final {
             }
         }
 
-        boost::format fmt(format);
+        Util::Format fmt(format);
         std::string message = ::error_helper(fmt, prefix, "", "", suffix, args...);
-        emit_message(message);
+        if (buffered)
+            sequenced[lane].push_back(
+                SequencedMessage{action == DiagnosticAction::Error, std::move(message)});
+        else
+            emit_message(message);
         if (errorCount >= maxErrorCount)
             FATAL_ERROR("Number of errors exceeded set maximum of %1%", maxErrorCount);
     }
 
+    /// Lane of the calling thread within a sequenced section, -1 when it
+    /// has none.  Thread-local: each worker sets its own lane (through
+    /// SequenceLaneScope) without affecting the others.
+    static int& sequenceLane() {
+        static thread_local int lane = -1;
+        return lane;
+    }
+
+    /// RAII assignment of the calling thread to a lane for the duration of
+    /// a unit of concurrent work.
+    struct SequenceLaneScope {
+        int previous;
+        explicit SequenceLaneScope(int lane) : previous(sequenceLane())
+        { sequenceLane() = lane; }
+        ~SequenceLaneScope() { sequenceLane() = previous; }
+    };
+
+    /// Start a sequenced section with @p lanes lanes.  Until the matching
+    /// endSequencedEmission(), diagnostics raised on a thread that declared
+    /// a lane are buffered per lane instead of printed; threads without a
+    /// lane (e.g. the main thread) keep printing directly.  Deterministic
+    /// ordering presumes each lane is filled by one worker at a time.
+    void beginSequencedEmission(size_t lanes) {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        sequencing = true;
+        sequenced.assign(lanes, {});
+        sectionDeferredStart = deferred.size();
+        sectionHadPriorErrors = errorCount.load() > 0;
+    }
+
+    /// End the sequenced section and emit the buffered diagnostics in lane
+    /// order, each lane's in issue order -- the order a sequential run of
+    /// the lanes would have produced, independent of scheduling.  Deferred
+    /// warnings recorded during the section are put into the same order for
+    /// their eventual flush.
+    void endSequencedEmission() {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        sequencing = false;
+        std::string batch;
+        bool errorSeen = sectionHadPriorErrors;
+        for (auto& lane : sequenced) {
+            for (auto& m : lane) {
+                if (!m.isError && errorSeen) {
+                    warningCount--;   // suppressed, as in a sequential run
+                    continue;
+                }
+                errorSeen = errorSeen || m.isError;
+                batch += m.text;
+            }
+        }
+        sequenced.clear();
+        std::stable_sort(deferred.begin() + sectionDeferredStart, deferred.end(),
+                         [](const DeferredDiagnostic& a, const DeferredDiagnostic& b) {
+                             return a.lane < b.lane; });
+        if (!batch.empty())
+            emit_message(batch);
+    }
+
+
+    /// Defer warnings: record them instead of formatting and printing them
+    /// immediately.  They are formatted, filtered against the diagnostic
+    /// actions in effect at that point, and printed in one batch by
+    /// flushDeferredWarnings().  Errors are always reported eagerly.
+    void setDeferWarnings(bool defer) { deferWarnings = defer; }
+
+    /// Format and emit the warnings recorded while deferral was enabled.
+    /// Warnings whose action was changed to Ignore in the meantime (e.g. by
+    /// a @diagnostic or @noWarn pragma processed after the warning was
+    /// issued) are dropped without ever being formatted; warnings upgraded
+    /// to errors are counted and printed as errors.
+    void flushDeferredWarnings(bool failOnTooManyErrors = true) {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        std::vector<DeferredDiagnostic> pending;
+        pending.swap(deferred);
+        std::string batch;
+        bool upgraded = false;
+        for (auto& d : pending) {
+            auto action = getDiagnosticAction(d.name, DiagnosticAction::Warn);
+            if (action == DiagnosticAction::Ignore || errorCount.load() > 0) {
+                warningCount--;
+                continue;
+            }
+            std::string prefix;
+            if (action == DiagnosticAction::Error) {
+                warningCount--;
+                errorCount++;
+                upgraded = true;
+                if (!d.name.isNull()) {
+                    prefix.append("[--Werror=");
+                    prefix.append(d.name);
+                    prefix.append("] error: ");
+                } else {
+                    prefix.append("error: ");
+                }
+            } else {
+                if (!d.name.isNull()) {
+                    prefix.append("[--Wwarn=");
+                    prefix.append(d.name);
+                    prefix.append("] warning: ");
+                } else {
+                    prefix.append("warning: ");
+                }
+            }
+            batch += d.format(prefix);
+        }
+        if (!batch.empty())
+            emit_message(batch);
+        if (failOnTooManyErrors && upgraded && errorCount >= maxErrorCount)
+            FATAL_ERROR("Number of errors exceeded set maximum of %1%", maxErrorCount);
+    }
 
     unsigned getErrorCount() const { return errorCount; }
 
@@ -184,6 +376,7 @@ class ErrorReporter final {
     /// position information provided by Bison.
     template <typename T>
     void parser_error(const Util::SourceInfo& location, const T& message) {
+        std::lock_guard<std::mutex> lock(reportMutex);
         errorCount++;
         *outputstream << location.toPositionString() << ":" << message << std::endl;
         emit_message(location.toSourceFragment());  // This flushes the stream.
@@ -199,6 +392,7 @@ class ErrorReporter final {
         va_list args;
         va_start(args, fmt);
 
+        std::lock_guard<std::mutex> lock(reportMutex);
         errorCount++;
 
         Util::SourcePosition position = sources->getCurrentPosition();
@@ -243,10 +437,30 @@ class ErrorReporter final {
     }
 
  private:
-    unsigned errorCount;
-    unsigned warningCount;
+    // Atomic so that other threads (e.g. a pass manager polling
+    // ::errorCount() while workers run) read consistent values; updates
+    // happen under reportMutex along with the message emission.
+    std::atomic<unsigned> errorCount;
+    std::atomic<unsigned> warningCount;
     unsigned maxErrorCount;  /// the maximum number of errors that we print before fail
 
+    /// If true, warnings are recorded in `deferred` instead of being
+    /// formatted and printed as they are issued.
+    bool deferWarnings;
+
+    /// Warnings recorded while deferral was enabled, in issue order.
+    std::vector<DeferredDiagnostic> deferred;
+
+    /// True between beginSequencedEmission and endSequencedEmission.
+    bool sequencing;
+    /// Per-lane buffers of formatted diagnostics for the current section.
+    std::vector<std::vector<SequencedMessage>> sequenced;
+    /// Size of `deferred` when the current section started; entries past it
+    /// are reordered by lane when the section ends.
+    size_t sectionDeferredStart;
+    /// Whether errors predated the section (then all its warnings drop).
+    bool sectionHadPriorErrors;
+
     /// The default diagnostic action for calls to `::warning()`.
     DiagnosticAction defaultWarningDiagnosticAction;
 
@@ -30,7 +30,7 @@ constexpr char ANSI_BLUE[] = "\e[34m";
 constexpr char ANSI_CLR[]  = "\e[0m";
 
 /// Base class for all exceptions.
-/// The constructor uses boost::format for the format string, i.e.,
+/// The constructor uses a boost::format-style format string, i.e.,
 /// %1%, %2%, etc (starting at 1, not at 0)
 class P4CExceptionBase : public std::exception {
  protected:
@@ -41,7 +41,7 @@ class P4CExceptionBase : public std::exception {
     template <typename... T>
     P4CExceptionBase(const char* format, T... args) {
         traceCreation();
-        boost::format fmt(format);
+        Util::Format fmt(format);
         message = ::bug_helper(fmt, "", "", "", std::forward<T>(args)...);
     }
 
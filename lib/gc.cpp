@@ -19,13 +19,18 @@ limitations under the License.
 #include <gc/gc_cpp.h>
 #include <gc/gc_mark.h>
 #endif  /* HAVE_LIBGC */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
+#include <mutex>
 #include <new>
 #include "log.h"
 #include "gc.h"
 #include "cstring.h"
 #include "n4.h"
 #include "backtrace.h"
+#include "tracepoints.h"
 
 /* glibc++ requires defining global delete with this exception spec to avoid warnings.
  * If it's not defined, probably not using glibc++ and don't need anything */
@@ -41,6 +46,68 @@ static char *emergency_ptr;
 
 // One can disable the GC, e.g., to run under Valgrind, by editing config.h
 #if HAVE_LIBGC
+
+#if HAVE_GC_COLLECTION_EVENT
+static uint64_t gc_now_nsec() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+static uint64_t pause_begin_nsec, total_pause_nsec, longest_pause_nsec;
+static size_t free_before_gc, total_freed_bytes;
+
+// Times each collection from start to end.  For the default stop-the-world
+// configuration that is exactly the pause the rest of the compiler sees;
+// under incremental marking it overcounts the stopped time somewhat.
+static void gc_event(GC_EventType event) {
+    switch (event) {
+    case GC_EVENT_START:
+        P4C_PROBE(gc_start);
+        pause_begin_nsec = gc_now_nsec();
+        free_before_gc = GC_get_free_bytes();
+        break;
+    case GC_EVENT_END: {
+        uint64_t pause = gc_now_nsec() - pause_begin_nsec;
+        total_pause_nsec += pause;
+        if (pause > longest_pause_nsec) longest_pause_nsec = pause;
+        size_t free_now = GC_get_free_bytes();
+        if (free_now > free_before_gc)
+            total_freed_bytes += free_now - free_before_gc;
+        P4C_PROBE2(gc_end, pause, free_now > free_before_gc ? free_now - free_before_gc : 0);
+        break; }
+    default:
+        break;
+    }
+}
+#endif  /* HAVE_GC_COLLECTION_EVENT */
+
+/* Initialize the collector with parallel marking sized to the machine.  The
+ * marker count can only be set before GC_INIT, which runs from the very
+ * first allocation, long before option processing -- so this is automatic
+ * rather than a CompilerOptions knob.  An explicit GC_MARKERS in the
+ * environment wins, and a libgc built without PARALLEL_MARK ignores the
+ * setting entirely. */
+static void init_gc() {
+    if (!getenv("GC_MARKERS")) {
+        long markers = sysconf(_SC_NPROCESSORS_ONLN);
+        if (markers > 8) markers = 8;  // marking scales poorly past this
+        if (markers > 1) {
+#if HAVE_GC_SET_MARKERS_COUNT
+            GC_set_markers_count(markers);
+#else
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%ld", markers);
+            setenv("GC_MARKERS", buf, 0);
+#endif /* HAVE_GC_SET_MARKERS_COUNT */
+        }
+    }
+    GC_INIT();
+#if HAVE_GC_COLLECTION_EVENT
+    GC_set_on_collection_event(gc_event);
+#endif /* HAVE_GC_COLLECTION_EVENT */
+}
+
 void *operator new(std::size_t size) {
     /* DANGER -- on OSX, can't safely call the garbage collector allocation
      * routines from a static global constructor without manually initializing
@@ -48,7 +115,7 @@ void *operator new(std::size_t size) {
      * memory, we need to force initialization */
     if (!done_init) {
         started_init = true;
-        GC_INIT();
+        init_gc();
         done_init = true; }
     auto *rv = ::operator new(size, UseGC, 0, 0);
     if (!rv && emergency_ptr && emergency_ptr + size < emergency_pool + sizeof(emergency_pool)) {
@@ -82,7 +149,7 @@ void *realloc(void *ptr, size_t size) {
             return rv;
         } else {
             started_init = true;
-            GC_INIT();
+            init_gc();
             done_init = true; } }
     if (ptr) {
         if (GC_is_heap_ptr(ptr))
@@ -113,8 +180,11 @@ extern "C" int GC_print_stats;
 #endif /* HAVE_GC_PRINT_STATS */
 
 static int gc_logging_level;
+static size_t heap_watermark;
 
 static void gc_callback() {
+    if (GC_get_heap_size() > heap_watermark)
+        heap_watermark = GC_get_heap_size();
     if (gc_logging_level >= 1) {
         std::clog << "****** GC called ****** (heap size " << n4(GC_get_heap_size()) << ")";
         size_t count, size = cstring::cache_size(count);
@@ -143,6 +213,61 @@ void setup_gc_logging() {
 #endif  /* HAVE_LIBGC */
 }
 
+void gc_register_thread() {
+#if HAVE_LIBGC
+    static std::once_flag allow_registration;
+    std::call_once(allow_registration, []() { GC_allow_register_threads(); });
+    GC_stack_base sb;
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+#endif  /* HAVE_LIBGC */
+}
+
+void gc_unregister_thread() {
+#if HAVE_LIBGC
+    GC_unregister_my_thread();
+#endif  /* HAVE_LIBGC */
+}
+
+size_t gc_bytes_allocated() {
+#if HAVE_LIBGC
+    // cumulative allocation, cheap to read (no collection triggered)
+    return GC_get_total_bytes();
+#else
+    return 0;
+#endif
+}
+
+size_t gc_heap_size() {
+#if HAVE_LIBGC
+    return GC_get_heap_size();
+#else
+    return 0;
+#endif
+}
+
+size_t gc_heap_watermark() {
+#if HAVE_LIBGC
+    // the heap rarely shrinks, so polling here and at each collection
+    // start (gc_callback) tracks the peak closely
+    if (GC_get_heap_size() > heap_watermark)
+        heap_watermark = GC_get_heap_size();
+    return heap_watermark;
+#else
+    return 0;
+#endif
+}
+
+size_t gc_object_size(const void *p) {
+#if HAVE_LIBGC
+    if (done_init && GC_is_heap_ptr(const_cast<void *>(p)))
+        return GC_size(const_cast<void *>(p));
+#else
+    (void)p;
+#endif
+    return 0;
+}
+
 size_t gc_mem_inuse(size_t *max) {
 #if HAVE_LIBGC
     GC_word heapsize, heapfree;
@@ -155,3 +280,56 @@ size_t gc_mem_inuse(size_t *max) {
     return 0;
 #endif
 }
+
+void gc_enable_incremental() {
+#if HAVE_LIBGC
+    GC_enable_incremental();
+#endif
+}
+
+void gc_set_free_space_divisor(unsigned divisor) {
+#if HAVE_LIBGC
+    if (divisor > 0)
+        GC_set_free_space_divisor(divisor);
+#else
+    (void)divisor;
+#endif
+}
+
+void gc_disable() {
+#if HAVE_LIBGC
+    GC_disable();
+#endif
+}
+
+size_t gc_collections() {
+#if HAVE_LIBGC
+    return done_init ? GC_get_gc_no() : 0;
+#else
+    return 0;
+#endif
+}
+
+uint64_t gc_pause_nsec() {
+#if HAVE_LIBGC && HAVE_GC_COLLECTION_EVENT
+    return total_pause_nsec;
+#else
+    return 0;
+#endif
+}
+
+uint64_t gc_max_pause_nsec() {
+#if HAVE_LIBGC && HAVE_GC_COLLECTION_EVENT
+    return longest_pause_nsec;
+#else
+    return 0;
+#endif
+}
+
+size_t gc_freed_bytes() {
+#if HAVE_LIBGC && HAVE_GC_COLLECTION_EVENT
+    return total_freed_bytes;
+#else
+    return 0;
+#endif
+}
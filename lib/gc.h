@@ -18,8 +18,42 @@ limitations under the License.
 #define LIB_GC_H_
 
 #include <cstddef>
+#include <cstdint>
 
 void setup_gc_logging();
 size_t gc_mem_inuse(size_t *max = 0);  // trigger GC, return inuse after
+size_t gc_bytes_allocated();  // cumulative bytes allocated; 0 without libgc
+size_t gc_heap_size();  // current heap size, cheap to read; 0 without libgc
+size_t gc_heap_watermark();  // largest heap size observed so far
+// allocated size of the object at @p, or 0 if @p is not a GC heap pointer
+size_t gc_object_size(const void *p);
+
+// Register/unregister the calling thread with the collector so that it can
+// safely allocate; no-ops when not built with libgc.  Worker threads (e.g.
+// those spawned by ParallelPassGroup) must register before touching the heap.
+void gc_register_thread();
+void gc_unregister_thread();
+
+// Collector tuning, applied from CompilerOptions; no-ops without libgc.
+// Parallel marking is configured automatically before the collector starts
+// (markers sized to the available cores); these expose the remaining knobs.
+void gc_enable_incremental();  // shorter pauses, some throughput cost
+// Heap growth policy: higher values keep the heap smaller at the cost of
+// more frequent collections (the libgc default is 3); 0 is ignored.
+void gc_set_free_space_divisor(unsigned divisor);
+// Permanently disable collection: the GC heap only grows and is reclaimed
+// at process exit.  Used by --arena-alloc (Util::Arena), where GC-heap
+// objects (string storage, vector buffers, ...) may be reachable only from
+// arena memory the collector does not scan, so collecting would free live
+// objects.  No-op without libgc.
+void gc_disable();
+
+// Collector statistics, cheap to read; all 0 without libgc.  The pause and
+// freed-bytes counters additionally need a libgc with collection-event
+// callbacks (HAVE_GC_COLLECTION_EVENT) and read as 0 without one.
+size_t gc_collections();       // collections completed so far
+uint64_t gc_pause_nsec();      // cumulative wall time spent collecting
+uint64_t gc_max_pause_nsec();  // longest single collection
+size_t gc_freed_bytes();       // cumulative bytes reclaimed by collections
 
 #endif /* LIB_GC_H_ */
@@ -14,6 +14,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
 #include "gmputil.h"
 
@@ -40,6 +42,10 @@ big_int ripBits(big_int &value, int bits) {
 }
 
 big_int mask(unsigned bits) {
+    if (bits <= 64)
+        // single conversion from a machine word instead of a chain of
+        // shift/subtract temporaries; nearly all requested widths land here
+        return big_int(bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1);
     big_int one = 1;
     big_int result = shift_left(one, bits);
     return result - 1;
@@ -48,6 +54,11 @@ big_int mask(unsigned bits) {
 big_int maskFromSlice(unsigned m, unsigned l) {
     if (m < l)
         throw std::logic_error("wrong argument order in maskFromSlice");
+    if (m < 64) {
+        uint64_t hi = (m == 63) ? ~uint64_t(0) : (uint64_t(1) << (m + 1)) - 1;
+        uint64_t lo = (uint64_t(1) << l) - 1;  // l <= m < 64
+        return big_int(hi - lo);
+    }
     big_int result = mask(m+1) - mask(l);
     return result;
 }
@@ -69,29 +80,48 @@ BitRange findOnes(const big_int &value) {
 
 big_int cvtInt(const char *s, unsigned base) {
     big_int rv;
+    // Nearly every literal fits in a machine word; accumulate there and
+    // only move to big_int arithmetic once the value grows too large.
+    // Below this limit another digit cannot overflow for any base <= 16.
+    static const uint64_t limit = (std::numeric_limits<uint64_t>::max() - 15) / 16;
+    uint64_t small = 0;
+    bool fits = true;
 
     while (*s) {
+        int digit;
         switch (*s) {
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
-            rv *= base;
-            rv += *s - '0';
+            digit = *s - '0';
             break;
         case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
-            rv *= base;
-            rv += *s - 'a' + 10;
+            digit = *s - 'a' + 10;
             break;
         case 'A': case 'B': case 'C': case 'D': case 'E': case 'F':
-            rv *= base;
-            rv += *s - 'A' + 10;
+            digit = *s - 'A' + 10;
             break;
         case '_':
+            digit = -1;
             break;
         default:
             throw std::logic_error(std::string("Unexpected character ") + *s);
         }
+        if (digit >= 0) {
+            if (fits && small <= limit) {
+                small = small * base + digit;
+            } else {
+                if (fits) {
+                    rv = small;
+                    fits = false;
+                }
+                rv *= base;
+                rv += digit;
+            }
+        }
         s++;
     }
+    if (fits)
+        rv = small;
     return rv;
 }
 
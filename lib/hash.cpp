@@ -139,5 +139,93 @@ struct murmur<sizeof(std::uint64_t)> {
 std::size_t murmur(const void *data, std::size_t size) {
     return Detail::murmur<>::hash(data, size);
 }
+
+/* A condensed form of wyhash (public domain).  The core primitive is a
+ * 64x64->128 multiply folded to 64 bits; long inputs go through three
+ * independent lanes per 48-byte stripe, which keeps the multipliers
+ * pipelined and outruns byte-at-a-time hashes by an order of magnitude
+ * without any architecture-specific code. */
+namespace Detail {
+
+static const std::uint64_t wyp0 = UINT64_C(0xa0761d6478bd642f);
+static const std::uint64_t wyp1 = UINT64_C(0xe7037ed1a0b428db);
+static const std::uint64_t wyp2 = UINT64_C(0x8ebc6af09c88c6e3);
+static const std::uint64_t wyp3 = UINT64_C(0x589965cc75374cc3);
+
+static inline std::uint64_t wymum(std::uint64_t a, std::uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+    std::uint64_t ha = a >> 32, la = static_cast<std::uint32_t>(a);
+    std::uint64_t hb = b >> 32, lb = static_cast<std::uint32_t>(b);
+    std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    std::uint64_t t = rl + (rm0 << 32), carry = t < rl;
+    std::uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+    return lo ^ hi;
+#endif
+}
+
+static inline std::uint64_t wyr8(const unsigned char *p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+static inline std::uint64_t wyr4(const unsigned char *p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+static inline std::uint64_t wyr3(const unsigned char *p, std::size_t k) {
+    return (static_cast<std::uint64_t>(p[0]) << 16)
+         | (static_cast<std::uint64_t>(p[k >> 1]) << 8)
+         | p[k - 1];
+}
+
+}  // namespace Detail
+
+std::uint64_t hash(const void *data, std::size_t size, std::uint64_t seed) {
+    using namespace Detail;
+    auto p = static_cast<const unsigned char *>(data);
+    seed ^= wymum(seed ^ wyp0, wyp1);
+    std::uint64_t a, b;
+    if (size <= 16) {
+        if (size >= 4) {
+            a = (wyr4(p) << 32) | wyr4(p + ((size >> 3) << 2));
+            b = (wyr4(p + size - 4) << 32) | wyr4(p + size - 4 - ((size >> 3) << 2));
+        } else if (size > 0) {
+            a = wyr3(p, size);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        std::size_t i = size;
+        if (i > 48) {
+            std::uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wymum(wyr8(p) ^ wyp1, wyr8(p + 8) ^ seed);
+                see1 = wymum(wyr8(p + 16) ^ wyp2, wyr8(p + 24) ^ see1);
+                see2 = wymum(wyr8(p + 32) ^ wyp3, wyr8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wymum(wyr8(p) ^ wyp1, wyr8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = wyr8(p + i - 16);
+        b = wyr8(p + i - 8);
+    }
+    return wymum(wyp1 ^ size, wymum(a ^ wyp1, b ^ seed));
+}
+
 }  // namespace Hash
 }  // namespace Util
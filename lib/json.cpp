@@ -14,6 +14,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <climits>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <sstream>
 #include "json.h"
@@ -22,6 +25,83 @@ limitations under the License.
 
 namespace Util {
 
+namespace {
+
+// Format @v backwards from @end; returns the first digit.
+char* formatUint(char* end, unsigned long long v) {
+    do {
+        *--end = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    return end;
+}
+
+// The first byte in [p, end) that appendJsonEscaped must escape, or @end.
+// SWAR scan: a word has a byte equal to n iff subtracting 1 from every byte
+// of word^(n repeated) borrows into a byte's high bit that was clear.
+const char* findEscape(const char* p, const char* end) {
+    const uintptr_t ones = ~uintptr_t(0) / 0xff;      // 0x0101...01
+    const uintptr_t high = ones << 7;                 // 0x8080...80
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(uintptr_t))) {
+        uintptr_t w;
+        memcpy(&w, p, sizeof(w));
+        uintptr_t q = w ^ (ones * '"');
+        uintptr_t b = w ^ (ones * '\\');
+        if (((q - ones) & ~q & high) | ((b - ones) & ~b & high))
+            break;  // some byte in this word needs escaping
+        p += sizeof(w); }
+    while (p < end && *p != '"' && *p != '\\') ++p;
+    return p;
+}
+
+}  // namespace
+
+void appendJsonNumber(std::string& out, const big_int& v) {
+    if (v < std::numeric_limits<long long>::min() ||
+        v > std::numeric_limits<unsigned long long>::max()) {
+        out += v.str();
+        return; }
+    char buf[24];  // 20 digits at most, plus sign and slack
+    char* end = buf + sizeof(buf);
+    char* p;
+    if (v < 0) {
+        auto mag = static_cast<unsigned long long>(v.convert_to<long long>());
+        p = formatUint(end, 0ULL - mag);  // two's complement magnitude
+        *--p = '-';
+    } else {
+        p = formatUint(end, v.convert_to<unsigned long long>()); }
+    out.append(p, end - p);
+}
+
+void writeJsonNumber(std::ostream& out, const big_int& v) {
+    if (v < std::numeric_limits<long long>::min() ||
+        v > std::numeric_limits<unsigned long long>::max()) {
+        out << v.str();
+        return; }
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* p;
+    if (v < 0) {
+        auto mag = static_cast<unsigned long long>(v.convert_to<long long>());
+        p = formatUint(end, 0ULL - mag);
+        *--p = '-';
+    } else {
+        p = formatUint(end, v.convert_to<unsigned long long>()); }
+    out.write(p, end - p);
+}
+
+void appendJsonEscaped(std::string& out, const char* s, size_t len) {
+    const char* p = s;
+    const char* end = s + len;
+    while (p < end) {
+        const char* stop = findEscape(p, end);
+        out.append(p, stop - p);
+        if (stop == end) break;
+        out += '\\';
+        out += *stop;
+        p = stop + 1; }
+}
+
 cstring IJson::toString() const {
     std::stringstream str;
     serialize(str);
@@ -70,7 +150,7 @@ void JsonValue::serialize(std::ostream& out) const {
             out << "\"" << str << "\"";
             break;
         case Kind::Number:
-            out << value;
+            writeJsonNumber(out, value);
             break;
         case Kind::True:
             out << "true";
@@ -209,4 +289,207 @@ JsonObject* JsonObject::emplace_non_null(cstring label, IJson* value) {
     return this;
 }
 
+// ------------------ CBOR (RFC 7049) ------------------
+
+namespace {
+
+// Initial byte(s) of a data item: major type and count (the value itself
+// for integers, the length for strings and containers), big-endian in the
+// smallest of the five definite-length encodings.
+void cborHead(std::ostream& out, unsigned major, unsigned long long count) {
+    unsigned char buf[9];
+    size_t extra;
+    if (count < 24) {
+        buf[0] = (major << 5) | static_cast<unsigned char>(count);
+        extra = 0;
+    } else if (count <= 0xff) {
+        buf[0] = (major << 5) | 24;
+        extra = 1;
+    } else if (count <= 0xffff) {
+        buf[0] = (major << 5) | 25;
+        extra = 2;
+    } else if (count <= 0xffffffff) {
+        buf[0] = (major << 5) | 26;
+        extra = 4;
+    } else {
+        buf[0] = (major << 5) | 27;
+        extra = 8;
+    }
+    for (size_t i = 0; i < extra; i++)
+        buf[extra - i] = static_cast<unsigned char>(count >> (8 * i));
+    out.write(reinterpret_cast<char*>(buf), 1 + extra);
+}
+
+// The byte-string payload of a bignum tag: the big-endian magnitude bytes.
+// Avoids boost's export_bits so it works with both the gmp and the cpp_int
+// backing of big_int; bignums only occur for values over 64 bits, so speed
+// is irrelevant.
+void cborBignum(std::ostream& out, big_int magnitude) {
+    std::vector<unsigned char> bytes;
+    while (magnitude != 0) {
+        bytes.push_back(static_cast<unsigned char>(
+            (magnitude & 0xff).convert_to<unsigned>()));
+        magnitude >>= 8;
+    }
+    cborHead(out, 2, bytes.size());
+    for (size_t i = bytes.size(); i > 0; i--)
+        out.put(static_cast<char>(bytes[i - 1]));
+}
+
+unsigned char cborByte(std::istream& in) {
+    int c = in.get();
+    if (c == EOF)
+        throw std::runtime_error("truncated CBOR input");
+    return static_cast<unsigned char>(c);
+}
+
+unsigned long long cborCount(std::istream& in, unsigned char info) {
+    if (info < 24)
+        return info;
+    size_t extra;
+    switch (info) {
+        case 24: extra = 1; break;
+        case 25: extra = 2; break;
+        case 26: extra = 4; break;
+        case 27: extra = 8; break;
+        default:
+            // 28-30 are reserved, 31 starts an indefinite length, which
+            // serializeCBOR never produces
+            throw std::runtime_error("unsupported CBOR length encoding");
+    }
+    unsigned long long count = 0;
+    for (size_t i = 0; i < extra; i++)
+        count = (count << 8) | cborByte(in);
+    return count;
+}
+
+cstring cborText(std::istream& in) {
+    unsigned char head = cborByte(in);
+    if ((head >> 5) != 3)
+        throw std::runtime_error("expected a CBOR text string");
+    auto length = cborCount(in, head & 0x1f);
+    std::string s(length, 0);
+    if (length > 0)
+        in.read(&s[0], length);
+    if (!in)
+        throw std::runtime_error("truncated CBOR input");
+    return cstring(s);
+}
+
+}  // namespace
+
+void JsonValue::serializeCBOR(std::ostream& out) const {
+    switch (tag) {
+        case Kind::String:
+            cborHead(out, 3, str.size());
+            out.write(str.c_str(), str.size());
+            break;
+        case Kind::Number:
+            if (value >= 0) {
+                if (value <= std::numeric_limits<unsigned long long>::max())
+                    cborHead(out, 0, value.convert_to<unsigned long long>());
+                else
+                    { out.put(static_cast<char>(0xc2)); cborBignum(out, value); }
+            } else {
+                big_int magnitude = -1 - value;
+                if (magnitude <= std::numeric_limits<unsigned long long>::max())
+                    cborHead(out, 1, magnitude.convert_to<unsigned long long>());
+                else
+                    { out.put(static_cast<char>(0xc3)); cborBignum(out, magnitude); }
+            }
+            break;
+        case Kind::True:
+            out.put(static_cast<char>(0xf5));
+            break;
+        case Kind::False:
+            out.put(static_cast<char>(0xf4));
+            break;
+        case Kind::Null:
+            out.put(static_cast<char>(0xf6));
+            break;
+    }
+}
+
+void JsonArray::serializeCBOR(std::ostream& out) const {
+    cborHead(out, 4, size());
+    for (auto v : *this) {
+        if (v == nullptr)
+            out.put(static_cast<char>(0xf6));
+        else
+            v->serializeCBOR(out);
+    }
+}
+
+void JsonObject::serializeCBOR(std::ostream& out) const {
+    cborHead(out, 5, size());
+    for (auto &it : *this) {
+        cborHead(out, 3, it.first.size());
+        out.write(it.first.c_str(), it.first.size());
+        if (it.second == nullptr)
+            out.put(static_cast<char>(0xf6));
+        else
+            it.second->serializeCBOR(out);
+    }
+}
+
+IJson* IJson::loadCBOR(std::istream& in) {
+    unsigned char head = cborByte(in);
+    unsigned info = head & 0x1f;
+    switch (head >> 5) {
+        case 0:  // unsigned integer
+            return new JsonValue(big_int(cborCount(in, info)));
+        case 1: {  // negative integer, encoded as -1 - count
+            big_int magnitude = cborCount(in, info);
+            return new JsonValue(big_int(-1 - magnitude));
+        }
+        case 2:  // bare byte strings only appear inside a bignum tag
+            throw std::runtime_error("unexpected CBOR byte string");
+        case 3: {  // text string
+            auto length = cborCount(in, info);
+            std::string s(length, 0);
+            if (length > 0)
+                in.read(&s[0], length);
+            if (!in)
+                throw std::runtime_error("truncated CBOR input");
+            return new JsonValue(s);
+        }
+        case 4: {  // array
+            auto length = cborCount(in, info);
+            auto result = new JsonArray();
+            for (unsigned long long i = 0; i < length; i++)
+                result->append(loadCBOR(in));
+            return result;
+        }
+        case 5: {  // map; keys are always text strings here
+            auto length = cborCount(in, info);
+            auto result = new JsonObject();
+            for (unsigned long long i = 0; i < length; i++) {
+                cstring label = cborText(in);
+                result->emplace(label, loadCBOR(in));
+            }
+            return result;
+        }
+        case 6: {  // tag; only the two bignum tags are produced
+            auto tag = cborCount(in, info);
+            if (tag != 2 && tag != 3)
+                throw std::runtime_error("unsupported CBOR tag");
+            unsigned char inner = cborByte(in);
+            if ((inner >> 5) != 2)
+                throw std::runtime_error("CBOR bignum tag without byte string");
+            auto length = cborCount(in, inner & 0x1f);
+            big_int magnitude = 0;
+            for (unsigned long long i = 0; i < length; i++)
+                magnitude = (magnitude << 8) | cborByte(in);
+            return new JsonValue(tag == 2 ? magnitude : big_int(-1 - magnitude));
+        }
+        default:  // simple values; floats are never produced
+            switch (info) {
+                case 20: return new JsonValue(false);
+                case 21: return new JsonValue(true);
+                case 22: return new JsonValue();
+                default: throw std::runtime_error("unsupported CBOR simple value");
+            }
+    }
+}
+
 }  // namespace Util
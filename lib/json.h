@@ -35,6 +35,15 @@ class IJson {
  public:
     virtual ~IJson() {}
     virtual void serialize(std::ostream& out) const = 0;
+    /* CBOR (RFC 7049) rendering of the same document: objects become maps,
+     * arrays become arrays, strings text strings, numbers (un)signed
+     * integers -- or tagged bignums when they exceed 64 bits -- and
+     * true/false/null their simple values.  All lengths are definite, so
+     * the encoding of a given document is byte-for-byte reproducible.
+     * loadCBOR inverts it (and rejects CBOR constructs serializeCBOR never
+     * emits, such as floats or indefinite lengths). */
+    virtual void serializeCBOR(std::ostream& out) const = 0;
+    static IJson* loadCBOR(std::istream& in);
     cstring toString() const;
     template<typename T> bool is() const { return to<T>() != nullptr; }
     template<typename T> T* to() { return dynamic_cast<T*>(this); }
@@ -68,6 +77,7 @@ class JsonValue final : public IJson {
     JsonValue(const std::string &s) : tag(Kind::String), str(s) {}    // NOLINT
     JsonValue(const char* s) : tag(Kind::String), str(s) {}           // NOLINT
     void serialize(std::ostream& out) const;
+    void serializeCBOR(std::ostream& out) const;
 
     bool operator==(const big_int& v) const;
     // is_integral is true for bool
@@ -111,6 +121,7 @@ class JsonArray final : public IJson, public std::vector<IJson*> {
     friend class Test::TestJson;
  public:
     void serialize(std::ostream& out) const;
+    void serializeCBOR(std::ostream& out) const;
     JsonArray* clone() const { return new JsonArray(*this); }
     JsonArray* append(IJson* value);
     JsonArray* append(big_int v) { append(new JsonValue(v)); return this; }
@@ -136,6 +147,7 @@ class JsonObject final : public IJson, public ordered_map<cstring, IJson*> {
  public:
     JsonObject() = default;
     void serialize(std::ostream& out) const;
+    void serializeCBOR(std::ostream& out) const;
     JsonObject* emplace(cstring label, IJson* value);
     JsonObject* emplace_non_null(cstring label, IJson* value);
     JsonObject* emplace(cstring label, big_int v)
@@ -154,6 +166,20 @@ class JsonObject final : public IJson, public ordered_map<cstring, IJson*> {
     IJson* get(cstring label) const { return ::get(*this, label); }
 };
 
+// Low-level serialization helpers, shared between IJson::serialize and the
+// streaming emitters built on top of it (e.g. BMV2::JsonWriter).
+
+/// Append @v to @out in JSON number syntax.  Values that fit in a machine
+/// word -- nearly all of them in practice -- are formatted into a stack
+/// buffer; only wider values go through big_int's string conversion.
+void appendJsonNumber(std::string& out, const big_int& v);
+/// As appendJsonNumber, writing to a stream.
+void writeJsonNumber(std::ostream& out, const big_int& v);
+/// Append @len bytes at @s to @out, backslash-escaping '"' and '\' (the
+/// escapes cstring::escapeJson produces).  Scans a word at a time and
+/// bulk-copies the spans that need no escaping.
+void appendJsonEscaped(std::string& out, const char* s, size_t len);
+
 }  // namespace Util
 
 #endif  /* _LIB_JSON_H_ */
@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef P4C_LIB_LOG_H_
 #define P4C_LIB_LOG_H_
 
+#include <atomic>
 #include <functional>
 #include <iostream>
 #include <set>
@@ -37,6 +38,18 @@ extern int verbosity;
 // A cache of the maximum log level requested for any file.
 extern int maximumLogLevel;
 
+// Bumped whenever the debug specs or the verbosity change, so that
+// per-call-site caches know to recompute their level.
+extern std::atomic<int> cacheGeneration;
+
+// Per-call-site cache of the file log level; embedded as a function-local
+// static by the LOGGING macro so that a disabled call site costs one
+// generation check after the first visit.
+struct LevelCache {
+    std::atomic<int> generation{-1};
+    std::atomic<int> level{0};
+};
+
 // Look up the log level of @file.
 int fileLogLevel(const char* file);
 std::ostream &fileLogOutput(const char *file);
@@ -77,6 +90,17 @@ inline bool fileLogLevelIsAtLeast(const char* file, int level) {
     return Detail::fileLogLevel(file) >= level;
 }
 
+inline bool fileLogLevelIsAtLeast(Detail::LevelCache &cache, const char* file, int level) {
+    int generation = Detail::cacheGeneration.load(std::memory_order_acquire);
+    if (cache.generation.load(std::memory_order_acquire) != generation) {
+        // Slow path, taken once per call site and again after any spec
+        // change; a racing thread at worst recomputes the same value.
+        cache.level.store(Detail::fileLogLevel(file), std::memory_order_relaxed);
+        cache.generation.store(generation, std::memory_order_release);
+    }
+    return cache.level.load(std::memory_order_relaxed) >= level;
+}
+
 // Process @spec and update the log level requested for the appropriate file.
 void addDebugSpec(const char* spec);
 
@@ -91,7 +115,14 @@ void increaseVerbosity();
 #define MAX_LOGGING_LEVEL 10
 #endif
 
-#define LOGGING(N) ((N) <= MAX_LOGGING_LEVEL && ::Log::fileLogLevelIsAtLeast(__FILE__, N))
+/* The lambda gives each call site its own level cache, so a disabled site
+ * costs a single generation check; the ternary in LOGN keeps argument
+ * expressions unevaluated unless the site is enabled. */
+#define LOGGING(N) ((N) <= MAX_LOGGING_LEVEL &&                                 \
+                    [](int n_) {                                                \
+                        static ::Log::Detail::LevelCache cache_;                \
+                        return ::Log::fileLogLevelIsAtLeast(cache_, __FILE__, n_); \
+                    }(N))
 #define LOGN(N, X) (LOGGING(N)                                                  \
                       ? ::Log::Detail::fileLogOutput(__FILE__)                  \
                           << ::Log::Detail::OutputLogPrefix(__FILE__, N)        \
@@ -119,7 +150,11 @@ void increaseVerbosity();
 #define LOG8_UNINDENT   LOGN_UNINDENT(8)
 #define LOG9_UNINDENT   LOGN_UNINDENT(9)
 
-#define LOG_FEATURE(TAG, N, X) ((N) <= MAX_LOGGING_LEVEL && ::Log::fileLogLevelIsAtLeast(TAG, N) \
+#define LOG_FEATURE(TAG, N, X) ((N) <= MAX_LOGGING_LEVEL &&                     \
+                    [](int n_) {                                                \
+                        static ::Log::Detail::LevelCache cache_;                \
+                        return ::Log::fileLogLevelIsAtLeast(cache_, TAG, n_);   \
+                    }(N)                                                        \
                       ? ::Log::Detail::fileLogOutput(TAG)                       \
                           << ::Log::Detail::OutputLogPrefix(TAG, N)             \
                           << X << std::endl                                     \
@@ -19,6 +19,8 @@ limitations under the License.
 
 #include <map>
 
+#include "lib/cstring.h"
+
 // XXX(seth): We use this namespace to hide our get() overloads from ADL. GCC
 // 4.8 has a bug which causes these overloads to be considered when get() is
 // called on a type in the global namespace, even if the number of arguments
@@ -56,6 +58,26 @@ template<class K, class T, class V, class Comp, class Alloc>
 inline const V *getref(const std::map<K, V, Comp, Alloc> *m, T key) {
     return m ? getref(*m, key) : 0; }
 
+// Probing a cstring-keyed map with a string that is not yet a cstring would
+// intern it as a side effect.  A string that was never interned cannot be a
+// key in any cstring-keyed container, so these overloads probe the intern
+// table without inserting and fail fast instead.
+
+template<class V, class Comp, class Alloc>
+inline V get(const std::map<cstring, V, Comp, Alloc> &m, const std::string &key, V def = V()) {
+    cstring interned = cstring::find_interned(key);
+    return interned.isNull() ? def : get(m, interned, def); }
+
+template<class V, class Comp, class Alloc>
+inline V *getref(std::map<cstring, V, Comp, Alloc> &m, const std::string &key) {
+    cstring interned = cstring::find_interned(key);
+    return interned.isNull() ? nullptr : getref(m, interned); }
+
+template<class V, class Comp, class Alloc>
+inline const V *getref(const std::map<cstring, V, Comp, Alloc> &m, const std::string &key) {
+    cstring interned = cstring::find_interned(key);
+    return interned.isNull() ? nullptr : getref(m, interned); }
+
 }  // namespace GetImpl
 using namespace GetImpl;  // NOLINT(build/namespaces)
 
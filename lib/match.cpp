@@ -16,6 +16,38 @@ limitations under the License.
 
 #include "match.h"
 
+int match_set_t::firstMatch(uintmax_t v) const {
+    for (size_t i = 0; i < patterns.size(); i++)
+        if (patterns[i].matches(v))
+            return static_cast<int>(i);
+    return -1;
+}
+
+/* Union cover by case splitting: a pattern fully covered by one earlier
+ * pattern is done; otherwise split on one bit where an overlapping earlier
+ * pattern cares and @m does not, and require both halves to be covered.
+ * Worst case this is exponential in the number of wildcard bits, but select
+ * patterns in practice care about most of their bits. */
+static bool coveredBy(const match_t &m, const std::vector<match_t> &set, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        if (set[i].covers(m))
+            return true;
+    for (size_t i = 0; i < n; i++) {
+        if (!set[i].overlaps(m)) continue;
+        uintmax_t split = (set[i].word0 ^ set[i].word1) & m.word0 & m.word1;
+        if (!split) continue;
+        split &= ~(split - 1);      // lowest such bit
+        match_t m0(m.word0, m.word1 & ~split);      // the bit forced to 0
+        match_t m1(m.word0 & ~split, m.word1);      // the bit forced to 1
+        return coveredBy(m0, set, n) && coveredBy(m1, set, n); }
+    return false;
+}
+
+bool match_set_t::coveredBefore(const match_t &m, size_t before) const {
+    if (before > patterns.size()) before = patterns.size();
+    return coveredBy(m, patterns, before);
+}
+
 static int chkmask(const match_t &m, int maskbits) {
     uintmax_t mask = (1U << maskbits) - 1;
     int shift = 0;
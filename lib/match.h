@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <stdint.h>
 #include <iostream>
+#include <vector>
 
 /// The ternary expression being matched, given as a pair of bitmasks:
 /// (word0, word1). The ternary expression cares about the value of an
@@ -47,6 +48,41 @@ struct match_t {
     match_t(int size, uintmax_t val, uintmax_t mask) : word0(~val&mask), word1(val&mask)
         { setwidth(size); }
     static match_t dont_care(int size) { return match_t(size, 0, 0); }
+
+    // Set algebra over the inputs a pattern matches; whole words at a
+    // time, no per-bit loops.
+
+    /// The set of inputs matched by both this and @a.  A bit with
+    /// neither word set in the result matches no input at all; use
+    /// emptyWithin to test for that.
+    match_t intersect(const match_t &a) const {
+        return match_t(word0 & a.word0, word1 & a.word1); }
+    /// True if no input of @bits width is matched -- some bit admits
+    /// neither a 0 nor a 1.
+    bool emptyWithin(int bits) const {
+        uintmax_t mask = ~(~uintmax_t(0) << bits);
+        return ((word0 | word1) & mask) != mask; }
+    /// True if every input matched by @a is also matched by this.
+    bool covers(const match_t &a) const {
+        return (a.word0 & ~word0) == 0 && (a.word1 & ~word1) == 0; }
+    /// True if some input is matched by both this and @a.
+    bool overlaps(const match_t &a) const {
+        return ((word0 & a.word0) | (word1 & a.word1)) ==
+               ((word0 | word1) & (a.word0 | a.word1)); }
+};
+
+/// An ordered collection of ternary patterns supporting one-against-many
+/// tests.  Earlier patterns take priority, matching select-case semantics.
+struct match_set_t {
+    std::vector<match_t> patterns;
+    void add(const match_t &m) { patterns.push_back(m); }
+    /// Index of the first pattern matching @v, or -1 if none does.
+    int firstMatch(uintmax_t v) const;
+    bool matches(uintmax_t v) const { return firstMatch(v) >= 0; }
+    /// True if every input matched by @m is matched by some pattern with
+    /// an index below @before; with before == i this reports whether
+    /// pattern i of a select is unreachable.
+    bool coveredBefore(const match_t &m, size_t before) const;
 };
 
 std::ostream &operator <<(std::ostream &, match_t);
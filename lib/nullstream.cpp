@@ -15,8 +15,20 @@ limitations under the License.
 */
 
 #include <fstream>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include "nullstream.h"
 
+namespace {
+
+bool isCompressedName(cstring name) {
+    cstring suffix = name.findlast('.');
+    return suffix == ".gz";
+}
+
+}  // namespace
+
 std::ostream* openFile(cstring name, bool nullOnError) {
     if (name.isNullOrEmpty()) {
         if (nullOnError)
@@ -24,6 +36,20 @@ std::ostream* openFile(cstring name, bool nullOnError) {
         ::error(ErrorType::ERR_INVALID, "Empty name for openFile", name);
         return nullptr;
     }
+    if (isCompressedName(name)) {
+        boost::iostreams::file_sink sink(name.c_str(), std::ios_base::binary);
+        if (!sink.is_open()) {
+            ::error(ErrorType::ERR_IO,
+                    "Error writing output to file %1%: %2%", name, strerror(errno));
+            if (nullOnError)
+                return new nullstream();
+            return nullptr;
+        }
+        auto file = new boost::iostreams::filtering_ostream();
+        file->push(boost::iostreams::gzip_compressor());
+        file->push(sink);
+        return file;
+    }
     std::ofstream *file = new std::ofstream(name);
     if (!file->good()) {
         ::error(ErrorType::ERR_IO,
@@ -34,3 +60,40 @@ std::ostream* openFile(cstring name, bool nullOnError) {
     }
     return file;
 }
+
+std::istream* openInputFile(cstring name) {
+    if (name.isNullOrEmpty()) {
+        ::error(ErrorType::ERR_INVALID, "Empty name for openInputFile", name);
+        return nullptr;
+    }
+    if (isCompressedName(name)) {
+        boost::iostreams::file_source source(name.c_str(), std::ios_base::binary);
+        if (!source.is_open()) {
+            ::error(ErrorType::ERR_IO,
+                    "Error reading input from file %1%: %2%", name, strerror(errno));
+            return nullptr;
+        }
+        auto file = new boost::iostreams::filtering_istream();
+        file->push(boost::iostreams::gzip_decompressor());
+        file->push(source);
+        return file;
+    }
+    std::ifstream *file = new std::ifstream(name);
+    if (!file->good()) {
+        ::error(ErrorType::ERR_IO,
+                "Error reading input from file %1%: %2%", name, strerror(errno));
+        return nullptr;
+    }
+    return file;
+}
+
+void closeFile(std::ostream* stream) {
+    if (stream == nullptr)
+        return;
+    // Popping the chain runs the compressor's close, which writes the
+    // gzip trailer; uncompressed streams only need a flush.
+    if (auto filtered = dynamic_cast<boost::iostreams::filtering_ostream*>(stream))
+        filtered->reset();
+    else
+        stream->flush();
+}
@@ -45,7 +45,18 @@ class onullstream final: public std::basic_ostream<cT, traits> {
 typedef onullstream<char> nullstream;
 
 // If nullOnError is 'true', on error a nullstream is returned
-// otherwise a nullptr is returned
+// otherwise a nullptr is returned.
+// Names ending in ".gz" are written through a streaming gzip
+// compressor; such streams must be finalized with closeFile or the
+// trailer is never emitted.
 std::ostream* openFile(cstring name, bool nullOnError);
 
+// Opens a file for reading, decompressing transparently when the name
+// ends in ".gz".  Returns nullptr on error.
+std::istream* openInputFile(cstring name);
+
+// Flushes the stream; for compressed outputs also writes the gzip
+// trailer. Safe to call on any stream returned by openFile.
+void closeFile(std::ostream* stream);
+
 #endif /* P4C_LIB_NULLSTREAM_H_ */
@@ -0,0 +1,203 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_ORDERED_FLAT_MAP_H_
+#define LIB_ORDERED_FLAT_MAP_H_
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/* Map ordered by order of element insertion, like ordered_map, but backed by
+ * an open-addressed hash index over a contiguous vector of entries instead of
+ * a std::map of std::list iterators.  Lookups hash the key rather than
+ * comparing it, so this is a drop-in replacement for ordered_map only where
+ * keys are hashable (pointers, cstrings, integers) and nothing relies on the
+ * comparator-based methods (lower_bound &c are not provided).  Iteration
+ * walks the entry vector, so it is both insertion-ordered and cache-friendly.
+ * erase() keeps the vector contiguous and therefore costs O(n). */
+template <class K, class V, class HASH = std::hash<K>, class PRED = std::equal_to<K>>
+class ordered_flat_map {
+ public:
+    typedef K                           key_type;
+    typedef V                           mapped_type;
+    typedef std::pair<const K, V>       value_type;
+    typedef HASH                        hasher;
+    typedef PRED                        key_equal;
+    typedef value_type                  &reference;
+    typedef const value_type            &const_reference;
+    typedef size_t                      size_type;
+
+ private:
+    /* entries hold a non-const key so the vector can relocate and erase can
+     * shift; iterators expose them as pair<const K, V>, as std::map does */
+    typedef std::pair<K, V>                             entry_type;
+    std::vector<entry_type>                             entries;
+    std::vector<size_t>                                 slots;  // index into entries
+    HASH                                                hash_fn;
+    PRED                                                pred_fn;
+    static const size_t EMPTY = static_cast<size_t>(-1);
+
+    size_t hash1(const K &k) const {
+        /* Fibonacci hashing -- spreads the (often pointer-valued, hence
+         * aligned) hash over the power-of-two table */
+        uint64_t h = hash_fn(k) * UINT64_C(0x9e3779b97f4a7c15);
+        return static_cast<size_t>(h >> 17); }
+    template<class KK> size_t find_slot(const KK &k) const {
+        size_t mask = slots.size() - 1;
+        size_t i = hash1(k) & mask;
+        while (slots[i] != EMPTY && !pred_fn(entries[slots[i]].first, k))
+            i = (i + 1) & mask;
+        return i; }
+    void rebuild(size_t nslots) {
+        slots.assign(nslots, size_t(EMPTY));
+        for (size_t e = 0; e < entries.size(); e++)
+            slots[find_slot(entries[e].first)] = e; }
+    void reserve_slot() {
+        if (slots.empty())
+            rebuild(16);
+        else if ((entries.size() + 1) * 4 > slots.size() * 3)
+            rebuild(slots.size() * 2); }
+    value_type *entry(size_t e) { return reinterpret_cast<value_type *>(&entries[e]); }
+    const value_type *entry(size_t e) const {
+        return reinterpret_cast<const value_type *>(&entries[e]); }
+
+ public:
+    typedef value_type                                  *iterator;
+    typedef const value_type                            *const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    ordered_flat_map() {}
+    ordered_flat_map(const std::initializer_list<value_type> &il) {
+        for (auto &el : il) insert(el); }
+
+    iterator                    begin() noexcept { return entries.empty() ? nullptr : entry(0); }
+    const_iterator              begin() const noexcept {
+                                    return entries.empty() ? nullptr : entry(0); }
+    iterator                    end() noexcept { return begin() + entries.size(); }
+    const_iterator              end() const noexcept { return begin() + entries.size(); }
+    reverse_iterator            rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator      rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator            rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator      rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_iterator              cbegin() const noexcept { return begin(); }
+    const_iterator              cend() const noexcept { return end(); }
+
+    bool        empty() const noexcept { return entries.empty(); }
+    size_type   size() const noexcept { return entries.size(); }
+    void clear() { entries.clear(); slots.clear(); }
+    bool operator==(const ordered_flat_map &a) const {
+        if (entries.size() != a.entries.size()) return false;
+        for (size_t i = 0; i < entries.size(); i++)
+            if (!(entries[i] == a.entries[i])) return false;
+        return true; }
+    bool operator!=(const ordered_flat_map &a) const { return !(*this == a); }
+
+    iterator find(const key_type &k) {
+        if (slots.empty()) return end();
+        size_t i = find_slot(k);
+        return slots[i] == EMPTY ? end() : entry(slots[i]); }
+    const_iterator find(const key_type &k) const {
+        if (slots.empty()) return end();
+        size_t i = find_slot(k);
+        return slots[i] == EMPTY ? end() : entry(slots[i]); }
+    size_type count(const key_type &k) const { return find(k) == end() ? 0 : 1; }
+
+    V& operator[](const K &x) {
+        auto it = find(x);
+        if (it != end()) return it->second;
+        reserve_slot();
+        slots[find_slot(x)] = entries.size();
+        entries.emplace_back(x, V());
+        return entries.back().second; }
+    V& at(const K &x) {
+        auto it = find(x);
+        if (it == end()) throw std::out_of_range("ordered_flat_map::at");
+        return it->second; }
+    const V& at(const K &x) const {
+        auto it = find(x);
+        if (it == end()) throw std::out_of_range("ordered_flat_map::at");
+        return it->second; }
+
+    template<typename KK, typename... VV>
+    std::pair<iterator, bool> emplace(KK &&k, VV &&... v) {
+        auto it = find(k);
+        if (it != end()) return std::make_pair(it, false);
+        reserve_slot();
+        slots[find_slot(k)] = entries.size();
+        entries.emplace_back(std::piecewise_construct_t(),
+                             std::forward_as_tuple(std::forward<KK>(k)),
+                             std::forward_as_tuple(std::forward<VV>(v)...));
+        return std::make_pair(entry(entries.size() - 1), true); }
+
+    std::pair<iterator, bool> insert(const value_type &v) {
+        return emplace(v.first, v.second); }
+    template<class InputIterator> void insert(InputIterator b, InputIterator e) {
+        while (b != e) insert(*b++); }
+
+    iterator erase(iterator pos) {
+        size_t e = pos - begin();
+        entries.erase(entries.begin() + e);
+        rebuild(slots.size());  // O(n), see class comment
+        return begin() + e; }
+    size_type erase(const K &k) {
+        auto it = find(k);
+        if (it == end()) return 0;
+        erase(it);
+        return 1; }
+};
+
+// get/getref overloads, hidden from ADL for the same reason as in
+// ordered_map.h.
+namespace GetImpl {
+
+template<class K, class T, class V, class Hash, class Pred>
+inline V get(const ordered_flat_map<K, V, Hash, Pred> &m, T key, V def = V()) {
+    auto it = m.find(key);
+    if (it != m.end()) return it->second;
+    return def; }
+
+template<class K, class T, class V, class Hash, class Pred>
+inline V *getref(ordered_flat_map<K, V, Hash, Pred> &m, T key) {
+    auto it = m.find(key);
+    if (it != m.end()) return &it->second;
+    return 0; }
+
+template<class K, class T, class V, class Hash, class Pred>
+inline const V *getref(const ordered_flat_map<K, V, Hash, Pred> &m, T key) {
+    auto it = m.find(key);
+    if (it != m.end()) return &it->second;
+    return 0; }
+
+template<class K, class T, class V, class Hash, class Pred>
+inline V get(const ordered_flat_map<K, V, Hash, Pred> *m, T key, V def = V()) {
+    return m ? get(*m, key, def) : def; }
+
+template<class K, class T, class V, class Hash, class Pred>
+inline V *getref(ordered_flat_map<K, V, Hash, Pred> *m, T key) {
+    return m ? getref(*m, key) : 0; }
+
+template<class K, class T, class V, class Hash, class Pred>
+inline const V *getref(const ordered_flat_map<K, V, Hash, Pred> *m, T key) {
+    return m ? getref(*m, key) : 0; }
+
+}  // namespace GetImpl
+using namespace GetImpl;  // NOLINT(build/namespaces)
+
+#endif /* LIB_ORDERED_FLAT_MAP_H_ */
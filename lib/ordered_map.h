@@ -22,6 +22,8 @@ limitations under the License.
 #include <map>
 #include <utility>
 
+#include "lib/cstring.h"
+
 // Map is ordered by order of element insertion.
 template <class K, class V, class COMP = std::less<K>,
           class ALLOC = std::allocator<std::pair<const K, V>>>
@@ -241,6 +243,24 @@ template<class K, class T, class V, class Comp, class Alloc>
 inline const V *getref(const ordered_map<K, V, Comp, Alloc> *m, T key) {
     return m ? getref(*m, key) : 0; }
 
+// As in lib/map.h: probe cstring-keyed maps with uninterned keys through the
+// intern table lookup, so a speculative probe never interns its key.
+
+template<class V, class Comp, class Alloc>
+inline V get(const ordered_map<cstring, V, Comp, Alloc> &m, const std::string &key, V def = V()) {
+    cstring interned = cstring::find_interned(key);
+    return interned.isNull() ? def : get(m, interned, def); }
+
+template<class V, class Comp, class Alloc>
+inline V *getref(ordered_map<cstring, V, Comp, Alloc> &m, const std::string &key) {
+    cstring interned = cstring::find_interned(key);
+    return interned.isNull() ? nullptr : getref(m, interned); }
+
+template<class V, class Comp, class Alloc>
+inline const V *getref(const ordered_map<cstring, V, Comp, Alloc> &m, const std::string &key) {
+    cstring interned = cstring::find_interned(key);
+    return interned.isNull() ? nullptr : getref(m, interned); }
+
 }  // namespace GetImpl
 using namespace GetImpl;  // NOLINT(build/namespaces)
 
@@ -31,6 +31,23 @@ class safe_vector : public std::vector<T, _Alloc> {
     typedef typename std::vector<T>::const_iterator const_iterator;
     reference operator[](size_type n) { return this->at(n); }
     const_reference operator[](size_type n) const { return this->at(n); }
+    /// Access without the bounds check, for loops whose index is bounded by
+    /// construction; debug builds keep the check.  Hand-written code should
+    /// normally stay with operator[] -- the check is the point of this class.
+    reference at_unchecked(size_type n) {
+#ifndef NDEBUG
+        return this->at(n);
+#else
+        return std::vector<T, _Alloc>::operator[](n);
+#endif
+    }
+    const_reference at_unchecked(size_type n) const {
+#ifndef NDEBUG
+        return this->at(n);
+#else
+        return std::vector<T, _Alloc>::operator[](n);
+#endif
+    }
 };
 
 #endif /* P4C_LIB_SAFE_VECTOR_H_ */
@@ -0,0 +1,198 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef P4C_LIB_SMALL_VECTOR_H_
+#define P4C_LIB_SMALL_VECTOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+/// A vector that stores up to N elements inline and only allocates once it
+/// grows past them.  Like safe_vector, operator[] is bounds-checked.
+///
+/// The element type must be default-constructible and cheap to copy; slots
+/// past size() hold default-constructed values rather than being destroyed
+/// eagerly.  This is tailored to the node pointers of IR::Vector, where most
+/// instances hold only a handful of elements but are copied constantly by
+/// the Transform clone paths.  Ranges passed to insert() must not overlap
+/// this vector's own storage.
+template<class T, size_t N = 4>
+class small_vector {
+    static_assert(N > 0, "small_vector needs some inline capacity");
+
+    T       inline_buf[N];
+    T       *buf;       // inline_buf, or a heap array once capacity exceeds N
+    size_t  sz;
+    size_t  cap;
+
+    void grow(size_t wanted) {
+        size_t ncap = cap * 2;
+        if (ncap < wanted) ncap = wanted;
+        T *nbuf = new T[ncap];
+        std::copy(buf, buf + sz, nbuf);
+        if (buf != inline_buf) delete [] buf;
+        buf = nbuf;
+        cap = ncap; }
+
+ public:
+    typedef T           value_type;
+    typedef T           *iterator;
+    typedef const T     *const_iterator;
+    typedef T           &reference;
+    typedef const T     &const_reference;
+    typedef size_t      size_type;
+    typedef std::reverse_iterator<iterator>         reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+    small_vector() : buf(inline_buf), sz(0), cap(N) {}
+    small_vector(const small_vector &a) : buf(inline_buf), sz(0), cap(N) { *this = a; }
+    small_vector(small_vector &&a) : buf(inline_buf), sz(0), cap(N) { *this = std::move(a); }
+    small_vector(std::initializer_list<T> il) : buf(inline_buf), sz(0), cap(N) {
+        insert(end(), il.begin(), il.end()); }
+    template<class InputIt>
+    small_vector(InputIt b, InputIt e) : buf(inline_buf), sz(0), cap(N) {
+        insert(end(), b, e); }
+    ~small_vector() { if (buf != inline_buf) delete [] buf; }
+
+    small_vector &operator=(const small_vector &a) {
+        if (this == &a) return *this;
+        if (a.sz > cap) grow(a.sz);
+        std::copy(a.buf, a.buf + a.sz, buf);
+        sz = a.sz;
+        return *this; }
+    small_vector &operator=(small_vector &&a) {
+        if (this == &a) return *this;
+        if (a.buf != a.inline_buf) {
+            // steal the heap buffer
+            if (buf != inline_buf) delete [] buf;
+            buf = a.buf;
+            sz = a.sz;
+            cap = a.cap;
+            a.buf = a.inline_buf;
+            a.sz = 0;
+            a.cap = N;
+        } else {
+            std::move(a.buf, a.buf + a.sz, buf);  // a.sz <= N <= cap
+            sz = a.sz;
+            a.sz = 0; }
+        return *this; }
+
+    iterator begin() { return buf; }
+    const_iterator begin() const { return buf; }
+    iterator end() { return buf + sz; }
+    const_iterator end() const { return buf + sz; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    size_type size() const { return sz; }
+    size_type capacity() const { return cap; }
+    bool empty() const { return sz == 0; }
+
+    reference at(size_type n) {
+        if (n >= sz) throw std::out_of_range("small_vector::at");
+        return buf[n]; }
+    const_reference at(size_type n) const {
+        if (n >= sz) throw std::out_of_range("small_vector::at");
+        return buf[n]; }
+    reference operator[](size_type n) { return at(n); }
+    const_reference operator[](size_type n) const { return at(n); }
+    /// Access without the bounds check, for loops whose index is bounded by
+    /// construction; debug builds keep the check.
+    reference at_unchecked(size_type n) {
+#ifndef NDEBUG
+        return at(n);
+#else
+        return buf[n];
+#endif
+    }
+    const_reference at_unchecked(size_type n) const {
+#ifndef NDEBUG
+        return at(n);
+#else
+        return buf[n];
+#endif
+    }
+    reference front() { return buf[0]; }
+    const_reference front() const { return buf[0]; }
+    reference back() { return buf[sz - 1]; }
+    const_reference back() const { return buf[sz - 1]; }
+
+    void clear() { sz = 0; }
+    void resize(size_type n) {
+        if (n > cap) grow(n);
+        for (size_type i = sz; i < n; ++i) buf[i] = T();
+        sz = n; }
+    void reserve(size_type n) { if (n > cap) grow(n); }
+
+    void push_back(T v) {
+        // take the argument by value: it may alias an element that grow()
+        // would otherwise leave behind
+        if (sz == cap) grow(sz + 1);
+        buf[sz++] = std::move(v); }
+    template<class... Args> void emplace_back(Args&&... args) {
+        T v(std::forward<Args>(args)...);
+        if (sz == cap) grow(sz + 1);
+        buf[sz++] = std::move(v); }
+    void pop_back() { --sz; }
+
+    iterator insert(const_iterator pos, T v) {
+        size_type idx = pos - buf;
+        if (sz == cap) grow(sz + 1);
+        std::copy_backward(buf + idx, buf + sz, buf + sz + 1);
+        buf[idx] = std::move(v);
+        ++sz;
+        return buf + idx; }
+    iterator insert(const_iterator pos, size_type n, T v) {
+        size_type idx = pos - buf;
+        if (sz + n > cap) grow(sz + n);
+        std::copy_backward(buf + idx, buf + sz, buf + sz + n);
+        for (size_type i = 0; i < n; ++i) buf[idx + i] = v;
+        sz += n;
+        return buf + idx; }
+    template<class InputIt>
+    iterator insert(const_iterator pos, InputIt b, InputIt e) {
+        size_type idx = pos - buf;
+        size_type n = std::distance(b, e);
+        if (sz + n > cap) grow(sz + n);
+        std::copy_backward(buf + idx, buf + sz, buf + sz + n);
+        std::copy(b, e, buf + idx);
+        sz += n;
+        return buf + idx; }
+
+    iterator erase(const_iterator pos) {
+        size_type idx = pos - buf;
+        std::copy(buf + idx + 1, buf + sz, buf + idx);
+        --sz;
+        return buf + idx; }
+    iterator erase(const_iterator b, const_iterator e) {
+        size_type idx = b - buf;
+        size_type n = e - b;
+        std::copy(buf + idx + n, buf + sz, buf + idx);
+        sz -= n;
+        return buf + idx; }
+
+    bool operator==(const small_vector &a) const {
+        return sz == a.sz && std::equal(buf, buf + sz, a.buf); }
+    bool operator!=(const small_vector &a) const { return !(*this == a); }
+};
+
+#endif /* P4C_LIB_SMALL_VECTOR_H_ */
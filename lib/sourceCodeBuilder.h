@@ -18,7 +18,12 @@ limitations under the License.
 #define P4C_LIB_SOURCECODEBUILDER_H_
 
 #include <ctype.h>
-#include <sstream>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
 
 #include "lib/stringify.h"
 #include "lib/cstring.h"
@@ -29,10 +34,22 @@ class SourceCodeBuilder {
     int indentLevel;  // current indent level
     unsigned indentAmount;
 
-    std::stringstream buffer;
-    const std::string nl = "\n";
+    // The generated code is kept as a rope: a list of fixed-size chunks
+    // appended to in order, so building multi-megabyte outputs never
+    // reallocates or copies what was already emitted.  Only the last
+    // chunk ever grows; writeTo flushes them in one pass.
+    static constexpr size_t chunkSize = 64 * 1024;
+    std::vector<std::string> chunks;
     bool endsInSpace;
 
+    void put(const char* data, size_t len) {
+        if (chunks.empty() || chunks.back().size() + len > chunkSize) {
+            chunks.emplace_back();
+            chunks.back().reserve(chunkSize > len ? chunkSize : len);
+        }
+        chunks.back().append(data, len);
+    }
+
  public:
     SourceCodeBuilder() :
             indentLevel(0),
@@ -46,10 +63,10 @@ class SourceCodeBuilder {
         if (indentLevel < 0)
             BUG("Negative indent");
     }
-    void newline() { buffer << nl; endsInSpace = true; }
+    void newline() { put("\n", 1); endsInSpace = true; }
     void spc() {
         if (!endsInSpace)
-            buffer << " ";
+            put(" ", 1);
         endsInSpace = true;
     }
 
@@ -59,26 +76,41 @@ class SourceCodeBuilder {
         if (str.size() == 0)
             return;
         endsInSpace = ::isspace(str.at(str.size() - 1));
-        buffer << str;
+        put(str.data(), str.size());
     }
     void append(char c) {
         endsInSpace = ::isspace(c);
-        buffer << c;
+        put(&c, 1);
     }
     void append(const char* str) {
         if (str == nullptr)
             BUG("Null argument to append");
-        if (strlen(str) == 0)
+        size_t len = strlen(str);
+        if (len == 0)
             return;
-        endsInSpace = ::isspace(str[strlen(str) - 1]);
-        buffer << str;
+        endsInSpace = ::isspace(str[len - 1]);
+        put(str, len);
     }
     void appendFormat(const char* format, ...) {
+        // format straight into the rope rather than through the cstring
+        // cache -- generated code fragments are rarely worth interning
+        char buf[256];
         va_list ap;
         va_start(ap, format);
-        cstring str = Util::vprintf_format(format, ap);
+        int len = vsnprintf(buf, sizeof(buf), format, ap);
+        va_end(ap);
+        if (len < 0)
+            BUG("Failed to format %1%", format);
+        if (size_t(len) < sizeof(buf)) {
+            append(buf);
+            return;
+        }
+        std::string big(len + 1, 0);
+        va_start(ap, format);
+        vsnprintf(&big[0], len + 1, format, ap);
         va_end(ap);
-        append(str);
+        big.resize(len);
+        append(big);
     }
     void append(unsigned u) { appendFormat("%d", u); }
     void append(int u) { appendFormat("%d", u); }
@@ -94,9 +126,7 @@ class SourceCodeBuilder {
     }
 
     void emitIndent() {
-        buffer << std::string(indentLevel, ' ');
-        if (indentLevel > 0)
-            endsInSpace = true;
+        append(std::string(indentLevel, ' '));
     }
 
     void blockEnd(bool nl) {
@@ -107,7 +137,26 @@ class SourceCodeBuilder {
             newline();
     }
 
-    std::string toString() const { return buffer.str(); }
+    std::string toString() const {
+        size_t total = 0;
+        for (auto &chunk : chunks)
+            total += chunk.size();
+        std::string result;
+        result.reserve(total);
+        for (auto &chunk : chunks)
+            result += chunk;
+        return result;
+    }
+    /// Flush the accumulated code to @out in one pass, without
+    /// materializing it as a single string first.
+    void writeTo(std::ostream &out) const {
+        for (auto &chunk : chunks)
+            out.write(chunk.data(), chunk.size());
+    }
+    /// Discard the accumulated contents.  Indentation and trailing-space
+    /// state are kept, so emission can continue as if nothing happened;
+    /// used by writers that flush at natural boundaries.
+    void clear() { chunks.clear(); }
     void commentStart() { append("/* "); }
     void commentEnd() { append(" */"); }
     bool lastIsSpace() const { return endsInSpace; }
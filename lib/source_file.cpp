@@ -17,6 +17,7 @@ limitations under the License.
 #include <sstream>
 
 #include <algorithm>
+#include <cstring>
 #include "source_file.h"
 #include "exceptions.h"
 #include "lib/log.h"
@@ -38,9 +39,11 @@ cstring SourcePosition::toString() const {
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
+constexpr uint64_t SourceInfo::detachedTag;
+
 SourceInfo::SourceInfo(const InputSources* sources, SourcePosition start,
                        SourcePosition end)
-        : sources(sources), start(start), end(end) {
+        : sources(sources), rep(encode(start, end)) {
     BUG_CHECK(sources != nullptr, "Invalid InputSources in SourceInfo");
     if (!start.isValid() || !end.isValid())
         BUG("Invalid source position in SourceInfo %1%-%2%",
@@ -50,23 +53,92 @@ SourceInfo::SourceInfo(const InputSources* sources, SourcePosition start,
                           start.toString(), end.toString());
 }
 
+namespace {
+/// Positions restored from JSON dumps (--fromJSON).  They are rare, so
+/// their strings live in this shared table instead of widening every
+/// SourceInfo by four fields.
+struct DetachedInfo {
+    cstring filename;
+    cstring srcBrief;
+    int line;
+    int column;
+};
+std::vector<DetachedInfo>& detachedInfos() {
+    static std::vector<DetachedInfo> infos;
+    return infos;
+}
+}  // namespace
+
+SourceInfo::SourceInfo(cstring filename, int line, int column, cstring srcBrief)
+        : sources(nullptr), rep(detachedTag | detachedInfos().size()) {
+    detachedInfos().push_back(DetachedInfo{filename, srcBrief, line, column});
+}
+
+cstring SourceInfo::detachedFilename() const {
+    BUG_CHECK(isDetached(), "%1%: not a detached SourceInfo", toDebugString());
+    return detachedInfos().at(rep & 0xFFFFFFFF).filename;
+}
+
+int SourceInfo::detachedLine() const {
+    BUG_CHECK(isDetached(), "%1%: not a detached SourceInfo", toDebugString());
+    return detachedInfos().at(rep & 0xFFFFFFFF).line;
+}
+
+int SourceInfo::detachedColumn() const {
+    BUG_CHECK(isDetached(), "%1%: not a detached SourceInfo", toDebugString());
+    return detachedInfos().at(rep & 0xFFFFFFFF).column;
+}
+
+cstring SourceInfo::detachedFragment() const {
+    BUG_CHECK(isDetached(), "%1%: not a detached SourceInfo", toDebugString());
+    return detachedInfos().at(rep & 0xFFFFFFFF).srcBrief;
+}
+
 cstring SourceInfo::toDebugString() const {
-    return Util::printf_format("(%s)-(%s)", start.toString(), end.toString());
+    return Util::printf_format("(%s)-(%s)", getStart().toString(), getEnd().toString());
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
+constexpr size_t InputSources::blockSize;
+
+const InputSources* InputSources::mostRecentInstance = nullptr;
+
 InputSources::InputSources() : sealed(false) {
+    mostRecentInstance = this;
     mapLine(nullptr, 1);  // the first line read will be line 1 of stdin
-    contents.push_back("");
 }
 
-void InputSources::addComment(SourceInfo srcInfo, bool singleLine, cstring body) {
-    if (!singleLine)
-        // Drop the "*/"
-        body = body.exceptLast(2);
-    auto comment = new Comment(srcInfo, singleLine, body);
-    comments.push_back(comment);
+void InputSources::getAllFileNames(std::set<cstring>* files) const {
+    for (auto& entry : line_file_map)
+        if (!entry.second.fileName.isNullOrEmpty())
+            files->insert(entry.second.fileName);
+}
+
+bool InputSources::captureComments_ = false;
+
+void InputSources::addComment(SourceInfo srcInfo, bool singleLine) {
+    if (!captureComments_)
+        return;
+    comments.push_back(new Comment(srcInfo, singleLine, this));
+}
+
+cstring Comment::toString() const {
+    if (sources == nullptr || !srcInfo.isValid())
+        return "";
+    auto start = srcInfo.getStart();
+    auto end = srcInfo.getEnd();
+    std::string result;
+    for (unsigned l = start.getLineNumber(); l <= end.getLineNumber(); l++) {
+        cstring line = sources->getLine(l);
+        unsigned from = l == start.getLineNumber() ? start.getColumnNumber() : 0;
+        unsigned to = l == end.getLineNumber()
+            ? std::min(static_cast<unsigned>(line.size()), end.getColumnNumber())
+            : static_cast<unsigned>(line.size());
+        if (from < to)
+            result.append(line.c_str() + from, to - from);
+    }
+    return result;
 }
 
 /// prevent further changes
@@ -78,14 +150,25 @@ void InputSources::seal() {
 }
 
 unsigned InputSources::lineCount() const {
-    int size = contents.size();
-    if (contents.back().empty()) {
-        // do not count the last line if it is empty.
-        size -= 1;
-        if (size < 0)
-            BUG("Negative line count");
-    }
-    return size;
+    // do not count the last line if it is empty.
+    return curLen == 0 ? lines.size() : lines.size() + 1;
+}
+
+// Make room for 'bytes' more characters on the line being assembled
+void InputSources::reserve(size_t bytes) {
+    if (blockAvail >= bytes)
+        return;
+    // the line under construction must stay contiguous, so it moves to
+    // the front of the new block; the stale copy at the end of the old
+    // block is simply abandoned
+    size_t size = std::max(blockSize, curLen + bytes);
+    blocks.emplace_back(new char[size]);
+    char* block = blocks.back().get();
+    if (curLen != 0)
+        memcpy(block, curLine, curLen);
+    curLine = block;
+    blockNext = block + curLen;
+    blockAvail = size - curLen;
 }
 
 // Append this text to the last line
@@ -98,15 +181,24 @@ void InputSources::appendToLastLine(StringRef text) {
         if (c == '\n')
             BUG("Text contains newlines");
     }
-    contents.back() += text.toString();
+    reserve(text.len);
+    memcpy(blockNext, text.p, text.len);
+    blockNext += text.len;
+    blockAvail -= text.len;
+    curLen += text.len;
 }
 
 // Append a newline and start a new line
 void InputSources::appendNewline(StringRef newline) {
     if (sealed)
         BUG("Appending to sealed InputSources");
-    contents.back() += newline.toString();
-    contents.push_back("");  // start a new line
+    reserve(newline.len);
+    memcpy(blockNext, newline.p, newline.len);
+    blockNext += newline.len;
+    blockAvail -= newline.len;
+    lines.push_back(StringRef(curLine, curLen + newline.len));
+    curLine = blockNext;  // start a new line
+    curLen = 0;
 }
 
 void InputSources::appendText(const char* text) {
@@ -149,18 +241,28 @@ cstring InputSources::getLine(unsigned lineNumber) const {
         // don't throw: this code may be called by exceptions
         // reporting on elements that have no source position
     }
-    return contents.at(lineNumber - 1);
+    if (lineNumber <= lines.size())
+        return lines[lineNumber - 1].toString();
+    if (lineNumber == lines.size() + 1)
+        // the line still being assembled by the lexer
+        return curLen == 0 ? cstring("") : cstring(std::string(curLine, curLen));
+    BUG("Invalid line number %1%", lineNumber);
 }
 
 void InputSources::mapLine(cstring file, unsigned originalSourceLineNo) {
     if (sealed)
         BUG("Changing mapping to sealed InputSources");
     unsigned lineno = getCurrentLineNumber();
-    line_file_map.emplace(lineno, SourceFileLine(file, originalSourceLineNo));
+    if (!line_file_map.empty() && line_file_map.back().first == lineno)
+        // like std::map::emplace, keep the first mapping for a line
+        return;
+    line_file_map.emplace_back(lineno, SourceFileLine(file, originalSourceLineNo));
 }
 
 SourceFileLine InputSources::getSourceLine(unsigned line) const {
-    auto it = line_file_map.upper_bound(line+1);
+    auto it = std::upper_bound(
+        line_file_map.begin(), line_file_map.end(), line + 1,
+        [](unsigned l, const std::pair<unsigned, SourceFileLine> &e) { return l < e.first; });
     if (it == line_file_map.begin())
         // There must be always something mapped to line 0
         BUG("No source information for line %1%", line);
@@ -181,12 +283,12 @@ SourceFileLine InputSources::getSourceLine(unsigned line) const {
 }
 
 unsigned InputSources::getCurrentLineNumber() const {
-    return contents.size();
+    return lines.size() + 1;
 }
 
 SourcePosition InputSources::getCurrentPosition() const {
     unsigned line = getCurrentLineNumber();
-    unsigned column = contents.back().size();
+    unsigned column = curLen;
     return SourcePosition(line, column);
 }
 
@@ -219,19 +321,37 @@ cstring InputSources::getSourceFragment(const SourceInfo &position) const {
     if (!position.isValid())
         return "";
 
+    // The last line is still being appended to by the lexer, so fragments
+    // pointing into it cannot be memoized.
+    bool cacheable = position.getStart().getLineNumber() < getCurrentLineNumber();
+    auto key = std::make_tuple(
+        position.getStart().getLineNumber(), position.getStart().getColumnNumber(),
+        position.getEnd().getLineNumber(), position.getEnd().getColumnNumber());
+    if (cacheable) {
+        auto it = fragmentCache.find(key);
+        if (it != fragmentCache.end())
+            return it->second;
+    }
+
+    cstring result;
     // If the position spans multiple lines, truncate to just the first line
-    if (position.getEnd().getLineNumber() > position.getStart().getLineNumber())
-        return getSourceFragment(position.getStart());
+    if (position.getEnd().getLineNumber() > position.getStart().getLineNumber()) {
+        result = getSourceFragment(position.getStart());
+    } else {
+        cstring line = getLine(position.getStart().getLineNumber());
+        // Normally the line has a newline, but if not
+        // then we have to add a newline
+        cstring toadd = "";
+        if (line.find('\n') == nullptr)
+            toadd = cstring::newline;
+        cstring marker = carets(line, position.getStart().getColumnNumber(),
+                                position.getEnd().getColumnNumber());
+        result = line + toadd + marker + cstring::newline;
+    }
 
-    cstring result = getLine(position.getStart().getLineNumber());
-    // Normally result has a newline, but if not
-    // then we have to add a newline
-    cstring toadd = "";
-    if (result.find('\n') == nullptr)
-        toadd = cstring::newline;
-    cstring marker = carets(result, position.getStart().getColumnNumber(),
-                            position.getEnd().getColumnNumber());
-    return result + toadd + marker + cstring::newline;
+    if (cacheable)
+        fragmentCache.emplace(key, result);
+    return result;
 }
 
 cstring InputSources::getBriefSourceFragment(const SourceInfo &position) const {
@@ -267,8 +387,10 @@ cstring InputSources::getBriefSourceFragment(const SourceInfo &position) const {
 
 cstring InputSources::toDebugString() const {
     std::stringstream builder;
-    for (auto line : contents)
+    for (auto line : lines)
         builder << line;
+    if (curLen != 0)
+        builder.write(curLine, curLen);
     builder << "---------------" << std::endl;
     for (auto lf : line_file_map)
         builder << lf.first << ": " << lf.second.toString() << std::endl;
@@ -292,28 +414,28 @@ cstring SourceInfo::toBriefSourceFragment() const {
 cstring SourceInfo::toPositionString() const {
     if (!isValid())
         return "";
-    SourceFileLine position = sources->getSourceLine(start.getLineNumber());
+    SourceFileLine position = sources->getSourceLine(getStart().getLineNumber());
     return position.toString();
 }
 
 cstring SourceInfo::toSourcePositionData(unsigned *outLineNumber,
                                          unsigned *outColumnNumber) const {
-    SourceFileLine position = sources->getSourceLine(start.getLineNumber());
+    SourceFileLine position = sources->getSourceLine(getStart().getLineNumber());
     if (outLineNumber != nullptr) {
         *outLineNumber = position.sourceLine;
     }
     if (outColumnNumber != nullptr) {
-        *outColumnNumber = start.getColumnNumber();
+        *outColumnNumber = getStart().getColumnNumber();
     }
     return position.fileName.c_str();
 }
 
 SourceFileLine SourceInfo::toPosition() const {
-    return sources->getSourceLine(start.getLineNumber());
+    return sources->getSourceLine(getStart().getLineNumber());
 }
 
 cstring SourceInfo::getSourceFile() const {
-    auto sourceLine = sources->getSourceLine(start.getLineNumber());
+    auto sourceLine = sources->getSourceLine(getStart().getLineNumber());
     return sourceLine.fileName;
 }
 
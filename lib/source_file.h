@@ -21,6 +21,11 @@ limitations under the License.
 #ifndef P4C_LIB_SOURCE_FILE_H_
 #define P4C_LIB_SOURCE_FILE_H_
 
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest_prod.h"
@@ -136,26 +141,26 @@ For a program element, the start is inclusive and the end is
 exclusive (the first position after the language element).
 
 SourceInfo can also be "invalid"
+
+The two positions are packed into a single 64-bit word: every IR node
+carries a SourceInfo, so its size is paid tens of millions of times in
+a big compile.  Positions saturate on overflow, which at worst widens
+the range a diagnostic highlights.
 */
 class SourceInfo final {
  public:
-    cstring filename = "";
-    int line = -1;
-    int column = -1;
-    cstring srcBrief = "";
-    SourceInfo(cstring filename, int line, int column, cstring srcBrief) {
-        this->filename = filename;
-        this->line = line;
-        this->column = column;
-        this->srcBrief = srcBrief;
-    }
+    /// Creates a "detached" SourceInfo carrying a position restored from
+    /// a JSON dump (--fromJSON) instead of a range in an InputSources.
+    /// The strings live in a shared side table, not in this object.
+    SourceInfo(cstring filename, int line, int column, cstring srcBrief);
+
     /// Creates an "invalid" SourceInfo
     SourceInfo()
-        : sources(nullptr), start(SourcePosition()), end(SourcePosition()) {}
+        : sources(nullptr), rep(0) {}
 
     /// Creates a SourceInfo for a 'point' in the source, or invalid
     SourceInfo(const InputSources* sources, SourcePosition point)
-        : sources(sources), start(point), end(point) {}
+        : sources(sources), rep(encode(point, point)) {}
 
     SourceInfo(const InputSources* sources, SourcePosition start,
                SourcePosition end);
@@ -172,22 +177,22 @@ class SourceInfo final {
             return rhs;
         if (!rhs.isValid())
             return *this;
-        SourcePosition s = start.min(rhs.start);
-        SourcePosition e = end.max(rhs.end);
+        SourcePosition s = getStart().min(rhs.getStart());
+        SourcePosition e = getEnd().max(rhs.getEnd());
         return SourceInfo(sources, s, e);
     }
     SourceInfo &operator+=(const SourceInfo& rhs) {
         if (!isValid()) {
             *this = rhs;
         } else if (rhs.isValid()) {
-            start = start.min(rhs.start);
-            end = end.max(rhs.end);
+            rep = encode(getStart().min(rhs.getStart()),
+                         getEnd().max(rhs.getEnd()));
         }
         return *this;
     }
 
     bool operator==(const SourceInfo &rhs) const
-    { return start == rhs.start && end == rhs.end; }
+    { return getStart() == rhs.getStart() && getEnd() == rhs.getEnd(); }
 
     cstring toDebugString() const;
 
@@ -202,16 +207,32 @@ class SourceInfo final {
     SourceFileLine toPosition() const;
 
     bool isValid() const
-    { return this->start.isValid(); }
+    { return this->getStart().isValid(); }
     explicit operator bool() const { return isValid(); }
 
+    /// True if this carries a detached position restored from a JSON
+    /// dump rather than a range in an InputSources.
+    bool isDetached() const { return (rep & detachedTag) != 0; }
+    cstring detachedFilename() const;
+    int detachedLine() const;
+    int detachedColumn() const;
+    cstring detachedFragment() const;
+
     cstring getSourceFile() const;
 
-    const SourcePosition& getStart() const
-    { return this->start; }
+    SourcePosition getStart() const {
+        unsigned line = (rep >> 40) & 0x7FFFFF;
+        if (line == 0)
+            return SourcePosition();
+        return SourcePosition(line, (rep >> 28) & 0xFFF);
+    }
 
-    const SourcePosition& getEnd() const
-    { return this->end; }
+    SourcePosition getEnd() const {
+        unsigned line = (rep >> 40) & 0x7FFFFF;
+        if (line == 0)
+            return SourcePosition();
+        return SourcePosition(line + ((rep >> 12) & 0xFFFF), rep & 0xFFF);
+    }
 
     /**
        True if this comes 'before' this source position.
@@ -221,7 +242,7 @@ class SourceInfo final {
     bool operator< (const SourceInfo& rhs) const {
         if (!rhs.isValid()) return false;
         if (!isValid()) return true;
-        return this->start < rhs.start;
+        return this->getStart() < rhs.getStart();
     }
     inline bool operator> (const SourceInfo& rhs) const
     { return rhs.operator< (*this); }
@@ -231,9 +252,27 @@ class SourceInfo final {
     { return !this->operator< (rhs); }
 
  private:
+    // Layout of the packed word:
+    //   bit  63      detached tag (position restored from a JSON dump)
+    //   bits 62..40  start line (23 bits)
+    //   bits 39..28  start column (12 bits)
+    //   bits 27..12  line span, end line - start line (16 bits)
+    //   bits 11..0   end column (12 bits)
+    // An all-zero word (line 0) is the invalid SourceInfo; a detached
+    // word stores an index into the side table holding its strings.
+    static constexpr uint64_t detachedTag = uint64_t(1) << 63;
+    static uint64_t field(unsigned value, uint64_t limit)
+    { return value < limit ? value : limit; }
+    static uint64_t encode(const SourcePosition& start, const SourcePosition& end) {
+        uint64_t span = end.getLineNumber() > start.getLineNumber()
+                      ? field(end.getLineNumber() - start.getLineNumber(), 0xFFFF) : 0;
+        return (field(start.getLineNumber(), 0x7FFFFF) << 40) |
+               (field(start.getColumnNumber(), 0xFFF) << 28) |
+               (span << 12) | field(end.getColumnNumber(), 0xFFF);
+    }
+
     const InputSources* sources;
-    SourcePosition start;
-    SourcePosition end;
+    uint64_t rep;
 };
 
 class IHasSourceInfo {
@@ -256,26 +295,21 @@ struct SourceFileLine {
     cstring toString() const;
 };
 
+class InputSources;
+
 class Comment final : IHasDbPrint {
  private:
     SourceInfo srcInfo;
     bool singleLine;
-    cstring body;
+    /// The sources the comment was read from.  The comment text is a span
+    /// of the program text they already store -- srcInfo covers the whole
+    /// token, delimiters included -- so nothing is copied at capture time.
+    const InputSources* sources;
 
  public:
-    Comment(SourceInfo srcInfo, bool singleLine, cstring body):
-            srcInfo(srcInfo), singleLine(singleLine), body(body) {}
-    cstring toString() const {
-        std::string result;
-        if (singleLine)
-            result = "//";
-        else
-            result = "/*";
-        result += body;
-        if (!singleLine)
-            result += "*/";
-        return result;
-    }
+    Comment(SourceInfo srcInfo, bool singleLine, const InputSources* sources):
+            srcInfo(srcInfo), singleLine(singleLine), sources(sources) {}
+    cstring toString() const;
     void dbprint(std::ostream& out) const {
         out << toString();
     }
@@ -326,23 +360,69 @@ class InputSources final {
     cstring getBriefSourceFragment(const SourceInfo &position) const;
 
     cstring toDebugString() const;
-    void addComment(SourceInfo srcInfo, bool singleLine, cstring body);
+    void addComment(SourceInfo srcInfo, bool singleLine);
+
+    /// Record comments while lexing so that a pretty printer can re-emit
+    /// them.  Off by default: ordinary compiles never read the comments
+    /// back, and capturing them costs an allocation per comment, which adds
+    /// up on heavily commented generated sources.  Must be set before
+    /// parsing starts.
+    static void captureComments(bool capture) { captureComments_ = capture; }
+
+    /// Adds the name of every file that contributed program text -- the
+    /// main file and everything it includes -- to @p files.
+    void getAllFileNames(std::set<cstring>* files) const;
+
+    /// @returns the most recently constructed InputSources, or nullptr
+    /// if no program has been parsed yet.  Only one program is compiled
+    /// at a time (see the class comment), so these are the sources of
+    /// "the" program; used by drivers that outlive a compilation, such
+    /// as --watch mode.
+    static const InputSources* mostRecent() { return mostRecentInstance; }
 
  private:
     /// Append this text to the last line; must not contain newlines
     void appendToLastLine(StringRef text);
     /// Append a newline and start a new line
     void appendNewline(StringRef newline);
+    /// Make room for 'bytes' more characters on the line being assembled.
+    void reserve(size_t bytes);
 
     /// Input program that is being currently compiled; there can be only one.
     bool sealed;
 
-    std::map<unsigned, SourceFileLine> line_file_map;
-
-    /// Each line also stores the end-of-line character(s)
-    std::vector<std::string> contents;
-    /// The commends found in the file.
+    /// Original-source mapping established by cpp linemarkers, sorted by
+    /// line number (mapLine is only ever called for increasing lines);
+    /// queried with binary search.
+    std::vector<std::pair<unsigned, SourceFileLine>> line_file_map;
+
+    /// Memoized formatted fragments, keyed by start/end position.
+    /// Diagnostics are routinely emitted many times for the same position
+    /// (e.g. bulk deprecation warnings), and formatting them is much more
+    /// expensive than looking them up.
+    mutable std::map<std::tuple<unsigned, unsigned, unsigned, unsigned>, cstring> fragmentCache;
+
+    /// Program text is stored contiguously in large blocks and each line
+    /// is a slice into them, so a program costs a handful of allocations
+    /// rather than one heap string per line.  Storing StringRefs is safe
+    /// here despite the usual caveat: the blocks they point into are owned
+    /// by this same object and are never freed or moved.
+    static constexpr size_t blockSize = 1 << 16;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    /// Each line includes its end-of-line character(s)
+    std::vector<StringRef> lines;
+    /// The line the lexer is still appending to, at the end of the current
+    /// block; promoted into 'lines' when its newline arrives.
+    const char* curLine = nullptr;
+    size_t curLen = 0;
+    char* blockNext = nullptr;
+    size_t blockAvail = 0;
+    /// The comments found in the file; only populated when comment capture
+    /// is enabled, see captureComments.
     std::vector<Comment*> comments;
+
+    static const InputSources* mostRecentInstance;
+    static bool captureComments_;
 };
 
 }  // namespace Util
@@ -15,8 +15,10 @@ limitations under the License.
 */
 
 #include <stdarg.h>
+#include <array>
+#include <limits>
 #include <sstream>
-#include <deque>
+#include <vector>
 #include "stringify.h"
 #include "exceptions.h"
 
@@ -43,66 +45,96 @@ cstring toString(const void* value) {
     return result.str();
 }
 
-char DigitToChar(int digit) {
-    switch (digit) {
-        case 0: return '0';
-        case 1: return '1';
-        case 2: return '2';
-        case 3: return '3';
-        case 4: return '4';
-        case 5: return '5';
-        case 6: return '6';
-        case 7: return '7';
-        case 8: return '8';
-        case 9: return '9';
-        case 10: return 'a';
-        case 11: return 'b';
-        case 12: return 'c';
-        case 13: return 'd';
-        case 14: return 'e';
-        case 15: return 'f';
-        default: break;
-    }
-    BUG("Unexpected digit: %1%", digit);
+namespace {
+
+// Format @v backwards from @end in @base; returns the first digit.
+char* formatWord(char* end, unsigned long long v, unsigned base) {
+    static const char digit[] = "0123456789abcdef";
+    do {
+        *--end = digit[v % base];
+        v /= base;
+    } while (v);
+    return end;
 }
 
+}  // namespace
+
 cstring toString(big_int value, unsigned width, bool sign, unsigned int base) {
-    std::ostringstream oss;
-    big_int zero = 0;
-    if (value < zero) {
-        oss << "-";
-        value = -value;
+    // the tiny constants ToP4 and the emitters print all the time
+    if (width == 0 && base == 10 && value >= 0 && value <= 255) {
+        static const std::array<cstring, 256> tiny = []() {
+            std::array<cstring, 256> rv;
+            char buf[8];
+            for (unsigned i = 0; i < 256; i++) {
+                char* end = buf + sizeof(buf);
+                char* p = formatWord(end, i, 10);
+                rv[i] = cstring(std::string(p, end - p)); }
+            return rv; }();
+        return tiny[static_cast<unsigned>(value)];
     }
 
+    char buf[72];  // one machine word in base 2, or one chunk in any base
+    char* const end = buf + sizeof(buf);
+    std::string out;
+    if (value < 0) {
+        out += '-';
+        value = -value;
+    }
     if (width) {
-        oss << width;
-        oss << (sign ? "s" : "w");
+        char* p = formatWord(end, width, 10);
+        out.append(p, end - p);
+        out += sign ? 's' : 'w';
     }
     switch (base) {
         case 2:
-            oss << "0b";
+            out += "0b";
             break;
         case 8:
-            oss << "0o";
+            out += "0o";
             break;
         case 16:
-            oss << "0x";
+            out += "0x";
             break;
         case 10:
             break;
         default:
             BUG("Unexpected base %1%", base);
     }
-    std::deque<char> buf;
-    do {
-        const int digit =
-            static_cast<int>(static_cast<big_int>(value % base));
-        value /= base;
-        buf.push_front(DigitToChar(digit));
-    } while (value > 0);
-    for (auto ch : buf)
-        oss << ch;
-    return oss.str();
+    if (value <= std::numeric_limits<unsigned long long>::max()) {
+        char* p = formatWord(end, value.convert_to<unsigned long long>(), base);
+        out.append(p, end - p);
+    } else {
+        // Peel off the largest power of the base that fits a machine word,
+        // so each big_int operation yields a whole chunk of digits instead
+        // of one.  Chunks come out least significant first; inner ones are
+        // zero-padded on output.
+        unsigned perChunk;
+        std::vector<unsigned long long> chunks;
+        if (base == 10) {
+            const big_int chunkDiv = 10000000000000000000ULL;  // 10^19
+            perChunk = 19;
+            while (value > 0) {
+                big_int q = value / chunkDiv;
+                chunks.push_back(big_int(value - q * chunkDiv)
+                                     .convert_to<unsigned long long>());
+                value = q; }
+        } else {
+            // powers of two need no division at all
+            unsigned bitsPer = base == 8 ? 63 : 64;  // a multiple of the digit width
+            perChunk = base == 16 ? 16 : base == 8 ? 21 : 64;
+            const big_int mask = (big_int(1) << bitsPer) - 1;
+            while (value > 0) {
+                chunks.push_back(big_int(value & mask).convert_to<unsigned long long>());
+                value >>= bitsPer; }
+        }
+        for (size_t i = chunks.size(); i-- > 0;) {
+            char* p = formatWord(end, chunks[i], base);
+            if (i + 1 < chunks.size())
+                while (end - p < static_cast<ptrdiff_t>(perChunk))
+                    *--p = '0';
+            out.append(p, end - p); }
+    }
+    return cstring(out);
 }
 
 cstring toString(cstring value) {
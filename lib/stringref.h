@@ -81,8 +81,11 @@ struct StringRef {
     template <class T> bool operator>=(T a) const { return compare(a) >= 0; }
 
     explicit operator std::string() const { return std::string(p, len); }
-    operator cstring() const { return std::string(p, len); }
-    cstring toString() const { return std::string(p, len); }
+    operator cstring() const { return p ? cstring(p, len) : cstring::empty; }
+    cstring toString() const { return p ? cstring(p, len) : cstring::empty; }
+    /// The interned cstring for this string if one exists, else null;
+    /// never interns (see cstring::find_interned).
+    cstring find_interned() const { return cstring::find_interned(p, len); }
     std::string string() const { return std::string(p, len); }
     StringRef &operator+=(size_t i) {
         if (len < i) { p = 0; len = 0;
@@ -0,0 +1,139 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "threadpool.h"
+
+#include <deque>
+
+#include "lib/compile_context.h"
+#include "lib/gc.h"
+
+namespace Util {
+
+namespace {
+/// Index of the pool queue owned by this thread, or -1 on threads that are
+/// not pool workers.
+thread_local int workerIndex = -1;
+}  // namespace
+
+struct ThreadPool::Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+unsigned ThreadPool::configuredWorkers = 0;
+std::atomic<bool> ThreadPool::started(false);
+
+void ThreadPool::configure(unsigned workers) {
+    if (started)
+        return;  // too late: the pool is already running
+    configuredWorkers = workers;
+}
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool() : pendingTasks(0), shuttingDown(false), nextVictim(0) {
+    started = true;
+    unsigned n = configuredWorkers;
+    if (n == 0) {
+        n = std::thread::hardware_concurrency();
+        if (n > 1) n -= 1;  // leave a hardware thread for the submitter
+        if (n == 0) n = 1;
+    }
+    queues.reserve(n);
+    for (unsigned i = 0; i < n; i++)
+        queues.emplace_back(new Queue());
+    threads.reserve(n);
+    for (unsigned i = 0; i < n; i++)
+        threads.emplace_back([this, i]() { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    shuttingDown = true;
+    wakeup.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void ThreadPool::post(std::function<void()> work) {
+    Task task;
+    task.work = std::move(work);
+    task.context = CompileContextStack::currentOrNull();
+    // A worker queues onto its own deque; other threads round-robin.
+    size_t target = workerIndex >= 0 ? size_t(workerIndex)
+                                     : nextVictim++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    pendingTasks++;
+    // Taking the sleep mutex here closes the window between a worker
+    // checking the (old) pending count and going to sleep, which would
+    // otherwise swallow the notification.
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wakeup.notify_one();
+}
+
+bool ThreadPool::runOneTask() {
+    size_t n = queues.size();
+    size_t self = workerIndex >= 0 ? size_t(workerIndex) : 0;
+    for (size_t i = 0; i < n; i++) {
+        auto& queue = *queues[(self + i) % n];
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (i == 0 && workerIndex >= 0) {
+                // Newest first from our own deque, for locality.
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                // Steal the oldest task from the victim.
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        pendingTasks--;
+        // The context stack is thread-local; run the task under the context
+        // it was submitted from.  Exceptions are captured by the
+        // packaged_task every entry point wraps work in.
+        InheritedCompileContext context(task.context);
+        task.work();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    gc_register_thread();
+    workerIndex = int(index);
+    while (true) {
+        if (runOneTask())
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeup.wait(lock, [this]() {
+            return pendingTasks.load() != 0 || shuttingDown.load(); });
+        if (shuttingDown && pendingTasks.load() == 0)
+            break;
+    }
+    gc_unregister_thread();
+}
+
+}  // namespace Util
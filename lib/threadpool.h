@@ -0,0 +1,154 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef P4C_LIB_THREADPOOL_H_
+#define P4C_LIB_THREADPOOL_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ICompileContext;
+
+namespace Util {
+
+/// The process-wide work-stealing thread pool.  Parallel compilation phases
+/// should submit their work here instead of spawning their own threads, so
+/// the process never oversubscribes the machine however many phases overlap.
+/// Each worker owns a deque: it runs its own newest task first and steals the
+/// oldest task of another worker when it runs dry.  Every task runs under the
+/// submitting thread's compilation context (the context stack is
+/// thread-local) and may allocate GC memory; workers are registered with the
+/// collector when they start.
+class ThreadPool {
+ public:
+    /// @return the shared pool.  The workers are started the first time this
+    /// is called.
+    static ThreadPool& instance();
+
+    /// Set the worker count of the shared pool; 0 (the default) sizes it to
+    /// the hardware.  Only effective before the first use of instance(), so
+    /// CompilerOptions calls it while the command line is processed.
+    static void configure(unsigned workers);
+
+    /// The number of worker threads, not counting threads that merely submit
+    /// work or help out while waiting for it.
+    unsigned workerCount() const { return unsigned(queues.size()); }
+
+    /// Run @work on the pool and return a future for its result.  Exceptions
+    /// thrown by @work are captured in the future.
+    template <typename Func>
+    std::future<typename std::result_of<Func()>::type> enqueue(Func&& work) {
+        typedef typename std::result_of<Func()>::type Result;
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Func>(work));
+        auto result = task->get_future();
+        post([task]() { (*task)(); });
+        return result;
+    }
+
+    /// Apply @func to every element of the random-access range [begin, end),
+    /// e.g. an IR::Vector.  The calling thread participates, and while
+    /// waiting for stragglers it runs other queued tasks, so nested calls
+    /// from inside a task do not deadlock.  Returns once the whole range has
+    /// been processed; the first exception thrown by @func is rethrown here.
+    template <typename Iterator, typename Func>
+    void forEach(Iterator begin, Iterator end, Func func) {
+        typedef typename std::iterator_traits<Iterator>::difference_type Diff;
+        size_t n = size_t(std::distance(begin, end));
+        if (n == 0) return;
+        std::atomic<size_t> next(0);
+        auto lane = [begin, n, &next, &func]() {
+            size_t i;
+            while ((i = next.fetch_add(1)) < n)
+                func(*(begin + Diff(i)));
+        };
+        size_t lanes = workerCount();
+        if (lanes > n - 1) lanes = n - 1;
+        std::vector<std::future<void>> helpers;
+        helpers.reserve(lanes);
+        for (size_t i = 0; i < lanes; i++)
+            helpers.push_back(enqueue(lane));
+        lane();  // the calling thread is a lane too
+        std::exception_ptr failure;
+        for (auto& helper : helpers) {
+            // The helper may be queued behind long tasks; run other work
+            // rather than blocking, in case that work is what it waits on.
+            while (helper.wait_for(std::chrono::seconds::zero()) !=
+                   std::future_status::ready)
+                if (!runOneTask())
+                    helper.wait();
+            try {
+                helper.get();
+            } catch (...) {
+                if (!failure) failure = std::current_exception();
+            }
+        }
+        if (failure) std::rethrow_exception(failure);
+    }
+
+ private:
+    ThreadPool();
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// A queued task and the compilation context it was submitted under.
+    struct Task {
+        std::function<void()> work;
+        ICompileContext* context;
+    };
+    struct Queue;
+
+    /// Queue @work, tagged with the caller's compilation context.
+    void post(std::function<void()> work);
+
+    /// Take one queued task -- preferring the calling worker's own deque --
+    /// and run it.  @return false if every queue was empty.
+    bool runOneTask();
+
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues;  // one per worker
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wakeup;
+    std::atomic<size_t> pendingTasks;
+    std::atomic<bool> shuttingDown;
+    std::atomic<size_t> nextVictim;  // round-robin cursor for submitters
+
+    static unsigned configuredWorkers;
+    static std::atomic<bool> started;
+};
+
+/// Apply @func to every element of @range (an IR::Vector, a safe_vector, or
+/// any other random-access range) using the shared pool.
+template <typename Range, typename Func>
+void parallel_for_each(const Range& range, Func func) {
+    ThreadPool::instance().forEach(range.begin(), range.end(), func);
+}
+
+}  // namespace Util
+
+#endif /* P4C_LIB_THREADPOOL_H_ */
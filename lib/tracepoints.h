@@ -0,0 +1,55 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef P4C_LIB_TRACEPOINTS_H_
+#define P4C_LIB_TRACEPOINTS_H_
+
+#include "config.h"
+
+/* USDT static tracepoints, provider "p4c".  When <sys/sdt.h> is available
+ * each probe compiles to a single nop that perf/bpftrace/systemtap can
+ * patch at runtime, so production binaries carry them for free and
+ * flamegraph or latency tooling can attach without an instrumented
+ * rebuild; without the header the macros (and their arguments) vanish.
+ *
+ * Probes currently placed:
+ *   pass_start(manager, pass)               PassManager, before each pass
+ *   pass_end(manager, pass, total_visits)   ... and after; total_visits is
+ *                                           the cumulative node-visit
+ *                                           counter, diff across probes
+ *   visit_node(node_type, node_id)          every node a visitor enters
+ *   gc_start()                              collection begins
+ *   gc_end(pause_nsec, freed_bytes)         ... and ends
+ *   write_start(file)                       artifact write begins
+ *   write_end(file, bytes)                  ... and ends
+ *
+ * Keep probe arguments cheap: they are evaluated even when nothing is
+ * attached. */
+
+#if HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define P4C_PROBE(name)             DTRACE_PROBE(p4c, name)
+#define P4C_PROBE1(name, a)         DTRACE_PROBE1(p4c, name, a)
+#define P4C_PROBE2(name, a, b)      DTRACE_PROBE2(p4c, name, a, b)
+#define P4C_PROBE3(name, a, b, c)   DTRACE_PROBE3(p4c, name, a, b, c)
+#else
+#define P4C_PROBE(name)             do {} while (0)
+#define P4C_PROBE1(name, a)         do {} while (0)
+#define P4C_PROBE2(name, a, b)      do {} while (0)
+#define P4C_PROBE3(name, a, b, c)   do {} while (0)
+#endif /* HAVE_SYS_SDT_H */
+
+#endif /* P4C_LIB_TRACEPOINTS_H_ */
@@ -0,0 +1,155 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef P4C_LIB_VIEW_H_
+#define P4C_LIB_VIEW_H_
+
+#include <iterator>
+#include <utility>
+
+/* Lightweight composable views over anything with begin()/end(), including
+ * Util::Enumerator, whose handles model the same single-pass iteration.
+ * Unlike the Enumerator adaptors, the predicate or transform is a template
+ * parameter here, so composed pipelines inline completely and cost no
+ * virtual dispatch or allocation per element.  Views follow the
+ * EnumeratorHandle convention that operator!= only ever compares against
+ * end(), which lets them wrap single-pass sources. */
+
+namespace Util {
+namespace Views {
+
+template<class R, class Pred>
+class filter_view {
+ public:
+    typedef decltype(std::begin(std::declval<R&>())) source_iterator;
+    typedef decltype(*std::declval<source_iterator&>()) reference;
+
+    class iterator {
+        source_iterator cur, last;
+        const Pred *pred;
+        void advance() { while (cur != last && !(*pred)(*cur)) ++cur; }
+        friend class filter_view;
+        iterator(source_iterator c, source_iterator l, const Pred *p, bool atEnd)
+            : cur(std::move(c)), last(std::move(l)), pred(p) { if (!atEnd) advance(); }
+     public:
+        reference operator*() const { return *cur; }
+        iterator &operator++() { ++cur; advance(); return *this; }
+        bool operator!=(const iterator &) const { return cur != last; }
+    };
+
+    filter_view(R &&source, Pred pred)
+        : source(std::forward<R>(source)), pred(std::move(pred)) {}
+    iterator begin() { return iterator(std::begin(source), std::end(source), &pred, false); }
+    iterator end() { return iterator(std::end(source), std::end(source), &pred, true); }
+
+ private:
+    R source;
+    Pred pred;
+};
+
+template<class R, class Fn>
+class map_view {
+ public:
+    typedef decltype(std::begin(std::declval<R&>())) source_iterator;
+    typedef typename std::decay<
+        decltype(std::declval<Fn&>()(*std::declval<source_iterator&>()))>::type value_type;
+
+    class iterator {
+        source_iterator cur, last;
+        const Fn *fn;
+        friend class map_view;
+        iterator(source_iterator c, source_iterator l, const Fn *f)
+            : cur(std::move(c)), last(std::move(l)), fn(f) {}
+     public:
+        value_type operator*() const { return (*fn)(*cur); }
+        iterator &operator++() { ++cur; return *this; }
+        bool operator!=(const iterator &) const { return cur != last; }
+    };
+
+    map_view(R &&source, Fn fn)
+        : source(std::forward<R>(source)), fn(std::move(fn)) {}
+    iterator begin() { return iterator(std::begin(source), std::end(source), &fn); }
+    iterator end() { return iterator(std::end(source), std::end(source), &fn); }
+
+ private:
+    R source;
+    Fn fn;
+};
+
+template<class R1, class R2>
+class concat_view {
+ public:
+    typedef decltype(std::begin(std::declval<R1&>())) iterator1;
+    typedef decltype(std::begin(std::declval<R2&>())) iterator2;
+    typedef typename std::decay<decltype(*std::declval<iterator1&>())>::type value_type;
+
+    class iterator {
+        iterator1 cur1, last1;
+        iterator2 cur2, last2;
+        bool inFirst;
+        void norm() { if (inFirst && !(cur1 != last1)) inFirst = false; }
+        friend class concat_view;
+        iterator(iterator1 c1, iterator1 l1, iterator2 c2, iterator2 l2)
+            : cur1(std::move(c1)), last1(std::move(l1)),
+              cur2(std::move(c2)), last2(std::move(l2)), inFirst(true) { norm(); }
+     public:
+        value_type operator*() const { return inFirst ? value_type(*cur1) : value_type(*cur2); }
+        iterator &operator++() {
+            if (inFirst) {
+                ++cur1;
+                norm();
+            } else {
+                ++cur2; }
+            return *this; }
+        bool operator!=(const iterator &) const { return inFirst || cur2 != last2; }
+    };
+
+    concat_view(R1 &&first, R2 &&second)
+        : first(std::forward<R1>(first)), second(std::forward<R2>(second)) {}
+    iterator begin() {
+        return iterator(std::begin(first), std::end(first),
+                        std::begin(second), std::end(second)); }
+    iterator end() {
+        return iterator(std::end(first), std::end(first),
+                        std::end(second), std::end(second)); }
+
+ private:
+    R1 first;
+    R2 second;
+};
+
+// Elements of @source for which @pred returns true.
+template<class R, class Pred>
+filter_view<R, Pred> filter(R &&source, Pred pred) {
+    return filter_view<R, Pred>(std::forward<R>(source), std::move(pred));
+}
+
+// @fn applied to each element of @source.
+template<class R, class Fn>
+map_view<R, Fn> map(R &&source, Fn fn) {
+    return map_view<R, Fn>(std::forward<R>(source), std::move(fn));
+}
+
+// All elements of @first, then all elements of @second.
+template<class R1, class R2>
+concat_view<R1, R2> concat(R1 &&first, R2 &&second) {
+    return concat_view<R1, R2>(std::forward<R1>(first), std::forward<R2>(second));
+}
+
+}  // namespace Views
+}  // namespace Util
+
+#endif  /* P4C_LIB_VIEW_H_ */
@@ -20,31 +20,12 @@ limitations under the License.
 
 namespace P4 {
 
-const IR::Node* DoMoveActionsToTables::postorder(IR::MethodCallStatement* statement) {
-    auto mi = MethodInstance::resolve(statement, refMap, typeMap);
-    if (!mi->is<ActionCall>())
-        return statement;
-    auto ac = mi->to<ActionCall>();
-
-    auto action = ac->action;
-    auto directionArgs = new IR::Vector<IR::Argument>();
-    auto mc = statement->methodCall;
-
-    // TODO: should use argument names
-    auto it = action->parameters->parameters.begin();
-    auto arg = mc->arguments->begin();
-    for (; it != action->parameters->parameters.end(); ++it) {
-        auto p = *it;
-        if (p->direction == IR::Direction::None)
-            break;
-        directionArgs->push_back(*arg);
-        ++arg;
-    }
-
+const IR::Node* DoMoveActionsToTables::synthesizeTable(
+        const IR::MethodCallStatement* statement, const IR::MethodCallExpression* mc,
+        cstring actionName, const IR::Vector<IR::Argument>* directionArgs,
+        const IR::Vector<IR::Argument>* otherArgs) {
     // Action invocation
-    BUG_CHECK(ac->expr->method->is<IR::PathExpression>(),
-              "%1%: Expected a PathExpression", ac->expr->method);
-    auto actionPath = new IR::PathExpression(IR::ID(mc->srcInfo, ac->action->name));
+    auto actionPath = new IR::PathExpression(IR::ID(mc->srcInfo, actionName));
     auto call = new IR::MethodCallExpression(mc->srcInfo, actionPath,
                                              new IR::Vector<IR::Type>(), directionArgs);
     auto actinst = new IR::ActionListElement(statement->srcInfo, call);
@@ -54,12 +35,6 @@ const IR::Node* DoMoveActionsToTables::postorder(IR::MethodCallStatement* statem
         IR::ID(IR::TableProperties::actionsPropertyName, nullptr),
         actlist, false);
     // default action property
-    auto otherArgs = new IR::Vector<IR::Argument>();
-    for (; it != action->parameters->parameters.end(); ++it) {
-        otherArgs->push_back(*arg);
-        ++arg;
-    }
-    BUG_CHECK(arg == mc->arguments->end(), "%1%: mismatched arguments", mc);
     auto amce = new IR::MethodCallExpression(mc->srcInfo, mc->method, mc->typeArguments, otherArgs);
     auto defactval = new IR::ExpressionValue(amce);
     auto defprop = new IR::Property(
@@ -69,7 +44,7 @@ const IR::Node* DoMoveActionsToTables::postorder(IR::MethodCallStatement* statem
     // List of table properties
     auto props = new IR::TableProperties({ prop, defprop });
     // Synthesize a new table
-    cstring tblName = IR::ID(refMap->newName(cstring("tbl_") + ac->action->name.name), nullptr);
+    cstring tblName = IR::ID(refMap->newName(cstring("tbl_") + actionName), nullptr);
 
     auto annos = new IR::Annotations();
     annos->add(new IR::Annotation(IR::Annotation::hiddenAnnotation, {}));
@@ -86,9 +61,53 @@ const IR::Node* DoMoveActionsToTables::postorder(IR::MethodCallStatement* statem
     return stat;
 }
 
+const IR::Node* DoMoveActionsToTables::postorder(IR::MethodCallStatement* statement) {
+    if (synthesized != nullptr &&
+        synthesized->count(getOriginal<IR::MethodCallStatement>()) != 0) {
+        // A call created by DoSynthesizeActions in the same pass
+        // manager: not in the type map, but known to be an invocation of
+        // a parameterless action.
+        auto mc = statement->methodCall;
+        auto path = mc->method->to<IR::PathExpression>();
+        CHECK_NULL(path);
+        return synthesizeTable(statement, mc, path->path->name.name,
+                               new IR::Vector<IR::Argument>(), new IR::Vector<IR::Argument>());
+    }
+
+    auto mi = MethodInstance::resolve(statement, refMap, typeMap);
+    if (!mi->is<ActionCall>())
+        return statement;
+    auto ac = mi->to<ActionCall>();
+
+    auto action = ac->action;
+    auto directionArgs = new IR::Vector<IR::Argument>();
+    auto mc = statement->methodCall;
+
+    // TODO: should use argument names
+    auto it = action->parameters->parameters.begin();
+    auto arg = mc->arguments->begin();
+    for (; it != action->parameters->parameters.end(); ++it) {
+        auto p = *it;
+        if (p->direction == IR::Direction::None)
+            break;
+        directionArgs->push_back(*arg);
+        ++arg;
+    }
+
+    auto otherArgs = new IR::Vector<IR::Argument>();
+    for (; it != action->parameters->parameters.end(); ++it) {
+        otherArgs->push_back(*arg);
+        ++arg;
+    }
+    BUG_CHECK(arg == mc->arguments->end(), "%1%: mismatched arguments", mc);
+
+    BUG_CHECK(ac->expr->method->is<IR::PathExpression>(),
+              "%1%: Expected a PathExpression", ac->expr->method);
+    return synthesizeTable(statement, mc, ac->action->name.name, directionArgs, otherArgs);
+}
+
 const IR::Node* DoMoveActionsToTables::postorder(IR::P4Control* control) {
-    for (auto t : tables)
-        control->controlLocals.push_back(t);
+    control->controlLocals.append(tables);
     return control;
 }
 
@@ -119,8 +138,7 @@ const IR::Node* DoSynthesizeActions::preorder(IR::P4Control* control) {
 }
 
 const IR::Node* DoSynthesizeActions::postorder(IR::P4Control* control) {
-    for (auto a : actions)
-        control->controlLocals.push_back(a);
+    control->controlLocals.append(actions);
     return control;
 }
 
@@ -208,6 +226,8 @@ const IR::Statement* DoSynthesizeActions::createAction(const IR::Statement* toAd
     auto actpath = new IR::PathExpression(name);
     auto repl = new IR::MethodCallExpression(toAdd->srcInfo, actpath);
     auto result = new IR::MethodCallStatement(toAdd->srcInfo, repl);
+    if (synthesizedCalls != nullptr)
+        synthesizedCalls->insert(result);
     return result;
 }
 
@@ -76,10 +76,21 @@ class DoMoveActionsToTables : public Transform {
     ReferenceMap* refMap;
     TypeMap*      typeMap;
     std::vector<const IR::P4Table*> tables;  // inserted tables
+    /// If not null, calls created by a DoSynthesizeActions run in the
+    /// same pass manager.  They are not in the type map, but are known
+    /// to be argument-less action invocations, so they can be wrapped in
+    /// tables without re-typechecking the program in between.
+    const std::set<const IR::MethodCallStatement*>* synthesized;
+
+    const IR::Node* synthesizeTable(const IR::MethodCallStatement* statement,
+                                    const IR::MethodCallExpression* mc, cstring actionName,
+                                    const IR::Vector<IR::Argument>* directionArgs,
+                                    const IR::Vector<IR::Argument>* otherArgs);
 
  public:
-    DoMoveActionsToTables(ReferenceMap* refMap, TypeMap* typeMap)
-            : refMap(refMap), typeMap(typeMap)
+    DoMoveActionsToTables(ReferenceMap* refMap, TypeMap* typeMap,
+                          const std::set<const IR::MethodCallStatement*>* synthesized = nullptr)
+            : refMap(refMap), typeMap(typeMap), synthesized(synthesized)
     { CHECK_NULL(refMap); CHECK_NULL(typeMap); setName("DoMoveActionsToTables"); }
     const IR::Node* preorder(IR::P4Parser* parser) override
     { prune(); return parser; }
@@ -114,14 +125,19 @@ class DoSynthesizeActions : public Transform {
     std::vector<const IR::P4Action*> actions;  // inserted actions
     bool changes = false;
     ActionSynthesisPolicy* policy;
+    /// If not null, records the call statements created for synthesized
+    /// actions, for a DoMoveActionsToTables running in the same pass
+    /// manager.
+    std::set<const IR::MethodCallStatement*>* synthesizedCalls;
 
  public:
     // If true the statement must be moved to an action
     bool mustMove(const IR::MethodCallStatement* statement);
     bool mustMove(const IR::AssignmentStatement* statement);
 
-    DoSynthesizeActions(ReferenceMap* refMap, TypeMap* typeMap, ActionSynthesisPolicy* policy) :
-            refMap(refMap), typeMap(typeMap), policy(policy)
+    DoSynthesizeActions(ReferenceMap* refMap, TypeMap* typeMap, ActionSynthesisPolicy* policy,
+                        std::set<const IR::MethodCallStatement*>* synthesizedCalls = nullptr) :
+            refMap(refMap), typeMap(typeMap), policy(policy), synthesizedCalls(synthesizedCalls)
     { CHECK_NULL(refMap); CHECK_NULL(typeMap); setName("DoSynthesizeActions"); }
     const IR::Node* preorder(IR::P4Parser* parser) override
     { prune(); return parser; }
@@ -166,6 +182,29 @@ class MoveActionsToTables : public PassManager {
     }
 };
 
+/**
+Runs action synthesis and table creation as one group with a single
+type checking.  The set of call statements created by action synthesis
+is shared with the move-to-tables transform, which wraps them in tables
+directly -- they are known to be argument-less action invocations --
+instead of requiring the program to be re-typechecked in between, as
+running SynthesizeActions followed by MoveActionsToTables does.
+*/
+class SynthesizeActionsAndMoveToTables : public PassManager {
+    std::set<const IR::MethodCallStatement*> synthesized;
+ public:
+    SynthesizeActionsAndMoveToTables(ReferenceMap* refMap, TypeMap* typeMap,
+                                     ActionSynthesisPolicy* policy = nullptr,
+                                     TypeChecking* typeChecking = nullptr) {
+        if (!typeChecking)
+            typeChecking = new TypeChecking(refMap, typeMap);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoSynthesizeActions(refMap, typeMap, policy, &synthesized));
+        passes.push_back(new DoMoveActionsToTables(refMap, typeMap, &synthesized));
+        setName("SynthesizeActionsAndMoveToTables");
+    }
+};
+
 }  // namespace P4
 
 #endif /* _MIDEND_ACTIONSYNTHESIS_H_ */
@@ -45,7 +45,7 @@ const IR::Expression* RemoveComplexComparisons::explode(
         const IR::Expression* lvalid;
         if (left->is<IR::StructExpression>()) {
             // A header defined this way is always valid
-            lvalid = new IR::BoolLiteral(true);
+            lvalid = IR::BoolLiteral::get(true);
         } else {
             lvalid = new IR::MethodCallExpression(srcInfo, lmethod);
         }
@@ -54,13 +54,13 @@ const IR::Expression* RemoveComplexComparisons::explode(
         const IR::Expression* rvalid;
         if (!rightTuple) {
             if (right->is<IR::StructExpression>()) {
-                rvalid = new IR::BoolLiteral(true);
+                rvalid = IR::BoolLiteral::get(true);
             } else {
                 auto rmethod = new IR::Member(right, IR::Type_Header::isValid);
                 rvalid = new IR::MethodCallExpression(srcInfo, rmethod);
             }
         } else {
-            rvalid = new IR::BoolLiteral(true);
+            rvalid = IR::BoolLiteral::get(true);
         }
 
         auto rinvalid = new IR::LNot(srcInfo, rvalid);
@@ -93,7 +93,7 @@ const IR::Expression* RemoveComplexComparisons::explode(
         return result;
     } else if (auto st = leftType->to<IR::Type_StructLike>()) {
         // Works for structs and unions
-        const IR::Expression* result = new IR::BoolLiteral(true);
+        const IR::Expression* result = IR::BoolLiteral::get(true);
         size_t index = 0;
         for (auto f : st->fields) {
             auto ftype = f->type;
@@ -120,7 +120,7 @@ const IR::Expression* RemoveComplexComparisons::explode(
         return result;
     } else if (auto at = leftType->to<IR::Type_Stack>()) {
         auto size = at->getSize();
-        const IR::Expression* result = new IR::BoolLiteral(true);
+        const IR::Expression* result = IR::BoolLiteral::get(true);
         BUG_CHECK(rightType->is<IR::Type_Stack>(),
                   "%1%: comparing stack with %1%", left, rightType);
         for (unsigned i=0; i < size; i++) {
@@ -133,7 +133,7 @@ const IR::Expression* RemoveComplexComparisons::explode(
         return result;
     } else if (leftTuple) {
         BUG_CHECK(rightTuple, "%1% vs %2%: unexpected comparison", left, right);
-        const IR::Expression* result = new IR::BoolLiteral(true);
+        const IR::Expression* result = IR::BoolLiteral::get(true);
         auto leftList = left->to<IR::ListExpression>();
         for (size_t index = 0; index < leftList->components.size(); index++) {
             auto fleft = leftList->components.at(index);
@@ -149,6 +149,28 @@ const IR::Expression* RemoveComplexComparisons::explode(
     }
 }
 
+namespace {
+// A bulk comparison needs addressable operands.
+bool isLvalue(const IR::Expression* expression) {
+    return expression->is<IR::PathExpression>() ||
+           expression->is<IR::Member>() ||
+           expression->is<IR::ArrayIndex>();
+}
+}  // namespace
+
+bool RemoveComplexComparisons::byteComparable(const IR::Type* type) {
+    auto st = type->to<IR::Type_Struct>();
+    if (st == nullptr)
+        return false;
+    for (auto f : st->fields) {
+        if (f->type->is<IR::Type_Bits>() || f->type->is<IR::Type_Boolean>())
+            continue;
+        // nested structs, headers, stacks, varbits: expand instead
+        return false;
+    }
+    return true;
+}
+
 const IR::Node* RemoveComplexComparisons::postorder(IR::Operation_Binary* expression) {
     if (!expression->is<IR::Neq>() && !expression->is<IR::Equ>())
         return expression;
@@ -157,6 +179,11 @@ const IR::Node* RemoveComplexComparisons::postorder(IR::Operation_Binary* expres
     if (!ltype->is<IR::Type_StructLike>() && !ltype->is<IR::Type_Stack>() &&
         !ltype->is<IR::Type_BaseList>())
         return expression;
+    if (keepBulkComparisons &&
+        byteComparable(ltype) && byteComparable(rtype) &&
+        isLvalue(expression->left) && isLvalue(expression->right))
+        // The target can compare the whole struct in one operation
+        return expression;
     auto result = explode(expression->srcInfo, ltype, expression->left, rtype, expression->right);
     if (expression->is<IR::Neq>())
         result = new IR::LNot(expression->srcInfo, result);
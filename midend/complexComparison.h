@@ -30,6 +30,12 @@ class RemoveComplexComparisons : public Transform {
  protected:
     ReferenceMap* refMap;
     TypeMap* typeMap;
+    /* Specific targets can compare a flat struct with a single bulk
+     * comparison.  When keepBulkComparisons is set, comparisons of
+     * byte-comparable structs -- flat, fixed-width fields, no varbits --
+     * between two lvalues are left intact for the backend.  Headers are
+     * always expanded, since their comparison involves validity bits. */
+    bool keepBulkComparisons;
 
     /// Expands left == right into sub-field comparisons
     const IR::Expression* explode(
@@ -37,9 +43,14 @@ class RemoveComplexComparisons : public Transform {
         const IR::Type* leftType, const IR::Expression* left,
         const IR::Type* rightType, const IR::Expression* right);
 
+    /// True if the type is a flat struct whose comparison can be done
+    /// with a single bulk byte comparison.
+    static bool byteComparable(const IR::Type* type);
+
  public:
-    RemoveComplexComparisons(ReferenceMap* refMap, TypeMap* typeMap):
-            refMap(refMap), typeMap(typeMap)
+    RemoveComplexComparisons(ReferenceMap* refMap, TypeMap* typeMap,
+                             bool keepBulkComparisons = false):
+            refMap(refMap), typeMap(typeMap), keepBulkComparisons(keepBulkComparisons)
     { CHECK_NULL(refMap); CHECK_NULL(typeMap); setName("RemoveComplexComparisons"); }
     const IR::Node* postorder(IR::Operation_Binary* expression) override;
 };
@@ -47,11 +58,12 @@ class RemoveComplexComparisons : public Transform {
 class SimplifyComparisons final : public PassManager {
  public:
     SimplifyComparisons(ReferenceMap* refMap, TypeMap* typeMap,
+            bool keepBulkComparisons = false,
             TypeChecking* typeChecking = nullptr) {
         if (!typeChecking)
             typeChecking = new TypeChecking(refMap, typeMap);
         passes.push_back(typeChecking);
-        passes.push_back(new RemoveComplexComparisons(refMap, typeMap));
+        passes.push_back(new RemoveComplexComparisons(refMap, typeMap, keepBulkComparisons));
         setName("SimplifyComparisons");
     }
 };
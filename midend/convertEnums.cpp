@@ -22,8 +22,22 @@ const IR::Node* DoConvertEnums::preorder(IR::Type_Enum* type) {
     return type;
 }
 
+const IR::Node* DoConvertEnums::preorder(IR::Type_SerEnum* type) {
+    if (!convertSerEnums)
+        return type;
+    if (getParent<IR::P4Program>())
+        return nullptr;  // delete the declaration
+    return type->type;
+}
+
 const IR::Node* DoConvertEnums::postorder(IR::Type_Name* type) {
     auto canontype = typeMap->getTypeType(getOriginal(), true);
+    if (convertSerEnums && canontype->is<IR::Type_SerEnum>()) {
+        if (findContext<IR::TypeNameExpression>() != nullptr)
+            // This will be resolved by the caller.
+            return type;
+        return canontype->to<IR::Type_SerEnum>()->type;
+    }
     if (!canontype->is<IR::Type_Enum>())
         return type;
     if (findContext<IR::TypeNameExpression>() != nullptr)
@@ -41,6 +55,10 @@ const IR::Node* DoConvertEnums::postorder(IR::Member* expression) {
     auto ei = EnumInstance::resolve(getOriginal<IR::Member>(), typeMap);
     if (!ei)
         return expression;
+    if (convertSerEnums) {
+        if (auto sei = ei->to<SerEnumInstance>())
+            return sei->value;
+    }
     if (ei->is<SimpleEnumInstance>()) {
         auto r = ::get(repr, ei->type->to<IR::Type_Enum>());
         if (r == nullptr)
@@ -95,11 +95,16 @@ class DoConvertEnums : public Transform {
     std::map<const IR::Type_Enum*, EnumRepresentation*> repr;
     ChooseEnumRepresentation* policy;
     TypeMap* typeMap;
+    /// If true serializable enums are replaced by their underlying type
+    /// in the same traversal, subsuming a separate EliminateSerEnums run.
+    bool convertSerEnums;
  public:
-    DoConvertEnums(ChooseEnumRepresentation* policy, TypeMap* typeMap)
-            : policy(policy), typeMap(typeMap)
+    DoConvertEnums(ChooseEnumRepresentation* policy, TypeMap* typeMap,
+                   bool convertSerEnums = false)
+            : policy(policy), typeMap(typeMap), convertSerEnums(convertSerEnums)
     { CHECK_NULL(policy); CHECK_NULL(typeMap); setName("DoConvertEnums"); }
     const IR::Node* preorder(IR::Type_Enum* type) override;
+    const IR::Node* preorder(IR::Type_SerEnum* type) override;
     const IR::Node* postorder(IR::Type_Name* type) override;
     const IR::Node* postorder(IR::Member* expression) override;
 };
@@ -110,8 +115,9 @@ class ConvertEnums : public PassManager {
     using EnumMapping = decltype(DoConvertEnums::repr);
     ConvertEnums(ReferenceMap* refMap, TypeMap* typeMap,
                  ChooseEnumRepresentation* policy,
+                 bool convertSerEnums = false,
                  TypeChecking* typeChecking = nullptr)
-        : convertEnums(new DoConvertEnums(policy, typeMap)) {
+        : convertEnums(new DoConvertEnums(policy, typeMap, convertSerEnums)) {
         if (!typeChecking)
             typeChecking = new TypeChecking(refMap, typeMap);
         passes.push_back(typeChecking);
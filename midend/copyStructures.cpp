@@ -96,6 +96,9 @@ const IR::Node* DoCopyStructures::postorder(IR::AssignmentStatement* statement)
                       statement->right->is<IR::ArrayIndex>(),
                       "%1%: Unexpected operation when eliminating struct copying",
                       statement->right);
+            if (keepBulkCopies)
+                // The target can copy the whole struct in one operation
+                return statement;
             for (auto f : strct->fields) {
                 auto right = new IR::Member(statement->right, f->name);
                 auto left = new IR::Member(statement->left, f->name);
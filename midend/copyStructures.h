@@ -59,9 +59,16 @@ class DoCopyStructures : public Transform {
      * errorOnMethodCall flag will produce an error message if such a
      * method is encountered. */
     bool errorOnMethodCall;
+    /* Specific targets can implement a struct-to-struct assignment as a
+     * single bulk copy.  When keepBulkCopies is set, assignments whose
+     * right-hand side is also an lvalue are left intact for the backend;
+     * struct initializers are still expanded field by field. */
+    bool keepBulkCopies;
  public:
-    explicit DoCopyStructures(TypeMap* typeMap, bool errorOnMethodCall) :
-            typeMap(typeMap), errorOnMethodCall(errorOnMethodCall)
+    explicit DoCopyStructures(TypeMap* typeMap, bool errorOnMethodCall,
+                              bool keepBulkCopies = false) :
+            typeMap(typeMap), errorOnMethodCall(errorOnMethodCall),
+            keepBulkCopies(keepBulkCopies)
     { CHECK_NULL(typeMap); setName("DoCopyStructures"); }
     const IR::Node* postorder(IR::AssignmentStatement* statement) override;
 };
@@ -106,6 +113,7 @@ class CopyStructures : public PassRepeated {
  public:
     CopyStructures(ReferenceMap* refMap, TypeMap* typeMap,
                    bool errorOnMethodCall = true,
+                   bool keepBulkCopies = false,
                    TypeChecking* typeChecking = nullptr) :
             PassManager({}) {
         CHECK_NULL(refMap); CHECK_NULL(typeMap); setName("CopyStructures");
@@ -114,7 +122,7 @@ class CopyStructures : public PassRepeated {
         passes.emplace_back(typeChecking);
         passes.emplace_back(new RemoveAliases(refMap, typeMap));
         passes.emplace_back(typeChecking);
-        passes.emplace_back(new DoCopyStructures(typeMap, errorOnMethodCall));
+        passes.emplace_back(new DoCopyStructures(typeMap, errorOnMethodCall, keepBulkCopies));
     }
 };
 
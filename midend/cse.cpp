@@ -0,0 +1,265 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "cse.h"
+#include "midend/expr_uses.h"
+
+namespace P4 {
+
+namespace {
+// Only unary/binary/ternary operations are worth a temporary; leaves are
+// as cheap as the temporary itself, and nothing else (calls, lists,
+// constructor invocations) can be a candidate or an available entry.
+bool isOperation(const IR::Expression* expression) {
+    return expression->is<IR::Operation_Unary>() ||
+           expression->is<IR::Operation_Binary>() ||
+           expression->is<IR::Operation_Ternary>();
+}
+
+// The name of the variable (or parameter) an lvalue writes to, or nullptr
+// for an unexpected lvalue shape.
+cstring lvalueRoot(const IR::Expression* expression) {
+    while (true) {
+        if (auto member = expression->to<IR::Member>()) {
+            expression = member->expr;
+        } else if (auto index = expression->to<IR::ArrayIndex>()) {
+            expression = index->left;
+        } else if (auto slice = expression->to<IR::Slice>()) {
+            expression = slice->e0;
+        } else {
+            break;
+        }
+    }
+    if (auto path = expression->to<IR::PathExpression>())
+        return path->path->name;
+    return nullptr;
+}
+}  // namespace
+
+/// Counts, for DoGlobalCSE, how many times each candidate expression
+/// occurs in a control body, so the rewrite only introduces a temporary
+/// for expressions that actually repeat.
+class CseExpressionCounter : public Inspector {
+    DoGlobalCSE& self;
+ public:
+    explicit CseExpressionCounter(DoGlobalCSE* self) : self(*self)
+    { setName("CseExpressionCounter"); }
+    bool preorder(const IR::Expression* expression) override {
+        if (!self.isCandidate(expression))
+            return true;
+        auto hash = expression->structuralHash();
+        auto range = self.counts.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (self.same.sameExpression(it->second.first, expression)) {
+                ++it->second.second;
+                return true;
+            }
+        }
+        self.counts.emplace(hash, std::make_pair(expression, 1u));
+        return true;
+    }
+};
+
+bool DoGlobalCSE::isCandidate(const IR::Expression* expression) {
+    if (!isOperation(expression))
+        return false;
+    auto type = typeMap->getType(expression);
+    if (type == nullptr || !(type->is<IR::Type_Bits>() || type->is<IR::Type_Boolean>()))
+        return false;
+    // lvalues (and lvalues read as values, e.g. a slice of a variable)
+    // must stay as written
+    if (typeMap->isLeftValue(expression))
+        return false;
+    return !sideEffects(expression);
+}
+
+unsigned DoGlobalCSE::occurrences(const IR::Expression* expression) const {
+    auto range = counts.equal_range(expression->structuralHash());
+    for (auto it = range.first; it != range.second; ++it)
+        if (same.sameExpression(it->second.first, expression))
+            return it->second.second;
+    return 0;
+}
+
+const DoGlobalCSE::Available* DoGlobalCSE::lookup(const IR::Expression* expression) const {
+    if (!isOperation(expression))
+        return nullptr;
+    auto hash = expression->structuralHash();
+    for (auto& scope : scopes) {
+        auto range = scope.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+            if (same.sameExpression(it->second.expr, expression))
+                return &it->second;
+    }
+    return nullptr;
+}
+
+void DoGlobalCSE::invalidate(cstring name) {
+    for (auto& scope : scopes) {
+        for (auto it = scope.begin(); it != scope.end();) {
+            if (exprUses(it->second.expr, name))
+                it = scope.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+void DoGlobalCSE::invalidateAll() {
+    for (auto& scope : scopes)
+        scope.clear();
+}
+
+void DoGlobalCSE::openFrame() {
+    Frame frame;
+    frame.scope = scopes.empty() ? 0 : scopes.size() - 1;
+    frame.inBlock = getParent<IR::BlockStatement>() != nullptr;
+    frames.push_back(std::move(frame));
+}
+
+const IR::Node* DoGlobalCSE::closeFrame(const IR::Statement* statement) {
+    auto& frame = frames.back();
+    if (frame.before.empty()) {
+        frames.pop_back();
+        return statement;
+    }
+    auto result = new IR::IndexedVector<IR::StatOrDecl>();
+    for (auto assign : frame.before)
+        result->push_back(assign);
+    result->push_back(statement);
+    frames.pop_back();
+    return result;
+}
+
+const IR::Node* DoGlobalCSE::preorder(IR::P4Control* control) {
+    counts.clear();
+    newDecls.clear();
+    scopes.clear();
+    frames.clear();
+    blockLimit.clear();
+    CseExpressionCounter count(this);
+    getOriginal<IR::P4Control>()->body->apply(count);
+    bool repeats = false;
+    for (auto& c : counts)
+        if (c.second.second > 1) { repeats = true; break; }
+    if (!repeats)
+        prune();
+    return control;
+}
+
+const IR::Node* DoGlobalCSE::postorder(IR::P4Control* control) {
+    for (auto decl : newDecls)
+        control->controlLocals.push_back(decl);
+    return control;
+}
+
+const IR::Node* DoGlobalCSE::preorder(IR::BlockStatement* block) {
+    scopes.emplace_back();
+    blockLimit.push_back(frames.size());
+    return block;
+}
+
+const IR::Node* DoGlobalCSE::postorder(IR::BlockStatement* block) {
+    scopes.pop_back();
+    blockLimit.pop_back();
+    return block;
+}
+
+const IR::Node* DoGlobalCSE::preorder(IR::AssignmentStatement* statement) {
+    openFrame();
+    return statement;
+}
+
+const IR::Node* DoGlobalCSE::postorder(IR::AssignmentStatement* statement) {
+    auto orig = getOriginal<IR::AssignmentStatement>();
+    if (sideEffects(orig->right)) {
+        invalidateAll();
+    } else {
+        cstring root = lvalueRoot(orig->left);
+        if (root.isNullOrEmpty())
+            invalidateAll();
+        else
+            invalidate(root);
+    }
+    return closeFrame(statement);
+}
+
+const IR::Node* DoGlobalCSE::preorder(IR::MethodCallStatement* statement) {
+    openFrame();
+    return statement;
+}
+
+const IR::Node* DoGlobalCSE::postorder(IR::MethodCallStatement* statement) {
+    // out arguments and extern state: assume anything may have changed
+    if (sideEffects(getOriginal<IR::MethodCallStatement>()->methodCall))
+        invalidateAll();
+    return closeFrame(statement);
+}
+
+const IR::Node* DoGlobalCSE::preorder(IR::IfStatement* statement) {
+    openFrame();
+    return statement;
+}
+
+const IR::Node* DoGlobalCSE::postorder(IR::IfStatement* statement) {
+    // writes in the branches were already handled statement by statement;
+    // a side-effecting condition (e.g. a table application) was not
+    if (sideEffects(getOriginal<IR::IfStatement>()->condition))
+        invalidateAll();
+    return closeFrame(statement);
+}
+
+const IR::Node* DoGlobalCSE::preorder(IR::SwitchStatement* statement) {
+    openFrame();
+    return statement;
+}
+
+const IR::Node* DoGlobalCSE::postorder(IR::SwitchStatement* statement) {
+    // the switch expression applies a table
+    invalidateAll();
+    return closeFrame(statement);
+}
+
+const IR::Node* DoGlobalCSE::preorder(IR::Expression* expression) {
+    auto orig = getOriginal<IR::Expression>();
+    if (auto avail = lookup(orig)) {
+        LOG2("Reusing " << avail->temp << " for " << dbp(orig));
+        prune();
+        return new IR::PathExpression(IR::ID(expression->srcInfo, avail->temp));
+    }
+    if (!isCandidate(orig) || occurrences(orig) < 2)
+        return expression;
+    // A new temporary needs a frame, opened inside the current block, to
+    // carry its initializing assignment; the assignment lands right before
+    // that frame's statement, so nothing runs between it and the
+    // occurrence it feeds.  Expressions first computed in a bare (non-
+    // block) branch or in a declaration initializer are left alone.
+    if (frames.empty() || blockLimit.empty() ||
+        frames.size() <= blockLimit.back() || !frames.back().inBlock)
+        return expression;
+    auto& frame = frames.back();
+    cstring temp = refMap->newName("cse");
+    auto type = typeMap->getType(orig, true);
+    newDecls.push_back(new IR::Declaration_Variable(temp, type, nullptr));
+    frame.before.push_back(new IR::AssignmentStatement(
+        expression->srcInfo, new IR::PathExpression(temp), expression));
+    scopes[frame.scope].emplace(orig->structuralHash(), Available{orig, temp});
+    LOG2("Computing " << dbp(orig) << " into " << temp);
+    prune();
+    return new IR::PathExpression(IR::ID(expression->srcInfo, temp));
+}
+
+}  // namespace P4
@@ -0,0 +1,161 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_CSE_H_
+#define MIDEND_CSE_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "ir/ir.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeChecking/syntacticEquivalence.h"
+#include "midend/has_side_effects.h"
+
+namespace P4 {
+
+/**
+Common-subexpression elimination over control bodies.  A side-effect-free
+expression that is computed several times is computed once into a shared
+temporary:
+\code{.cpp}
+apply {
+    x = (h.a ^ h.b) >> 2;
+    ...
+    y = ((h.a ^ h.b) >> 2) + 1;
+}
+\endcode
+is converted to
+\code{.cpp}
+bit<32> cse;
+apply {
+    cse = (h.a ^ h.b) >> 2;
+    x = cse;
+    ...
+    y = cse + 1;
+}
+\endcode
+
+Only expressions of type bit<N> or bool are shared, so that the temporary
+is a declarable variable.  A computed expression stays available until
+something it reads may have changed: an assignment to a variable the
+expression uses invalidates it, and any statement that may have other side
+effects (method calls, table applications) invalidates everything.
+Expressions first computed inside a conditional branch do not stay
+available past the branch.  The pass is meant to run just before
+LocalCopyPropagation, which cleans up the temporaries that end up with a
+single use -- for instance when every later occurrence turns out to be
+invalidated.
+*/
+class DoGlobalCSE : public Transform {
+    ReferenceMap*   refMap;
+    TypeMap*        typeMap;
+    SameExpression  same;
+    hasSideEffects  sideEffects;
+
+    /// An expression already computed on every path to the current program
+    /// point: the occurrence whose value the temporary holds, and the
+    /// temporary's name.
+    struct Available {
+        const IR::Expression* expr;
+        cstring               temp;
+    };
+    /// Available expressions, bucketed by structural hash; buckets are
+    /// disambiguated with sameExpression.  One map per enclosing
+    /// BlockStatement, so entries die with their block.
+    typedef std::unordered_multimap<uint64_t, Available> Scope;
+    std::vector<Scope> scopes;
+
+    /// Assignments "tmp = e;" waiting to be spliced in front of the
+    /// statement this frame was opened for.  A frame is opened for every
+    /// expression-bearing statement.
+    struct Frame {
+        size_t scope;    ///< index of the scope current when the frame opened
+        bool   inBlock;  ///< the statement is a direct child of a BlockStatement
+        IR::IndexedVector<IR::StatOrDecl> before;
+    };
+    std::vector<Frame> frames;
+    /// frames.size() at entry to each open block.  A temporary may only be
+    /// introduced through a frame opened inside the current block -- never,
+    /// say, from a declaration initializer through the frame of an
+    /// enclosing if, which would move the computation past statements that
+    /// run before the initializer.
+    std::vector<size_t> blockLimit;
+
+    /// Occurrence counts of the candidate expressions in the control being
+    /// rewritten, filled in by CseExpressionCounter.
+    std::unordered_multimap<uint64_t, std::pair<const IR::Expression*, unsigned>> counts;
+    /// Declarations for the introduced temporaries; appended to the
+    /// control's locals.
+    IR::IndexedVector<IR::Declaration> newDecls;
+
+    friend class CseExpressionCounter;
+
+    bool isCandidate(const IR::Expression* expression);
+    unsigned occurrences(const IR::Expression* expression) const;
+    const Available* lookup(const IR::Expression* expression) const;
+    void invalidate(cstring name);
+    void invalidateAll();
+    void openFrame();
+    const IR::Node* closeFrame(const IR::Statement* statement);
+
+    const IR::Node* preorder(IR::P4Parser* parser) override
+    { prune(); return parser; }
+    const IR::Node* preorder(IR::P4Action* action) override
+    { prune(); return action; }
+    const IR::Node* preorder(IR::P4Table* table) override
+    { prune(); return table; }
+    const IR::Node* preorder(IR::Function* function) override
+    { prune(); return function; }
+
+    const IR::Node* preorder(IR::P4Control* control) override;
+    const IR::Node* postorder(IR::P4Control* control) override;
+    const IR::Node* preorder(IR::BlockStatement* block) override;
+    const IR::Node* postorder(IR::BlockStatement* block) override;
+    const IR::Node* preorder(IR::AssignmentStatement* statement) override;
+    const IR::Node* postorder(IR::AssignmentStatement* statement) override;
+    const IR::Node* preorder(IR::MethodCallStatement* statement) override;
+    const IR::Node* postorder(IR::MethodCallStatement* statement) override;
+    const IR::Node* preorder(IR::IfStatement* statement) override;
+    const IR::Node* postorder(IR::IfStatement* statement) override;
+    const IR::Node* preorder(IR::SwitchStatement* statement) override;
+    const IR::Node* postorder(IR::SwitchStatement* statement) override;
+    const IR::Node* preorder(IR::Expression* expression) override;
+
+ public:
+    DoGlobalCSE(ReferenceMap* refMap, TypeMap* typeMap) :
+            refMap(refMap), typeMap(typeMap), same(refMap, typeMap),
+            sideEffects(refMap, typeMap) {
+        CHECK_NULL(refMap); CHECK_NULL(typeMap); setName("DoGlobalCSE");
+    }
+};
+
+class GlobalCSE : public PassManager {
+ public:
+    GlobalCSE(ReferenceMap* refMap, TypeMap* typeMap,
+              TypeChecking* typeChecking = nullptr) {
+        if (!typeChecking)
+            typeChecking = new TypeChecking(refMap, typeMap);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoGlobalCSE(refMap, typeMap));
+        setName("GlobalCSE");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_CSE_H_ */
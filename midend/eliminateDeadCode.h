@@ -0,0 +1,59 @@
+/*
+Copyright 2020 VMware, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _MIDEND_ELIMINATEDEADCODE_H_
+#define _MIDEND_ELIMINATEDEADCODE_H_
+
+#include "ir/ir.h"
+#include "frontends/common/resolveReferences/resolveReferences.h"
+#include "frontends/p4/simplifyParsers.h"
+#include "frontends/p4/unusedDeclarations.h"
+
+namespace P4 {
+
+/**
+ * Removes dead dataplane code before conversion to a backend
+ * representation: tables that are never applied, actions only reachable
+ * from such tables, parser states left unreachable by earlier select
+ * simplifications, and controls or parsers that are no longer
+ * instantiated.
+ *
+ * The frontend performs the same cleanup, but midend rewrites -- constant
+ * folding, select-case simplification, predication -- strand further
+ * declarations that would otherwise flow into the generated artifacts,
+ * inflating their size and the target's table memory.
+ *
+ * Reachability over the reference graph is computed by
+ * RemoveAllUnusedDeclarations, whose usage computation cascades through
+ * declarations that die together (a table and the actions only it
+ * lists).  SimplifyParsers then prunes states through the parser
+ * transition graph, which also catches cycles of dead states that keep
+ * each other referenced.  No warnings are emitted: by this point unused
+ * declarations are usually the compiler's own doing, not the program's.
+ */
+class EliminateDeadCode : public PassManager {
+ public:
+    explicit EliminateDeadCode(ReferenceMap* refMap) {
+        CHECK_NULL(refMap);
+        passes.push_back(new RemoveAllUnusedDeclarations(refMap));
+        passes.push_back(new SimplifyParsers(refMap));
+        setName("EliminateDeadCode");
+    }
+};
+
+}  // namespace P4
+
+#endif /* _MIDEND_ELIMINATEDEADCODE_H_ */
@@ -48,13 +48,13 @@ const IR::Node* DoEliminateSwitch::postorder(IR::SwitchStatement* statement) {
 
     auto tableKeyEl = new IR::KeyElement(
         src, new IR::PathExpression(key),
-        new IR::PathExpression(P4CoreLibrary::instance.exactMatch.Id()));
+        new IR::PathExpression(P4CoreLibrary::instance().exactMatch.Id()));
     IR::IndexedVector<IR::ActionListElement> actionsList;
     IR::IndexedVector<IR::Property> properties;
     IR::Vector<IR::SwitchCase> cases;
     IR::Vector<IR::Entry> entries;
     properties.push_back(new IR::Property(src, "key", new IR::Key({tableKeyEl}), false));
-    IR::ID defaultAction = P4CoreLibrary::instance.noAction.Id();
+    IR::ID defaultAction = P4CoreLibrary::instance().noAction.Id();
 
     // Create actions
     IR::Vector<IR::Expression> pendingLabels;  // switch labels with no statement
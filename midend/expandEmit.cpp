@@ -27,6 +27,12 @@ bool DoExpandEmit::expandArg(
         resultTypes->push_back(type);
         return false;
     } else if (auto st = type->to<IR::Type_Stack>()) {
+        if (policy != nullptr && !policy->expandStack(st)) {
+            // the target can emit the whole stack natively
+            result->push_back(arg);
+            resultTypes->push_back(type);
+            return false;
+        }
         int size = st->getSize();
         for (int i = 0; i < size; i++) {
             auto index = new IR::Constant(i);
@@ -61,8 +67,8 @@ bool DoExpandEmit::expandArg(
 const IR::Node* DoExpandEmit::postorder(IR::MethodCallStatement* statement) {
     auto mi = MethodInstance::resolve(statement->methodCall, refMap, typeMap);
     if (auto em = mi->to<P4::ExternMethod>()) {
-        if (em->originalExternType->name.name == P4::P4CoreLibrary::instance.packetOut.name &&
-            em->method->name.name == P4::P4CoreLibrary::instance.packetOut.emit.name) {
+        if (em->originalExternType->name.name == P4::P4CoreLibrary::instance().packetOut.name &&
+            em->method->name.name == P4::P4CoreLibrary::instance().packetOut.emit.name) {
             if (em->expr->arguments->size() != 1) {
                 ::error(ErrorType::ERR_UNEXPECTED, "%1%: expected exactly 1 argument", statement);
                 return statement;
@@ -22,6 +22,21 @@ limitations under the License.
 
 namespace P4 {
 
+/**
+Policy which selects the emit arguments that are expanded.
+Targets that can emit a whole header stack natively can keep such
+emits intact instead of paying for one emit per stack element.
+*/
+class ExpandEmitPolicy {
+ public:
+    virtual ~ExpandEmitPolicy() {}
+    /**
+       If the policy returns true an emit of the given stack is expanded
+       into per-element emits, otherwise the stack is emitted whole.
+    */
+    virtual bool expandStack(const IR::Type_Stack*) const { return true; }
+};
+
 /**
  * Convert an emit of a struct recursively into a sequence of emits of
  * all fields of the struct.  Convert an emit of a header stack into a
@@ -44,9 +59,11 @@ namespace P4 {
 class DoExpandEmit : public Transform {
     ReferenceMap* refMap;
     TypeMap* typeMap;
+    const ExpandEmitPolicy* policy;  // can be nullptr: expand everything
  public:
-    DoExpandEmit(ReferenceMap* refMap, TypeMap* typeMap):
-            refMap(refMap), typeMap(typeMap)
+    DoExpandEmit(ReferenceMap* refMap, TypeMap* typeMap,
+                 const ExpandEmitPolicy* policy = nullptr):
+            refMap(refMap), typeMap(typeMap), policy(policy)
     { CHECK_NULL(refMap); CHECK_NULL(typeMap); setName("DoExpandEmit"); }
     // return true if the expansion produced something "new"
     bool expandArg(const IR::Type* type, const IR::Argument* argument,
@@ -58,12 +75,13 @@ class DoExpandEmit : public Transform {
 class ExpandEmit : public PassManager {
  public:
     ExpandEmit(ReferenceMap* refMap, TypeMap* typeMap,
+            const ExpandEmitPolicy* policy = nullptr,
             TypeChecking* typeChecking = nullptr) {
         setName("ExpandEmit");
         if (!typeChecking)
             typeChecking = new TypeChecking(refMap, typeMap);
         passes.push_back(typeChecking);
-        passes.push_back(new DoExpandEmit(refMap, typeMap));
+        passes.push_back(new DoExpandEmit(refMap, typeMap, policy));
     }
 };
 
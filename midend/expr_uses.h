@@ -18,9 +18,36 @@ limitations under the License.
 #define MIDEND_EXPR_USES_H_
 
 #include "ir/ir.h"
+#include "ir/visitor.h"
 
 /* Should this be a method on IR::Expression? */
 
+/// Computes, once per node, the set of path and primitive names mentioned
+/// anywhere inside an expression.  Summaries are cached by node id: nodes are
+/// immutable and ids are never reused, so an entry stays valid as long as the
+/// node does.  exprUses consults this before walking -- DoLocalCopyPropagation
+/// asks "does this value use that variable" for every available variable at
+/// every write, and almost all of those answers are "no".
+class exprNameSummary : public Inspector {
+    std::set<cstring> *names;
+    bool preorder(const IR::Path *p) override { names->insert(p->name.name); return false; }
+    bool preorder(const IR::Primitive *p) override { names->insert(p->name); return true; }
+    explicit exprNameSummary(std::set<cstring> *out) : names(out) {}
+    static NodeIdInfoMap<const std::set<cstring> *> &cache() {
+        static NodeIdInfoMap<const std::set<cstring> *> c;
+        return c; }
+
+ public:
+    static const std::set<cstring> &get(const IR::Expression *e) {
+        auto &slot = cache()[e->id];
+        if (slot == nullptr) {
+            auto *out = new std::set<cstring>;
+            exprNameSummary summarize(out);
+            e->apply(summarize);
+            slot = out; }
+        return *slot; }
+};
+
 /// Functor to check if an expression uses an lvalue.  The lvalue is specified as a
 /// a cstring, which can be the name of a variable with optional field names and constant
 /// array indexes for fields of headers or structs or unions or elements of stacks.
@@ -66,7 +93,15 @@ class exprUses : public Inspector {
 
  public:
     exprUses(const IR::Expression *e, cstring n) : look_for(n) {
-        visitDagOnce = false; e->apply(*this); }
+        visitDagOnce = false;
+        // A path can only match the leading name segment of look_for, and a
+        // primitive only all of it, so if the cached name summary has
+        // neither the answer is no without walking the expression.
+        auto &names = exprNameSummary::get(e);
+        size_t rootlen = strcspn(n.c_str(), ".[");
+        if (!names.count(n.substr(0, rootlen)) && !names.count(n))
+            return;
+        e->apply(*this); }
     explicit operator bool () const { return result; }
 };
 
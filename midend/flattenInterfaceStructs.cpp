@@ -139,9 +139,11 @@ const IR::Node* ReplaceStructs::postorder(IR::Member* expression) {
     auto newFieldName = ::get(repl->fieldNameRemap, prefix);
     const IR::Expression* result;
     if (newFieldName.isNullOrEmpty()) {
-        auto type = replacementMap->typeMap->getType(getOriginal(), true);
-        // This could be, for example, a method like setValid.
-        if (!type->is<IR::Type_Struct>())
+        // Consult the replacement itself instead of the type map: when
+        // running right after ReplaceHeaders the expression may not be
+        // in the type map.  Prefixes that do not name a struct-valued
+        // field could be, for example, a method like setValid.
+        if (repl->structFieldMap.count(prefix) == 0)
             return expression;
         if (getParent<IR::Member>() != nullptr)
             // We only want to process the outermost Member
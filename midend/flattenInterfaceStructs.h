@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "ir/ir.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
+#include "midend/flattenHeaders.h"
 
 namespace P4 {
 
@@ -186,6 +187,33 @@ class FlattenInterfaceStructs final : public PassManager {
     }
 };
 
+/**
+Runs FlattenHeaders and FlattenInterfaceStructs as one group with a
+single type checking.  Both Find passes inspect the program before any
+replacement, and neither Replace pass consults the type map on nodes
+produced by the other: header replacement rewrites member chains below
+a header, struct replacement rewrites chains between a parameter and
+the first non-struct field, and the two meet only at header-typed
+fields, which both sides treat as opaque leaves.  This saves a full
+re-typecheck of the program compared to running the two pass managers
+in sequence.
+*/
+class FlattenHeadersAndInterfaceStructs final : public PassManager {
+ public:
+    FlattenHeadersAndInterfaceStructs(ReferenceMap* refMap, TypeMap* typeMap,
+                                      AnnotationSelectionPolicy* policy = nullptr) {
+        auto findHeadersToReplace = new FindHeaderTypesToReplace(typeMap, policy);
+        auto sm = new NestedStructMap(refMap, typeMap);
+        passes.push_back(new TypeChecking(refMap, typeMap));
+        passes.push_back(findHeadersToReplace);
+        passes.push_back(new FindTypesToReplace(sm));
+        passes.push_back(new ReplaceHeaders(typeMap, findHeadersToReplace));
+        passes.push_back(new ReplaceStructs(sm));
+        passes.push_back(new ClearTypeMap(typeMap));
+        setName("FlattenHeadersAndInterfaceStructs");
+    }
+};
+
 
 }  // namespace P4
 
@@ -18,6 +18,7 @@ limitations under the License.
 #define MIDEND_HAS_SIDE_EFFECTS_H_
 
 #include "ir/ir.h"
+#include "ir/visitor.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 
@@ -27,12 +28,25 @@ class hasSideEffects : public Inspector {
     P4::ReferenceMap    *refMap = nullptr;
     P4::TypeMap         *typeMap = nullptr;
 
+    /// Per-subtree summaries from earlier queries, keyed by node id: nodes
+    /// are immutable and ids are never reused, so an answer stays valid as
+    /// long as the node does.  Kept per instance, as the answer depends on
+    /// whether this functor was given a refMap/typeMap to resolve method
+    /// calls with; clients that issue many queries (DoLocalCopyPropagation)
+    /// share one instance so the summaries accumulate.
+    enum : char { UNKNOWN = 0, NONE, SOME };
+    NodeIdInfoMap<char> cache;
+
     bool result = false;
     bool preorder(const IR::AssignmentStatement *) override { result = true; return false; }
     bool preorder(const IR::MethodCallExpression *mc) override {
         if (result) {
             return false;
         }
+        if (auto *c = cache.find(mc->id)) {
+            if (*c == SOME) { result = true; return false; }
+            if (*c == NONE) return false;
+        }
         /* assume has side effects if we can't look it up */
         if (refMap && typeMap) {
             auto *mi = P4::MethodInstance::resolve(mc, refMap, typeMap, true);
@@ -47,11 +61,26 @@ class hasSideEffects : public Inspector {
                 }
             }
         result = true;
+        cache[mc->id] = SOME;
         return false;
     }
 
-    bool preorder(const IR::Primitive *) override { result = true; return false; }
-    bool preorder(const IR::Expression *) override { return !result; }
+    bool preorder(const IR::Primitive *p) override {
+        result = true;
+        cache[p->id] = SOME;
+        return false; }
+    bool preorder(const IR::Expression *e) override {
+        if (result) return false;
+        if (auto *c = cache.find(e->id)) {
+            if (*c == SOME) { result = true; return false; }
+            if (*c == NONE) return false;
+        }
+        return true; }
+    // Postorder runs only when preorder descended, so `result` still false
+    // here means this whole subtree is side-effect free, while true means
+    // the subtree contains the effecting node (siblings visited after it
+    // are skipped, not summarized).
+    void postorder(const IR::Expression *e) override { cache[e->id] = result ? SOME : NONE; }
 
  public:
     explicit hasSideEffects(const IR::Expression *e) { e->apply(*this); }
@@ -29,7 +29,7 @@ SymbolicValue* SymbolicValueFactory::create(const IR::Type* type, bool uninitial
     }
     if (type->is<IR::Type_Extern>()) {
         auto te = type->to<IR::Type_Extern>();
-        if (te->name.name == P4CoreLibrary::instance.packetIn.name) {
+        if (te->name.name == P4CoreLibrary::instance().packetIn.name) {
             return new SymbolicPacketIn(te);
         }
         return new SymbolicExtern(te);
@@ -827,7 +827,10 @@ void ExpressionEvaluator::postorder(const IR::PathExpression* expression) {
     if (type->is<IR::Type_Error>())
         result = new SymbolicEnum(type, decl->getName());
     else
-        result = valueMap->get(decl);
+        // Evaluation can mutate any value it reaches from here -- through
+        // assignments, setValid, extract, or out arguments -- so take a
+        // private copy if the binding is still shared with another map.
+        result = valueMap->getWritable(decl);
     set(expression, result);
 }
 
@@ -887,9 +890,9 @@ void ExpressionEvaluator::postorder(const IR::MethodCallExpression* expression)
     if (mi->is<ExternMethod>()) {
         // There are some extern methods that we know something about
         auto em = mi->to<ExternMethod>();
-        if (em->originalExternType->name.name == P4CoreLibrary::instance.packetIn.name) {
+        if (em->originalExternType->name.name == P4CoreLibrary::instance().packetIn.name) {
             // packet methods
-            if (em->method->name.name == P4CoreLibrary::instance.packetIn.extract.name) {
+            if (em->method->name.name == P4CoreLibrary::instance().packetIn.extract.name) {
                 // We know that after an extract terminates the header argument
                 // is always valid.
                 auto arg0 = expression->arguments->at(0);
@@ -928,7 +931,7 @@ void ExpressionEvaluator::postorder(const IR::MethodCallExpression* expression)
                 }
 
                 auto decl = em->object;
-                auto obj = valueMap->get(decl);
+                auto obj = valueMap->getWritable(decl);  // advanced below
                 CHECK_NULL(obj);
                 if (obj->is<SymbolicError>()) {
                     set(expression, obj);
@@ -977,10 +980,99 @@ void ExpressionEvaluator::postorder(const IR::MethodCallExpression* expression)
     }
 }
 
+namespace {
+// Collects the maximal read subexpressions of an expression -- the values
+// flowing into its operators -- and rejects expressions containing method
+// calls, whose evaluation may have side effects.
+class ReadCollector : public Inspector {
+    int nested = 0;  // depth of enclosing read expressions
+    void record(const IR::Expression* expression) {
+        if (nested++ == 0)
+            reads.push_back(expression);
+    }
+ public:
+    std::vector<const IR::Expression*> reads;
+    bool memoizable = true;
+    bool preorder(const IR::MethodCallExpression*) override
+    { memoizable = false; return false; }
+    bool preorder(const IR::Member* expression) override
+    { record(expression); return true; }
+    void postorder(const IR::Member*) override { --nested; }
+    bool preorder(const IR::ArrayIndex* expression) override
+    { record(expression); return true; }
+    void postorder(const IR::ArrayIndex*) override { --nested; }
+    bool preorder(const IR::PathExpression* expression) override
+    { record(expression); return true; }
+    void postorder(const IR::PathExpression*) override { --nested; }
+};
+}  // namespace
+
+SymbolicValue* ExpressionMemoizer::lookup(const IR::Expression* expression,
+                                          const std::vector<SymbolicValue*>& reads) const {
+    auto it = cache.find(expression);
+    if (it == cache.end())
+        return nullptr;
+    for (auto& entry : it->second) {
+        if (entry.reads.size() != reads.size())
+            continue;
+        bool match = true;
+        for (size_t i = 0; i < reads.size(); i++) {
+            if (!reads.at(i)->equals(entry.reads.at(i))) {
+                match = false;
+                break;
+            }
+        }
+        if (match)
+            return entry.result->clone();
+    }
+    return nullptr;
+}
+
+void ExpressionMemoizer::insert(const IR::Expression* expression,
+                                const std::vector<SymbolicValue*>& reads,
+                                const SymbolicValue* result) {
+    Entry entry;
+    for (auto v : reads)
+        entry.reads.push_back(v->clone());
+    entry.result = result->clone();
+    cache[expression].push_back(entry);
+}
+
+bool ExpressionEvaluator::isMemoizable(const IR::Expression* expression,
+                                       std::vector<SymbolicValue*>* reads) {
+    // Bare reads are cheap to re-evaluate and their results may alias the
+    // store, so only proper computations are memoized.
+    if (!expression->is<IR::Operation_Unary>() && !expression->is<IR::Operation_Binary>())
+        return false;
+    ReadCollector collector;
+    (void)expression->apply(collector);
+    if (!collector.memoizable)
+        return false;
+    for (auto leaf : collector.reads) {
+        (void)leaf->apply(*this);
+        reads->push_back(get(leaf));
+    }
+    return true;
+}
+
 SymbolicValue* ExpressionEvaluator::evaluate(const IR::Expression* expression, bool leftValue) {
     evaluatingLeftValue = leftValue;
+    // Parser unrolling evaluates the same statements once per symbolic
+    // path, and most right-hand sides read values that are invariant
+    // across paths; reuse the result of a previous evaluation when every
+    // value read by the expression is equal to what it read back then.
+    std::vector<SymbolicValue*> reads;
+    bool memoize = memoizer != nullptr && !leftValue && isMemoizable(expression, &reads);
+    if (memoize) {
+        if (auto cached = memoizer->lookup(expression, reads)) {
+            LOG3("Memoized evaluation of " << expression);
+            return set(expression, cached);
+        }
+    }
     (void)expression->apply(*this);
     auto result = get(expression);
+    if (memoize)
+        memoizer->insert(expression, reads, result);
     return result;
 }
 
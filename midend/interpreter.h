@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef _MIDEND_INTERPRETER_H_
 #define _MIDEND_INTERPRETER_H_
 
+#include <set>
+#include <vector>
+
 #include "ir/ir.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/typeMap.h"
@@ -76,23 +79,50 @@ class SymbolicValueFactory {
 class ValueMap final : public IHasDbPrint {
  public:
     std::map<const IR::IDeclaration*, SymbolicValue*> map;
-    ValueMap* clone() const {
+    // Declarations whose value may also be reachable from a clone of this
+    // map; such a value can be read freely, but must be copied before it
+    // is written -- see getWritable.  The flag is conservative: it stays
+    // set even after all other maps have replaced their copy.
+    std::set<const IR::IDeclaration*> shared;
+    // The clone shares the values of this map; both maps copy a value
+    // lazily when they first need to write it.  The symbolic interpreter
+    // clones the whole map at every parser-state branch, but each state
+    // only writes a few bindings, so most values are never copied.
+    ValueMap* clone() {
         auto result = new ValueMap();
-        for (auto v : map)
-            result->map.emplace(v.first, v.second->clone());
+        result->map = map;
+        for (auto v : map) {
+            shared.emplace(v.first);
+            result->shared.emplace(v.first);
+        }
         return result;
     }
     ValueMap* filter(std::function<bool(const IR::IDeclaration*, const SymbolicValue*)> filter) {
         auto result = new ValueMap();
         for (auto v : map)
-            if (filter(v.first, v.second))
+            if (filter(v.first, v.second)) {
                 result->map.emplace(v.first, v.second);
+                shared.emplace(v.first);
+                result->shared.emplace(v.first);
+            }
         return result;
     }
     void set(const IR::IDeclaration* left, SymbolicValue* right)
-    { CHECK_NULL(left); CHECK_NULL(right); map[left] = right; }
+    { CHECK_NULL(left); CHECK_NULL(right); map[left] = right; shared.erase(left); }
     SymbolicValue* get(const IR::IDeclaration* left) const
     { CHECK_NULL(left); return ::get(map, left); }
+    // Get a value that is safe to mutate: if the binding is still shared
+    // with another map it is replaced by a deep copy first.
+    SymbolicValue* getWritable(const IR::IDeclaration* left) {
+        CHECK_NULL(left);
+        auto value = ::get(map, left);
+        if (value != nullptr && shared.count(left)) {
+            value = value->clone();
+            map[left] = value;
+            shared.erase(left);
+        }
+        return value;
+    }
 
     void dbprint(std::ostream& out) const {
         bool first = true;
@@ -109,7 +139,7 @@ class ValueMap final : public IHasDbPrint {
         for (auto d : map) {
             auto v = other->get(d.first);
             CHECK_NULL(v);
-            change = change || d.second->merge(v);
+            change = change || getWritable(d.first)->merge(v);
         }
         return change;
     }
@@ -125,11 +155,32 @@ class ValueMap final : public IHasDbPrint {
     }
 };
 
+// Memoizes the evaluation of side-effect-free expressions across the many
+// symbolic stores explored during parser unrolling.  An entry records the
+// values the expression read when it was first evaluated; a cached result is
+// reused only when every read yields a value equal to the recorded one, so
+// the cache is exact, not a heuristic.  Values are cloned on both sides of
+// the cache boundary and thus never alias a symbolic store.
+class ExpressionMemoizer {
+    struct Entry {
+        std::vector<const SymbolicValue*> reads;
+        const SymbolicValue* result;
+    };
+    std::map<const IR::Expression*, std::vector<Entry>> cache;
+ public:
+    // Return a private copy of a previous result, or nullptr.
+    SymbolicValue* lookup(const IR::Expression* expression,
+                          const std::vector<SymbolicValue*>& reads) const;
+    void insert(const IR::Expression* expression,
+                const std::vector<SymbolicValue*>& reads, const SymbolicValue* result);
+};
+
 class ExpressionEvaluator : public Inspector {
     ReferenceMap*       refMap;
     TypeMap*            typeMap;  // updated if constant folding happens
     ValueMap*           valueMap;
     const SymbolicValueFactory* factory;
+    ExpressionMemoizer* memoizer;  // may be nullptr
     bool evaluatingLeftValue = false;
 
     std::map<const IR::Expression*, SymbolicValue*> value;
@@ -153,9 +204,14 @@ class ExpressionEvaluator : public Inspector {
     void postorder(const IR::ListExpression* expression) override;
     void postorder(const IR::MethodCallExpression* expression) override;
 
+    // True if the expression may be memoized: a computation without method
+    // calls.  Evaluates the values it reads from the store into 'reads'.
+    bool isMemoizable(const IR::Expression* expression, std::vector<SymbolicValue*>* reads);
+
  public:
-    ExpressionEvaluator(ReferenceMap* refMap, TypeMap* typeMap, ValueMap* valueMap) :
-            refMap(refMap), typeMap(typeMap), valueMap(valueMap) {
+    ExpressionEvaluator(ReferenceMap* refMap, TypeMap* typeMap, ValueMap* valueMap,
+                        ExpressionMemoizer* memoizer = nullptr) :
+            refMap(refMap), typeMap(typeMap), valueMap(valueMap), memoizer(memoizer) {
         CHECK_NULL(refMap); CHECK_NULL(typeMap); CHECK_NULL(valueMap);
         factory = new SymbolicValueFactory(typeMap);
     }
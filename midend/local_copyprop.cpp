@@ -160,15 +160,35 @@ class DoLocalCopyPropagation::RewriteTableKeys : public Transform {
 void DoLocalCopyPropagation::flow_merge(Visitor &a_) {
     auto &a = dynamic_cast<DoLocalCopyPropagation &>(a_);
     BUG_CHECK(working == a.working, "inconsitent DoLocalCopyPropagation state on merge");
+    need_key_rewrite |= a.need_key_rewrite;
+    // the branch being merged never wrote a variable, so both sides still
+    // share one representation and there is nothing to reconcile
+    if (available.shares_with(a.available))
+        return;
+    const cow_map<cstring, VarInfo> &ours = available;
+    const cow_map<cstring, VarInfo> &theirs = a.available;
+    // check whether the merge changes anything before writing to (and
+    // thereby unsharing) our own state
+    bool change = false;
+    for (const auto &var : ours) {
+        if (auto merge = ::getref(theirs, var.first)) {
+            if ((merge->val != var.second.val && var.second.val != nullptr) ||
+                (merge->live && !var.second.live)) {
+                change = true;
+                break; }
+        } else if (var.second.val != nullptr) {
+            change = true;
+            break; } }
+    if (!change)
+        return;
     for (auto &var : available) {
-        if (auto merge = ::getref(a.available, var.first)) {
+        if (auto merge = ::getref(theirs, var.first)) {
             if (merge->val != var.second.val)
                 var.second.val = nullptr;
             if (merge->live)
                 var.second.live = true;
         } else {
             var.second.val = nullptr; } }
-    need_key_rewrite |= a.need_key_rewrite;
 }
 
 /// test to see if names denote overlapping locations
@@ -208,6 +228,30 @@ void DoLocalCopyPropagation::dropValuesUsing(cstring name) {
             var.second.val = nullptr; } }
 }
 
+Visitor::profile_t DoLocalCopyPropagation::init_apply(const IR::Node *node) {
+    /* When the pass is reapplied to its own output (as the PassRepeated in
+     * LocalCopyPropagation does), only the blocks rewritten by the previous
+     * application can be simplified further, so the preorder functions below
+     * prune everything else.  The analysis maps persist across applications;
+     * their contents for a skipped block only ever grow, which is safely
+     * conservative. */
+    incremental = (node == lastResult);
+    if (incremental) {
+        revisit.swap(changed);
+    } else {
+        revisit.clear();
+        tables.clear();
+        actions.clear();
+        methods.clear();
+        states.clear(); }
+    changed.clear();
+    return Transform::init_apply(node);
+}
+
+void DoLocalCopyPropagation::end_apply(const IR::Node *node) {
+    lastResult = node;
+}
+
 void DoLocalCopyPropagation::visit_local_decl(const IR::Declaration_Variable *var) {
     LOG4("Visiting " << var);
     if (available.count(var->name))
@@ -466,6 +510,10 @@ IR::MethodCallExpression *DoLocalCopyPropagation::postorder(IR::MethodCallExpres
 IR::P4Action *DoLocalCopyPropagation::preorder(IR::P4Action *act) {
     visitOnce();
     BUG_CHECK(!working && !inferForFunc && available.empty(), "corrupt internal data struct");
+    if (incremental && !revisit.count(act->name)) {
+        LOG2("DoLocalCopyPropagation skipping unchanged action " << act->name);
+        prune();
+        return act; }
     working = true;
     inferForFunc = &actions[act->name];
     LOG2("DoLocalCopyPropagation working on action " << act->name);
@@ -484,6 +532,8 @@ IR::P4Action *DoLocalCopyPropagation::postorder(IR::P4Action *act) {
     LOG4("reads=" << inferForFunc->reads << " writes=" << inferForFunc->writes);
     LOG4(act);
     inferForFunc = nullptr;
+    if (!(*act == *getOriginal<IR::P4Action>()))
+        changed.insert(act->name);
     return act;
 }
 
@@ -496,6 +546,10 @@ IR::Function *DoLocalCopyPropagation::preorder(IR::Function *fn) {
         name = decl->name + '.' + fn->name;
     else
         name = fn->name;
+    if (incremental && !revisit.count(name)) {
+        LOG2("DoLocalCopyPropagation skipping unchanged function " << name);
+        prune();
+        return fn; }
     working = true;
     inferForFunc = &methods[name];
     LOG2("DoLocalCopyPropagation working on function " << name);
@@ -520,12 +574,26 @@ IR::Function *DoLocalCopyPropagation::postorder(IR::Function *fn) {
     LOG4("reads=" << inferForFunc->reads << " writes=" << inferForFunc->writes);
     LOG4(fn);
     inferForFunc = nullptr;
+    if (!(*fn == *getOriginal<IR::Function>())) {
+        changed.insert(name);
+        // also mark the enclosing instance, so the parsers/controls holding
+        // it know they must be revisited
+        if (auto decl = findContext<IR::Declaration_Instance>())
+            changed.insert(decl->name); }
     return fn;
 }
 
 IR::P4Control *DoLocalCopyPropagation::preorder(IR::P4Control *ctrl) {
     visitOnce();
     BUG_CHECK(!working && available.empty(), "corrupt internal data struct");
+    if (incremental && !revisit.count(ctrl->name)) {
+        bool skip = true;
+        for (auto local : ctrl->controlLocals)
+            if (revisit.count(local->name)) { skip = false; break; }
+        if (skip) {
+            LOG2("DoLocalCopyPropagation skipping unchanged control " << ctrl->name);
+            prune();
+            return ctrl; } }
     visit(ctrl->type, "type");
     visit(ctrl->constructorParams, "constructorParams");
     visit(ctrl->controlLocals, "controlLocals");
@@ -560,6 +628,8 @@ IR::P4Control *DoLocalCopyPropagation::preorder(IR::P4Control *ctrl) {
     available.clear();
     LOG3("DoLocalCopyPropagation finished control " << ctrl->name);
     LOG4(ctrl);
+    if (!(*ctrl == *getOriginal<IR::P4Control>()))
+        changed.insert(ctrl->name);
     prune();
     return ctrl;
 }
@@ -622,6 +692,22 @@ IR::P4Table *DoLocalCopyPropagation::postorder(IR::P4Table *tbl) {
     return tbl;
 }
 
+const IR::P4Parser *DoLocalCopyPropagation::preorder(IR::P4Parser *parser) {
+    visitOnce();
+    BUG_CHECK(!working && available.empty(), "corrupt internal data struct");
+    if (incremental && !revisit.count(parser->name)) {
+        bool skip = true;
+        for (auto *state : parser->states)
+            if (revisit.count(state->name)) { skip = false; break; }
+        if (skip)
+            for (auto *local : parser->parserLocals)
+                if (revisit.count(local->name)) { skip = false; break; }
+        if (skip) {
+            LOG2("DoLocalCopyPropagation skipping unchanged parser " << parser->name);
+            prune(); } }
+    return parser;
+}
+
 const IR::P4Parser *DoLocalCopyPropagation::postorder(IR::P4Parser *parser) {
     BUG_CHECK(!working && available.empty(), "corrupt internal data struct");
     working = true;
@@ -632,12 +718,18 @@ const IR::P4Parser *DoLocalCopyPropagation::postorder(IR::P4Parser *parser) {
     auto *rv = parser->apply(ElimDead(*this));
     working = false;
     available.clear();
+    if (!(*rv == *getOriginal<IR::P4Parser>()))
+        changed.insert(rv->name);
     return rv;
 }
 
 IR::ParserState *DoLocalCopyPropagation::preorder(IR::ParserState *state) {
     visitOnce();
     BUG_CHECK(!working && available.empty(), "corrupt internal data struct");
+    if (incremental && !revisit.count(state->name)) {
+        LOG2("DoLocalCopyPropagation skipping unchanged parser state " << state->name);
+        prune();
+        return state; }
     working = true;
     LOG2("DoLocalCopyPropagation working on parser state " << state->name);
     LOG4(state);
@@ -655,6 +747,8 @@ IR::ParserState *DoLocalCopyPropagation::postorder(IR::ParserState *state) {
     available.clear();
     LOG3("DoLocalCopyPropagation finished parser state " << state->name);
     LOG4(state);
+    if (!(*state == *getOriginal<IR::ParserState>()))
+        changed.insert(state->name);
     return state;
 }
 
@@ -20,6 +20,7 @@ limitations under the License.
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "has_side_effects.h"
+#include "lib/cow_map.h"
 
 namespace P4 {
 
@@ -48,6 +49,13 @@ policy should only evaluate the potential cost of propagating, as propagated exp
 may be evaluated mulitple times.  The default policy just returns true -- always propagate
 if legal to do so.
 
+The pass records which actions/functions/states it rewrites, and when it is reapplied
+to its own output (as the PassRepeated in LocalCopyPropagation does) it revisits only
+those and the enclosing controls/parsers, skipping everything else: a block it did not
+change can only be simplified further as a consequence of its own previous rewrites.
+Iterating to a fixed point therefore costs one full traversal plus local reprocessing
+of whatever each round changed.
+
  */
 class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteContext {
     ReferenceMap                *refMap;
@@ -67,11 +75,22 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
         std::set<cstring>       reads, writes;
         int                     apply_count = 0;
     };
-    std::map<cstring, VarInfo>          available;
+    // Copy-on-write: flow_clone copies this visitor at every branch point,
+    // and most branches never write a variable, so the clones share one
+    // representation until somebody does.
+    cow_map<cstring, VarInfo>           available;
+    // Shared (by reference) across flow_clones, like the maps below, so the
+    // side-effect summaries it caches accumulate over the whole application
+    // instead of being recomputed per query.
+    ::hasSideEffects                    &sideEffects;
     std::map<cstring, TableInfo>        &tables;
     std::map<cstring, FuncInfo>         &actions;
     std::map<cstring, FuncInfo>         &methods;
     std::map<cstring, FuncInfo>         &states;
+    std::set<cstring>                   &changed;   // blocks rewritten by this application
+    std::set<cstring>                   &revisit;   // blocks rewritten by the previous one
+    bool                                incremental = false;
+    const IR::Node                      *lastResult = nullptr;
     TableInfo                           *inferForTable = nullptr;
     FuncInfo                            *inferForFunc = nullptr;
     bool                                need_key_rewrite = false;
@@ -83,9 +102,10 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
     bool name_overlap(cstring, cstring);
     void forOverlapAvail(cstring, std::function<void(cstring, VarInfo *)>);
     void dropValuesUsing(cstring);
-    bool hasSideEffects(const IR::Expression *e) {
-        return bool(::hasSideEffects(refMap, typeMap, e)); }
+    bool hasSideEffects(const IR::Expression *e) { return sideEffects(e); }
 
+    Visitor::profile_t init_apply(const IR::Node *node) override;
+    void end_apply(const IR::Node *node) override;
     void visit_local_decl(const IR::Declaration_Variable *);
     const IR::Node *postorder(IR::Declaration_Variable *) override;
     IR::Expression *preorder(IR::Expression *m) override;
@@ -107,6 +127,7 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
     void apply_function(FuncInfo *tbl);
     IR::P4Table *preorder(IR::P4Table *) override;
     IR::P4Table *postorder(IR::P4Table *) override;
+    const IR::P4Parser *preorder(IR::P4Parser *) override;
     const IR::P4Parser *postorder(IR::P4Parser *) override;
     IR::ParserState *preorder(IR::ParserState *) override;
     IR::ParserState *postorder(IR::ParserState *) override;
@@ -118,9 +139,11 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
  public:
     DoLocalCopyPropagation(ReferenceMap* refMap, TypeMap* typeMap,
         std::function<bool(const Context *, const IR::Expression *)> policy, bool eut)
-    : refMap(refMap), typeMap(typeMap), tables(*new std::map<cstring, TableInfo>),
+    : refMap(refMap), typeMap(typeMap), sideEffects(*new ::hasSideEffects(refMap, typeMap)),
+      tables(*new std::map<cstring, TableInfo>),
       actions(*new std::map<cstring, FuncInfo>), methods(*new std::map<cstring, FuncInfo>),
-      states(*new std::map<cstring, FuncInfo>), policy(policy), elimUnusedTables(eut) {}
+      states(*new std::map<cstring, FuncInfo>), changed(*new std::set<cstring>),
+      revisit(*new std::set<cstring>), policy(policy), elimUnusedTables(eut) {}
 };
 
 class LocalCopyPropagation : public PassManager {
@@ -133,8 +156,12 @@ class LocalCopyPropagation : public PassManager {
     ) {
         if (!typeChecking)
             typeChecking = new TypeChecking(refMap, typeMap, true);
-        passes.push_back(typeChecking);
-        passes.push_back(new DoLocalCopyPropagation(refMap, typeMap, policy, elimUnusedTables));
+        // Propagating a copy can expose another (x=y; z=x; after propagation
+        // z=y may propagate further), so iterate to a fixed point; rounds
+        // after the first only reprocess what the previous round changed.
+        passes.push_back(new PassRepeated({
+            typeChecking,
+            new DoLocalCopyPropagation(refMap, typeMap, policy, elimUnusedTables)}));
     }
 };
 
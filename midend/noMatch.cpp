@@ -32,12 +32,12 @@ const IR::Node* DoHandleNoMatch::postorder(IR::SelectExpression* expression) {
 }
 
 const IR::Node* DoHandleNoMatch::preorder(IR::P4Parser* parser) {
-    P4CoreLibrary& lib = P4CoreLibrary::instance;
+    P4CoreLibrary& lib = P4CoreLibrary::instance();
 
     cstring name = nameGen->newName("noMatch");
     LOG2("Inserting " << name << " state");
     auto args = new IR::Vector<IR::Argument>();
-    args->push_back(new IR::Argument(new IR::BoolLiteral(false)));
+    args->push_back(new IR::Argument(IR::BoolLiteral::get(false)));
     args->push_back(new IR::Argument(new IR::Member(
         new IR::TypeNameExpression(IR::Type_Error::error),
         lib.noMatch.Id())));
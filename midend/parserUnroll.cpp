@@ -1,4 +1,5 @@
 #include "parserUnroll.h"
+#include "lib/hash.h"
 #include "lib/stringify.h"
 
 namespace P4 {
@@ -48,8 +49,18 @@ class ParserSymbolicInterpreter {
     ReferenceMap*       refMap;
     TypeMap*            typeMap;
     SymbolicValueFactory* factory;
+    // Shared by all the evaluators created below: identical pure
+    // computations are evaluated once per distinct set of read values
+    // rather than once per path.
+    ExpressionMemoizer* memoizer;
     ParserInfo*         synthesizedParser;  // output produced
     bool                unroll;
+    // States already expanded, bucketed by original state name and a hash
+    // of their symbolic store; paths that reach a state with an equivalent
+    // store are merged instead of being re-expanded, so the evaluation is
+    // linear in the number of distinct (state, store) pairs rather than in
+    // the number of paths.
+    std::map<std::pair<cstring, size_t>, std::vector<const ParserStateInfo*>> visitedStates;
 
     ValueMap* initializeVariables() {
         ValueMap* result = new ValueMap();
@@ -151,7 +162,7 @@ class ParserSymbolicInterpreter {
     /// and 'false' if an error occurred.
     bool executeStatement(const ParserStateInfo* state, const IR::StatOrDecl* sord,
                           ValueMap* valueMap) const {
-        ExpressionEvaluator ev(refMap, typeMap, valueMap);
+        ExpressionEvaluator ev(refMap, typeMap, valueMap, memoizer);
 
         bool success = true;
         if (sord->is<IR::AssignmentStatement>()) {
@@ -296,6 +307,32 @@ class ParserSymbolicInterpreter {
         return false;
     }
 
+    /// A cheap fingerprint of a symbolic store, computed from its printed
+    /// form; equal stores print identically, so equal stores always hash
+    /// equal.  Used only to pick a bucket -- candidates within a bucket
+    /// are still compared with ValueMap::equals.
+    static size_t hashValues(const ValueMap* values) {
+        std::stringstream repr;
+        values->dbprint(repr);
+        return Util::Hash::murmur(repr.str());
+    }
+
+    /// True if an equivalent symbolic configuration was already expanded;
+    /// registers the state otherwise.  Called after checkLoops, so cycle
+    /// diagnostics are emitted before the revisiting path is merged away.
+    bool alreadyVisited(const ParserStateInfo* state) {
+        auto key = std::make_pair(state->state->name.name, hashValues(state->before));
+        auto& bucket = visitedStates[key];
+        for (auto prev : bucket) {
+            if (prev->before->equals(state->before)) {
+                LOG1("Merging into previously explored " << stateChain(prev));
+                return true;
+            }
+        }
+        bucket.push_back(state);
+        return false;
+    }
+
     std::vector<ParserStateInfo*>* evaluateState(ParserStateInfo* state) {
         LOG1("Analyzing " << state->state);
         auto valueMap = state->before->clone();
@@ -316,6 +353,7 @@ class ParserSymbolicInterpreter {
               synthesizedParser(nullptr), unroll(unroll) {
         CHECK_NULL(structure); CHECK_NULL(refMap); CHECK_NULL(typeMap);
         factory = new SymbolicValueFactory(typeMap);
+        memoizer = new ExpressionMemoizer();
         parser = structure->parser;
     }
 
@@ -337,6 +375,9 @@ class ParserSymbolicInterpreter {
             if (infLoop)
                 // don't evaluate successors anymore
                 continue;
+            if (alreadyVisited(stateInfo))
+                // another path already expanded this configuration
+                continue;
             auto nextStates = evaluateState(stateInfo);
             if (nextStates == nullptr) {
                 LOG1("No next states");
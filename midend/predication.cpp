@@ -67,6 +67,10 @@ const IR::Mux * Predication::ExpressionReplacer::preorder(IR::Mux * mux) {
     visit(mux->e1);
     visit(mux->e2);
     --currentNestingLevel;
+    // The branches have been rewritten by the explicit visits above;
+    // letting the traversal descend again would redo the same work on
+    // every level of the Mux chain.
+    prune();
     return mux;
 }
 
@@ -137,11 +141,11 @@ const IR::Node* Predication::preorder(IR::AssignmentStatement* statement) {
     if (findContext<IR::P4Action>() == nullptr || ifNestingLevel == 0) {
         return statement;
     }
-    const Context * ctxt = nullptr;
+    // The predicate context is maintained by preorder(IfStatement);
+    // the replacer expects the conditions innermost-first.
     std::vector<const IR::Expression*> conditions;
-    while (auto ifs = findContext<IR::IfStatement>(ctxt)) {
-        conditions.push_back(ifs->condition);
-    }
+    conditions.reserve(nestedConditions.size());
+    conditions.insert(conditions.end(), nestedConditions.rbegin(), nestedConditions.rend());
     auto clonedStatement = clone(statement)->to<IR::AssignmentStatement>();
     ExpressionReplacer replacer(clonedStatement, travesalPath, conditions);
     // Referenced lvalue is not appeard before
@@ -237,6 +241,7 @@ const IR::Node* Predication::preorder(IR::IfStatement* statement) {
         statement->condition = condition;  // replace with variable cond
     }
     travesalPath.push_back(true);
+    nestedConditions.push_back(statement->condition);
     visit(statement->ifTrue);
     rv->push_back(statement->ifTrue);
     // This evaluates else branch
@@ -246,11 +251,10 @@ const IR::Node* Predication::preorder(IR::IfStatement* statement) {
         rv->push_back(statement->ifFalse);
     }
     // Push assignments which are correctly aranged in liveAssigns vector on rv block.
-    for (auto it : liveAssigns) {
-        rv->push_back(it);
-    }
+    rv->components.append(liveAssigns);
     liveAssigns.clear();
     liveAssignments.clear();
+    nestedConditions.pop_back();
     travesalPath.pop_back();
     --ifNestingLevel;
     prune();
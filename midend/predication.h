@@ -84,6 +84,11 @@ class Predication final : public Transform {
     // false at the end of the vector means that you are in the else branch of the if statement.
     // Size of this vector is the current if nesting level.
     std::vector<bool> travesalPath;
+    // Conditions of the enclosing if statements, innermost at the back.
+    // Maintained in parallel with travesalPath so that each assignment
+    // can read its predicate context directly instead of walking the
+    // visitor context chain.
+    std::vector<const IR::Expression*> nestedConditions;
     std::vector<cstring> dependencies;
     // Collects assignment statements with transformed right expression.
     // liveAssignments are pushed at the back of liveAssigns vetor.
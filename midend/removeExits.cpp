@@ -59,7 +59,7 @@ const IR::Node* DoRemoveExits::preorder(IR::ExitStatement* statement) {
     set(Returns::Yes);
     auto left = new IR::PathExpression(returnVar);
     return new IR::AssignmentStatement(statement->srcInfo, left,
-                                       new IR::BoolLiteral(true));
+                                       IR::BoolLiteral::get(true));
 }
 
 const IR::Node* DoRemoveExits::preorder(IR::P4Table* table) {
@@ -114,7 +114,7 @@ const IR::Node* DoRemoveExits::preorder(IR::P4Control* control) {
 
     IR::IndexedVector<IR::StatOrDecl> newbody;
     auto left = new IR::PathExpression(returnVar);
-    auto init = new IR::AssignmentStatement(left, new IR::BoolLiteral(false));
+    auto init = new IR::AssignmentStatement(left, IR::BoolLiteral::get(false));
     newbody.push_back(init);
     newbody.append(control->body->components);
     control->body = new IR::BlockStatement(
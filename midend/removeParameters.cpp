@@ -151,6 +151,7 @@ const IR::Node* DoRemoveActionParameters::postorder(IR::P4Action* action) {
 
     InsertBeforeExits ibf(postamble);
     auto actionBody = action->body->apply(ibf)->to<IR::BlockStatement>();
+    body->reserve(body->size() + actionBody->components.size() + postamble->size());
     body->append(actionBody->components);
     body->append(*postamble);
 
@@ -197,7 +198,15 @@ RemoveActionParameters::RemoveActionParameters(ReferenceMap* refMap, TypeMap* ty
     passes.emplace_back(typeChecking);
     passes.emplace_back(new FindActionParameters(refMap, typeMap, ai));
     passes.emplace_back(new DoRemoveActionParameters(ai));
-    passes.emplace_back(new ClearTypeMap(typeMap));
+    // DoRemoveActionParameters allocates a fresh node for everything whose
+    // type changes (the actions, their calls, and the spine above them), so
+    // the surviving nodes keep their typeMap entries.  Re-running type
+    // checking here is therefore incremental -- TypeInference::done() skips
+    // every node that is already typed and only the replacements are visited
+    // -- and it leaves the map valid for the rewritten program, so the
+    // defensive TypeChecking at the start of the next midend pass no-ops
+    // instead of re-typechecking the whole program from a cleared map.
+    passes.emplace_back(typeChecking);
 }
 
 }  // namespace P4
@@ -0,0 +1,137 @@
+/*
+Copyright 2020 VMware, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "removeUnusedFields.h"
+#include "frontends/common/options.h"
+
+namespace P4 {
+
+namespace {
+
+/// Same test ToP4 uses to recognize system headers when pretty-printing.
+bool fromArchitectureFile(const IR::Node* node) {
+    if (!node->srcInfo.isValid())
+        return false;
+    return node->srcInfo.getSourceFile().startsWith(p4includePath);
+}
+
+}  // namespace
+
+bool FindUnusedFields::preorder(const IR::Type_Struct* type) {
+    cstring name = type->name.name;
+    map->declare(name);
+    if (fromArchitectureFile(type) || type->annotations->size() > 0)
+        map->setOpaque(name);
+    return true;
+}
+
+void FindUnusedFields::postorder(const IR::Type_Name* type) {
+    auto decl = refMap->getDeclaration(type->path, true);
+    auto st = decl->getNode()->to<IR::Type_Struct>();
+    if (st == nullptr)
+        return;
+    // The struct name may appear as the type of a parameter, variable or
+    // field without pinning the layout; anywhere else -- a type argument
+    // of a method call or instantiation, a cast, a tuple component -- the
+    // declaration must be kept intact.
+    auto parent = getContext()->node;
+    if (parent->is<IR::Parameter>() || parent->is<IR::Declaration_Variable>() ||
+        parent->is<IR::StructField>())
+        return;
+    map->setOpaque(st->name.name);
+}
+
+void FindUnusedFields::postorder(const IR::PathExpression* expression) {
+    auto type = typeMap->getType(expression, true);
+    auto st = type->to<IR::Type_Struct>();
+    if (st == nullptr)
+        return;
+    if (getContext()->node->is<IR::Member>())
+        return;  // just the base of a field access
+    map->setOpaque(st->name.name);
+}
+
+void FindUnusedFields::postorder(const IR::Member* expression) {
+    auto parent = getContext()->node;
+    if (auto type = typeMap->getType(expression)) {
+        if (auto st = type->to<IR::Type_Struct>()) {
+            // A struct-valued field used as anything except the base of a
+            // further field access is copied or passed around whole.
+            if (!parent->is<IR::Member>())
+                map->setOpaque(st->name.name);
+        }
+    }
+    auto baseType = typeMap->getType(expression->expr, true);
+    auto st = baseType->to<IR::Type_Struct>();
+    if (st == nullptr)
+        return;
+    if (parent->is<IR::MethodCallExpression>()) {
+        // minSizeInBits() and friends depend on the full field list.
+        map->setOpaque(st->name.name);
+        return;
+    }
+    if (isWrite() && !isRead()) {
+        auto assign = getParent<IR::AssignmentStatement>();
+        if (assign != nullptr && assign->left == expression && !sideEffects(assign->right))
+            // A pure write to this exact field; it disappears together
+            // with the field, so it does not keep the field alive.
+            return;
+    }
+    map->setRead(st->name.name, expression->member.name);
+}
+
+void FindUnusedFields::postorder(const IR::StructExpression* expression) {
+    auto type = typeMap->getType(expression, true);
+    if (auto st = type->to<IR::Type_Struct>())
+        map->setOpaque(st->name.name);
+}
+
+void FindUnusedFields::postorder(const IR::ListExpression* expression) {
+    auto type = typeMap->getType(expression, true);
+    if (auto st = type->to<IR::Type_Struct>())
+        map->setOpaque(st->name.name);
+}
+
+const IR::Node* PruneUnusedFields::postorder(IR::Type_Struct* type) {
+    bool changed = false;
+    IR::IndexedVector<IR::StructField> fields;
+    for (auto field : type->fields) {
+        if (fieldUseMap->isRemoved(type->name.name, field->name.name)) {
+            LOG3("Removing unused field " << field->name << " of " << type->name);
+            changed = true;
+        } else {
+            fields.push_back(field);
+        }
+    }
+    if (!changed)
+        return type;
+    type->fields = fields;
+    return type;
+}
+
+const IR::Node* PruneUnusedFields::postorder(IR::AssignmentStatement* statement) {
+    auto member = getOriginal<IR::AssignmentStatement>()->left->to<IR::Member>();
+    if (member == nullptr)
+        return statement;
+    auto baseType = typeMap->getType(member->expr, true);
+    auto st = baseType->to<IR::Type_Struct>();
+    if (st == nullptr || !fieldUseMap->isRemoved(st->name.name, member->member.name))
+        return statement;
+    LOG3("Removing write to unused field: " << statement);
+    return new IR::EmptyStatement();
+}
+
+}  // namespace P4
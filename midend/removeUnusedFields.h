@@ -0,0 +1,137 @@
+/*
+Copyright 2020 VMware, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _MIDEND_REMOVEUNUSEDFIELDS_H_
+#define _MIDEND_REMOVEUNUSEDFIELDS_H_
+
+#include "ir/ir.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "midend/has_side_effects.h"
+
+namespace P4 {
+
+/**
+ * Field-level usage summary for the struct types declared by the program,
+ * built by FindUnusedFields and consulted by PruneUnusedFields.
+ */
+struct FieldUseMap {
+    struct StructUse {
+        /// Set for structs the program actually declares; usage recorded
+        /// against other names is ignored.
+        bool declared = false;
+        /// The struct must keep its full field list: it is used as a whole
+        /// value somewhere, it carries annotations, it comes from an
+        /// architecture file, or its name appears in a position (type
+        /// argument, cast) whose semantics may depend on the layout.
+        bool opaque = false;
+        /// Names of fields whose value may be observed.
+        std::set<cstring> read;
+    };
+    ordered_map<cstring, StructUse> structs;
+
+    void declare(cstring name) { structs[name].declared = true; }
+    void setOpaque(cstring name) { structs[name].opaque = true; }
+    void setRead(cstring name, cstring field) { structs[name].read.emplace(field); }
+    /// True if the named field can be deleted from the struct declaration.
+    bool isRemoved(cstring name, cstring field) const {
+        auto it = structs.find(name);
+        if (it == structs.end() || !it->second.declared || it->second.opaque)
+            return false;
+        return it->second.read.count(field) == 0;
+    }
+};
+
+/**
+ * Computes which struct fields are ever read.  A field access counts as a
+ * read unless it is the left-hand side of an assignment whose right-hand
+ * side has no side-effects; such a write dies together with the field.
+ * Any use of a struct as a whole value -- copied, passed as an argument,
+ * built with an initializer expression -- makes the type opaque, as do
+ * annotations on the declaration (control-plane aliases, @metadata) and
+ * declarations that come from an architecture include file, whose layout
+ * the target knows about (the PSA intrinsic metadata structs carry no
+ * annotations that would otherwise protect them).
+ */
+class FindUnusedFields : public Inspector, P4WriteContext {
+    ReferenceMap* refMap;
+    TypeMap*      typeMap;
+    FieldUseMap*  map;
+    hasSideEffects sideEffects;
+
+ public:
+    FindUnusedFields(ReferenceMap* refMap, TypeMap* typeMap, FieldUseMap* map)
+            : refMap(refMap), typeMap(typeMap), map(map), sideEffects(refMap, typeMap) {
+        CHECK_NULL(refMap); CHECK_NULL(typeMap); CHECK_NULL(map);
+        setName("FindUnusedFields");
+    }
+    bool preorder(const IR::Annotation*) override { return false; }
+    bool preorder(const IR::Type_Struct* type) override;
+    void postorder(const IR::Type_Name* type) override;
+    void postorder(const IR::PathExpression* expression) override;
+    void postorder(const IR::Member* expression) override;
+    void postorder(const IR::StructExpression* expression) override;
+    void postorder(const IR::ListExpression* expression) override;
+};
+
+/**
+ * Deletes the fields that FindUnusedFields proved dead from their struct
+ * declarations, along with the assignments that wrote to them.
+ */
+class PruneUnusedFields : public Transform {
+    const FieldUseMap* fieldUseMap;
+    const TypeMap*     typeMap;
+
+ public:
+    PruneUnusedFields(const FieldUseMap* fieldUseMap, const TypeMap* typeMap)
+            : fieldUseMap(fieldUseMap), typeMap(typeMap) {
+        CHECK_NULL(fieldUseMap); CHECK_NULL(typeMap);
+        setName("PruneUnusedFields");
+    }
+    const IR::Node* postorder(IR::Type_Struct* type) override;
+    const IR::Node* postorder(IR::AssignmentStatement* statement) override;
+};
+
+/**
+ * Removes struct fields that are never read, and the writes to them.
+ * Struct fields -- typically user metadata -- that survive to a backend
+ * are materialized in the generated artifacts (the single DPDK metadata
+ * structure, the BMv2 scalars header, eBPF stack variables) and cost
+ * memory and copies on every packet even when no table or deparser ever
+ * looks at them.
+ *
+ * Only Type_Struct declarations are pruned.  Headers are never touched:
+ * their field list is the wire format.  Structs used as whole values,
+ * structs with annotations and structs declared by architecture include
+ * files keep all their fields; see FindUnusedFields for the exact rules.
+ *
+ * Best run late in a midend, after dead code elimination, so that fields
+ * kept alive only by code that is itself dead are pruned too.
+ */
+class RemoveUnusedFields final : public PassManager {
+ public:
+    RemoveUnusedFields(ReferenceMap* refMap, TypeMap* typeMap) {
+        auto fieldUseMap = new FieldUseMap();
+        passes.push_back(new TypeChecking(refMap, typeMap));
+        passes.push_back(new FindUnusedFields(refMap, typeMap, fieldUseMap));
+        passes.push_back(new PruneUnusedFields(fieldUseMap, typeMap));
+        passes.push_back(new ClearTypeMap(typeMap));
+        setName("RemoveUnusedFields");
+    }
+};
+
+}  // namespace P4
+
+#endif /* _MIDEND_REMOVEUNUSEDFIELDS_H_ */
@@ -53,7 +53,13 @@ DoReplaceSelectRange::rangeToMasks(const IR::Range *r) {
     big_int range_size_remaining = max - min + 1;
 
     while (range_size_remaining > 0) {
-        big_int range_size = ((big_int) 1) << ((min == 0) ? 0 : ffs(min));
+        // Greedy prefix cover: take the largest power-of-two block
+        // aligned at min that still fits in the range.  A min of zero is
+        // aligned for any block size; with minimalCover only the
+        // remaining range size limits the block, otherwise start from a
+        // single-value block as the historical expansion did.
+        big_int range_size = ((big_int) 1)
+            << ((min == 0) ? (minimalCover ? width : 0) : ffs(min));
 
         while (range_size > range_size_remaining)
             range_size >>= 1;
@@ -38,8 +38,14 @@ class DoReplaceSelectRange : public Transform {
     // number of new cases generated for ternary operations due to a range
     // Each case is a key set expression.
     const uint MAX_CASES;
+    // If true, a range starting at zero is covered with the fewest masks
+    // possible instead of the historical single-value-first expansion.
+    // Off by default: the smaller cover changes the emitted select cases,
+    // so enabling it requires regenerating the reference outputs.
+    const bool minimalCover;
 
-    explicit DoReplaceSelectRange(uint max) : MAX_CASES(max) {
+    explicit DoReplaceSelectRange(uint max, bool minimalCover = false)
+            : MAX_CASES(max), minimalCover(minimalCover) {
         setName("DoReplaceSelectRange");
     }
     const IR::Node* postorder(IR::SelectCase* p) override;
@@ -63,6 +63,18 @@ const IR::Node* DoSimplifyKey::postorder(IR::KeyElement* element) {
         insertions = it->second;
     }
 
+    // If an identical expression was already copied for this table
+    // reuse its temporary; the copies all execute together just before
+    // the table is applied, so they would hold the same value.
+    for (auto assign : insertions->statements) {
+        if (same.sameExpression(assign->right, element->expression)) {
+            element->expression = new IR::PathExpression(
+                assign->left->to<IR::PathExpression>()->path->name);
+            LOG2("Reused key expression " << element);
+            return element;
+        }
+    }
+
     auto tmp = refMap->newName("key");
     auto type = typeMap->getType(element->expression, true);
     auto decl = new IR::Declaration_Variable(tmp, type, nullptr);
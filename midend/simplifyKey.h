@@ -20,6 +20,7 @@ limitations under the License.
 #include "ir/ir.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeChecking/syntacticEquivalence.h"
 
 namespace P4 {
 
@@ -146,11 +147,13 @@ class DoSimplifyKey : public Transform {
     ReferenceMap* refMap;
     TypeMap*      typeMap;
     KeyIsSimple*  key_policy;
+    /// Used to reuse one temporary for identical key expressions of a table.
+    SameExpression same;
     std::map<const IR::P4Table*, TableInsertions*> toInsert;
 
  public:
     DoSimplifyKey(ReferenceMap* refMap, TypeMap* typeMap, KeyIsSimple* key_policy)
-        : refMap(refMap), typeMap(typeMap), key_policy(key_policy)
+        : refMap(refMap), typeMap(typeMap), key_policy(key_policy), same(refMap, typeMap)
     { CHECK_NULL(refMap); CHECK_NULL(typeMap); CHECK_NULL(key_policy); setName("DoSimplifyKey"); }
     const IR::Node* doStatement(const IR::Statement* statement, const IR::Expression* expression);
 
@@ -33,9 +33,9 @@ const IR::Node* DoTableHit::postorder(IR::AssignmentStatement* statement) {
         return statement;
 
     auto tstat = new IR::AssignmentStatement(
-        statement->left->clone(), new IR::BoolLiteral(true));
+        statement->left->clone(), IR::BoolLiteral::get(true));
     auto fstat = new IR::AssignmentStatement(
-        statement->left->clone(), new IR::BoolLiteral(false));
+        statement->left->clone(), IR::BoolLiteral::get(false));
     if (negated)
         return new IR::IfStatement(right, fstat, tstat);
     else
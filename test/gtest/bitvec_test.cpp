@@ -91,6 +91,12 @@ TEST(Bitvec, getslice) {
     EXPECT_EQ(slice.ffs(32), 64);
     EXPECT_EQ(slice.ffz(64), 80u);
     EXPECT_EQ(slice.ffs(80), 96);
+
+    // an unaligned slice whose source spans one more word than the result:
+    // the bits from the extra word used to be dropped
+    bitvec straddle;
+    straddle.setbit(4185);
+    EXPECT_EQ(straddle.getslice(4095, 91).ffs(0), 90);
 }
 
 TEST(Bitvec, rotate) {
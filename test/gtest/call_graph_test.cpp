@@ -52,4 +52,36 @@ TEST(CallGraph, Acyclic) {
     EXPECT_EQ('a', sorted.at(2));
 }
 
+TEST(CallGraph, Compiled) {
+    P4::CallGraph<char> graph("cyclic");
+    // a<->b->c   d->d   e
+
+    graph.calls('a', 'b');
+    graph.calls('b', 'a');
+    graph.calls('b', 'c');
+    graph.calls('d', 'd');
+    graph.add('e');
+
+    auto compiled = graph.compile();
+    EXPECT_EQ(5u, compiled->size());
+    EXPECT_TRUE(compiled->isCyclic());
+    EXPECT_TRUE(compiled->isRecursive('a'));
+    EXPECT_TRUE(compiled->isRecursive('b'));
+    EXPECT_FALSE(compiled->isRecursive('c'));
+    EXPECT_TRUE(compiled->isRecursive('d'));  // self-loop
+    EXPECT_FALSE(compiled->isRecursive('e'));
+    EXPECT_TRUE(compiled->inSameComponent('a', 'b'));
+    EXPECT_FALSE(compiled->inSameComponent('a', 'c'));
+
+    // callees before callers, components consecutive
+    std::vector<char> expected = {'c', 'b', 'a', 'd', 'e'};
+    EXPECT_EQ(expected, compiled->sccOrder());
+
+    // only nodes reachable from the start
+    std::vector<char> sorted;
+    EXPECT_TRUE(compiled->sccSort('a', sorted));
+    std::vector<char> reachable = {'c', 'b', 'a'};
+    EXPECT_EQ(reachable, sorted);
+}
+
 }  // namespace Test
@@ -141,4 +141,31 @@ TEST_F(ConstantExpr, TestIntegerFuncs) {
     EXPECT_EQ(neg_res.asInt(), -123);
 }
 
+TEST_F(ConstantExpr, TestInterning) {
+    auto u8 = IR::Type_Bits::get(8);
+
+    // small position-less constants of interned types are shared
+    auto zero = IR::Constant::get(u8, 0);
+    EXPECT_EQ(zero, IR::Constant::get(u8, 0));
+    EXPECT_NE(zero, IR::Constant::get(u8, 1));
+    EXPECT_NE(zero, IR::Constant::get(IR::Type_Bits::get(16), 0));
+    EXPECT_EQ(0, zero->asInt());
+
+    // values outside the cacheable range still get fresh nodes
+    auto big1 = IR::Constant::get(u8, 200);
+    auto big2 = IR::Constant::get(u8, 200);
+    EXPECT_NE(big1, big2);
+    EXPECT_TRUE(big1->equiv(*big2));
+
+    // Type_InfInt is a type variable for unification and is never shared
+    EXPECT_NE(IR::Constant::get(new IR::Type_InfInt(), 0),
+              IR::Constant::get(new IR::Type_InfInt(), 0));
+
+    auto t = IR::BoolLiteral::get(true);
+    EXPECT_EQ(t, IR::BoolLiteral::get(true));
+    EXPECT_NE(t, IR::BoolLiteral::get(false));
+    EXPECT_TRUE(t->value);
+    EXPECT_TRUE(t->type->is<IR::Type_Boolean>());
+}
+
 }  // namespace Test
@@ -0,0 +1,88 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "lib/cow_map.h"
+
+namespace Test {
+
+TEST(cow_map, copy_shares) {
+    cow_map<int, int> a;
+    a[1] = 10;
+    a[2] = 20;
+
+    cow_map<int, int> b = a;
+    EXPECT_TRUE(a.shares_with(b));
+    const cow_map<int, int> &cb = b;
+    EXPECT_EQ(2u, cb.size());
+    EXPECT_EQ(10, cb.find(1)->second);
+    // const lookups do not unshare
+    EXPECT_TRUE(a.shares_with(b));
+}
+
+TEST(cow_map, write_unshares) {
+    cow_map<int, int> a;
+    a[1] = 10;
+    cow_map<int, int> b = a;
+
+    b[1] = 11;
+    EXPECT_FALSE(a.shares_with(b));
+    const cow_map<int, int> &ca = a;
+    const cow_map<int, int> &cb = b;
+    EXPECT_EQ(10, ca.find(1)->second);
+    EXPECT_EQ(11, cb.find(1)->second);
+}
+
+TEST(cow_map, nonconst_lookup_unshares) {
+    cow_map<int, int> a;
+    a[1] = 10;
+    cow_map<int, int> b = a;
+
+    // non-const find may be written through, so it must unshare
+    auto it = b.find(1);
+    it->second = 12;
+    EXPECT_FALSE(a.shares_with(b));
+    const cow_map<int, int> &ca = a;
+    EXPECT_EQ(10, ca.find(1)->second);
+}
+
+TEST(cow_map, getref) {
+    cow_map<int, int> a;
+    a[1] = 10;
+    const cow_map<int, int> &ca = a;
+
+    EXPECT_EQ(nullptr, ::getref(ca, 2));
+    ASSERT_NE(nullptr, ::getref(ca, 1));
+    EXPECT_EQ(10, *::getref(ca, 1));
+
+    cow_map<int, int> b = a;
+    *::getref(b, 1) = 13;
+    EXPECT_FALSE(a.shares_with(b));
+    EXPECT_EQ(10, *::getref(ca, 1));
+}
+
+TEST(cow_map, clear_detaches) {
+    cow_map<int, int> a;
+    a[1] = 10;
+    cow_map<int, int> b = a;
+
+    b.clear();
+    EXPECT_TRUE(b.empty());
+    const cow_map<int, int> &ca = a;
+    EXPECT_EQ(1u, ca.size());
+}
+
+}  // namespace Test
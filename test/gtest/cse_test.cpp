@@ -0,0 +1,102 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "helpers.h"
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeMap.h"
+#include "midend/cse.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+/// Counts the xor nodes left after CSE has shared the repeated ones.
+class CountXors : public Inspector {
+ public:
+    unsigned xors = 0;
+    void postorder(const IR::BXor*) override { xors++; }
+};
+
+}  // namespace
+
+class P4CCse : public P4CTest { };
+
+// The repeated a ^ b must be computed once into a temporary; the two
+// enclosing additions differ, so they stay.
+TEST_F(P4CCse, SharedSubexpression) {
+    std::string program = P4_SOURCE(R"(
+        control c(in bit<8> a, in bit<8> b, out bit<8> x, out bit<8> y) {
+            apply {
+                x = (a ^ b) + 1;
+                y = (a ^ b) + 2;
+            }
+        }
+        control proto(in bit<8> a, in bit<8> b, out bit<8> x, out bit<8> y);
+        package top(proto p);
+        top(c()) main;
+    )");
+    auto pgm = P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    TypeMap      typeMap;
+    GlobalCSE    cse(&refMap, &typeMap);
+
+    pgm = pgm->apply(cse);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    CountXors counter;
+    pgm->apply(counter);
+    EXPECT_EQ(1u, counter.xors);
+}
+
+// An intervening write to an input of the shared expression must
+// invalidate it: the second a ^ b reads the new a and is recomputed.
+TEST_F(P4CCse, InvalidatedByWrite) {
+    std::string program = P4_SOURCE(R"(
+        control c(inout bit<8> a, in bit<8> b, out bit<8> x, out bit<8> y) {
+            apply {
+                x = (a ^ b) + 1;
+                a = x;
+                y = (a ^ b) + 2;
+            }
+        }
+        control proto(inout bit<8> a, in bit<8> b, out bit<8> x, out bit<8> y);
+        package top(proto p);
+        top(c()) main;
+    )");
+    auto pgm = P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    TypeMap      typeMap;
+    GlobalCSE    cse(&refMap, &typeMap);
+
+    pgm = pgm->apply(cse);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    CountXors counter;
+    pgm->apply(counter);
+    EXPECT_EQ(2u, counter.xors);
+}
+
+}  // namespace Test
@@ -14,8 +14,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <map>
+#include <set>
+
 #include "gtest/gtest.h"
 #include "lib/cstring.h"
+#include "lib/map.h"
 
 namespace Test {
 
@@ -110,4 +114,92 @@ TEST(cstring, replace) {
     EXPECT_EQ(c.replace("i", ""), "Orgnal");
 }
 
+TEST(cstring, make_unique) {
+    std::set<cstring> inuse = { "base" };
+    EXPECT_EQ(cstring::make_unique(inuse, "fresh"), "fresh");
+    EXPECT_EQ(cstring::make_unique(inuse, "base"), "base.0");
+    inuse.insert("base.0");
+    EXPECT_EQ(cstring::make_unique(inuse, "base", '_'), "base_0");
+
+    // the counter-based variant must agree with the plain one and resume
+    // from where it left off for the same base name
+    std::map<cstring, int> counters;
+    EXPECT_EQ(cstring::make_unique(inuse, counters, "base"), "base.1");
+    inuse.insert("base.1");
+    EXPECT_EQ(cstring::make_unique(inuse, counters, "base"), "base.2");
+    inuse.insert("base.2");
+    EXPECT_EQ(cstring::make_unique(inuse, counters, "other"), "other");
+    // a stale counter may only skip suffixes, never produce a duplicate
+    counters["taken"] = 5;
+    inuse.insert("taken");
+    EXPECT_EQ(cstring::make_unique(inuse, counters, "taken"), "taken.5");
+}
+
+TEST(cstring, size) {
+    // size() reads the length stored alongside the interned string, so it
+    // must agree with strlen for every construction path
+    cstring shared = "size.shared";
+    EXPECT_EQ(strlen(shared.c_str()), shared.size());
+
+    std::string longName(1000, 'x');
+    cstring fromString = longName;
+    EXPECT_EQ(1000u, fromString.size());
+
+    cstring lit = cstring::literal("size.literal");
+    EXPECT_EQ(strlen("size.literal"), lit.size());
+
+    const size_t length = strlen("size.owned");
+    char* owned = new char[length + 1];
+    snprintf(owned, length + 1, "%s", "size.owned");
+    cstring fromOwned = cstring::own(owned, length);
+    EXPECT_EQ(length, fromOwned.size());
+    EXPECT_EQ(fromOwned, "size.owned");
+
+    cstring sub = shared.substr(5);
+    EXPECT_EQ(strlen(sub.c_str()), sub.size());
+    EXPECT_EQ(sub.size(), size_t(sub.end() - sub.begin()));
+}
+
+TEST(cstring, ordering) {
+    // a proper prefix sorts before the longer string
+    EXPECT_LT(cstring("order"), cstring("ordering"));
+    EXPECT_GT(cstring("ordering"), cstring("order"));
+    EXPECT_LT(cstring("abc"), cstring("abd"));
+    EXPECT_LE(cstring("abc"), cstring("abc"));
+    EXPECT_GE(cstring("abc"), cstring("abc"));
+    EXPECT_EQ(0, cstring("abc").compare("abc"));
+    EXPECT_GT(0, cstring("abc").compare("abd"));
+    EXPECT_LT(0, cstring("abd").compare("abc"));
+
+    // null sorts before everything, including the empty string
+    cstring null;
+    EXPECT_LT(null, cstring(""));
+    EXPECT_FALSE(cstring("") < null);
+    EXPECT_FALSE(null < null);
+    EXPECT_LE(null, null);
+    EXPECT_GE(null, null);
+}
+
+TEST(cstring, find_interned) {
+    cstring interned = "find_interned.present";
+    EXPECT_EQ(interned, cstring::find_interned("find_interned.present"));
+    // the probe returns the interned string itself, not a copy
+    EXPECT_EQ(interned.c_str(), cstring::find_interned("find_interned.present").c_str());
+
+    // a failed probe must not grow the intern table
+    size_t count, countAfter;
+    cstring::cache_size(count);
+    EXPECT_TRUE(cstring::find_interned(std::string("find_interned.absent")).isNull());
+    cstring::cache_size(countAfter);
+    EXPECT_EQ(count, countAfter);
+
+    std::map<cstring, int> m;
+    m[interned] = 1;
+    EXPECT_EQ(1, get(m, std::string("find_interned.present")));
+    EXPECT_EQ(0, get(m, std::string("find_interned.also.absent")));
+    EXPECT_EQ(nullptr, getref(m, std::string("find_interned.also.absent")));
+    cstring::cache_size(countAfter);
+    EXPECT_EQ(count, countAfter);
+}
+
 }  // namespace Test
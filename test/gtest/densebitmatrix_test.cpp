@@ -0,0 +1,126 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "lib/densebitmatrix.h"
+
+namespace {
+
+// Reference closure: the textbook triple loop, bit at a time.
+DenseBitMatrix naiveClosure(DenseBitMatrix m) {
+    unsigned n = m.size();
+    for (unsigned k = 0; k < n; k++)
+        for (unsigned i = 0; i < n; i++)
+            if (m(i, k))
+                for (unsigned j = 0; j < n; j++)
+                    if (m(k, j)) m.set(i, j);
+    return m;
+}
+
+TEST(DenseBitMatrix, Basic) {
+    DenseBitMatrix m(200);
+    EXPECT_EQ(200U, m.size());
+    EXPECT_TRUE(m.empty());
+    m.set(3, 150);
+    EXPECT_TRUE(m(3, 150));
+    EXPECT_FALSE(m(150, 3));
+    m.set_sym(7, 190);
+    EXPECT_TRUE(m(7, 190) && m(190, 7));
+    m.clr(3, 150);
+    EXPECT_FALSE(m(3, 150));
+
+    m.set(5, 64);
+    m.set(5, 67);
+    bitvec row5 = m.row(5);
+    EXPECT_EQ(2U, row5.popcount());
+    EXPECT_TRUE(row5.getbit(64) && row5.getbit(67));
+}
+
+TEST(DenseBitMatrix, Closure) {
+    // a chain crossing word-block boundaries, plus a path that enters a
+    // block through one edge and leaves through a vertex it only reaches
+    // inside that block
+    DenseBitMatrix m(200);
+    m.set(0, 70);
+    m.set(70, 130);
+    m.set(130, 199);
+    m.set(5, 64);
+    m.set(64, 65);
+    m.set(65, 3);
+    auto expect = naiveClosure(m);
+    m.closure();
+    EXPECT_EQ(expect, m);
+    EXPECT_TRUE(m(0, 199));
+    EXPECT_TRUE(m(5, 3));
+    EXPECT_FALSE(m(199, 0));
+}
+
+TEST(DenseBitMatrix, ClosureMatchesNaive) {
+    // pseudorandom sparse graph; the blocked kernel must agree with the
+    // textbook loop exactly
+    DenseBitMatrix m(150);
+    uint32_t x = 12345;
+    for (int e = 0; e < 300; e++) {
+        x = x * 1664525 + 1013904223;
+        m.set((x >> 8) % 150, (x >> 20) % 150); }
+    auto expect = naiveClosure(m);
+    m.closure();
+    EXPECT_EQ(expect, m);
+}
+
+TEST(DenseBitMatrix, MakeSymmetric) {
+    DenseBitMatrix m(130);
+    m.set(0, 129);
+    m.set(100, 3);
+    m.set(65, 64);
+    m.set(2, 2);
+    m.make_symmetric();
+    DenseBitMatrix expect(130);
+    expect.set_sym(0, 129);
+    expect.set_sym(100, 3);
+    expect.set_sym(65, 64);
+    expect.set(2, 2);
+    EXPECT_EQ(expect, m);
+}
+
+TEST(DenseBitMatrix, ConvertFromTriangular) {
+    SymBitMatrix sym;
+    sym(3, 10) = 1;
+    sym(90, 90) = 1;
+    sym(80, 95) = 1;
+    DenseBitMatrix dm(sym);
+    EXPECT_EQ(sym.size(), dm.size());
+    EXPECT_TRUE(dm(3, 10) && dm(10, 3));
+    EXPECT_TRUE(dm(90, 90));
+    EXPECT_TRUE(dm(80, 95) && dm(95, 80));
+
+    LTBitMatrix lt;
+    lt(5, 2) = 1;
+    lt(70, 70) = 1;
+    DenseBitMatrix dl(lt);
+    EXPECT_EQ(lt.size(), dl.size());
+    EXPECT_TRUE(dl(5, 2));
+    EXPECT_FALSE(dl(2, 5));
+    EXPECT_TRUE(dl(70, 70));
+
+    // round trip back through the rowref |= used by the triangular types
+    SymBitMatrix back;
+    for (unsigned r = 0; r < dm.size(); r++)
+        back[r] |= dm.row(r);
+    EXPECT_EQ(sym, back);
+}
+
+}  // namespace
@@ -16,12 +16,15 @@ limitations under the License.
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/optional.hpp>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 #include "frontends/common/applyOptionsPragmas.h"
 #include "ir/ir.h"
+#include "lib/gc.h"
 #include "test/gtest/helpers.h"
 
 namespace Test {
@@ -266,4 +269,84 @@ TEST_F(Diagnostics, CompilerOptions) {
     }
 }
 
+TEST_F(Diagnostics, ContextInheritedByWorkerThread) {
+    AutoCompileContext autoContext(new GTestContext);
+
+    // Keep the error we report below out of the test output.
+    std::stringstream errors;
+    BaseCompileContext::get().errorReporter().setOutputStream(&errors);
+
+    auto* parentContext = CompileContextStack::currentOrNull();
+    EXPECT_EQ(parentContext, &BaseCompileContext::get());
+
+    std::thread worker([parentContext]() {
+        gc_register_thread();
+        {
+            // The compilation context stack is thread-local, so a freshly
+            // spawned thread starts with an empty stack...
+            EXPECT_EQ(nullptr, CompileContextStack::currentOrNull());
+
+            // ...until it adopts its parent's context.
+            InheritedCompileContext inherited(parentContext);
+            EXPECT_EQ(parentContext, CompileContextStack::currentOrNull());
+            ::error("error reported from a worker thread");
+        }
+        EXPECT_EQ(nullptr, CompileContextStack::currentOrNull());
+        gc_unregister_thread();
+    });
+    worker.join();
+
+    // The worker's error was counted against the shared context.
+    EXPECT_EQ(1u, ::errorCount());
+    EXPECT_FALSE(errors.str().empty());
+}
+
+TEST_F(Diagnostics, SequencedEmissionOrdersByLane) {
+    AutoCompileContext autoContext(new GTestContext);
+
+    std::stringstream out;
+    auto& reporter = BaseCompileContext::get().errorReporter();
+    reporter.setOutputStream(&out);
+
+    // Emit in reverse lane order, as an unlucky schedule would; the merge
+    // must still produce lane order.
+    reporter.beginSequencedEmission(2);
+    {
+        ErrorReporter::SequenceLaneScope lane(1);
+        ::warning(ErrorType::WARN_INVALID, "second %1%", "message");
+    }
+    {
+        ErrorReporter::SequenceLaneScope lane(0);
+        ::warning(ErrorType::WARN_INVALID, "first %1%", "message");
+    }
+    EXPECT_TRUE(out.str().empty());  // nothing printed before the merge
+    reporter.endSequencedEmission();
+
+    auto text = out.str();
+    auto first = text.find("first");
+    auto second = text.find("second");
+    ASSERT_NE(std::string::npos, first);
+    ASSERT_NE(std::string::npos, second);
+    EXPECT_LT(first, second);
+    EXPECT_EQ(2u, ::warningCount());
+
+    // An error in an earlier lane suppresses warnings merged after it, just
+    // as a sequential run of the lanes would have.
+    out.str("");
+    reporter.beginSequencedEmission(2);
+    {
+        ErrorReporter::SequenceLaneScope lane(1);
+        ::warning(ErrorType::WARN_INVALID, "dropped %1%", "warning");
+    }
+    {
+        ErrorReporter::SequenceLaneScope lane(0);
+        ::error(ErrorType::ERR_INVALID, "lane zero %1%", "failure");
+    }
+    reporter.endSequencedEmission();
+    EXPECT_NE(std::string::npos, out.str().find("lane zero"));
+    EXPECT_EQ(std::string::npos, out.str().find("dropped"));
+    EXPECT_EQ(2u, ::warningCount());  // the dropped warning was uncounted
+    EXPECT_EQ(1u, ::errorCount());
+}
+
 }  // namespace Test
@@ -70,3 +70,31 @@ TEST(IR, Equiv) {
     pr2->add("listb", list1);
     EXPECT_FALSE(pr1->equiv(*pr2));
 }
+
+TEST(IR, StructuralHash) {
+    auto *t = IR::Type::Bits::get(16);
+    auto *a1 = new IR::Constant(t, 10);
+    auto *a2 = new IR::Constant(t, 10);
+    auto *c = new IR::Constant(t, 20);
+    EXPECT_EQ(a1->structuralHash(), a2->structuralHash());
+    EXPECT_EQ(a1->structuralHash(), a1->structuralHash());  // the cached value is stable
+    EXPECT_NE(a1->structuralHash(), c->structuralHash());
+
+    auto *d1 = new IR::PathExpression("d");
+    auto *d2 = new IR::PathExpression("d");
+    auto *e = new IR::PathExpression("e");
+    EXPECT_EQ(d1->structuralHash(), d2->structuralHash());
+    EXPECT_NE(d1->structuralHash(), e->structuralHash());
+
+    // the hash ignores node identity, so a clone hashes like its original
+    EXPECT_EQ(d1->structuralHash(), d1->clone()->structuralHash());
+
+    auto *call1 = new IR::MethodCallExpression(new IR::Member(d1, "m"), { a1, d1 });
+    auto *call2 = new IR::MethodCallExpression(new IR::Member(d2, "m"), { a2, d2 });
+    auto *call3 = new IR::MethodCallExpression(new IR::Member(d1, "m"), { c, d1 });
+    EXPECT_EQ(call1->structuralHash(), call2->structuralHash());
+    EXPECT_NE(call1->structuralHash(), call3->structuralHash());
+    // and equiv, which consults the hash first, still answers correctly
+    EXPECT_TRUE(call1->equiv(*call2));
+    EXPECT_FALSE(call1->equiv(*call3));
+}
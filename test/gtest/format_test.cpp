@@ -55,6 +55,10 @@ TEST(Util, Format) {
     message = context.errorReporter().format_message("%1% %2%", x, 5);
     EXPECT_EQ("x 5\n", message);
 
+    // Placeholders may repeat and appear out of order; %% is a literal '%'.
+    message = context.errorReporter().format_message("%2%-%1%-%2% 100%%", "a", "b");
+    EXPECT_EQ("b-a-b 100%\n", message);
+
     message = Util::printf_format("Number=%d, String=%s", 5, "short");
     EXPECT_EQ("Number=5, String=short", message);
 }
@@ -0,0 +1,115 @@
+/*
+Copyright 2021-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "helpers.h"
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/actionsInlining.h"
+#include "frontends/p4/functionsInlining.h"
+#include "frontends/p4/typeMap.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+/// Counts what is left for the inliners to do in a program.
+class CountInlinable : public Inspector {
+ public:
+    unsigned callStatements = 0;
+    unsigned actionCalls = 0;  // call statements within action bodies
+    unsigned actions = 0;
+    unsigned functions = 0;
+    void postorder(const IR::MethodCallStatement*) override {
+        callStatements++;
+        if (findContext<IR::P4Action>() != nullptr)
+            actionCalls++;
+    }
+    void postorder(const IR::P4Action*) override { actions++; }
+    void postorder(const IR::Function*) override { functions++; }
+};
+
+}  // namespace
+
+class P4CInline : public P4CTest { };
+
+// A chain of nested action calls must be fully flattened by InlineActions,
+// which inlines the whole plan in a single traversal.
+TEST_F(P4CInline, ChainedActionCalls) {
+    std::string program = P4_SOURCE(R"(
+        control c(inout bit<8> x) {
+            action a1(in bit<8> v, out bit<8> r) { r = v + 1; }
+            action a2(in bit<8> v, out bit<8> r) { bit<8> t; a1(v, t); r = t + 1; }
+            action a3() { bit<8> t; a2(x, t); x = t; }
+            apply { a3(); }
+        }
+        control proto(inout bit<8> x);
+        package top(proto p);
+        top(c()) main;
+    )");
+    auto pgm = P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    TypeMap      typeMap;
+    InlineActions inliner(&refMap, &typeMap, /* bulk */ true);
+
+    pgm = pgm->apply(inliner);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    CountInlinable counter;
+    pgm->apply(counter);
+    // no action calls remain within actions; a1 and a2 are now unused and
+    // removed; the call of a3 from the apply block is left alone
+    EXPECT_EQ(0u, counter.actionCalls);
+    EXPECT_EQ(1u, counter.actions);
+    EXPECT_EQ(1u, counter.callStatements);
+}
+
+// A chain of nested function calls must be fully flattened by
+// InlineFunctions.
+TEST_F(P4CInline, ChainedFunctionCalls) {
+    std::string program = P4_SOURCE(R"(
+        void f1(inout bit<8> v) { v = v + 1; }
+        void f2(inout bit<8> v) { f1(v); f1(v); }
+        control c(inout bit<8> x) {
+            apply { f2(x); }
+        }
+        control proto(inout bit<8> x);
+        package top(proto p);
+        top(c()) main;
+    )");
+    auto pgm = P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    TypeMap      typeMap;
+    InlineFunctions inliner(&refMap, &typeMap, /* bulk */ true);
+
+    pgm = pgm->apply(inliner);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    CountInlinable counter;
+    pgm->apply(counter);
+    EXPECT_EQ(0u, counter.callStatements);
+    EXPECT_EQ(0u, counter.functions);
+}
+
+}  // namespace Test
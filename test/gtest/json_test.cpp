@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <limits>
 #include <sstream>
 
 #include "gtest/gtest.h"
@@ -71,4 +72,63 @@ TEST(Util, Json) {
               obj->toString());
 }
 
+TEST(Util, JsonNumberFormat) {
+    // the stack-buffer fast path and the big_int fallback must agree with
+    // the stream representation at the boundaries
+    for (auto v : { big_int(0), big_int(-1),
+                    big_int(std::numeric_limits<long long>::min()),
+                    big_int(std::numeric_limits<unsigned long long>::max()),
+                    big_int(std::numeric_limits<long long>::min()) - 1,
+                    big_int(std::numeric_limits<unsigned long long>::max()) + 1,
+                    big_int(1) << 100, -(big_int(1) << 100) }) {
+        std::string appended;
+        appendJsonNumber(appended, v);
+        std::ostringstream written;
+        writeJsonNumber(written, v);
+        EXPECT_EQ(v.str(), appended);
+        EXPECT_EQ(v.str(), written.str());
+    }
+}
+
+TEST(Util, JsonCBORRoundTrip) {
+    auto obj = new JsonObject();
+    obj->emplace("name", "ingress.t\"bl");  // escaping is a JSON-text concern only
+    obj->emplace("id", 42);
+    obj->emplace("negative", -1);
+    obj->emplace("wide", big_int(1) << 100);
+    obj->emplace("negative_wide", new JsonValue(-(big_int(1) << 100)));
+    obj->emplace("boundary", std::numeric_limits<unsigned long long>::max());
+    obj->emplace("valid", true);
+    obj->emplace("miss", false);
+    obj->emplace("next", JsonValue::null);
+    auto arr = new JsonArray();
+    arr->append(1)->append("two")->append(new JsonArray());
+    obj->emplace("entries", arr);
+
+    std::stringstream buffer;
+    obj->serializeCBOR(buffer);
+    auto decoded = IJson::loadCBOR(buffer);
+    // same structure, same field order, so the same text rendering
+    EXPECT_EQ(obj->toString(), decoded->toString());
+
+    // the encoding is deterministic
+    std::stringstream again;
+    decoded->serializeCBOR(again);
+    EXPECT_EQ(buffer.str(), again.str());
+}
+
+TEST(Util, JsonEscape) {
+    std::string out;
+    appendJsonEscaped(out, "plain text, no escapes needed here at all", 41);
+    EXPECT_EQ("plain text, no escapes needed here at all", out);
+
+    out.clear();
+    const char input[] = "say \"hi\\there\" and a longer clean tail afterwards";
+    appendJsonEscaped(out, input, sizeof(input) - 1);
+    EXPECT_EQ("say \\\"hi\\\\there\\\" and a longer clean tail afterwards", out);
+
+    EXPECT_EQ("a\\\"b", cstring("a\"b").escapeJson());
+    EXPECT_EQ("", cstring("").escapeJson());
+}
+
 }  // namespace Util
@@ -0,0 +1,80 @@
+/*
+Copyright 2021-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "helpers.h"
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeMap.h"
+#include "midend/local_copyprop.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+/// Counts what copy propagation should have eliminated.
+class CountResidue : public Inspector {
+ public:
+    unsigned declarations = 0;
+    unsigned assignments = 0;
+    void postorder(const IR::Declaration_Variable*) override { declarations++; }
+    void postorder(const IR::AssignmentStatement*) override { assignments++; }
+};
+
+}  // namespace
+
+class P4CCopyProp : public P4CTest { };
+
+// A chain of copies must be fully propagated and the intermediate
+// variables eliminated by a single LocalCopyPropagation, which iterates
+// to a fixed point internally (and must terminate doing so).
+TEST_F(P4CCopyProp, ChainedCopies) {
+    std::string program = P4_SOURCE(R"(
+        control c(inout bit<8> x) {
+            bit<8> a;
+            bit<8> b;
+            apply {
+                a = x + 1;
+                b = a;
+                x = b;
+            }
+        }
+        control proto(inout bit<8> x);
+        package top(proto p);
+        top(c()) main;
+    )");
+    auto pgm = P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    TypeMap      typeMap;
+    LocalCopyPropagation copyprop(&refMap, &typeMap);
+
+    pgm = pgm->apply(copyprop);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    CountResidue counter;
+    pgm->apply(counter);
+    // only x = x + 1 remains; a and b are propagated away
+    EXPECT_EQ(0u, counter.declarations);
+    EXPECT_EQ(1u, counter.assignments);
+}
+
+}  // namespace Test
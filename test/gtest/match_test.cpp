@@ -0,0 +1,64 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "lib/match.h"
+
+namespace {
+
+TEST(Match, SetAlgebra) {
+    match_t wild = match_t::dont_care(8);
+    match_t ten(8, 10, 0xff);       // exactly 10
+    match_t lowNibble(8, 0x00, 0xf0);  // high nibble zero
+
+    EXPECT_TRUE(wild.covers(ten));
+    EXPECT_FALSE(ten.covers(wild));
+    EXPECT_TRUE(lowNibble.covers(ten));
+    EXPECT_TRUE(lowNibble.overlaps(ten));
+    EXPECT_FALSE(ten.overlaps(match_t(8, 11, 0xff)));
+
+    auto both = lowNibble.intersect(ten);
+    EXPECT_FALSE(both.emptyWithin(8));
+    EXPECT_TRUE(both.matches(10));
+    EXPECT_FALSE(both.matches(11));
+
+    auto none = ten.intersect(match_t(8, 11, 0xff));
+    EXPECT_TRUE(none.emptyWithin(8));
+}
+
+TEST(Match, MatchSet) {
+    match_set_t set;
+    set.add(match_t(8, 1, 0xff));
+    set.add(match_t(8, 0x80, 0x80));   // high bit set
+    set.add(match_t::dont_care(8));
+
+    EXPECT_EQ(0, set.firstMatch(1));
+    EXPECT_EQ(1, set.firstMatch(0x81));
+    EXPECT_EQ(2, set.firstMatch(7));
+    EXPECT_TRUE(set.matches(0xff));
+
+    // the wildcard is reachable: values below 0x80 other than 1 fall through
+    EXPECT_FALSE(set.coveredBefore(set.patterns[2], 2));
+    // a pattern with the high bit set is subsumed by pattern 1
+    EXPECT_TRUE(set.coveredBefore(match_t(8, 0x83, 0xff), 2));
+    // the union of "high bit set" and "high bit clear" covers everything
+    match_set_t split;
+    split.add(match_t(8, 0x80, 0x80));
+    split.add(match_t(8, 0x00, 0x80));
+    EXPECT_TRUE(split.coveredBefore(match_t::dont_care(8), 2));
+}
+
+}  // namespace
@@ -23,6 +23,8 @@ limitations under the License.
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/typeMap.h"
 #include "midend/convertEnums.h"
+#include "midend/removeUnusedFields.h"
+#include "midend/replaceSelectRange.h"
 
 using namespace P4;
 
@@ -109,4 +111,91 @@ TEST_F(P4CMidend, getEnumMapping) {
     ASSERT_EQ(enumMap.size(), (unsigned long)1);
 }
 
+// the mask cover of a range must be minimal
+TEST_F(P4CMidend, replaceSelectRange_minimalCover) {
+    auto t = IR::Type_Bits::get(16);
+    DoReplaceSelectRange pass(100);
+
+    // an aligned range is a single mask: 0..1023 -> 0 &&& 0xFC00
+    auto r1 = new IR::Range(t, new IR::Constant(t, 0), new IR::Constant(t, 1023));
+    auto m1 = pass.rangeToMasks(r1);
+    ASSERT_EQ(m1.size(), (size_t)1);
+    EXPECT_EQ(m1.at(0)->left->to<IR::Constant>()->value, big_int(0));
+    EXPECT_EQ(m1.at(0)->right->to<IR::Constant>()->value, big_int(0xFC00));
+
+    // the full domain is a single don't-care mask
+    auto r2 = new IR::Range(t, new IR::Constant(t, 0), new IR::Constant(t, 65535));
+    auto m2 = pass.rangeToMasks(r2);
+    ASSERT_EQ(m2.size(), (size_t)1);
+    EXPECT_EQ(m2.at(0)->right->to<IR::Constant>()->value, big_int(0));
+
+    // 1024..65535 needs one mask per doubling block
+    auto r3 = new IR::Range(t, new IR::Constant(t, 1024), new IR::Constant(t, 65535));
+    auto m3 = pass.rangeToMasks(r3);
+    EXPECT_EQ(m3.size(), (size_t)6);
+
+    // 3..5 = {3} + {4,5}
+    auto r4 = new IR::Range(t, new IR::Constant(t, 3), new IR::Constant(t, 5));
+    auto m4 = pass.rangeToMasks(r4);
+    EXPECT_EQ(m4.size(), (size_t)2);
+}
+
+// a field that is never read disappears, along with the write to it
+TEST_F(P4CMidend, removeUnusedFields_prune) {
+    std::string program = P4_SOURCE(R"(
+        struct S { bit<8> a; bit<8> b; }
+        control c(inout S s) {
+            apply { s.b = s.a; }
+        }
+    )");
+    auto pgm = P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap  refMap;
+    TypeMap       typeMap;
+    PassManager passes = {
+        new P4::RemoveUnusedFields(&refMap, &typeMap)
+    };
+    pgm = pgm->apply(passes);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    const IR::Type_Struct* s = nullptr;
+    forAllMatching<IR::Type_Struct>(pgm,
+        [&](const IR::Type_Struct* t) { s = t; });
+    ASSERT_TRUE(s != nullptr);
+    ASSERT_EQ(s->fields.size(), (size_t)1);
+    EXPECT_EQ(s->fields.at(0)->name.name, "a");
+
+    unsigned assignments = 0;
+    forAllMatching<IR::AssignmentStatement>(pgm,
+        [&](const IR::AssignmentStatement*) { ++assignments; });
+    EXPECT_EQ(assignments, 0U);
+}
+
+// a struct copied as a whole value keeps its full field list
+TEST_F(P4CMidend, removeUnusedFields_wholeValueIsOpaque) {
+    std::string program = P4_SOURCE(R"(
+        struct S { bit<8> a; bit<8> b; }
+        control c(inout S s1, inout S s2) {
+            apply { s1 = s2; }
+        }
+    )");
+    auto pgm = P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap  refMap;
+    TypeMap       typeMap;
+    PassManager passes = {
+        new P4::RemoveUnusedFields(&refMap, &typeMap)
+    };
+    pgm = pgm->apply(passes);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    const IR::Type_Struct* s = nullptr;
+    forAllMatching<IR::Type_Struct>(pgm,
+        [&](const IR::Type_Struct* t) { s = t; });
+    ASSERT_TRUE(s != nullptr);
+    EXPECT_EQ(s->fields.size(), (size_t)2);
+}
+
 }  // namespace Test
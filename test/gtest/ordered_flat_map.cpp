@@ -0,0 +1,107 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lib/ordered_flat_map.h"
+
+namespace Test {
+
+TEST(ordered_flat_map, insertion_order) {
+    ordered_flat_map<unsigned, unsigned> m;
+
+    // enough insertions to force several rehashes
+    std::vector<unsigned> keys;
+    for (unsigned i = 0; i < 1000; i++) {
+        unsigned k = (i * 7919) % 5000;
+        if (!m.count(k)) keys.push_back(k);
+        m[k] = k + 1;
+    }
+
+    EXPECT_EQ(keys.size(), m.size());
+    size_t idx = 0;
+    for (auto &e : m) {
+        EXPECT_EQ(keys[idx], e.first);
+        EXPECT_EQ(keys[idx] + 1, e.second);
+        ++idx;
+    }
+}
+
+TEST(ordered_flat_map, find_erase) {
+    ordered_flat_map<unsigned, unsigned> m;
+
+    m[1] = 111;
+    m[2] = 222;
+    m[3] = 333;
+    m[4] = 444;
+
+    EXPECT_EQ(222u, m.at(2));
+    EXPECT_EQ(333u, get(m, 3u));
+    EXPECT_EQ(0u, get(m, 5u));
+    EXPECT_TRUE(m.find(5) == m.end());
+
+    EXPECT_EQ(1u, m.erase(2));
+    EXPECT_EQ(0u, m.erase(2));
+    EXPECT_EQ(3u, m.size());
+
+    // remaining elements keep their relative order
+    std::vector<unsigned> keys;
+    for (auto &e : m) keys.push_back(e.first);
+    EXPECT_EQ((std::vector<unsigned>{1, 3, 4}), keys);
+}
+
+TEST(ordered_flat_map, map_equal) {
+    ordered_flat_map<unsigned, unsigned> a;
+    ordered_flat_map<unsigned, unsigned> b;
+
+    EXPECT_TRUE(a == b);
+
+    a[1] = 111;
+    a[2] = 222;
+
+    b[1] = 111;
+    b[2] = 222;
+
+    EXPECT_TRUE(a == b);
+
+    // same contents, different insertion order
+    a[3] = 333;
+    a[4] = 444;
+    b[4] = 444;
+    b[3] = 333;
+
+    EXPECT_TRUE(a != b);
+
+    a.clear();
+    b.clear();
+
+    EXPECT_TRUE(a == b);
+}
+
+TEST(ordered_flat_map, pointer_keys) {
+    unsigned x = 0, y = 0;
+    ordered_flat_map<const unsigned *, unsigned> m;
+
+    m[&x] = 1;
+    m[&y] = 2;
+
+    EXPECT_EQ(1u, m.at(&x));
+    EXPECT_EQ(&x, m.begin()->first);
+    EXPECT_EQ(nullptr, getref(m, static_cast<const unsigned *>(nullptr)));
+}
+
+}  // namespace Test
@@ -0,0 +1,104 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/pattern.h"
+
+namespace Test {
+
+class PatternTest : public P4CTest { };
+
+TEST_F(PatternTest, Nested) {
+    auto c = new IR::Constant(4);
+    auto v = new IR::PathExpression("v");
+    const IR::Expression* e = new IR::Add(new IR::Mul(v, c), new IR::Constant(1));
+
+    Pattern::Match<IR::Expression> a;
+    Pattern::Match<IR::Constant> k;
+    EXPECT_TRUE(((a * k) + 1).match(e));
+    EXPECT_EQ(v, (const IR::Expression*)a);
+    EXPECT_EQ(c, (const IR::Constant*)k);
+    EXPECT_FALSE(((a * k) + 2).match(e));
+}
+
+TEST_F(PatternTest, Commutative) {
+    auto c = new IR::Constant(4);
+    auto v = new IR::PathExpression("v");
+
+    // Mul is commutative: the constant matches on either side
+    Pattern::Match<IR::Expression> a;
+    EXPECT_TRUE((a * 4).match(new IR::Mul(v, c)));
+    EXPECT_EQ(v, (const IR::Expression*)a);
+    EXPECT_TRUE((a * 4).match(new IR::Mul(c, v)));
+    EXPECT_EQ(v, (const IR::Expression*)a);
+
+    // Sub is not
+    EXPECT_TRUE((a - 4).match(new IR::Sub(v, c)));
+    EXPECT_FALSE((a - 4).match(new IR::Sub(c, v)));
+}
+
+TEST_F(PatternTest, BoolLiteral) {
+    auto t = new IR::BoolLiteral(true);
+    auto v = new IR::PathExpression("v");
+
+    Pattern::Match<IR::Expression> a;
+    EXPECT_TRUE((a == true).match(new IR::Equ(v, t)));
+    EXPECT_EQ(v, (const IR::Expression*)a);
+    EXPECT_FALSE((a == false).match(new IR::Equ(v, t)));
+    // a bool pattern must not match an IR::Constant of the same value
+    EXPECT_FALSE((a == true).match(new IR::Equ(v, new IR::Constant(1))));
+}
+
+TEST_F(PatternTest, ConstantPredicate) {
+    auto v = new IR::PathExpression("v");
+    const IR::Constant* k = nullptr;
+    Pattern evenK(k, [](const IR::Constant* c) { return c->value % 2 == 0; });
+
+    // the predicate participates in matching, so the commutative retry
+    // can pick whichever side satisfies it
+    Pattern::Match<IR::Expression> a;
+    auto c6 = new IR::Constant(6);
+    EXPECT_TRUE((a & evenK).match(new IR::BAnd(new IR::Constant(3), c6)));
+    EXPECT_EQ(c6, k);
+    EXPECT_FALSE((a & evenK).match(new IR::BAnd(v, new IR::Constant(3))));
+}
+
+TEST_F(PatternTest, Table) {
+    PatternTable table({
+        {Pattern::any() + 0, [](const IR::Node* n) -> const IR::Node* {
+            return n->to<IR::Add>()->left; }},
+        {Pattern::any() == Pattern::any(), [](const IR::Node* n) -> const IR::Node* {
+            auto e = n->to<IR::Equ>();
+            // decline unless the operands are identical
+            if (e->left != e->right) return nullptr;
+            return new IR::BoolLiteral(true); }}});
+
+    auto v = new IR::PathExpression("v");
+    // dispatch picks the Add bucket and the pattern filters within it
+    EXPECT_EQ(v, table.apply(new IR::Add(v, new IR::Constant(0))));
+    EXPECT_EQ(nullptr, table.apply(new IR::Add(v, new IR::Constant(1))));
+    // no bucket for Sub at all
+    EXPECT_EQ(nullptr, table.apply(new IR::Sub(v, new IR::Constant(0))));
+    // a declined action falls through to "no match"
+    EXPECT_EQ(nullptr, table.apply(new IR::Equ(v, new IR::PathExpression("w"))));
+    auto result = table.apply(new IR::Equ(v, v));
+    ASSERT_TRUE(result != nullptr && result->is<IR::BoolLiteral>());
+    EXPECT_TRUE(result->to<IR::BoolLiteral>()->value);
+}
+
+}  // namespace Test
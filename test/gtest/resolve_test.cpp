@@ -0,0 +1,117 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/resolveReferences.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+/// Records the last PathExpression seen in each top-level control, by
+/// control name.
+class CollectPaths : public Inspector {
+ public:
+    std::map<cstring, const IR::PathExpression *> paths;
+    bool preorder(const IR::PathExpression *p) override {
+        if (auto *control = findContext<IR::P4Control>())
+            paths[control->name.name] = p;
+        return true;
+    }
+};
+
+/// Replaces every PathExpression inside control `c2` with a fresh node,
+/// leaving everything else shared with the input program.
+class ReplacePathInC2 : public Transform {
+    const IR::Node *postorder(IR::PathExpression *p) override {
+        auto *control = findOrigCtxt<IR::P4Control>();
+        if (control != nullptr && control->name == "c2")
+            return new IR::PathExpression(p->path->name);
+        return p;
+    }
+};
+
+/// Rewrites the initializer of the global constant `x`, replacing its
+/// declaration (and hence the program) while sharing all the controls.
+class RewriteConstant : public Transform {
+    const IR::Node *postorder(IR::Declaration_Constant *d) override {
+        if (d->name == "x")
+            d->initializer = new IR::Constant(IR::Type_Bits::get(8), 4);
+        return d;
+    }
+};
+
+}  // namespace
+
+class P4CResolve : public P4CTest { };
+
+TEST_F(P4CResolve, IncrementalResolveReferences) {
+    std::string source = P4_SOURCE(R"(
+        const bit<8> x = 3;
+        control c1() { apply { bit<8> y = x; } }
+        control c2() { apply { bit<8> z = x; } }
+    )");
+    auto *pgm = P4::parseP4String(source, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    ResolveReferences resolver(&refMap, /* checkShadow */ false, /* incremental */ true);
+    pgm->apply(resolver);
+    ASSERT_EQ(0u, ::errorCount());
+
+    CollectPaths before;
+    pgm->apply(before);
+    const auto *xdecl = refMap.getDeclaration(before.paths.at("c1")->path, true);
+
+    // Rewrite the reference inside c2; c1 and x are shared with the old
+    // program, so resolution should just patch the map.
+    const auto *pgm2 = pgm->apply(ReplacePathInC2())->to<IR::P4Program>();
+    ASSERT_TRUE(pgm2 != nullptr && pgm2 != pgm);
+    pgm2->apply(resolver);
+    ASSERT_EQ(0u, ::errorCount());
+
+    CollectPaths after;
+    pgm2->apply(after);
+    ASSERT_NE(before.paths.at("c2"), after.paths.at("c2"));
+    // The new reference resolves, the reference in the untouched control is
+    // undisturbed, and the entry for the discarded reference is still there:
+    // the map was patched, not rebuilt.
+    EXPECT_EQ(xdecl, refMap.getDeclaration(after.paths.at("c2")->path, true));
+    EXPECT_EQ(xdecl, refMap.getDeclaration(after.paths.at("c1")->path, true));
+    EXPECT_EQ(xdecl, refMap.getDeclaration(before.paths.at("c2")->path));
+
+    // Replace the declaration of x itself; the entries of the untouched
+    // controls must be patched to point to the new declaration.
+    const auto *pgm3 = pgm2->apply(RewriteConstant())->to<IR::P4Program>();
+    ASSERT_TRUE(pgm3 != nullptr && pgm3 != pgm2);
+    pgm3->apply(resolver);
+    ASSERT_EQ(0u, ::errorCount());
+
+    CollectPaths last;
+    pgm3->apply(last);
+    EXPECT_EQ(before.paths.at("c1"), last.paths.at("c1"));  // control untouched
+    const auto *newx = refMap.getDeclaration(last.paths.at("c1")->path, true);
+    EXPECT_NE(xdecl, newx);
+    EXPECT_EQ(cstring("x"), newx->getName().name);
+}
+
+}  // namespace Test
@@ -0,0 +1,87 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lib/small_vector.h"
+
+namespace Test {
+
+TEST(small_vector, push_and_grow) {
+    small_vector<int, 4> v;
+    EXPECT_TRUE(v.empty());
+    for (int i = 0; i < 100; i++)
+        v.push_back(i);
+    EXPECT_EQ((size_t)100, v.size());
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(i, v[i]);
+    EXPECT_EQ(0, v.front());
+    EXPECT_EQ(99, v.back());
+    EXPECT_THROW(v[100], std::out_of_range);
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(i, v.at_unchecked(i));
+}
+
+TEST(small_vector, insert_erase) {
+    small_vector<int, 4> v{1, 2, 3};
+    auto it = v.insert(v.begin() + 1, 9);
+    EXPECT_EQ(9, *it);
+    EXPECT_EQ((small_vector<int, 4>{1, 9, 2, 3}), v);
+
+    std::vector<int> more{7, 8};
+    v.insert(v.end(), more.begin(), more.end());  // forces a heap buffer
+    EXPECT_EQ((small_vector<int, 4>{1, 9, 2, 3, 7, 8}), v);
+
+    it = v.erase(v.begin() + 1);
+    EXPECT_EQ(2, *it);
+    v.erase(v.begin() + 2, v.end());
+    EXPECT_EQ((small_vector<int, 4>{1, 2}), v);
+
+    v.insert(v.begin(), (size_t)3, 0);
+    EXPECT_EQ((small_vector<int, 4>{0, 0, 0, 1, 2}), v);
+}
+
+TEST(small_vector, copy_and_move) {
+    small_vector<int, 2> inl{1, 2};
+    small_vector<int, 2> big{1, 2, 3, 4, 5};
+
+    small_vector<int, 2> a(inl);
+    EXPECT_EQ(inl, a);
+    small_vector<int, 2> b(big);
+    EXPECT_EQ(big, b);
+
+    small_vector<int, 2> c(std::move(a));
+    EXPECT_EQ(inl, c);
+    small_vector<int, 2> d(std::move(b));
+    EXPECT_EQ(big, d);
+    EXPECT_TRUE(b.empty());
+
+    c = d;
+    EXPECT_EQ(big, c);
+    d = small_vector<int, 2>{9};
+    EXPECT_EQ((small_vector<int, 2>{9}), d);
+}
+
+TEST(small_vector, push_back_aliasing) {
+    small_vector<int, 2> v{1, 2};
+    // push_back of an element of the vector itself must survive the
+    // reallocation off the inline buffer
+    v.push_back(v[0]);
+    EXPECT_EQ((small_vector<int, 2>{1, 2, 1}), v);
+}
+
+}  // namespace Test
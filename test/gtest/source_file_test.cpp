@@ -97,4 +97,33 @@ TEST(UtilSourceFile, SourceInfo) {
     EXPECT_FALSE(invalid.isValid());
 }
 
+TEST(UtilSourceFile, CompressedSourceInfo) {
+    Util::InputSources sources;
+
+    // the packed representation round-trips both positions
+    SourceInfo range(&sources, SourcePosition(10, 4), SourcePosition(12, 7));
+    EXPECT_EQ(10u, range.getStart().getLineNumber());
+    EXPECT_EQ(4u, range.getStart().getColumnNumber());
+    EXPECT_EQ(12u, range.getEnd().getLineNumber());
+    EXPECT_EQ(7u, range.getEnd().getColumnNumber());
+    EXPECT_FALSE(range.isDetached());
+
+    // positions beyond the packed field widths saturate instead of wrapping
+    SourceInfo huge(&sources, SourcePosition(0x900000, 5000));
+    EXPECT_TRUE(huge.isValid());
+    EXPECT_EQ(0x7FFFFFu, huge.getStart().getLineNumber());
+    EXPECT_EQ(0xFFFu, huge.getStart().getColumnNumber());
+
+    // detached positions (--fromJSON) keep their strings in a side table
+    SourceInfo detached("prog.p4", 42, 3, "x = y;");
+    EXPECT_FALSE(detached.isValid());
+    EXPECT_TRUE(detached.isDetached());
+    EXPECT_EQ("prog.p4", detached.detachedFilename());
+    EXPECT_EQ(42, detached.detachedLine());
+    EXPECT_EQ(3, detached.detachedColumn());
+    EXPECT_EQ("x = y;", detached.detachedFragment());
+    SourceInfo copy = detached;
+    EXPECT_EQ("prog.p4", copy.detachedFilename());
+}
+
 }  // namespace Util
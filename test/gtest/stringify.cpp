@@ -63,4 +63,29 @@ TEST(stringify, printf_empty) {
     EXPECT_EQ(str, "");
 }
 
+TEST(stringify, bigIntToString) {
+    // the cached tiny constants and the machine-word fast path
+    EXPECT_EQ(Util::toString(big_int(0), 0, false), "0");
+    EXPECT_EQ(Util::toString(big_int(255), 0, false), "255");
+    EXPECT_EQ(Util::toString(big_int(256), 0, false), "256");
+    EXPECT_EQ(Util::toString(big_int(-255), 0, false), "-255");
+    EXPECT_EQ(Util::toString(big_int(10), 8, true, 16), "8s0xa");
+    EXPECT_EQ(Util::toString(big_int(5), 3, false, 2), "3w0b101");
+
+    // chunked conversion of values wider than a machine word, around the
+    // chunk boundaries in every base
+    EXPECT_EQ(Util::toString(big_int("18446744073709551616"), 0, false),
+              "18446744073709551616");  // 2^64
+    EXPECT_EQ(Util::toString(big_int("100000000000000000000000000000000000000"), 0, false),
+              "100000000000000000000000000000000000000");  // 10^38
+    EXPECT_EQ(Util::toString((big_int(1) << 128) - 1, 0, false, 16),
+              "0xffffffffffffffffffffffffffffffff");
+    EXPECT_EQ(Util::toString(big_int(1) << 128, 0, false, 16),
+              "0x100000000000000000000000000000000");
+    EXPECT_EQ(Util::toString(big_int(1) << 65, 0, false, 2),
+              cstring("0b1" + std::string(65, '0')));
+    EXPECT_EQ(Util::toString((big_int(1) << 66) - 1, 0, false, 8),
+              cstring("0o" + std::string(22, '7')));
+}
+
 }  // namespace Test
@@ -0,0 +1,85 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lib/threadpool.h"
+
+namespace Util {
+
+TEST(ThreadPool, FutureResults) {
+    auto& pool = ThreadPool::instance();
+    EXPECT_GE(pool.workerCount(), 1u);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; i++)
+        results.push_back(pool.enqueue([i]() { return i * i; }));
+    int sum = 0;
+    for (auto& result : results)
+        sum += result.get();
+    EXPECT_EQ(328350, sum);  // sum of squares below 100
+}
+
+TEST(ThreadPool, FuturePropagatesException) {
+    auto failed = ThreadPool::instance().enqueue(
+        []() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, ParallelForEach) {
+    std::vector<int> input(10000);
+    for (size_t i = 0; i < input.size(); i++)
+        input[i] = int(i);
+    std::vector<std::atomic<int>> visits(input.size());
+    for (auto& v : visits)
+        v = 0;
+    std::atomic<long> sum(0);
+    parallel_for_each(input, [&](int value) {
+        visits[value]++;
+        sum += value;
+    });
+    // Every element was visited exactly once.
+    for (auto& v : visits)
+        EXPECT_EQ(1, v.load());
+    EXPECT_EQ(long(input.size()) * (long(input.size()) - 1) / 2, sum.load());
+}
+
+TEST(ThreadPool, ForEachPropagatesException) {
+    std::vector<int> input(100);
+    for (size_t i = 0; i < input.size(); i++)
+        input[i] = int(i);
+    EXPECT_THROW(
+        parallel_for_each(input, [](int value) {
+            if (value == 42) throw std::runtime_error("boom");
+        }),
+        std::runtime_error);
+}
+
+TEST(ThreadPool, NestedForEach) {
+    // A task may itself run a parallel loop: the waiting lane helps with
+    // queued work instead of blocking, so this must not deadlock.
+    std::vector<int> outer(8);
+    std::vector<int> inner(64);
+    std::atomic<int> count(0);
+    parallel_for_each(outer, [&](int) {
+        parallel_for_each(inner, [&](int) { count++; });
+    });
+    EXPECT_EQ(8 * 64, count.load());
+}
+
+}  // namespace Util
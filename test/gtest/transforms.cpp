@@ -17,6 +17,7 @@ limitations under the License.
 #include "gtest/gtest.h"
 #include "helpers.h"
 #include "ir/ir.h"
+#include "ir/pass_manager.h"
 #include "ir/visitor.h"
 #include "lib/source_file.h"
 
@@ -43,4 +44,78 @@ TEST_F(P4C_IR, Transform) {
     EXPECT_EQ(e, n);
 }
 
+TEST_F(P4C_IR, CheckpointRestore) {
+    struct Counter : public ICheckpointable {
+        int value = 0;
+        std::function<void()> checkpoint() override {
+            int saved = value;
+            return [this, saved]() { value = saved; };
+        }
+    };
+
+    Counter counter;
+    PassManager pm;
+    pm.addCheckpointable(&counter);
+
+    auto c = new IR::Constant(2);
+    const IR::Node* program = new IR::Add(Util::SourceInfo(), c, c);
+    counter.value = 1;
+    auto cp = pm.checkpoint(program);
+    EXPECT_TRUE(cp);
+    EXPECT_EQ(program, cp.program());
+
+    // a trial run builds new IR and mutates the side state...
+    counter.value = 42;
+    // ...and restoring rolls the side state back and hands back the
+    // checkpointed program
+    EXPECT_EQ(program, pm.restore(cp));
+    EXPECT_EQ(1, counter.value);
+
+    // the same checkpoint can back several retries
+    counter.value = 7;
+    EXPECT_EQ(program, pm.restore(cp));
+    EXPECT_EQ(1, counter.value);
+
+    Checkpoint empty;
+    EXPECT_FALSE(empty);
+}
+
+TEST_F(P4C_IR, IterativeInspector) {
+    // records every callback with the context depth so the explicit-stack
+    // engine can be compared event-for-event against the recursive one
+    struct Trace : public Inspector {
+        explicit Trace(bool iterative) { iterativeTraversal = iterative; }
+        std::vector<std::pair<const IR::Node*, int>> events;
+        bool preorder(const IR::Node* n) override {
+            events.emplace_back(n, getContext()->depth);
+            return !n->is<IR::Mul>();  // also check pruning
+        }
+        void postorder(const IR::Node* n) override {
+            events.emplace_back(n, -getContext()->depth);
+        }
+    };
+
+    auto* c = new IR::Constant(2);
+    auto* d = new IR::Constant(3);
+    const IR::Expression* e = new IR::Add(Util::SourceInfo(), c, d);
+    e = new IR::Sub(Util::SourceInfo(), e, new IR::Mul(Util::SourceInfo(), c, c));
+
+    Trace recursive(false), iterative(true);
+    e->apply(recursive);
+    e->apply(iterative);
+    EXPECT_EQ(recursive.events, iterative.events);
+
+    // a chain much too deep for one C++ call frame per node
+    const IR::Expression* deep = c;
+    for (int i = 0; i < 50000; ++i)
+        deep = new IR::Neg(Util::SourceInfo(), deep);
+    struct Count : public Inspector {
+        Count() { iterativeTraversal = true; }
+        int negs = 0;
+        bool preorder(const IR::Neg*) override { ++negs; return true; }
+    } count;
+    deep->apply(count);
+    EXPECT_EQ(50000, count.negs);
+}
+
 }  // namespace Test
@@ -0,0 +1,78 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lib/enumerator.h"
+#include "lib/view.h"
+
+namespace Util {
+
+class UtilView : public ::testing::Test {
+ protected:
+    std::vector<int> vec{ 1, 2, 3, 4, 5 };
+};
+
+TEST_F(UtilView, Filter) {
+    std::vector<int> result;
+    for (auto v : Views::filter(vec, [](int v) { return v % 2 == 0; }))
+        result.push_back(v);
+    EXPECT_EQ(std::vector<int>({ 2, 4 }), result);
+
+    for (auto v : Views::filter(vec, [](int) { return false; }))
+        FAIL() << "empty filter produced " << v;
+}
+
+TEST_F(UtilView, Map) {
+    std::vector<int> result;
+    for (auto v : Views::map(vec, [](int v) { return v * 10; }))
+        result.push_back(v);
+    EXPECT_EQ(std::vector<int>({ 10, 20, 30, 40, 50 }), result);
+}
+
+TEST_F(UtilView, Concat) {
+    std::vector<int> other{ 7, 8 };
+    std::vector<int> result;
+    for (auto v : Views::concat(vec, other))
+        result.push_back(v);
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3, 4, 5, 7, 8 }), result);
+
+    std::vector<int> none;
+    result.clear();
+    for (auto v : Views::concat(none, other))
+        result.push_back(v);
+    EXPECT_EQ(std::vector<int>({ 7, 8 }), result);
+}
+
+TEST_F(UtilView, Compose) {
+    std::vector<int> result;
+    for (auto v : Views::map(Views::filter(vec, [](int v) { return v > 2; }),
+                             [](int v) { return v + 1; }))
+        result.push_back(v);
+    EXPECT_EQ(std::vector<int>({ 4, 5, 6 }), result);
+}
+
+TEST_F(UtilView, OverEnumerator) {
+    // views follow the single-pass EnumeratorHandle iteration convention
+    auto* enumerator = Enumerator<int>::createEnumerator(vec);
+    std::vector<int> result;
+    for (auto v : Views::filter(*enumerator, [](int v) { return v != 3; }))
+        result.push_back(v);
+    EXPECT_EQ(std::vector<int>({ 1, 2, 4, 5 }), result);
+}
+
+}  // namespace Util
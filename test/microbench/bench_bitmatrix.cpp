@@ -0,0 +1,63 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/densebitmatrix.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+const unsigned dim = 512;  // rows; big enough that closure dominates setup
+
+DenseBitMatrix sparseGraph(unsigned seed) {
+    DenseBitMatrix m(dim);
+    uint32_t x = seed;
+    for (unsigned e = 0; e < dim * 4; e++) {
+        x = x * 1664525 + 1013904223;
+        m.set((x >> 8) % dim, (x >> 20) % dim); }
+    return m;
+}
+
+void bitmatrixClosure(MicroBench::State& state) {
+    DenseBitMatrix base = sparseGraph(12345);
+    while (state.keepRunning()) {
+        DenseBitMatrix m = base;
+        m.closure();
+        MicroBench::keep(m(0, dim - 1));
+    }
+}
+MICROBENCH(bitmatrixClosure);
+
+void bitmatrixMakeSymmetric(MicroBench::State& state) {
+    DenseBitMatrix base = sparseGraph(54321);
+    while (state.keepRunning()) {
+        DenseBitMatrix m = base;
+        m.make_symmetric();
+        MicroBench::keep(m.empty());
+    }
+}
+MICROBENCH(bitmatrixMakeSymmetric);
+
+void bitmatrixOrRow(MicroBench::State& state) {
+    DenseBitMatrix m = sparseGraph(999);
+    unsigned i = 0;
+    while (state.keepRunning()) {
+        MicroBench::keep(m.or_row(i % dim, (i + 7) % dim));
+        ++i;
+    }
+}
+MICROBENCH(bitmatrixOrRow);
+
+}  // namespace
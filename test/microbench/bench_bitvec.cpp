@@ -0,0 +1,88 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/bitvec.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+const size_t width = 4096;  // bits per vector; large enough to be multi-word
+
+bitvec sparse(size_t stride) {
+    bitvec bv;
+    for (size_t i = 0; i < width; i += stride)
+        bv.setbit(i);
+    return bv;
+}
+
+void bitvecSetClear(MicroBench::State& state) {
+    bitvec bv;
+    uint64_t i = 0;
+    while (state.keepRunning()) {
+        size_t idx = i++ % width;
+        bv.setbit(idx);
+        MicroBench::keep(bv.clrbit(idx));
+    }
+}
+MICROBENCH(bitvecSetClear);
+
+void bitvecGetbit(MicroBench::State& state) {
+    bitvec bv = sparse(3);
+    uint64_t i = 0;
+    while (state.keepRunning())
+        MicroBench::keep(bv.getbit(i++ % width));
+}
+MICROBENCH(bitvecGetbit);
+
+void bitvecUnion(MicroBench::State& state) {
+    bitvec a = sparse(2), b = sparse(3);
+    while (state.keepRunning()) {
+        bitvec c = a;
+        MicroBench::keep(c |= b);
+    }
+}
+MICROBENCH(bitvecUnion);
+
+void bitvecIntersect(MicroBench::State& state) {
+    bitvec a = sparse(2), b = sparse(3);
+    while (state.keepRunning()) {
+        bitvec c = a;
+        MicroBench::keep(c &= b);
+    }
+}
+MICROBENCH(bitvecIntersect);
+
+void bitvecPopcount(MicroBench::State& state) {
+    bitvec bv = sparse(3);
+    while (state.keepRunning())
+        MicroBench::keep(bv.popcount());
+}
+MICROBENCH(bitvecPopcount);
+
+// Iteration over the set bits, the pattern used all over the midend for
+// walking live sets.
+void bitvecIterateSetBits(MicroBench::State& state) {
+    bitvec bv = sparse(7);
+    while (state.keepRunning()) {
+        size_t sum = 0;
+        for (auto bit : bv)
+            sum += bit;
+        MicroBench::keep(sum);
+    }
+}
+MICROBENCH(bitvecIterateSetBits);
+
+}  // namespace
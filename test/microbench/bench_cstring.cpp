@@ -0,0 +1,63 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "lib/cstring.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+// Interning strings the cache has never seen: measures the cache insert
+// and the copy of the text.
+void cstringInternNew(MicroBench::State& state) {
+    static uint64_t salt = 0;  // distinct strings across calibration reruns
+    char buf[32];
+    while (state.keepRunning()) {
+        snprintf(buf, sizeof(buf), "mb-new-%llu", static_cast<unsigned long long>(++salt));
+        MicroBench::keep(cstring(buf).c_str());
+    }
+}
+MICROBENCH(cstringInternNew);
+
+// Re-interning strings already in the cache: the common case when the
+// same identifiers keep coming back from different char buffers.
+void cstringInternExisting(MicroBench::State& state) {
+    std::vector<std::string> texts;
+    for (int i = 0; i < 512; i++) {
+        texts.push_back("mb-existing-" + std::to_string(i));
+        cstring dummy(texts.back().c_str());  // warm the cache
+        MicroBench::keep(dummy.c_str());
+    }
+    uint64_t i = 0;
+    while (state.keepRunning())
+        MicroBench::keep(cstring(texts[i++ & 511].c_str()).c_str());
+}
+MICROBENCH(cstringInternExisting);
+
+// Equality of interned strings is a pointer comparison.
+void cstringCompareInterned(MicroBench::State& state) {
+    cstring a("mb-compare-interned");
+    cstring b(std::string("mb-compare-interned"));
+    while (state.keepRunning())
+        MicroBench::keep(a == b);
+}
+MICROBENCH(cstringCompareInterned);
+
+}  // namespace
@@ -0,0 +1,71 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "lib/enumerator.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+std::vector<int> makeData() {
+    std::vector<int> data;
+    for (int i = 0; i < 1024; i++)
+        data.push_back(i);
+    return data;
+}
+
+// One iteration drains a plain vector enumerator, including its
+// construction; this is how getDeclarations() and friends are consumed.
+void enumeratorDrain(MicroBench::State& state) {
+    auto data = makeData();
+    while (state.keepRunning()) {
+        int sum = 0;
+        for (auto v : *Util::Enumerator<int>::createEnumerator(data))
+            sum += v;
+        MicroBench::keep(sum);
+    }
+}
+MICROBENCH(enumeratorDrain);
+
+// One iteration runs a where/map pipeline to completion.
+void enumeratorWhereMap(MicroBench::State& state) {
+    auto data = makeData();
+    while (state.keepRunning()) {
+        auto* pipeline = Util::Enumerator<int>::createEnumerator(data)
+            ->where([](const int& v) { return (v & 1) == 0; })
+            ->map<int>([](const int& v) { return v * 2; });
+        int sum = 0;
+        for (auto v : *pipeline)
+            sum += v;
+        MicroBench::keep(sum);
+    }
+}
+MICROBENCH(enumeratorWhereMap);
+
+// One iteration materializes a filtered pipeline into a vector.
+void enumeratorToVector(MicroBench::State& state) {
+    auto data = makeData();
+    while (state.keepRunning()) {
+        auto* result = Util::Enumerator<int>::createEnumerator(data)
+            ->where([](const int& v) { return (v & 3) == 0; })
+            ->toVector();
+        MicroBench::keep(result->size());
+    }
+}
+MICROBENCH(enumeratorToVector);
+
+}  // namespace
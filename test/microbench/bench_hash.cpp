@@ -0,0 +1,75 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+
+#include "lib/hash.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+std::string makeBuffer(size_t size) {
+    std::string buf;
+    for (size_t i = 0; i < size; i++)
+        buf += char('a' + i % 26);
+    return buf;
+}
+
+// Identifier-sized input, the common case when hashing names.
+void hashMurmurShort(MicroBench::State& state) {
+    std::string buf = makeBuffer(16);
+    while (state.keepRunning())
+        MicroBench::keep(Util::Hash::murmur(buf.data(), buf.size()));
+}
+MICROBENCH(hashMurmurShort);
+
+// Source-fragment-sized input.
+void hashMurmurLong(MicroBench::State& state) {
+    std::string buf = makeBuffer(4096);
+    while (state.keepRunning())
+        MicroBench::keep(Util::Hash::murmur(buf.data(), buf.size()));
+}
+MICROBENCH(hashMurmurLong);
+
+void hashWyShort(MicroBench::State& state) {
+    std::string buf = makeBuffer(16);
+    while (state.keepRunning())
+        MicroBench::keep(Util::Hash::hash(buf.data(), buf.size()));
+}
+MICROBENCH(hashWyShort);
+
+void hashWyLong(MicroBench::State& state) {
+    std::string buf = makeBuffer(4096);
+    while (state.keepRunning())
+        MicroBench::keep(Util::Hash::hash(buf.data(), buf.size()));
+}
+MICROBENCH(hashWyLong);
+
+void hashFnv1aShort(MicroBench::State& state) {
+    std::string buf = makeBuffer(16);
+    while (state.keepRunning())
+        MicroBench::keep(Util::Hash::fnv1a(buf.data(), buf.size()));
+}
+MICROBENCH(hashFnv1aShort);
+
+void hashFnv1aLong(MicroBench::State& state) {
+    std::string buf = makeBuffer(4096);
+    while (state.keepRunning())
+        MicroBench::keep(Util::Hash::fnv1a(buf.data(), buf.size()));
+}
+MICROBENCH(hashFnv1aLong);
+
+}  // namespace
@@ -0,0 +1,75 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <sstream>
+
+#include "lib/json.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+// serializing numbers and strings dominates JSON output time; these
+// exercise the two helpers behind both IJson::serialize and the bmv2
+// streaming emitter
+
+void jsonAppendNumber(MicroBench::State& state) {
+    big_int v = 1234567890123;
+    std::string out;
+    while (state.keepRunning()) {
+        out.clear();
+        Util::appendJsonNumber(out, v);
+        MicroBench::keep(out.size());
+    }
+}
+MICROBENCH(jsonAppendNumber);
+
+void jsonSerializeNumbers(MicroBench::State& state) {
+    auto* arr = new Util::JsonArray();
+    for (int i = 0; i < 256; i++)
+        arr->append(i * 976543);
+    while (state.keepRunning()) {
+        std::ostringstream out;
+        arr->serialize(out);
+        MicroBench::keep(out.str().size());
+    }
+}
+MICROBENCH(jsonSerializeNumbers);
+
+void jsonEscapeClean(MicroBench::State& state) {
+    std::string in(512, 'x');
+    std::string out;
+    while (state.keepRunning()) {
+        out.clear();
+        Util::appendJsonEscaped(out, in.data(), in.size());
+        MicroBench::keep(out.size());
+    }
+}
+MICROBENCH(jsonEscapeClean);
+
+void jsonEscapeDense(MicroBench::State& state) {
+    std::string in;
+    for (int i = 0; i < 64; i++)
+        in += "some \"quoted\" text\\";
+    std::string out;
+    while (state.keepRunning()) {
+        out.clear();
+        Util::appendJsonEscaped(out, in.data(), in.size());
+        MicroBench::keep(out.size());
+    }
+}
+MICROBENCH(jsonEscapeDense);
+
+}  // namespace
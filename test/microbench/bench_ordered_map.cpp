@@ -0,0 +1,74 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+
+#include "lib/cstring.h"
+#include "lib/ordered_map.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+const int entries = 1024;
+
+std::vector<cstring> makeKeys() {
+    std::vector<cstring> keys;
+    for (int i = 0; i < entries; i++)
+        keys.push_back(cstring("mb-map-key-" + std::to_string(i)));
+    return keys;
+}
+
+// One iteration builds a complete map, the way visitors accumulate
+// per-node tables.
+void orderedMapBuild(MicroBench::State& state) {
+    auto keys = makeKeys();
+    while (state.keepRunning()) {
+        ordered_map<cstring, int> map;
+        for (int i = 0; i < entries; i++)
+            map.emplace(keys[i], i);
+        MicroBench::keep(map.size());
+    }
+}
+MICROBENCH(orderedMapBuild);
+
+void orderedMapLookup(MicroBench::State& state) {
+    auto keys = makeKeys();
+    ordered_map<cstring, int> map;
+    for (int i = 0; i < entries; i++)
+        map.emplace(keys[i], i);
+    uint64_t i = 0;
+    while (state.keepRunning())
+        MicroBench::keep(map.find(keys[i++ % entries]));
+}
+MICROBENCH(orderedMapLookup);
+
+// One iteration walks the whole map in insertion order.
+void orderedMapIterate(MicroBench::State& state) {
+    auto keys = makeKeys();
+    ordered_map<cstring, int> map;
+    for (int i = 0; i < entries; i++)
+        map.emplace(keys[i], i);
+    while (state.keepRunning()) {
+        int sum = 0;
+        for (auto& kv : map)
+            sum += kv.second;
+        MicroBench::keep(sum);
+    }
+}
+MICROBENCH(orderedMapIterate);
+
+}  // namespace
@@ -0,0 +1,73 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+
+#include "lib/cstring.h"
+#include "lib/ordered_set.h"
+#include "test/microbench/microbench.h"
+
+namespace {
+
+const int entries = 1024;
+
+std::vector<cstring> makeElems() {
+    std::vector<cstring> elems;
+    for (int i = 0; i < entries; i++)
+        elems.push_back(cstring("mb-set-elem-" + std::to_string(i)));
+    return elems;
+}
+
+// One iteration builds a complete set.
+void orderedSetBuild(MicroBench::State& state) {
+    auto elems = makeElems();
+    while (state.keepRunning()) {
+        ordered_set<cstring> set;
+        for (auto& e : elems)
+            set.insert(e);
+        MicroBench::keep(set.size());
+    }
+}
+MICROBENCH(orderedSetBuild);
+
+void orderedSetLookup(MicroBench::State& state) {
+    auto elems = makeElems();
+    ordered_set<cstring> set;
+    for (auto& e : elems)
+        set.insert(e);
+    uint64_t i = 0;
+    while (state.keepRunning())
+        MicroBench::keep(set.count(elems[i++ % entries]));
+}
+MICROBENCH(orderedSetLookup);
+
+// One iteration walks the whole set in insertion order.
+void orderedSetIterate(MicroBench::State& state) {
+    auto elems = makeElems();
+    ordered_set<cstring> set;
+    for (auto& e : elems)
+        set.insert(e);
+    while (state.keepRunning()) {
+        size_t total = 0;
+        for (auto& e : set)
+            total += e.size();
+        MicroBench::keep(total);
+    }
+}
+MICROBENCH(orderedSetIterate);
+
+}  // namespace
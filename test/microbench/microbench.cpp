@@ -0,0 +1,144 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "test/microbench/microbench.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "lib/compile_context.h"
+#include "lib/gc.h"
+
+namespace MicroBench {
+
+std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+int registerBenchmark(const char* name, BenchmarkFn fn) {
+    registry().push_back(Benchmark{name, fn});
+    return 0;
+}
+
+namespace {
+
+struct Result {
+    const char* name;
+    uint64_t iterations;
+    double seconds;
+    double nsPerOp() const { return seconds * 1e9 / iterations; }
+};
+
+double timedRun(const Benchmark& bench, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    State state(iterations);
+    bench.fn(state);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/// Run @bench for at least @minSeconds, growing the iteration count until
+/// the run is long enough to time reliably.
+Result run(const Benchmark& bench, double minSeconds) {
+    uint64_t iterations = 1;
+    double seconds = timedRun(bench, iterations);
+    while (seconds < minSeconds) {
+        double scale = seconds > 0 ? 1.4 * minSeconds / seconds : 16;
+        uint64_t next = uint64_t(iterations * scale);
+        iterations = std::max(next, iterations * 2);
+        seconds = timedRun(bench, iterations);
+    }
+    return Result{bench.name, iterations, seconds};
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    out << "{ \"benchmarks\" : [";
+    const char* sep = "\n";
+    for (auto& r : results) {
+        out << sep << "  { \"name\" : \"" << r.name << "\""
+            << ", \"iterations\" : " << r.iterations
+            << ", \"ns_per_op\" : " << r.nsPerOp()
+            << ", \"seconds\" : " << r.seconds << " }";
+        sep = ",\n";
+    }
+    out << "\n] }" << std::endl;
+}
+
+struct MicroBenchContext : BaseCompileContext {};
+
+}  // namespace
+
+}  // namespace MicroBench
+
+int main(int argc, char* const argv[]) {
+    setup_gc_logging();
+    AutoCompileContext autoContext(new MicroBench::MicroBenchContext);
+
+    const char* jsonFile = nullptr;
+    const char* filter = nullptr;
+    double minSeconds = 0.2;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+            jsonFile = argv[++i];
+        } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter substring] [--json file] [--min-time seconds]" << std::endl;
+            return 1;
+        }
+    }
+
+    auto benchmarks = MicroBench::registry();
+    std::sort(benchmarks.begin(), benchmarks.end(),
+              [](const MicroBench::Benchmark& a, const MicroBench::Benchmark& b) {
+                  return strcmp(a.name, b.name) < 0; });
+
+    std::vector<MicroBench::Result> results;
+    for (auto& bench : benchmarks) {
+        if (filter != nullptr && strstr(bench.name, filter) == nullptr)
+            continue;
+        auto result = MicroBench::run(bench, minSeconds);
+        printf("%-40s %12" PRIu64 " iterations %12.1f ns/op\n",
+               result.name, result.iterations, result.nsPerOp());
+        results.push_back(result);
+    }
+    if (results.empty()) {
+        std::cerr << "No benchmarks matched" << std::endl;
+        return 1;
+    }
+
+    if (jsonFile != nullptr) {
+        std::ofstream out(jsonFile);
+        if (!out) {
+            std::cerr << "Can't open " << jsonFile << std::endl;
+            return 1;
+        }
+        MicroBench::writeJson(out, results);
+    }
+    return 0;
+}
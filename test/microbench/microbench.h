@@ -0,0 +1,84 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef TEST_MICROBENCH_MICROBENCH_H_
+#define TEST_MICROBENCH_MICROBENCH_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+/**
+ * A minimal microbenchmark harness for the p4c-microbench target.
+ *
+ * The interface follows Google Benchmark's measured-loop idiom so that
+ * benchmark bodies could move there unchanged, but the harness itself is
+ * self-contained: the repository only vendors frameworks as submodules
+ * (see test/frameworks) and the benchmarks should build everywhere the
+ * compiler does.
+ *
+ *     static void bitvecUnion(MicroBench::State& state) {
+ *         bitvec a = ..., b = ...;
+ *         while (state.keepRunning())
+ *             MicroBench::keep(a |= b);
+ *     }
+ *     MICROBENCH(bitvecUnion);
+ *
+ * The runner calibrates the iteration count until a benchmark runs long
+ * enough to time reliably and reports nanoseconds per iteration; --json
+ * writes the results in a stable machine-readable form for trend tracking.
+ */
+namespace MicroBench {
+
+/// Hands the calibrated iteration count to a benchmark body; the measured
+/// region is exactly the keepRunning() loop.
+class State {
+    uint64_t limit;
+    uint64_t count = 0;
+
+ public:
+    explicit State(uint64_t limit) : limit(limit) {}
+    bool keepRunning() { return count++ < limit; }
+    uint64_t iterations() const { return limit; }
+};
+
+typedef void (*BenchmarkFn)(State&);
+
+struct Benchmark {
+    const char* name;
+    BenchmarkFn fn;
+};
+
+/// All registered benchmarks, in registration order.
+std::vector<Benchmark>& registry();
+
+/// Registers @fn under @name; returns 0 so it can initialize a static.
+int registerBenchmark(const char* name, BenchmarkFn fn);
+
+/// Forces @value to be computed and kept, so the measured loop body is not
+/// optimized away.
+template<typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace MicroBench
+
+#define MICROBENCH(fn) \
+    static int fn ## _registered __attribute__((unused)) = \
+        ::MicroBench::registerBenchmark(#fn, fn)
+
+#endif /* TEST_MICROBENCH_MICROBENCH_H_ */
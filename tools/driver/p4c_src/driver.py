@@ -46,6 +46,7 @@ class BackendDriver:
         self._source_filename = None
         self._source_basename = None
         self._verbose = False
+        self._preprocessor_opts_given = False
 
     def __str__(self):
         return self._backend
@@ -86,6 +87,7 @@ class BackendDriver:
         self._source_basename = os.path.splitext(os.path.basename(opts.source_file))[0]
 
         # set preprocessor options
+        self._preprocessor_opts_given = len(opts.preprocessor_options) > 0
         if 'preprocessor' in self._commands:
             for option in opts.preprocessor_options:
                 self.add_command_option('preprocessor', option)
@@ -265,6 +267,30 @@ class BackendDriver:
             # so that we do all the cleanup
         return rc # \TODO should we fail on this or not?
 
+    def skip_redundant_preprocessor(self):
+        """
+        The p4c-* binaries preprocess their input themselves (in process
+        when possible, otherwise streaming the output of a cpp subprocess
+        over a pipe), so when the compiler step runs anyway the separate
+        preprocessor step only repeats that work to leave behind the .p4i
+        intermediate.  Feed the compiler the original source and drop the
+        step.  -E alone still produces the .p4i, and explicit
+        -Xpreprocessor options keep the external step, since they cannot
+        be forwarded to the built-in preprocessor.
+        """
+        if 'preprocessor' not in self._commandsEnabled or \
+           'compiler' not in self._commandsEnabled or \
+           self._preprocessor_opts_given:
+            return
+        p4i = "{}/{}.p4i".format(self._output_directory, self._source_basename)
+        compiler = self._commands['compiler']
+        for i, arg in enumerate(compiler):
+            if arg == p4i:
+                compiler[i] = self._source_filename
+                # the cleaner step (where present) only removes the .p4i
+                self.disable_commands(['preprocessor', 'cleaner'])
+                return
+
     def run(self):
         """
         Run the set of commands required by this driver
@@ -274,6 +300,8 @@ class BackendDriver:
         if not os.path.exists(self._output_directory):
             os.makedirs(self._output_directory)
 
+        self.skip_redundant_preprocessor()
+
         for c in self._commandsEnabled:
 
             # run the setup for the command
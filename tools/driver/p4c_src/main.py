@@ -64,6 +64,29 @@ def add_developer_options(parser):
     parser.add_argument("--pp", dest="pretty_print", default=None,
                         help="Pretty-print the program in the specified file.")
 
+def schedule_compiles(source_files, jobs):
+    """Compile each source file in a separate driver process, running at
+    most `jobs` of them at a time -- like a make jobserver, with the tokens
+    local to this invocation.  The compiles are independent, so their only
+    interaction is the aggregated exit code."""
+    import subprocess
+    from concurrent.futures import ThreadPoolExecutor
+
+    if not jobs or jobs < 1:
+        jobs = min(len(source_files), os.cpu_count() or 1)
+    base_argv = [sys.executable, sys.argv[0]] + \
+                [a for a in sys.argv[1:] if a not in source_files]
+
+    def compile_one(source):
+        return subprocess.call(base_argv + [source])
+
+    rc = 0
+    with ThreadPoolExecutor(max_workers = jobs) as pool:
+        for code in pool.map(compile_one, source_files):
+            rc = rc or code
+    return rc
+
+
 def main():
     parser = argparse.ArgumentParser(conflict_handler='resolve')
     parser.add_argument("-V", "--version", dest="show_version",
@@ -157,11 +180,15 @@ def main():
     parser.add_argument("--ndebug", dest="ndebug_mode",
                         help="Compile program in non-debug mode.\n",
                         action="store_true", default=False)
+    parser.add_argument("-j", "--jobs", dest="jobs", type=int, default=None,
+                        metavar="N",
+                        help="When several source files are given, run up to "
+                        "N compiles in parallel (default: number of cores).")
 
     if (os.environ['P4C_BUILD_TYPE'] == "DEVELOPER"):
         add_developer_options(parser)
 
-    parser.add_argument("source_file", nargs='?', help="Files to compile", default=None)
+    parser.add_argument("source_file", nargs='*', help="Files to compile", default=[])
 
     # load supported configuration.
     # We load these before we parse options, so that backends can register
@@ -199,6 +226,13 @@ def main():
         print(display_supported_targets(cfg))
         sys.exit(0)
 
+    # Each source file is an independent compile; schedule them across the
+    # cores by re-invoking the driver once per file.  The rest of this
+    # function deals with a single source.
+    if len(opts.source_file) > 1:
+        sys.exit(schedule_compiles(opts.source_file, opts.jobs))
+    opts.source_file = opts.source_file[0] if opts.source_file else None
+
     # When using --help-* options, we don't necessarily need to pass an input file
     # However, by default the driver checks the input and fails if it does not exist.
     # Also, loading the backend configuration files requires a source file to be set,
@@ -31,6 +31,7 @@ void usage(const char* progname) {
     fprintf(stderr, "     -o file: file where the header code is written\n");
     fprintf(stderr, "     -i file: file where implementation code is written\n");
     fprintf(stderr, "     -t file: file where the tree macro is written\n");
+    fprintf(stderr, "     -s file: file where the static-dispatch visitor is written\n");
     fprintf(stderr, "     -h: print this message and exit\n");
     fprintf(stderr, "     -P: don't generate #line directives\n");
 }
@@ -39,9 +40,10 @@ int main(int argc, char* argv[]) {
     std::ostream *t = new nullstream();
     std::ostream *header = new nullstream();
     std::ostream *impl = new nullstream();
+    std::ostream *sv = new nullstream();
 
     while (true) {
-        int opt = getopt(argc, argv, "o:i:t:hP");
+        int opt = getopt(argc, argv, "o:i:t:s:hP");
         if (opt == -1)
             break;
 
@@ -61,6 +63,10 @@ int main(int argc, char* argv[]) {
                 t = openFile(optarg, false);
                 if (t == nullptr) return 1;
                 break;
+            case 's':
+                sv = openFile(optarg, false);
+                if (sv == nullptr) return 1;
+                break;
             case 'P':
                 LineDirective::inhibit = true;
                 break;
@@ -76,7 +82,7 @@ int main(int argc, char* argv[]) {
         return 1;
 
     defs->resolve();
-    defs->generate(*t, *header, *impl);
+    defs->generate(*t, *header, *impl, *sv);
     t->flush();
     return 0;
 }
@@ -14,6 +14,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <cstring>
+
 #include "irclass.h"
 #include "lib/exceptions.h"
 #include "lib/enumerator.h"
@@ -101,22 +104,27 @@ Util::Enumerator<IrClass*>* IrDefinitions::getClasses() const {
             ->where([] (IrClass* e) { return e != nullptr; });
 }
 
-void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &impl) const {
+void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &impl,
+                             std::ostream &sv) const {
     std::string macroname = "_IR_GENERATED_H_";
     out << "#ifndef " << macroname << "\n"
         << "#define " << macroname << "\n" << std::endl;
 
     impl << "#include \"ir/ir.h\"\n"
          << "#include \"ir/visitor.h\"\n"
-         << "#include \"ir/json_loader.h\"\n" << std::endl;
+         << "#include \"ir/json_loader.h\"\n"
+         << "#include \"ir/node-size-budget.h\"\n" << std::endl;
 
-    out << "#include <map>\n"
+    out << "#include <iosfwd>\n"
+        << "#include <map>\n"
         << "#include <functional>\n" << std::endl
         << "class JSONLoader;\n"
         << "using NodeFactoryFn = IR::Node*(*)(JSONLoader&);\n"
         << std::endl
         << "namespace IR {\n"
         << "extern std::map<cstring, NodeFactoryFn> unpacker_table;\n"
+        << "// print \"<class> <sizeof>\" for every concrete node class\n"
+        << "void dump_node_sizes(std::ostream &);\n"
         << "}\n";
 
     impl << "std::map<cstring, NodeFactoryFn> IR::unpacker_table = {\n";
@@ -138,6 +146,17 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         e->generate_hdr(out);
         e->generate_impl(impl); }
 
+    impl << "void IR::dump_node_sizes(std::ostream &out) {" << std::endl;
+    for (auto cls : *getClasses())
+        if (cls->kind == NodeKind::Concrete)
+            impl << "    out << \"IR::" << cls->containedIn << cls->name << " \" << sizeof(IR::"
+                 << cls->containedIn << cls->name << ") << '\\n';" << std::endl;
+    impl << "}" << std::endl << std::endl;
+    for (auto cls : *getClasses())
+        if (cls->kind == NodeKind::Concrete)
+            impl << "IRNODE_CHECK_SIZE(IR::" << cls->containedIn << cls->name << ")" << std::endl;
+    impl << std::endl;
+
     out << "#endif /* " << macroname << " */" << std::endl;
 
     ///////////////////////////////// tree
@@ -175,6 +194,129 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         exit_namespace(t, cls->containedIn);
     }
     t << "}  // namespace IR" << std::endl;
+
+    // must run after the header pass above, which is what marks the
+    // Vector/IndexedVector instantiations each class needs
+    generateStaticVisitor(sv);
+}
+
+void IrDefinitions::generateStaticVisitor(std::ostream &out) const {
+    std::string macroname = "_IR_GEN_STATIC_VISITOR_H_";
+    out << "#ifndef " << macroname << "\n"
+        << "#define " << macroname << "\n" << std::endl
+        << "#include <typeindex>\n"
+        << "#include <typeinfo>\n"
+        << "#include <unordered_map>\n" << std::endl
+        << "#include \"ir/ir.h\"\n"
+        << "#include \"ir/visitor.h\"\n" << std::endl
+        << "namespace IR {\n" << std::endl;
+
+    out <<
+"/** Read-only IR traversal with statically dispatched callbacks.\n"
+" *\n"
+" * A pass derives as `class MyPass : public StaticInspector<MyPass>` and\n"
+" * supplies `bool preorder(const IR::X *)` / `void postorder(const IR::X *)`\n"
+" * overloads (plus using-declarations pulling in the defaults below when it\n"
+" * overloads either name).  Callback selection happens by overload resolution\n"
+" * at compile time, which picks the overload for the nearest base class just\n"
+" * like the walk-up defaults of the virtual Inspector, and the per-class\n"
+" * children traversal is unrolled here at generation time, so the callbacks\n"
+" * and children iteration can all be inlined.  The only per-node runtime\n"
+" * dispatch left is one type lookup in visit().\n"
+" *\n"
+" * Semantics follow Inspector: a preorder returning false prunes the children\n"
+" * and the postorder, and nodes appearing more than once in the tree are\n"
+" * visited once unless visitDagOnce is cleared.  There is no visitor Context\n"
+" * and no revisit callback; passes needing those, or needing Modifier or\n"
+" * Transform semantics, still use the virtual visitors.  Classes with\n"
+" * hand-written visit_children bodies in the .def files are traversed through\n"
+" * that body via a forwarding Visitor, so their flow-ordering quirks are\n"
+" * preserved.\n"
+" */\n";
+    out << "template<class Self> class StaticInspector {" << std::endl
+        << " public:" << std::endl
+        << "    bool preorder(const Node *) { return true; }" << std::endl
+        << "    void postorder(const Node *) {}" << std::endl
+        << std::endl
+        << "    /// Visit the tree rooted at @root, resetting the visited-node filter" << std::endl
+        << "    /// so the inspector can be reused on another tree." << std::endl
+        << "    void apply(const Node *root) {" << std::endl
+        << "        visited = visited_t();" << std::endl
+        << "        visit(root); }" << std::endl
+        << std::endl
+        << "    void visit(const Node *n) {" << std::endl
+        << "        if (n == nullptr) return;" << std::endl
+        << "        if (visitDagOnce) {" << std::endl
+        << "            bool &seen = visited[n->id];" << std::endl
+        << "            if (seen) return;" << std::endl
+        << "            seen = true; }" << std::endl
+        << "        auto &table = dispatchTable();" << std::endl
+        << "        auto it = table.find(std::type_index(typeid(*n)));" << std::endl
+        << "        if (it == table.end())" << std::endl
+        << "            BUG(\"StaticInspector: unhandled node type %s\", "
+              "n->node_type_name());" << std::endl
+        << "        it->second(*this, n); }" << std::endl
+        << std::endl
+        << " protected:" << std::endl
+        << "    bool visitDagOnce = true;" << std::endl
+        << std::endl
+        << " private:" << std::endl
+        << "    Self &self() { return static_cast<Self &>(*this); }" << std::endl
+        << "    typedef NodeIdInfoMap<bool> visited_t;" << std::endl
+        << "    visited_t visited;" << std::endl
+        << std::endl
+        << "    class ChildForwarder : public Visitor {" << std::endl
+        << "        StaticInspector &self;" << std::endl
+        << "        const IR::Node *apply_visitor(const IR::Node *n, "
+              "const char * = 0) override {" << std::endl
+        << "            self.visit(n);" << std::endl
+        << "            return n; }" << std::endl
+        << "     public:" << std::endl
+        << "        explicit ChildForwarder(StaticInspector &s) : self(s) {}" << std::endl
+        << "    };" << std::endl
+        << std::endl
+        << "    void traverse_children(const Node *) {}" << std::endl
+        << "    template<class T> void traverse(const Vector<T> *n) {" << std::endl
+        << "        if (self().preorder(static_cast<const Node *>(n))) {" << std::endl
+        << "            for (auto &e : *n) visit(e);" << std::endl
+        << "            self().postorder(static_cast<const Node *>(n)); } }" << std::endl
+        << std::endl;
+
+    for (auto cls : *getClasses())
+        if (cls->kind != NodeKind::Interface && cls->kind != NodeKind::Nested &&
+            cls->kind != NodeKind::Template)
+            cls->generateStaticTraversal(out);
+
+    out << "    typedef void (*dispatch_fn)(StaticInspector &, const Node *);" << std::endl
+        << "    static const std::unordered_map<std::type_index, dispatch_fn> "
+              "&dispatchTable() {" << std::endl
+        << "        static const std::unordered_map<std::type_index, dispatch_fn> "
+              "table = {" << std::endl;
+    auto entry = [&out](const std::string &key, const std::string &cast) {
+        out << "            { std::type_index(typeid(" << key << "))," << std::endl
+            << "              [](StaticInspector &self, const Node *n) {" << std::endl
+            << "                  self.traverse(static_cast<const " << cast
+            << " *>(n)); } }," << std::endl; };
+    for (auto cls : *getClasses()) {
+        if (cls->kind != NodeKind::Concrete)
+            continue;
+        std::stringstream tmp;
+        tmp << cls->containedIn << cls->name;
+        entry(tmp.str(), tmp.str()); }
+    entry("Vector<Node>", "Vector<Node>");
+    entry("IndexedVector<Node>", "Vector<Node>");
+    for (auto cls : *getClasses()) {
+        std::stringstream tmp;
+        tmp << cls->containedIn << cls->name;
+        if (cls->needVector || cls->needIndexedVector)
+            entry("Vector<" + tmp.str() + ">", "Vector<" + tmp.str() + ">");
+        if (cls->needIndexedVector)
+            entry("IndexedVector<" + tmp.str() + ">", "Vector<" + tmp.str() + ">"); }
+    out << "        };" << std::endl
+        << "        return table; }" << std::endl
+        << "};" << std::endl << std::endl
+        << "}  // namespace IR" << std::endl << std::endl
+        << "#endif /* " << macroname << " */" << std::endl;
 }
 
 void IrClass::generateTreeMacro(std::ostream &out) const {
@@ -188,6 +330,61 @@ void IrClass::generateTreeMacro(std::ostream &out) const {
     out << "), ##__VA_ARGS__) \\" << std::endl;
 }
 
+/* Children traversal for the static-dispatch visitor.  Mirrors the
+ * auto-generated visit_children: walk up the concrete parent chain, then the
+ * node-valued fields in declaration order.  Classes with a hand-written
+ * visit_children body keep it as the single source of truth by routing their
+ * children through the virtual interface. */
+void IrClass::generateStaticTraversal(std::ostream &out) const {
+    const IrMethod *custom = nullptr;
+    for (auto e : elements)
+        if (auto m = e->to<IrMethod>())
+            if (m->name == "visit_children" && m->isUser)
+                custom = m;
+    bool suppressed = Util::Enumerator<IrElement*>::createEnumerator(elements)
+            ->where([] (IrElement *el) { return el->is<IrNo>(); })
+            ->where([] (IrElement *el) { return el->to<IrNo>()->text == "visit_children"; })
+            ->any();
+
+    out << indent << "void traverse_children(const " << containedIn << name
+        << " *n) {" << std::endl;
+    if (custom) {
+        out << indent << indent << "ChildForwarder fwd(*this);" << std::endl
+            << indent << indent << "n->" << containedIn << name
+            << "::visit_children(fwd);" << std::endl;
+    } else {
+        out << indent << indent << "traverse_children(static_cast<const "
+            << getParent()->containedIn << getParent()->name << " *>(n));" << std::endl;
+        if (!suppressed) {
+            for (auto f : *getFields()) {
+                const IrClass *fcl = f->type->resolve(containedIn);
+                if (fcl == nullptr)
+                    // This is not an IR pointer
+                    continue;
+                if (!f->isInline)
+                    out << indent << indent << "visit(n->" << f->name << ");" << std::endl;
+                else if (fcl == vectorClass() || fcl == indexedVectorClass())
+                    out << indent << indent << "for (auto &e : n->" << f->name
+                        << ") visit(e);" << std::endl;
+                else if (fcl == namemapClass())
+                    out << indent << indent << "for (auto &e : n->" << f->name
+                        << ") visit(e.second);" << std::endl;
+                else if (fcl == nodemapClass())
+                    out << indent << indent << "for (auto &e : n->" << f->name
+                        << ") { visit(e.first); visit(e.second); }" << std::endl;
+                else
+                    out << indent << indent << "traverse_children(&n->" << f->name
+                        << ");" << std::endl; } } }
+    out << indent << "}" << std::endl;
+
+    if (kind == NodeKind::Concrete)
+        out << indent << "void traverse(const " << containedIn << name << " *n) {" << std::endl
+            << indent << indent << "if (self().preorder(n)) {" << std::endl
+            << indent << indent << indent << "traverse_children(n);" << std::endl
+            << indent << indent << indent << "self().postorder(n); } }" << std::endl;
+    out << std::endl;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 
 void EmitBlock::generate_hdr(std::ostream &out) const {
@@ -336,7 +533,11 @@ void IrClass::generate_hdr(std::ostream &out) const {
     auto access = IrElement::Private;
     for (auto e : elements) {
         if (e->access != access) out << (access = e->access);
-        e->generate_hdr(out); }
+        auto slot = slotField.find(e);
+        if (slot != slotField.end())
+            slot->second->generate_hdr(out);
+        else
+            e->generate_hdr(out); }
 
     if (kind != NodeKind::Interface && kind != NodeKind::Nested)
         out << indent << "IRNODE" << (kind == NodeKind::Abstract ?  "_ABSTRACT" : "")
@@ -377,27 +578,53 @@ int IrClass::generateConstructor(const ctor_args_t &arglist, const IrMethod *use
     //     { validate(); }
     // }
     int optargs = 0;
-    std::stringstream body;
-    const char *sep = ":\n    ";
-    auto parent = getParent() ? getParent()->qualified_name(containedIn) : cstring();
-    const char *end_parent = "";
+    std::vector<const IrField *> parentArgs, ownFields;
     for (auto &arg : arglist) {
         if (arg.first->optional && (skip_opt & (1U << optargs++)))
             continue;
-        if (arg.second == this) {
-            body << end_parent;
-            end_parent = "";
-        } else if (parent) {
-            body << sep << parent;
-            parent = nullptr;
-            sep = "(";
-            end_parent = ")"; }
-        body << sep << arg.first->name;
         if (arg.second == this)
-            body << "(" << arg.first->name << ")";
+            ownFields.push_back(arg.first);
+        else
+            parentArgs.push_back(arg.first); }
+    // members are initialized in declaration order whatever the list says,
+    // so write the list in the (packed) declaration order to keep that
+    // honest and -Wreorder quiet; argument order is unaffected
+    std::stable_sort(ownFields.begin(), ownFields.end(),
+        [this](const IrField *a, const IrField *b) {
+            return layout.at(a) < layout.at(b); });
+    // Inline class-typed arguments (Vector, IndexedVector, ...) arrive by
+    // value, so forward them with std::move: a caller handing over an
+    // expiring list -- the parser's semantic values, say -- then pays a
+    // buffer swap instead of an element-wise copy.  A user constructor
+    // body sees the argument (it shadows the member), so any argument the
+    // body mentions keeps the copying form.
+    auto sink = [this, user](const IrField *f) -> bool {
+        if (!f->isInline || f->type->resolve(f->clss ? f->clss->containedIn : containedIn)
+                            == nullptr)
+            return false;
+        return !user || user->body.isNullOrEmpty() ||
+               strstr(user->body.c_str(), f->name.c_str()) == nullptr; };
+    auto forward = [&sink](std::ostream &out, const IrField *f) -> std::ostream& {
+        if (sink(f))
+            out << "std::move(" << f->name << ")";
+        else
+            out << f->name;
+        return out; };
+    std::stringstream body;
+    const char *sep = ":\n    ";
+    if (!parentArgs.empty()) {
+        body << sep << getParent()->qualified_name(containedIn);
+        sep = "(";
+        for (auto arg : parentArgs) {
+            forward(body << sep, arg);
+            sep = ", "; }
+        body << ")";
+        sep = ", "; }
+    for (auto arg : ownFields) {
+        forward(body << sep << arg->name << "(", arg) << ")";
         sep = ", "; }
 
-    body << end_parent << std::endl << indent << "{";
+    body << std::endl << indent << "{";
     if (user)
         body << '\n' << LineDirective(user->getSourceInfo()) << user->body << '\n'
              << LineDirective() << indent;
@@ -450,6 +677,54 @@ bool IrClass::shouldSkip(cstring feature) const {
     return provided;
 }
 
+/* Estimated alignment of a field in the emitted class, used to pack the
+ * declaration order.  Only the relative order matters, so unknown types are
+ * conservatively given pointer alignment; misjudging an enum only costs a
+ * packing opportunity, never correctness. */
+static int alignmentEstimate(const IrField *f, const IrNamespace *ns) {
+    const Type *t = f->type;
+    while (auto arr = dynamic_cast<const ArrayType *>(t))
+        t = arr->base;
+    if (t->resolve(ns) != nullptr && !f->isInline)
+        return 8;  // emitted as a pointer
+    cstring n = t->toString();
+    if (n == "bool" || n == "char" || n == "int8_t" || n == "uint8_t")
+        return 1;
+    if (n == "short" || n == "int16_t" || n == "uint16_t")
+        return 2;
+    if (n == "int" || n == "unsigned" || n == "unsigned int" || n == "int32_t" || n == "uint32_t")
+        return 4;
+    return 8;
+}
+
+/* Choose the emitted declaration order of the data members: within each
+ * access level, fields are stably sorted by decreasing alignment so that
+ * bools and small integers no longer interleave with pointers and pad every
+ * gap up to a word.  Only the emission slots change -- constructor argument
+ * order, visit_children/operator== order and the JSON field names all keep
+ * following the .def declaration order, so nothing visible to users of the
+ * classes moves.  generateConstructor consults the resulting positions to
+ * list the member initializers in declaration order. */
+void IrClass::computeFieldLayout() {
+    std::map<int, std::vector<const IrField *>> groups;  // keyed by access level
+    for (auto e : elements)
+        if (auto f = e->to<IrField>())
+            if (!f->isStatic)
+                groups[f->access].push_back(f);
+    for (auto &g : groups)
+        std::stable_sort(g.second.begin(), g.second.end(),
+            [this](const IrField *a, const IrField *b) {
+                return alignmentEstimate(a, containedIn) > alignmentEstimate(b, containedIn); });
+    std::map<int, size_t> next;
+    int pos = 0;
+    for (auto e : elements)
+        if (auto f = e->to<IrField>())
+            if (!f->isStatic) {
+                const IrField *pick = groups[f->access][next[f->access]++];
+                slotField[e] = pick;
+                layout[pick] = pos++; }
+}
+
 void IrClass::resolve() {
     for (auto s : parents) {
         const IrClass *p = s->resolve(containedIn);
@@ -463,6 +738,7 @@ void IrClass::resolve() {
                     "Class %1% has more than 1 non-interface parent: %2% and %3%",
                     this, concreteParent, p); }
         parentClasses.push_back(p); }
+    computeFieldLayout();
     generateMethods();
     for (auto e : elements)
         e->resolve();
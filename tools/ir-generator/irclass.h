@@ -216,6 +216,11 @@ class IrClass : public IrElement {
     int generateConstructor(const ctor_args_t &args, const IrMethod *user, unsigned skip_opt);
     void generateMethods();
     bool shouldSkip(cstring feature) const;
+    void computeFieldLayout();
+    // which field is emitted at each field slot of the class body, and the
+    // resulting declaration position of each field; see computeFieldLayout
+    std::map<const IrElement *, const IrField *> slotField;
+    std::map<const IrField *, int> layout;
 
  public:
     const IrClass *getParent() const {
@@ -267,6 +272,7 @@ class IrClass : public IrElement {
     void generate_hdr(std::ostream &out) const override;
     void generate_impl(std::ostream &out) const override;
     void generateTreeMacro(std::ostream &out) const;
+    void generateStaticTraversal(std::ostream &out) const;
     void resolve() override;
     cstring toString() const override { return name; }
     std::string fullName() const;
@@ -279,6 +285,7 @@ class IrClass : public IrElement {
 class IrDefinitions {
     std::vector<IrElement*> elements;
     Util::Enumerator<IrClass*>* getClasses() const;
+    void generateStaticVisitor(std::ostream &out) const;
 
  public:
     explicit IrDefinitions(std::vector<IrElement*> classes) : elements(classes) {}
@@ -291,7 +298,8 @@ class IrDefinitions {
         IrClass::indexedVectorClass()->resolve();
         for (auto cls : *getClasses())
             cls->resolve(); }
-    void generate(std::ostream &t, std::ostream &out, std::ostream &impl) const;
+    void generate(std::ostream &t, std::ostream &out, std::ostream &impl,
+                  std::ostream &sv) const;
 };
 
 class LineDirective {
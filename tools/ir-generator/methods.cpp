@@ -74,6 +74,8 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
             if (parent->name == "Node") {
                 buf << cl->indent << cl->indent << "if (typeid(*this) != typeid(a_)) "
                                                    "return false;\n";
+                buf << cl->indent << cl->indent << "if (structuralHash() != a_.structuralHash()) "
+                                                   "return false;\n";
             } else {
                 buf << cl->indent << cl->indent << "if (!"
                     << parent->qualified_name(cl->containedIn)
@@ -107,6 +109,34 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
             buf << ";" << std::endl; }
         buf << cl->indent << "}";
         return buf.str(); } } },
+{ "computeHash", { &NamedType::Uint64(), {}, EXTEND + CONST + IN_IMPL + OVERRIDE,
+    [](IrClass *cl, Util::SourceInfo srcInfo, cstring body) -> cstring {
+        // must fold in exactly the fields that 'equiv' above compares; classes
+        // with a custom equiv body supply a matching custom computeHash body
+        std::stringstream buf;
+        buf << "{" << std::endl;
+        buf << cl->indent << cl->indent << "uint64_t h = ";
+        if (auto parent = cl->getParent())
+            buf << parent->qualified_name(cl->containedIn) << "::computeHash();" << std::endl;
+        else
+            buf << "0;" << std::endl;
+        if (body) {
+            buf << LineDirective(srcInfo, true) << body << std::endl;
+        } else {
+            for (auto f : *cl->getFields()) {
+                if (*f->type == NamedType::SourceInfo()) continue;  // not part of equiv
+                buf << cl->indent << cl->indent << "h = ::IR::hash_combine(h, ";
+                if (f->type->resolve(cl->containedIn) == nullptr) {
+                    // This is not an IR pointer
+                    buf << f->name;
+                } else if (f->isInline) {
+                    buf << f->name << ".structuralHash()";
+                } else {
+                    buf << f->name << " ? " << f->name << "->structuralHash() : 1"; }
+                buf << ");" << std::endl; }
+            buf << cl->indent << cl->indent << "return h;" << std::endl; }
+        buf << cl->indent << "}";
+        return buf.str(); } } },
 { "operator<<", { &ReferenceType::OstreamRef, { new IrField(&ReferenceType::OstreamRef, "out") },
   EXTEND + IN_IMPL + NOT_DEFAULT + INCL_NESTED + CLASSREF + FRIEND,
     [](IrClass *cl, Util::SourceInfo srcInfo, cstring body) -> cstring {
@@ -63,6 +63,11 @@ NamedType& NamedType::Int() {
     return nt;
 }
 
+NamedType& NamedType::Uint64() {
+    static NamedType nt("uint64_t");
+    return nt;
+}
+
 NamedType& NamedType::Void() {
     static NamedType nt("void");
     return nt;
@@ -90,6 +90,7 @@ class NamedType : public Type {
 
     static NamedType& Bool();
     static NamedType& Int();
+    static NamedType& Uint64();
     static NamedType& Void();
     static NamedType& Cstring();
     static NamedType& Ostream();
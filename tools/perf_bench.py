@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+# Copyright 2013-present Barefoot Networks, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+""" End-to-end compile-time benchmark harness, run as `make perf-bench`.
+
+    Compiles a corpus of P4 programs -- a curated set from
+    testdata/p4_16_samples plus synthesized programs that scale the number
+    of headers, parser states and tables -- through every compiler driver
+    found in the build directory, and writes a JSON report with wall time
+    and the per-pass records collected by --pass-profile (see
+    ir/pass_manager.h).  Reports from two builds can be diffed or trended
+    to catch compile-time regressions when they are committed, not weeks
+    later.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+# Curated sample programs: broad, commonly-edited language features.
+# Synthesized programs provide the scaling dimension; these provide realism.
+CURATED_V1MODEL = [
+    "flowlet_switching-bmv2.p4",
+    "checksum-l4-bmv2.p4",
+    "v1model-special-ops-bmv2.p4",
+    "issue561-bmv2.p4",
+    "crc32-bmv2.p4",
+]
+CURATED_PSA = [
+    "psa-example-digest-bmv2.p4",
+    "psa-example-parser-checksum.p4",
+    "psa-action-selector1.p4",
+]
+
+# Scales for the synthesized programs: (headers & parser states, tables).
+SCALES = [(16, 16), (64, 64), (256, 128)]
+
+
+def synthesize(nheaders, ntables):
+    """A v1model program with @nheaders headers (each with its own parser
+       state) and @ntables tables applied in sequence in the ingress."""
+    out = ["#include <core.p4>", "#include <v1model.p4>", ""]
+    for i in range(nheaders):
+        out.append("header h%d_t { bit<16> f; bit<8> next; }" % i)
+    out.append("struct headers {")
+    for i in range(nheaders):
+        out.append("    h%d_t h%d;" % (i, i))
+    out.append("}")
+    out.append("struct metadata { }")
+    out.append("")
+
+    out.append("parser P(packet_in pkt, out headers hdr, inout metadata meta,")
+    out.append("         inout standard_metadata_t std) {")
+    out.append("    state start { transition s0; }")
+    for i in range(nheaders):
+        nxt = "s%d" % (i + 1) if i + 1 < nheaders else "accept"
+        out.append("    state s%d {" % i)
+        out.append("        pkt.extract(hdr.h%d);" % i)
+        out.append("        transition select(hdr.h%d.next) {" % i)
+        out.append("            8w1: %s;" % nxt)
+        out.append("            default: accept;")
+        out.append("        }")
+        out.append("    }")
+    out.append("}")
+    out.append("")
+
+    out.append("control Ing(inout headers hdr, inout metadata meta,")
+    out.append("            inout standard_metadata_t std) {")
+    for i in range(ntables):
+        h = i % nheaders
+        out.append("    action set%d() { hdr.h%d.f = 16w%d; }" % (i, h, i))
+        out.append("    action fwd%d(bit<9> port) { std.egress_spec = port; }" % i)
+        out.append("    table t%d {" % i)
+        out.append("        key = { hdr.h%d.f : exact; }" % h)
+        out.append("        actions = { set%d; fwd%d; NoAction; }" % (i, i))
+        out.append("        default_action = NoAction();")
+        out.append("    }")
+    out.append("    apply {")
+    for i in range(ntables):
+        out.append("        t%d.apply();" % i)
+    out.append("    }")
+    out.append("}")
+    out.append("")
+
+    out.append("control Eg(inout headers hdr, inout metadata meta,")
+    out.append("           inout standard_metadata_t std) { apply { } }")
+    out.append("control Vck(inout headers hdr, inout metadata meta) { apply { } }")
+    out.append("control Cck(inout headers hdr, inout metadata meta) { apply { } }")
+    out.append("control Dep(packet_out pkt, in headers hdr) {")
+    out.append("    apply {")
+    for i in range(nheaders):
+        out.append("        pkt.emit(hdr.h%d);" % i)
+    out.append("    }")
+    out.append("}")
+    out.append("")
+    out.append("V1Switch(P(), Vck(), Ing(), Eg(), Cck(), Dep()) main;")
+    return "\n".join(out) + "\n"
+
+
+def build_corpus(testdata, workdir):
+    """Returns a list of (label, path, arch) jobs."""
+    corpus = []
+    samples = os.path.join(testdata, "p4_16_samples")
+    for name in CURATED_V1MODEL:
+        path = os.path.join(samples, name)
+        if os.path.exists(path):
+            corpus.append((name, path, "v1model"))
+    for name in CURATED_PSA:
+        path = os.path.join(samples, name)
+        if os.path.exists(path):
+            corpus.append((name, path, "psa"))
+    for nheaders, ntables in SCALES:
+        label = "synth-h%d-t%d.p4" % (nheaders, ntables)
+        path = os.path.join(workdir, label)
+        with open(path, "w") as f:
+            f.write(synthesize(nheaders, ntables))
+        corpus.append((label, path, "v1model"))
+    return corpus
+
+
+def drivers_for(builddir, arch):
+    """The (driver-name, extra-args) pairs that can compile @arch programs,
+       limited to the drivers present in the build."""
+    found = []
+    jobs = {
+        "v1model": [("p4test", []), ("p4c-bm2-ss", ["-o", "out.json"])],
+        "psa": [("p4test", []), ("p4c-dpdk", ["-o", "out.spec"])],
+    }
+    for name, args in jobs[arch]:
+        path = os.path.join(builddir, name)
+        if os.path.exists(path):
+            found.append((path, name, args))
+    return found
+
+
+def run_job(driver, args, program, profile, timeout):
+    cmd = [driver, program, "--pass-profile", profile] + args
+    start = time.monotonic()
+    try:
+        rc = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                            timeout=timeout).returncode
+    except subprocess.TimeoutExpired:
+        return None, "timeout"
+    seconds = time.monotonic() - start
+    if rc != 0:
+        return None, "exit %d" % rc
+    return seconds, None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--build-dir", required=True, help="directory with the compiler drivers")
+    parser.add_argument("--testdata", required=True, help="the testdata source directory")
+    parser.add_argument("--output", required=True, help="file for the JSON report")
+    parser.add_argument("--work-dir", default=None,
+                        help="where to put synthesized programs and compiler outputs"
+                             " (default: <build-dir>/perf-bench)")
+    parser.add_argument("--runs", type=int, default=3,
+                        help="repetitions per job; the report keeps the best wall time")
+    parser.add_argument("--timeout", type=int, default=600, help="per-compile timeout, seconds")
+    options = parser.parse_args()
+
+    # the compilers run from the work dir; keep every path absolute
+    options.build_dir = os.path.abspath(options.build_dir)
+    options.testdata = os.path.abspath(options.testdata)
+    options.output = os.path.abspath(options.output)
+    workdir = os.path.abspath(options.work_dir or os.path.join(options.build_dir, "perf-bench"))
+    os.makedirs(workdir, exist_ok=True)
+    os.chdir(workdir)
+
+    results = []
+    failures = 0
+    for label, path, arch in build_corpus(options.testdata, workdir):
+        for driver, name, args in drivers_for(options.build_dir, arch):
+            profile = os.path.join(workdir, "%s.%s.passes.json" % (label, name))
+            walls = []
+            error = None
+            for _ in range(options.runs):
+                seconds, error = run_job(driver, args, path, profile, options.timeout)
+                if error is not None:
+                    break
+                walls.append(seconds)
+            if error is not None:
+                print("FAILED  %-12s %-32s %s" % (name, label, error))
+                results.append({"program": label, "driver": name, "error": error})
+                failures += 1
+                continue
+            passes = []
+            try:
+                with open(profile) as f:
+                    passes = json.load(f)
+            except (OSError, ValueError):
+                pass  # profile is best-effort; wall time is still reported
+            print("%-12s %-32s %8.3f s" % (name, label, min(walls)))
+            results.append({"program": label, "driver": name,
+                            "wall_seconds": min(walls), "all_seconds": walls,
+                            "passes": passes})
+
+    report = {"version": 1, "runs": options.runs, "results": results}
+    with open(options.output, "w") as f:
+        json.dump(report, f, indent=2)
+        f.write("\n")
+    print("Report written to", options.output)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# Copyright 2013-present Barefoot Networks, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+""" Profile-guided + LTO build driver, run as `make p4c-optimized`.
+
+    Builds the compiler binaries in two stages:
+      1. an instrumented build (-DP4C_PGO=generate) that compiles the
+         perf-bench corpus (see tools/perf_bench.py) to collect execution
+         profiles of realistic compiles;
+      2. a final build (-DP4C_PGO=use -DENABLE_LTO=ON) that consumes the
+         profiles and optimizes across the frontend/midend/ir static
+         libraries at link time.
+    The final binaries end up in <build-dir>/final.
+"""
+
+import argparse
+import glob
+import multiprocessing
+import os
+import shutil
+import subprocess
+import sys
+
+
+def run(cmd, **kwargs):
+    print("+ " + " ".join(cmd))
+    sys.stdout.flush()
+    subprocess.check_call(cmd, **kwargs)
+
+
+def configure_and_build(source_dir, build_dir, jobs, targets, cmake_args):
+    os.makedirs(build_dir, exist_ok=True)
+    run(["cmake", source_dir] + cmake_args, cwd=build_dir)
+    run(["cmake", "--build", build_dir, "--", "-j%d" % jobs] + targets)
+
+
+def merge_clang_profiles(profile_dir):
+    """Clang writes raw per-process profiles; they must be merged into a
+       single indexed file before -fprofile-use can consume them.  gcc
+       profiles are consumed in place, so there is nothing to do."""
+    raws = glob.glob(os.path.join(profile_dir, "*.profraw"))
+    if not raws:
+        return
+    profdata = shutil.which("llvm-profdata")
+    if profdata is None:
+        sys.exit("llvm-profdata is needed to merge clang profiles but was not found")
+    run([profdata, "merge", "--output",
+         os.path.join(profile_dir, "default.profdata")] + raws)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--source-dir", required=True, help="the p4c source directory")
+    parser.add_argument("--build-dir", required=True,
+                        help="where to put the staged builds and the profiles")
+    parser.add_argument("--jobs", type=int, default=multiprocessing.cpu_count(),
+                        help="parallel build jobs")
+    parser.add_argument("--target", action="append", default=[],
+                        help="compiler targets to build and optimize"
+                             " (default: p4test p4c-bm2-ss p4c-dpdk)")
+    parser.add_argument("--cmake-arg", action="append", default=[],
+                        help="extra argument for both cmake configures; repeatable")
+    options = parser.parse_args()
+
+    source_dir = os.path.abspath(options.source_dir)
+    build_dir = os.path.abspath(options.build_dir)
+    targets = options.target or ["p4test", "p4c-bm2-ss", "p4c-dpdk"]
+    profile_dir = os.path.join(build_dir, "profiles")
+    os.makedirs(profile_dir, exist_ok=True)
+
+    # Both stages share the settings that matter for profile fidelity; the
+    # test binaries are skipped since only the shipped drivers are profiled.
+    common = ["-DCMAKE_BUILD_TYPE=RELEASE",
+              "-DENABLE_GTESTS=OFF",
+              "-DP4C_PGO_DIR=%s" % profile_dir] + options.cmake_arg
+
+    # Stage 1: instrumented compiler, profiled on the perf-bench corpus.
+    instrumented = os.path.join(build_dir, "instrumented")
+    configure_and_build(source_dir, instrumented, options.jobs, targets,
+                        common + ["-DP4C_PGO=generate"])
+    run([os.path.join(source_dir, "tools", "perf_bench.py"),
+         "--build-dir", instrumented,
+         "--testdata", os.path.join(source_dir, "testdata"),
+         "--output", os.path.join(build_dir, "perf-bench-instrumented.json"),
+         "--runs", "1"])
+    merge_clang_profiles(profile_dir)
+
+    # Stage 2: the shipped build, guided by the profiles and LTO-optimized.
+    final = os.path.join(build_dir, "final")
+    configure_and_build(source_dir, final, options.jobs, targets,
+                        common + ["-DP4C_PGO=use", "-DENABLE_LTO=ON"])
+
+    print("Optimized binaries are in " + final)
+
+
+if __name__ == "__main__":
+    main()